@@ -7,7 +7,9 @@ parser = argparse.ArgumentParser(description="Make helper parser")
 parser.add_argument("--directory", dest="directory", required=True)
 parser.add_argument("--library", dest="library", help="Make a library")
 parser.add_argument("--binary", dest="binary", help="Make a binary")
+parser.add_argument("--prefix", dest="prefix", help="Make a set of objs")
 parser.add_argument("--exclude", dest="exclude", help="Exclude file", action="append")
+parser.add_argument("--exclude-dir", dest="exclude_dir", help="Exclude subdirectory", action="append")
 parser.add_argument("--include", dest="include", help="Include file", action="append")
 parser.add_argument("--out", dest="out", help="Output file")
 parser.add_argument("--cpp-suffix", dest="cpp_suffix", help="C++ file suffix")
@@ -15,6 +17,7 @@ PREFIX=None
 LIBRARY=None
 BINARY=None
 EXCLUDE=[]
+EXCLUDE_DIR=[]
 INCLUDE=[]
 OUTFILE="targets.mk"
 CPP_SUFFIX=".cpp"
@@ -53,6 +56,8 @@ def find_sources():
     c_files = []
     print EXCLUDE
     for dir in os.walk("."):
+        if os.path.normpath(dir[0]).split(os.sep)[0] in EXCLUDE_DIR:
+            continue
         for file in dir[2]:
             if (len(INCLUDE) == 0 and not file in EXCLUDE) or file in INCLUDE:
                 if os.path.splitext(file)[1] == CPP_SUFFIX:
@@ -70,12 +75,16 @@ if args.library is not None:
     PREFIX=args.library.upper()
 elif args.binary is not None:
     PREFIX=args.binary.upper()
+elif args.prefix is not None:
+    PREFIX=args.prefix.upper()
 else:
-    sys.stderr.write("Must provide either library or binary")
+    sys.stderr.write("Must provide either library, binary or prefix")
     sys.exit(1)
 
 if args.exclude is not None:
     EXCLUDE = args.exclude
+if args.exclude_dir is not None:
+    EXCLUDE_DIR = args.exclude_dir
 if args.include is not None:
     INCLUDE = args.include
 if args.out is not None:
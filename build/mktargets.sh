@@ -6,5 +6,8 @@ python build/mktargets.py --directory codec/processing --library processing
 
 python build/mktargets.py --directory codec/console/dec --binary h264dec
 python build/mktargets.py --directory codec/console/enc --binary h264enc
-python build/mktargets.py --directory test --binary codec_unittest
+python build/mktargets.py --directory test --binary codec_unittest --exclude-dir decoder --exclude-dir encoder --exclude-dir processing
+python build/mktargets.py --directory test/decoder --prefix decoder_unittest
+python build/mktargets.py --directory test/encoder --prefix encoder_unittest
+python build/mktargets.py --directory test/processing --prefix processing_unittest
 python build/mktargets.py --directory gtest --library gtest --out build/gtest-targets.mk --cpp-suffix .cc --include gtest-all.cc
@@ -62,7 +62,10 @@ class ISVCEncoder {
   virtual int EXTAPI Uninitialize() = 0;
 
   /*
-   * return: EVideoFrameType [IDR: videoFrameTypeIDR; P: videoFrameTypeP; ERROR: videoFrameTypeInvalid]
+   * with iLookaheadFrames set the input has to be videoFormatI420, other formats fail the frame; the first
+   * iLookaheadFrames calls return videoFrameTypeDelayed, then NULL input drains the pictures still kept
+   * return: EVideoFrameType [IDR: videoFrameTypeIDR; P: videoFrameTypeP; DELAYED: videoFrameTypeDelayed;
+   *         ERROR: videoFrameTypeInvalid]
    */
   virtual int EXTAPI EncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo) = 0;
   /*
@@ -71,6 +74,7 @@ class ISVCEncoder {
   virtual int EXTAPI EncodeParameterSets (SFrameBSInfo* pBsInfo) = 0;
 
   /*
+   * not supported with iLookaheadFrames set
    * return: 0 - success; otherwise - failed;
    */
   virtual int EXTAPI PauseFrame (const SSourcePicture* kpSrcPic,SFrameBSInfo* pBsInfo) = 0;
@@ -88,6 +92,21 @@ class ISVCEncoder {
    */
   virtual int EXTAPI SetOption (ENCODER_OPTION eOptionId, void* pOption) = 0;
   virtual int EXTAPI GetOption (ENCODER_OPTION eOptionId, void* pOption) = 0;
+
+  /*
+   * queue picture to be encoded on the encoder thread while the caller goes on, the picture is copied so
+   * it can be reused as soon as the call returns; NULL drains frames delayed by lookahead like EncodeFrame;
+   * the input has to be videoFormatI420 (videoFormatVFlip may be set unless lookahead is on), others fail
+   * return: CM_RETURN: 0 - success; cmQueueFull - GetEncodedFrame is expected first; otherwise - failed;
+   */
+  virtual int EXTAPI EncodeFrameAsync (const SSourcePicture* kpSrcPic) = 0;
+
+  /*
+   * wait for the oldest picture queued by EncodeFrameAsync, pBsInfo is filled as EncodeFrame would have
+   * done and stays valid until the next call
+   * return: EVideoFrameType as EncodeFrame; videoFrameTypeInvalid and no layer if nothing is queued
+   */
+  virtual int EXTAPI GetEncodedFrame (SFrameBSInfo* pBsInfo) = 0;
 };
 
 class ISVCDecoder {
@@ -112,7 +131,12 @@ class ISVCDecoder {
 
   /*
    *  src must be 4 byte aligned,   recommend 16 byte aligned.    the available src size must be multiple of 4.
-   *  this API does not work for now!! This is for future use to support non-I420 color format output.
+   *  decode as DecodeFrame2 and write the output picture, if any, converted to iColorFormat into pDst owned by caller;
+   *  videoFormatI420, videoFormatNV12, videoFormatYUY2, videoFormatRGB (R, G, B bytes) and videoFormatBGRA are supported.
+   *  iDstStride is the stride of luma or packed rows, 0 for tightly packed; planar chroma follows luma, I420 with
+   *  stride iDstStride/2 and NV12 with stride iDstStride.
+   *  iDstLen is the size of pDst on input and the bytes written on output, 0 if no picture is output. If pDst is too
+   *  small, dsDstBufNeedExpand is returned with the size needed in iDstLen, and the picture is dropped.
    */
   virtual DECODING_STATE EXTAPI DecodeFrameEx (const unsigned char* pSrc,
                                                const int iSrcLen,
@@ -153,6 +177,9 @@ struct ISVCEncoderVtbl {
 
   int (*SetOption) (ISVCEncoder*, ENCODER_OPTION eOptionId, void* pOption);
   int (*GetOption) (ISVCEncoder*, ENCODER_OPTION eOptionId, void* pOption);
+
+  int (*EncodeFrameAsync) (ISVCEncoder*, const SSourcePicture* kpSrcPic);
+  int (*GetEncodedFrame) (ISVCEncoder*, SFrameBSInfo* pBsInfo);
 };
 
 typedef struct ISVCDecoderVtbl ISVCDecoderVtbl;
@@ -187,6 +214,16 @@ struct ISVCDecoderVtbl {
 };
 #endif
 
+/* an access unit, or NULL to flush as with DecodeFrame2(), to be decoded by WelsDecodeBatch() */
+typedef struct TagDecodeBatchItem {
+  ISVCDecoder* pDecoder;
+  const unsigned char* pSrc;
+  int iSrcLen;
+  void* pDst[3];			// output as DecodeFrame2() does
+  SBufferInfo sDstInfo;
+  DECODING_STATE eState;	// return value of DecodeFrame2()
+} SDecodeBatchItem;
+
 
   int  CreateSVCEncoder (ISVCEncoder** ppEncoder);
   void DestroySVCEncoder (ISVCEncoder* pEncoder);
@@ -194,6 +231,26 @@ struct ISVCDecoderVtbl {
   long CreateDecoder (ISVCDecoder** ppDecoder);
   void DestroyDecoder (ISVCDecoder* pDecoder);
 
+  /* decode the items on the shared thread pool and return the count of frames output, -1 for invalid arguments.
+     Items are grouped by picture size of their decoders so that a worker decodes streams of one size back to back;
+     items of one decoder are decoded in their order, an output of an earlier one is valid only as DecodeFrame2()
+     allows. Decoders initialized with bUseSharedThreadPool keep the pool alive between batches. */
+  int  WelsDecodeBatch (SDecodeBatchItem* pItems, int iItemNum);
+
+  /* number of workers of the thread pool shared by instances created with bUseSharedThreadPool,
+     0 (default) means one per logical processor; fails (non-zero) while any instance is attached */
+  int  WelsSetSharedThreadPoolSize (int iThreadNum);
+
+  /* allocator behind all buffers of the codec instances, NULL restores the default pool that keeps freed
+     buffers in size classes for reuse by any instance; fails (non-zero) while any buffer is allocated */
+  int  WelsSetMemoryAllocator (const SWelsMemoryAllocator* pAllocator);
+
+  /* bytes of freed buffers the default pool keeps for reuse, 0 releases them and disables the reuse */
+  int  WelsSetMemoryPoolLimit (unsigned int uiLimit);
+
+  /* current and peak bytes per allocation tag of all instances, returns the count of tags copied */
+  int  WelsGetMemoryTagUsage (SWelsMemoryTagUsage* pUsage, int iMaxNum);
+
 #ifdef __cplusplus
 }
 #endif
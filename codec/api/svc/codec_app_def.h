@@ -89,7 +89,9 @@ typedef enum {
   ENCODER_OPTION_ENABLE_PREFIX_NAL_ADDING,   //enable prefix: true--enable prefix; false--disable prefix
   ENCODER_OPTION_ENABLE_SPS_PPS_ID_ADDITION, //disable pSps/pPps id addition: true--disable pSps/pPps id; false--enable pSps/pPps id addistion
 
-  ENCODER_OPTION_CURRENT_PATH
+  ENCODER_OPTION_CURRENT_PATH,
+
+  ENCODER_OPTION_INPUT_PICTURE              //GetOption only: SSourcePicture* of the padded picture the next EncodeFrame() reads in place, query it for every frame
 } ENCODER_OPTION;
 
 /* Option types introduced in decoder application */
@@ -102,6 +104,10 @@ typedef enum {
   DECODER_OPTION_IDR_PIC_ID,	// feedback current frame belong to which IDR period
   DECODER_OPTION_LTR_MARKING_FLAG,	// feedback wether current frame mark a LTR
   DECODER_OPTION_LTR_MARKED_FRAME_NUM,	// feedback frame num marked by current Frame
+  DECODER_OPTION_ROWS_CALLBACK,	// SDecodedRowsCallback*, called each time MB rows (a slice at least in slice threading) are finished;
+  // the call is made on the deblocking helper or a job thread if enabled, in frame threading for several pictures at once
+  DECODER_OPTION_FRAME_ALLOCATOR,	// SFrameAllocator*, pictures are decoded into buffers of the application; set before the first
+  // decoding call, a NULL pfnGetBuffer restores internal storage
 
 } DECODER_OPTION;
 typedef enum { //feedback that whether or not have VCL NAL in current AU
@@ -123,6 +129,19 @@ typedef enum {
   VIDEO_BITSTREAM_DEFAULT           = VIDEO_BITSTREAM_SVC,
 } VIDEO_BITSTREAM_TYPE;
 
+//enumerate the way decoder threads share the work, effective when iThreadCount > 1
+typedef enum {
+  DECODER_THREADING_FRAME           = 0,	// pictures reconstructed in parallel, output delayed by up to iThreadCount frames
+  DECODER_THREADING_SLICE           = 1,	// slices of a picture parsed and reconstructed in parallel, no output delay
+} DECODER_THREADING_MODE;
+
+//enumerate the motion search engines of the encoder, slower presets spend more cycles to find cheaper vectors
+typedef enum {
+  ME_PRESET_FAST                    = 0,	// small diamond search around the predicted vectors
+  ME_PRESET_MEDIUM                  = 1,	// hexagon search, static blocks terminated early by SAD threshold
+  ME_PRESET_SLOW                    = 2,	// half resolution candidate search and uneven multi-hexagon search for fast motion
+} ME_SEARCH_PRESET;
+
 typedef enum {
   NO_RECOVERY_REQUSET  = 0,
   LTR_RECOVERY_REQUEST = 1,
@@ -170,6 +189,7 @@ typedef struct {
   int	iSpatialBitrate;	// target bitrate for a spatial layer
   unsigned int	uiProfileIdc;	// value of profile IDC (0 for auto-detection)
   int    iDLayerQp;
+  int    iEntropyCodingModeFlag;	// 0: CAVLC, 1: CABAC for this layer; CABAC is forced by iEtropyCodingModeFlag
 
   SSliceConfig sSliceCfg;
 } SSpatialLayerConfig;
@@ -211,13 +231,15 @@ typedef struct TagEncParamExt
   bool    bPrefixNalAddingCtrl;
   bool	  bEnableSSEI;
   int      iPaddingFlag;            // 0:disable padding;1:padding
-  int      iEtropyCodingModeFlag;
+  int      iEtropyCodingModeFlag;	// 0: CAVLC, 1: CABAC for all spatial layers
+  ME_SEARCH_PRESET	eMotionSearchPreset;	// speed/quality trade-off of integer pel motion search
 
   /* rc control */
   bool    bEnableRc;
   bool    bEnableFrameSkip; // allow skipping frames to keep the bitrate within limits
   int     iMaxQp;
   int     iMinQp;
+  int     iLookaheadFrames; // frames analyzed ahead by rate control (I420 input only), output is delayed as many frames; 0: disabled
 
   /*LTR settings*/
   bool     bEnableLongTermReference; // 0: on, 1: off
@@ -227,6 +249,8 @@ typedef struct TagEncParamExt
   /* multi-thread settings*/
   short		iMultipleThreadIdc;		// 1	# 0: auto(dynamic imp. internal encoder); 1: multiple threads imp. disabled; > 1: count number of threads;
   short		iCountThreadsNum;			//		# derived from disable_multiple_slice_idc (=0 or >1) means;
+  bool		bUseSharedThreadPool;	// run slice coding as tasks of the pool shared by the process instead of own threads, see WelsSetSharedThreadPoolSize()
+  bool		bEnableWavefront;		// code MB rows of single slice layers by iMultipleThreadIdc threads, each MB two MBs behind the row above
 
    /* Deblocking loop filter */
   int		iLoopFilterDisableIdc;	// 0: on, 1: off, 2: on except for slice boundaries
@@ -238,10 +262,14 @@ typedef struct TagEncParamExt
 
   /*pre-processing feature*/
   bool    bEnableDenoise;	    // denoise control
+  bool    bEnableTemporalDenoise;	// blend the static blocks of P pictures with their reference source, on the 8x8 sad of the VAA
   bool    bEnableBackgroundDetection;// background detection control //VAA_BACKGROUND_DETECTION //BGD cmd
   bool    bEnableAdaptiveQuant; // adaptive quantization control
   bool	  bEnableFrameCroppingFlag;// enable frame cropping flag: TRUE always in application
   bool    bEnableSceneChangeDetect;
+
+  /* reconfiguration */
+  int     iCtxPoolSize;	// contexts of other configurations kept by ENCODER_OPTION_SVC_ENCODE_PARAM_EXT to be reset instead of rebuilt when switched back to; 0: rebuilt on every change
 }SEncParamExt;
 
 //Define a new struct to show the property of video bitstream.
@@ -261,6 +289,12 @@ typedef struct TagSVCDecodingParam {
   unsigned char	uiEcActiveFlag;		// Whether active error concealment feature in decoder
 
   SVideoProperty   sVideoProperty;
+
+  int			iThreadCount;		// number of decoding threads, 0 or 1 for single threaded decoding
+  DECODER_THREADING_MODE	eThreadingMode;	// how the work is shared by threads
+  bool			bUseSharedThreadPool;	// slice threading runs on the pool shared by the process, iThreadCount only bounds the jobs in flight;
+  // the decoder keeps the pool alive for WelsDecodeBatch() also
+  bool			bDeblockingThread;		// single threaded decoding filters each slice on a helper thread one MB row behind reconstruction
 } SDecodingParam, *PDecodingParam;
 
 /* Bitstream inforamtion of a layer being encoded */
@@ -297,5 +331,20 @@ typedef struct Source_Picture_s {
   int 		iPicHeight;				// luma picture height in y coordinate
 } SSourcePicture;
 
+/* allocator behind all buffers of the codec instances, see WelsSetMemoryAllocator() */
+typedef struct {
+  void*	(*pfMalloc) (void* pUserData, unsigned int uiSize);
+  void	(*pfFree) (void* pUserData, void* pPtr, unsigned int uiSize);	// uiSize as passed to pfMalloc
+  void*	pUserData;
+} SWelsMemoryAllocator;
+
+/* bytes allocated under one tag by all codec instances, see WelsGetMemoryTagUsage() */
+typedef struct {
+  const char*	pTag;
+  unsigned int	uiCurrentBytes;
+  unsigned int	uiPeakBytes;
+  unsigned int	uiAllocNum;		// count of allocations so far
+} SWelsMemoryTagUsage;
+
 
 #endif//WELS_VIDEO_CODEC_APPLICATION_DEFINITION_H__
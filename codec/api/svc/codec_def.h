@@ -53,6 +53,7 @@ typedef enum {
   videoFormatInternal   = 25,                        // Only Used for SVC decoder testbed
 
   videoFormatNV12		  = 26,						// new format for output by DXVA decoding
+  videoFormatNV21       = 29,                        // y planar + vu packed
 
   videoFormatVFlip      = 0x80000000
 } EVideoFormatType;
@@ -64,6 +65,7 @@ typedef enum {
   videoFrameTypeP,		/* P frame type */
   videoFrameTypeSkip,		/* Skip the frame based encoder kernel */
   videoFrameTypeIPMixed,		/* Frame type introduced I and P slices are mixing */
+  videoFrameTypeDelayed,		/* Picture kept by lookahead, no layer is output until a later call */
 } EVideoFrameType;
 
 typedef enum {
@@ -75,6 +77,7 @@ typedef enum {
   cmUnkonwReason,
   cmMallocMemeError,                /*Malloc a memory error*/
   cmInitExpected,			  /*Initial action is expected*/
+  cmQueueFull,				  /*Queue of asynchronous encoding is full, encoded frames are expected to be taken*/
 } CM_RETURN;
 
 
@@ -172,8 +175,53 @@ typedef struct TagBufferInfo {
   union {
     SSysMEMBuffer sSystemBuffer;
   } UsrData;
+  void* pFrameOpaque;	// pOpaque of the SFrameBuffer holding the frame output if a frame allocator is set, else NULL
 } SBufferInfo;
 
+/* Rows of the picture being decoded which will not change any more, passed before the picture itself is output */
+typedef struct TagDecodedRows {
+  unsigned char* pData[3];	// planes of the cropped picture, the same pointers DecodeFrame2() outputs later
+  int iStride[2];			// stride of luma and chroma planes
+  int iWidth;				// cropped luma size
+  int iHeight;
+  int iLineStart;			// luma lines [iLineStart, iLineEnd) are decoded and deblocked, chroma lines are half of them
+  int iLineEnd;
+} SDecodedRows;
+
+typedef void (*PDecodedRowsFunc) (void* pContext, const SDecodedRows* pRows);
+
+/* callback set by DECODER_OPTION_ROWS_CALLBACK */
+typedef struct TagDecodedRowsCallback {
+  PDecodedRowsFunc pfnDecodedRows;	// NULL to disable
+  void* pContext;
+} SDecodedRowsCallback;
+
+/* Storage of a decoded picture supplied by the application, see SFrameAllocator */
+typedef struct TagFrameBuffer {
+  int iSize;				// bytes requested by the decoder, planes with the borders used by motion compensation
+  int iWidth;				// size in pixels of the picture to be decoded, uncropped
+  int iHeight;
+  unsigned char* pBuffer;	// set by pfnGetBuffer, aligned to 16 bytes at least
+  void* pOpaque;			// set by pfnGetBuffer for use of the application, output as SBufferInfo::pFrameOpaque
+} SFrameBuffer;
+
+/* fill pBuffer and pOpaque of pFrameBuf, return 0 if successful */
+typedef int (*PGetFrameBufferFunc) (void* pContext, SFrameBuffer* pFrameBuf);
+/* the decoder neither writes nor references the buffer any more */
+typedef void (*PReleaseFrameBufferFunc) (void* pContext, SFrameBuffer* pFrameBuf);
+
+/*
+ *	allocator set by DECODER_OPTION_FRAME_ALLOCATOR, a buffer is got for each picture decoded and kept while the picture
+ *	is referenced or pending output; it is released at a later decoding call or Uninitialize(). The output picture is
+ *	valid until the next decoding call only, unless the application keeps its buffer from being reused after release.
+ *	Both calls are made on the thread calling the decoder.
+ */
+typedef struct TagFrameAllocator {
+  PGetFrameBufferFunc pfnGetBuffer;
+  PReleaseFrameBufferFunc pfnReleaseBuffer;
+  void* pContext;
+} SFrameAllocator;
+
 /* Constants related to transmission rate at various resolutions */
 static const SRateThresholds ksRateThrMap[4] = {
   // initial-maximal-minimal
@@ -0,0 +1,303 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ * \file	WelsMemoryPool.cpp
+ *
+ * \brief	Size class pool behind the aligned allocations of encoder and decoder, shared by all codec instances
+ *		of the process, with usage accounted per allocation tag
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "WelsMemoryPool.h"
+#include "WelsThreadLib.h"
+
+#define POOL_HEADER_SIZE		16		// in front of each block, keeps the alignment the allocator gives
+#define POOL_MIN_CLASS_SHIFT	6		// smallest class holds 64 bytes, 4 classes per power of 2 above
+#define POOL_CLASS_NUM			((31 - POOL_MIN_CLASS_SHIFT) * 4 + 1)
+#define POOL_TAG_HASH_SIZE		1024	// power of 2, twice WELS_MEMORY_MAX_TAG_NUM at least
+
+typedef struct TagPoolBlockHeader {
+  uint32_t	uiSize;			// bytes requested from the allocator, header included
+  int32_t	iTagIdx;
+} SPoolBlockHeader;
+
+static void* DefaultPoolMalloc (void* pUserData, unsigned int uiSize);
+static void DefaultPoolFree (void* pUserData, void* pPtr, unsigned int uiSize);
+
+static SWelsMemoryAllocator	g_sAllocator		= { DefaultPoolMalloc, DefaultPoolFree, NULL };
+static int32_t				g_iBlockNum			= 0;	// blocks allocated through g_sAllocator and not freed yet
+
+#ifdef MT_ENABLED
+
+static WELS_MUTEX			g_mutexMemoryPool;
+static void*				g_pFreeList[POOL_CLASS_NUM];	// blocks freed, linked through their first bytes
+static uint32_t				g_uiCachedBytes		= 0;
+static uint32_t				g_uiPoolLimit		= WELS_MEMORY_POOL_DEFAULT_LIMIT;
+
+static SWelsMemoryTagUsage	g_sTagUsage[WELS_MEMORY_MAX_TAG_NUM];
+static int32_t				g_iTagNum			= 0;
+static int32_t				g_iTagHash[POOL_TAG_HASH_SIZE];	// index + 1 into g_sTagUsage, 0 if empty
+
+static void ReleaseCachedBlocks (const uint32_t kuiLimit);
+
+// mutex of the pool has to be ready before any codec instance is created, cached blocks go back at exit
+class CWelsMemoryPoolMutex {
+ public:
+  CWelsMemoryPoolMutex() {
+    WelsMutexInit (&g_mutexMemoryPool);
+  }
+  ~CWelsMemoryPoolMutex() {
+    ReleaseCachedBlocks (0);
+    WelsMutexDestroy (&g_mutexMemoryPool);
+  }
+};
+static CWelsMemoryPoolMutex g_cMemoryPoolMutex;
+
+static int32_t PoolSizeClass (const uint32_t kuiSize) {
+  if (kuiSize <= (1u << POOL_MIN_CLASS_SHIFT))
+    return 0;
+
+  const uint32_t kuiVal	= kuiSize - 1;
+  int32_t iShift			= POOL_MIN_CLASS_SHIFT;
+  while (kuiVal >> (iShift + 1))
+    ++ iShift;
+  return ((iShift - POOL_MIN_CLASS_SHIFT) << 2) + ((kuiVal >> (iShift - 2)) & 3) + 1;
+}
+
+static uint32_t PoolClassSize (const int32_t kiClass) {
+  if (kiClass == 0)
+    return 1u << POOL_MIN_CLASS_SHIFT;
+
+  const int32_t kiShift = ((kiClass - 1) >> 2) + POOL_MIN_CLASS_SHIFT;
+  return (1u << kiShift) + ((((kiClass - 1) & 3) + 1) << (kiShift - 2));
+}
+
+// called with the pool locked
+static void ReleaseCachedBlocks (const uint32_t kuiLimit) {
+  for (int32_t iClass = POOL_CLASS_NUM - 1; iClass >= 0 && g_uiCachedBytes > kuiLimit; -- iClass) {
+    while (g_pFreeList[iClass] != NULL && g_uiCachedBytes > kuiLimit) {
+      void* pBlock = g_pFreeList[iClass];
+      g_pFreeList[iClass] = * ((void**)pBlock);
+      g_uiCachedBytes -= PoolClassSize (iClass);
+      free (pBlock);
+    }
+  }
+}
+
+static void* DefaultPoolMalloc (void* pUserData, unsigned int uiSize) {
+  if (uiSize > WELS_MEMORY_POOL_MAX_BLOCK)
+    return malloc (uiSize);
+
+  const int32_t kiClass = PoolSizeClass (uiSize);
+  void* pBlock = NULL;
+  WelsMutexLock (&g_mutexMemoryPool);
+  if (g_pFreeList[kiClass] != NULL) {
+    pBlock = g_pFreeList[kiClass];
+    g_pFreeList[kiClass] = * ((void**)pBlock);
+    g_uiCachedBytes -= PoolClassSize (kiClass);
+  }
+  WelsMutexUnlock (&g_mutexMemoryPool);
+
+  if (NULL == pBlock)
+    pBlock = malloc (PoolClassSize (kiClass));
+  return pBlock;
+}
+
+static void DefaultPoolFree (void* pUserData, void* pPtr, unsigned int uiSize) {
+  if (uiSize <= WELS_MEMORY_POOL_MAX_BLOCK) {
+    const int32_t kiClass		= PoolSizeClass (uiSize);
+    const uint32_t kuiClassSize	= PoolClassSize (kiClass);
+    WelsMutexLock (&g_mutexMemoryPool);
+    if (g_uiCachedBytes + kuiClassSize <= g_uiPoolLimit) {
+      * ((void**)pPtr) = g_pFreeList[kiClass];
+      g_pFreeList[kiClass] = pPtr;
+      g_uiCachedBytes += kuiClassSize;
+      pPtr = NULL;
+    }
+    WelsMutexUnlock (&g_mutexMemoryPool);
+  }
+  free (pPtr);
+}
+
+// called with the pool locked, tags are expected to be string literals
+static int32_t LookupTag (const char* kpTag) {
+  uint32_t uiHash = 5381;
+  int32_t i;
+
+  if (NULL == kpTag)
+    kpTag = "unknown";
+  for (i = 0; kpTag[i] != '\0'; ++ i)
+    uiHash = uiHash * 33 + (uint8_t)kpTag[i];
+
+  for (i = 0; i < POOL_TAG_HASH_SIZE; ++ i) {
+    int32_t* pSlot = &g_iTagHash[ (uiHash + i) & (POOL_TAG_HASH_SIZE - 1)];
+    if (*pSlot == 0) {
+      if (g_iTagNum >= WELS_MEMORY_MAX_TAG_NUM - 1)
+        break;
+      g_sTagUsage[g_iTagNum].pTag = kpTag;
+      *pSlot = ++ g_iTagNum;
+      return g_iTagNum - 1;
+    }
+    if (0 == strcmp (g_sTagUsage[*pSlot - 1].pTag, kpTag))
+      return *pSlot - 1;
+  }
+
+  g_sTagUsage[WELS_MEMORY_MAX_TAG_NUM - 1].pTag = "others";
+  return WELS_MEMORY_MAX_TAG_NUM - 1;
+}
+
+#define POOL_LOCK()		WelsMutexLock (&g_mutexMemoryPool)
+#define POOL_UNLOCK()	WelsMutexUnlock (&g_mutexMemoryPool)
+
+#else
+
+// no locking without threading support, so nothing is cached nor accounted
+static void* DefaultPoolMalloc (void* pUserData, unsigned int uiSize) {
+  return malloc (uiSize);
+}
+
+static void DefaultPoolFree (void* pUserData, void* pPtr, unsigned int uiSize) {
+  free (pPtr);
+}
+
+#define POOL_LOCK()
+#define POOL_UNLOCK()
+
+#endif//MT_ENABLED
+
+void* WelsPoolMalloc (const uint32_t kuiSize, const char* kpTag) {
+  const uint32_t kuiBlockSize = kuiSize + POOL_HEADER_SIZE;
+  SWelsMemoryAllocator sAllocator;
+  SPoolBlockHeader* pHeader = NULL;
+  uint8_t* pBlock = NULL;
+
+  if (kuiBlockSize < kuiSize)
+    return NULL;
+
+  // counted before allocation so that the allocator cannot be replaced meanwhile
+  POOL_LOCK();
+  sAllocator = g_sAllocator;
+  ++ g_iBlockNum;
+  POOL_UNLOCK();
+
+  pBlock = (uint8_t*)sAllocator.pfMalloc (sAllocator.pUserData, kuiBlockSize);
+  pHeader = (SPoolBlockHeader*)pBlock;
+
+  POOL_LOCK();
+  if (NULL == pBlock) {
+    -- g_iBlockNum;
+  } else {
+    pHeader->uiSize		= kuiBlockSize;
+    pHeader->iTagIdx	= 0;
+#ifdef MT_ENABLED
+    pHeader->iTagIdx	= LookupTag (kpTag);
+    SWelsMemoryTagUsage* pUsage = &g_sTagUsage[pHeader->iTagIdx];
+    pUsage->uiCurrentBytes += kuiSize;
+    if (pUsage->uiCurrentBytes > pUsage->uiPeakBytes)
+      pUsage->uiPeakBytes = pUsage->uiCurrentBytes;
+    ++ pUsage->uiAllocNum;
+#endif//MT_ENABLED
+  }
+  POOL_UNLOCK();
+
+  return (NULL == pBlock) ? NULL : (pBlock + POOL_HEADER_SIZE);
+}
+
+void WelsPoolFree (void* pPtr) {
+  if (NULL == pPtr)
+    return;
+
+  uint8_t* pBlock					= (uint8_t*)pPtr - POOL_HEADER_SIZE;
+  const SPoolBlockHeader* kpHeader	= (const SPoolBlockHeader*)pBlock;
+  const uint32_t kuiBlockSize		= kpHeader->uiSize;
+#ifdef MT_ENABLED
+  const int32_t kiTagIdx			= kpHeader->iTagIdx;
+#endif//MT_ENABLED
+
+  g_sAllocator.pfFree (g_sAllocator.pUserData, pBlock, kuiBlockSize);
+
+  POOL_LOCK();
+#ifdef MT_ENABLED
+  g_sTagUsage[kiTagIdx].uiCurrentBytes -= kuiBlockSize - POOL_HEADER_SIZE;
+#endif//MT_ENABLED
+  -- g_iBlockNum;
+  POOL_UNLOCK();
+}
+
+int WelsSetMemoryAllocator (const SWelsMemoryAllocator* pAllocator) {
+  static const SWelsMemoryAllocator kDefaultAllocator = { DefaultPoolMalloc, DefaultPoolFree, NULL };
+  int iRet = 0;
+
+  if (pAllocator != NULL && (NULL == pAllocator->pfMalloc || NULL == pAllocator->pfFree))
+    return 1;
+
+  POOL_LOCK();
+  if (g_iBlockNum > 0)
+    iRet = 1;
+  else
+    g_sAllocator = (pAllocator != NULL) ? *pAllocator : kDefaultAllocator;
+  POOL_UNLOCK();
+
+  return iRet;
+}
+
+int WelsSetMemoryPoolLimit (unsigned int uiLimit) {
+#ifdef MT_ENABLED
+  POOL_LOCK();
+  g_uiPoolLimit = uiLimit;
+  ReleaseCachedBlocks (uiLimit);
+  POOL_UNLOCK();
+
+  return 0;
+#else
+  return 1;	// no pool without threading support
+#endif//MT_ENABLED
+}
+
+int WelsGetMemoryTagUsage (SWelsMemoryTagUsage* pUsage, int iMaxNum) {
+  int iNum = 0;
+#ifdef MT_ENABLED
+  if (NULL == pUsage)
+    return 0;
+
+  POOL_LOCK();
+  for (int32_t i = 0; i < WELS_MEMORY_MAX_TAG_NUM && iNum < iMaxNum; ++ i) {
+    if (g_sTagUsage[i].pTag != NULL)
+      pUsage[iNum++] = g_sTagUsage[i];
+  }
+  POOL_UNLOCK();
+#endif//MT_ENABLED
+
+  return iNum;
+}
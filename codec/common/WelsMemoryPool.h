@@ -0,0 +1,86 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ * \file	WelsMemoryPool.h
+ *
+ * \brief	Size class pool behind the aligned allocations of encoder and decoder, shared by all codec instances
+ *		of the process, with usage accounted per allocation tag
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef   _WELS_MEMORY_POOL_H_
+#define   _WELS_MEMORY_POOL_H_
+
+#include "typedefs.h"
+#include "codec_app_def.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#define WELS_MEMORY_POOL_DEFAULT_LIMIT	(64 << 20)	// bytes of freed blocks kept for reuse by default
+#define WELS_MEMORY_POOL_MAX_BLOCK		(64 << 20)	// larger blocks go back to the system at once
+#define WELS_MEMORY_MAX_TAG_NUM			512			// distinct tags accounted, others are summed up as "others"
+
+/*!
+ * \brief	allocate kuiSize bytes from the current allocator, kpTag names the buffer in the usage report
+ * \return	pointer aligned as the allocator aligns, NULL on failure
+ */
+void* WelsPoolMalloc (const uint32_t kuiSize, const char* kpTag);
+
+/*!
+ * \brief	return memory of WelsPoolMalloc() to the allocator it came from
+ */
+void WelsPoolFree (void* pPtr);
+
+/*!
+ * \brief	replace the default size class pool, NULL restores it; fails while memory is allocated
+ * \return	0 on success
+ */
+int WelsSetMemoryAllocator (const SWelsMemoryAllocator* pAllocator);
+
+/*!
+ * \brief	bytes of freed blocks the default pool keeps for reuse, 0 releases all and disables the cache
+ */
+int WelsSetMemoryPoolLimit (unsigned int uiLimit);
+
+/*!
+ * \brief	copy usage of at most iMaxNum tags into pUsage, in order of first allocation
+ * \return	number of tags copied
+ */
+int WelsGetMemoryTagUsage (SWelsMemoryTagUsage* pUsage, int iMaxNum);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif//_WELS_MEMORY_POOL_H_
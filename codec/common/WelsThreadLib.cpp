@@ -58,6 +58,7 @@
 
 #include "WelsThreadLib.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 #ifdef MT_ENABLED
 
@@ -139,6 +140,28 @@ WELS_THREAD_ERROR_CODE    WelsEventDestroy (WELS_EVENT* event) {
   return WELS_THREAD_ERROR_OK;
 }
 
+WELS_THREAD_ERROR_CODE    WelsEventCreate (WELS_EVENT** p_event) {
+  if (p_event == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+  *p_event = (WELS_EVENT*)malloc (sizeof (WELS_EVENT));
+  if (*p_event == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+  if (WelsEventInit (*p_event) != WELS_THREAD_ERROR_OK) {
+    free (*p_event);
+    *p_event = NULL;
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE    WelsEventFree (WELS_EVENT* event) {
+  if (event == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+  WelsEventDestroy (event);
+  free (event);
+  return WELS_THREAD_ERROR_OK;
+}
+
 
 WELS_THREAD_ERROR_CODE    WelsThreadCreate (WELS_THREAD_HANDLE* thread,  LPWELS_THREAD_ROUTINE  routine,
     void* arg, WELS_THREAD_ATTR attr) {
@@ -287,6 +310,27 @@ WELS_THREAD_ERROR_CODE    WelsEventClose (WELS_EVENT* event, char* event_name) {
   return err;
 }
 
+WELS_THREAD_ERROR_CODE    WelsEventCreate (WELS_EVENT** p_event) {
+  char name[32] = {0};
+  WELS_THREAD_ERROR_CODE err = 0;
+
+  if (p_event == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+  // the name is only needed until the semaphore is opened, it is removed at once so that neither other processes
+  // nor later instances can get it; 31 characters at most on mac
+  snprintf (name, sizeof (name), "we%d_%p", (int32_t)getpid(), (void*)p_event);
+  err = WelsEventOpen (p_event, name);
+  if (err == WELS_THREAD_ERROR_OK)
+    sem_unlink (name);
+  return err;
+}
+
+WELS_THREAD_ERROR_CODE    WelsEventFree (WELS_EVENT* event) {
+  if (event == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+  return WelsEventClose (event, NULL);
+}
+
 WELS_THREAD_ERROR_CODE   WelsEventSignal (WELS_EVENT* event) {
   WELS_THREAD_ERROR_CODE err = 0;
 //	int32_t val = 0;
@@ -115,6 +115,12 @@ WELS_THREAD_ERROR_CODE    WelsEventClose (WELS_EVENT* event, char* event_name);
 #endif//__GNUC__
 WELS_THREAD_ERROR_CODE    WelsEventInit (WELS_EVENT* event);
 WELS_THREAD_ERROR_CODE    WelsEventDestroy (WELS_EVENT* event);
+/*!
+ * \brief	create/free event usable on every platform, a named semaphore for posix since unnamed ones
+ *		are not supported on mac; *p_event is NULL on failure
+ */
+WELS_THREAD_ERROR_CODE    WelsEventCreate (WELS_EVENT** p_event);
+WELS_THREAD_ERROR_CODE    WelsEventFree (WELS_EVENT* event);
 WELS_THREAD_ERROR_CODE    WelsEventSignal (WELS_EVENT* event);
 WELS_THREAD_ERROR_CODE    WelsEventReset (WELS_EVENT* event);
 WELS_THREAD_ERROR_CODE    WelsEventWait (WELS_EVENT* event);
@@ -0,0 +1,399 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	WelsThreadPool.cpp
+ *
+ * \brief	Work stealing pool of worker threads, either private or shared by all codec instances of the process
+ *
+ * \date	10/17/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include "WelsThreadPool.h"
+
+#ifdef MT_ENABLED
+
+static WELS_MUTEX       g_mutexSharedPool;
+static SWelsThreadPool* g_pSharedPool		= NULL;
+static int32_t          g_iSharedPoolRef	= 0;
+static int32_t          g_iSharedPoolSize	= 0;	// 0: one worker per logical processor
+
+// mutex of the shared pool has to be ready before any codec instance is created
+class CWelsSharedPoolMutex {
+ public:
+  CWelsSharedPoolMutex() {
+    WelsMutexInit (&g_mutexSharedPool);
+  }
+  ~CWelsSharedPoolMutex() {
+    WelsMutexDestroy (&g_mutexSharedPool);
+  }
+};
+static CWelsSharedPoolMutex g_cSharedPoolMutex;
+
+static SWelsThreadTask* PopQueueTask (SWelsThreadWorker* pWorker, SWelsThreadTaskGroup* pGroup) {
+  SWelsThreadTask* pPrev = NULL;
+  SWelsThreadTask* pTask = NULL;
+
+  WelsMutexLock (&pWorker->mutexQueue);
+  pTask = pWorker->pTaskHead;
+  while (pTask != NULL && pGroup != NULL && pTask->pGroup != pGroup) {
+    pPrev = pTask;
+    pTask = pTask->pNext;
+  }
+  if (pTask != NULL) {
+    if (pPrev != NULL)
+      pPrev->pNext = pTask->pNext;
+    else
+      pWorker->pTaskHead = pTask->pNext;
+    if (pWorker->pTaskTail == pTask)
+      pWorker->pTaskTail = pPrev;
+    pTask->pNext = NULL;
+  }
+  WelsMutexUnlock (&pWorker->mutexQueue);
+
+  return pTask;
+}
+
+// own queue first, then steal from the others; pGroup != NULL only takes tasks of that group
+static SWelsThreadTask* TakeTask (SWelsThreadPool* pPool, const int32_t kiFirst, SWelsThreadTaskGroup* pGroup) {
+  int32_t i = 0;
+
+  for (i = 0; i < pPool->iThreadNum; i++) {
+    SWelsThreadTask* pTask = PopQueueTask (&pPool->pWorkers[ (kiFirst + i) % pPool->iThreadNum], pGroup);
+    if (pTask != NULL)
+      return pTask;
+  }
+  return NULL;
+}
+
+static void RunTask (SWelsThreadTask* pTask) {
+  SWelsThreadTaskGroup* pGroup = pTask->pGroup;	// task may be reused by its owner once the group is done
+
+  pTask->pProc (pTask->pArg);
+
+  if (pGroup != NULL) {
+    WelsMutexLock (&pGroup->mutexGroup);
+    if (-- pGroup->iPendingNum == 0 && pGroup->bWaiting) {
+      pGroup->bWaiting = false;
+      WelsEventSignal (pGroup->pDoneEvent);
+    }
+    WelsMutexUnlock (&pGroup->mutexGroup);
+  }
+}
+
+static WELS_THREAD_ROUTINE_TYPE WelsThreadPoolWorker (void* pArg) {
+  SWelsThreadWorker* pWorker = (SWelsThreadWorker*)pArg;
+  SWelsThreadPool* pPool = pWorker->pPool;
+
+  while (true) {
+    SWelsThreadTask* pTask = TakeTask (pPool, pWorker->iIndex, NULL);
+
+    if (pTask == NULL) {
+      // look again under the pool mutex, tasks are queued while holding it so none can be missed before sleeping
+      WelsMutexLock (&pPool->mutexPool);
+      pTask = TakeTask (pPool, pWorker->iIndex, NULL);
+      if (pTask == NULL) {
+        if (pPool->bStop) {
+          WelsMutexUnlock (&pPool->mutexPool);
+          break;
+        }
+        // a worker whose wait failed is still in the list, it must not be added twice
+        if (!pWorker->bIdle) {
+          pWorker->pNextIdle	= pPool->pIdleWorkers;
+          pPool->pIdleWorkers	= pWorker;
+          pWorker->bIdle		= true;
+        }
+      }
+      WelsMutexUnlock (&pPool->mutexPool);
+    }
+
+    if (pTask != NULL)
+      RunTask (pTask);
+    else if (WelsEventWait (pWorker->pWakeEvent) != WELS_THREAD_ERROR_OK)
+      WelsSleep (1);	// interrupted or failed, look for tasks again without spinning on the event
+  }
+
+  WELS_THREAD_ROUTINE_RETURN (0);
+}
+
+static void StopPool (SWelsThreadPool* pPool, const int32_t kiStartedNum) {
+  int32_t i = 0;
+
+  WelsMutexLock (&pPool->mutexPool);
+  pPool->bStop = true;
+  while (pPool->pIdleWorkers != NULL) {
+    pPool->pIdleWorkers->bIdle = false;
+    WelsEventSignal (pPool->pIdleWorkers->pWakeEvent);
+    pPool->pIdleWorkers = pPool->pIdleWorkers->pNextIdle;
+  }
+  WelsMutexUnlock (&pPool->mutexPool);
+
+  for (i = 0; i < kiStartedNum; i++) {
+    WelsThreadJoin (pPool->pWorkers[i].hThread);
+  }
+  for (i = 0; i < pPool->iThreadNum; i++) {
+    WelsEventFree (pPool->pWorkers[i].pWakeEvent);
+    WelsMutexDestroy (&pPool->pWorkers[i].mutexQueue);
+  }
+  WelsMutexDestroy (&pPool->mutexPool);
+  free (pPool->pWorkers);
+  free (pPool);
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadPoolCreate (SWelsThreadPool** ppPool, int32_t iThreadNum) {
+  SWelsThreadPool* pPool = NULL;
+  int32_t i = 0;
+
+  if (ppPool == NULL || iThreadNum <= 0)
+    return WELS_THREAD_ERROR_GENERAL;
+  *ppPool = NULL;
+
+  pPool = (SWelsThreadPool*)malloc (sizeof (SWelsThreadPool));
+  if (pPool == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+  memset (pPool, 0, sizeof (SWelsThreadPool));
+
+  pPool->pWorkers = (SWelsThreadWorker*)malloc (iThreadNum * sizeof (SWelsThreadWorker));
+  if (pPool->pWorkers == NULL) {
+    free (pPool);
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  memset (pPool->pWorkers, 0, iThreadNum * sizeof (SWelsThreadWorker));
+  if (WelsMutexInit (&pPool->mutexPool) != WELS_THREAD_ERROR_OK) {
+    free (pPool->pWorkers);
+    free (pPool);
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+
+  // all queues exist before the first worker may try to steal
+  for (i = 0; i < iThreadNum; i++) {
+    SWelsThreadWorker* pWorker = &pPool->pWorkers[i];
+    pWorker->pPool	= pPool;
+    pWorker->iIndex	= i;
+    if (WelsMutexInit (&pWorker->mutexQueue) != WELS_THREAD_ERROR_OK)
+      break;
+    if (WelsEventCreate (&pWorker->pWakeEvent) != WELS_THREAD_ERROR_OK) {
+      WelsMutexDestroy (&pWorker->mutexQueue);
+      break;
+    }
+  }
+  pPool->iThreadNum = i;	// workers with queue and event, StopPool frees just those
+  if (i < iThreadNum) {
+    StopPool (pPool, 0);
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+
+  for (i = 0; i < iThreadNum; i++) {
+    if (WelsThreadCreate (&pPool->pWorkers[i].hThread, WelsThreadPoolWorker, &pPool->pWorkers[i], 0) != WELS_THREAD_ERROR_OK)
+      break;
+  }
+  if (i < iThreadNum) {
+    StopPool (pPool, i);
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+
+  *ppPool = pPool;
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadPoolDestroy (SWelsThreadPool* pPool) {
+  if (pPool == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+
+  StopPool (pPool, pPool->iThreadNum);
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadPoolQueueTask (SWelsThreadPool* pPool, SWelsThreadTask* pTask) {
+  SWelsThreadWorker* pWorker = NULL;
+
+  if (pPool == NULL || pTask == NULL || pTask->pProc == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+
+  if (pTask->pGroup != NULL) {
+    WelsMutexLock (&pTask->pGroup->mutexGroup);
+    ++ pTask->pGroup->iPendingNum;
+    WelsMutexUnlock (&pTask->pGroup->mutexGroup);
+  }
+
+  pTask->pNext = NULL;
+  WelsMutexLock (&pPool->mutexPool);
+  pWorker = &pPool->pWorkers[pPool->iNextQueue];
+  pPool->iNextQueue = (pPool->iNextQueue + 1) % pPool->iThreadNum;
+
+  WelsMutexLock (&pWorker->mutexQueue);
+  if (pWorker->pTaskTail != NULL)
+    pWorker->pTaskTail->pNext = pTask;
+  else
+    pWorker->pTaskHead = pTask;
+  pWorker->pTaskTail = pTask;
+  WelsMutexUnlock (&pWorker->mutexQueue);
+
+  // one sleeping worker is enough for one task, it does not matter which queue the task is in
+  if (pPool->pIdleWorkers != NULL) {
+    SWelsThreadWorker* pIdle = pPool->pIdleWorkers;
+    pPool->pIdleWorkers = pIdle->pNextIdle;
+    pIdle->bIdle = false;
+    WelsEventSignal (pIdle->pWakeEvent);
+  }
+  WelsMutexUnlock (&pPool->mutexPool);
+
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadPoolWaitGroup (SWelsThreadPool* pPool, SWelsThreadTaskGroup* pGroup) {
+  if (pPool == NULL || pGroup == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+
+  while (true) {
+    // help the workers instead of sleeping while tasks of the group are still queued
+    SWelsThreadTask* pTask = TakeTask (pPool, 0, pGroup);
+    if (pTask != NULL) {
+      RunTask (pTask);
+      continue;
+    }
+
+    WelsMutexLock (&pGroup->mutexGroup);
+    if (pGroup->iPendingNum == 0) {
+      WelsMutexUnlock (&pGroup->mutexGroup);
+      break;
+    }
+    pGroup->bWaiting = true;
+    WelsMutexUnlock (&pGroup->mutexGroup);
+
+    // a stale or failed wake up only costs another look at the pending count
+    if (WelsEventWait (pGroup->pDoneEvent) != WELS_THREAD_ERROR_OK)
+      WelsSleep (1);
+  }
+
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadTaskGroupInit (SWelsThreadTaskGroup* pGroup) {
+  if (pGroup == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+
+  pGroup->iPendingNum	= 0;
+  pGroup->bWaiting	= false;
+  if (WelsEventCreate (&pGroup->pDoneEvent) != WELS_THREAD_ERROR_OK)
+    return WELS_THREAD_ERROR_GENERAL;
+  if (WelsMutexInit (&pGroup->mutexGroup) != WELS_THREAD_ERROR_OK) {
+    WelsEventFree (pGroup->pDoneEvent);
+    pGroup->pDoneEvent = NULL;
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadTaskGroupDestroy (SWelsThreadTaskGroup* pGroup) {
+  if (pGroup == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+
+  if (pGroup->pDoneEvent == NULL)	// init failed or destroyed already
+    return WELS_THREAD_ERROR_GENERAL;
+  WelsEventFree (pGroup->pDoneEvent);
+  pGroup->pDoneEvent = NULL;
+  return WelsMutexDestroy (&pGroup->mutexGroup);
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadPoolAttachShared (SWelsThreadPool** ppPool) {
+  WELS_THREAD_ERROR_CODE iRet = WELS_THREAD_ERROR_OK;
+
+  if (ppPool == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+  *ppPool = NULL;
+
+  WelsMutexLock (&g_mutexSharedPool);
+  if (g_pSharedPool == NULL) {
+    int32_t iThreadNum = g_iSharedPoolSize;
+    if (iThreadNum <= 0) {
+      WelsLogicalProcessInfo sInfo;
+      sInfo.ProcessorCount = 1;
+      WelsQueryLogicalProcessInfo (&sInfo);
+      iThreadNum = sInfo.ProcessorCount > 1 ? sInfo.ProcessorCount : 1;
+    }
+    iRet = WelsThreadPoolCreate (&g_pSharedPool, iThreadNum);
+  }
+  if (g_pSharedPool != NULL) {
+    ++ g_iSharedPoolRef;
+    *ppPool = g_pSharedPool;
+  }
+  WelsMutexUnlock (&g_mutexSharedPool);
+
+  return iRet;
+}
+
+WELS_THREAD_ERROR_CODE WelsThreadPoolDetachShared (SWelsThreadPool* pPool) {
+  SWelsThreadPool* pLastPool = NULL;
+
+  if (pPool == NULL)
+    return WELS_THREAD_ERROR_GENERAL;
+
+  WelsMutexLock (&g_mutexSharedPool);
+  if (pPool != g_pSharedPool || g_iSharedPoolRef <= 0) {
+    WelsMutexUnlock (&g_mutexSharedPool);
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  if (-- g_iSharedPoolRef == 0) {
+    pLastPool = g_pSharedPool;
+    g_pSharedPool = NULL;
+  }
+  WelsMutexUnlock (&g_mutexSharedPool);
+
+  // joining the workers does not need the lock, a new attach simply creates another pool
+  if (pLastPool != NULL)
+    WelsThreadPoolDestroy (pLastPool);
+
+  return WELS_THREAD_ERROR_OK;
+}
+
+#endif//MT_ENABLED
+
+int WelsSetSharedThreadPoolSize (int iThreadNum) {
+#ifdef MT_ENABLED
+  int iRet = 0;
+
+  if (iThreadNum < 0)
+    return 1;
+
+  WelsMutexLock (&g_mutexSharedPool);
+  if (g_pSharedPool != NULL)
+    iRet = 1;
+  else
+    g_iSharedPoolSize = iThreadNum;
+  WelsMutexUnlock (&g_mutexSharedPool);
+
+  return iRet;
+#else
+  return 1;	// no pool without threading support
+#endif//MT_ENABLED
+}
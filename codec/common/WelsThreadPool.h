@@ -0,0 +1,146 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	WelsThreadPool.h
+ *
+ * \brief	Work stealing pool of worker threads, either private or shared by all codec instances of the process
+ *
+ * \date	10/17/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef   _WELS_THREAD_POOL_H_
+#define   _WELS_THREAD_POOL_H_
+
+#include "WelsThreadLib.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#ifdef MT_ENABLED
+
+typedef void (*PWelsThreadTaskProc) (void* pArg);
+
+/*!
+ * \brief	set of tasks the submitter waits for at once, see WelsThreadPoolWaitGroup
+ */
+typedef struct TagWelsThreadTaskGroup {
+  WELS_MUTEX            mutexGroup;
+  WELS_EVENT*           pDoneEvent;	// signaled when the last task of a waited group is done
+  int32_t               iPendingNum;	// tasks queued or running
+  bool                  bWaiting;
+} SWelsThreadTaskGroup;
+
+/*!
+ * \brief	task item queued into pool, memory is owned by the caller and must stay valid until pProc returns
+ */
+typedef struct TagWelsThreadTask {
+  PWelsThreadTaskProc         pProc;
+  void*                       pArg;
+  SWelsThreadTaskGroup*       pGroup;	// NULL if the task does not belong to a group
+  struct TagWelsThreadTask*   pNext;	// used by pool internally
+} SWelsThreadTask;
+
+struct TagWelsThreadPool;
+
+typedef struct TagWelsThreadWorker {
+  struct TagWelsThreadPool*   pPool;
+  int32_t                     iIndex;
+  WELS_THREAD_HANDLE          hThread;
+  WELS_MUTEX                  mutexQueue;
+  SWelsThreadTask*            pTaskHead;	// oldest task, taken first by owner and by other workers alike
+  SWelsThreadTask*            pTaskTail;
+  WELS_EVENT*                 pWakeEvent;
+  struct TagWelsThreadWorker* pNextIdle;
+  bool                        bIdle;	// in the idle list of the pool, a wake up is pending until it is taken out
+} SWelsThreadWorker;
+
+typedef struct TagWelsThreadPool {
+  SWelsThreadWorker*    pWorkers;
+  int32_t               iThreadNum;
+  WELS_MUTEX            mutexPool;	// protects the fields below, taken before any queue mutex
+  SWelsThreadWorker*    pIdleWorkers;	// workers sleeping on their wake event
+  int32_t               iNextQueue;	// round robin position for new tasks
+  bool                  bStop;
+} SWelsThreadPool;
+
+/*!
+ * \brief	create private pool with iThreadNum workers
+ * \return	WELS_THREAD_ERROR_OK on success, *ppPool is NULL on failure
+ */
+WELS_THREAD_ERROR_CODE    WelsThreadPoolCreate (SWelsThreadPool** ppPool, int32_t iThreadNum);
+
+/*!
+ * \brief	stop all workers after pending tasks are done and free the pool
+ */
+WELS_THREAD_ERROR_CODE    WelsThreadPoolDestroy (SWelsThreadPool* pPool);
+
+/*!
+ * \brief	queue task to a worker, idle workers steal it if its worker is busy;
+ *		tasks are started in submission order as far as workers are free
+ */
+WELS_THREAD_ERROR_CODE    WelsThreadPoolQueueTask (SWelsThreadPool* pPool, SWelsThreadTask* pTask);
+
+/*!
+ * \brief	wait until all tasks queued with pGroup are done, the calling thread runs queued tasks of the group meanwhile
+ */
+WELS_THREAD_ERROR_CODE    WelsThreadPoolWaitGroup (SWelsThreadPool* pPool, SWelsThreadTaskGroup* pGroup);
+
+WELS_THREAD_ERROR_CODE    WelsThreadTaskGroupInit (SWelsThreadTaskGroup* pGroup);
+WELS_THREAD_ERROR_CODE    WelsThreadTaskGroupDestroy (SWelsThreadTaskGroup* pGroup);
+
+/*!
+ * \brief	attach to the pool shared by the process, it is created by the first attach
+ *		with the worker count set by WelsSetSharedThreadPoolSize()
+ */
+WELS_THREAD_ERROR_CODE    WelsThreadPoolAttachShared (SWelsThreadPool** ppPool);
+
+/*!
+ * \brief	detach from the shared pool, it is destroyed by the last detach
+ */
+WELS_THREAD_ERROR_CODE    WelsThreadPoolDetachShared (SWelsThreadPool* pPool);
+
+#endif//MT_ENABLED
+
+/*!
+ * \brief	cap the number of workers of the shared pool, 0 means one per logical processor;
+ *		fails while codec instances are attached to the pool
+ * \return	0 on success
+ */
+int WelsSetSharedThreadPoolSize (int iThreadNum);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif//_WELS_THREAD_POOL_H_
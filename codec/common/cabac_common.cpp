@@ -0,0 +1,552 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	cabac_common.cpp
+ *
+ * \brief	Context initialization and probability state tables of CABAC shared by encoder and decoder
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include "cabac_common.h"
+#include "macros.h"
+
+// Table 9-12 ~ 9-33 of the spec, the order of models is cabac_init_idc 0, 1, 2 then I slice
+const int8_t g_kiCabacGlobalContextIdx[WELS_CONTEXT_COUNT][4][2] = {
+  { { 20, -15}, { 20, -15}, { 20, -15}, { 20, -15} },	// 0
+  { {  2,  54}, {  2,  54}, {  2,  54}, {  2,  54} },
+  { {  3,  74}, {  3,  74}, {  3,  74}, {  3,  74} },
+  { { 20, -15}, { 20, -15}, { 20, -15}, { 20, -15} },
+  { {  2,  54}, {  2,  54}, {  2,  54}, {  2,  54} },
+  { {  3,  74}, {  3,  74}, {  3,  74}, {  3,  74} },
+  { {-28, 127}, {-28, 127}, {-28, 127}, {-28, 127} },
+  { {-23, 104}, {-23, 104}, {-23, 104}, {-23, 104} },
+  { { -6,  53}, { -6,  53}, { -6,  53}, { -6,  53} },
+  { { -1,  54}, { -1,  54}, { -1,  54}, { -1,  54} },
+  { {  7,  51}, {  7,  51}, {  7,  51}, {  7,  51} },
+  { { 23,  33}, { 22,  25}, { 29,  16}, {  0,   0} },
+  { { 23,   2}, { 34,   0}, { 25,   0}, {  0,   0} },
+  { { 21,   0}, { 16,   0}, { 14,   0}, {  0,   0} },
+  { {  1,   9}, { -2,   9}, {-10,  51}, {  0,   0} },
+  { {  0,  49}, {  4,  41}, { -3,  62}, {  0,   0} },
+  { {-37, 118}, {-29, 118}, {-27,  99}, {  0,   0} },
+  { {  5,  57}, {  2,  65}, { 26,  16}, {  0,   0} },
+  { {-13,  78}, { -6,  71}, { -4,  85}, {  0,   0} },
+  { {-11,  65}, {-13,  79}, {-24, 102}, {  0,   0} },
+  { {  1,  62}, {  5,  52}, {  5,  57}, {  0,   0} },	// 20
+  { { 12,  49}, {  9,  50}, {  6,  57}, {  0,   0} },
+  { { -4,  73}, { -3,  70}, {-17,  73}, {  0,   0} },
+  { { 17,  50}, { 10,  54}, { 14,  57}, {  0,   0} },
+  { { 18,  64}, { 26,  34}, { 20,  40}, {  0,   0} },
+  { {  9,  43}, { 19,  22}, { 20,  10}, {  0,   0} },
+  { { 29,   0}, { 40,   0}, { 29,   0}, {  0,   0} },
+  { { 26,  67}, { 57,   2}, { 54,   0}, {  0,   0} },
+  { { 16,  90}, { 41,  36}, { 37,  42}, {  0,   0} },
+  { {  9, 104}, { 26,  69}, { 12,  97}, {  0,   0} },
+  { {-46, 127}, {-45, 127}, {-32, 127}, {  0,   0} },
+  { {-20, 104}, {-15, 101}, {-22, 117}, {  0,   0} },
+  { {  1,  67}, { -4,  76}, { -2,  74}, {  0,   0} },
+  { {-13,  78}, { -6,  71}, { -4,  85}, {  0,   0} },
+  { {-11,  65}, {-13,  79}, {-24, 102}, {  0,   0} },
+  { {  1,  62}, {  5,  52}, {  5,  57}, {  0,   0} },
+  { { -6,  86}, {  6,  69}, { -6,  93}, {  0,   0} },
+  { {-17,  95}, {-13,  90}, {-14,  88}, {  0,   0} },
+  { { -6,  61}, {  0,  52}, { -6,  44}, {  0,   0} },
+  { {  9,  45}, {  8,  43}, {  4,  55}, {  0,   0} },
+  { { -3,  69}, { -2,  69}, {-11,  89}, {  0,   0} },	// 40
+  { { -6,  81}, { -5,  82}, {-15, 103}, {  0,   0} },
+  { {-11,  96}, {-10,  96}, {-21, 116}, {  0,   0} },
+  { {  6,  55}, {  2,  59}, { 19,  57}, {  0,   0} },
+  { {  7,  67}, {  2,  75}, { 20,  58}, {  0,   0} },
+  { { -5,  86}, { -3,  87}, {  4,  84}, {  0,   0} },
+  { {  2,  88}, { -3, 100}, {  6,  96}, {  0,   0} },
+  { {  0,  58}, {  1,  56}, {  1,  63}, {  0,   0} },
+  { { -3,  76}, { -3,  74}, { -5,  85}, {  0,   0} },
+  { {-10,  94}, { -6,  85}, {-13, 106}, {  0,   0} },
+  { {  5,  54}, {  0,  59}, {  5,  63}, {  0,   0} },
+  { {  4,  69}, { -3,  81}, {  6,  75}, {  0,   0} },
+  { { -3,  81}, { -7,  86}, { -3,  90}, {  0,   0} },
+  { {  0,  88}, { -5,  95}, { -1, 101}, {  0,   0} },
+  { { -7,  67}, { -1,  66}, {  3,  55}, {  0,   0} },
+  { { -5,  74}, { -1,  77}, { -4,  79}, {  0,   0} },
+  { { -4,  74}, {  1,  70}, { -2,  75}, {  0,   0} },
+  { { -5,  80}, { -2,  86}, {-12,  97}, {  0,   0} },
+  { { -7,  72}, { -5,  72}, { -7,  50}, {  0,   0} },
+  { {  1,  58}, {  0,  61}, {  1,  60}, {  0,   0} },
+  { {  0,  41}, {  0,  41}, {  0,  41}, {  0,  41} },	// 60
+  { {  0,  63}, {  0,  63}, {  0,  63}, {  0,  63} },
+  { {  0,  63}, {  0,  63}, {  0,  63}, {  0,  63} },
+  { {  0,  63}, {  0,  63}, {  0,  63}, {  0,  63} },
+  { { -9,  83}, { -9,  83}, { -9,  83}, { -9,  83} },
+  { {  4,  86}, {  4,  86}, {  4,  86}, {  4,  86} },
+  { {  0,  97}, {  0,  97}, {  0,  97}, {  0,  97} },
+  { { -7,  72}, { -7,  72}, { -7,  72}, { -7,  72} },
+  { { 13,  41}, { 13,  41}, { 13,  41}, { 13,  41} },
+  { {  3,  62}, {  3,  62}, {  3,  62}, {  3,  62} },
+  { {  0,  45}, { 13,  15}, {  7,  34}, {  0,  11} },
+  { { -4,  78}, {  7,  51}, { -9,  88}, {  1,  55} },
+  { { -3,  96}, {  2,  80}, {-20, 127}, {  0,  69} },
+  { {-27, 126}, {-39, 127}, {-36, 127}, {-17, 127} },
+  { {-28,  98}, {-18,  91}, {-17,  91}, {-13, 102} },
+  { {-25, 101}, {-17,  96}, {-14,  95}, {  0,  82} },
+  { {-23,  67}, {-26,  81}, {-25,  84}, { -7,  74} },
+  { {-28,  82}, {-35,  98}, {-25,  86}, {-21, 107} },
+  { {-20,  94}, {-24, 102}, {-12,  89}, {-27, 127} },
+  { {-16,  83}, {-23,  97}, {-17,  91}, {-31, 127} },
+  { {-22, 110}, {-27, 119}, {-31, 127}, {-24, 127} },	// 80
+  { {-21,  91}, {-24,  99}, {-14,  76}, {-18,  95} },
+  { {-18, 102}, {-21, 110}, {-18, 103}, {-27, 127} },
+  { {-13,  93}, {-18, 102}, {-13,  90}, {-21, 114} },
+  { {-29, 127}, {-36, 127}, {-37, 127}, {-30, 127} },
+  { { -7,  92}, {  0,  80}, { 11,  80}, {-17, 123} },
+  { { -5,  89}, { -5,  89}, {  5,  76}, {-12, 115} },
+  { { -7,  96}, { -7,  94}, {  2,  84}, {-16, 122} },
+  { {-13, 108}, { -4,  92}, {  5,  78}, {-11, 115} },
+  { { -3,  46}, {  0,  39}, { -6,  55}, {-12,  63} },
+  { { -1,  65}, {  0,  65}, {  4,  61}, { -2,  68} },
+  { { -1,  57}, {-15,  84}, {-14,  83}, {-15,  84} },
+  { { -9,  93}, {-35, 127}, {-37, 127}, {-13, 104} },
+  { { -3,  74}, { -2,  73}, { -5,  79}, { -3,  70} },
+  { { -9,  92}, {-12, 104}, {-11, 104}, { -8,  93} },
+  { { -8,  87}, { -9,  91}, {-11,  91}, {-10,  90} },
+  { {-23, 126}, {-31, 127}, {-30, 127}, {-30, 127} },
+  { {  5,  54}, {  3,  55}, {  0,  65}, { -1,  74} },
+  { {  6,  60}, {  7,  56}, { -2,  79}, { -6,  97} },
+  { {  6,  59}, {  7,  55}, {  0,  72}, { -7,  91} },
+  { {  6,  69}, {  8,  61}, { -4,  92}, {-20, 127} },	// 100
+  { { -1,  48}, { -3,  53}, { -6,  56}, { -4,  56} },
+  { {  0,  68}, {  0,  68}, {  3,  68}, { -5,  82} },
+  { { -4,  69}, { -7,  74}, { -8,  71}, { -7,  76} },
+  { { -8,  88}, { -9,  88}, {-13,  98}, {-22, 125} },
+  { { -2,  85}, {-13, 103}, { -4,  86}, { -7,  93} },
+  { { -6,  78}, {-13,  91}, {-12,  88}, {-11,  87} },
+  { { -1,  75}, { -9,  89}, { -5,  82}, { -3,  77} },
+  { { -7,  77}, {-14,  92}, { -3,  72}, { -5,  71} },
+  { {  2,  54}, { -8,  76}, { -4,  67}, { -4,  63} },
+  { {  5,  50}, {-12,  87}, { -8,  72}, { -4,  68} },
+  { { -3,  68}, {-23, 110}, {-16,  89}, {-12,  84} },
+  { {  1,  50}, {-24, 105}, { -9,  69}, { -7,  62} },
+  { {  6,  42}, {-10,  78}, { -1,  59}, { -7,  65} },
+  { { -4,  81}, {-20, 112}, {  5,  66}, {  8,  61} },
+  { {  1,  63}, {-17,  99}, {  4,  57}, {  5,  56} },
+  { { -4,  70}, {-78, 127}, { -4,  71}, { -2,  66} },
+  { {  0,  67}, {-70, 127}, { -2,  71}, {  1,  64} },
+  { {  2,  57}, {-50, 127}, {  2,  58}, {  0,  61} },
+  { { -2,  76}, {-46, 127}, { -1,  74}, { -2,  78} },
+  { { 11,  35}, { -4,  66}, { -4,  44}, {  1,  50} },	// 120
+  { {  4,  64}, { -5,  78}, { -1,  69}, {  7,  52} },
+  { {  1,  61}, { -4,  71}, {  0,  62}, { 10,  35} },
+  { { 11,  35}, { -8,  72}, { -7,  51}, {  0,  44} },
+  { { 18,  25}, {  2,  59}, { -4,  47}, { 11,  38} },
+  { { 12,  24}, { -1,  55}, { -6,  42}, {  1,  45} },
+  { { 13,  29}, { -7,  70}, { -3,  41}, {  0,  46} },
+  { { 13,  36}, { -6,  75}, { -6,  53}, {  5,  44} },
+  { {-10,  93}, { -8,  89}, {  8,  76}, { 31,  17} },
+  { { -7,  73}, {-34, 119}, { -9,  78}, {  1,  51} },
+  { { -2,  73}, { -3,  75}, {-11,  83}, {  7,  50} },
+  { { 13,  46}, { 32,  20}, {  9,  52}, { 28,  19} },
+  { {  9,  49}, { 30,  22}, {  0,  67}, { 16,  33} },
+  { { -7, 100}, {-44, 127}, { -5,  90}, { 14,  62} },
+  { {  9,  53}, {  0,  54}, {  1,  67}, {-13, 108} },
+  { {  2,  53}, { -5,  61}, {-15,  72}, {-15, 100} },
+  { {  5,  53}, {  0,  58}, { -5,  75}, {-13, 101} },
+  { { -2,  61}, { -1,  60}, { -8,  80}, {-13,  91} },
+  { {  0,  56}, { -3,  61}, {-21,  83}, {-12,  94} },
+  { {  0,  56}, { -8,  67}, {-21,  64}, {-10,  88} },
+  { {-13,  63}, {-25,  84}, {-13,  31}, {-16,  84} },	// 140
+  { { -5,  60}, {-14,  74}, {-25,  64}, {-10,  86} },
+  { { -1,  62}, { -5,  65}, {-29,  94}, { -7,  83} },
+  { {  4,  57}, {  5,  52}, {  9,  75}, {-13,  87} },
+  { { -6,  69}, {  2,  57}, { 17,  63}, {-19,  94} },
+  { {  4,  57}, {  0,  61}, { -8,  74}, {  1,  70} },
+  { { 14,  39}, { -9,  69}, { -5,  35}, {  0,  72} },
+  { {  4,  51}, {-11,  70}, { -2,  27}, { -5,  74} },
+  { { 13,  68}, { 18,  55}, { 13,  91}, { 18,  59} },
+  { {  3,  64}, { -4,  71}, {  3,  65}, { -8, 102} },
+  { {  1,  61}, {  0,  58}, { -7,  69}, {-15, 100} },
+  { {  9,  63}, {  7,  61}, {  8,  77}, {  0,  95} },
+  { {  7,  50}, {  9,  41}, {-10,  66}, { -4,  75} },
+  { { 16,  39}, { 18,  25}, {  3,  62}, {  2,  72} },
+  { {  5,  44}, {  9,  32}, { -3,  68}, {-11,  75} },
+  { {  4,  52}, {  5,  43}, {-20,  81}, { -3,  71} },
+  { { 11,  48}, {  9,  47}, {  0,  30}, { 15,  46} },
+  { { -5,  60}, {  0,  44}, {  1,   7}, {-13,  69} },
+  { { -1,  59}, {  0,  51}, { -3,  23}, {  0,  62} },
+  { {  0,  59}, {  2,  46}, {-21,  74}, {  0,  65} },
+  { { 22,  33}, { 19,  38}, { 16,  66}, { 21,  37} },	// 160
+  { {  5,  44}, { -4,  66}, {-23, 124}, {-15,  72} },
+  { { 14,  43}, { 15,  38}, { 17,  37}, {  9,  57} },
+  { { -1,  78}, { 12,  42}, { 44, -18}, { 16,  54} },
+  { {  0,  60}, {  9,  34}, { 50, -34}, {  0,  62} },
+  { {  9,  69}, {  0,  89}, {-22, 127}, { 12,  72} },
+  { { 11,  28}, {  4,  45}, {  4,  39}, { 24,   0} },
+  { {  2,  40}, { 10,  28}, {  0,  42}, { 15,   9} },
+  { {  3,  44}, { 10,  31}, {  7,  34}, {  8,  25} },
+  { {  0,  49}, { 33, -11}, { 11,  29}, { 13,  18} },
+  { {  0,  46}, { 52, -43}, {  8,  31}, { 15,   9} },
+  { {  2,  44}, { 18,  15}, {  6,  37}, { 13,  19} },
+  { {  2,  51}, { 28,   0}, {  7,  42}, { 10,  37} },
+  { {  0,  47}, { 35, -22}, {  3,  40}, { 12,  18} },
+  { {  4,  39}, { 38, -25}, {  8,  33}, {  6,  29} },
+  { {  2,  62}, { 34,   0}, { 13,  43}, { 20,  33} },
+  { {  6,  46}, { 39, -18}, { 13,  36}, { 15,  30} },
+  { {  0,  54}, { 32, -12}, {  4,  47}, {  4,  45} },
+  { {  3,  54}, {102, -94}, {  3,  55}, {  1,  58} },
+  { {  2,  58}, {  0,   0}, {  2,  58}, {  0,  62} },
+  { {  4,  63}, { 56, -15}, {  6,  60}, {  7,  61} },	// 180
+  { {  6,  51}, { 33,  -4}, {  8,  44}, { 12,  38} },
+  { {  6,  57}, { 29,  10}, { 11,  44}, { 11,  45} },
+  { {  7,  53}, { 37,  -5}, { 14,  42}, { 15,  39} },
+  { {  6,  52}, { 51, -29}, {  7,  48}, { 11,  42} },
+  { {  6,  55}, { 39,  -9}, {  4,  56}, { 13,  44} },
+  { { 11,  45}, { 52, -34}, {  4,  52}, { 16,  45} },
+  { { 14,  36}, { 69, -58}, { 13,  37}, { 12,  41} },
+  { {  8,  53}, { 67, -63}, {  9,  49}, { 10,  49} },
+  { { -1,  82}, { 44,  -5}, { 19,  58}, { 30,  34} },
+  { {  7,  55}, { 32,   7}, { 10,  48}, { 18,  42} },
+  { { -3,  78}, { 55, -29}, { 12,  45}, { 10,  55} },
+  { { 15,  46}, { 32,   1}, {  0,  69}, { 17,  51} },
+  { { 22,  31}, {  0,   0}, { 20,  33}, { 17,  46} },
+  { { -1,  84}, { 27,  36}, {  8,  63}, {  0,  89} },
+  { { 25,   7}, { 33, -25}, { 35, -18}, { 26, -19} },
+  { { 30,  -7}, { 34, -30}, { 33, -25}, { 22, -17} },
+  { { 28,   3}, { 36, -28}, { 28,  -3}, { 26, -17} },
+  { { 28,   4}, { 38, -28}, { 24,  10}, { 30, -25} },
+  { { 32,   0}, { 38, -27}, { 27,   0}, { 28, -20} },
+  { { 34,  -1}, { 34, -18}, { 34, -14}, { 33, -23} },	// 200
+  { { 30,   6}, { 35, -16}, { 52, -44}, { 37, -27} },
+  { { 30,   6}, { 34, -14}, { 39, -24}, { 33, -23} },
+  { { 32,   9}, { 32,  -8}, { 19,  17}, { 40, -28} },
+  { { 31,  19}, { 37,  -6}, { 31,  25}, { 38, -17} },
+  { { 26,  27}, { 35,   0}, { 36,  29}, { 33, -11} },
+  { { 26,  30}, { 30,  10}, { 24,  33}, { 40, -15} },
+  { { 37,  20}, { 28,  18}, { 34,  15}, { 41,  -6} },
+  { { 28,  34}, { 26,  25}, { 30,  20}, { 38,   1} },
+  { { 17,  70}, { 29,  41}, { 22,  73}, { 41,  17} },
+  { {  1,  67}, {  0,  75}, { 20,  34}, { 30,  -6} },
+  { {  5,  59}, {  2,  72}, { 19,  31}, { 27,   3} },
+  { {  9,  67}, {  8,  77}, { 27,  44}, { 26,  22} },
+  { { 16,  30}, { 14,  35}, { 19,  16}, { 37, -16} },
+  { { 18,  32}, { 18,  31}, { 15,  36}, { 35,  -4} },
+  { { 18,  35}, { 17,  35}, { 15,  36}, { 38,  -8} },
+  { { 22,  29}, { 21,  30}, { 21,  28}, { 38,  -3} },
+  { { 24,  31}, { 17,  45}, { 25,  21}, { 37,   3} },
+  { { 23,  38}, { 20,  42}, { 30,  20}, { 38,   5} },
+  { { 18,  43}, { 18,  45}, { 31,  12}, { 42,   0} },
+  { { 20,  41}, { 27,  26}, { 27,  16}, { 35,  16} },	// 220
+  { { 11,  63}, { 16,  54}, { 24,  42}, { 39,  22} },
+  { {  9,  59}, {  7,  66}, {  0,  93}, { 14,  48} },
+  { {  9,  64}, { 16,  56}, { 14,  56}, { 27,  37} },
+  { { -1,  94}, { 11,  73}, { 15,  57}, { 21,  60} },
+  { { -2,  89}, { 10,  67}, { 26,  38}, { 12,  68} },
+  { { -9, 108}, {-10, 116}, {-24, 127}, {  2,  97} },
+  { { -6,  76}, {-23, 112}, {-24, 115}, { -3,  71} },
+  { { -2,  44}, {-15,  71}, {-22,  82}, { -6,  42} },
+  { {  0,  45}, { -7,  61}, { -9,  62}, { -5,  50} },
+  { {  0,  52}, {  0,  53}, {  0,  53}, { -3,  54} },
+  { { -3,  64}, { -5,  66}, {  0,  59}, { -2,  62} },
+  { { -2,  59}, {-11,  77}, {-14,  85}, {  0,  58} },
+  { { -4,  70}, { -9,  80}, {-13,  89}, {  1,  63} },
+  { { -4,  75}, { -9,  84}, {-13,  94}, { -2,  72} },
+  { { -8,  82}, {-10,  87}, {-11,  92}, { -1,  74} },
+  { {-17, 102}, {-34, 127}, {-29, 127}, { -9,  91} },
+  { { -9,  77}, {-21, 101}, {-21, 100}, { -5,  67} },
+  { {  3,  24}, { -3,  39}, {-14,  57}, { -5,  27} },
+  { {  0,  42}, { -5,  53}, {-12,  67}, { -3,  39} },
+  { {  0,  48}, { -7,  61}, {-11,  71}, { -2,  44} },	// 240
+  { {  0,  55}, {-11,  75}, {-10,  77}, {  0,  46} },
+  { { -6,  59}, {-15,  77}, {-21,  85}, {-16,  64} },
+  { { -7,  71}, {-17,  91}, {-16,  88}, { -8,  68} },
+  { {-12,  83}, {-25, 107}, {-23, 104}, {-10,  78} },
+  { {-11,  87}, {-25, 111}, {-15,  98}, { -6,  77} },
+  { {-30, 119}, {-28, 122}, {-37, 127}, {-10,  86} },
+  { {  1,  58}, {-11,  76}, {-10,  82}, {-12,  92} },
+  { { -3,  29}, {-10,  44}, { -8,  48}, {-15,  55} },
+  { { -1,  36}, {-10,  52}, { -8,  61}, {-10,  60} },
+  { {  1,  38}, {-10,  57}, { -8,  66}, { -6,  62} },
+  { {  2,  43}, { -9,  58}, { -7,  70}, { -4,  65} },
+  { { -6,  55}, {-16,  72}, {-14,  75}, {-12,  73} },
+  { {  0,  58}, { -7,  69}, {-10,  79}, { -8,  76} },
+  { {  0,  64}, { -4,  69}, { -9,  83}, { -7,  80} },
+  { { -3,  74}, { -5,  74}, {-12,  92}, { -9,  88} },
+  { {-10,  90}, { -9,  86}, {-18, 108}, {-17, 110} },
+  { {  0,  70}, {  2,  66}, { -4,  79}, {-11,  97} },
+  { { -4,  29}, { -9,  34}, {-22,  69}, {-20,  84} },
+  { {  5,  31}, {  1,  32}, {-16,  75}, {-11,  79} },
+  { {  7,  42}, { 11,  31}, { -2,  58}, { -6,  73} },	// 260
+  { {  1,  59}, {  5,  52}, {  1,  58}, { -4,  74} },
+  { { -2,  58}, { -2,  55}, {-13,  78}, {-13,  86} },
+  { { -3,  72}, { -2,  67}, { -9,  83}, {-13,  96} },
+  { { -3,  81}, {  0,  73}, { -4,  81}, {-11,  97} },
+  { {-11,  97}, { -8,  89}, {-13,  99}, {-19, 117} },
+  { {  0,  58}, {  3,  52}, {-13,  81}, { -8,  78} },
+  { {  8,   5}, {  7,   4}, { -6,  38}, { -5,  33} },
+  { { 10,  14}, { 10,   8}, {-13,  62}, { -4,  48} },
+  { { 14,  18}, { 17,   8}, { -6,  58}, { -2,  53} },
+  { { 13,  27}, { 16,  19}, { -2,  59}, { -3,  62} },
+  { {  2,  40}, {  3,  37}, {-16,  73}, {-13,  71} },
+  { {  0,  58}, { -1,  61}, {-10,  76}, {-10,  79} },
+  { { -3,  70}, { -5,  73}, {-13,  86}, {-12,  86} },
+  { { -6,  79}, { -1,  70}, { -9,  83}, {-13,  90} },
+  { { -8,  85}, { -4,  78}, {-10,  87}, {-14,  97} },
+  { {  0,   0}, {  0,   0}, {  0,   0}, {  0,   0} },
+  { {-13, 106}, {-21, 126}, {-22, 127}, { -6,  93} },
+  { {-16, 106}, {-23, 124}, {-25, 127}, { -6,  84} },
+  { {-10,  87}, {-20, 110}, {-25, 120}, { -8,  79} },
+  { {-21, 114}, {-26, 126}, {-27, 127}, {  0,  66} },	// 280
+  { {-18, 110}, {-25, 124}, {-19, 114}, { -1,  71} },
+  { {-14,  98}, {-17, 105}, {-23, 117}, {  0,  62} },
+  { {-22, 110}, {-27, 121}, {-25, 118}, { -2,  60} },
+  { {-21, 106}, {-27, 117}, {-26, 117}, { -2,  59} },
+  { {-18, 103}, {-17, 102}, {-24, 113}, { -5,  75} },
+  { {-21, 107}, {-26, 117}, {-28, 118}, { -3,  62} },
+  { {-23, 108}, {-27, 116}, {-31, 120}, { -4,  58} },
+  { {-26, 112}, {-33, 122}, {-37, 124}, { -9,  66} },
+  { {-10,  96}, {-10,  95}, {-10,  94}, { -1,  79} },
+  { {-12,  95}, {-14, 100}, {-15, 102}, {  0,  71} },
+  { { -5,  91}, { -8,  95}, {-10,  99}, {  3,  68} },
+  { { -9,  93}, {-17, 111}, {-13, 106}, { 10,  44} },
+  { {-22,  94}, {-28, 114}, {-50, 127}, { -7,  62} },
+  { { -5,  86}, { -6,  89}, { -5,  92}, { 15,  36} },
+  { {  9,  67}, { -2,  80}, { 17,  57}, { 14,  40} },
+  { { -4,  80}, { -4,  82}, { -5,  86}, { 16,  27} },
+  { {-10,  85}, { -9,  85}, {-13,  94}, { 12,  29} },
+  { { -1,  70}, { -8,  81}, {-12,  91}, {  1,  44} },
+  { {  7,  60}, { -1,  72}, { -2,  77}, { 20,  36} },
+  { {  9,  58}, {  5,  64}, {  0,  71}, { 18,  32} },	// 300
+  { {  5,  61}, {  1,  67}, { -1,  73}, {  5,  42} },
+  { { 12,  50}, {  9,  56}, {  4,  64}, {  1,  48} },
+  { { 15,  50}, {  0,  69}, { -7,  81}, { 10,  62} },
+  { { 18,  49}, {  1,  69}, {  5,  64}, { 17,  46} },
+  { { 17,  54}, {  7,  69}, { 15,  57}, {  9,  64} },
+  { { 10,  41}, { -7,  69}, {  1,  67}, {-12, 104} },
+  { {  7,  46}, { -6,  67}, {  0,  68}, {-11,  97} },
+  { { -1,  51}, {-16,  77}, {-10,  67}, {-16,  96} },
+  { {  7,  49}, { -2,  64}, {  1,  68}, { -7,  88} },
+  { {  8,  52}, {  2,  61}, {  0,  77}, { -8,  85} },
+  { {  9,  41}, { -6,  67}, {  2,  64}, { -7,  85} },
+  { {  6,  47}, { -3,  64}, {  0,  68}, { -9,  85} },
+  { {  2,  55}, {  2,  57}, { -5,  78}, {-13,  88} },
+  { { 13,  41}, { -3,  65}, {  7,  55}, {  4,  66} },
+  { { 10,  44}, { -3,  66}, {  5,  59}, { -3,  77} },
+  { {  6,  50}, {  0,  62}, {  2,  65}, { -3,  76} },
+  { {  5,  53}, {  9,  51}, { 14,  54}, { -6,  76} },
+  { { 13,  49}, { -1,  66}, { 15,  44}, { 10,  58} },
+  { {  4,  63}, { -2,  71}, {  5,  60}, { -1,  76} },
+  { {  6,  64}, { -2,  75}, {  2,  70}, { -1,  83} },	// 320
+  { { -2,  69}, { -1,  70}, { -2,  76}, { -7,  99} },
+  { { -2,  59}, { -9,  72}, {-18,  86}, {-14,  95} },
+  { {  6,  70}, { 14,  60}, { 12,  70}, {  2,  95} },
+  { { 10,  44}, { 16,  37}, {  5,  64}, {  0,  76} },
+  { {  9,  31}, {  0,  47}, {-12,  70}, { -5,  74} },
+  { { 12,  43}, { 18,  35}, { 11,  55}, {  0,  70} },
+  { {  3,  53}, { 11,  37}, {  5,  56}, {-11,  75} },
+  { { 14,  34}, { 12,  41}, {  0,  69}, {  1,  68} },
+  { { 10,  38}, { 10,  41}, {  2,  65}, {  0,  65} },
+  { { -3,  52}, {  2,  48}, { -6,  74}, {-14,  73} },
+  { { 13,  40}, { 12,  41}, {  5,  54}, {  3,  62} },
+  { { 17,  32}, { 13,  41}, {  7,  54}, {  4,  62} },
+  { {  7,  44}, {  0,  59}, { -6,  76}, { -1,  68} },
+  { {  7,  38}, {  3,  50}, {-11,  82}, {-13,  75} },
+  { { 13,  50}, { 19,  40}, { -2,  77}, { 11,  55} },
+  { { 10,  57}, {  3,  66}, { -2,  77}, {  5,  64} },
+  { { 26,  43}, { 18,  50}, { 25,  42}, { 12,  70} },
+  { { 14,  11}, { 19,  -6}, { 17, -13}, { 15,   6} },
+  { { 11,  14}, { 18,  -6}, { 16,  -9}, {  6,  19} },
+  { {  9,  11}, { 14,   0}, { 17, -12}, {  7,  16} },	// 340
+  { { 18,  11}, { 26, -12}, { 27, -21}, { 12,  14} },
+  { { 21,   9}, { 31, -16}, { 37, -30}, { 18,  13} },
+  { { 23,  -2}, { 33, -25}, { 41, -40}, { 13,  11} },
+  { { 32, -15}, { 33, -22}, { 42, -41}, { 13,  15} },
+  { { 32, -15}, { 37, -28}, { 48, -47}, { 15,  16} },
+  { { 34, -21}, { 39, -30}, { 39, -32}, { 12,  23} },
+  { { 39, -23}, { 42, -30}, { 46, -40}, { 13,  23} },
+  { { 42, -33}, { 47, -42}, { 52, -51}, { 15,  20} },
+  { { 41, -31}, { 45, -36}, { 46, -41}, { 14,  26} },
+  { { 46, -28}, { 49, -34}, { 52, -39}, { 14,  44} },
+  { { 38, -12}, { 41, -17}, { 43, -19}, { 17,  40} },
+  { { 21,  29}, { 32,   9}, { 32,  11}, { 17,  47} },
+  { { 45, -24}, { 69, -71}, { 61, -55}, { 24,  17} },
+  { { 53, -45}, { 63, -63}, { 56, -46}, { 21,  21} },
+  { { 48, -26}, { 66, -64}, { 62, -50}, { 25,  22} },
+  { { 65, -43}, { 77, -74}, { 81, -67}, { 31,  27} },
+  { { 43, -19}, { 54, -39}, { 45, -20}, { 22,  29} },
+  { { 39, -10}, { 52, -35}, { 35,  -2}, { 19,  35} },
+  { { 30,   9}, { 41, -10}, { 28,  15}, { 14,  50} },
+  { { 18,  26}, { 36,   0}, { 34,   1}, { 10,  57} },	// 360
+  { { 20,  27}, { 40,  -1}, { 39,   1}, {  7,  63} },
+  { {  0,  57}, { 30,  14}, { 30,  17}, { -2,  77} },
+  { {-14,  82}, { 28,  26}, { 20,  38}, { -4,  82} },
+  { { -5,  75}, { 23,  37}, { 18,  45}, { -3,  94} },
+  { {-19,  97}, { 12,  55}, { 15,  54}, {  9,  69} },
+  { {-35, 125}, { 11,  65}, {  0,  79}, {-12, 109} },
+  { { 27,   0}, { 37, -33}, { 36, -16}, { 36, -35} },
+  { { 28,   0}, { 39, -36}, { 37, -14}, { 36, -34} },
+  { { 31,  -4}, { 40, -37}, { 37, -17}, { 32, -26} },
+  { { 27,   6}, { 38, -30}, { 32,   1}, { 37, -30} },
+  { { 34,   8}, { 46, -33}, { 34,  15}, { 44, -32} },
+  { { 30,  10}, { 42, -30}, { 29,  15}, { 34, -18} },
+  { { 24,  22}, { 40, -24}, { 24,  25}, { 34, -15} },
+  { { 33,  19}, { 49, -29}, { 34,  22}, { 40, -15} },
+  { { 22,  32}, { 38, -12}, { 31,  16}, { 33,  -7} },
+  { { 26,  31}, { 40, -10}, { 35,  18}, { 35,  -5} },
+  { { 21,  41}, { 38,  -3}, { 31,  28}, { 33,   0} },
+  { { 26,  44}, { 46,  -5}, { 33,  41}, { 38,   2} },
+  { { 23,  47}, { 31,  20}, { 36,  28}, { 33,  13} },
+  { { 16,  65}, { 29,  30}, { 27,  47}, { 23,  35} },	// 380
+  { { 14,  71}, { 25,  44}, { 21,  62}, { 13,  58} },
+  { {  8,  60}, { 12,  48}, { 18,  31}, { 29,  -3} },
+  { {  6,  63}, { 11,  49}, { 19,  26}, { 26,   0} },
+  { { 17,  65}, { 26,  45}, { 36,  24}, { 22,  30} },
+  { { 21,  24}, { 22,  22}, { 24,  23}, { 31,  -7} },
+  { { 23,  20}, { 23,  22}, { 27,  16}, { 35, -15} },
+  { { 26,  23}, { 27,  21}, { 24,  30}, { 34,  -3} },
+  { { 27,  32}, { 33,  20}, { 31,  29}, { 34,   3} },
+  { { 28,  23}, { 26,  28}, { 22,  41}, { 36,  -1} },
+  { { 28,  24}, { 30,  24}, { 22,  42}, { 34,   5} },
+  { { 23,  40}, { 27,  34}, { 16,  60}, { 32,  11} },
+  { { 24,  32}, { 18,  42}, { 15,  52}, { 35,   5} },
+  { { 28,  29}, { 25,  39}, { 14,  60}, { 34,  12} },
+  { { 23,  42}, { 18,  50}, {  3,  78}, { 39,  11} },
+  { { 19,  57}, { 12,  70}, {-16, 123}, { 30,  29} },
+  { { 22,  53}, { 21,  54}, { 21,  53}, { 34,  26} },
+  { { 22,  61}, { 14,  71}, { 22,  56}, { 29,  39} },
+  { { 11,  86}, { 11,  83}, { 25,  61}, { 19,  66} },
+  { { 12,  40}, { 25,  32}, { 21,  33}, { 31,  21} },
+  { { 11,  51}, { 21,  49}, { 19,  50}, { 31,  31} },	// 400
+  { { 14,  59}, { 21,  54}, { 17,  61}, { 25,  50} },
+  { { -4,  79}, { -5,  85}, { -3,  78}, {-17, 120} },
+  { { -7,  71}, { -6,  81}, { -8,  74}, {-20, 112} },
+  { { -5,  69}, {-10,  77}, { -9,  72}, {-18, 114} },
+  { { -9,  70}, { -7,  81}, {-10,  72}, {-11,  85} },
+  { { -8,  66}, {-17,  80}, {-18,  75}, {-15,  92} },
+  { {-10,  68}, {-18,  73}, {-12,  71}, {-14,  89} },
+  { {-19,  73}, { -4,  74}, {-11,  63}, {-26,  71} },
+  { {-12,  69}, {-10,  83}, { -5,  70}, {-15,  81} },
+  { {-16,  70}, { -9,  71}, {-17,  75}, {-14,  80} },
+  { {-15,  67}, { -9,  67}, {-14,  72}, {  0,  68} },
+  { {-20,  62}, { -1,  61}, {-16,  67}, {-14,  70} },
+  { {-19,  70}, { -8,  66}, { -8,  53}, {-24,  56} },
+  { {-16,  66}, {-14,  66}, {-14,  59}, {-23,  68} },
+  { {-22,  65}, {  0,  59}, { -9,  52}, {-24,  50} },
+  { {-20,  63}, {  2,  59}, {-11,  68}, {-11,  74} },
+  { {  9,  -2}, { 17, -10}, {  9,  -2}, { 23, -13} },
+  { { 26,  -9}, { 32, -13}, { 30, -10}, { 26, -13} },
+  { { 33,  -9}, { 42,  -9}, { 31,  -4}, { 40, -15} },
+  { { 39,  -7}, { 49,  -5}, { 33,  -1}, { 49, -14} },	// 420
+  { { 41,  -2}, { 53,   0}, { 33,   7}, { 44,   3} },
+  { { 45,   3}, { 64,   3}, { 31,  12}, { 45,   6} },
+  { { 49,   9}, { 68,  10}, { 37,  23}, { 44,  34} },
+  { { 45,  27}, { 66,  27}, { 31,  38}, { 33,  54} },
+  { { 36,  59}, { 47,  57}, { 20,  64}, { 19,  82} },
+  { { -6,  66}, { -5,  71}, { -9,  71}, { -3,  75} },
+  { { -7,  35}, {  0,  24}, { -7,  37}, { -1,  23} },
+  { { -7,  42}, { -1,  36}, { -8,  44}, {  1,  34} },
+  { { -8,  45}, { -2,  42}, {-11,  49}, {  1,  43} },
+  { { -5,  48}, { -2,  52}, {-10,  56}, {  0,  54} },
+  { {-12,  56}, { -9,  57}, {-12,  59}, { -2,  55} },
+  { { -6,  60}, { -6,  63}, { -8,  63}, {  0,  61} },
+  { { -5,  62}, { -4,  65}, { -9,  67}, {  1,  64} },
+  { { -8,  66}, { -4,  67}, { -6,  68}, {  0,  68} },
+  { { -8,  76}, { -7,  82}, {-10,  79}, { -9,  92} },
+  { { -5,  85}, { -3,  81}, { -3,  78}, {-14, 106} },
+  { { -6,  81}, { -3,  76}, { -8,  74}, {-13,  97} },
+  { {-10,  77}, { -7,  72}, { -9,  72}, {-15,  90} },
+  { { -7,  81}, { -6,  78}, {-10,  72}, {-12,  90} },
+  { {-17,  80}, {-12,  72}, {-18,  75}, {-18,  88} },	// 440
+  { {-18,  73}, {-14,  68}, {-12,  71}, {-10,  73} },
+  { { -4,  74}, { -3,  70}, {-11,  63}, { -9,  79} },
+  { {-10,  83}, { -6,  76}, { -5,  70}, {-14,  86} },
+  { { -9,  71}, { -5,  66}, {-17,  75}, {-10,  73} },
+  { { -9,  67}, { -5,  62}, {-14,  72}, {-10,  70} },
+  { { -1,  61}, {  0,  57}, {-16,  67}, {-10,  69} },
+  { { -8,  66}, { -4,  61}, { -8,  53}, { -5,  66} },
+  { {-14,  66}, { -9,  60}, {-14,  59}, { -9,  64} },
+  { {  0,  59}, {  1,  54}, { -9,  52}, { -5,  58} },
+  { {  2,  59}, {  2,  58}, {-11,  68}, {  2,  59} },
+  { { 21, -13}, { 17, -10}, {  9,  -2}, { 21, -10} },
+  { { 33, -14}, { 32, -13}, { 30, -10}, { 24, -11} },
+  { { 39,  -7}, { 42,  -9}, { 31,  -4}, { 28,  -8} },
+  { { 46,  -2}, { 49,  -5}, { 33,  -1}, { 28,  -1} },
+  { { 51,   2}, { 53,   0}, { 33,   7}, { 29,   3} },
+  { { 60,   6}, { 64,   3}, { 31,  12}, { 29,   9} },
+  { { 61,  17}, { 68,  10}, { 37,  23}, { 35,  20} },
+  { { 55,  34}, { 66,  27}, { 31,  38}, { 29,  36} },
+  { { 42,  62}, { 47,  57}, { 20,  64}, { 14,  67} },
+};
+
+// Table 9-44 of the spec, indexed by pStateIdx and qCodIRangeIdx
+const uint8_t g_kuiCabacRangeLps[64][4] = {
+  {128, 176, 208, 240}, {128, 167, 197, 227}, {128, 158, 187, 216}, {123, 150, 178, 205},
+  {116, 142, 169, 195}, {111, 135, 160, 185}, {105, 128, 152, 175}, {100, 122, 144, 166},
+  { 95, 116, 137, 158}, { 90, 110, 130, 150}, { 85, 104, 123, 142}, { 81,  99, 117, 135},
+  { 77,  94, 111, 128}, { 73,  89, 105, 122}, { 69,  85, 100, 116}, { 66,  80,  95, 110},
+  { 62,  76,  90, 104}, { 59,  72,  86,  99}, { 56,  69,  81,  94}, { 53,  65,  77,  89},
+  { 51,  62,  73,  85}, { 48,  59,  69,  80}, { 46,  56,  66,  76}, { 43,  53,  63,  72},
+  { 41,  50,  59,  69}, { 39,  48,  56,  65}, { 37,  45,  54,  62}, { 35,  43,  51,  59},
+  { 33,  41,  48,  56}, { 32,  39,  46,  53}, { 30,  37,  43,  50}, { 29,  35,  41,  48},
+  { 27,  33,  39,  45}, { 26,  31,  37,  43}, { 24,  30,  35,  41}, { 23,  28,  33,  39},
+  { 22,  27,  32,  37}, { 21,  26,  30,  35}, { 20,  24,  29,  33}, { 19,  23,  27,  31},
+  { 18,  22,  26,  30}, { 17,  21,  25,  28}, { 16,  20,  23,  27}, { 15,  19,  22,  25},
+  { 14,  18,  21,  24}, { 14,  17,  20,  23}, { 13,  16,  19,  22}, { 12,  15,  18,  21},
+  { 12,  14,  17,  20}, { 11,  14,  16,  19}, { 11,  13,  15,  18}, { 10,  12,  15,  17},
+  { 10,  12,  14,  16}, {  9,  11,  13,  15}, {  9,  11,  12,  14}, {  8,  10,  12,  14},
+  {  8,   9,  11,  13}, {  7,   9,  11,  12}, {  7,   9,  10,  12}, {  7,   8,  10,  11},
+  {  6,   8,   9,  11}, {  6,   7,   9,  10}, {  6,   7,   8,   9}, {  2,   2,   2,   2},
+};
+
+// Table 9-45 of the spec, transIdxLPS and transIdxMPS
+const uint8_t g_kuiStateTransTable[64][2] = {
+  { 0,  1}, { 0,  2}, { 1,  3}, { 2,  4}, { 2,  5}, { 4,  6}, { 4,  7}, { 5,  8},
+  { 6,  9}, { 7, 10}, { 8, 11}, { 9, 12}, { 9, 13}, {11, 14}, {11, 15}, {12, 16},
+  {13, 17}, {13, 18}, {15, 19}, {15, 20}, {16, 21}, {16, 22}, {18, 23}, {18, 24},
+  {19, 25}, {19, 26}, {21, 27}, {21, 28}, {22, 29}, {22, 30}, {23, 31}, {24, 32},
+  {24, 33}, {25, 34}, {26, 35}, {26, 36}, {27, 37}, {27, 38}, {28, 39}, {29, 40},
+  {29, 41}, {30, 42}, {30, 43}, {30, 44}, {31, 45}, {32, 46}, {32, 47}, {33, 48},
+  {33, 49}, {33, 50}, {34, 51}, {34, 52}, {35, 53}, {35, 54}, {35, 55}, {36, 56},
+  {36, 57}, {36, 58}, {37, 59}, {37, 60}, {37, 61}, {38, 62}, {38, 62}, {63, 63},
+};
+
+void WelsCabacContextStateInit (uint8_t* pStateCtx, const int32_t kiModel, const int32_t kiSliceQp) {
+  const int32_t kiQp = WELS_CLIP3 (kiSliceQp, 0, 51);
+  int32_t i;
+
+  for (i = 0; i < WELS_CONTEXT_COUNT; i++) {
+    const int32_t kiPreCtxState = WELS_CLIP3 ((((g_kiCabacGlobalContextIdx[i][kiModel][0] * kiQp) >> 4) +
+                                  g_kiCabacGlobalContextIdx[i][kiModel][1]), 1, 126);
+    if (kiPreCtxState <= 63)
+      pStateCtx[i] = WELS_CABAC_STATE (63 - kiPreCtxState, 0);
+    else
+      pStateCtx[i] = WELS_CABAC_STATE (kiPreCtxState - 64, 1);
+  }
+}
@@ -0,0 +1,71 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	cabac_common.h
+ *
+ * \brief	Context initialization and probability state tables of CABAC shared by encoder and decoder
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_CABAC_COMMON_H__
+#define WELS_CABAC_COMMON_H__
+
+#include "typedefs.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif//__cplusplus
+
+#define WELS_CONTEXT_COUNT		460	// ctxIdx 0..459, covers all of frame coded 4:2:0 without 8x8 transform
+#define WELS_CABAC_MODEL_I		3	// model index of I slices, 0..2 are P slices with cabac_init_idc 0..2
+
+/*
+ * context states are packed into one byte, (pStateIdx << 1) | valMPS
+ */
+#define WELS_CABAC_STATE(iStateIdx, iMps)	(((iStateIdx) << 1) | (iMps))
+
+extern const int8_t		g_kiCabacGlobalContextIdx[WELS_CONTEXT_COUNT][4][2];	// (m, n) per model
+extern const uint8_t	g_kuiCabacRangeLps[64][4];
+extern const uint8_t	g_kuiStateTransTable[64][2];	// 0: next state on LPS; 1: next state on MPS
+
+/*!
+ * \brief	initialize packed context states for slice QP with model of cabac_init_idc or I slice
+ */
+void WelsCabacContextStateInit (uint8_t* pStateCtx, const int32_t kiModel, const int32_t kiSliceQp);
+
+#if defined(__cplusplus)
+}
+#endif//__cplusplus
+
+#endif//WELS_CABAC_COMMON_H__
@@ -132,6 +132,16 @@ uint32_t WelsCPUFeatureDetect (int32_t* pNumberOfLogicProcessors) {
     /* MOVBE checking */
     uiCPU |= WELS_CPU_MOVBE;
   }
+  /* AVX2 also needs OSXSAVE and the xmm/ymm state enabled in XCR0, checked by WelsCPUSupportAVX on the leaf 1 flags;
+     leaf 7 goes into its own registers, the leaf 1 EBX is still needed for the logic processor count below */
+  if (uiMaxCpuidLevel >= 7 && WelsCPUSupportAVX (uiFeatureA, uiFeatureC)) {
+    uint32_t uiExtFeatureA = 0, uiExtFeatureB = 0, uiExtFeatureC = 0, uiExtFeatureD = 0;	// sub-leaf 0 in ECX
+    WelsCPUId (7, &uiExtFeatureA, &uiExtFeatureB, &uiExtFeatureC, &uiExtFeatureD);
+    if (uiExtFeatureB & 0x00000020) {
+      /* AVX2 supported */
+      uiCPU |= WELS_CPU_AVX2;
+    }
+  }
 
   if( pNumberOfLogicProcessors != NULL ){
     if( uiCPU & WELS_CPU_HTT){
@@ -1,10 +1,13 @@
 COMMON_SRCDIR=codec/common
 COMMON_CPP_SRCS=\
+	$(COMMON_SRCDIR)/cabac_common.cpp\
 	$(COMMON_SRCDIR)/cpu.cpp\
 	$(COMMON_SRCDIR)/crt_util_safe_x.cpp\
 	$(COMMON_SRCDIR)/deblocking_common.cpp\
 	$(COMMON_SRCDIR)/logging.cpp\
+	$(COMMON_SRCDIR)/WelsMemoryPool.cpp\
 	$(COMMON_SRCDIR)/WelsThreadLib.cpp\
+	$(COMMON_SRCDIR)/WelsThreadPool.cpp\
 
 COMMON_OBJS += $(COMMON_CPP_SRCS:.cpp=.o)
 
@@ -191,6 +191,10 @@ int ParseConfig (CReadConfig& cRdCfg, SEncParamExt& pSvcParam, SFilesSet& sFileS
           pSvcParam.iMultipleThreadIdc = 0;
         else if (pSvcParam.iMultipleThreadIdc > MAX_THREADS_NUM)
           pSvcParam.iMultipleThreadIdc = MAX_THREADS_NUM;
+      } else if (strTag[0].compare ("UseSharedThreadPool") == 0) {
+        pSvcParam.bUseSharedThreadPool	= atoi (strTag[1].c_str()) ? true : false;
+      } else if (strTag[0].compare ("EnableWavefront") == 0) {
+        pSvcParam.bEnableWavefront	= atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("EnableRC") == 0) {
         pSvcParam.bEnableRc	= atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("RCMode") == 0) {
@@ -206,6 +210,8 @@ int ParseConfig (CReadConfig& cRdCfg, SEncParamExt& pSvcParam, SFilesSet& sFileS
         }
       } else if (strTag[0].compare ("EnableDenoise") == 0) {
         pSvcParam.bEnableDenoise	= atoi (strTag[1].c_str()) ? true : false;
+      } else if (strTag[0].compare ("EnableTemporalDenoise") == 0) {
+        pSvcParam.bEnableTemporalDenoise	= atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("EnableSceneChangeDetection") == 0) {
         pSvcParam.bEnableSceneChangeDetect	= atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("EnableBackgroundDetection") == 0) {
@@ -214,6 +220,10 @@ int ParseConfig (CReadConfig& cRdCfg, SEncParamExt& pSvcParam, SFilesSet& sFileS
         pSvcParam.bEnableAdaptiveQuant	= atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("EnableFrameSkip") == 0) {
         pSvcParam.bEnableFrameSkip	= atoi (strTag[1].c_str()) ? true : false;
+      } else if (strTag[0].compare ("LookaheadFrames") == 0) {
+        pSvcParam.iLookaheadFrames	= atoi (strTag[1].c_str());
+      } else if (strTag[0].compare ("MotionSearchPreset") == 0) {
+        pSvcParam.eMotionSearchPreset	= (ME_SEARCH_PRESET)atoi (strTag[1].c_str());
       } else if (strTag[0].compare ("EnableLongTermReference") == 0) {
         pSvcParam.bEnableLongTermReference	= atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("LtrMarkPeriod") == 0) {
@@ -283,6 +293,8 @@ int ParseConfig (CReadConfig& cRdCfg, SEncParamExt& pSvcParam, SFilesSet& sFileS
 #endif//ENABLE_FRAME_DUMP
         } else if (strTag[0].compare ("ProfileIdc") == 0) {
           pDLayer->uiProfileIdc	= atoi (strTag[1].c_str());
+        } else if (strTag[0].compare ("EntropyCodingModeFlag") == 0) {
+          pDLayer->iEntropyCodingModeFlag	= atoi (strTag[1].c_str());
         } else if (strTag[0].compare ("FRExt") == 0) {
 //					pDLayer->frext_mode	= (bool)atoi(strTag[1].c_str());
         } else if (strTag[0].compare ("SpatialBitrate") == 0) {
@@ -347,6 +359,9 @@ int ParseCommandLine (int argc, char** argv, SEncParamExt& sParam) {
     else if (!strcmp (pCmd, "-denois") && (i < argc))
       sParam.bEnableDenoise = atoi (argv[i++]) ? true : false;
 
+    else if (!strcmp (pCmd, "-tdenois") && (i < argc))
+      sParam.bEnableTemporalDenoise = atoi (argv[i++]) ? true : false;
+
     else if (!strcmp (pCmd, "-bgd") && (i < argc))
       sParam.bEnableBackgroundDetection = atoi (argv[i++]) ? true : false;
 
@@ -399,12 +414,17 @@ void PrintHelp() {
   printf ("  -iper   Intra period (default: -1) : must be a power of 2 of GOP size (or -1)\n");
   printf ("  -spsid   Enable id adding in SPS/PPS per IDR \n");
   printf ("  -denois Control denoising  (default: 0)\n");
+  printf ("  -tdenois Control temporal denoising of static blocks (default: 0)\n");
   printf ("  -scene  Control scene change detection (default: 0)\n");
   printf ("  -bgd    Control background detection (default: 0)\n");
   printf ("  -aq     Control adaptive quantization (default: 0)\n");
   printf ("  -ltr    Control long term reference (default: 0)\n");
   printf ("  -rc	  Control rate control: 0-disable; 1-enable \n");
   printf ("  -tarb	  Overall target bitrate\n");
+  printf ("  -lookahead Number of frames analyzed ahead by rate control (default: 0)\n");
+  printf ("  -threadpool Code slices on the thread pool shared by the process: 0-own threads; 1-shared pool (default: 0)\n");
+  printf ("  -wavefront  Code MB rows of a single slice layer by multiple threads: 0-disable; 1-enable (default: 0)\n");
+  printf ("  -me     Motion search preset: 0-fast; 1-medium; 2-slow (default: 0)\n");
   printf ("  -numl   Number Of Layers: Must exist with layer_cfg file and the number of input layer_cfg file must equal to the value set by this command\n");
   printf ("  The options below are layer-based: (need to be set with layer id)\n");
   printf ("  -org		(Layer) (original file); example: -org 0 src.yuv\n");
@@ -449,6 +469,9 @@ int ParseCommandLine (int argc, char** argv, SEncParamExt& pSvcParam, SFilesSet&
     else if (!strcmp (pCommand, "-denois") && (n < argc))
       pSvcParam.bEnableDenoise = atoi (argv[n++]) ? true : false;
 
+    else if (!strcmp (pCommand, "-tdenois") && (n < argc))
+      pSvcParam.bEnableTemporalDenoise = atoi (argv[n++]) ? true : false;
+
     else if (!strcmp (pCommand, "-scene") && (n < argc))
       pSvcParam.bEnableSceneChangeDetect = atoi (argv[n++]) ? true : false;
 
@@ -461,6 +484,18 @@ int ParseCommandLine (int argc, char** argv, SEncParamExt& pSvcParam, SFilesSet&
     else if (!strcmp (pCommand, "-fs") && (n < argc))
       pSvcParam.bEnableFrameSkip = atoi (argv[n++]) ? true : false;
 
+    else if (!strcmp (pCommand, "-lookahead") && (n < argc))
+      pSvcParam.iLookaheadFrames = atoi (argv[n++]);
+
+    else if (!strcmp (pCommand, "-threadpool") && (n < argc))
+      pSvcParam.bUseSharedThreadPool = atoi (argv[n++]) ? true : false;
+
+    else if (!strcmp (pCommand, "-wavefront") && (n < argc))
+      pSvcParam.bEnableWavefront = atoi (argv[n++]) ? true : false;
+
+    else if (!strcmp (pCommand, "-me") && (n < argc))
+      pSvcParam.eMotionSearchPreset = (ME_SEARCH_PRESET)atoi (argv[n++]);
+
     else if (!strcmp (pCommand, "-ltr") && (n < argc))
       pSvcParam.bEnableLongTermReference = atoi (argv[n++]) ? true : false;
 
@@ -519,6 +554,8 @@ int ParseCommandLine (int argc, char** argv, SEncParamExt& pSvcParam, SFilesSet&
 #endif//ENABLE_FRAME_DUMP
             } else if (strTag[0].compare ("ProfileIdc") == 0) {
               pDLayer->uiProfileIdc	= atoi (strTag[1].c_str());
+            } else if (strTag[0].compare ("EntropyCodingModeFlag") == 0) {
+              pDLayer->iEntropyCodingModeFlag	= atoi (strTag[1].c_str());
             } else if (strTag[0].compare ("FRExt") == 0) {
 //							pDLayer->frext_mode	= (bool)atoi(strTag[1].c_str());
             } else if (strTag[0].compare ("SpatialBitrate") == 0) {
@@ -645,6 +682,7 @@ int FillSpecificParameters (SEncParamExt& sParam) {
   sParam.iTemporalLayerNum = 3;	// layer number at temporal level
   sParam.iSpatialLayerNum	= 4;	// layer number at spatial level
   sParam.bEnableDenoise    = 0;    // denoise control
+  sParam.bEnableTemporalDenoise = 0; // temporal denoise control
   sParam.bEnableBackgroundDetection = 1; // background detection control
   sParam.bEnableAdaptiveQuant       = 1; // adaptive quantization control
   sParam.bEnableFrameSkip           = 1; // frame skipping
@@ -827,7 +865,7 @@ int ProcessEncodingSvcWithParam (ISVCEncoder* pPtrEnc, int argc, char** argv) {
     }
 
     /* Write bit-stream */
-    if (pFpBs != NULL && videoFrameTypeSkip != iEncode) {	// file handler to write bit stream
+    if (pFpBs != NULL && videoFrameTypeSkip != iEncode && videoFrameTypeDelayed != iEncode) {	// file handler to write bit stream
       int iLayer = 0;
       while (iLayer < sFbi.iLayerNum) {
         SLayerBSInfo* pLayerBsInfo = &sFbi.sLayerInfo[iLayer];
@@ -996,8 +1034,7 @@ int ProcessEncodingSvcWithConfig (ISVCEncoder* pPtrEnc, int argc, char** argv) {
     }
 
   iFrameIdx = 0;
-  while (iFrameIdx < iTotalFrameMax && (((int32_t)sSvcParam.uiFrameToBeCoded <= 0)
-                                        || (iFrameIdx < (int32_t)sSvcParam.uiFrameToBeCoded))) {
+  while (true) {
     bool bOnePicAvailableAtLeast = false;
     bool bSomeSpatialUnavailable	  = false;
 
@@ -1008,17 +1045,21 @@ int ProcessEncodingSvcWithConfig (ISVCEncoder* pPtrEnc, int argc, char** argv) {
     }
 #endif//ONLY_ENC_FRAMES_NUM
       bool bCanBeRead = false;
-      bCanBeRead = (fread (pYUV, 1, kiPicResSize, pFileYUV) == kiPicResSize);
+      bCanBeRead = (iFrameIdx < iTotalFrameMax && (((int32_t)sSvcParam.uiFrameToBeCoded <= 0)
+                    || (iFrameIdx < (int32_t)sSvcParam.uiFrameToBeCoded)))
+                   && (fread (pYUV, 1, kiPicResSize, pFileYUV) == kiPicResSize);
 
-      if (!bCanBeRead)
-		  break;
-      // To encoder this frame
+      // To encoder this frame, or drain frames still buffered by lookahead once input ends
     iStart	= WelsTime();
-    int iEncFrames = pPtrEnc->EncodeFrame (pSrcPic, &sFbi);
+    int iEncFrames = pPtrEnc->EncodeFrame (bCanBeRead ? pSrcPic : NULL, &sFbi);
     iTotal += WelsTime() - iStart;
+    if (!bCanBeRead && videoFrameTypeInvalid == iEncFrames)
+      break;
+    if (bCanBeRead)
+      ++ iFrameIdx;
 
     // fixed issue in case dismatch source picture introduced by frame skipped, 1/12/2010
-    if (videoFrameTypeSkip == iEncFrames) {
+    if (videoFrameTypeSkip == iEncFrames || videoFrameTypeDelayed == iEncFrames) {
       continue;
     }
 
@@ -1067,8 +1108,6 @@ int ProcessEncodingSvcWithConfig (ISVCEncoder* pPtrEnc, int argc, char** argv) {
     } else {
       fprintf (stderr, "EncodeFrame(), ret: %d, frame index: %d.\n", iEncFrames, iFrameIdx);
     }
-
-    ++ iFrameIdx;
   }
 
   if (iActualFrameEncodedCount > 0) {
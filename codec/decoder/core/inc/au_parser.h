@@ -64,6 +64,31 @@ namespace WelsDec {
  */
 uint8_t* DetectStartCodePrefix (const uint8_t* kpBuf, int32_t* pOffset, int32_t iBufSize);
 
+/*!
+ *************************************************************************************
+ * \brief	Find the first emulation prevention sequence (0x 00 00 03) or start code
+ *		prefix (0x 00 00 01) in the buffer
+ *
+ * \param 	kpBuf		bitstream payload buffer
+ * \param	kiBufSize	count size of buffer
+ *
+ * \return	offset of the first 0x00 of the sequence, kiBufSize if none is found
+ *
+ * \note	N/A
+ *************************************************************************************
+ */
+int32_t DetectEscOrStartCode_c (const uint8_t* kpBuf, const int32_t kiBufSize);
+
+#if defined(X86_ASM)
+int32_t DetectEscOrStartCode_sse2 (const uint8_t* kpBuf, const int32_t kiBufSize);
+int32_t DetectEscOrStartCode_avx2 (const uint8_t* kpBuf, const int32_t kiBufSize);
+#endif//X86_ASM
+
+/*!
+ * \brief	select the DetectEscOrStartCode_* scanner of the widest vectors kuiCpuFlags supports
+ */
+void InitDetectEscOrStartCodeFunc (PDetectEscOrStartCodeFunc* ppfDetect, const uint32_t kuiCpuFlags);
+
 /*!
  *************************************************************************************
  * \brief	to parse network abstraction layer unit,
@@ -0,0 +1,108 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	color_convert.h
+ *
+ * \brief	Conversion of decoded I420 pictures into caller owned buffers of other colour formats
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+#ifndef WELS_COLOR_CONVERT_H__
+#define WELS_COLOR_CONVERT_H__
+
+#include "typedefs.h"
+
+namespace WelsDec {
+
+/* one output row from a luma row and the chroma rows it is subsampled to, iWidth in pixels */
+typedef void (*PYuvToPackedRowFunc) (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV,
+                                     int32_t iWidth);
+/* one NV12 chroma row, iWidth is chroma samples per plane */
+typedef void (*PInterleaveUVRowFunc) (uint8_t* pDst, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+
+typedef struct TagColorConvertFunc {
+  PInterleaveUVRowFunc	pfInterleaveUVRow;
+  PYuvToPackedRowFunc		pfYuvToYuy2Row;
+  PYuvToPackedRowFunc		pfYuvToRgb24Row;
+  PYuvToPackedRowFunc		pfYuvToBgraRow;
+} SColorConvertFunc, *PColorConvertFunc;
+
+void InterleaveUVRow_c (uint8_t* pDst, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToYuy2Row_c (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToRgb24Row_c (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToBgraRow_c (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+
+#if defined(X86_ASM)
+// the RGB24 rows store 2 bytes behind the 48 of a 16 pixel block, so only blocks with pixels behind them are vectorized
+void InterleaveUVRow_sse2 (uint8_t* pDst, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToYuy2Row_sse2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToRgb24Row_sse2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToBgraRow_sse2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+
+void InterleaveUVRow_avx2 (uint8_t* pDst, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToYuy2Row_avx2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToRgb24Row_avx2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+void YuvToBgraRow_avx2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth);
+#endif//X86_ASM
+
+/*!
+ * \brief	set row kernels of colour conversion, optimized ones are selected by kuiCpuFlags
+ */
+void InitColorConvertFunc (SColorConvertFunc* pFunc, const uint32_t kuiCpuFlags);
+
+/*!
+ * \brief	size in bytes of a picture of iColorFormat with luma or packed rows iStride bytes apart
+ * \return	0 if the format is not supported
+ */
+int32_t WelsColorConvertBufSize (const int32_t kiColorFormat, const int32_t kiStride, const int32_t kiHeight);
+
+/*!
+ * \brief	minimum row stride in bytes of a picture of iColorFormat, 0 if the format is not supported
+ */
+int32_t WelsColorConvertMinStride (const int32_t kiColorFormat, const int32_t kiWidth);
+
+/*!
+ * \brief	convert a cropped I420 picture into pDst in a single pass over the source, planar outputs are laid out
+ *			back to back: I420 as Y, U, V with chroma stride kiDstStride/2, NV12 as Y, UV with chroma stride kiDstStride
+ *
+ * \param	pSrc		Y, U and V of the cropped picture
+ * \param	kiSrcStride	luma and chroma strides of source
+ *
+ * \return	0 if successful; ERR_INFO_INVALID_PARAM for unsupported formats
+ */
+int32_t WelsColorConvert (PColorConvertFunc pFunc, uint8_t* pSrc[3], const int32_t kiSrcStride[2], const int32_t kiWidth,
+                          const int32_t kiHeight, uint8_t* pDst, const int32_t kiDstStride, const int32_t kiColorFormat);
+
+} // namespace WelsDec
+
+#endif//WELS_COLOR_CONVERT_H__
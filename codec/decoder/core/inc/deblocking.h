@@ -66,6 +66,44 @@ void  DeblockingInit (PDeblockingFunc pDeblockingFunc,  int32_t iCpu);
  */
 void WelsDeblockingFilterSlice (PWelsDecoderContext pCtx, PDeblockingFilterMbFunc pDeblockMb);
 
+/*
+ *	Row progressive deblocking of a slice coded in raster order (no FMO). Once MB row y is reconstructed, MBs of
+ *	the slice up to the end of row y-1 are filtered; intra prediction of row y+1 reads unfiltered samples of row y only.
+ */
+typedef struct TagDeblockingSliceRows {
+  SDeblockingFilter	sFilter;
+  int32_t				iFilterIdc;
+  bool				bFilterFlag;	// false for slices not filtered, their MBs are just counted as finished
+  int32_t				iMbNext;		// next MB to be filtered, raster index
+  int32_t				iMbEnd;			// MB after the last one of slice
+  PPicture			pPic;
+} SDeblockingSliceRows, *PDeblockingSliceRows;
+
+/*!
+ * \brief	set up row progressive deblocking for current slice of target layer
+ */
+void WelsDeblockingInitSliceRows (PWelsDecoderContext pCtx, PDeblockingSliceRows pRows);
+
+/*!
+ * \brief	filter MBs of the slice one row behind reconstruction
+ *
+ * \param	pCtx			decoder context the progress is recorded to
+ * \param	pCurDqLayer		DQ layer whose MB position is used, may be a private copy
+ * \param	kiMbRecEnd		MB after the last one reconstructed, raster index
+ * \param	kbSliceEnd		slice completely reconstructed, the remaining MBs are filtered
+ *
+ * \return	NONE
+ */
+void WelsDeblockingFilterSliceRows (PWelsDecoderContext pCtx, PDqLayer pCurDqLayer, PDeblockingSliceRows pRows,
+                                    const int32_t kiMbRecEnd, const bool kbSliceEnd);
+
+/*!
+ * \brief	record kiMbNum MBs of pPic starting from kiMbStart as finished, -1 if they are not in raster order;
+ *		MB rows of which the row below is finished as well are notified by pCtx->pfMbRowsFinished
+ */
+void WelsDeblockingMbsDone (PWelsDecoderContext pCtx, PDqLayer pCurDqLayer, PPicture pPic, const int32_t kiMbStart,
+                            const int32_t kiMbNum);
+
 /*!
  * \brief	pixel deblocking filtering
  *
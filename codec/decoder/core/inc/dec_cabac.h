@@ -0,0 +1,203 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	dec_cabac.h
+ *
+ * \brief	Binary arithmetic decoding engine of CABAC
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+#ifndef WELS_DEC_CABAC_H__
+#define WELS_DEC_CABAC_H__
+
+#include "typedefs.h"
+#include "cabac_common.h"
+#include "dec_golomb.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif//_MSC_VER
+
+namespace WelsDec {
+
+/* ctxIdxOffset of syntax elements used in frame coded 4:2:0 slices, Table 9-34 of the spec */
+#define CTX_OFFSET_MB_TYPE_I			3
+#define CTX_OFFSET_SKIP_FLAG_P			11
+#define CTX_OFFSET_MB_TYPE_P			14
+#define CTX_OFFSET_MB_TYPE_P_SUFFIX		17
+#define CTX_OFFSET_SUB_MB_TYPE_P		21
+#define CTX_OFFSET_MVD_X				40
+#define CTX_OFFSET_MVD_Y				47
+#define CTX_OFFSET_REF_IDX				54
+#define CTX_OFFSET_MB_QP_DELTA			60
+#define CTX_OFFSET_INTRA_CHROMA_PRED	64
+#define CTX_OFFSET_PREV_INTRA_PRED_FLAG	68
+#define CTX_OFFSET_REM_INTRA_PRED_MODE	69
+#define CTX_OFFSET_CBP_LUMA				73
+#define CTX_OFFSET_CBP_CHROMA			77
+#define CTX_OFFSET_CODED_BLOCK_FLAG		85
+#define CTX_OFFSET_SIG_COEFF_FLAG		105
+#define CTX_OFFSET_LAST_SIG_COEFF_FLAG	166
+#define CTX_OFFSET_COEFF_ABS_LEVEL		227
+
+#define CABAC_FETCH_BYTES				6	// bytes appended to the offset window per refill
+
+/*
+ *	state of the arithmetic decoding engine, the offset is kept scaled by 2^iBitsLeft so that
+ *	bits are fetched in bulk and renormalization is a shift of the range only
+ */
+typedef struct TagWelsCabacDecEngine {
+  uint64_t		uiOffset;		// codIOffset << iBitsLeft plus the look-ahead bits not consumed yet
+  uint32_t		uiRange;		// codIRange, 9 bits
+  int32_t			iBitsLeft;		// count of look-ahead bits below codIOffset in uiOffset
+  const uint8_t*	pBuffStart;
+  const uint8_t*	pBuffCurr;		// next byte to fetch, may pass pBuffEnd by the zeros padded
+  const uint8_t*	pBuffEnd;
+  uint8_t			sStateCtx[WELS_CONTEXT_COUNT];	// packed context states, see WELS_CABAC_STATE
+} SWelsCabacDecEngine, *PWelsCabacDecEngine;
+
+extern const uint8_t g_kuiCabacDecStateTrans[128][2];	// next packed state indexed by packed state and bin decoded
+
+static inline int32_t WelsCabacClz32 (uint32_t uiVal) {
+#if defined(__GNUC__)
+  return __builtin_clz (uiVal);
+#elif defined(_MSC_VER)
+  unsigned long uiIdx;
+  _BitScanReverse (&uiIdx, uiVal);
+  return 31 - uiIdx;
+#else
+  int32_t iCount = 0;
+  while (! (uiVal & 0x80000000)) {
+    uiVal <<= 1;
+    ++ iCount;
+  }
+  return iCount;
+#endif
+}
+
+/*!
+ * \brief	append the next bytes of slice data to the offset window, zeros are padded beyond the end
+ * \return	0 if successful; ERR_INFO_READ_OVERFLOW if the slice data is used up
+ */
+int32_t WelsCabacDecRefill (PWelsCabacDecEngine pEngine);
+
+/*!
+ * \brief	initialize the decoding engine on byte aligned slice data (9.3.1.2)
+ */
+int32_t WelsCabacDecEngineInit (PWelsCabacDecEngine pEngine, const uint8_t* pBuf, const uint8_t* pBufEnd);
+
+/*!
+ * \brief	initialize context states for slice QP with model of cabac_init_idc or I slice (9.3.1.1)
+ */
+void WelsCabacDecContextInit (PWelsCabacDecEngine pEngine, const int32_t kiModel, const int32_t kiSliceQp);
+
+/*!
+ * \brief	first byte not consumed by the engine, where pcm samples start after I_PCM mb_type
+ */
+static inline const uint8_t* WelsCabacDecBytePos (PWelsCabacDecEngine pEngine) {
+  return pEngine->pBuffCurr - (pEngine->iBitsLeft >> 3);
+}
+
+static inline int32_t WelsCabacDecRenorm (PWelsCabacDecEngine pEngine) {
+  const int32_t kiShift = WelsCabacClz32 (pEngine->uiRange) - 23;	// range is kept in [256, 510]
+  pEngine->uiRange <<= kiShift;
+  pEngine->iBitsLeft -= kiShift;
+  if (pEngine->iBitsLeft < 0)
+    return WelsCabacDecRefill (pEngine);
+  return ERR_NONE;
+}
+
+/*!
+ * \brief	decode a bin with context ctxIdx kiCtx (9.3.3.2.1)
+ */
+static inline int32_t WelsCabacDecDecision (PWelsCabacDecEngine pEngine, const int32_t kiCtx, uint32_t& uiBinVal) {
+  const uint8_t kuiState		= pEngine->sStateCtx[kiCtx];
+  const uint32_t kuiRangeLps	= g_kuiCabacRangeLps[kuiState >> 1][ (pEngine->uiRange >> 6) & 3];
+  const uint64_t kuiScaledMps	= (uint64_t) (pEngine->uiRange - kuiRangeLps) << pEngine->iBitsLeft;
+
+  if (pEngine->uiOffset < kuiScaledMps) {
+    uiBinVal = kuiState & 1;
+    pEngine->uiRange -= kuiRangeLps;
+    pEngine->sStateCtx[kiCtx] = g_kuiCabacDecStateTrans[kuiState][uiBinVal];
+    if (pEngine->uiRange >= 256)
+      return ERR_NONE;
+  } else {
+    uiBinVal = (kuiState & 1) ^ 1;
+    pEngine->uiOffset -= kuiScaledMps;
+    pEngine->uiRange = kuiRangeLps;
+    pEngine->sStateCtx[kiCtx] = g_kuiCabacDecStateTrans[kuiState][uiBinVal];
+  }
+  return WelsCabacDecRenorm (pEngine);
+}
+
+/*!
+ * \brief	decode a bin with equiprobable bypass mode (9.3.3.2.3)
+ */
+static inline int32_t WelsCabacDecBypass (PWelsCabacDecEngine pEngine, uint32_t& uiBinVal) {
+  uint64_t uiScaledRange;
+  if (-- pEngine->iBitsLeft < 0) {
+    WELS_READ_VERIFY (WelsCabacDecRefill (pEngine));
+  }
+  uiScaledRange = (uint64_t)pEngine->uiRange << pEngine->iBitsLeft;
+  if (pEngine->uiOffset >= uiScaledRange) {
+    pEngine->uiOffset -= uiScaledRange;
+    uiBinVal = 1;
+  } else {
+    uiBinVal = 0;
+  }
+  return ERR_NONE;
+}
+
+/*!
+ * \brief	decode a bin with the terminating context ctxIdx 276, end_of_slice_flag or I_PCM bin of mb_type (9.3.3.2.2.3)
+ */
+static inline int32_t WelsCabacDecTerminate (PWelsCabacDecEngine pEngine, uint32_t& uiBinVal) {
+  pEngine->uiRange -= 2;
+  if (pEngine->uiOffset >= ((uint64_t)pEngine->uiRange << pEngine->iBitsLeft)) {
+    uiBinVal = 1;
+    return ERR_NONE;
+  }
+  uiBinVal = 0;
+  if (pEngine->uiRange >= 256)
+    return ERR_NONE;
+  return WelsCabacDecRenorm (pEngine);
+}
+
+/*!
+ * \brief	k-th order Exp-Golomb suffix of UEGk binarization, all bins are bypass decoded
+ */
+int32_t WelsCabacDecUeBypass (PWelsCabacDecEngine pEngine, int32_t iExpBits, uint32_t& uiVal);
+
+} // namespace WelsDec
+
+#endif//WELS_DEC_CABAC_H__
@@ -82,6 +82,8 @@ struct TagDqLayer {
   int8_t*  pChromaPredMode;
   //uint8_t (*motion_pred_flag[LIST_A])[MB_PARTITION_SIZE]; // 8x8
   int8_t (*pSubMbType)[MB_SUB_PARTITION_SIZE];
+  uint8_t (*pMvd[LIST_A])[MB_BLOCK4x4_NUM][MV_A];	// clipped absolute mvd, used by cabac contexts only
+  uint8_t* pCbfDc;	// coded_block_flag of luma DC, Cb DC and Cr DC, used by cabac contexts only
   int32_t iLumaStride;
   int32_t iChromaStride;
   uint8_t* pPred[3];
@@ -0,0 +1,251 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file		dec_multi_threading.h
+ *
+ * \brief		frame level multiple threading reconstruction of decoder
+ *
+ * \date		10/17/2014 Created
+ *************************************************************************************
+ */
+
+#ifndef WELS_DEC_MULTI_THREADING_H__
+#define WELS_DEC_MULTI_THREADING_H__
+
+#include "typedefs.h"
+#include "decoder_context.h"
+#include "deblocking.h"
+#include "codec_def.h"
+#include "WelsThreadPool.h"
+
+namespace WelsDec {
+
+#if defined(MT_ENABLED)
+
+#define MAX_DEC_THREAD_NUM		16
+#define MAX_DEC_RECON_SLOT_NUM	(MAX_DEC_THREAD_NUM + 1)	// one picture being parsed while the others reconstructed
+#define MAX_DEC_OUTPUT_PIC_NUM	(MAX_DEC_THREAD_NUM + 2)
+
+/*
+ *	Frame threading overview
+ *	The decoding thread keeps doing NAL splitting, slice header/MB syntax parsing and reference marking serially,
+ *	MB data of each picture is parsed into a private DQ layer of a recon slot. Once a picture is completely parsed,
+ *	a job reconstructs, deblocks and pads it row by row on the thread pool and publishes progress in MB rows, motion
+ *	compensation of later jobs only waits for the reference rows it really reads. Pictures are output in decoding order.
+ *
+ *	Slice threading overview
+ *	Pictures are decoded one after another, each slice of the target layer is parsed and reconstructed by a job with a
+ *	private copy of the DQ layer sharing its MB arrays. The decoding thread collects jobs in submission order and
+ *	deblocks each slice once it lands, while later slices are still in flight.
+ *
+ *	Deblocking helper
+ *	With a single decoding thread, a slice in raster order is filtered by a job on a private single worker pool while
+ *	the decoding thread still reconstructs it, one MB row behind, with a private copy of the DQ layer.
+ */
+
+/* slice level parameters needed by reconstruction job, indexed by first MB of slice */
+typedef struct TagDecReconSliceInfo {
+  ESliceType	eSliceType;
+  int32_t		iDisableDeblockingFilterIdc;
+  int32_t		iSliceAlphaC0Offset;
+  int32_t		iSliceBetaOffset;
+} SDecReconSliceInfo;
+
+typedef enum TagReconSlotState {
+  RECON_SLOT_IDLE		= 0,
+  RECON_SLOT_PARSING	= 1,	// MB data of the current picture is being parsed into it
+  RECON_SLOT_BUSY		= 2,	// reconstruction job is queued or running
+  RECON_SLOT_DONE		= 3		// slice job finished, result not collected yet
+} EReconSlotState;
+
+typedef struct TagDecReconSlot {
+  struct TagDecThreadCtx*	pThreadCtx;
+  PWelsDecoderContext		pReconCtx;		// private copy of decoder context used by the job
+  SDqLayer				sDqLayer;		// parsed MB data of the picture
+
+  uint8_t*				pMbDataBuf;		// MB level arrays of sDqLayer and slice info
+  int32_t					iMbDataNum;		// MB count allocated
+  uint8_t*				pCsBuf;			// I_PCM samples of sDqLayer
+  int32_t					iCsBufSize;
+  SDecReconSliceInfo*		pSliceInfo;
+
+  PNalUnit				pNal;			// slice decoded by slice job
+  int32_t					iSliceRet;
+  PPicture				pPic;
+  bool					bRef;
+  int32_t					iRefRowsReady[MAX_REF_PIC_COUNT];	// cached progress of references, for job only
+  EReconSlotState			eState;
+  int32_t					iSeq;			// submission order
+
+  WELS_EVENT*				pWaitEvent;
+  SWelsThreadTask			sTask;
+} SDecReconSlot, *PDecReconSlot;
+
+typedef struct TagDecRowWaiter {
+  PPicture	pPic;
+  int32_t		iRows;
+  WELS_EVENT*	pEvent;
+} SDecRowWaiter;
+
+typedef struct TagDecOutputPic {
+  PPicture	pPic;
+  int32_t		iWidth;
+  int32_t		iHeight;
+  SPosOffset	sFrameCrop;
+} SDecOutputPic;
+
+typedef struct TagDecThreadCtx {
+  SWelsThreadPool*	pThreadPool;
+  bool				bSharedPool;	// pThreadPool is the pool shared by the process
+  int32_t				iThreadNum;
+  bool				bSliceThreading;
+  int32_t				iSlotNum;
+  SDecReconSlot		sSlots[MAX_DEC_RECON_SLOT_NUM];
+  PDecReconSlot		pParseSlot;
+  int32_t				iSubmitSeq;
+  int32_t				iRetireSeq;		// next slice job to be collected
+  int32_t				iSliceErr;		// error of the first failed slice job in current layer
+  bool				bSliceWaiting;	// decoding thread is waiting for a slice job
+
+  WELS_MUTEX			mutexProgress;	// protects slot states, picture row progress and picture hold counts
+  WELS_EVENT*			pCallerEvent;	// used by decoding thread to wait for jobs
+  SDecRowWaiter		sWaiters[MAX_DEC_RECON_SLOT_NUM + 1];
+  int32_t				iWaiterNum;
+
+  SDecOutputPic		sOutputPics[MAX_DEC_OUTPUT_PIC_NUM];	// FIFO in decoding order
+  int32_t				iOutputHead;
+  int32_t				iOutputNum;
+  PPicture			pLastOutputPic;	// held until next decoding call
+} SDecThreadCtx, *PDecThreadCtx;
+
+typedef struct TagDecDeblockThread {
+  SWelsThreadPool*		pThreadPool;
+  SWelsThreadTaskGroup	sTaskGroup;
+  SWelsThreadTask			sTask;
+  bool					bBusy;			// job queued and not joined yet, used by decoding thread only
+
+  WELS_MUTEX				mutexProgress;	// protects the fields below
+  WELS_EVENT*				pJobEvent;		// used by job to wait for reconstruction progress
+  bool					bJobWaiting;
+  int32_t					iMbRecEnd;		// MB after the last one reconstructed, raster index
+  bool					bSliceEnd;		// slice completely reconstructed
+  bool					bStop;			// no more progress will come, job stops where it is
+
+  PWelsDecoderContext		pCtx;
+  SDqLayer				sDqLayer;		// shares MB arrays of current layer
+  SDeblockingSliceRows	sRows;
+} SDecDeblockThread, *PDecDeblockThread;
+
+/*!
+ * \brief	create thread pool and recon slots, called once function pointers of pCtx are ready;
+ *		only slice threading may run on the shared pool, frame jobs block on each other and keep own workers
+ */
+int32_t WelsInitDecThreadCtx (PWelsDecoderContext pCtx, const int32_t kiThreadNum, const bool kbSliceThreading,
+                              const bool kbSharedPool);
+void WelsUninitDecThreadCtx (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	count of additional pictures needed in picture buffer
+ */
+int32_t WelsGetDecThreadPicNum (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	wait for all jobs and drop pending output, used before pictures are freed
+ */
+void WelsResetDecThreads (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	whether AU can be decoded in the configured threading mode, otherwise it is decoded serially
+ */
+bool WelsCheckAuForThreading (PWelsDecoderContext pCtx, PAccessUnit pCurAu, const uint8_t kuiTargetDqId);
+bool WelsIsFrameThreading (PWelsDecoderContext pCtx);
+bool WelsIsSliceThreading (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	set up current DQ layer for the incoming AU, the picture being parsed is restarted if decoding mode changes
+ */
+int32_t WelsPrepareFrameThreadingAu (PWelsDecoderContext pCtx, const bool kbFrameThreading);
+PPicture WelsThreadPrefetchPic (PWelsDecoderContext pCtx, const bool kbFrameThreading);
+void WelsResetParseSlotPicture (PWelsDecoderContext pCtx);
+int32_t WelsRecordSliceForRecon (PWelsDecoderContext pCtx);
+void WelsSubmitReconJob (PWelsDecoderContext pCtx, const bool kbRef);
+
+/*!
+ * \brief	parse and reconstruct slice of current DQ layer on thread pool
+ */
+void WelsQueueSliceJob (PWelsDecoderContext pCtx, PNalUnit pNalCur);
+
+/*!
+ * \brief	collect all slice jobs of current DQ layer and deblock the slices
+ * \return	0 - successed, error of the first failed slice otherwise
+ */
+int32_t WelsFinishSliceJobs (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	wait for slice jobs left by a failed AU, results are dropped
+ */
+void WelsWaitSliceJobs (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	append finished (or being reconstructed) picture to output FIFO
+ */
+void WelsQueueOutputPic (PWelsDecoderContext pCtx, PPicture pPic, const int32_t kiWidth, const int32_t kiHeight);
+void WelsFetchOutputPic (PWelsDecoderContext pCtx, uint8_t** ppDst, SBufferInfo* pDstInfo);
+void WelsReleaseOutputPic (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	block until the rows of reference picture covering given luma line are ready, called by jobs only
+ */
+void WelsWaitRefPicLines (PDecReconSlot pSlot, PPicture pRefPic, const int32_t kiRefIdx, const int32_t kiBottomLine);
+
+int32_t WelsInitDeblockThread (PWelsDecoderContext pCtx);
+void WelsUninitDeblockThread (PWelsDecoderContext pCtx);
+
+/*!
+ * \brief	start filtering current slice on the deblocking helper, the job of previous slice is joined first
+ */
+void WelsStartDeblockSlice (PWelsDecoderContext pCtx, PDeblockingSliceRows pRows);
+
+/*!
+ * \brief	publish reconstruction progress of current slice, kbSliceEnd once its last MB is reconstructed
+ */
+void WelsUpdateDeblockSlice (PWelsDecoderContext pCtx, const int32_t kiMbRecEnd, const bool kbSliceEnd);
+
+/*!
+ * \brief	join the deblocking job before the picture is output or padded, MBs of a slice not finished stay unfiltered
+ */
+void WelsWaitDeblockThread (PWelsDecoderContext pCtx);
+
+#endif//MT_ENABLED
+
+} // namespace WelsDec
+
+#endif//WELS_DEC_MULTI_THREADING_H__
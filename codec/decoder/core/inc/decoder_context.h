@@ -53,6 +53,8 @@
 #include "as264_common.h" // for LONG_TERM_REF macro,can be delete if not need this macro
 #include "crt_util_safe_x.h"
 #include "mb_cache.h"
+#include "dec_cabac.h"
+#include "color_convert.h"
 
 namespace WelsDec {
 
@@ -117,6 +119,10 @@ typedef struct tagDeblockingFilter {
 } SDeblockingFilter, *PDeblockingFilter;
 
 typedef void (*PDeblockingFilterMbFunc) (PDqLayer pCurDqLayer, PDeblockingFilter  filter, int32_t boundry_flag);
+/* MB rows [iMbRowStart, iMbRowEnd) of pPic sized iMbWidth x iMbHeight are reconstructed and deblocked, no later slice
+ * changes them any more */
+typedef void (*PWelsMbRowsFinishedFunc) (void* pArg, PPicture pPic, int32_t iMbWidth, int32_t iMbHeight,
+    int32_t iMbRowStart, int32_t iMbRowEnd);
 typedef void (*PLumaDeblockingLT4Func) (uint8_t* iSampleY, int32_t iStride, int32_t iAlpha, int32_t iBeta,
     int8_t* iTc);
 typedef void (*PLumaDeblockingEQ4Func) (uint8_t* iSampleY, int32_t iStride, int32_t iAlpha, int32_t iBeta);
@@ -164,6 +170,9 @@ typedef struct TagExpandPicFunc {
  *	SWelsDecoderContext: to maintail all modules data over decoder@framework
  */
 
+/* offset of the first 00 00 03 or 00 00 01 in kpBuf, kiBufSize if there is none */
+typedef int32_t (*PDetectEscOrStartCodeFunc) (const uint8_t* kpBuf, const int32_t kiBufSize);
+
 typedef struct TagWelsDecoderContext {
   // Input
   void*				pArgDec;			// structured arguments for decoder, reserved here for extension in the future
@@ -212,6 +221,8 @@ typedef struct TagWelsDecoderContext {
     int8_t*  pCbp[LAYER_NUM_EXCHANGEABLE];
     uint8_t (*pMotionPredFlag[LAYER_NUM_EXCHANGEABLE][LIST_A])[MB_PARTITION_SIZE]; // 8x8
     int8_t (*pSubMbType[LAYER_NUM_EXCHANGEABLE])[MB_SUB_PARTITION_SIZE];
+    uint8_t (*pMvd[LAYER_NUM_EXCHANGEABLE][LIST_A])[MB_BLOCK4x4_NUM][MV_A];
+    uint8_t* pCbfDc[LAYER_NUM_EXCHANGEABLE];
     int32_t* pSliceIdc[LAYER_NUM_EXCHANGEABLE];		// using int32_t for slice_idc
     int8_t*  pResidualPredFlag[LAYER_NUM_EXCHANGEABLE];
     int8_t*  pInterPredictionDoneFlag[LAYER_NUM_EXCHANGEABLE];
@@ -227,6 +238,7 @@ typedef struct TagWelsDecoderContext {
   SRefPic				sRefPic;
 
   SVlcTable			sVlcTable;		 // vlc table
+  SWelsCabacDecEngine	sCabacDecEngine;	// arithmetic decoding engine of cabac slices
 
   SBitStringAux		sBs;
 
@@ -245,6 +257,7 @@ typedef struct TagWelsDecoderContext {
   PSliceHeader		pSliceHeader;
 
   PPicBuff	        pPicBuff[LIST_A];	// Initially allocated memory for pictures which are used in decoding.
+  SFrameAllocator		sFrameAllocator;	// storage of pictures from the application if pfnGetBuffer is set
   int32_t				iPicQueueNumber;
 
   SSubsetSps			sSubsetSpsBuffer[MAX_SPS_COUNT];
@@ -299,6 +312,15 @@ typedef struct TagWelsDecoderContext {
   /* For Deblocking */
   SDeblockingFunc     sDeblockingFunc;
   SExpandPicFunc	    sExpandPicFunc;
+  SColorConvertFunc	sColorConvertFunc;	// for DecodeFrameEx()
+  PDetectEscOrStartCodeFunc	pfDetectEscOrStartCode;	// for the bulk NAL copy of WelsDecodeBs()
+
+  /* row progress of pDec, see WelsDeblockingMbsDone() */
+  int32_t iDeblockedMbNum;		// MBs finished without a gap from the top of picture
+  int32_t iDeblockedMbTotal;		// MBs finished in all, slices may arrive out of order
+  int32_t iFinishedMbRows;		// MB rows notified as final
+  PWelsMbRowsFinishedFunc pfMbRowsFinished;	// NULL if nobody listens, called on deblocking helper thread if enabled
+  void* pMbRowsFinishedArg;
 
   /* For Block */
   SBlockFunc          sBlockFunc;
@@ -320,6 +342,12 @@ typedef struct TagWelsDecoderContext {
   //trace handle
   void*      pTraceHandle;
 
+#if defined(MT_ENABLED)
+  struct TagDecThreadCtx*  pThreadCtx;	// frame threading control, NULL for single threaded decoding
+  struct TagDecReconSlot*  pReconSlot;	// owner job of a private reconstruction context, NULL in decoder context
+  struct TagDecDeblockThread*  pDeblockThread;	// deblocking helper of single threaded decoding, NULL if disabled
+#endif
+
 #ifdef NO_WAITING_AU
   //Save the last nal header info
   SNalUnitHeaderExt sLastNalHdrExt;
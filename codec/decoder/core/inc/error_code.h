@@ -164,6 +164,8 @@ enum {
   ERR_INFO_INVALID_SLICE_TYPE,
   ERR_INFO_INVALID_REF_MARKING,
   ERR_INFO_INVALID_REF_REORDERING,
+  ERR_INFO_INVALID_CABAC_INIT_IDC,
+  ERR_INFO_CABAC_INVALID_MB_DATA,
 
   /* Error from corresponding logic, 10001-65535 */
   ERR_INFO_NO_IDR_PIC		= ERR_INFO_LOGIC_BASE,	// NO IDR picture available before sequence header
@@ -50,6 +50,12 @@ namespace WelsDec {
 void ExpandReferencingPicture (PPicture pPic, PExpandPictureFunc pExpandPictureLuma,
                                  PExpandPictureFunc pExpandPictureChroma[2]);
 
+/*!
+ * \brief	expand borders of MB rows [kiStartMbRow, kiEndMbRow) of a reference picture, top and bottom borders are
+ *			filled along with the first and the last MB row; result is identical to ExpandReferencingPicture()
+ */
+void ExpandReferencingPictureMbRows (PPicture pPic, const int32_t kiStartMbRow, const int32_t kiEndMbRow);
+
 void InitExpandPictureFunc (SExpandPicFunc* pExpandPicFunc, const uint32_t kuiCpuFlags);
 
 } // namespace WelsDec
@@ -71,6 +71,19 @@ void UpdateP8x16MotionInfo (PDqLayer pCurDqLayer, int16_t iMotionVector[LIST_A][
                               int8_t iRefIndex[LIST_A][30],
                               int32_t iPartIdx, int8_t iRef, int16_t iMVs[2]);
 
+/*!
+ * \brief	whether MB kiNeighXy, left or above the current one, is in the slice of the current MB
+ *			without FMO a slice is a run of MBs from its first one, so pSliceIdc[] of other slices, which slice jobs of
+ *			the decoder may still write, is only read with slice groups
+ */
+static inline bool IsNeighborInCurSlice (PDqLayer pCurLayer, const int32_t kiNeighXy) {
+  const SSliceHeader* kpSh = &pCurLayer->sLayerInfo.sSliceInLayer.sSliceHeaderExt.sSliceHeader;
+
+  if (kpSh->pPps->uiNumSliceGroups > 1)
+    return pCurLayer->pSliceIdc[kiNeighXy] == pCurLayer->pSliceIdc[pCurLayer->iMbXyIndex];
+  return kiNeighXy >= kpSh->iFirstMbInSlice;
+}
+
 /*!
  * \brief   get the motion predictor for skip mode
  * \param
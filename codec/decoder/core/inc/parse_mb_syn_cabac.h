@@ -0,0 +1,104 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	parse_mb_syn_cabac.h
+ *
+ * \brief	Parsing all syntax elements of mb and decoding residual with cabac
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_PARSE_MB_SYN_CABAC_H__
+#define WELS_PARSE_MB_SYN_CABAC_H__
+
+#include "wels_common_basis.h"
+#include "decoder_context.h"
+#include "dec_frame.h"
+#include "slice.h"
+#include "dec_cabac.h"
+
+namespace WelsDec {
+
+/* bits of TagDqLayer::pCbfDc */
+#define CBF_DC_LUMA		0x01
+#define CBF_DC_CB		0x02
+#define CBF_DC_CR		0x04
+
+/*!
+ * \brief   start the arithmetic decoding engine and contexts of a cabac slice, called after the slice header is parsed
+ * \param 	input : decoding context, bit-stream positioned at the slice data
+ * \param 	output: 0 indicating decoding correctly; non-zero means error
+ */
+int32_t InitCabacSliceDec (PWelsDecoderContext pCtx, PBitStringAux pBs);
+
+int32_t ParseEndOfSliceCabac (PWelsDecoderContext pCtx, uint32_t& uiBinVal);
+int32_t ParseSkipFlagCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiSkip);
+
+/*!
+ * \brief   parsing mb_type, the value returned is numbered as in cavlc slices (Table 7-11 and 7-13)
+ * \param 	input : decoding context, neighbouring MB info
+ * \param 	output: 0 indicating decoding correctly; non-zero means error
+ */
+int32_t ParseMBTypeISliceCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiMbType);
+int32_t ParseMBTypePSliceCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiMbType);
+
+/*!
+ * \brief   parsing intra prediction modes of luma and chroma
+ * \param 	input : decoding context, neighbouring MB info, intra4x4 mode cache
+ * \param 	output: 0 indicating decoding correctly; non-zero means error
+ */
+int32_t ParseIntra4x4ModeCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, int8_t* pIntraPredMode);
+int32_t ParseIntra16x16ModeCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail);
+
+/*!
+ * \brief   parsing inter info (including sub_mb_type, ref_index and mvd)
+ * \param 	input : decoding context, neighbouring MB info, mv and ref caches filled by WelsFillCacheInter
+ * \param 	output: 0 indicating decoding correctly; non-zero means error
+ */
+int32_t ParseInterInfoCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, int16_t iMvArray[LIST_A][30][MV_A],
+                             int8_t iRefIdxArray[LIST_A][30]);
+
+int32_t ParseCbpInfoCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiCbp);
+int32_t ParseDeltaQpCabac (PWelsDecoderContext pCtx, int32_t& iQpDelta);
+
+/*!
+ * \brief   parsing a residual block and storing its scaled coefficients, the coded_block_flag included
+ * \param 	input : iResProperty and iIndex of block as in WelsResidualBlockCavlc, count cache filled for the MB
+ * \param 	output: 0 indicating decoding correctly; non-zero means error
+ */
+int32_t ParseResidualBlockCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint8_t* pNonZeroCountCache,
+                                 int32_t iIndex, int32_t iMaxNumCoeff, const uint8_t* pScanTable, int32_t iResProperty,
+                                 int16_t* pTCoeff, uint8_t uiQp);
+
+} // namespace WelsDec
+#endif//WELS_PARSE_MB_SYN_CABAC_H__
@@ -46,6 +46,7 @@ typedef struct TagPicBuff {
 PPicture*      ppPic;
 int32_t        iCapacity;  // capacity size of queue
 int32_t        iCurrentIdx;
+SFrameAllocator* pAllocator;	// storage of pictures is got per prefetch from the application, NULL for internal storage
 } SPicBuff, *PPicBuff;
 
 /*
@@ -54,6 +55,11 @@ int32_t        iCurrentIdx;
 
 PPicture PrefetchPic (PPicBuff pPicBuff);  // To get current node applicable
 
+/*!
+ * \brief	return storage of pPic to the frame allocator of pPicBuff, if it holds any
+ */
+void ReleasePicBuffer (PPicBuff pPicBuff, PPicture pPic);
+
 } // namespace WelsDec
 
 #endif//WELS_PICTURE_QUEUE_H__
@@ -35,6 +35,8 @@
 #define WELS_PICTURE_H__
 
 #include "typedefs.h"
+#include "wels_common_basis.h"
+#include "codec_def.h"
 
 namespace WelsDec {
 
@@ -60,7 +62,7 @@ int32_t		iFramePoc;		// frame POC
 /*******************************sef_definition for misc use****************************/
 bool		bUsedAsRef;							//for ref pic management
 bool		bIsLongRef;	// long term reference frame flag	//for ref pic management
-uint8_t		uiRefCount;
+uint8_t		uiRefCount;	// holds by reconstruction jobs and pending output of frame threading, prefetch skips it while not 0
 bool		bAvailableFlag;	// indicate whether it is available in this picture memory block.
 
 /*******************************for future use****************************/
@@ -73,9 +75,12 @@ int32_t		iFrameNum;		// frame number			//for ref pic management
 int32_t		iLongTermFrameIdx;					//id for long term ref pic
 
 int32_t     iTotalNumMbRec; //show how many MB constructed
+int32_t     iReadyMbRows;   //MB rows finished (deblocked and padded) for reference by frame threading
 
 int32_t     iSpsId; //against mosaic caused by cross-IDR interval reference.
 int32_t     iPpsId;
+SPosOffset  sFrameCrop;	//cropping of the SPS decoded with, for row notifications
+SFrameBuffer sExtBuffer;	//storage got from the frame allocator while pBuffer is set, iSize is 0 for internal storage
 } SPicture, *PPicture;	// "Picture" declaration is comflict with Mac system
 
 } // namespace WelsDec
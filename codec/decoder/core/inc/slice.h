@@ -183,6 +183,7 @@ typedef struct TagSlice {
   /*******************************use for future****************************/
   // for Macroblock coding within slice
   int32_t		iLastMbQp;		// stored qp for last mb coded, maybe more efficient for mb skip detection etc.
+  int32_t		iLastDeltaQp;	// mb_qp_delta of last mb decoded, 0 if absent, used by cabac contexts
 
   /*******************************slice_data****************************/
   /*slice_data_ext()*/
@@ -44,6 +44,8 @@
 #include "memmgr_nal_unit.h"
 #include "decoder_core.h"
 #include "decoder_core.h"
+#include "ls_defines.h"
+#include "cpu_core.h"
 
 namespace WelsDec {
 /*!
@@ -85,6 +87,58 @@ uint8_t* DetectStartCodePrefix (const uint8_t* kpBuf, int32_t* pOffset, int32_t
   return NULL;
 }
 
+/*!
+ *************************************************************************************
+ * \brief	Find the first emulation prevention sequence (0x 00 00 03) or start code
+ *		prefix (0x 00 00 01) in the buffer
+ *
+ * \param 	kpBuf		bitstream payload buffer
+ * \param	kiBufSize	count size of buffer
+ *
+ * \return	offset of the first 0x00 of the sequence, kiBufSize if none is found
+ *
+ * \note	bytes are tested 8 at a time, windows without any zero byte can not
+ *		start such a sequence and are skipped as a whole
+ *************************************************************************************
+ */
+int32_t DetectEscOrStartCode_c (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  const uint64_t kuiLsb = 0x0101010101010101ULL;
+  const uint64_t kuiMsb = 0x8080808080808080ULL;
+  const int32_t kiLastPos = kiBufSize - 2; // the third byte of the sequence has to be inside the buffer
+  int32_t iIdx = 0;
+
+  while (iIdx < kiLastPos) {
+    if (iIdx + 8 <= kiBufSize) {
+      const uint64_t kuiWord = LD64 (kpBuf + iIdx);
+      if (0 == ((kuiWord - kuiLsb) & ~kuiWord & kuiMsb)) {
+        iIdx += 8;
+        continue;
+      }
+    }
+    const int32_t kiEnd = WELS_MIN (iIdx + 8, kiLastPos);
+    for (; iIdx < kiEnd; ++ iIdx) {
+      if (0 == kpBuf[iIdx] && 0 == kpBuf[iIdx + 1] && (kpBuf[iIdx + 2] == 0x03 || kpBuf[iIdx + 2] == 0x01))
+        return iIdx;
+    }
+  }
+
+  return kiBufSize;
+}
+
+void InitDetectEscOrStartCodeFunc (PDetectEscOrStartCodeFunc* ppfDetect, const uint32_t kuiCpuFlags) {
+  *ppfDetect = DetectEscOrStartCode_c;
+#if defined(X86_ASM)
+  if (kuiCpuFlags & WELS_CPU_SSE2) {
+    *ppfDetect = DetectEscOrStartCode_sse2;
+  }
+  if (kuiCpuFlags & WELS_CPU_AVX2) {
+    *ppfDetect = DetectEscOrStartCode_avx2;
+  }
+#else
+  (void)kuiCpuFlags;
+#endif//X86_ASM
+}
+
 /*!
  *************************************************************************************
  * \brief	to parse nal unit
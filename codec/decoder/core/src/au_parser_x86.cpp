@@ -0,0 +1,116 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file	au_parser_x86.cpp
+ *
+ * \brief	SSE2/AVX2 scanners for emulation prevention sequences and start code prefixes
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+#include "au_parser.h"
+
+#if defined(X86_ASM)
+
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif//_MSC_VER
+
+#if defined(__GNUC__)
+#define WELS_DEC_TARGET(kpIsa)	__attribute__ ((target (kpIsa)))
+#else
+#define WELS_DEC_TARGET(kpIsa)
+#endif//__GNUC__
+
+namespace WelsDec {
+
+static inline int32_t LowestSetBit (const uint32_t kuiMask) {
+#if defined(_MSC_VER)
+  unsigned long uiIdx;
+  _BitScanForward (&uiIdx, kuiMask);
+  return (int32_t)uiIdx;
+#else
+  return __builtin_ctz (kuiMask);
+#endif//_MSC_VER
+}
+
+/*
+ *	a position starts a sequence when its byte and the next one are zero and the byte after is 1 or 3, i.e. is 3
+ *	once bit 1 is set; the three unaligned loads cover sequences crossing the end of the vector
+ */
+
+WELS_DEC_TARGET ("sse2")
+int32_t DetectEscOrStartCode_sse2 (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  const __m128i kvZero = _mm_setzero_si128();
+  const __m128i kvTwo = _mm_set1_epi8 (2);
+  const __m128i kvThree = _mm_set1_epi8 (3);
+  int32_t iIdx = 0;
+
+  for (; iIdx + 18 <= kiBufSize; iIdx += 16) {
+    const __m128i kv0 = _mm_loadu_si128 ((const __m128i*) (kpBuf + iIdx));
+    const __m128i kv1 = _mm_loadu_si128 ((const __m128i*) (kpBuf + iIdx + 1));
+    const __m128i kv2 = _mm_loadu_si128 ((const __m128i*) (kpBuf + iIdx + 2));
+    const __m128i kvHit = _mm_and_si128 (_mm_and_si128 (_mm_cmpeq_epi8 (kv0, kvZero), _mm_cmpeq_epi8 (kv1, kvZero)),
+                                         _mm_cmpeq_epi8 (_mm_or_si128 (kv2, kvTwo), kvThree));
+    const uint32_t kuiMask = (uint32_t)_mm_movemask_epi8 (kvHit);
+    if (kuiMask)
+      return iIdx + LowestSetBit (kuiMask);
+  }
+
+  return iIdx + DetectEscOrStartCode_c (kpBuf + iIdx, kiBufSize - iIdx);
+}
+
+WELS_DEC_TARGET ("avx2")
+int32_t DetectEscOrStartCode_avx2 (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  const __m256i kvZero = _mm256_setzero_si256();
+  const __m256i kvTwo = _mm256_set1_epi8 (2);
+  const __m256i kvThree = _mm256_set1_epi8 (3);
+  int32_t iIdx = 0;
+
+  for (; iIdx + 34 <= kiBufSize; iIdx += 32) {
+    const __m256i kv0 = _mm256_loadu_si256 ((const __m256i*) (kpBuf + iIdx));
+    const __m256i kv1 = _mm256_loadu_si256 ((const __m256i*) (kpBuf + iIdx + 1));
+    const __m256i kv2 = _mm256_loadu_si256 ((const __m256i*) (kpBuf + iIdx + 2));
+    const __m256i kvHit = _mm256_and_si256 (_mm256_and_si256 (_mm256_cmpeq_epi8 (kv0, kvZero), _mm256_cmpeq_epi8 (kv1,
+                                            kvZero)), _mm256_cmpeq_epi8 (_mm256_or_si256 (kv2, kvTwo), kvThree));
+    const uint32_t kuiMask = (uint32_t)_mm256_movemask_epi8 (kvHit);
+    if (kuiMask)
+      return iIdx + LowestSetBit (kuiMask);
+  }
+
+  return iIdx + DetectEscOrStartCode_sse2 (kpBuf + iIdx, kiBufSize - iIdx);
+}
+
+} // namespace WelsDec
+
+#endif//X86_ASM
@@ -0,0 +1,218 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	color_convert.cpp
+ *
+ * \brief	Conversion of decoded I420 pictures into caller owned buffers of other colour formats
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include <string.h>
+#include "color_convert.h"
+#include "codec_def.h"
+#include "macros.h"
+#include "cpu_core.h"
+#include "error_code.h"
+
+namespace WelsDec {
+
+/*
+ *	BT.601 limited range to full range RGB in 8 bit fixed point:
+ *	R = 1.164 (Y-16) + 1.596 (V-128), G = 1.164 (Y-16) - 0.391 (U-128) - 0.813 (V-128), B = 1.164 (Y-16) + 2.018 (U-128)
+ */
+#define YUV2RGB_Y	298
+#define YUV2RGB_RV	409
+#define YUV2RGB_GU	100
+#define YUV2RGB_GV	208
+#define YUV2RGB_BU	516
+
+// chroma terms are shared by the two pixels of a pair, loops are kept simple for the compiler to vectorize
+static inline void YuvToRgbPixel (const int32_t kiY, const int32_t kiRv, const int32_t kiGuv, const int32_t kiBu,
+                                  uint8_t& uiR, uint8_t& uiG, uint8_t& uiB) {
+  const int32_t kiLuma = YUV2RGB_Y * (kiY - 16) + 128;
+  uiR = WELS_CLIP1 ((kiLuma + kiRv) >> 8);
+  uiG = WELS_CLIP1 ((kiLuma - kiGuv) >> 8);
+  uiB = WELS_CLIP1 ((kiLuma + kiBu) >> 8);
+}
+
+void InterleaveUVRow_c (uint8_t* pDst, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  for (int32_t i = 0; i < iWidth; i++) {
+    pDst[2 * i]		= pU[i];
+    pDst[2 * i + 1]	= pV[i];
+  }
+}
+
+void YuvToYuy2Row_c (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  const int32_t kiPairs = iWidth >> 1;
+  for (int32_t i = 0; i < kiPairs; i++) {
+    pDst[4 * i]		= pY[2 * i];
+    pDst[4 * i + 1]	= pU[i];
+    pDst[4 * i + 2]	= pY[2 * i + 1];
+    pDst[4 * i + 3]	= pV[i];
+  }
+  if (iWidth & 1) {
+    pDst[4 * kiPairs]		= pY[2 * kiPairs];
+    pDst[4 * kiPairs + 1]	= pU[kiPairs];
+  }
+}
+
+// bytes in memory are R, G, B for RGB24 (kiR = 0, kiB = 2) and B, G, R, A for BGRA (kiR = 2, kiB = 0)
+template<int32_t kiBpp, int32_t kiR, int32_t kiB>
+static inline void YuvToRgbRow (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV,
+                                int32_t iWidth) {
+  for (int32_t i = 0; i < iWidth; i++) {
+    const int32_t kiU	= pU[i >> 1] - 128;
+    const int32_t kiV	= pV[i >> 1] - 128;
+    uint8_t* pPix		= pDst + kiBpp * i;
+    YuvToRgbPixel (pY[i], YUV2RGB_RV * kiV, YUV2RGB_GU * kiU + YUV2RGB_GV * kiV, YUV2RGB_BU * kiU,
+                   pPix[kiR], pPix[1], pPix[kiB]);
+    if (kiBpp == 4)
+      pPix[3] = 255;
+  }
+}
+
+void YuvToRgb24Row_c (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  YuvToRgbRow<3, 0, 2> (pDst, pY, pU, pV, iWidth);
+}
+
+void YuvToBgraRow_c (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  YuvToRgbRow<4, 2, 0> (pDst, pY, pU, pV, iWidth);
+}
+
+void InitColorConvertFunc (SColorConvertFunc* pFunc, const uint32_t kuiCpuFlags) {
+  pFunc->pfInterleaveUVRow	= InterleaveUVRow_c;
+  pFunc->pfYuvToYuy2Row		= YuvToYuy2Row_c;
+  pFunc->pfYuvToRgb24Row	= YuvToRgb24Row_c;
+  pFunc->pfYuvToBgraRow		= YuvToBgraRow_c;
+#if defined(X86_ASM)
+  if (kuiCpuFlags & WELS_CPU_SSE2) {
+    pFunc->pfInterleaveUVRow	= InterleaveUVRow_sse2;
+    pFunc->pfYuvToYuy2Row		= YuvToYuy2Row_sse2;
+    pFunc->pfYuvToRgb24Row	= YuvToRgb24Row_sse2;
+    pFunc->pfYuvToBgraRow		= YuvToBgraRow_sse2;
+  }
+  if (kuiCpuFlags & WELS_CPU_AVX2) {
+    pFunc->pfInterleaveUVRow	= InterleaveUVRow_avx2;
+    pFunc->pfYuvToYuy2Row		= YuvToYuy2Row_avx2;
+    pFunc->pfYuvToRgb24Row	= YuvToRgb24Row_avx2;
+    pFunc->pfYuvToBgraRow		= YuvToBgraRow_avx2;
+  }
+#else
+  (void)kuiCpuFlags;
+#endif//X86_ASM
+}
+
+int32_t WelsColorConvertMinStride (const int32_t kiColorFormat, const int32_t kiWidth) {
+  switch (kiColorFormat) {
+  case videoFormatI420:
+  case videoFormatNV12:
+    return kiWidth;
+  case videoFormatYUY2:
+    return (kiWidth + (kiWidth & 1)) << 1;
+  case videoFormatRGB:
+    return kiWidth * 3;
+  case videoFormatBGRA:
+    return kiWidth << 2;
+  default:
+    return 0;
+  }
+}
+
+int32_t WelsColorConvertBufSize (const int32_t kiColorFormat, const int32_t kiStride, const int32_t kiHeight) {
+  const int32_t kiChromaHeight = (kiHeight + 1) >> 1;
+  switch (kiColorFormat) {
+  case videoFormatI420:
+    return kiStride * kiHeight + 2 * (kiStride >> 1) * kiChromaHeight;
+  case videoFormatNV12:
+    return kiStride * (kiHeight + kiChromaHeight);
+  case videoFormatYUY2:
+  case videoFormatRGB:
+  case videoFormatBGRA:
+    return kiStride * kiHeight;
+  default:
+    return 0;
+  }
+}
+
+int32_t WelsColorConvert (PColorConvertFunc pFunc, uint8_t* pSrc[3], const int32_t kiSrcStride[2], const int32_t kiWidth,
+                          const int32_t kiHeight, uint8_t* pDst, const int32_t kiDstStride, const int32_t kiColorFormat) {
+  const int32_t kiChromaWidth	= (kiWidth + 1) >> 1;
+  const int32_t kiChromaHeight	= (kiHeight + 1) >> 1;
+  PYuvToPackedRowFunc pfPackedRow = NULL;
+  int32_t i;
+
+  switch (kiColorFormat) {
+  case videoFormatI420: {
+    const int32_t kiDstStrideUV = kiDstStride >> 1;
+    uint8_t* pDstU = pDst + kiDstStride * kiHeight;
+    uint8_t* pDstV = pDstU + kiDstStrideUV * kiChromaHeight;
+    for (i = 0; i < kiHeight; i++)
+      memcpy (pDst + i * kiDstStride, pSrc[0] + i * kiSrcStride[0], kiWidth);
+    for (i = 0; i < kiChromaHeight; i++) {
+      memcpy (pDstU + i * kiDstStrideUV, pSrc[1] + i * kiSrcStride[1], kiChromaWidth);
+      memcpy (pDstV + i * kiDstStrideUV, pSrc[2] + i * kiSrcStride[1], kiChromaWidth);
+    }
+    return ERR_NONE;
+  }
+  case videoFormatNV12: {
+    uint8_t* pDstUV = pDst + kiDstStride * kiHeight;
+    for (i = 0; i < kiHeight; i++)
+      memcpy (pDst + i * kiDstStride, pSrc[0] + i * kiSrcStride[0], kiWidth);
+    for (i = 0; i < kiChromaHeight; i++)
+      pFunc->pfInterleaveUVRow (pDstUV + i * kiDstStride, pSrc[1] + i * kiSrcStride[1], pSrc[2] + i * kiSrcStride[1],
+                                kiChromaWidth);
+    return ERR_NONE;
+  }
+  case videoFormatYUY2:
+    pfPackedRow = pFunc->pfYuvToYuy2Row;
+    break;
+  case videoFormatRGB:
+    pfPackedRow = pFunc->pfYuvToRgb24Row;
+    break;
+  case videoFormatBGRA:
+    pfPackedRow = pFunc->pfYuvToBgraRow;
+    break;
+  default:
+    return ERR_INFO_INVALID_PARAM;
+  }
+
+  for (i = 0; i < kiHeight; i++) {
+    const int32_t kiOffsetUV = (i >> 1) * kiSrcStride[1];
+    pfPackedRow (pDst + i * kiDstStride, pSrc[0] + i * kiSrcStride[0], pSrc[1] + kiOffsetUV, pSrc[2] + kiOffsetUV,
+                 kiWidth);
+  }
+  return ERR_NONE;
+}
+
+} // namespace WelsDec
@@ -0,0 +1,300 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	color_convert_x86.cpp
+ *
+ * \brief	SSE2/AVX2 row kernels of the colour conversion into caller owned buffers
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+#include "color_convert.h"
+
+#if defined(X86_ASM)
+
+#include <string.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+#define WELS_DEC_TARGET(kpIsa)	__attribute__ ((target (kpIsa)))
+#else
+#define WELS_DEC_TARGET(kpIsa)
+#endif//__GNUC__
+
+namespace WelsDec {
+
+/* coefficient pairs of _mm_madd_epi16, kiLo multiplies the even 16 bit lane and kiHi the odd one */
+#define MADD_PAIR(kiLo, kiHi)	((int32_t)(((uint32_t)(uint16_t)(kiHi) << 16) | (uint16_t)(kiLo)))
+
+/*
+ *	the fixed point terms of YuvToRgbPixel() in 32 bit lanes: Y, U and V are interleaved into 16 bit pairs and
+ *	multiplied by _mm_madd_epi16, so R = (298 Y' + 409 V' + 128) >> 8 and so on are exact as in the C rows;
+ *	the saturating packs clip to [0, 255] as WELS_CLIP1
+ */
+
+WELS_DEC_TARGET ("sse2")
+static inline __m128i RgbTerm_sse2 (const __m128i kvA, const __m128i kvB, const int32_t kiPair, const __m128i kvAdd) {
+  const __m128i kvPair = _mm_set1_epi32 (kiPair);
+  const __m128i kvLo = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (_mm_unpacklo_epi16 (kvA, kvB), kvPair), kvAdd), 8);
+  const __m128i kvHi = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (_mm_unpackhi_epi16 (kvA, kvB), kvPair), kvAdd), 8);
+  return _mm_packs_epi32 (kvLo, kvHi);
+}
+
+// R, G and B as 16 bit of 8 pixels from 8 luma and 4 chroma samples
+WELS_DEC_TARGET ("sse2")
+static inline void YuvToRgb8_sse2 (const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, __m128i& vR, __m128i& vG,
+                                   __m128i& vB) {
+  const __m128i kvZero = _mm_setzero_si128();
+  const __m128i kvRound = _mm_set1_epi32 (128);
+  int32_t iU, iV;
+  memcpy (&iU, pU, sizeof (iU));
+  memcpy (&iV, pV, sizeof (iV));
+  __m128i vU = _mm_cvtsi32_si128 (iU);
+  __m128i vV = _mm_cvtsi32_si128 (iV);
+  const __m128i kvY = _mm_sub_epi16 (_mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i*)pY), kvZero),
+                                     _mm_set1_epi16 (16));
+  vU = _mm_sub_epi16 (_mm_unpacklo_epi8 (_mm_unpacklo_epi8 (vU, vU), kvZero), _mm_set1_epi16 (128));
+  vV = _mm_sub_epi16 (_mm_unpacklo_epi8 (_mm_unpacklo_epi8 (vV, vV), kvZero), _mm_set1_epi16 (128));
+
+  vR = RgbTerm_sse2 (kvY, vV, MADD_PAIR (298, 409), kvRound);
+  vB = RgbTerm_sse2 (kvY, vU, MADD_PAIR (298, 516), kvRound);
+  // -100 U' - 208 V' + 128 first, then 298 Y' on top of it
+  const __m128i kvGv = _mm_set1_epi32 (MADD_PAIR (-208, 128));
+  const __m128i kvOne = _mm_set1_epi16 (1);
+  const __m128i kvGvLo = _mm_madd_epi16 (_mm_unpacklo_epi16 (vV, kvOne), kvGv);
+  const __m128i kvGvHi = _mm_madd_epi16 (_mm_unpackhi_epi16 (vV, kvOne), kvGv);
+  const __m128i kvGyu = _mm_set1_epi32 (MADD_PAIR (298, -100));
+  const __m128i kvGLo = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (_mm_unpacklo_epi16 (kvY, vU), kvGyu), kvGvLo), 8);
+  const __m128i kvGHi = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (_mm_unpackhi_epi16 (kvY, vU), kvGyu), kvGvHi), 8);
+  vG = _mm_packs_epi32 (kvGLo, kvGHi);
+}
+
+// R, G and B bytes of 16 pixels
+WELS_DEC_TARGET ("sse2")
+static inline void YuvToRgb16_sse2 (const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, __m128i& vR, __m128i& vG,
+                                    __m128i& vB) {
+  __m128i vR0, vG0, vB0, vR1, vG1, vB1;
+  YuvToRgb8_sse2 (pY, pU, pV, vR0, vG0, vB0);
+  YuvToRgb8_sse2 (pY + 8, pU + 4, pV + 4, vR1, vG1, vB1);
+  vR = _mm_packus_epi16 (vR0, vR1);
+  vG = _mm_packus_epi16 (vG0, vG1);
+  vB = _mm_packus_epi16 (vB0, vB1);
+}
+
+WELS_DEC_TARGET ("sse2")
+static inline void StoreBgra16_sse2 (uint8_t* pDst, const __m128i kvR, const __m128i kvG, const __m128i kvB) {
+  const __m128i kvAlpha = _mm_set1_epi8 ((char)0xff);
+  const __m128i kvBgLo = _mm_unpacklo_epi8 (kvB, kvG);
+  const __m128i kvBgHi = _mm_unpackhi_epi8 (kvB, kvG);
+  const __m128i kvRaLo = _mm_unpacklo_epi8 (kvR, kvAlpha);
+  const __m128i kvRaHi = _mm_unpackhi_epi8 (kvR, kvAlpha);
+  _mm_storeu_si128 ((__m128i*)pDst, _mm_unpacklo_epi16 (kvBgLo, kvRaLo));
+  _mm_storeu_si128 ((__m128i*) (pDst + 16), _mm_unpackhi_epi16 (kvBgLo, kvRaLo));
+  _mm_storeu_si128 ((__m128i*) (pDst + 32), _mm_unpacklo_epi16 (kvBgHi, kvRaHi));
+  _mm_storeu_si128 ((__m128i*) (pDst + 48), _mm_unpackhi_epi16 (kvBgHi, kvRaHi));
+}
+
+/*
+ *	4 pixels as R, G, B, 0 are squeezed to 6 bytes in each 64 bit lane, each lane is stored with 8 bytes and
+ *	the 2 bytes behind are overwritten by the next store: 2 bytes behind the 48 of 16 pixels are written
+ */
+WELS_DEC_TARGET ("sse2")
+static inline void StoreRgb24x4_sse2 (uint8_t* pDst, const __m128i kvRgbx) {
+  const __m128i kvMaskLo = _mm_set_epi32 (0, 0x00ffffff, 0, 0x00ffffff);
+  const __m128i kvMaskHi = _mm_set_epi32 (0x0000ffff, 0xff000000, 0x0000ffff, 0xff000000);
+  const __m128i kvPacked = _mm_or_si128 (_mm_and_si128 (kvRgbx, kvMaskLo),
+                                         _mm_and_si128 (_mm_srli_epi64 (kvRgbx, 8), kvMaskHi));
+  _mm_storel_epi64 ((__m128i*)pDst, kvPacked);
+  _mm_storel_epi64 ((__m128i*) (pDst + 6), _mm_srli_si128 (kvPacked, 8));
+}
+
+WELS_DEC_TARGET ("sse2")
+static inline void StoreRgb24x16_sse2 (uint8_t* pDst, const __m128i kvR, const __m128i kvG, const __m128i kvB) {
+  const __m128i kvZero = _mm_setzero_si128();
+  const __m128i kvRgLo = _mm_unpacklo_epi8 (kvR, kvG);
+  const __m128i kvRgHi = _mm_unpackhi_epi8 (kvR, kvG);
+  const __m128i kvBxLo = _mm_unpacklo_epi8 (kvB, kvZero);
+  const __m128i kvBxHi = _mm_unpackhi_epi8 (kvB, kvZero);
+  StoreRgb24x4_sse2 (pDst, _mm_unpacklo_epi16 (kvRgLo, kvBxLo));
+  StoreRgb24x4_sse2 (pDst + 12, _mm_unpackhi_epi16 (kvRgLo, kvBxLo));
+  StoreRgb24x4_sse2 (pDst + 24, _mm_unpacklo_epi16 (kvRgHi, kvBxHi));
+  StoreRgb24x4_sse2 (pDst + 36, _mm_unpackhi_epi16 (kvRgHi, kvBxHi));
+}
+
+WELS_DEC_TARGET ("sse2")
+void InterleaveUVRow_sse2 (uint8_t* pDst, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  for (; i + 16 <= iWidth; i += 16) {
+    const __m128i kvU = _mm_loadu_si128 ((const __m128i*) (pU + i));
+    const __m128i kvV = _mm_loadu_si128 ((const __m128i*) (pV + i));
+    _mm_storeu_si128 ((__m128i*) (pDst + 2 * i), _mm_unpacklo_epi8 (kvU, kvV));
+    _mm_storeu_si128 ((__m128i*) (pDst + 2 * i + 16), _mm_unpackhi_epi8 (kvU, kvV));
+  }
+  InterleaveUVRow_c (pDst + 2 * i, pU + i, pV + i, iWidth - i);
+}
+
+WELS_DEC_TARGET ("sse2")
+void YuvToYuy2Row_sse2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  for (; i + 16 <= iWidth; i += 16) {
+    const __m128i kvY = _mm_loadu_si128 ((const __m128i*) (pY + i));
+    const __m128i kvUV = _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i*) (pU + (i >> 1))),
+                                            _mm_loadl_epi64 ((const __m128i*) (pV + (i >> 1))));
+    _mm_storeu_si128 ((__m128i*) (pDst + 2 * i), _mm_unpacklo_epi8 (kvY, kvUV));
+    _mm_storeu_si128 ((__m128i*) (pDst + 2 * i + 16), _mm_unpackhi_epi8 (kvY, kvUV));
+  }
+  YuvToYuy2Row_c (pDst + 2 * i, pY + i, pU + (i >> 1), pV + (i >> 1), iWidth - i);
+}
+
+WELS_DEC_TARGET ("sse2")
+void YuvToRgb24Row_sse2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  // a pixel behind the 16 takes the 2 bytes stored past them
+  for (; i + 16 < iWidth; i += 16) {
+    __m128i vR, vG, vB;
+    YuvToRgb16_sse2 (pY + i, pU + (i >> 1), pV + (i >> 1), vR, vG, vB);
+    StoreRgb24x16_sse2 (pDst + 3 * i, vR, vG, vB);
+  }
+  YuvToRgb24Row_c (pDst + 3 * i, pY + i, pU + (i >> 1), pV + (i >> 1), iWidth - i);
+}
+
+WELS_DEC_TARGET ("sse2")
+void YuvToBgraRow_sse2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  for (; i + 16 <= iWidth; i += 16) {
+    __m128i vR, vG, vB;
+    YuvToRgb16_sse2 (pY + i, pU + (i >> 1), pV + (i >> 1), vR, vG, vB);
+    StoreBgra16_sse2 (pDst + 4 * i, vR, vG, vB);
+  }
+  YuvToBgraRow_c (pDst + 4 * i, pY + i, pU + (i >> 1), pV + (i >> 1), iWidth - i);
+}
+
+WELS_DEC_TARGET ("avx2")
+static inline __m256i RgbTerm_avx2 (const __m256i kvA, const __m256i kvB, const int32_t kiPair, const __m256i kvAdd) {
+  const __m256i kvPair = _mm256_set1_epi32 (kiPair);
+  const __m256i kvLo = _mm256_srai_epi32 (_mm256_add_epi32 (_mm256_madd_epi16 (_mm256_unpacklo_epi16 (kvA, kvB), kvPair),
+                                          kvAdd), 8);
+  const __m256i kvHi = _mm256_srai_epi32 (_mm256_add_epi32 (_mm256_madd_epi16 (_mm256_unpackhi_epi16 (kvA, kvB), kvPair),
+                                          kvAdd), 8);
+  // the unpacks and packs both work within 128 bit lanes, so the pixels come back in order
+  return _mm256_packs_epi32 (kvLo, kvHi);
+}
+
+WELS_DEC_TARGET ("avx2")
+static inline __m128i PackBytes_avx2 (const __m256i kv16) {
+  return _mm_packus_epi16 (_mm256_castsi256_si128 (kv16), _mm256_extracti128_si256 (kv16, 1));
+}
+
+// R, G and B bytes of 16 pixels
+WELS_DEC_TARGET ("avx2")
+static inline void YuvToRgb16_avx2 (const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, __m128i& vR, __m128i& vG,
+                                    __m128i& vB) {
+  const __m256i kvRound = _mm256_set1_epi32 (128);
+  const __m128i kvU8 = _mm_loadl_epi64 ((const __m128i*)pU);
+  const __m128i kvV8 = _mm_loadl_epi64 ((const __m128i*)pV);
+  const __m256i kvY = _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i*)pY)),
+                                        _mm256_set1_epi16 (16));
+  const __m256i kvU = _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (_mm_unpacklo_epi8 (kvU8, kvU8)), _mm256_set1_epi16 (128));
+  const __m256i kvV = _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (_mm_unpacklo_epi8 (kvV8, kvV8)), _mm256_set1_epi16 (128));
+
+  vR = PackBytes_avx2 (RgbTerm_avx2 (kvY, kvV, MADD_PAIR (298, 409), kvRound));
+  vB = PackBytes_avx2 (RgbTerm_avx2 (kvY, kvU, MADD_PAIR (298, 516), kvRound));
+  const __m256i kvGv = _mm256_set1_epi32 (MADD_PAIR (-208, 128));
+  const __m256i kvOne = _mm256_set1_epi16 (1);
+  const __m256i kvGvLo = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (kvV, kvOne), kvGv);
+  const __m256i kvGvHi = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (kvV, kvOne), kvGv);
+  const __m256i kvGyu = _mm256_set1_epi32 (MADD_PAIR (298, -100));
+  const __m256i kvGLo = _mm256_srai_epi32 (_mm256_add_epi32 (_mm256_madd_epi16 (_mm256_unpacklo_epi16 (kvY, kvU), kvGyu),
+                                           kvGvLo), 8);
+  const __m256i kvGHi = _mm256_srai_epi32 (_mm256_add_epi32 (_mm256_madd_epi16 (_mm256_unpackhi_epi16 (kvY, kvU), kvGyu),
+                                           kvGvHi), 8);
+  vG = PackBytes_avx2 (_mm256_packs_epi32 (kvGLo, kvGHi));
+}
+
+/* the 128 bit lanes of the unpacks hold elements 0-7 and 16-23, 8-15 and 24-31; the permutes put them in order */
+WELS_DEC_TARGET ("avx2")
+void InterleaveUVRow_avx2 (uint8_t* pDst, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  for (; i + 32 <= iWidth; i += 32) {
+    const __m256i kvU = _mm256_loadu_si256 ((const __m256i*) (pU + i));
+    const __m256i kvV = _mm256_loadu_si256 ((const __m256i*) (pV + i));
+    const __m256i kvLo = _mm256_unpacklo_epi8 (kvU, kvV);
+    const __m256i kvHi = _mm256_unpackhi_epi8 (kvU, kvV);
+    _mm256_storeu_si256 ((__m256i*) (pDst + 2 * i), _mm256_permute2x128_si256 (kvLo, kvHi, 0x20));
+    _mm256_storeu_si256 ((__m256i*) (pDst + 2 * i + 32), _mm256_permute2x128_si256 (kvLo, kvHi, 0x31));
+  }
+  InterleaveUVRow_sse2 (pDst + 2 * i, pU + i, pV + i, iWidth - i);
+}
+
+WELS_DEC_TARGET ("avx2")
+void YuvToYuy2Row_avx2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  for (; i + 32 <= iWidth; i += 32) {
+    const __m128i kvU = _mm_loadu_si128 ((const __m128i*) (pU + (i >> 1)));
+    const __m128i kvV = _mm_loadu_si128 ((const __m128i*) (pV + (i >> 1)));
+    const __m256i kvUV = _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_unpacklo_epi8 (kvU, kvV)),
+                         _mm_unpackhi_epi8 (kvU, kvV), 1);
+    const __m256i kvY = _mm256_loadu_si256 ((const __m256i*) (pY + i));
+    const __m256i kvLo = _mm256_unpacklo_epi8 (kvY, kvUV);
+    const __m256i kvHi = _mm256_unpackhi_epi8 (kvY, kvUV);
+    _mm256_storeu_si256 ((__m256i*) (pDst + 2 * i), _mm256_permute2x128_si256 (kvLo, kvHi, 0x20));
+    _mm256_storeu_si256 ((__m256i*) (pDst + 2 * i + 32), _mm256_permute2x128_si256 (kvLo, kvHi, 0x31));
+  }
+  YuvToYuy2Row_sse2 (pDst + 2 * i, pY + i, pU + (i >> 1), pV + (i >> 1), iWidth - i);
+}
+
+WELS_DEC_TARGET ("avx2")
+void YuvToRgb24Row_avx2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  for (; i + 16 < iWidth; i += 16) {
+    __m128i vR, vG, vB;
+    YuvToRgb16_avx2 (pY + i, pU + (i >> 1), pV + (i >> 1), vR, vG, vB);
+    StoreRgb24x16_sse2 (pDst + 3 * i, vR, vG, vB);
+  }
+  YuvToRgb24Row_c (pDst + 3 * i, pY + i, pU + (i >> 1), pV + (i >> 1), iWidth - i);
+}
+
+WELS_DEC_TARGET ("avx2")
+void YuvToBgraRow_avx2 (uint8_t* pDst, const uint8_t* pY, const uint8_t* pU, const uint8_t* pV, int32_t iWidth) {
+  int32_t i = 0;
+  for (; i + 16 <= iWidth; i += 16) {
+    __m128i vR, vG, vB;
+    YuvToRgb16_avx2 (pY + i, pU + (i >> 1), pV + (i >> 1), vR, vG, vB);
+    StoreBgra16_sse2 (pDst + 4 * i, vR, vG, vB);
+  }
+  YuvToBgraRow_c (pDst + 4 * i, pY + i, pU + (i >> 1), pV + (i >> 1), iWidth - i);
+}
+
+} // namespace WelsDec
+
+#endif//X86_ASM
@@ -616,6 +616,25 @@ void WelsDeblockingMb (PDqLayer pCurDqLayer, PDeblockingFilter  pFilter, int32_t
   }
 }
 
+static void DeblockingInitFilter (PWelsDecoderContext pCtx, PDeblockingFilter pFilter) {
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  PSliceHeader pSliceHeader = &pCurDqLayer->sLayerInfo.sSliceInLayer.sSliceHeaderExt.sSliceHeader;
+
+  pFilter->pCsData[0] = pCtx->pDec->pData[0];
+  pFilter->pCsData[1] = pCtx->pDec->pData[1];
+  pFilter->pCsData[2] = pCtx->pDec->pData[2];
+
+  pFilter->iCsStride[0] = pCtx->pDec->iLinesize[0];
+  pFilter->iCsStride[1] = pCtx->pDec->iLinesize[1];
+
+  pFilter->eSliceType = (ESliceType) pCurDqLayer->sLayerInfo.sSliceInLayer.eSliceType;
+
+  pFilter->iSliceAlphaC0Offset = pSliceHeader->iSliceAlphaC0Offset;
+  pFilter->iSliceBetaOffset     = pSliceHeader->iSliceBetaOffset;
+
+  pFilter->pLoopf = &pCtx->sDeblockingFunc;
+}
+
 /*!
  * \brief	AVC slice deblocking filtering target layer
  *
@@ -639,19 +658,7 @@ void WelsDeblockingFilterSlice (PWelsDecoderContext pCtx, PDeblockingFilterMbFun
   int32_t iFilterIdc = pCurDqLayer->sLayerInfo.sSliceInLayer.sSliceHeaderExt.sSliceHeader.uiDisableDeblockingFilterIdc;
 
   /* Step1: parameters set */
-  pFilter.pCsData[0] = pCtx->pDec->pData[0];
-  pFilter.pCsData[1] = pCtx->pDec->pData[1];
-  pFilter.pCsData[2] = pCtx->pDec->pData[2];
-
-  pFilter.iCsStride[0] = pCtx->pDec->iLinesize[0];
-  pFilter.iCsStride[1] = pCtx->pDec->iLinesize[1];
-
-  pFilter.eSliceType = (ESliceType) pCurDqLayer->sLayerInfo.sSliceInLayer.eSliceType;
-
-  pFilter.iSliceAlphaC0Offset = pSliceHeaderExt->sSliceHeader.iSliceAlphaC0Offset;
-  pFilter.iSliceBetaOffset     = pSliceHeaderExt->sSliceHeader.iSliceBetaOffset;
-
-  pFilter.pLoopf = &pCtx->sDeblockingFunc;
+  DeblockingInitFilter (pCtx, &pFilter);
 
   /* Step2: macroblock deblocking */
   if (0 == iFilterIdc || 2 == iFilterIdc) {
@@ -685,6 +692,70 @@ void WelsDeblockingFilterSlice (PWelsDecoderContext pCtx, PDeblockingFilterMbFun
     } while (1);
   }
 }
+
+void WelsDeblockingInitSliceRows (PWelsDecoderContext pCtx, PDeblockingSliceRows pRows) {
+  PSlice pCurSlice = &pCtx->pCurDqLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader = &pCurSlice->sSliceHeaderExt.sSliceHeader;
+
+  memset (&pRows->sFilter, 0, sizeof (SDeblockingFilter));
+  DeblockingInitFilter (pCtx, &pRows->sFilter);
+  pRows->iFilterIdc	= pSliceHeader->uiDisableDeblockingFilterIdc;
+  pRows->bFilterFlag	= (pCurSlice->eSliceType == I_SLICE || pCurSlice->eSliceType == P_SLICE) && 1 != pRows->iFilterIdc;
+  pRows->iMbNext		= pSliceHeader->iFirstMbInSlice;
+  pRows->iMbEnd		= WELS_MIN (pSliceHeader->iFirstMbInSlice + pCurSlice->iTotalMbInCurSlice,
+                                (int32_t)pSliceHeader->pSps->uiTotalMbCount);
+  pRows->pPic			= pCtx->pDec;
+}
+
+void WelsDeblockingFilterSliceRows (PWelsDecoderContext pCtx, PDqLayer pCurDqLayer, PDeblockingSliceRows pRows,
+                                    const int32_t kiMbRecEnd, const bool kbSliceEnd) {
+  const int32_t kiMbWidth = pCurDqLayer->iMbWidth;
+  const int32_t kiMbStart = pRows->iMbNext;
+  int32_t iMbEnd = kbSliceEnd ? pRows->iMbEnd : (kiMbRecEnd / kiMbWidth - 1) * kiMbWidth;
+
+  iMbEnd = WELS_MIN (iMbEnd, pRows->iMbEnd);
+  if (iMbEnd <= kiMbStart)
+    return;
+
+  if (pRows->bFilterFlag) {
+    int32_t iMbXy = kiMbStart;
+    for (; iMbXy < iMbEnd; iMbXy++) {
+      pCurDqLayer->iMbX		= iMbXy % kiMbWidth;
+      pCurDqLayer->iMbY		= iMbXy / kiMbWidth;
+      pCurDqLayer->iMbXyIndex	= iMbXy;
+      WelsDeblockingMb (pCurDqLayer, &pRows->sFilter, DeblockingAvailableNoInterlayer (pCurDqLayer, pRows->iFilterIdc));
+    }
+  }
+  pRows->iMbNext = iMbEnd;
+
+  WelsDeblockingMbsDone (pCtx, pCurDqLayer, pRows->pPic, kiMbStart, iMbEnd - kiMbStart);
+}
+
+/*
+ *	Filtering MB row y+1 changes the bottom samples of row y, so a row is final once the row below is finished.
+ */
+void WelsDeblockingMbsDone (PWelsDecoderContext pCtx, PDqLayer pCurDqLayer, PPicture pPic, const int32_t kiMbStart,
+                            const int32_t kiMbNum) {
+  const int32_t kiMbWidth		= pCurDqLayer->iMbWidth;
+  const int32_t kiMbHeight	= pCurDqLayer->iMbHeight;
+  int32_t iRows = 0;
+
+  if (kiMbStart == pCtx->iDeblockedMbNum)
+    pCtx->iDeblockedMbNum += kiMbNum;
+  pCtx->iDeblockedMbTotal += kiMbNum;
+
+  if (pCtx->iDeblockedMbTotal >= kiMbWidth * kiMbHeight)
+    iRows = kiMbHeight;
+  else
+    iRows = WELS_MAX (pCtx->iDeblockedMbNum / kiMbWidth - 1, 0);
+
+  if (iRows > pCtx->iFinishedMbRows) {
+    if (NULL != pCtx->pfMbRowsFinished)
+      pCtx->pfMbRowsFinished (pCtx->pMbRowsFinishedArg, pPic, kiMbWidth, kiMbHeight, pCtx->iFinishedMbRows, iRows);
+    pCtx->iFinishedMbRows = iRows;
+  }
+}
+
 /*!
  * \brief	deblocking module initialize
  *
@@ -0,0 +1,128 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	dec_cabac.cpp
+ *
+ * \brief	Binary arithmetic decoding engine of CABAC
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include "dec_cabac.h"
+
+namespace WelsDec {
+
+// g_kuiStateTransTable rearranged on packed states (pStateIdx << 1 | valMPS), so a bin updates its context by one lookup
+const uint8_t g_kuiCabacDecStateTrans[128][2] = {
+  {  2,   1}, {  0,   3}, {  4,   0}, {  1,   5}, {  6,   2}, {  3,   7}, {  8,   4}, {  5,   9},
+  { 10,   4}, {  5,  11}, { 12,   8}, {  9,  13}, { 14,   8}, {  9,  15}, { 16,  10}, { 11,  17},
+  { 18,  12}, { 13,  19}, { 20,  14}, { 15,  21}, { 22,  16}, { 17,  23}, { 24,  18}, { 19,  25},
+  { 26,  18}, { 19,  27}, { 28,  22}, { 23,  29}, { 30,  22}, { 23,  31}, { 32,  24}, { 25,  33},
+  { 34,  26}, { 27,  35}, { 36,  26}, { 27,  37}, { 38,  30}, { 31,  39}, { 40,  30}, { 31,  41},
+  { 42,  32}, { 33,  43}, { 44,  32}, { 33,  45}, { 46,  36}, { 37,  47}, { 48,  36}, { 37,  49},
+  { 50,  38}, { 39,  51}, { 52,  38}, { 39,  53}, { 54,  42}, { 43,  55}, { 56,  42}, { 43,  57},
+  { 58,  44}, { 45,  59}, { 60,  44}, { 45,  61}, { 62,  46}, { 47,  63}, { 64,  48}, { 49,  65},
+  { 66,  48}, { 49,  67}, { 68,  50}, { 51,  69}, { 70,  52}, { 53,  71}, { 72,  52}, { 53,  73},
+  { 74,  54}, { 55,  75}, { 76,  54}, { 55,  77}, { 78,  56}, { 57,  79}, { 80,  58}, { 59,  81},
+  { 82,  58}, { 59,  83}, { 84,  60}, { 61,  85}, { 86,  60}, { 61,  87}, { 88,  60}, { 61,  89},
+  { 90,  62}, { 63,  91}, { 92,  64}, { 65,  93}, { 94,  64}, { 65,  95}, { 96,  66}, { 67,  97},
+  { 98,  66}, { 67,  99}, {100,  66}, { 67, 101}, {102,  68}, { 69, 103}, {104,  68}, { 69, 105},
+  {106,  70}, { 71, 107}, {108,  70}, { 71, 109}, {110,  70}, { 71, 111}, {112,  72}, { 73, 113},
+  {114,  72}, { 73, 115}, {116,  72}, { 73, 117}, {118,  74}, { 75, 119}, {120,  74}, { 75, 121},
+  {122,  74}, { 75, 123}, {124,  76}, { 77, 125}, {124,  76}, { 77, 125}, {126, 126}, {127, 127},
+};
+
+int32_t WelsCabacDecRefill (PWelsCabacDecEngine pEngine) {
+  const uint8_t* pBuf = pEngine->pBuffCurr;
+  uint64_t uiBytes = 0;
+  int32_t i;
+
+  // a conforming slice never needs bits beyond its rbsp_stop_one_bit, bytes beyond the end only pad the window
+  if (pBuf >= pEngine->pBuffEnd)
+    return ERR_INFO_READ_OVERFLOW;
+
+  for (i = 0; i < CABAC_FETCH_BYTES; i++) {
+    uiBytes <<= 8;
+    if (pBuf + i < pEngine->pBuffEnd)
+      uiBytes |= pBuf[i];
+  }
+  pEngine->uiOffset = (pEngine->uiOffset << (CABAC_FETCH_BYTES << 3)) | uiBytes;
+  pEngine->pBuffCurr += CABAC_FETCH_BYTES;
+  pEngine->iBitsLeft += CABAC_FETCH_BYTES << 3;
+  return ERR_NONE;
+}
+
+int32_t WelsCabacDecEngineInit (PWelsCabacDecEngine pEngine, const uint8_t* pBuf, const uint8_t* pBufEnd) {
+  pEngine->pBuffStart	= pBuf;
+  pEngine->pBuffCurr	= pBuf;
+  pEngine->pBuffEnd		= pBufEnd;
+  pEngine->uiOffset		= 0;
+  pEngine->iBitsLeft	= 0;
+  WELS_READ_VERIFY (WelsCabacDecRefill (pEngine));
+
+  // codIOffset is the first 9 bits read
+  pEngine->uiRange		= 510;
+  pEngine->iBitsLeft	-= 9;
+  if ((pEngine->uiOffset >> pEngine->iBitsLeft) >= 510)
+    return ERR_INFO_READ_OVERFLOW;	// codIOffset of 510 and 511 is not allowed in conforming streams
+  return ERR_NONE;
+}
+
+void WelsCabacDecContextInit (PWelsCabacDecEngine pEngine, const int32_t kiModel, const int32_t kiSliceQp) {
+  WelsCabacContextStateInit (pEngine->sStateCtx, kiModel, kiSliceQp);
+}
+
+int32_t WelsCabacDecUeBypass (PWelsCabacDecEngine pEngine, int32_t iExpBits, uint32_t& uiVal) {
+  uint32_t uiCode = 0;
+  uint32_t uiBin;
+
+  uiVal = 0;
+  do {
+    WELS_READ_VERIFY (WelsCabacDecBypass (pEngine, uiBin));
+    if (uiBin == 0)
+      break;
+    uiVal += 1 << iExpBits;
+    ++ iExpBits;
+  } while (iExpBits < 32);
+  if (iExpBits >= 32)
+    return ERR_INFO_READ_OVERFLOW;
+
+  while (iExpBits-- > 0) {
+    WELS_READ_VERIFY (WelsCabacDecBypass (pEngine, uiBin));
+    uiCode = (uiCode << 1) | uiBin;
+  }
+  uiVal += uiCode;
+  return ERR_NONE;
+}
+
+} // namespace WelsDec
@@ -0,0 +1,1019 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file		dec_multi_threading.cpp
+ *
+ * \brief		frame level multiple threading reconstruction of decoder
+ *
+ * \date		10/17/2014 Created
+ *************************************************************************************
+ */
+
+#include "dec_multi_threading.h"
+#include "decode_slice.h"
+#include "deblocking.h"
+#include "expand_pic.h"
+#include "mem_align.h"
+#include "error_code.h"
+#include "utils.h"
+
+namespace WelsDec {
+
+#if defined(MT_ENABLED)
+
+#define DEC_MT_ALIGN(x)	WELS_ALIGN ((x), 16)
+
+/*
+ *	Picture hold counts and row progress, slot states and the waiter list are protected by mutexProgress.
+ */
+static inline void HoldPicture (PPicture pPic) {
+  if (NULL != pPic)
+    ++ pPic->uiRefCount;
+}
+
+static inline void UnholdPicture (PPicture pPic) {
+  if (NULL != pPic && pPic->uiRefCount > 0)
+    -- pPic->uiRefCount;
+}
+
+static void PublishPicRows (PDecThreadCtx pThreadCtx, PPicture pPic, const int32_t kiRows) {
+  int32_t i = 0;
+
+  pPic->iReadyMbRows = kiRows;
+  while (i < pThreadCtx->iWaiterNum) {
+    SDecRowWaiter* pWaiter = &pThreadCtx->sWaiters[i];
+    if (pWaiter->pPic == pPic && pWaiter->iRows <= kiRows) {
+      WelsEventSignal (pWaiter->pEvent);
+      *pWaiter = pThreadCtx->sWaiters[-- pThreadCtx->iWaiterNum];
+    } else {
+      ++ i;
+    }
+  }
+}
+
+static void WaitPicRows (PDecThreadCtx pThreadCtx, PPicture pPic, const int32_t kiRows, WELS_EVENT* pEvent) {
+  while (pPic->iReadyMbRows < kiRows) {
+    SDecRowWaiter* pWaiter = &pThreadCtx->sWaiters[pThreadCtx->iWaiterNum ++];
+    WELS_THREAD_ERROR_CODE iWaitRet = WELS_THREAD_ERROR_OK;
+    int32_t i = 0;
+    pWaiter->pPic	= pPic;
+    pWaiter->iRows	= kiRows;
+    pWaiter->pEvent	= pEvent;
+
+    WelsMutexUnlock (&pThreadCtx->mutexProgress);
+    iWaitRet = WelsEventWait (pEvent);
+    WelsMutexLock (&pThreadCtx->mutexProgress);
+
+    // an interrupted wait may leave the waiter registered, it must not be added once more
+    for (i = 0; WELS_THREAD_ERROR_OK != iWaitRet && i < pThreadCtx->iWaiterNum; i++) {
+      if (pThreadCtx->sWaiters[i].pEvent == pEvent) {
+        pThreadCtx->sWaiters[i] = pThreadCtx->sWaiters[-- pThreadCtx->iWaiterNum];
+        break;
+      }
+    }
+  }
+}
+
+/* wait for the earliest submitted job, return false if no job is in flight */
+static bool WaitOldestReconJob (PDecThreadCtx pThreadCtx) {
+  PDecReconSlot pOldest = NULL;
+  int32_t i = 0;
+
+  if (pThreadCtx->bSliceThreading)
+    return false;
+
+  for (i = 0; i < pThreadCtx->iSlotNum; i++) {
+    PDecReconSlot pSlot = &pThreadCtx->sSlots[i];
+    if (RECON_SLOT_BUSY == pSlot->eState && (NULL == pOldest || pSlot->iSeq < pOldest->iSeq))
+      pOldest = pSlot;
+  }
+  if (NULL == pOldest)
+    return false;
+
+  WaitPicRows (pThreadCtx, pOldest->pPic, pOldest->sDqLayer.iMbHeight, pThreadCtx->pCallerEvent);
+  return true;
+}
+
+static void WaitSliceJobDone (PDecThreadCtx pThreadCtx, PDecReconSlot pSlot) {
+  while (RECON_SLOT_BUSY == pSlot->eState) {
+    pThreadCtx->bSliceWaiting = true;
+    WelsMutexUnlock (&pThreadCtx->mutexProgress);
+    WelsEventWait (pThreadCtx->pCallerEvent);
+    WelsMutexLock (&pThreadCtx->mutexProgress);
+  }
+}
+
+/* slice jobs are dropped in submission order, results are not collected */
+static void DropSliceJobs (PDecThreadCtx pThreadCtx) {
+  while (pThreadCtx->iRetireSeq < pThreadCtx->iSubmitSeq) {
+    PDecReconSlot pSlot = &pThreadCtx->sSlots[pThreadCtx->iRetireSeq % pThreadCtx->iSlotNum];
+    WaitSliceJobDone (pThreadCtx, pSlot);
+    pSlot->eState = RECON_SLOT_IDLE;
+    ++ pThreadCtx->iRetireSeq;
+  }
+  pThreadCtx->iSliceErr = ERR_NONE;
+}
+
+static void WaitAllReconJobs (PDecThreadCtx pThreadCtx) {
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  if (pThreadCtx->bSliceThreading)
+    DropSliceJobs (pThreadCtx);
+  else
+    while (WaitOldestReconJob (pThreadCtx));
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+static void DropOutputPic (PDecThreadCtx pThreadCtx) {
+  UnholdPicture (pThreadCtx->sOutputPics[pThreadCtx->iOutputHead].pPic);
+  pThreadCtx->iOutputHead = (pThreadCtx->iOutputHead + 1) % MAX_DEC_OUTPUT_PIC_NUM;
+  -- pThreadCtx->iOutputNum;
+}
+
+/*
+ *	MB level arrays of the private DQ layer, allocated as a whole and (re)requested on picture size changes
+ */
+static int32_t RequestReconSlotMem (PWelsDecoderContext pCtx, PDecReconSlot pSlot) {
+  PDqLayer pDq = &pSlot->sDqLayer;
+  const int32_t kiMbNum = pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight;
+  const int32_t kiLumaLines = (pCtx->sMb.iMbHeight << 4) + (PADDING_LENGTH << 1);
+  const int32_t kiCsSize = pCtx->iCsStride[0] * kiLumaLines + ((pCtx->iCsStride[1] * (kiLumaLines >> 1)) << 1);
+  int32_t iSize = 0;
+  uint8_t* pBuf = NULL;
+
+  if (kiMbNum > pSlot->iMbDataNum) {
+    WELS_SAFE_FREE (pSlot->pMbDataBuf, "pSlot->pMbDataBuf");
+    pSlot->iMbDataNum = 0;
+
+    iSize = DEC_MT_ALIGN (kiMbNum * sizeof (int8_t))				// pMbType
+            + DEC_MT_ALIGN (kiMbNum * sizeof (int32_t))			// pSliceIdc
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pMv[0]))
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pRefIndex[0]))
+            + DEC_MT_ALIGN (kiMbNum * sizeof (int8_t)) * 2			// pLumaQp, pChromaQp
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pNzc)) * 2		// pNzc, pNzcRs
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pScaledTCoeff))
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pIntraPredMode))
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pIntra4x4FinalMode))
+            + DEC_MT_ALIGN (kiMbNum * sizeof (int8_t)) * 2			// pChromaPredMode, pCbp
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pSubMbType))
+            + DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pMvd[0]))
+            + DEC_MT_ALIGN (kiMbNum * sizeof (uint8_t))			// pCbfDc
+            + DEC_MT_ALIGN (kiMbNum * sizeof (int8_t)) * 2			// pResidualPredFlag, pInterPredictionDoneFlag
+            + DEC_MT_ALIGN (kiMbNum * sizeof (SDecReconSliceInfo));
+    pSlot->pMbDataBuf = (uint8_t*)WelsMalloc (iSize, "pSlot->pMbDataBuf");
+    WELS_VERIFY_RETURN_IF (ERR_INFO_OUT_OF_MEMORY, (NULL == pSlot->pMbDataBuf))
+    pSlot->iMbDataNum = kiMbNum;
+
+    pBuf = pSlot->pMbDataBuf;
+    pDq->pMbType			= (int8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int8_t));
+    pDq->pSliceIdc			= (int32_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int32_t));
+    pDq->pMv[0]				= (int16_t (*)[MB_BLOCK4x4_NUM][MV_A])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pMv[0]));
+    pDq->pRefIndex[0]		= (int8_t (*)[MB_BLOCK4x4_NUM])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pRefIndex[0]));
+    pDq->pLumaQp			= (int8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int8_t));
+    pDq->pChromaQp			= (int8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int8_t));
+    pDq->pNzc				= (int8_t (*)[24])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pNzc));
+    pDq->pNzcRs				= (int8_t (*)[24])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pNzcRs));
+    pDq->pScaledTCoeff		= (int16_t (*)[MB_COEFF_LIST_SIZE])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pScaledTCoeff));
+    pDq->pIntraPredMode		= (int8_t (*)[8])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pIntraPredMode));
+    pDq->pIntra4x4FinalMode	= (int8_t (*)[MB_BLOCK4x4_NUM])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pIntra4x4FinalMode));
+    pDq->pChromaPredMode	= (int8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int8_t));
+    pDq->pCbp				= (int8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int8_t));
+    pDq->pSubMbType			= (int8_t (*)[MB_SUB_PARTITION_SIZE])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pSubMbType));
+    pDq->pMvd[0]			= (uint8_t (*)[MB_BLOCK4x4_NUM][MV_A])pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (*pDq->pMvd[0]));
+    pDq->pCbfDc				= (uint8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (uint8_t));
+    pDq->pResidualPredFlag	= (int8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int8_t));
+    pDq->pInterPredictionDoneFlag = (int8_t*)pBuf;
+    pBuf += DEC_MT_ALIGN (kiMbNum * sizeof (int8_t));
+    pSlot->pSliceInfo		= (SDecReconSliceInfo*)pBuf;
+  }
+
+  if (kiCsSize > pSlot->iCsBufSize) {
+    WELS_SAFE_FREE (pSlot->pCsBuf, "pSlot->pCsBuf");
+    pSlot->iCsBufSize = 0;
+    pSlot->pCsBuf = (uint8_t*)WelsMalloc (kiCsSize, "pSlot->pCsBuf");
+    WELS_VERIFY_RETURN_IF (ERR_INFO_OUT_OF_MEMORY, (NULL == pSlot->pCsBuf))
+    pSlot->iCsBufSize = kiCsSize;
+  }
+  pDq->pCsData[0]	= pSlot->pCsBuf;
+  pDq->pCsData[1]	= pDq->pCsData[0] + pCtx->iCsStride[0] * kiLumaLines;
+  pDq->pCsData[2]	= pDq->pCsData[1] + pCtx->iCsStride[1] * (kiLumaLines >> 1);
+  pDq->iCsStride[0]	= pCtx->iCsStride[0];
+  pDq->iCsStride[1]	= pCtx->iCsStride[1];
+  pDq->iCsStride[2]	= pCtx->iCsStride[2];
+
+  return ERR_NONE;
+}
+
+int32_t WelsInitDecThreadCtx (PWelsDecoderContext pCtx, const int32_t kiThreadNum, const bool kbSliceThreading,
+                              const bool kbSharedPool) {
+  PDecThreadCtx pThreadCtx = NULL;
+  int32_t i = 0;
+
+  WELS_VERIFY_RETURN_IF (ERR_INFO_INVALID_PARAM, (NULL == pCtx || NULL != pCtx->pThreadCtx || kiThreadNum <= 1))
+
+  pThreadCtx = (PDecThreadCtx)WelsMalloc (sizeof (SDecThreadCtx), "pThreadCtx");
+  WELS_VERIFY_RETURN_IF (ERR_INFO_OUT_OF_MEMORY, (NULL == pThreadCtx))
+
+  pThreadCtx->iThreadNum	= WELS_MIN (kiThreadNum, MAX_DEC_THREAD_NUM);
+  pThreadCtx->bSliceThreading	= kbSliceThreading;
+  pThreadCtx->iSlotNum	= pThreadCtx->iThreadNum + 1;
+  if (WELS_THREAD_ERROR_OK != WelsMutexInit (&pThreadCtx->mutexProgress)) {
+    WelsFree (pThreadCtx, "pThreadCtx");
+    return ERR_INFO_OUT_OF_MEMORY;
+  }
+  if (WELS_THREAD_ERROR_OK != WelsEventCreate (&pThreadCtx->pCallerEvent)) {
+    pCtx->pThreadCtx = pThreadCtx;
+    WelsUninitDecThreadCtx (pCtx);
+    return ERR_INFO_OUT_OF_MEMORY;
+  }
+
+  for (i = 0; i < pThreadCtx->iSlotNum; i++) {
+    PDecReconSlot pSlot = &pThreadCtx->sSlots[i];
+    pSlot->pThreadCtx	= pThreadCtx;
+    pSlot->pReconCtx	= (PWelsDecoderContext)WelsMalloc (sizeof (SWelsDecoderContext), "pSlot->pReconCtx");
+    if (NULL == pSlot->pReconCtx || WELS_THREAD_ERROR_OK != WelsEventCreate (&pSlot->pWaitEvent)) {
+      pCtx->pThreadCtx = pThreadCtx;
+      WelsUninitDecThreadCtx (pCtx);
+      return ERR_INFO_OUT_OF_MEMORY;
+    }
+    // function pointers and tables are shared, per job fields are set at submission
+    memcpy (pSlot->pReconCtx, pCtx, sizeof (SWelsDecoderContext));
+    pSlot->pReconCtx->pThreadCtx	= NULL;
+    // references are complete before slice jobs start, no need to wait for rows
+    pSlot->pReconCtx->pReconSlot	= kbSliceThreading ? NULL : pSlot;
+  }
+
+  pCtx->pThreadCtx = pThreadCtx;
+  // a frame job waits for rows of older ones, on a shared pool it could hold a worker other instances need
+  pThreadCtx->bSharedPool	= kbSharedPool && kbSliceThreading;
+  if (kbSharedPool && !kbSliceThreading)
+    WelsLog (pCtx, WELS_LOG_INFO, "frame threading does not run on the shared thread pool, own threads used\n");
+  if (pThreadCtx->bSharedPool)
+    pThreadCtx->bSharedPool	= (WELS_THREAD_ERROR_OK == WelsThreadPoolAttachShared (&pThreadCtx->pThreadPool));
+  if (NULL == pThreadCtx->pThreadPool
+      && WELS_THREAD_ERROR_OK != WelsThreadPoolCreate (&pThreadCtx->pThreadPool, pThreadCtx->iThreadNum)) {
+    WelsUninitDecThreadCtx (pCtx);
+    return ERR_INFO_OUT_OF_MEMORY;
+  }
+
+  WelsLog (pCtx, WELS_LOG_INFO, "%s threading enabled with %d %sthreads\n", kbSliceThreading ? "slice" : "frame",
+           pThreadCtx->pThreadPool->iThreadNum, pThreadCtx->bSharedPool ? "shared " : "");
+  return ERR_NONE;
+}
+
+void WelsUninitDecThreadCtx (PWelsDecoderContext pCtx) {
+  PDecThreadCtx pThreadCtx = NULL;
+  int32_t i = 0;
+
+  if (NULL == pCtx || NULL == pCtx->pThreadCtx)
+    return;
+  pThreadCtx = pCtx->pThreadCtx;
+
+  if (NULL != pThreadCtx->pThreadPool) {
+    WaitAllReconJobs (pThreadCtx);
+    if (pThreadCtx->bSharedPool)
+      WelsThreadPoolDetachShared (pThreadCtx->pThreadPool);
+    else
+      WelsThreadPoolDestroy (pThreadCtx->pThreadPool);
+    pThreadCtx->pThreadPool = NULL;
+  }
+
+  for (i = 0; i < pThreadCtx->iSlotNum; i++) {
+    PDecReconSlot pSlot = &pThreadCtx->sSlots[i];
+    WELS_SAFE_FREE (pSlot->pMbDataBuf, "pSlot->pMbDataBuf");
+    WELS_SAFE_FREE (pSlot->pCsBuf, "pSlot->pCsBuf");
+    WELS_SAFE_FREE (pSlot->pReconCtx, "pSlot->pReconCtx");
+    if (NULL != pSlot->pWaitEvent)
+      WelsEventFree (pSlot->pWaitEvent);
+  }
+  if (NULL != pThreadCtx->pCallerEvent)
+    WelsEventFree (pThreadCtx->pCallerEvent);
+  WelsMutexDestroy (&pThreadCtx->mutexProgress);
+
+  WelsFree (pThreadCtx, "pThreadCtx");
+  pCtx->pThreadCtx = NULL;
+}
+
+int32_t WelsGetDecThreadPicNum (PWelsDecoderContext pCtx) {
+  if (NULL == pCtx->pThreadCtx || pCtx->pThreadCtx->bSliceThreading)
+    return 0;
+  // targets of jobs in flight and pending output, plus the picture last output
+  return pCtx->pThreadCtx->iSlotNum + 1;
+}
+
+void WelsResetDecThreads (PWelsDecoderContext pCtx) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+
+  if (NULL == pThreadCtx)
+    return;
+
+  WaitAllReconJobs (pThreadCtx);
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  if (pThreadCtx->iOutputNum > 0) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "WelsResetDecThreads(), %d decoded frames dropped before output\n",
+             pThreadCtx->iOutputNum);
+  }
+  while (pThreadCtx->iOutputNum > 0)
+    DropOutputPic (pThreadCtx);
+  UnholdPicture (pThreadCtx->pLastOutputPic);
+  pThreadCtx->pLastOutputPic = NULL;
+  if (NULL != pThreadCtx->pParseSlot) {
+    pThreadCtx->pParseSlot->eState = RECON_SLOT_IDLE;
+    pThreadCtx->pParseSlot = NULL;
+  }
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+bool WelsIsFrameThreading (PWelsDecoderContext pCtx) {
+  return NULL != pCtx->pThreadCtx && !pCtx->pThreadCtx->bSliceThreading;
+}
+
+bool WelsIsSliceThreading (PWelsDecoderContext pCtx) {
+  return NULL != pCtx->pThreadCtx && pCtx->pThreadCtx->bSliceThreading;
+}
+
+bool WelsCheckAuForThreading (PWelsDecoderContext pCtx, PAccessUnit pCurAu, const uint8_t kuiTargetDqId) {
+  uint32_t uiIdx = pCurAu->uiStartPos;
+
+  // only single layer with plain slice structure is decoded by jobs
+  for (; uiIdx <= pCurAu->uiEndPos; uiIdx++) {
+    PNalUnit pNal = pCurAu->pNalUnitsList[uiIdx];
+    if (pNal->sNalHeaderExt.uiLayerDqId > kuiTargetDqId)
+      break;
+    if (pNal->sNalHeaderExt.uiLayerDqId != kuiTargetDqId
+        || pNal->sNalData.sVclNal.sSliceHeaderExt.bStoreRefBasePicFlag
+        || pNal->sNalData.sVclNal.sSliceHeaderExt.sSliceHeader.pPps->uiNumSliceGroups > 1)
+      return false;
+  }
+  return pCtx->bAvcBasedFlag;
+}
+
+int32_t WelsPrepareFrameThreadingAu (PWelsDecoderContext pCtx, const bool kbFrameThreading) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  int32_t iRet = ERR_NONE;
+
+  if (pThreadCtx->bSliceThreading)
+    return ERR_NONE;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  // picture queued for output in serial mode can not be continued to decode into
+  if (NULL != pCtx->pDec && pCtx->pDec->uiRefCount > 0)
+    pCtx->pDec = NULL;
+
+  if (kbFrameThreading) {
+    if (NULL == pThreadCtx->pParseSlot) {
+      PDecReconSlot pSlot = NULL;
+      int32_t i = 0;
+
+      if (NULL != pCtx->pDec)
+        pCtx->pDec->iTotalNumMbRec = 0;	// partial picture was parsed into layer of serial mode
+
+      while (NULL == pSlot) {
+        for (i = 0; i < pThreadCtx->iSlotNum; i++) {
+          if (RECON_SLOT_IDLE == pThreadCtx->sSlots[i].eState) {
+            pSlot = &pThreadCtx->sSlots[i];
+            break;
+          }
+        }
+        if (NULL == pSlot)
+          WaitOldestReconJob (pThreadCtx);
+      }
+      pSlot->eState = RECON_SLOT_PARSING;
+      pThreadCtx->pParseSlot = pSlot;
+    }
+  } else {
+    if (NULL != pThreadCtx->pParseSlot) {
+      if (NULL != pCtx->pDec)
+        pCtx->pDec->iTotalNumMbRec = 0;	// partial picture was parsed into recon slot
+      pThreadCtx->pParseSlot->eState = RECON_SLOT_IDLE;
+      pThreadCtx->pParseSlot = NULL;
+    }
+    // references must be complete for serial reconstruction
+    while (WaitOldestReconJob (pThreadCtx));
+  }
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+
+  if (kbFrameThreading) {
+    iRet = RequestReconSlotMem (pCtx, pThreadCtx->pParseSlot);
+    if (ERR_NONE != iRet) {
+      pThreadCtx->pParseSlot->eState = RECON_SLOT_IDLE;
+      pThreadCtx->pParseSlot = NULL;
+      return iRet;
+    }
+    pCtx->pCurDqLayer = &pThreadCtx->pParseSlot->sDqLayer;
+  }
+
+  return ERR_NONE;
+}
+
+PPicture WelsThreadPrefetchPic (PWelsDecoderContext pCtx, const bool kbFrameThreading) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  PPicture pPic = NULL;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  while (NULL == (pPic = PrefetchPic (pCtx->pPicBuff[0]))) {
+    if (WaitOldestReconJob (pThreadCtx))
+      continue;
+    if (0 == pThreadCtx->iOutputNum)
+      break;
+    WelsLog (pCtx, WELS_LOG_WARNING, "WelsThreadPrefetchPic(), decoded frame dropped before output\n");
+    DropOutputPic (pThreadCtx);
+  }
+  if (NULL != pPic) {
+    // pictures of serial mode are complete at the time they can be referenced
+    pPic->iReadyMbRows = kbFrameThreading ? 0 : (pPic->iHeightInPixel >> 4);
+  }
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+
+  return pPic;
+}
+
+void WelsResetParseSlotPicture (PWelsDecoderContext pCtx) {
+  PDqLayer pDq = &pCtx->pThreadCtx->pParseSlot->sDqLayer;
+
+  memset (pDq->pSliceIdc, 0xff, pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight * sizeof (int32_t));
+}
+
+int32_t WelsRecordSliceForRecon (PWelsDecoderContext pCtx) {
+  PDecReconSlot pSlot = pCtx->pThreadCtx->pParseSlot;
+  PDqLayer pCurLayer = pCtx->pCurDqLayer;
+  PSlice pCurSlice = &pCurLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader = &pCurSlice->sSliceHeaderExt.sSliceHeader;
+  SDecReconSliceInfo* pInfo = &pSlot->pSliceInfo[pSliceHeader->iFirstMbInSlice];
+
+  pInfo->eSliceType					= (ESliceType)pCurSlice->eSliceType;
+  pInfo->iDisableDeblockingFilterIdc	= pSliceHeader->uiDisableDeblockingFilterIdc;
+  pInfo->iSliceAlphaC0Offset			= pSliceHeader->iSliceAlphaC0Offset;
+  pInfo->iSliceBetaOffset				= pSliceHeader->iSliceBetaOffset;
+
+  if (0 == pSliceHeader->iFirstMbInSlice) {
+    pCurLayer->pDec->iSpsId = pSliceHeader->iSpsId;
+    pCurLayer->pDec->iPpsId = pSliceHeader->iPpsId;
+
+    pCurLayer->pDec->uiQualityId = pCurLayer->sLayerInfo.sNalHeaderExt.uiQualityId;
+  }
+
+  pCurLayer->pDec->iTotalNumMbRec += pCurSlice->iTotalMbInCurSlice;
+  if (pCurLayer->pDec->iTotalNumMbRec > (int32_t)pSliceHeader->pSps->uiTotalMbCount) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "WelsRecordSliceForRecon():::fdec->iTotalNumMbRec:%d, iTotalMbTargetLayer:%d\n",
+             pCurLayer->pDec->iTotalNumMbRec, pSliceHeader->pSps->uiTotalMbCount);
+    return -1;
+  }
+
+  pCtx->pDec->iWidthInPixel  = pCurLayer->iMbWidth << 4;
+  pCtx->pDec->iHeightInPixel = pCurLayer->iMbHeight << 4;
+
+  return 0;
+}
+
+static int32_t ReconstructMbRow (PDecReconSlot pSlot, const int32_t kiMbY) {
+  PWelsDecoderContext pCtx = pSlot->pReconCtx;
+  PDqLayer pCurDq = &pSlot->sDqLayer;
+  int32_t iRet = 0;
+  int32_t iMbX = 0;
+
+  for (iMbX = 0; iMbX < pCurDq->iMbWidth; iMbX++) {
+    const int32_t kiMbXy = kiMbY * pCurDq->iMbWidth + iMbX;
+    if (pCurDq->pSliceIdc[kiMbXy] < 0)
+      continue;	// MB not available in bitstream
+
+    pCurDq->iMbX		= iMbX;
+    pCurDq->iMbY		= kiMbY;
+    pCurDq->iMbXyIndex	= kiMbXy;
+    if (WelsTargetMbConstruction (pCtx)) {
+      WelsLog (pCtx, WELS_LOG_WARNING, "ReconstructMbRow():::MB(%d, %d) construction error.\n", iMbX, kiMbY);
+      iRet = -1;
+    }
+  }
+  return iRet;
+}
+
+static void DeblockMbRow (PDecReconSlot pSlot, SDeblockingFilter* pFilter, const int32_t kiMbY) {
+  PDqLayer pCurDq = &pSlot->sDqLayer;
+  int32_t iMbX = 0;
+
+  for (iMbX = 0; iMbX < pCurDq->iMbWidth; iMbX++) {
+    const int32_t kiMbXy = kiMbY * pCurDq->iMbWidth + iMbX;
+    const int32_t kiSliceIdc = pCurDq->pSliceIdc[kiMbXy];
+    SDecReconSliceInfo* pInfo = NULL;
+
+    if (kiSliceIdc < 0)
+      continue;
+    pInfo = &pSlot->pSliceInfo[kiSliceIdc >> 7];
+    if ((pInfo->eSliceType != I_SLICE && pInfo->eSliceType != P_SLICE) || 1 == pInfo->iDisableDeblockingFilterIdc)
+      continue;
+
+    pFilter->eSliceType				= pInfo->eSliceType;
+    pFilter->iSliceAlphaC0Offset	= pInfo->iSliceAlphaC0Offset;
+    pFilter->iSliceBetaOffset		= pInfo->iSliceBetaOffset;
+
+    pCurDq->iMbX		= iMbX;
+    pCurDq->iMbY		= kiMbY;
+    pCurDq->iMbXyIndex	= kiMbXy;
+    WelsDeblockingMb (pCurDq, pFilter, DeblockingAvailableNoInterlayer (pCurDq, pInfo->iDisableDeblockingFilterIdc));
+  }
+}
+
+/*
+ *	Rows are finished with a lag, row y is deblocked after row y+1 is reconstructed, as intra prediction of row y+1
+ *	needs unfiltered samples; the border of row y is padded after row y+1 is deblocked.
+ */
+static void ReconJobProc (void* pArg) {
+  PDecReconSlot pSlot = (PDecReconSlot)pArg;
+  PDecThreadCtx pThreadCtx = pSlot->pThreadCtx;
+  PWelsDecoderContext pCtx = pSlot->pReconCtx;
+  PPicture pPic = pSlot->pPic;
+  const int32_t kiMbWidth = pSlot->sDqLayer.iMbWidth;
+  const int32_t kiMbHeight = pSlot->sDqLayer.iMbHeight;
+  SDeblockingFilter sFilter;
+  int32_t iMbY = 0;
+  int32_t iErr = 0;
+  int32_t i = 0;
+
+  memset (&sFilter, 0, sizeof (sFilter));
+  sFilter.pCsData[0]	= pPic->pData[0];
+  sFilter.pCsData[1]	= pPic->pData[1];
+  sFilter.pCsData[2]	= pPic->pData[2];
+  sFilter.iCsStride[0] = pPic->iLinesize[0];
+  sFilter.iCsStride[1] = pPic->iLinesize[1];
+  sFilter.pLoopf		= &pCtx->sDeblockingFunc;
+
+  for (iMbY = 0; iMbY < kiMbHeight; iMbY++) {
+    iErr |= ReconstructMbRow (pSlot, iMbY);
+    if (iMbY > 0)
+      DeblockMbRow (pSlot, &sFilter, iMbY - 1);
+    if (iMbY > 1 && pSlot->bRef) {
+      ExpandReferencingPictureMbRows (pPic, iMbY - 2, iMbY - 1);
+
+      WelsMutexLock (&pThreadCtx->mutexProgress);
+      PublishPicRows (pThreadCtx, pPic, iMbY - 1);
+      WelsMutexUnlock (&pThreadCtx->mutexProgress);
+    }
+    if (iMbY > 1 && NULL != pCtx->pfMbRowsFinished)
+      pCtx->pfMbRowsFinished (pCtx->pMbRowsFinishedArg, pPic, kiMbWidth, kiMbHeight, iMbY - 2, iMbY - 1);
+  }
+  DeblockMbRow (pSlot, &sFilter, kiMbHeight - 1);
+  if (pSlot->bRef)
+    ExpandReferencingPictureMbRows (pPic, WELS_MAX (kiMbHeight - 2, 0), kiMbHeight);
+  if (NULL != pCtx->pfMbRowsFinished)
+    pCtx->pfMbRowsFinished (pCtx->pMbRowsFinishedArg, pPic, kiMbWidth, kiMbHeight, WELS_MAX (kiMbHeight - 2, 0),
+                            kiMbHeight);
+
+  if (iErr) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "ReconJobProc(), frame_num %d reconstructed with errors\n", pPic->iFrameNum);
+  }
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  UnholdPicture (pPic);
+  for (i = 0; i < MAX_REF_PIC_COUNT; i++)
+    UnholdPicture (pCtx->sRefPic.pRefList[LIST_0][i]);
+  pSlot->eState = RECON_SLOT_IDLE;
+  // waiters for the whole picture also wait for the slot, so publish after it is released
+  PublishPicRows (pThreadCtx, pPic, kiMbHeight);
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+void WelsSubmitReconJob (PWelsDecoderContext pCtx, const bool kbRef) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  PDecReconSlot pSlot = pThreadCtx->pParseSlot;
+  PWelsDecoderContext pReconCtx = pSlot->pReconCtx;
+  int32_t i = 0;
+
+  pReconCtx->pDec			= pCtx->pDec;
+  pReconCtx->pCurDqLayer	= &pSlot->sDqLayer;
+  memcpy (pReconCtx->iDecBlockOffsetArray, pCtx->iDecBlockOffsetArray, sizeof (pCtx->iDecBlockOffsetArray));
+  memcpy (pReconCtx->sRefPic.pRefList[LIST_0], pCtx->sRefPic.pRefList[LIST_0], sizeof (pCtx->sRefPic.pRefList[LIST_0]));
+  pReconCtx->sRefPic.uiRefCount[LIST_0] = pCtx->sRefPic.uiRefCount[LIST_0];
+  pReconCtx->pfMbRowsFinished		= pCtx->pfMbRowsFinished;
+  pReconCtx->pMbRowsFinishedArg	= pCtx->pMbRowsFinishedArg;
+  memset (pSlot->iRefRowsReady, 0, sizeof (pSlot->iRefRowsReady));
+
+  pSlot->pPic	= pCtx->pDec;
+  pSlot->bRef	= kbRef;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  HoldPicture (pSlot->pPic);
+  for (i = 0; i < MAX_REF_PIC_COUNT; i++)
+    HoldPicture (pReconCtx->sRefPic.pRefList[LIST_0][i]);
+  pSlot->eState	= RECON_SLOT_BUSY;
+  pSlot->iSeq		= pThreadCtx->iSubmitSeq ++;
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+
+  pThreadCtx->pParseSlot = NULL;
+
+  pSlot->sTask.pProc	= ReconJobProc;
+  pSlot->sTask.pArg	= pSlot;
+  WelsThreadPoolQueueTask (pThreadCtx->pThreadPool, &pSlot->sTask);
+}
+
+/*
+ *	Slice job parses one slice and reconstructs its MBs without deblocking, the decoding thread deblocks it later
+ */
+static int32_t ReconstructSlice (PDecReconSlot pSlot) {
+  PWelsDecoderContext pCtx = pSlot->pReconCtx;
+  PDqLayer pCurDq = &pSlot->sDqLayer;
+  PSlice pCurSlice = &pCurDq->sLayerInfo.sSliceInLayer;
+  int32_t iNextMbXyIndex = pCurSlice->sSliceHeaderExt.sSliceHeader.iFirstMbInSlice;
+  int32_t iCountNumMb = 0;
+
+  for (; iCountNumMb < pCurSlice->iTotalMbInCurSlice; iCountNumMb++, iNextMbXyIndex++) {
+    pCurDq->iMbX		= iNextMbXyIndex % pCurDq->iMbWidth;
+    pCurDq->iMbY		= iNextMbXyIndex / pCurDq->iMbWidth;
+    pCurDq->iMbXyIndex	= iNextMbXyIndex;
+    if (WelsTargetMbConstruction (pCtx)) {
+      WelsLog (pCtx, WELS_LOG_WARNING, "ReconstructSlice():::MB(%d, %d) construction error. pCurSlice_type:%d\n",
+               pCurDq->iMbX, pCurDq->iMbY, pCurSlice->eSliceType);
+      return -1;
+    }
+  }
+  return ERR_NONE;
+}
+
+static void SliceJobProc (void* pArg) {
+  PDecReconSlot pSlot = (PDecReconSlot)pArg;
+  PDecThreadCtx pThreadCtx = pSlot->pThreadCtx;
+  int32_t iRet = WelsDecodeSlice (pSlot->pReconCtx, true, pSlot->pNal);
+
+  if (ERR_NONE == iRet)
+    iRet = ReconstructSlice (pSlot);
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  pSlot->iSliceRet	= iRet;
+  pSlot->eState	= RECON_SLOT_DONE;
+  if (pThreadCtx->bSliceWaiting) {
+    pThreadCtx->bSliceWaiting = false;
+    WelsEventSignal (pThreadCtx->pCallerEvent);
+  }
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+/* collect the oldest slice job and deblock it, row progress of the picture is recorded to pCtx */
+static void RetireSliceJob (PWelsDecoderContext pCtx) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  PDecReconSlot pSlot = &pThreadCtx->sSlots[pThreadCtx->iRetireSeq % pThreadCtx->iSlotNum];
+  PWelsDecoderContext pSliceCtx = pSlot->pReconCtx;
+  PDqLayer pSliceDq = &pSlot->sDqLayer;
+  PSlice pSlice = &pSliceDq->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader = &pSlice->sSliceHeaderExt.sSliceHeader;
+  PPicture pDec = pSliceDq->pDec;
+  int32_t iRet = ERR_NONE;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  WaitSliceJobDone (pThreadCtx, pSlot);
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+
+  pCtx->iErrorCode |= pSliceCtx->iErrorCode;
+  iRet = pSlot->iSliceRet;
+  if (ERR_NONE == iRet) {
+    if (0 == pSliceHeader->iFirstMbInSlice) {
+      pDec->iSpsId = pSliceHeader->iSpsId;
+      pDec->iPpsId = pSliceHeader->iPpsId;
+
+      pDec->uiQualityId = pSliceDq->sLayerInfo.sNalHeaderExt.uiQualityId;
+    }
+
+    pDec->iTotalNumMbRec += pSlice->iTotalMbInCurSlice;
+    if (pDec->iTotalNumMbRec > (int32_t)pSliceHeader->pSps->uiTotalMbCount) {
+      WelsLog (pCtx, WELS_LOG_WARNING, "RetireSliceJob():::fdec->iTotalNumMbRec:%d, iTotalMbTargetLayer:%d\n",
+               pDec->iTotalNumMbRec, pSliceHeader->pSps->uiTotalMbCount);
+      iRet = -1;
+    } else {
+      SDeblockingSliceRows sRows;
+
+      pDec->iWidthInPixel  = pSliceDq->iMbWidth << 4;
+      pDec->iHeightInPixel = pSliceDq->iMbHeight << 4;
+
+      // later slices never touch samples of this one, so it is filtered while they are still reconstructed
+      WelsDeblockingInitSliceRows (pSliceCtx, &sRows);
+      WelsDeblockingFilterSliceRows (pCtx, pSliceDq, &sRows, sRows.iMbEnd, true);
+    }
+  } else {
+    WelsLog (pCtx, WELS_LOG_WARNING, "RetireSliceJob() slice job failed (%d) in frame: %d first MB: %d\n", iRet,
+             pSliceHeader->iFrameNum, pSliceHeader->iFirstMbInSlice);
+  }
+
+  if (ERR_NONE != iRet && ERR_NONE == pThreadCtx->iSliceErr)
+    pThreadCtx->iSliceErr = iRet;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  pSlot->eState = RECON_SLOT_IDLE;
+  ++ pThreadCtx->iRetireSeq;
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+void WelsQueueSliceJob (PWelsDecoderContext pCtx, PNalUnit pNalCur) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  PDecReconSlot pSlot = NULL;
+  PWelsDecoderContext pSliceCtx = NULL;
+
+  if (pThreadCtx->iSubmitSeq - pThreadCtx->iRetireSeq == pThreadCtx->iSlotNum)
+    RetireSliceJob (pCtx);
+
+  pSlot = &pThreadCtx->sSlots[pThreadCtx->iSubmitSeq % pThreadCtx->iSlotNum];
+  pSliceCtx = pSlot->pReconCtx;
+
+  // private DQ layer shares MB arrays of current layer, slices never overlap
+  memcpy (&pSlot->sDqLayer, pCtx->pCurDqLayer, sizeof (SDqLayer));
+  pSliceCtx->pCurDqLayer	= &pSlot->sDqLayer;
+  pSliceCtx->pDec			= pCtx->pDec;
+  pSliceCtx->pFmo			= pCtx->pFmo;
+  pSliceCtx->pSliceHeader	= pCtx->pSliceHeader;
+  pSliceCtx->eSliceType	= pCtx->eSliceType;
+  pSliceCtx->bAvcBasedFlag	= pCtx->bAvcBasedFlag;
+  pSliceCtx->iCurSeqIntervalMaxPicWidth = pCtx->iCurSeqIntervalMaxPicWidth;
+  pSliceCtx->iErrorCode	= dsErrorFree;
+  memcpy (&pSliceCtx->sRefPic, &pCtx->sRefPic, sizeof (SRefPic));
+  memcpy (pSliceCtx->iDecBlockOffsetArray, pCtx->iDecBlockOffsetArray, sizeof (pCtx->iDecBlockOffsetArray));
+
+  pSlot->pNal			= pNalCur;
+  pSlot->iSliceRet	= ERR_NONE;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  pSlot->eState	= RECON_SLOT_BUSY;
+  pSlot->iSeq		= pThreadCtx->iSubmitSeq ++;
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+
+  pSlot->sTask.pProc	= SliceJobProc;
+  pSlot->sTask.pArg	= pSlot;
+  WelsThreadPoolQueueTask (pThreadCtx->pThreadPool, &pSlot->sTask);
+}
+
+int32_t WelsFinishSliceJobs (PWelsDecoderContext pCtx) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  int32_t iRet = ERR_NONE;
+
+  while (pThreadCtx->iRetireSeq < pThreadCtx->iSubmitSeq)
+    RetireSliceJob (pCtx);
+
+  iRet = pThreadCtx->iSliceErr;
+  pThreadCtx->iSliceErr = ERR_NONE;
+  return iRet;
+}
+
+void WelsWaitSliceJobs (PWelsDecoderContext pCtx) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+
+  if (NULL == pThreadCtx || !pThreadCtx->bSliceThreading)
+    return;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  DropSliceJobs (pThreadCtx);
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+void WelsQueueOutputPic (PWelsDecoderContext pCtx, PPicture pPic, const int32_t kiWidth, const int32_t kiHeight) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  SDecOutputPic* pOutput = NULL;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  if (MAX_DEC_OUTPUT_PIC_NUM == pThreadCtx->iOutputNum) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "WelsQueueOutputPic(), decoded frame dropped before output\n");
+    DropOutputPic (pThreadCtx);
+  }
+  pOutput = &pThreadCtx->sOutputPics[(pThreadCtx->iOutputHead + pThreadCtx->iOutputNum) % MAX_DEC_OUTPUT_PIC_NUM];
+  pOutput->pPic		= pPic;
+  pOutput->iWidth		= kiWidth;
+  pOutput->iHeight	= kiHeight;
+  memcpy (&pOutput->sFrameCrop, &pCtx->sFrameCrop, sizeof (SPosOffset));
+  HoldPicture (pPic);
+  ++ pThreadCtx->iOutputNum;
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+/*
+ *	The oldest picture is output once reconstructed. It is waited for at end of stream, or when more pictures are
+ *	pending than there are threads so that latency stays bounded.
+ */
+void WelsFetchOutputPic (PWelsDecoderContext pCtx, uint8_t** ppDst, SBufferInfo* pDstInfo) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+  SDecOutputPic sOutput;
+  bool bReady = false;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  if (pThreadCtx->iOutputNum > 0) {
+    memcpy (&sOutput, &pThreadCtx->sOutputPics[pThreadCtx->iOutputHead], sizeof (SDecOutputPic));
+    bReady = sOutput.pPic->iReadyMbRows >= (sOutput.iHeight >> 4);
+    if (!bReady && (pCtx->bEndOfStreamFlag || pThreadCtx->iOutputNum > pThreadCtx->iThreadNum)) {
+      WaitPicRows (pThreadCtx, sOutput.pPic, sOutput.iHeight >> 4, pThreadCtx->pCallerEvent);
+      bReady = true;
+    }
+    if (bReady) {
+      // the hold moves to pLastOutputPic
+      pThreadCtx->iOutputHead = (pThreadCtx->iOutputHead + 1) % MAX_DEC_OUTPUT_PIC_NUM;
+      -- pThreadCtx->iOutputNum;
+      UnholdPicture (pThreadCtx->pLastOutputPic);
+      pThreadCtx->pLastOutputPic = sOutput.pPic;
+    }
+  }
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+
+  if (!bReady)
+    return;
+
+  pDstInfo->UsrData.sSystemBuffer.iFormat = videoFormatI420;
+  pDstInfo->UsrData.sSystemBuffer.iWidth = sOutput.iWidth - (sOutput.sFrameCrop.iLeftOffset +
+      sOutput.sFrameCrop.iRightOffset) * 2;
+  pDstInfo->UsrData.sSystemBuffer.iHeight = sOutput.iHeight - (sOutput.sFrameCrop.iTopOffset +
+      sOutput.sFrameCrop.iBottomOffset) * 2;
+  pDstInfo->UsrData.sSystemBuffer.iStride[0] = sOutput.pPic->iLinesize[0];
+  pDstInfo->UsrData.sSystemBuffer.iStride[1] = sOutput.pPic->iLinesize[1];
+  ppDst[0] = sOutput.pPic->pData[0] + sOutput.sFrameCrop.iTopOffset * 2 * sOutput.pPic->iLinesize[0] +
+             sOutput.sFrameCrop.iLeftOffset * 2;
+  ppDst[1] = sOutput.pPic->pData[1] + sOutput.sFrameCrop.iTopOffset * sOutput.pPic->iLinesize[1] +
+             sOutput.sFrameCrop.iLeftOffset;
+  ppDst[2] = sOutput.pPic->pData[2] + sOutput.sFrameCrop.iTopOffset * sOutput.pPic->iLinesize[1] +
+             sOutput.sFrameCrop.iLeftOffset;
+  pDstInfo->pFrameOpaque = sOutput.pPic->sExtBuffer.pOpaque;
+  pDstInfo->iBufferStatus = 1;
+}
+
+void WelsReleaseOutputPic (PWelsDecoderContext pCtx) {
+  PDecThreadCtx pThreadCtx = pCtx->pThreadCtx;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  UnholdPicture (pThreadCtx->pLastOutputPic);
+  pThreadCtx->pLastOutputPic = NULL;
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+void WelsWaitRefPicLines (PDecReconSlot pSlot, PPicture pRefPic, const int32_t kiRefIdx, const int32_t kiBottomLine) {
+  PDecThreadCtx pThreadCtx = pSlot->pThreadCtx;
+  const int32_t kiRows = (kiBottomLine >= pRefPic->iHeightInPixel) ? (pRefPic->iHeightInPixel >> 4) :
+                         ((WELS_MAX (kiBottomLine, 0) >> 4) + 1);
+
+  if (pSlot->iRefRowsReady[kiRefIdx] >= kiRows)
+    return;
+
+  WelsMutexLock (&pThreadCtx->mutexProgress);
+  WaitPicRows (pThreadCtx, pRefPic, kiRows, pSlot->pWaitEvent);
+  pSlot->iRefRowsReady[kiRefIdx] = pRefPic->iReadyMbRows;
+  WelsMutexUnlock (&pThreadCtx->mutexProgress);
+}
+
+int32_t WelsInitDeblockThread (PWelsDecoderContext pCtx) {
+  PDecDeblockThread pThread = NULL;
+
+  WELS_VERIFY_RETURN_IF (ERR_INFO_INVALID_PARAM, (NULL == pCtx || NULL != pCtx->pDeblockThread))
+
+  pThread = (PDecDeblockThread)WelsMalloc (sizeof (SDecDeblockThread), "pDeblockThread");
+  WELS_VERIFY_RETURN_IF (ERR_INFO_OUT_OF_MEMORY, (NULL == pThread))
+
+  if (WELS_THREAD_ERROR_OK != WelsThreadPoolCreate (&pThread->pThreadPool, 1)) {
+    WelsFree (pThread, "pDeblockThread");
+    return ERR_INFO_OUT_OF_MEMORY;
+  }
+  if (WELS_THREAD_ERROR_OK != WelsThreadTaskGroupInit (&pThread->sTaskGroup)) {
+    WelsThreadPoolDestroy (pThread->pThreadPool);
+    WelsFree (pThread, "pDeblockThread");
+    return ERR_INFO_OUT_OF_MEMORY;
+  }
+  if (WELS_THREAD_ERROR_OK != WelsEventCreate (&pThread->pJobEvent)) {
+    WelsThreadTaskGroupDestroy (&pThread->sTaskGroup);
+    WelsThreadPoolDestroy (pThread->pThreadPool);
+    WelsFree (pThread, "pDeblockThread");
+    return ERR_INFO_OUT_OF_MEMORY;
+  }
+  WelsMutexInit (&pThread->mutexProgress);
+  pThread->pCtx = pCtx;
+
+  pCtx->pDeblockThread = pThread;
+  WelsLog (pCtx, WELS_LOG_INFO, "deblocking helper thread enabled\n");
+  return ERR_NONE;
+}
+
+void WelsUninitDeblockThread (PWelsDecoderContext pCtx) {
+  PDecDeblockThread pThread = NULL;
+
+  if (NULL == pCtx || NULL == pCtx->pDeblockThread)
+    return;
+  pThread = pCtx->pDeblockThread;
+
+  WelsWaitDeblockThread (pCtx);
+  WelsThreadPoolDestroy (pThread->pThreadPool);
+  WelsThreadTaskGroupDestroy (&pThread->sTaskGroup);
+  WelsEventFree (pThread->pJobEvent);
+  WelsMutexDestroy (&pThread->mutexProgress);
+
+  WelsFree (pThread, "pDeblockThread");
+  pCtx->pDeblockThread = NULL;
+}
+
+static void DeblockJobProc (void* pArg) {
+  PDecDeblockThread pThread = (PDecDeblockThread)pArg;
+  int32_t iMbRecEnd = pThread->sRows.iMbNext;
+  bool bSliceEnd = false;
+  bool bStop = false;
+
+  do {
+    WelsMutexLock (&pThread->mutexProgress);
+    while (pThread->iMbRecEnd == iMbRecEnd && !pThread->bSliceEnd && !pThread->bStop) {
+      pThread->bJobWaiting = true;
+      WelsMutexUnlock (&pThread->mutexProgress);
+      WelsEventWait (pThread->pJobEvent);
+      WelsMutexLock (&pThread->mutexProgress);
+    }
+    iMbRecEnd	= pThread->iMbRecEnd;
+    bSliceEnd	= pThread->bSliceEnd;
+    bStop		= pThread->bStop;
+    WelsMutexUnlock (&pThread->mutexProgress);
+
+    WelsDeblockingFilterSliceRows (pThread->pCtx, &pThread->sDqLayer, &pThread->sRows, iMbRecEnd, bSliceEnd);
+  } while (!bSliceEnd && !bStop);
+}
+
+void WelsStartDeblockSlice (PWelsDecoderContext pCtx, PDeblockingSliceRows pRows) {
+  PDecDeblockThread pThread = pCtx->pDeblockThread;
+
+  WelsWaitDeblockThread (pCtx);
+
+  memcpy (&pThread->sDqLayer, pCtx->pCurDqLayer, sizeof (SDqLayer));
+  memcpy (&pThread->sRows, pRows, sizeof (SDeblockingSliceRows));
+  pThread->bJobWaiting	= false;
+  pThread->iMbRecEnd		= pRows->iMbNext;
+  pThread->bSliceEnd		= false;
+  pThread->bStop			= false;
+  pThread->bBusy			= true;
+
+  pThread->sTask.pProc	= DeblockJobProc;
+  pThread->sTask.pArg		= pThread;
+  pThread->sTask.pGroup	= &pThread->sTaskGroup;
+  WelsThreadPoolQueueTask (pThread->pThreadPool, &pThread->sTask);
+}
+
+static void PostDeblockProgress (PDecDeblockThread pThread, const int32_t kiMbRecEnd, const bool kbSliceEnd,
+                                 const bool kbStop) {
+  WelsMutexLock (&pThread->mutexProgress);
+  pThread->iMbRecEnd	= kiMbRecEnd;
+  pThread->bSliceEnd	= kbSliceEnd;
+  pThread->bStop		= kbStop;
+  if (pThread->bJobWaiting) {
+    pThread->bJobWaiting = false;
+    WelsEventSignal (pThread->pJobEvent);
+  }
+  WelsMutexUnlock (&pThread->mutexProgress);
+}
+
+void WelsUpdateDeblockSlice (PWelsDecoderContext pCtx, const int32_t kiMbRecEnd, const bool kbSliceEnd) {
+  PostDeblockProgress (pCtx->pDeblockThread, kiMbRecEnd, kbSliceEnd, false);
+}
+
+void WelsWaitDeblockThread (PWelsDecoderContext pCtx) {
+  PDecDeblockThread pThread = pCtx->pDeblockThread;
+
+  if (NULL == pThread || !pThread->bBusy)
+    return;
+
+  // progress is written by the decoding thread only, so it is read here without the mutex
+  PostDeblockProgress (pThread, pThread->iMbRecEnd, pThread->bSliceEnd, true);
+  WelsThreadPoolWaitGroup (pThread->pThreadPool, &pThread->sTaskGroup);
+  pThread->bBusy = false;
+}
+
+#endif//MT_ENABLED
+
+} // namespace WelsDec
@@ -42,8 +42,10 @@
 #include "deblocking.h"
 
 #include "decode_slice.h"
+#include "dec_multi_threading.h"
 
 #include "parse_mb_syn_cavlc.h"
+#include "parse_mb_syn_cabac.h"
 #include "rec_mb.h"
 #include "mv_pred.h"
 
@@ -69,6 +71,12 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
   int32_t iTotalNumMb = pCurSlice->iTotalMbInCurSlice;
   int32_t iCountNumMb = 0;
   PDeblockingFilterMbFunc pDeblockMb;
+  // slices in raster order are filtered one MB row behind reconstruction
+  const bool kbRowDeblocking = (pSliceHeader->pPps->uiNumSliceGroups <= 1);
+  SDeblockingSliceRows sRows;
+#if defined(MT_ENABLED)
+  bool bDeblockThread = false;
+#endif//MT_ENABLED
 
   if (!pCtx->bAvcBasedFlag && iCurLayerWidth != pCtx->iCurSeqIntervalMaxPicWidth) {
     return -1;
@@ -86,6 +94,15 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
     pCurLayer->pDec->uiQualityId = pCurLayer->sLayerInfo.sNalHeaderExt.uiQualityId;
   }
 
+  if (kbRowDeblocking) {
+    WelsDeblockingInitSliceRows (pCtx, &sRows);
+#if defined(MT_ENABLED)
+    bDeblockThread = (NULL != pCtx->pDeblockThread);
+    if (bDeblockThread)
+      WelsStartDeblockSlice (pCtx, &sRows);
+#endif//MT_ENABLED
+  }
+
   do {
     iPreQP = pCurLayer->pLumaQp[pCurLayer->iMbXyIndex];
 
@@ -98,6 +115,14 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
 
     ++iCountNumMb;
     ++pCurLayer->pDec->iTotalNumMbRec;
+    if (kbRowDeblocking && pCurLayer->iMbX == pCurLayer->iMbWidth - 1 && iCountNumMb < iTotalNumMb) {
+#if defined(MT_ENABLED)
+      if (bDeblockThread)
+        WelsUpdateDeblockSlice (pCtx, pCurLayer->iMbXyIndex + 1, false);
+      else
+#endif//MT_ENABLED
+        WelsDeblockingFilterSliceRows (pCtx, pCurLayer, &sRows, pCurLayer->iMbXyIndex + 1, false);
+    }
     if (iCountNumMb >= iTotalNumMb) {
       break;
     }
@@ -124,18 +149,25 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
   pCtx->pDec->iWidthInPixel  = iCurLayerWidth;
   pCtx->pDec->iHeightInPixel = iCurLayerHeight;
 
-  if ((pCurSlice->eSliceType != I_SLICE) && (pCurSlice->eSliceType != P_SLICE))
+  if (kbRowDeblocking) {
+#if defined(MT_ENABLED)
+    if (bDeblockThread)
+      WelsUpdateDeblockSlice (pCtx, sRows.iMbEnd, true);
+    else
+#endif//MT_ENABLED
+      WelsDeblockingFilterSliceRows (pCtx, pCurLayer, &sRows, sRows.iMbEnd, true);
     return 0;
+  }
 
-  pDeblockMb = WelsDeblockingMb;
-
-  if (1 == pSliceHeader->uiDisableDeblockingFilterIdc) {
-    return 0;//NO_SUPPORTED_FILTER_IDX
-  } else {
-    WelsDeblockingFilterSlice (pCtx, pDeblockMb);
+  if ((pCurSlice->eSliceType == I_SLICE) || (pCurSlice->eSliceType == P_SLICE)) {
+    pDeblockMb = WelsDeblockingMb;
 
+    if (1 != pSliceHeader->uiDisableDeblockingFilterIdc) {
+      WelsDeblockingFilterSlice (pCtx, pDeblockMb);
+    }
+    // any other filter_idc not supported here, 7/22/2010
   }
-  // any other filter_idc not supported here, 7/22/2010
+  WelsDeblockingMbsDone (pCtx, pCurLayer, pCtx->pDec, -1, iCountNumMb);
 
   return 0;
 }
@@ -365,14 +397,23 @@ int32_t WelsDecodeSlice (PWelsDecoderContext pCtx, bool bFirstSliceInLayer, PNal
   PBitStringAux pBs = pCurLayer->pBitStringAux;
   int32_t iUsedBits  = 0;
 
-  PWelsDecMbCavlcFunc pDecMbCavlcFunc;
+  const bool kbCabac = pCurLayer->sLayerInfo.pPps->bEntropyCodingModeFlag;
+  uint32_t uiEndOfSlice;
+
+  PWelsDecMbFunc pDecMbFunc;
 
   pSlice->iTotalMbInCurSlice = 0; //initialize at the starting of slice decoding.
 
-  if (P_SLICE == pSliceHeader->eSliceType) {
-    pDecMbCavlcFunc = WelsDecodeMbCavlcPSlice;
+  if (kbCabac) {
+    if (P_SLICE == pSliceHeader->eSliceType) {
+      pDecMbFunc = WelsDecodeMbCabacPSlice;
+    } else { //I_SLICE
+      pDecMbFunc = WelsDecodeMbCabacISlice;
+    }
+  } else if (P_SLICE == pSliceHeader->eSliceType) {
+    pDecMbFunc = WelsDecodeMbCavlcPSlice;
   } else { //I_SLICE
-    pDecMbCavlcFunc = WelsDecodeMbCavlcISlice;
+    pDecMbFunc = WelsDecodeMbCavlcISlice;
   }
 
   if (pSliceHeader->pPps->bConstainedIntraPredFlag) {
@@ -387,11 +428,6 @@ int32_t WelsDecodeSlice (PWelsDecoderContext pCtx, bool bFirstSliceInLayer, PNal
 
   pCtx->eSliceType = pSliceHeader->eSliceType;
 
-  if (pCurLayer->sLayerInfo.pPps->bEntropyCodingModeFlag == 1) {
-    //CABAC encoding is unsupported yet!
-    return -1;
-  }
-
   iNextMbXyIndex = pSliceHeader->iFirstMbInSlice;
 
   if ((iNextMbXyIndex < 0) || (iNextMbXyIndex >= kiCountNumMb)) {
@@ -434,9 +470,16 @@ int32_t WelsDecodeSlice (PWelsDecoderContext pCtx, bool bFirstSliceInLayer, PNal
     return 0;
   }
 
+  if (kbCabac) {
+    iRet = InitCabacSliceDec (pCtx, pBs);
+    if (iRet != ERR_NONE) {
+      return iRet;
+    }
+  }
+
   do {
     pCurLayer->pSliceIdc[iNextMbXyIndex] = iSliceIdc;
-    iRet = pDecMbCavlcFunc (pCtx,  pNalCur);
+    iRet = pDecMbFunc (pCtx,  pNalCur);
 
     if (iRet != ERR_NONE) {
       return iRet;
@@ -444,6 +487,13 @@ int32_t WelsDecodeSlice (PWelsDecoderContext pCtx, bool bFirstSliceInLayer, PNal
 
     ++pSlice->iTotalMbInCurSlice;
 
+    if (kbCabac) {
+      WELS_READ_VERIFY (ParseEndOfSliceCabac (pCtx, uiEndOfSlice)); //end_of_slice_flag
+      if (uiEndOfSlice) {
+        break;
+      }
+    }
+
     if (pSliceHeader->pPps->uiNumSliceGroups > 1) {
       iNextMbXyIndex = FmoNextMb (pFmo, iNextMbXyIndex);
     } else {
@@ -453,16 +503,18 @@ int32_t WelsDecodeSlice (PWelsDecoderContext pCtx, bool bFirstSliceInLayer, PNal
       break;
     }
 
-    // check whether there is left bits to read next time in case multiple slices
-    iUsedBits = ((pBs->pCurBuf - pBs->pStartBuf) << 3) - (16 - pBs->iLeftBits);
-    if (iUsedBits == pBs->iBits && 0 >= pCurLayer->sLayerInfo.sSliceInLayer.iMbSkipRun) {	// slice boundary
-      break;
-    }
-    if (iUsedBits > pBs->iBits) { //When BS incomplete, as long as find it, SHOULD stop decoding to avoid mosaic or crash.
-      WelsLog (pCtx, WELS_LOG_WARNING,
-               "WelsDecodeSlice()::::pBs incomplete, iUsedBits:%d > pBs->iBits:%d, MUST stop decoding.\n",
-               iUsedBits, pBs->iBits);
-      return -1;
+    // check whether there is left bits to read next time in case multiple slices, cabac slices end with end_of_slice_flag
+    if (!kbCabac) {
+      iUsedBits = ((pBs->pCurBuf - pBs->pStartBuf) << 3) - (16 - pBs->iLeftBits);
+      if (iUsedBits == pBs->iBits && 0 >= pCurLayer->sLayerInfo.sSliceInLayer.iMbSkipRun) {	// slice boundary
+        break;
+      }
+      if (iUsedBits > pBs->iBits) { //When BS incomplete, as long as find it, SHOULD stop decoding to avoid mosaic or crash.
+        WelsLog (pCtx, WELS_LOG_WARNING,
+                 "WelsDecodeSlice()::::pBs incomplete, iUsedBits:%d > pBs->iBits:%d, MUST stop decoding.\n",
+                 iUsedBits, pBs->iBits);
+        return -1;
+      }
     }
     iMbX = iNextMbXyIndex % pCurLayer->iMbWidth;
     iMbY = iNextMbXyIndex / pCurLayer->iMbWidth;
@@ -1127,6 +1179,345 @@ int32_t WelsDecodeMbCavlcPSlice (PWelsDecoderContext pCtx, PNalUnit pNalCur) {
   return 0;
 }
 
+/*
+ *	I_PCM MB of cabac slice, samples start at the byte following the bits consumed by the engine,
+ *	which is initialized again after them
+ */
+static int32_t WelsDecodeMbCabacPcm (PWelsDecoderContext pCtx) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  PDqLayer pCurLayer = pCtx->pCurDqLayer;
+  PSlice pSlice      = &pCurLayer->sLayerInfo.sSliceInLayer;
+  int32_t iMbX = pCurLayer->iMbX;
+  int32_t iMbY = pCurLayer->iMbY;
+  int32_t iMbXy = pCurLayer->iMbXyIndex;
+  int32_t iDecStrideL = pCurLayer->pDec->iLinesize[0];
+  int32_t iDecStrideC = pCurLayer->pDec->iLinesize[1];
+
+  int32_t iOffsetL = (iMbX + iMbY * iDecStrideL) << 4;
+  int32_t iOffsetC = (iMbX + iMbY * iDecStrideC) << 3;
+
+  uint8_t* pDecY = pCurLayer->pCsData[0] + iOffsetL;
+  uint8_t* pDecU = pCurLayer->pCsData[1] + iOffsetC;
+  uint8_t* pDecV = pCurLayer->pCsData[2] + iOffsetC;
+
+  const uint8_t* pTmpBsBuf = WelsCabacDecBytePos (pEngine);
+  const uint8_t* kpPcmEnd  = pTmpBsBuf + 384;
+  int32_t i;
+
+  if (kpPcmEnd > pEngine->pBuffEnd) {
+    return ERR_INFO_READ_OVERFLOW;
+  }
+
+  pCurLayer->pMbType[iMbXy] = MB_TYPE_INTRA_PCM;
+
+  for (i = 0; i < 16; i++) { //luma
+    memcpy (pDecY, pTmpBsBuf, 16);
+    pDecY += iDecStrideL;
+    pTmpBsBuf += 16;
+  }
+  for (i = 0; i < 8; i++) { //cb
+    memcpy (pDecU, pTmpBsBuf, 8);
+    pDecU += iDecStrideC;
+    pTmpBsBuf += 8;
+  }
+  for (i = 0; i < 8; i++) { //cr
+    memcpy (pDecV, pTmpBsBuf, 8);
+    pDecV += iDecStrideC;
+    pTmpBsBuf += 8;
+  }
+
+  //update QP, cbp and pNonZeroCount, all blocks are taken as coded by the contexts of neighbours
+  pCurLayer->pLumaQp[iMbXy] = 0;
+  pCurLayer->pChromaQp[iMbXy] = 0;
+  pCurLayer->pCbp[iMbXy] = 0x2f;
+  pCurLayer->pCbfDc[iMbXy] = CBF_DC_LUMA | CBF_DC_CB | CBF_DC_CR;
+  memset (pCurLayer->pNzc[iMbXy], 16, sizeof (pCurLayer->pNzc[iMbXy]));
+  memset (pCurLayer->pMvd[LIST_0][iMbXy], 0, sizeof (pCurLayer->pMvd[LIST_0][iMbXy]));
+  pSlice->iLastDeltaQp = 0;
+
+  return WelsCabacDecEngineInit (pEngine, kpPcmEnd, pEngine->pBuffEnd);
+}
+
+/*
+ *	prediction modes and cbp of I4x4 and I16x16 MBs, uiMbType numbered as in I slice
+ */
+static int32_t WelsDecodeMbCabacIntraInfo (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint8_t* pNonZeroCount,
+    uint32_t uiMbType) {
+  PDqLayer pCurLayer = pCtx->pCurDqLayer;
+  int32_t iMbXy = pCurLayer->iMbXyIndex;
+  uint32_t uiCbp;
+
+  memset (pCurLayer->pMvd[LIST_0][iMbXy], 0, sizeof (pCurLayer->pMvd[LIST_0][iMbXy]));
+  if (0 == uiMbType) {
+    ENFORCE_STACK_ALIGN_1D (int8_t, pIntraPredMode, 48, 16);
+    pCurLayer->pMbType[iMbXy] = MB_TYPE_INTRA4x4;
+    pCtx->pFillInfoCacheIntra4x4Func (pNeighAvail, pNonZeroCount, pIntraPredMode, pCurLayer);
+    WELS_READ_VERIFY (ParseIntra4x4ModeCabac (pCtx, pNeighAvail, pIntraPredMode));
+    WELS_READ_VERIFY (ParseCbpInfoCabac (pCtx, pNeighAvail, uiCbp));
+    pCurLayer->pCbp[iMbXy] = uiCbp;
+  } else {
+    pCurLayer->pMbType[iMbXy] = MB_TYPE_INTRA16x16;
+    pCurLayer->pIntraPredMode[iMbXy][7] = (uiMbType - 1) & 3;
+    pCurLayer->pCbp[iMbXy] = g_kuiI16CbpTable[ (uiMbType - 1) >> 2];
+    WelsFillCacheNonZeroCount (pNeighAvail, pNonZeroCount, pCurLayer);
+    WELS_READ_VERIFY (ParseIntra16x16ModeCabac (pCtx, pNeighAvail));
+  }
+  return ERR_NONE;
+}
+
+/*
+ *	mb_qp_delta and residual of MB, with cbp and MB type parsed and the count cache filled
+ */
+static int32_t WelsDecodeMbCabacResidual (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint8_t* pNonZeroCount) {
+  PDqLayer pCurLayer		 = pCtx->pCurDqLayer;
+  PSlice pSlice			 = &pCurLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader		     = &pSlice->sSliceHeaderExt.sSliceHeader;
+
+  int32_t iScanIdxStart = pSlice->sSliceHeaderExt.uiScanIdxStart;
+  int32_t iScanIdxEnd   = pSlice->sSliceHeaderExt.uiScanIdxEnd;
+
+  int32_t iMbXy = pCurLayer->iMbXyIndex;
+  uint32_t uiCbpL = pCurLayer->pCbp[iMbXy] & 15;
+  uint32_t uiCbpC = pCurLayer->pCbp[iMbXy] >> 4;
+  int32_t iQpDelta, iId8x8, iId4x4, i;
+
+  pCtx->sBlockFunc.pWelsBlockZero16x16Func (pCurLayer->pScaledTCoeff[iMbXy], 16);
+  pCtx->sBlockFunc.pWelsBlockZero8x8Func (pCurLayer->pScaledTCoeff[iMbXy] + 256, 8);
+  pCtx->sBlockFunc.pWelsBlockZero8x8Func (pCurLayer->pScaledTCoeff[iMbXy] + 256 + 64, 8);
+
+  ST32 (&pCurLayer->pNzc[iMbXy][0], 0);
+  ST32 (&pCurLayer->pNzc[iMbXy][4], 0);
+  ST32 (&pCurLayer->pNzc[iMbXy][8], 0);
+  ST32 (&pCurLayer->pNzc[iMbXy][12], 0);
+  ST32 (&pCurLayer->pNzc[iMbXy][16], 0);
+  ST32 (&pCurLayer->pNzc[iMbXy][20], 0);
+  pCurLayer->pCbfDc[iMbXy] = 0;
+
+  if (pCurLayer->pCbp[iMbXy] == 0 && !IS_INTRA16x16 (pCurLayer->pMbType[iMbXy])) {
+    pCurLayer->pLumaQp[iMbXy] = pSlice->iLastMbQp;
+    pCurLayer->pChromaQp[iMbXy] = g_kuiChromaQp[WELS_CLIP3 (pCurLayer->pLumaQp[iMbXy] +
+                                  pSliceHeader->pPps->iChromaQpIndexOffset, 0, 51)];
+    pSlice->iLastDeltaQp = 0;
+    return ERR_NONE;
+  }
+
+  WELS_READ_VERIFY (ParseDeltaQpCabac (pCtx, iQpDelta)); //mb_qp_delta
+  if (iQpDelta > 25 || iQpDelta < -26) { //out of iQpDelta range
+    return ERR_INFO_INVALID_QP;
+  }
+
+  pCurLayer->pLumaQp[iMbXy] = pSlice->iLastMbQp + iQpDelta; //update iLastMbQp
+  //refer to JVT-X201wcm1.doc equation(7-35)
+  if ((unsigned) (pCurLayer->pLumaQp[iMbXy]) > 51) {
+    if (pCurLayer->pLumaQp[iMbXy] < 0) {
+      pCurLayer->pLumaQp[iMbXy] += 52;
+    } else {
+      pCurLayer->pLumaQp[iMbXy] -= 52;
+    }
+  }
+  //QP should be in the range of [0, 51]
+  if (pCurLayer->pLumaQp[iMbXy] < 0 || pCurLayer->pLumaQp[iMbXy] > 51) {
+    return ERR_INFO_INVALID_QP;
+  }
+  pSlice->iLastMbQp = pCurLayer->pLumaQp[iMbXy];
+  pCurLayer->pChromaQp[iMbXy] = g_kuiChromaQp[WELS_CLIP3 (pSlice->iLastMbQp + pSliceHeader->pPps->iChromaQpIndexOffset, 0,
+                                51)];
+
+  if (MB_TYPE_INTRA16x16 == pCurLayer->pMbType[iMbXy]) {
+    //step1: Luma DC
+    WELS_READ_VERIFY (ParseResidualBlockCabac (pCtx, pNeighAvail, pNonZeroCount, 0, 16, g_kuiLumaDcZigzagScan,
+                      I16_LUMA_DC, pCurLayer->pScaledTCoeff[iMbXy], pCurLayer->pLumaQp[iMbXy]));
+    //step2: Luma AC
+    if (uiCbpL) {
+      for (i = 0; i < 16; i++) {
+        WELS_READ_VERIFY (ParseResidualBlockCabac (pCtx, pNeighAvail, pNonZeroCount, i,
+                          iScanIdxEnd - WELS_MAX (iScanIdxStart, 1) + 1, g_kuiZigzagScan + WELS_MAX (iScanIdxStart, 1),
+                          I16_LUMA_AC, pCurLayer->pScaledTCoeff[iMbXy] + (i << 4), pCurLayer->pLumaQp[iMbXy]));
+      }
+      ST32 (&pCurLayer->pNzc[iMbXy][0], LD32 (&pNonZeroCount[1 + 8 * 1]));
+      ST32 (&pCurLayer->pNzc[iMbXy][4], LD32 (&pNonZeroCount[1 + 8 * 2]));
+      ST32 (&pCurLayer->pNzc[iMbXy][8], LD32 (&pNonZeroCount[1 + 8 * 3]));
+      ST32 (&pCurLayer->pNzc[iMbXy][12], LD32 (&pNonZeroCount[1 + 8 * 4]));
+    }
+  } else { //non-MB_TYPE_INTRA16x16
+    for (iId8x8 = 0; iId8x8 < 4; iId8x8++) {
+      if (uiCbpL & (1 << iId8x8)) {
+        int32_t iIndex = (iId8x8 << 2);
+        for (iId4x4 = 0; iId4x4 < 4; iId4x4++) {
+          //Luma (DC and AC decoding together)
+          WELS_READ_VERIFY (ParseResidualBlockCabac (pCtx, pNeighAvail, pNonZeroCount, iIndex,
+                            iScanIdxEnd - iScanIdxStart + 1, g_kuiZigzagScan + iScanIdxStart, LUMA_DC_AC,
+                            pCurLayer->pScaledTCoeff[iMbXy] + (iIndex << 4), pCurLayer->pLumaQp[iMbXy]));
+          iIndex++;
+        }
+      } else {
+        ST16 (&pNonZeroCount[g_kuiCacheNzcScanIdx[iId8x8 << 2]], 0);
+        ST16 (&pNonZeroCount[g_kuiCacheNzcScanIdx[ (iId8x8 << 2) + 2]], 0);
+      }
+    }
+    ST32 (&pCurLayer->pNzc[iMbXy][0], LD32 (&pNonZeroCount[1 + 8 * 1]));
+    ST32 (&pCurLayer->pNzc[iMbXy][4], LD32 (&pNonZeroCount[1 + 8 * 2]));
+    ST32 (&pCurLayer->pNzc[iMbXy][8], LD32 (&pNonZeroCount[1 + 8 * 3]));
+    ST32 (&pCurLayer->pNzc[iMbXy][12], LD32 (&pNonZeroCount[1 + 8 * 4]));
+  }
+
+  //chroma
+  //step1: DC
+  if (1 == uiCbpC || 2 == uiCbpC) {
+    for (i = 0; i < 2; i++) { //Cb Cr
+      WELS_READ_VERIFY (ParseResidualBlockCabac (pCtx, pNeighAvail, pNonZeroCount, 16 + (i << 2), 4, g_kuiChromaDcScan,
+                        CHROMA_DC, pCurLayer->pScaledTCoeff[iMbXy] + 256 + (i << 6), pCurLayer->pChromaQp[iMbXy]));
+    }
+  }
+  //step2: AC
+  if (2 == uiCbpC) {
+    for (i = 0; i < 2; i++) { //Cb Cr
+      int32_t iIndex = 16 + (i << 2);
+      for (iId4x4 = 0; iId4x4 < 4; iId4x4++) {
+        WELS_READ_VERIFY (ParseResidualBlockCabac (pCtx, pNeighAvail, pNonZeroCount, iIndex,
+                          iScanIdxEnd - WELS_MAX (iScanIdxStart, 1) + 1, g_kuiZigzagScan + WELS_MAX (iScanIdxStart, 1),
+                          CHROMA_AC, pCurLayer->pScaledTCoeff[iMbXy] + (iIndex << 4), pCurLayer->pChromaQp[iMbXy]));
+        iIndex++;
+      }
+    }
+    ST16 (&pCurLayer->pNzc[iMbXy][16], LD16 (&pNonZeroCount[6 + 8 * 1]));
+    ST16 (&pCurLayer->pNzc[iMbXy][20], LD16 (&pNonZeroCount[6 + 8 * 2]));
+    ST16 (&pCurLayer->pNzc[iMbXy][18], LD16 (&pNonZeroCount[6 + 8 * 4]));
+    ST16 (&pCurLayer->pNzc[iMbXy][22], LD16 (&pNonZeroCount[6 + 8 * 5]));
+  }
+
+  return ERR_NONE;
+}
+
+int32_t WelsActualDecodeMbCabacISlice (PWelsDecoderContext pCtx) {
+  PDqLayer pCurLayer		 = pCtx->pCurDqLayer;
+  PSlice pSlice			 = &pCurLayer->sLayerInfo.sSliceInLayer;
+  SNeighAvail sNeighAvail;
+  int32_t iMbXy = pCurLayer->iMbXyIndex;
+  uint32_t uiMbType;
+
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pNonZeroCount, 48, 16);
+
+  pCurLayer->pInterPredictionDoneFlag[iMbXy] = 0;
+  pCurLayer->pResidualPredFlag[iMbXy] = pSlice->sSliceHeaderExt.bDefaultResidualPredFlag;
+
+  GetNeighborAvailMbType (&sNeighAvail, pCurLayer);
+  WELS_READ_VERIFY (ParseMBTypeISliceCabac (pCtx, &sNeighAvail, uiMbType)); //mb_type
+  if (25 == uiMbType) {
+    return WelsDecodeMbCabacPcm (pCtx);
+  }
+  WELS_READ_VERIFY (WelsDecodeMbCabacIntraInfo (pCtx, &sNeighAvail, pNonZeroCount, uiMbType));
+
+  return WelsDecodeMbCabacResidual (pCtx, &sNeighAvail, pNonZeroCount);
+}
+
+int32_t WelsDecodeMbCabacISlice (PWelsDecoderContext pCtx, PNalUnit pNalCur) {
+  PSliceHeaderExt pSliceHeaderExt = &pCtx->pCurDqLayer->sLayerInfo.sSliceInLayer.sSliceHeaderExt;
+
+  if (pSliceHeaderExt->bAdaptiveBaseModeFlag || pSliceHeaderExt->bDefaultBaseModeFlag) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "base_mode_flag with cabac, inter-layer prediction not supported.\n");
+    return GENERATE_ERROR_NO (ERR_LEVEL_SLICE_HEADER, ERR_INFO_UNSUPPORTED_ILP);
+  }
+
+  return WelsActualDecodeMbCabacISlice (pCtx);
+}
+
+int32_t WelsActualDecodeMbCabacPSlice (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail) {
+  PDqLayer pCurLayer		 = pCtx->pCurDqLayer;
+  PSlice pSlice			 = &pCurLayer->sLayerInfo.sSliceInLayer;
+  int32_t iMbXy = pCurLayer->iMbXyIndex;
+  uint32_t uiMbType, uiCbp;
+
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pNonZeroCount, 48, 16);
+  pCurLayer->pInterPredictionDoneFlag[iMbXy] = 0;
+
+  WELS_READ_VERIFY (ParseMBTypePSliceCabac (pCtx, pNeighAvail, uiMbType)); //mb_type
+  if (uiMbType < 4) { //inter MB type
+    int16_t iMotionVector[LIST_A][30][MV_A];
+    int8_t	iRefIndex[LIST_A][30];
+
+    pCurLayer->pMbType[iMbXy] = g_ksInterMbTypeInfo[uiMbType].iType;
+    WelsFillCacheInter (pNeighAvail, pNonZeroCount, iMotionVector, iRefIndex, pCurLayer);
+    WELS_READ_VERIFY (ParseInterInfoCabac (pCtx, pNeighAvail, iMotionVector, iRefIndex));
+
+    if (pSlice->sSliceHeaderExt.bAdaptiveResidualPredFlag || pSlice->sSliceHeaderExt.bDefaultResidualPredFlag) {
+      WelsLog (pCtx, WELS_LOG_WARNING, "residual_pred_flag = 1 not supported.\n");
+      return GENERATE_ERROR_NO (ERR_LEVEL_MB_DATA, ERR_INFO_UNSUPPORTED_ILP);
+    }
+    pCurLayer->pResidualPredFlag[iMbXy] = 0;
+
+    WELS_READ_VERIFY (ParseCbpInfoCabac (pCtx, pNeighAvail, uiCbp)); //coded_block_pattern
+    pCurLayer->pCbp[iMbXy] = uiCbp;
+  } else { //intra MB type
+    uiMbType -= 5;
+    if (25 == uiMbType) {
+      return WelsDecodeMbCabacPcm (pCtx);
+    }
+    WELS_READ_VERIFY (WelsDecodeMbCabacIntraInfo (pCtx, pNeighAvail, pNonZeroCount, uiMbType));
+  }
+
+  return WelsDecodeMbCabacResidual (pCtx, pNeighAvail, pNonZeroCount);
+}
+
+int32_t WelsDecodeMbCabacPSlice (PWelsDecoderContext pCtx, PNalUnit pNalCur) {
+  PDqLayer pCurLayer		 = pCtx->pCurDqLayer;
+  PSlice pSlice			 = &pCurLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader		    = &pSlice->sSliceHeaderExt.sSliceHeader;
+  SNeighAvail sNeighAvail;
+  int32_t iMbXy = pCurLayer->iMbXyIndex;
+  int32_t i;
+  uint32_t uiCode;
+
+  GetNeighborAvailMbType (&sNeighAvail, pCurLayer);
+  WELS_READ_VERIFY (ParseSkipFlagCabac (pCtx, &sNeighAvail, uiCode)); //mb_skip_flag
+  if (uiCode) {
+    int16_t iMv[2] = {0};
+
+    pCurLayer->pMbType[iMbXy] = MB_TYPE_SKIP;
+    ST32 (&pCurLayer->pNzc[iMbXy][0], 0);
+    ST32 (&pCurLayer->pNzc[iMbXy][4], 0);
+    ST32 (&pCurLayer->pNzc[iMbXy][8], 0);
+    ST32 (&pCurLayer->pNzc[iMbXy][12], 0);
+    ST32 (&pCurLayer->pNzc[iMbXy][16], 0);
+    ST32 (&pCurLayer->pNzc[iMbXy][20], 0);
+    memset (pCurLayer->pMvd[LIST_0][iMbXy], 0, sizeof (pCurLayer->pMvd[LIST_0][iMbXy]));
+    pCurLayer->pCbfDc[iMbXy] = 0;
+
+    pCurLayer->pInterPredictionDoneFlag[iMbXy] = 0;
+    memset (pCurLayer->pRefIndex[0][iMbXy], 0, sizeof (int8_t) * 16);
+
+    //predict iMv
+    PredPSkipMvFromNeighbor (pCurLayer, iMv);
+    for (i = 0; i < 16; i++) {
+      ST32 (pCurLayer->pMv[0][iMbXy][i], * (uint32_t*)iMv);
+    }
+
+    if (!pSlice->sSliceHeaderExt.bDefaultResidualPredFlag) {
+      memset (pCurLayer->pScaledTCoeff[iMbXy], 0, 384 * sizeof (int16_t));
+    }
+
+    //reset rS
+    if (!pSlice->sSliceHeaderExt.bDefaultResidualPredFlag ||
+        (pNalCur->sNalHeaderExt.uiQualityId == 0 && pNalCur->sNalHeaderExt.uiDependencyId == 0)) {
+      pCurLayer->pLumaQp[iMbXy] = pSlice->iLastMbQp;
+      pCurLayer->pChromaQp[iMbXy] = g_kuiChromaQp[WELS_CLIP3 (pCurLayer->pLumaQp[iMbXy] +
+                                    pSliceHeader->pPps->iChromaQpIndexOffset, 0, 51)];
+    }
+
+    pCurLayer->pCbp[iMbXy] = 0;
+    pSlice->iLastDeltaQp = 0;
+
+    return 0;
+  }
+
+  if (pSlice->sSliceHeaderExt.bAdaptiveBaseModeFlag || pSlice->sSliceHeaderExt.bDefaultBaseModeFlag) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "base_mode_flag with cabac, inter-layer prediction not supported.\n");
+    return GENERATE_ERROR_NO (ERR_LEVEL_SLICE_HEADER, ERR_INFO_UNSUPPORTED_ILP);
+  }
+
+  return WelsActualDecodeMbCabacPSlice (pCtx, &sNeighAvail);
+}
+
 void WelsBlockInit (int16_t* pBlock, int32_t iWidth, int32_t iHeight, int32_t iStride, uint8_t uiVal) {
   int32_t i;
   int16_t* pDst = pBlock;
@@ -51,6 +51,7 @@
 #include "expand_pic.h"
 #include "decode_slice.h"
 #include "mem_align.h"
+#include "dec_multi_threading.h"
 #include "ls_defines.h"
 
 namespace WelsDec {
@@ -93,6 +94,7 @@ static int32_t CreatePicBuff (PWelsDecoderContext pCtx, PPicBuff* ppPicBuf, cons
   // initialize context in queue
   pPicBuf->iCapacity	 = kiSize;
   pPicBuf->iCurrentIdx = 0;
+  pPicBuf->pAllocator	 = (NULL != pCtx->sFrameAllocator.pfnGetBuffer) ? &pCtx->sFrameAllocator : NULL;
   *ppPicBuf			 = pPicBuf;
 
   return 0;
@@ -110,6 +112,7 @@ static void DestroyPicBuff (PPicBuff* ppPicBuf) {
     while (iPicIdx < pPicBuf->iCapacity) {
       PPicture pPic = pPicBuf->ppPic[iPicIdx];
       if (pPic != NULL) {
+        ReleasePicBuffer (pPicBuf, pPic);
         FreePicture (pPic);
       }
       pPic = NULL;
@@ -245,6 +248,9 @@ int32_t WelsRequestMem (PWelsDecoderContext pCtx, const int32_t kiMbWidth, const
   // Fixed the issue about different gop size over last, 5/17/2010
   // get picture queue size currently
   iPicQueueSize	= GetTargetRefListSize (pCtx);	// adaptive size of picture queue, = (pSps->iNumRefFrames x 2)
+#if defined(MT_ENABLED)
+  iPicQueueSize	+= WelsGetDecThreadPicNum (pCtx);	// pictures held by reconstruction jobs and pending output
+#endif//MT_ENABLED
   pCtx->iPicQueueNumber = iPicQueueSize;
   if (pCtx->pPicBuff[LIST_0] != NULL
       && pCtx->pPicBuff[LIST_0]->iCapacity ==
@@ -254,6 +260,10 @@ int32_t WelsRequestMem (PWelsDecoderContext pCtx, const int32_t kiMbWidth, const
   WELS_VERIFY_RETURN_IF (ERR_NONE, pCtx->bHaveGotMemory && (kiPicWidth == pCtx->iImgWidthInPixel
                          && kiPicHeight == pCtx->iImgHeightInPixel) && (!bNeedChangePicQueue))	// have same scaled buffer
 
+#if defined(MT_ENABLED)
+  WelsResetDecThreads (pCtx);	// no job may touch pictures to be freed
+#endif//MT_ENABLED
+
   // sync update pRefList
   WelsResetRefPic (pCtx);	// added to sync update ref list due to pictures are free
 
@@ -314,6 +324,8 @@ void WelsOpenDecoder (PWelsDecoderContext pCtx) {
   InitMcFunc (& (pCtx->sMcFunc), pCtx->uiCpuFlag);
 
   InitExpandPictureFunc (& (pCtx->sExpandPicFunc), pCtx->uiCpuFlag);
+  InitColorConvertFunc (& (pCtx->sColorConvertFunc), pCtx->uiCpuFlag);
+  InitDetectEscOrStartCodeFunc (& (pCtx->pfDetectEscOrStartCode), pCtx->uiCpuFlag);
   AssignFuncPointerForRec (pCtx);
 
   // vlc tables
@@ -334,6 +346,11 @@ void WelsOpenDecoder (PWelsDecoderContext pCtx) {
  * \brief	Close decoder
  */
 void WelsCloseDecoder (PWelsDecoderContext pCtx) {
+#if defined(MT_ENABLED)
+  WelsUninitDecThreadCtx (pCtx);
+  WelsUninitDeblockThread (pCtx);
+#endif//MT_ENABLED
+
   WelsFreeMem (pCtx);
 
   WelsFreeMemory (pCtx);
@@ -372,6 +389,17 @@ int32_t DecoderConfigParam (PWelsDecoderContext pCtx, const SDecodingParam* kpPa
 
   WelsLog (pCtx, WELS_LOG_INFO, "eVideoType: %d\n", pCtx->eVideoType);
 
+#if defined(MT_ENABLED)
+  if (pCtx->pParam->iThreadCount > 1 && ERR_NONE != WelsInitDecThreadCtx (pCtx, pCtx->pParam->iThreadCount,
+      DECODER_THREADING_SLICE == pCtx->pParam->eThreadingMode, pCtx->pParam->bUseSharedThreadPool)) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "DecoderConfigParam(), threading not available, decoding in single thread\n");
+  }
+  if (NULL == pCtx->pThreadCtx && NULL == pCtx->pDeblockThread && pCtx->pParam->bDeblockingThread
+      && ERR_NONE != WelsInitDeblockThread (pCtx)) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "DecoderConfigParam(), deblocking helper thread not available\n");
+  }
+#endif//MT_ENABLED
+
   return 0;
 }
 
@@ -482,9 +510,15 @@ int32_t WelsDecodeBs (PWelsDecoderContext pCtx, const uint8_t* kpBsBuf, const in
     pDstNal = pRawData->pCurPos + 4; //4-bytes used to write the length of current NAL rbsp
 
     while (iSrcConsumed < iSrcLength) {
-      if ((2 + iSrcConsumed < iSrcLength) &&
-          (0 == LD16 (pSrcNal + iSrcIdx)) &&
-          ((pSrcNal[2 + iSrcIdx] == 0x03) || (pSrcNal[2 + iSrcIdx] == 0x01))) {
+      //bulk copy of the run without any escape or start code, 0x03 removal below only happens where one shows up
+      const int32_t kiRunLen = pCtx->pfDetectEscOrStartCode (pSrcNal + iSrcIdx, iSrcLength - iSrcConsumed);
+      if (kiRunLen > 0) {
+        memcpy (pDstNal + iDstIdx, pSrcNal + iSrcIdx, kiRunLen);
+        iDstIdx      += kiRunLen;
+        iSrcIdx      += kiRunLen;
+        iSrcConsumed += kiRunLen;
+      }
+      if (iSrcConsumed < iSrcLength) {
         if (pSrcNal[2 + iSrcIdx] == 0x03) {
           ST16 (pDstNal + iDstIdx, 0);
           iDstIdx	+= 2;
@@ -541,10 +575,7 @@ int32_t WelsDecodeBs (PWelsDecoderContext pCtx, const uint8_t* kpBsBuf, const in
           iSrcIdx = 0;
           iDstIdx  = 0; //reset 0, used to statistic the length of next NAL
         }
-        continue;
       }
-      pDstNal[iDstIdx++] = pSrcNal[iSrcIdx++];
-      iSrcConsumed++;
     }
 
     //last NAL decoding
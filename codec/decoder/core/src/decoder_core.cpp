@@ -41,6 +41,7 @@
 #include "decoder.h"
 #include "decode_mb_aux.h"
 #include "mem_align.h"
+#include "dec_multi_threading.h"
 
 namespace WelsDec {
 
@@ -78,6 +79,14 @@ static inline int32_t DecodeFrameConstruction (PWelsDecoderContext pCtx, uint8_t
              pCtx->sFrameCrop.iBottomOffset);
   }
 
+#if defined(MT_ENABLED)
+  if (WelsIsFrameThreading (pCtx)) {
+    // output in decoding order after reconstruction job done, see WelsFetchOutputPic()
+    WelsQueueOutputPic (pCtx, pPic, kiWidth, kiHeight);
+    return 0;
+  }
+#endif//MT_ENABLED
+
   //////output:::normal path
   ppDst[0]      = pPic->pData[0];
   ppDst[1]      = pPic->pData[1];
@@ -96,6 +105,7 @@ static inline int32_t DecodeFrameConstruction (PWelsDecoderContext pCtx, uint8_t
   ppDst[0] = ppDst[0] + pCtx->sFrameCrop.iTopOffset * 2 * pPic->iLinesize[0] + pCtx->sFrameCrop.iLeftOffset * 2;
   ppDst[1] = ppDst[1] + pCtx->sFrameCrop.iTopOffset  * pPic->iLinesize[1] + pCtx->sFrameCrop.iLeftOffset;
   ppDst[2] = ppDst[2] + pCtx->sFrameCrop.iTopOffset  * pPic->iLinesize[1] + pCtx->sFrameCrop.iLeftOffset;
+  pDstInfo->pFrameOpaque = pPic->sExtBuffer.pOpaque;
   pDstInfo->iBufferStatus = 1;
 
   return 0;
@@ -714,9 +724,14 @@ int32_t ParseSliceHeaderSyntaxs (PWelsDecoderContext pCtx, PBitStringAux pBs, co
     }
   }
 
-  if (pPps->bEntropyCodingModeFlag) {
-    WelsLog (pCtx, WELS_LOG_WARNING, "ParseSliceHeaderSyntaxs(): CABAC in Enhancement layer not supported.\n");
-    return GENERATE_ERROR_NO (ERR_LEVEL_SLICE_HEADER, ERR_INFO_UNSUPPORTED_CABAC_EL);
+  pSliceHead->iCabacInitIdc = 0;
+  if (pPps->bEntropyCodingModeFlag && uiSliceType != I_SLICE && uiSliceType != SI_SLICE) {
+    WELS_READ_VERIFY (BsGetUe (pBs, &uiCode)); //cabac_init_idc
+    if (uiCode > 2) {
+      WelsLog (pCtx, WELS_LOG_WARNING, "cabac_init_idc (%d) out of range [0, 2]\n", uiCode);
+      return GENERATE_ERROR_NO (ERR_LEVEL_SLICE_HEADER, ERR_INFO_INVALID_CABAC_INIT_IDC);
+    }
+    pSliceHead->iCabacInitIdc = uiCode;
   }
 
   WELS_READ_VERIFY (BsGetSe (pBs, &iCode)); //slice_qp_delta
@@ -1068,6 +1083,10 @@ int32_t InitialDqLayersContext (PWelsDecoderContext pCtx, const int32_t kiMaxWid
                         "pCtx->sMb.pCbp[]");
     pCtx->sMb.pSubMbType[i] = (int8_t (*)[MB_PARTITION_SIZE])WelsMalloc (pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight * sizeof (
                                 int8_t) * MB_PARTITION_SIZE, "pCtx->sMb.pSubMbType[]");
+    pCtx->sMb.pMvd[i][0] = (uint8_t (*)[MB_BLOCK4x4_NUM][MV_A])WelsMalloc (pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight *
+                           sizeof (uint8_t) * MV_A * MB_BLOCK4x4_NUM, "pCtx->sMb.pMvd[][]");
+    pCtx->sMb.pCbfDc[i] = (uint8_t*)WelsMalloc (pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight * sizeof (uint8_t),
+                          "pCtx->sMb.pCbfDc[]");
     pCtx->sMb.pSliceIdc[i] = (int32_t*) WelsMalloc (pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight * sizeof (int32_t),
                              "pCtx->sMb.pSliceIdc[]");	// using int32_t for slice_idc, 4/21/2010
     if (pCtx->sMb.pSliceIdc[i] != NULL)
@@ -1093,6 +1112,8 @@ int32_t InitialDqLayersContext (PWelsDecoderContext pCtx, const int32_t kiMaxWid
                             (NULL == pCtx->sMb.pChromaPredMode[i]) ||
                             (NULL == pCtx->sMb.pCbp[i]) ||
                             (NULL == pCtx->sMb.pSubMbType[i]) ||
+                            (NULL == pCtx->sMb.pMvd[i][0]) ||
+                            (NULL == pCtx->sMb.pCbfDc[i]) ||
                             (NULL == pCtx->sMb.pSliceIdc[i]) ||
                             (NULL == pCtx->sMb.pResidualPredFlag[i]) ||
                             (NULL == pCtx->sMb.pInterPredictionDoneFlag[i])
@@ -1235,6 +1256,18 @@ void UninitialDqLayersContext (PWelsDecoderContext pCtx) {
       pCtx->sMb.pSubMbType[i] = NULL;
     }
 
+    if (pCtx->sMb.pMvd[i][0]) {
+      WelsFree (pCtx->sMb.pMvd[i][0], "pCtx->sMb.pMvd[][]");
+
+      pCtx->sMb.pMvd[i][0] = NULL;
+    }
+
+    if (pCtx->sMb.pCbfDc[i]) {
+      WelsFree (pCtx->sMb.pCbfDc[i], "pCtx->sMb.pCbfDc[]");
+
+      pCtx->sMb.pCbfDc[i] = NULL;
+    }
+
     if (pCtx->sMb.pSliceIdc[i]) {
       WelsFree (pCtx->sMb.pSliceIdc[i], "pCtx->sMb.pSliceIdc[]");
 
@@ -1663,6 +1696,10 @@ int32_t ConstructAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBufferI
 
 
   iErr = DecodeCurrentAccessUnit (pCtx, ppDst, iStride, &iWidth, &iHeight, pDstInfo);
+#if defined(MT_ENABLED)
+  WelsWaitSliceJobs (pCtx);	// jobs left by a failure still read bits of this AU
+  WelsWaitDeblockThread (pCtx);
+#endif//MT_ENABLED
 
   WelsDecodeAccessUnitEnd (pCtx);
 
@@ -1764,6 +1801,8 @@ void InitCurDqLayerData (PWelsDecoderContext pCtx, PDqLayer pCurDq) {
     pCurDq->pChromaPredMode = pCtx->sMb.pChromaPredMode[0];
     pCurDq->pCbp            = pCtx->sMb.pCbp[0];
     pCurDq->pSubMbType      = pCtx->sMb.pSubMbType[0];
+    pCurDq->pMvd[0]         = pCtx->sMb.pMvd[0][0];
+    pCurDq->pCbfDc          = pCtx->sMb.pCbfDc[0];
     pCurDq->pInterPredictionDoneFlag = pCtx->sMb.pInterPredictionDoneFlag[0];
     pCurDq->pResidualPredFlag = pCtx->sMb.pResidualPredFlag[0];
   }
@@ -1801,6 +1840,11 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
   bool	bFreshSliceAvailable =
     true;	// Another fresh slice comingup for given dq layer, for multiple slices in case of header parts of slices sometimes loss over error-prone channels, 8/14/2008
   PPicture  pStoreBasePic = NULL;
+#if defined(MT_ENABLED)
+  const bool kbThreadedAu = (NULL != pCtx->pThreadCtx) && WelsCheckAuForThreading (pCtx, pCurAu, kuiTargetLayerDqId);
+  const bool kbFrameThreading = kbThreadedAu && WelsIsFrameThreading (pCtx);
+  const bool kbSliceThreading = kbThreadedAu && WelsIsSliceThreading (pCtx);
+#endif//MT_ENABLED
 
   //update pCurDqLayer at the starting of AU decoding
   if (pCtx->bInitialDqLayersMem) {
@@ -1809,6 +1853,16 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
 
   InitCurDqLayerData (pCtx, pCtx->pCurDqLayer);
 
+#if defined(MT_ENABLED)
+  if (NULL != pCtx->pThreadCtx) {
+    iRet = WelsPrepareFrameThreadingAu (pCtx, kbFrameThreading);
+    if (ERR_NONE != iRet) {
+      pCtx->iErrorCode |= dsOutOfMemory;
+      return iRet;
+    }
+  }
+#endif//MT_ENABLED
+
   pNalCur = pCurAu->pNalUnitsList[iIdx];
   while (iIdx <= iEndIdx) {
     PDqLayer dq_cur							= pCtx->pCurDqLayer;
@@ -1817,7 +1871,12 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
     PSliceHeader pSh							= NULL;
 
     if (pCtx->pDec == NULL) {
-      pCtx->pDec = PrefetchPic (pCtx->pPicBuff[0]);
+#if defined(MT_ENABLED)
+      if (NULL != pCtx->pThreadCtx)
+        pCtx->pDec = WelsThreadPrefetchPic (pCtx, kbFrameThreading);
+      else
+#endif//MT_ENABLED
+        pCtx->pDec = PrefetchPic (pCtx->pPicBuff[0]);
 
       if (NULL == pCtx->pDec) {
         WelsLog (pCtx, WELS_LOG_ERROR, "DecodeCurrentAccessUnit()::::::PrefetchPic ERROR, pSps->iNumRefFrames:%d.\n",
@@ -1839,8 +1898,18 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
     pCtx->pDec->iTotalNumMbRec = 0;
 #endif
     if (pCtx->pDec->iTotalNumMbRec == 0) { //Picture start to decode
-      for (int32_t i = 0; i < LAYER_NUM_EXCHANGEABLE; ++ i)
-        memset (pCtx->sMb.pSliceIdc[i], 0xff, (pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight * sizeof (int32_t)));
+      pCtx->iDeblockedMbNum	= 0;
+      pCtx->iDeblockedMbTotal	= 0;
+      pCtx->iFinishedMbRows	= 0;
+      memcpy (&pCtx->pDec->sFrameCrop, &pNalCur->sNalData.sVclNal.sSliceHeaderExt.sSliceHeader.pSps->sFrameCrop,
+              sizeof (SPosOffset));
+#if defined(MT_ENABLED)
+      if (kbFrameThreading)
+        WelsResetParseSlotPicture (pCtx);
+      else
+#endif//MT_ENABLED
+        for (int32_t i = 0; i < LAYER_NUM_EXCHANGEABLE; ++ i)
+          memset (pCtx->sMb.pSliceIdc[i], 0xff, (pCtx->sMb.iMbWidth * pCtx->sMb.iMbHeight * sizeof (int32_t)));
     }
     GetI4LumaIChromaAddrTable (pCtx->iDecBlockOffsetArray, pCtx->pDec->iLinesize[0], pCtx->pDec->iLinesize[1]);
 
@@ -1935,7 +2004,14 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
           }
         }
 
-        iRet = WelsDecodeSlice (pCtx, bFreshSliceAvailable, pNalCur);
+#if defined(MT_ENABLED)
+        if (kbSliceThreading) {
+          // parsed and reconstructed on thread pool, collected by WelsFinishSliceJobs()
+          WelsQueueSliceJob (pCtx, pNalCur);
+          iRet = ERR_NONE;
+        } else
+#endif//MT_ENABLED
+          iRet = WelsDecodeSlice (pCtx, bFreshSliceAvailable, pNalCur);
 
         //Output good store_base reconstruction when enhancement quality layer occurred error for MGS key picture case
         if (iRet != ERR_NONE) {
@@ -1945,9 +2021,19 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
           return iRet;
         }
         if (bReconstructSlice)	{
-          if (WelsDecodeConstructSlice (pCtx, pNalCur)) {
-            return -1;
-          }
+#if defined(MT_ENABLED)
+          if (kbSliceThreading) {
+            // reconstructed by slice job
+          } else if (kbFrameThreading) {
+            if (WelsRecordSliceForRecon (pCtx)) {
+              HandleReferenceLostL0 (pCtx, pNalCur);
+              return -1;
+            }
+          } else
+#endif//MT_ENABLED
+            if (WelsDecodeConstructSlice (pCtx, pNalCur)) {
+              return -1;
+            }
         }
       }
 #if defined (_DEBUG) &&  !defined (CODEC_FOR_TESTBED)
@@ -1979,6 +2065,17 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
              dq_cur->sLayerInfo.sNalHeaderExt.uiPriorityId, dq_cur->sLayerInfo.sSliceInLayer.sSliceHeaderExt.sSliceHeader.iSliceQp);
 #endif//#if !CODEC_FOR_TESTBED
 
+#if defined(MT_ENABLED)
+    WelsWaitDeblockThread (pCtx);
+    if (kbSliceThreading) {
+      iRet = WelsFinishSliceJobs (pCtx);
+      if (iRet != ERR_NONE) {
+        HandleReferenceLostL0 (pCtx, pCurAu->pNalUnitsList[iIdx - 1]);
+        return iRet;
+      }
+    }
+#endif//MT_ENABLED
+
     if (dq_cur->uiLayerDqId == kuiTargetLayerDqId) {
       if (DecodeFrameConstruction (pCtx, ppDst, pDstLen, pWidth, pHeight, pDstInfo)) {
 #ifdef NO_WAITING_AU
@@ -1992,11 +2089,23 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, int3
 #endif
 
       }
+#if defined(MT_ENABLED)
+      if (kbFrameThreading) {
+        const bool kbRef = (uiNalRefIdc > 0);
+        if (kbRef)
+          WelsMarkAsRef (pCtx, false);
+        // padding of referencing picture is done by the job row by row
+        WelsSubmitReconJob (pCtx, kbRef);
+        pCtx->pDec = NULL;
+      } else
+#endif//MT_ENABLED
       if ((uiNalRefIdc > 0) && (iCurrIdQ || (!dq_cur->bStoreRefBasePicFlag))) {
         WelsMarkAsRef (pCtx, false);
         ExpandReferencingPicture (pCtx->pDec, pCtx->sExpandPicFunc.pExpandLumaPicture,
                                   pCtx->sExpandPicFunc.pExpandChromaPicture);
         pCtx->pDec = NULL;
+      } else if (0 == uiNalRefIdc && NULL != pCtx->pPicBuff[LIST_0]->pAllocator) {
+        pCtx->pDec = NULL;	// the application may keep the picture output, the next one gets another buffer
       }
     }
 
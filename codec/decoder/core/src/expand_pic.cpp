@@ -154,4 +154,43 @@ void ExpandReferencingPicture (PPicture pPic, PExpandPictureFunc pExpLuma, PExpa
   }
 }
 
+static inline void ExpandPlaneLines_c (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicWidth,
+                                       const int32_t kiPicHeight, const int32_t kiStartLine, const int32_t kiEndLine, const int32_t kiPaddingLen) {
+  uint8_t* pTmp	= pDst + kiStartLine * kiStride;
+  int32_t i		= kiStartLine;
+
+  // pad left and right
+  while (i < kiEndLine) {
+    memset (pTmp - kiPaddingLen, pTmp[0], kiPaddingLen);
+    memset (pTmp + kiPicWidth, pTmp[kiPicWidth - 1], kiPaddingLen);
+
+    pTmp += kiStride;
+    ++ i;
+  }
+
+  // pad top and bottom together with corners, by copying the padded first/last line
+  if (0 == kiStartLine) {
+    for (i = 1; i <= kiPaddingLen; ++ i)
+      memcpy (pDst - i * kiStride - kiPaddingLen, pDst - kiPaddingLen, kiPicWidth + (kiPaddingLen << 1));
+  }
+  if (kiPicHeight == kiEndLine) {
+    uint8_t* pDstLastLine = pDst + (kiPicHeight - 1) * kiStride;
+    for (i = 1; i <= kiPaddingLen; ++ i)
+      memcpy (pDstLastLine + i * kiStride - kiPaddingLen, pDstLastLine - kiPaddingLen, kiPicWidth + (kiPaddingLen << 1));
+  }
+}
+
+void ExpandReferencingPictureMbRows (PPicture pPic, const int32_t kiStartMbRow, const int32_t kiEndMbRow) {
+  const int32_t kiWidthY	= pPic->iWidthInPixel;
+  const int32_t kiHeightY	= pPic->iHeightInPixel;
+  const int32_t kiStartY	= kiStartMbRow << 4;
+  const int32_t kiEndY	= WELS_MIN (kiEndMbRow << 4, kiHeightY);
+
+  ExpandPlaneLines_c (pPic->pData[0], pPic->iLinesize[0], kiWidthY, kiHeightY, kiStartY, kiEndY, PADDING_LENGTH);
+  ExpandPlaneLines_c (pPic->pData[1], pPic->iLinesize[1], kiWidthY >> 1, kiHeightY >> 1, kiStartY >> 1, kiEndY >> 1,
+                      PADDING_LENGTH >> 1);
+  ExpandPlaneLines_c (pPic->pData[2], pPic->iLinesize[2], kiWidthY >> 1, kiHeightY >> 1, kiStartY >> 1, kiEndY >> 1,
+                      PADDING_LENGTH >> 1);
+}
+
 } // namespace WelsDec
@@ -31,6 +31,7 @@
  */
 
 #include "mem_align.h"
+#include "WelsMemoryPool.h"
 
 namespace WelsDec {
 
@@ -48,7 +49,7 @@ void* WelsMalloc (const uint32_t kuiSize, const char* kpTag) {
   const int32_t kiSizeVoidPtr	= sizeof (void**);
   const int32_t kiSizeInt		= sizeof (int32_t);
   const int32_t kiAlignBytes	= 15;
-  uint8_t* pBuf		= (uint8_t*) malloc (kuiSize + kiAlignBytes + kiSizeVoidPtr + kiSizeInt);
+  uint8_t* pBuf		= (uint8_t*) WelsPoolMalloc (kuiSize + kiAlignBytes + kiSizeVoidPtr + kiSizeInt, kpTag);
   uint8_t* pAlignBuf;
 
 #ifdef MEMORY_CHECK
@@ -92,7 +93,7 @@ void WelsFree (void* pPtr, const char* kpTag) {
       fflush (pMemCheckFree);
     }
 #endif
-    free (* (((void**) pPtr) - 1));
+    WelsPoolFree (* (((void**) pPtr) - 1));
   }
 }
 
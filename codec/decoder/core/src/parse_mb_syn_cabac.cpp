@@ -0,0 +1,743 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	parse_mb_syn_cabac.cpp
+ *
+ * \brief	Interfaces implementation for parsing the syntax of MB with cabac
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include "parse_mb_syn_cabac.h"
+#include "parse_mb_syn_cavlc.h"
+#include "error_code.h"
+#include "mv_pred.h"
+
+namespace WelsDec {
+
+#define MAX_COEFF_ABS_LEVEL_SUFFIX	(1 << 16)	// no level after scaling fits in 16 bits beyond it
+#define MAX_MVD_SUFFIX				(1 << 14)	// mvd beyond the range of all levels
+
+/* ctxBlockCatOffset of Table 9-40 indexed by ctxBlockCat, which is iResProperty - 1 for 4:2:0 frame coding */
+static const uint8_t g_kuiCbfCtxOffset[5]		= { 0,  4,  8, 12, 16};
+static const uint8_t g_kuiSigCoeffCtxOffset[5]	= { 0, 15, 29, 44, 47};
+static const uint8_t g_kuiAbsLevelCtxOffset[5]	= { 0, 10, 20, 30, 39};
+
+/* ctxIdxInc of the bins of intra mb_type following the I_PCM terminating bin: luma cbp, chroma cbp != 0,
+ * chroma cbp == 2, prediction mode high and low bit, in I slices and as suffix in P slices */
+static const int8_t g_kiIntraMbTypeCtxInc[2][5] = {
+  {3, 4, 5, 6, 7},
+  {1, 2, 2, 3, 3},
+};
+
+int32_t InitCabacSliceDec (PWelsDecoderContext pCtx, PBitStringAux pBs) {
+  PSlice pSlice				= &pCtx->pCurDqLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader	= &pSlice->sSliceHeaderExt.sSliceHeader;
+  const int32_t kiUsedBits	= ((pBs->pCurBuf - pBs->pStartBuf) << 3) - (16 - pBs->iLeftBits);
+  // cabac_alignment_one_bit skipped, the slice data run up to the byte of rbsp_stop_one_bit
+  const uint8_t* kpBuf		= pBs->pStartBuf + ((kiUsedBits + 7) >> 3);
+  const uint8_t* kpBufEnd	= pBs->pStartBuf + (pBs->iBits >> 3) + 1;
+  const int32_t kiModel		= (I_SLICE == pSliceHeader->eSliceType) ? WELS_CABAC_MODEL_I : pSliceHeader->iCabacInitIdc;
+
+  if (kpBuf >= kpBufEnd) {
+    return ERR_INFO_READ_OVERFLOW;
+  }
+  WelsCabacDecContextInit (&pCtx->sCabacDecEngine, kiModel, pSliceHeader->iSliceQp);
+  pSlice->iLastDeltaQp = 0;
+
+  return WelsCabacDecEngineInit (&pCtx->sCabacDecEngine, kpBuf, kpBufEnd);
+}
+
+int32_t ParseEndOfSliceCabac (PWelsDecoderContext pCtx, uint32_t& uiBinVal) {
+  return WelsCabacDecTerminate (&pCtx->sCabacDecEngine, uiBinVal);
+}
+
+int32_t ParseSkipFlagCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiSkip) {
+  const int32_t kiCtxInc = (pNeighAvail->iLeftAvail && MB_TYPE_SKIP != pNeighAvail->iLeftType)
+                           + (pNeighAvail->iTopAvail && MB_TYPE_SKIP != pNeighAvail->iTopType);
+  return WelsCabacDecDecision (&pCtx->sCabacDecEngine, CTX_OFFSET_SKIP_FLAG_P + kiCtxInc, uiSkip);
+}
+
+/*
+ *	bins of intra mb_type from the I_PCM terminating one on, mb_type returned is that of I slice
+ */
+static int32_t ParseIntraMbTypeCabac (PWelsCabacDecEngine pEngine, const int32_t kiCtxOffset, const int8_t* kpCtxInc,
+                                      uint32_t& uiMbType) {
+  uint32_t uiCode, uiCbpLuma, uiCbpChroma, uiPredMode;
+
+  WELS_READ_VERIFY (WelsCabacDecTerminate (pEngine, uiCode));
+  if (uiCode) {
+    uiMbType = 25; //I_PCM
+    return ERR_NONE;
+  }
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtxOffset + kpCtxInc[0], uiCbpLuma));
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtxOffset + kpCtxInc[1], uiCbpChroma));
+  if (uiCbpChroma) {
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtxOffset + kpCtxInc[2], uiCode));
+    uiCbpChroma += uiCode;
+  }
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtxOffset + kpCtxInc[3], uiPredMode));
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtxOffset + kpCtxInc[4], uiCode));
+  uiPredMode = (uiPredMode << 1) | uiCode;
+
+  uiMbType = 1 + uiPredMode + (uiCbpChroma << 2) + uiCbpLuma * 12;
+  return ERR_NONE;
+}
+
+int32_t ParseMBTypeISliceCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiMbType) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  const int32_t kiCtxInc = (pNeighAvail->iLeftAvail && MB_TYPE_INTRA4x4 != pNeighAvail->iLeftType)
+                           + (pNeighAvail->iTopAvail && MB_TYPE_INTRA4x4 != pNeighAvail->iTopType);
+  uint32_t uiCode;
+
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_MB_TYPE_I + kiCtxInc, uiCode));
+  if (0 == uiCode) {
+    uiMbType = 0; //I4x4
+    return ERR_NONE;
+  }
+  return ParseIntraMbTypeCabac (pEngine, CTX_OFFSET_MB_TYPE_I, g_kiIntraMbTypeCtxInc[0], uiMbType);
+}
+
+int32_t ParseMBTypePSliceCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiMbType) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  uint32_t uiCode;
+
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_MB_TYPE_P, uiCode));
+  if (uiCode) { //intra prefix, I slice mb_type in suffix
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_MB_TYPE_P_SUFFIX, uiCode));
+    if (0 == uiCode) {
+      uiMbType = 5; //I4x4
+      return ERR_NONE;
+    }
+    WELS_READ_VERIFY (ParseIntraMbTypeCabac (pEngine, CTX_OFFSET_MB_TYPE_P_SUFFIX, g_kiIntraMbTypeCtxInc[1], uiMbType));
+    uiMbType += 5;
+    return ERR_NONE;
+  }
+
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_MB_TYPE_P + 1, uiCode));
+  if (uiCode) {
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_MB_TYPE_P + 3, uiCode));
+    uiMbType = uiCode ? 1 : 2; //16x8 : 8x16
+  } else {
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_MB_TYPE_P + 2, uiCode));
+    uiMbType = uiCode ? 3 : 0; //8x8 : 16x16
+  }
+  return ERR_NONE;
+}
+
+static int32_t ParseSubMBTypeCabac (PWelsCabacDecEngine pEngine, uint32_t& uiSubMbType) {
+  uint32_t uiCode;
+
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_SUB_MB_TYPE_P, uiCode));
+  if (uiCode) {
+    uiSubMbType = 0; //8x8
+    return ERR_NONE;
+  }
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_SUB_MB_TYPE_P + 1, uiCode));
+  if (0 == uiCode) {
+    uiSubMbType = 1; //8x4
+    return ERR_NONE;
+  }
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_SUB_MB_TYPE_P + 2, uiCode));
+  uiSubMbType = uiCode ? 2 : 3; //4x8 : 4x4
+  return ERR_NONE;
+}
+
+/*
+ *	condTermFlagN of intra_chroma_pred_mode, 0 for neighbours unavailable, inter, I_PCM or of DC prediction
+ */
+static inline int32_t ChromaPredModeCond (const int32_t kiAvail, const int32_t kiMbType, const int8_t kiMode) {
+  return kiAvail && IS_INTRA (kiMbType) && MB_TYPE_INTRA_PCM != kiMbType && kiMode >= C_PRED_H && kiMode <= C_PRED_P;
+}
+
+static int32_t ParseIntraChromaPredModeCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint8_t uiNeighAvail) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  const int32_t kiMbXy = pCurDqLayer->iMbXyIndex;
+  int32_t iCtxInc = 0;
+  int8_t iMode = 0;
+  uint32_t uiCode;
+
+  if (pNeighAvail->iLeftAvail) {
+    iCtxInc += ChromaPredModeCond (1, pNeighAvail->iLeftType, pCurDqLayer->pChromaPredMode[kiMbXy - 1]);
+  }
+  if (pNeighAvail->iTopAvail) {
+    iCtxInc += ChromaPredModeCond (1, pNeighAvail->iTopType, pCurDqLayer->pChromaPredMode[kiMbXy - pCurDqLayer->iMbWidth]);
+  }
+
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_INTRA_CHROMA_PRED + iCtxInc, uiCode));
+  while (uiCode && iMode < C_PRED_P) { //truncated unary, cMax = 3
+    ++ iMode;
+    if (iMode < C_PRED_P) {
+      WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_INTRA_CHROMA_PRED + 3, uiCode));
+    }
+  }
+
+  pCurDqLayer->pChromaPredMode[kiMbXy] = iMode;
+  if (CheckIntraChromaPredMode (uiNeighAvail, &pCurDqLayer->pChromaPredMode[kiMbXy])) {
+    return ERR_INFO_INVALID_I_CHROMA_PRED_MODE;
+  }
+  return ERR_NONE;
+}
+
+/*
+ *	neighbour samples usable by intra prediction, only intra MBs count with constrained_intra_pred_flag
+ */
+static inline int32_t IntraNeighAvail (PWelsDecoderContext pCtx, const int32_t kiAvail, const int32_t kiMbType) {
+  return kiAvail && (!pCtx->pCurDqLayer->sLayerInfo.pPps->bConstainedIntraPredFlag || IS_INTRA (kiMbType));
+}
+
+int32_t ParseIntra4x4ModeCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, int8_t* pIntraPredMode) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  int32_t iSampleAvail[5 * 6] = { 0 }; //initialize as 0
+  int32_t iMbXy = pCurDqLayer->iMbXyIndex;
+  int32_t iFinalMode, i, j;
+  uint8_t uiNeighAvail = 0;
+  uint32_t uiCode;
+
+  if (IntraNeighAvail (pCtx, pNeighAvail->iLeftAvail, pNeighAvail->iLeftType)) {  //left
+    iSampleAvail[ 6] =
+      iSampleAvail[12] =
+        iSampleAvail[18] =
+          iSampleAvail[24] = 1;
+  }
+  if (IntraNeighAvail (pCtx, pNeighAvail->iLeftTopAvail, pNeighAvail->iLeftTopType)) { //top_left
+    iSampleAvail[0] = 1;
+  }
+  if (IntraNeighAvail (pCtx, pNeighAvail->iTopAvail, pNeighAvail->iTopType)) { //top
+    iSampleAvail[1] =
+      iSampleAvail[2] =
+        iSampleAvail[3] =
+          iSampleAvail[4] = 1;
+  }
+  if (IntraNeighAvail (pCtx, pNeighAvail->iRightTopAvail, pNeighAvail->iRightTopType)) { //top_right
+    iSampleAvail[5] = 1;
+  }
+
+  uiNeighAvail = (iSampleAvail[6] << 2) | (iSampleAvail[0] << 1) | (iSampleAvail[1]);
+
+  for (i = 0; i < 16; i++) {
+    const int32_t kiPredMode = PredIntra4x4Mode (pIntraPredMode, i);
+    int8_t iBestMode;
+
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_PREV_INTRA_PRED_FLAG, uiCode));
+    if (uiCode) { //prev_intra4x4_pred_mode_flag
+      iBestMode = kiPredMode;
+    } else {
+      int32_t iRemMode = 0;
+      for (j = 0; j < 3; j++) { //rem_intra4x4_pred_mode, fixed length with LSB first
+        WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_REM_INTRA_PRED_MODE, uiCode));
+        iRemMode |= uiCode << j;
+      }
+      iBestMode = (iRemMode < kiPredMode) ? iRemMode : iRemMode + 1;
+    }
+
+    iFinalMode = CheckIntra4x4PredMode (&iSampleAvail[0], &iBestMode, i);
+    if (iFinalMode  == ERR_INVALID_INTRA4X4_MODE) {
+      return ERR_INFO_INVALID_I4x4_PRED_MODE;
+    }
+
+    pCurDqLayer->pIntra4x4FinalMode[iMbXy][g_kuiScan4[i]] = iFinalMode;
+
+    pIntraPredMode[g_kuiScan8[i]] = iBestMode;
+
+    iSampleAvail[g_kuiCache30ScanIdx[i]] = 1;
+  }
+  ST32 (&pCurDqLayer->pIntraPredMode[iMbXy][0], LD32 (&pIntraPredMode[1 + 8 * 4]));
+  pCurDqLayer->pIntraPredMode[iMbXy][4] = pIntraPredMode[4 + 8 * 1];
+  pCurDqLayer->pIntraPredMode[iMbXy][5] = pIntraPredMode[4 + 8 * 2];
+  pCurDqLayer->pIntraPredMode[iMbXy][6] = pIntraPredMode[4 + 8 * 3];
+
+  return ParseIntraChromaPredModeCabac (pCtx, pNeighAvail, uiNeighAvail);
+}
+
+int32_t ParseIntra16x16ModeCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail) {
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  int32_t iMbXy = pCurDqLayer->iMbXyIndex;
+  uint8_t uiNeighAvail = 0; //0x07 = 0 1 1 1, means left, top-left, top avail or not. (1: avail, 0: unavail)
+
+  if (IntraNeighAvail (pCtx, pNeighAvail->iLeftAvail, pNeighAvail->iLeftType)) {
+    uiNeighAvail = (1 << 2);
+  }
+  if (IntraNeighAvail (pCtx, pNeighAvail->iLeftTopAvail, pNeighAvail->iLeftTopType)) {
+    uiNeighAvail |= (1 << 1);
+  }
+  if (IntraNeighAvail (pCtx, pNeighAvail->iTopAvail, pNeighAvail->iTopType)) {
+    uiNeighAvail |= 1;
+  }
+
+  if (CheckIntra16x16PredMode (uiNeighAvail,
+                               &pCurDqLayer->pIntraPredMode[iMbXy][7])) { //invalid iPredMode, must stop decoding
+    return ERR_INFO_INVALID_I16x16_PRED_MODE;
+  }
+
+  return ParseIntraChromaPredModeCabac (pCtx, pNeighAvail, uiNeighAvail);
+}
+
+static int32_t ParseRefIdxCabac (PWelsCabacDecEngine pEngine, const int8_t* kpRefCtxCache, const int32_t kiCacheIdx,
+                                 const int32_t kiRefCount, int32_t& iRefIdx) {
+  int32_t iCtx = CTX_OFFSET_REF_IDX + (kpRefCtxCache[kiCacheIdx - 1] > 0) + ((kpRefCtxCache[kiCacheIdx - 6] > 0) << 1);
+  uint32_t uiCode;
+
+  iRefIdx = 0;
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, iCtx, uiCode));
+  iCtx = CTX_OFFSET_REF_IDX + 4;
+  while (uiCode) { //unary
+    if (++ iRefIdx >= kiRefCount) {
+      return ERR_INFO_INVALID_REF_INDEX;
+    }
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, iCtx, uiCode));
+    iCtx = CTX_OFFSET_REF_IDX + 5;
+  }
+  return ERR_NONE;
+}
+
+static int32_t ParseMvdCompCabac (PWelsCabacDecEngine pEngine, const int32_t kiCtxOffset, const int32_t kiAbsMvdSum,
+                                  int16_t& iMvd) {
+  int32_t iCtxInc = (kiAbsMvdSum < 3) ? 0 : ((kiAbsMvdSum > 32) ? 2 : 1);
+  int32_t iAbsMvd = 0;
+  uint32_t uiCode;
+
+  iMvd = 0;
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtxOffset + iCtxInc, uiCode));
+  if (0 == uiCode) {
+    return ERR_NONE;
+  }
+  // UEG3 with signedValFlag = 1 and uCoff = 9, truncated unary prefix with ctxIdxInc 3, 4, 5, 6, 6, ...
+  iAbsMvd = 1;
+  iCtxInc = 3;
+  do {
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtxOffset + iCtxInc, uiCode));
+    if (0 == uiCode) {
+      break;
+    }
+    if (iCtxInc < 6) {
+      ++ iCtxInc;
+    }
+  } while (++ iAbsMvd < 9);
+  if (9 == iAbsMvd) {
+    uint32_t uiSuffix;
+    WELS_READ_VERIFY (WelsCabacDecUeBypass (pEngine, 3, uiSuffix));
+    if (uiSuffix > MAX_MVD_SUFFIX) {
+      return ERR_INFO_CABAC_INVALID_MB_DATA;
+    }
+    iAbsMvd += uiSuffix;
+  }
+  WELS_READ_VERIFY (WelsCabacDecBypass (pEngine, uiCode));
+  iMvd = uiCode ? -iAbsMvd : iAbsMvd;
+  return ERR_NONE;
+}
+
+/*
+ *	mvd of a partition, uiMvdCache keeps the absolute mvd of neighbouring 4x4 blocks for contexts and is
+ *	updated over the partition of kiWidth x kiHeight 4x4 blocks
+ */
+static int32_t ParseMvdCabac (PWelsCabacDecEngine pEngine, uint8_t uiMvdCache[30][MV_A], const int32_t kiCacheIdx,
+                              const int32_t kiWidth, const int32_t kiHeight, int16_t iMvd[MV_A]) {
+  int32_t i, j;
+  uint8_t uiAbsMvd[MV_A];
+
+  WELS_READ_VERIFY (ParseMvdCompCabac (pEngine, CTX_OFFSET_MVD_X,
+                                       uiMvdCache[kiCacheIdx - 1][0] + uiMvdCache[kiCacheIdx - 6][0], iMvd[0]));
+  WELS_READ_VERIFY (ParseMvdCompCabac (pEngine, CTX_OFFSET_MVD_Y,
+                                       uiMvdCache[kiCacheIdx - 1][1] + uiMvdCache[kiCacheIdx - 6][1], iMvd[1]));
+
+  // only sums below 3 and above 32 are told apart in contexts, so 8 bits are plenty
+  uiAbsMvd[0] = WELS_MIN (WELS_ABS (iMvd[0]), 127);
+  uiAbsMvd[1] = WELS_MIN (WELS_ABS (iMvd[1]), 127);
+  for (j = 0; j < kiHeight; j++) {
+    for (i = 0; i < kiWidth; i++) {
+      ST16 (uiMvdCache[kiCacheIdx + 6 * j + i], LD16 (uiAbsMvd));
+    }
+  }
+  return ERR_NONE;
+}
+
+static inline void FillRefCtxCache (int8_t* pRefCtxCache, const int32_t kiCacheIdx, const int32_t kiWidth,
+                                    const int32_t kiHeight, const int8_t kiRefIdx) {
+  int32_t j;
+  for (j = 0; j < kiHeight; j++) {
+    memset (&pRefCtxCache[kiCacheIdx + 6 * j], kiRefIdx, kiWidth);
+  }
+}
+
+int32_t ParseInterInfoCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, int16_t iMvArray[LIST_A][30][MV_A],
+                             int8_t iRefIdxArray[LIST_A][30]) {
+  PWelsCabacDecEngine pEngine	= &pCtx->sCabacDecEngine;
+  PSlice pSlice				= &pCtx->pCurDqLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader	= &pSlice->sSliceHeaderExt.sSliceHeader;
+  PPicture* ppRefPic = pCtx->sRefPic.pRefList[LIST_0];
+  const int32_t kiRefCount	= pSliceHeader->uiRefCount[0];
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  int32_t i, j;
+  int32_t iMbXy = pCurDqLayer->iMbXyIndex;
+  int16_t iMv[2] = {0};
+  int16_t iMvd[2];
+  int16_t iMinVmv = pSliceHeader->pSps->pSLevelLimits->iMinVmv;
+  int16_t iMaxVmv = pSliceHeader->pSps->pSLevelLimits->iMaxVmv;
+  int32_t iRefIdx[4] = {0};
+  // ref_idx for contexts apart from iRefIdxArray, which is updated with the motion of each partition in prediction
+  int8_t iRefCtxCache[30];
+  uint8_t uiMvdCache[30][MV_A];
+
+  if (pSlice->sSliceHeaderExt.bAdaptiveMotionPredFlag || pSlice->sSliceHeaderExt.bDefaultMotionPredFlag) {
+    WelsLog (pCtx, WELS_LOG_WARNING, "inter parse: iMotionPredFlag = 1 not supported. \n");
+    return GENERATE_ERROR_NO (ERR_LEVEL_MB_DATA, ERR_INFO_UNSUPPORTED_ILP);
+  }
+
+  memcpy (iRefCtxCache, iRefIdxArray[LIST_0], sizeof (iRefCtxCache));
+  memset (uiMvdCache, 0, sizeof (uiMvdCache));
+  if (pNeighAvail->iTopAvail) {
+    memcpy (uiMvdCache[1], pCurDqLayer->pMvd[LIST_0][iMbXy - pCurDqLayer->iMbWidth][12], 4 * MV_A);
+  }
+  if (pNeighAvail->iLeftAvail) {
+    for (j = 0; j < 4; j++) {
+      ST16 (uiMvdCache[6 * (j + 1)], LD16 (pCurDqLayer->pMvd[LIST_0][iMbXy - 1][3 + (j << 2)]));
+    }
+  }
+
+  switch (pCurDqLayer->pMbType[iMbXy]) {
+  case MB_TYPE_16x16:
+    if (kiRefCount > 1) {
+      WELS_READ_VERIFY (ParseRefIdxCabac (pEngine, iRefCtxCache, 7, kiRefCount, iRefIdx[0]));
+    }
+    if (ppRefPic[iRefIdx[0]] == NULL) {
+      return ERR_INFO_INVALID_REF_INDEX;
+    }
+    PredMv (iMvArray, iRefIdxArray, 0, 4, iRefIdx[0], iMv);
+
+    WELS_READ_VERIFY (ParseMvdCabac (pEngine, uiMvdCache, 7, 4, 4, iMvd));
+    iMv[0] += iMvd[0];
+    iMv[1] += iMvd[1];
+    WELS_CHECK_SE_BOTH_WARNING (iMv[1], iMinVmv, iMaxVmv, "vertical mv");
+    UpdateP16x16MotionInfo (pCurDqLayer, iRefIdx[0], iMv);
+    break;
+  case MB_TYPE_16x8:
+    for (i = 0; i < 2; i++) {
+      const uint8_t kuiCacheIdx = g_kuiCache30ScanIdx[i << 3];
+      if (kiRefCount > 1) {
+        WELS_READ_VERIFY (ParseRefIdxCabac (pEngine, iRefCtxCache, kuiCacheIdx, kiRefCount, iRefIdx[i]));
+        FillRefCtxCache (iRefCtxCache, kuiCacheIdx, 4, 2, iRefIdx[i]);
+      }
+      if (ppRefPic[iRefIdx[i]] == NULL) {
+        return ERR_INFO_INVALID_REF_INDEX;
+      }
+    }
+    for (i = 0; i < 2; i++) {
+      PredInter16x8Mv (iMvArray, iRefIdxArray, i << 3, iRefIdx[i], iMv);
+
+      WELS_READ_VERIFY (ParseMvdCabac (pEngine, uiMvdCache, g_kuiCache30ScanIdx[i << 3], 4, 2, iMvd));
+      iMv[0] += iMvd[0];
+      iMv[1] += iMvd[1];
+      WELS_CHECK_SE_BOTH_WARNING (iMv[1], iMinVmv, iMaxVmv, "vertical mv");
+      UpdateP16x8MotionInfo (pCurDqLayer, iMvArray, iRefIdxArray, i << 3, iRefIdx[i], iMv);
+    }
+    break;
+  case MB_TYPE_8x16:
+    for (i = 0; i < 2; i++) {
+      const uint8_t kuiCacheIdx = g_kuiCache30ScanIdx[i << 2];
+      if (kiRefCount > 1) {
+        WELS_READ_VERIFY (ParseRefIdxCabac (pEngine, iRefCtxCache, kuiCacheIdx, kiRefCount, iRefIdx[i]));
+        FillRefCtxCache (iRefCtxCache, kuiCacheIdx, 2, 4, iRefIdx[i]);
+      }
+      if (ppRefPic[iRefIdx[i]] == NULL) {
+        return ERR_INFO_INVALID_REF_INDEX;
+      }
+    }
+    for (i = 0; i < 2; i++) {
+      PredInter8x16Mv (iMvArray, iRefIdxArray, i << 2, iRefIdx[i], iMv);
+
+      WELS_READ_VERIFY (ParseMvdCabac (pEngine, uiMvdCache, g_kuiCache30ScanIdx[i << 2], 2, 4, iMvd));
+      iMv[0] += iMvd[0];
+      iMv[1] += iMvd[1];
+      WELS_CHECK_SE_BOTH_WARNING (iMv[1], iMinVmv, iMaxVmv, "vertical mv");
+      UpdateP8x16MotionInfo (pCurDqLayer, iMvArray, iRefIdxArray, i << 2, iRefIdx[i], iMv);
+    }
+    break;
+  case MB_TYPE_8x8: {
+    int32_t iSubPartCount[4], iPartWidth[4];
+    uint32_t uiSubMbType;
+
+    //uiSubMbType, partition
+    for (i = 0; i < 4; i++) {
+      WELS_READ_VERIFY (ParseSubMBTypeCabac (pEngine, uiSubMbType));
+      pCurDqLayer->pSubMbType[iMbXy][i] = g_ksInterSubMbTypeInfo[uiSubMbType].iType;
+      iSubPartCount[i] = g_ksInterSubMbTypeInfo[uiSubMbType].iPartCount;
+      iPartWidth[i] = g_ksInterSubMbTypeInfo[uiSubMbType].iPartWidth;
+    }
+
+    //iRefIdxArray
+    for (i = 0; i < 4; i++) {
+      const uint8_t kuiCacheIdx = g_kuiCache30ScanIdx[i << 2];
+      const uint8_t kuiScan4Idx = g_kuiScan4[i << 2];
+      if (kiRefCount > 1) {
+        WELS_READ_VERIFY (ParseRefIdxCabac (pEngine, iRefCtxCache, kuiCacheIdx, kiRefCount, iRefIdx[i]));
+        FillRefCtxCache (iRefCtxCache, kuiCacheIdx, 2, 2, iRefIdx[i]);
+      }
+      if (ppRefPic[iRefIdx[i]] == NULL) {
+        return ERR_INFO_INVALID_REF_INDEX;
+      }
+      pCurDqLayer->pRefIndex[0][iMbXy][kuiScan4Idx  ] = pCurDqLayer->pRefIndex[0][iMbXy][kuiScan4Idx + 1] =
+            pCurDqLayer->pRefIndex[0][iMbXy][kuiScan4Idx + 4] = pCurDqLayer->pRefIndex[0][iMbXy][kuiScan4Idx + 5] = iRefIdx[i];
+    }
+
+    //gain mv and update mv cache
+    for (i = 0; i < 4; i++) {
+      int8_t iPartCount = iSubPartCount[i];
+      uint32_t uiSubMbType = pCurDqLayer->pSubMbType[iMbXy][i];
+      int16_t iPartIdx, iBlockWidth = iPartWidth[i], iIdx = i << 2;
+      int16_t iBlockHeight = (SUB_MB_TYPE_8x8 == uiSubMbType || SUB_MB_TYPE_4x8 == uiSubMbType) ? 2 : 1;
+      uint8_t uiScan4Idx, uiCacheIdx;
+
+      uint8_t uiIdx4Cache = g_kuiCache30ScanIdx[iIdx];
+
+      iRefIdxArray[0][uiIdx4Cache  ] = iRefIdxArray[0][uiIdx4Cache + 1] =
+                                         iRefIdxArray[0][uiIdx4Cache + 6] = iRefIdxArray[0][uiIdx4Cache + 7] = iRefIdx[i];
+
+      for (j = 0; j < iPartCount; j++) {
+        iPartIdx = iIdx + j * iBlockWidth;
+        uiScan4Idx = g_kuiScan4[iPartIdx];
+        uiCacheIdx = g_kuiCache30ScanIdx[iPartIdx];
+        PredMv (iMvArray, iRefIdxArray, iPartIdx, iBlockWidth, iRefIdx[i], iMv);
+
+        WELS_READ_VERIFY (ParseMvdCabac (pEngine, uiMvdCache, uiCacheIdx, iBlockWidth, iBlockHeight, iMvd));
+        iMv[0] += iMvd[0];
+        iMv[1] += iMvd[1];
+        WELS_CHECK_SE_BOTH_WARNING (iMv[1], iMinVmv, iMaxVmv, "vertical mv");
+        if (SUB_MB_TYPE_8x8 == uiSubMbType) {
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx], LD32 (iMv));
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx + 1], LD32 (iMv));
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx + 4], LD32 (iMv));
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx + 5], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx  ], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx + 1], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx + 6], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx + 7], LD32 (iMv));
+        } else if (SUB_MB_TYPE_8x4 == uiSubMbType) {
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx  ], LD32 (iMv));
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx + 1], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx  ], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx + 1], LD32 (iMv));
+        } else if (SUB_MB_TYPE_4x8 == uiSubMbType) {
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx  ], LD32 (iMv));
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx + 4], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx  ], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx + 6], LD32 (iMv));
+        } else { //SUB_MB_TYPE_4x4 == uiSubMbType
+          ST32 (pCurDqLayer->pMv[0][iMbXy][uiScan4Idx  ], LD32 (iMv));
+          ST32 (iMvArray[0][uiCacheIdx  ], LD32 (iMv));
+        }
+      }
+    }
+  }
+  break;
+  default:
+    return ERR_INFO_INVALID_MB_TYPE;
+  }
+
+  // keep the absolute mvd of the MB for contexts of the right and bottom neighbours
+  for (j = 0; j < 4; j++) {
+    memcpy (pCurDqLayer->pMvd[LIST_0][iMbXy][j << 2], uiMvdCache[7 + 6 * j], 4 * MV_A);
+  }
+
+  return ERR_NONE;
+}
+
+int32_t ParseCbpInfoCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint32_t& uiCbp) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  const int32_t kiMbXy = pCurDqLayer->iMbXyIndex;
+  // unavailable MBs act as all luma coded and no chroma, cbp of P_Skip is 0 and of I_PCM is 0x2f
+  const int32_t kiCbpLeft = pNeighAvail->iLeftAvail ? pCurDqLayer->pCbp[kiMbXy - 1] : 0x0F;
+  const int32_t kiCbpTop  = pNeighAvail->iTopAvail ? pCurDqLayer->pCbp[kiMbXy - pCurDqLayer->iMbWidth] : 0x0F;
+  uint32_t uiCbpLuma = 0, uiCbpChroma = 0, uiCode;
+  int32_t iCtxInc, iIdx8;
+
+  for (iIdx8 = 0; iIdx8 < 4; iIdx8++) {
+    const int32_t kiCbpA = (iIdx8 & 1) ? uiCbpLuma : kiCbpLeft;	// 8x8 blocks inside the MB read the bins decoded
+    const int32_t kiCbpB = (iIdx8 & 2) ? uiCbpLuma : kiCbpTop;
+    iCtxInc = ! ((kiCbpA >> (iIdx8 ^ 1)) & 1) + ((! ((kiCbpB >> (iIdx8 ^ 2)) & 1)) << 1);
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_CBP_LUMA + iCtxInc, uiCode));
+    uiCbpLuma |= uiCode << iIdx8;
+  }
+
+  iCtxInc = ((kiCbpLeft >> 4) != 0) + (((kiCbpTop >> 4) != 0) << 1);
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_CBP_CHROMA + iCtxInc, uiCode));
+  if (uiCode) {
+    iCtxInc = 4 + ((kiCbpLeft >> 4) == 2) + (((kiCbpTop >> 4) == 2) << 1);
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_CBP_CHROMA + iCtxInc, uiCode));
+    uiCbpChroma = 1 + uiCode;
+  }
+
+  uiCbp = uiCbpLuma | (uiCbpChroma << 4);
+  return ERR_NONE;
+}
+
+int32_t ParseDeltaQpCabac (PWelsDecoderContext pCtx, int32_t& iQpDelta) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  PSlice pSlice = &pCtx->pCurDqLayer->sLayerInfo.sSliceInLayer;
+  int32_t iCtx = CTX_OFFSET_MB_QP_DELTA + (pSlice->iLastDeltaQp != 0);
+  int32_t iCode = 0;
+  uint32_t uiCode;
+
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, iCtx, uiCode));
+  iCtx = CTX_OFFSET_MB_QP_DELTA + 2;
+  while (uiCode) { //unary of the mapped value of Table 9-3
+    if (++ iCode > 52) {
+      return ERR_INFO_INVALID_QP;
+    }
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, iCtx, uiCode));
+    iCtx = CTX_OFFSET_MB_QP_DELTA + 3;
+  }
+
+  iQpDelta = (iCode + 1) >> 1;
+  if (0 == (iCode & 1)) {
+    iQpDelta = -iQpDelta;
+  }
+  pSlice->iLastDeltaQp = iQpDelta;
+  return ERR_NONE;
+}
+
+int32_t ParseResidualBlockCabac (PWelsDecoderContext pCtx, PNeighAvail pNeighAvail, uint8_t* pNonZeroCountCache,
+                                 int32_t iIndex, int32_t iMaxNumCoeff, const uint8_t* pScanTable, int32_t iResProperty,
+                                 int16_t* pTCoeff, uint8_t uiQp) {
+  PWelsCabacDecEngine pEngine = &pCtx->sCabacDecEngine;
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  const int32_t kiMbXy = pCurDqLayer->iMbXyIndex;
+  const int32_t kiBlockCat = iResProperty - 1;
+  const int32_t kiSigCtx = CTX_OFFSET_SIG_COEFF_FLAG + g_kuiSigCoeffCtxOffset[kiBlockCat];
+  const int32_t kiLastCtx = CTX_OFFSET_LAST_SIG_COEFF_FLAG + g_kuiSigCoeffCtxOffset[kiBlockCat];
+  const int32_t kiAbsCtx = CTX_OFFSET_COEFF_ABS_LEVEL + g_kuiAbsLevelCtxOffset[kiBlockCat];
+  const int32_t kiGt1CtxMax = (CHROMA_DC == iResProperty) ? 3 : 4;
+  const bool kbChromaDc = (CHROMA_DC == iResProperty);
+  const bool kbDc = (I16_LUMA_DC == iResProperty || kbChromaDc);
+  // coded_block_flag of blocks in MBs unavailable is inferred as 1 for intra MB and 0 for inter MB
+  const int32_t kiCbfUnavail = IS_INTRA (pCurDqLayer->pMbType[kiMbXy]) ? 1 : 0;
+  const uint16_t* kpDequantCoeff = g_kuiDequantCoeff[uiQp];
+  const int32_t kiCacheIdx = g_kuiCacheNzcScanIdx[iIndex];
+  uint8_t uiCbfDcMask = 0;
+  int32_t iSigIdx[16];
+  int32_t iSigCount = 0, iNumEq1 = 0, iNumGt1 = 0;
+  int32_t iCtxInc, i;
+  uint32_t uiCode;
+
+  //coded_block_flag
+  if (kbDc) {
+    uiCbfDcMask = (I16_LUMA_DC == iResProperty) ? CBF_DC_LUMA : ((16 == iIndex) ? CBF_DC_CB : CBF_DC_CR);
+    iCtxInc  = pNeighAvail->iLeftAvail ? ((pCurDqLayer->pCbfDc[kiMbXy - 1] & uiCbfDcMask) != 0) : kiCbfUnavail;
+    iCtxInc += (pNeighAvail->iTopAvail ? ((pCurDqLayer->pCbfDc[kiMbXy - pCurDqLayer->iMbWidth] & uiCbfDcMask) != 0) :
+                kiCbfUnavail) << 1;
+  } else {
+    const uint8_t kuiNzcA = pNonZeroCountCache[kiCacheIdx - 1];
+    const uint8_t kuiNzcB = pNonZeroCountCache[kiCacheIdx - 8];
+    iCtxInc  = (0xFF == kuiNzcA) ? kiCbfUnavail : (kuiNzcA != 0);
+    iCtxInc += ((0xFF == kuiNzcB) ? kiCbfUnavail : (kuiNzcB != 0)) << 1;
+  }
+  WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, CTX_OFFSET_CODED_BLOCK_FLAG + g_kuiCbfCtxOffset[kiBlockCat] + iCtxInc,
+                    uiCode));
+  if (0 == uiCode) {
+    if (!kbDc) {
+      pNonZeroCountCache[kiCacheIdx] = 0;
+    }
+    return ERR_NONE;
+  }
+  if (kbDc) {
+    pCurDqLayer->pCbfDc[kiMbXy] |= uiCbfDcMask;
+  }
+
+  //significance map, the last coefficient is inferred significant when reached
+  for (i = 0; i < iMaxNumCoeff - 1; i++) {
+    iCtxInc = kbChromaDc ? WELS_MIN (i, 2) : i;
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiSigCtx + iCtxInc, uiCode));
+    if (uiCode) {
+      iSigIdx[iSigCount++] = i;
+      WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiLastCtx + iCtxInc, uiCode));
+      if (uiCode) {
+        break;
+      }
+    }
+  }
+  if (i == iMaxNumCoeff - 1) {
+    iSigIdx[iSigCount++] = i;
+  }
+
+  //levels in reverse scanning order
+  for (i = iSigCount - 1; i >= 0; i--) {
+    int32_t iAbsLevelMinus1 = 0;
+    int32_t iLevel, j;
+
+    WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiAbsCtx + ((iNumGt1 != 0) ? 0 : WELS_MIN (4, 1 + iNumEq1)),
+                      uiCode));
+    if (uiCode) {
+      const int32_t kiCtx = kiAbsCtx + 5 + WELS_MIN (kiGt1CtxMax, iNumGt1);
+      iAbsLevelMinus1 = 1;
+      while (iAbsLevelMinus1 < 14) { //truncated unary prefix of UEG0, uCoff = 14
+        WELS_READ_VERIFY (WelsCabacDecDecision (pEngine, kiCtx, uiCode));
+        if (0 == uiCode) {
+          break;
+        }
+        ++ iAbsLevelMinus1;
+      }
+      if (14 == iAbsLevelMinus1) {
+        uint32_t uiSuffix;
+        WELS_READ_VERIFY (WelsCabacDecUeBypass (pEngine, 0, uiSuffix));
+        if (uiSuffix > MAX_COEFF_ABS_LEVEL_SUFFIX) {
+          return ERR_INFO_CABAC_INVALID_MB_DATA;
+        }
+        iAbsLevelMinus1 += uiSuffix;
+      }
+      ++ iNumGt1;
+    } else {
+      ++ iNumEq1;
+    }
+    WELS_READ_VERIFY (WelsCabacDecBypass (pEngine, uiCode)); //coeff_sign_flag
+    iLevel = uiCode ? - (iAbsLevelMinus1 + 1) : (iAbsLevelMinus1 + 1);
+
+    j = pScanTable[iSigIdx[i]];
+    if (I16_LUMA_DC == iResProperty) { //scaled along with the transform
+      pTCoeff[j] = iLevel;
+    } else if (kbChromaDc) {
+      pTCoeff[j] = iLevel * kpDequantCoeff[0];
+    } else {
+      pTCoeff[j] = iLevel * kpDequantCoeff[j & 0x07];
+    }
+  }
+
+  if (!kbDc) {
+    pNonZeroCountCache[kiCacheIdx] = iSigCount;
+  }
+  return ERR_NONE;
+}
+
+} // namespace WelsDec
@@ -46,18 +46,15 @@
 namespace WelsDec {
 #define MAX_LEVEL_PREFIX 15
 void GetNeighborAvailMbType (PNeighAvail pNeighAvail, PDqLayer pCurLayer) {
-  int32_t iCurSliceIdc, iTopSliceIdc, iLeftTopSliceIdc, iRightTopSliceIdc, iLeftSliceIdc;
   int32_t iCurXy, iTopXy, iLeftXy, iLeftTopXy, iRightTopXy;
   int32_t iCurX, iCurY;
 
   iCurXy = pCurLayer->iMbXyIndex;
   iCurX  = pCurLayer->iMbX;
   iCurY  = pCurLayer->iMbY;
-  iCurSliceIdc = pCurLayer->pSliceIdc[iCurXy];
   if (iCurX != 0) {
     iLeftXy = iCurXy - 1;
-    iLeftSliceIdc = pCurLayer->pSliceIdc[iLeftXy];
-    pNeighAvail->iLeftAvail = (iLeftSliceIdc == iCurSliceIdc);
+    pNeighAvail->iLeftAvail = IsNeighborInCurSlice (pCurLayer, iLeftXy);
   } else {
     pNeighAvail->iLeftAvail = 0;
     pNeighAvail->iLeftTopAvail = 0;
@@ -65,19 +62,16 @@ void GetNeighborAvailMbType (PNeighAvail pNeighAvail, PDqLayer pCurLayer) {
 
   if (iCurY != 0) {
     iTopXy = iCurXy - pCurLayer->iMbWidth;
-    iTopSliceIdc = pCurLayer->pSliceIdc[iTopXy];
-    pNeighAvail->iTopAvail = (iTopSliceIdc == iCurSliceIdc);
+    pNeighAvail->iTopAvail = IsNeighborInCurSlice (pCurLayer, iTopXy);
     if (iCurX != 0) {
       iLeftTopXy = iTopXy - 1;
-      iLeftTopSliceIdc = pCurLayer->pSliceIdc[iLeftTopXy];
-      pNeighAvail->iLeftTopAvail = (iLeftTopSliceIdc == iCurSliceIdc);
+      pNeighAvail->iLeftTopAvail = IsNeighborInCurSlice (pCurLayer, iLeftTopXy);
     } else {
       pNeighAvail->iLeftTopAvail = 0;
     }
     if (iCurX != (pCurLayer->iMbWidth - 1)) {
       iRightTopXy = iTopXy + 1;
-      iRightTopSliceIdc = pCurLayer->pSliceIdc[iRightTopXy];
-      pNeighAvail->iRightTopAvail = (iRightTopSliceIdc == iCurSliceIdc);
+      pNeighAvail->iRightTopAvail = IsNeighborInCurSlice (pCurLayer, iRightTopXy);
     } else {
       pNeighAvail->iRightTopAvail = 0;
     }
@@ -59,6 +59,16 @@ void FreePicture (PPicture pPic);
 
 
 
+// planes of luma and chroma one after another in pBuffer, with PADDING_LENGTH borders
+static void AssignPicPlanes (PPicture pPic, uint8_t* pBuffer, const int32_t kiLumaSize, const int32_t kiChromaSize) {
+  pPic->pBuffer[0]	= pBuffer;
+  pPic->pBuffer[1]	= pPic->pBuffer[0] + kiLumaSize;
+  pPic->pBuffer[2]	= pPic->pBuffer[1] + kiChromaSize;
+  pPic->pData[0]	= pPic->pBuffer[0] + (1 + pPic->iLinesize[0]) * PADDING_LENGTH;
+  pPic->pData[1]	= pPic->pBuffer[1] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[1]) * PADDING_LENGTH) >> 1);
+  pPic->pData[2]	= pPic->pBuffer[2] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[2]) * PADDING_LENGTH) >> 1);
+}
+
 PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const int32_t kiPicHeight) {
   PPicture pPic = NULL;
   int32_t iPicWidth = 0;
@@ -81,19 +91,21 @@ PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const
 
   iLumaSize	= iPicWidth * iPicHeight;
   iChromaSize	= iPicChromaWidth * iPicChromaHeight;
-    pPic->pBuffer[0]	= static_cast<uint8_t*> (WelsMalloc (iLumaSize /* luma */
-                        + (iChromaSize << 1) /* Cb,Cr */, "_pic->buffer[0]"));
-
-    WELS_VERIFY_RETURN_PROC_IF (NULL, NULL == pPic->pBuffer[0], FreePicture (pPic));
-    pPic->iLinesize[0] = iPicWidth;
-    pPic->iLinesize[1] = pPic->iLinesize[2] = iPicChromaWidth;
-    pPic->pBuffer[1]	= pPic->pBuffer[0] + iLumaSize;
-    pPic->pBuffer[2]	= pPic->pBuffer[1] + iChromaSize;
-    pPic->pData[0]	= pPic->pBuffer[0] + (1 + pPic->iLinesize[0]) * PADDING_LENGTH;
-    pPic->pData[1]	= pPic->pBuffer[1] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[1]) * PADDING_LENGTH) >> 1);
-    pPic->pData[2]	= pPic->pBuffer[2] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[2]) * PADDING_LENGTH) >> 1);
-
-
+  pPic->iLinesize[0] = iPicWidth;
+  pPic->iLinesize[1] = pPic->iLinesize[2] = iPicChromaWidth;
+
+  if (NULL != pCtx->sFrameAllocator.pfnGetBuffer) {
+    // storage is got by PrefetchPic()
+    pPic->sExtBuffer.iSize		= iLumaSize + (iChromaSize << 1);
+    pPic->sExtBuffer.iWidth		= kiPicWidth;
+    pPic->sExtBuffer.iHeight	= kiPicHeight;
+  } else {
+    uint8_t* pBuffer = static_cast<uint8_t*> (WelsMalloc (iLumaSize /* luma */
+                       + (iChromaSize << 1) /* Cb,Cr */, "_pic->buffer[0]"));
+
+    WELS_VERIFY_RETURN_PROC_IF (NULL, NULL == pBuffer, FreePicture (pPic));
+    AssignPicPlanes (pPic, pBuffer, iLumaSize, iChromaSize);
+  }
 
   pPic->iPlanes		= 3;	// yv12 in default
   pPic->iWidthInPixel	= kiPicWidth;
@@ -107,7 +119,7 @@ PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const
 void FreePicture (PPicture pPic) {
   if (NULL != pPic) {
 
-    if (pPic->pBuffer[0]) {
+    if (pPic->pBuffer[0] && 0 == pPic->sExtBuffer.iSize) {
       WelsFree (pPic->pBuffer[0], "pPic->pBuffer[0]");
     }
 
@@ -116,6 +128,46 @@ void FreePicture (PPicture pPic) {
     pPic = NULL;
   }
 }
+
+void ReleasePicBuffer (PPicBuff pPicBuf, PPicture pPic) {
+  if (NULL == pPicBuf->pAllocator || NULL == pPic->sExtBuffer.pBuffer)
+    return;
+
+  if (NULL != pPicBuf->pAllocator->pfnReleaseBuffer)
+    pPicBuf->pAllocator->pfnReleaseBuffer (pPicBuf->pAllocator->pContext, &pPic->sExtBuffer);
+  pPic->sExtBuffer.pBuffer	= NULL;
+  pPic->sExtBuffer.pOpaque	= NULL;
+  memset (pPic->pBuffer, 0, sizeof (pPic->pBuffer));
+  memset (pPic->pData, 0, sizeof (pPic->pData));
+}
+
+static inline bool IsPicFree (PPicture pPic) {
+  return pPic != NULL && pPic->bAvailableFlag && !pPic->bUsedAsRef && 0 == pPic->uiRefCount;
+}
+
+/*
+ *	Storage of pictures freed since last prefetch goes back to the allocator, the prefetched one gets a new buffer
+ *	as the application may still be using the former one it was output in.
+ */
+static int32_t SwapPicBuffers (PPicBuff pPicBuf, PPicture pPic) {
+  const int32_t kiChromaSize = pPic->iLinesize[1] * (WELS_ALIGN (pPic->iHeightInPixel + (PADDING_LENGTH << 1),
+                               PICTURE_RESOLUTION_ALIGNMENT) >> 1);
+  int32_t iPicIdx = 0;
+
+  for (iPicIdx = 0; iPicIdx < pPicBuf->iCapacity; ++iPicIdx) {
+    if (IsPicFree (pPicBuf->ppPic[iPicIdx]))
+      ReleasePicBuffer (pPicBuf, pPicBuf->ppPic[iPicIdx]);
+  }
+
+  if (0 != pPicBuf->pAllocator->pfnGetBuffer (pPicBuf->pAllocator->pContext, &pPic->sExtBuffer)
+      || NULL == pPic->sExtBuffer.pBuffer || 0 != ((uintptr_t)pPic->sExtBuffer.pBuffer & 15)) {
+    pPic->sExtBuffer.pBuffer = NULL;
+    return 1;
+  }
+  AssignPicPlanes (pPic, pPic->sExtBuffer.pBuffer, pPic->sExtBuffer.iSize - (kiChromaSize << 1), kiChromaSize);
+  return 0;
+}
+
 PPicture PrefetchPic (PPicBuff pPicBuf) {
   int32_t iPicIdx = 0;
   PPicture pPic  = NULL;
@@ -125,25 +177,29 @@ PPicture PrefetchPic (PPicBuff pPicBuf) {
   }
 
   for (iPicIdx = pPicBuf->iCurrentIdx + 1; iPicIdx < pPicBuf->iCapacity ; ++iPicIdx) {
-    if (pPicBuf->ppPic[iPicIdx] != NULL && pPicBuf->ppPic[iPicIdx]->bAvailableFlag
-        && !pPicBuf->ppPic[iPicIdx]->bUsedAsRef) {
+    if (IsPicFree (pPicBuf->ppPic[iPicIdx])) {
       pPic = pPicBuf->ppPic[iPicIdx];
       break;
     }
   }
-  if (pPic != NULL) {
-    pPicBuf->iCurrentIdx = iPicIdx;
-    return pPic;
-  }
-  for (iPicIdx = 0 ; iPicIdx < pPicBuf->iCurrentIdx ; ++iPicIdx) {
-    if (pPicBuf->ppPic[iPicIdx] != NULL && pPicBuf->ppPic[iPicIdx]->bAvailableFlag
-        && !pPicBuf->ppPic[iPicIdx]->bUsedAsRef) {
-      pPic = pPicBuf->ppPic[iPicIdx];
-      break;
+  if (pPic == NULL) {
+    // the one prefetched last is left out with internal storage, its non-reference picture is reused as pDec instead;
+    // with an allocator pDec is dropped once output and its slot is as good as others
+    const int32_t kiEndIdx = pPicBuf->iCurrentIdx + (pPicBuf->pAllocator != NULL ? 1 : 0);
+    for (iPicIdx = 0 ; iPicIdx < kiEndIdx ; ++iPicIdx) {
+      if (IsPicFree (pPicBuf->ppPic[iPicIdx])) {
+        pPic = pPicBuf->ppPic[iPicIdx];
+        break;
+      }
     }
   }
 
+  if (pPic == NULL)
+    return NULL;
+
   pPicBuf->iCurrentIdx = iPicIdx;
+  if (pPicBuf->pAllocator != NULL && 0 != SwapPicBuffers (pPicBuf, pPic))
+    return NULL;
   return pPic;
 }
 
@@ -41,6 +41,7 @@
 
 #include "rec_mb.h"
 #include "decode_slice.h"
+#include "dec_multi_threading.h"
 
 namespace WelsDec {
 
@@ -181,6 +182,12 @@ typedef struct TagMCRefMember {
 
   int32_t iPicWidth;
   int32_t iPicHeight;
+
+#if defined(MT_ENABLED)
+  PDecReconSlot pReconSlot;	// not NULL when the reference may still be under reconstruction
+  PPicture pRefPic;
+  int32_t iRefIdx;
+#endif
 } sMCRefMember;
 //according to current 8*8 block ref_index to gain reference picture
 static inline void GetRefPic (sMCRefMember* pMCRefMem, PWelsDecoderContext pCtx, int8_t* pRefIdxList,
@@ -196,6 +203,10 @@ static inline void GetRefPic (sMCRefMember* pMCRefMem, PWelsDecoderContext pCtx,
   pMCRefMem->pSrcY = pRefPic->pData[0];
   pMCRefMem->pSrcU = pRefPic->pData[1];
   pMCRefMem->pSrcV = pRefPic->pData[2];
+#if defined(MT_ENABLED)
+  pMCRefMem->pRefPic = pRefPic;
+  pMCRefMem->iRefIdx = iRefIdx;
+#endif
 }
 
 
@@ -239,6 +250,13 @@ static inline void BaseMC (sMCRefMember* pMCRefMem, int32_t iXOffset, int32_t iY
 
   ENFORCE_STACK_ALIGN_1D (uint8_t, uiExpandBuf, (PADDING_LENGTH + 6) * (PADDING_LENGTH + 6), 16);
 
+#if defined(MT_ENABLED)
+  if (NULL != pMCRefMem->pReconSlot) {
+    // the lowest luma line read by 6-tap interpolation, chroma never reaches below it
+    WelsWaitRefPicLines (pMCRefMem->pReconSlot, pMCRefMem->pRefPic, pMCRefMem->iRefIdx, iIntMVy + iBlkHeight + 2);
+  }
+#endif
+
   if (iFullMVx & 0x07) {
     iExpandWidth -= 3;
   }
@@ -310,6 +328,9 @@ void GetInterPred (uint8_t* pPredY, uint8_t* pPredCb, uint8_t* pPredCr, PWelsDec
 
   pMCRefMem.iPicWidth = (pCurDqLayer->sLayerInfo.sSliceInLayer.sSliceHeaderExt.sSliceHeader.iMbWidth << 4);
   pMCRefMem.iPicHeight = (pCurDqLayer->sLayerInfo.sSliceInLayer.sSliceHeaderExt.sSliceHeader.iMbHeight << 4);
+#if defined(MT_ENABLED)
+  pMCRefMem.pReconSlot = pCtx->pReconSlot;
+#endif
 
   pMCRefMem.pDstY = pPredY;
   pMCRefMem.pDstU = pPredCb;
@@ -47,6 +47,7 @@
 #include "decoder_context.h"
 #include "welsCodecTrace.h"
 #include "cpu.h"
+#include "WelsThreadPool.h"
 
 class ISVCDecoder;
 
@@ -97,9 +98,16 @@ virtual DECODING_STATE EXTAPI DecodeFrameEx (const unsigned char* kpSrc,
 virtual long EXTAPI SetOption (DECODER_OPTION eOptID, void* pOption);
 virtual long EXTAPI GetOption (DECODER_OPTION eOptID, void* pOption);
 
+/* size of pictures decoded last, 0 before the first one, streams are grouped by it in WelsDecodeBatch() */
+void GetPictureSize (int32_t& iWidth, int32_t& iHeight) const;
+
  private:
 PWelsDecoderContext 				m_pDecContext;
 IWelsTrace*							m_pTrace;
+SDecodedRowsCallback				m_sDecodedRowsCallback;
+#if defined(MT_ENABLED)
+SWelsThreadPool*					m_pSharedPool;	// attached with bUseSharedThreadPool to keep the pool alive
+#endif//MT_ENABLED
 
 void InitDecoder (void);
 void UninitDecoder (void);
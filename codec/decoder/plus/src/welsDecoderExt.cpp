@@ -54,8 +54,10 @@ extern "C" {
 #include "decoder_core.h"
 #include "manage_dec_ref.h"
 }
+#include "dec_multi_threading.h"
 #include "error_code.h"
 #include "crt_util_safe_x.h"	// Safe CRT routines like util for cross platforms
+#include <stdlib.h>
 #include <time.h>
 #if defined(_WIN32) /*&& defined(_DEBUG)*/
 
@@ -86,6 +88,10 @@ namespace WelsDec {
 CWelsDecoder::CWelsDecoder (void)
   :	m_pDecContext (NULL),
     m_pTrace (NULL) {
+  memset (&m_sDecodedRowsCallback, 0, sizeof (SDecodedRowsCallback));
+#if defined(MT_ENABLED)
+  m_pSharedPool = NULL;
+#endif//MT_ENABLED
 #ifdef OUTPUT_BIT_STREAM
   char chFileName[1024] = { 0 };  //for .264
   int iBufUsed = 0;
@@ -197,6 +203,13 @@ long CWelsDecoder::Initialize (const SDecodingParam* pParam) {
 
   DecoderConfigParam (m_pDecContext, pParam);
 
+#if defined(MT_ENABLED)
+  if (pParam->bUseSharedThreadPool && NULL == m_pSharedPool
+      && WELS_THREAD_ERROR_OK != WelsThreadPoolAttachShared (&m_pSharedPool)) {
+    m_pSharedPool = NULL;
+  }
+#endif//MT_ENABLED
+
   return cmResultSuccess;
 }
 
@@ -220,6 +233,13 @@ void CWelsDecoder::UninitDecoder (void) {
     m_pDecContext	= NULL;
   }
 
+#if defined(MT_ENABLED)
+  if (NULL != m_pSharedPool) {
+    WelsThreadPoolDetachShared (m_pSharedPool);
+    m_pSharedPool = NULL;
+  }
+#endif//MT_ENABLED
+
   IWelsTrace::WelsVTrace (m_pTrace, IWelsTrace::WELS_LOG_INFO, "left CWelsDecoder::uninit_decoder()..");
 }
 
@@ -234,6 +254,31 @@ void CWelsDecoder::InitDecoder (void) {
   IWelsTrace::WelsVTrace (m_pTrace, IWelsTrace::WELS_LOG_INFO, "CWelsDecoder::init_decoder().. left");
 }
 
+/*
+ *	MB rows finished by decoder core are passed to application as lines of the cropped picture
+ */
+static void DecodedMbRowsFinished (void* pArg, PPicture pPic, int32_t iMbWidth, int32_t iMbHeight, int32_t iMbRowStart,
+                                   int32_t iMbRowEnd) {
+  SDecodedRowsCallback* pCallback = (SDecodedRowsCallback*)pArg;
+  const SPosOffset* kpCrop = &pPic->sFrameCrop;
+  SDecodedRows sRows;
+
+  sRows.iWidth		= (iMbWidth << 4) - ((kpCrop->iLeftOffset + kpCrop->iRightOffset) << 1);
+  sRows.iHeight		= (iMbHeight << 4) - ((kpCrop->iTopOffset + kpCrop->iBottomOffset) << 1);
+  sRows.iLineStart	= WELS_MAX ((iMbRowStart << 4) - (kpCrop->iTopOffset << 1), 0);
+  sRows.iLineEnd		= WELS_MIN ((iMbRowEnd << 4) - (kpCrop->iTopOffset << 1), sRows.iHeight);
+  if (sRows.iLineEnd <= sRows.iLineStart)
+    return;
+
+  sRows.iStride[0]	= pPic->iLinesize[0];
+  sRows.iStride[1]	= pPic->iLinesize[1];
+  sRows.pData[0]		= pPic->pData[0] + kpCrop->iTopOffset * 2 * pPic->iLinesize[0] + kpCrop->iLeftOffset * 2;
+  sRows.pData[1]		= pPic->pData[1] + kpCrop->iTopOffset * pPic->iLinesize[1] + kpCrop->iLeftOffset;
+  sRows.pData[2]		= pPic->pData[2] + kpCrop->iTopOffset * pPic->iLinesize[1] + kpCrop->iLeftOffset;
+
+  pCallback->pfnDecodedRows (pCallback->pContext, &sRows);
+}
+
 /*
  * Set Option
  */
@@ -258,6 +303,24 @@ long CWelsDecoder::SetOption (DECODER_OPTION eOptID, void* pOption) {
 
     m_pDecContext->bEndOfStreamFlag	= iVal ? true : false;
 
+    return cmResultSuccess;
+  } else if (eOptID == DECODER_OPTION_ROWS_CALLBACK) { // Set callback of rows finished before the frame is output
+    if (pOption == NULL)
+      return cmInitParaError;
+
+    memcpy (&m_sDecodedRowsCallback, pOption, sizeof (SDecodedRowsCallback));
+    m_pDecContext->pfMbRowsFinished	= (NULL != m_sDecodedRowsCallback.pfnDecodedRows) ? DecodedMbRowsFinished : NULL;
+    m_pDecContext->pMbRowsFinishedArg	= &m_sDecodedRowsCallback;
+
+    return cmResultSuccess;
+  } else if (eOptID == DECODER_OPTION_FRAME_ALLOCATOR) { // Set storage of pictures from application
+    if (pOption == NULL)
+      return cmInitParaError;
+    if (m_pDecContext->bHaveGotMemory)	// pictures are allocated already
+      return cmInitExpected;
+
+    memcpy (&m_pDecContext->sFrameAllocator, pOption, sizeof (SFrameAllocator));
+
     return cmResultSuccess;
   }
 
@@ -348,6 +411,10 @@ DECODING_STATE CWelsDecoder::DecodeFrame2 (const unsigned char* kpSrc,
   }
 
   ppDst[0] = ppDst[1] = ppDst[2] = NULL;
+#if defined(MT_ENABLED)
+  if (NULL != m_pDecContext->pThreadCtx)
+    WelsReleaseOutputPic (m_pDecContext);	// picture output by last call is no longer in use by caller
+#endif//MT_ENABLED
   m_pDecContext->iErrorCode             = dsErrorFree; //initialize at the starting of AU decoding.
   m_pDecContext->iFeedbackVclNalInAu = FEEDBACK_UNKNOWN_NAL; //initialize
   memset (pDstInfo, 0, sizeof (SBufferInfo));
@@ -388,6 +455,11 @@ DECODING_STATE CWelsDecoder::DecodeFrame2 (const unsigned char* kpSrc,
     return (DECODING_STATE)m_pDecContext->iErrorCode;
   }
 
+#if defined(MT_ENABLED)
+  if (NULL != m_pDecContext->pThreadCtx)
+    WelsFetchOutputPic (m_pDecContext, (uint8_t**)ppDst, pDstInfo);
+#endif//MT_ENABLED
+
   return dsErrorFree;
 }
 
@@ -417,6 +489,11 @@ DECODING_STATE CWelsDecoder::DecodeFrame (const unsigned char* kpSrc,
   return eDecState;
 }
 
+void CWelsDecoder::GetPictureSize (int32_t& iWidth, int32_t& iHeight) const {
+  iWidth	= (NULL != m_pDecContext) ? m_pDecContext->iImgWidthInPixel : 0;
+  iHeight	= (NULL != m_pDecContext) ? m_pDecContext->iImgHeightInPixel : 0;
+}
+
 DECODING_STATE CWelsDecoder::DecodeFrameEx (const unsigned char* kpSrc,
     const int kiSrcLen,
     unsigned char* pDst,
@@ -425,11 +502,190 @@ DECODING_STATE CWelsDecoder::DecodeFrameEx (const unsigned char* kpSrc,
     int& iWidth,
     int& iHeight,
     int& iColorFormat) {
-  DECODING_STATE	 state = dsErrorFree;
+  DECODING_STATE eDecState = dsErrorFree;
+  SBufferInfo    DstInfo;
+  uint8_t*       pData[3] = {NULL, NULL, NULL};
+  int32_t        iStride, iBufSize;
+
+  if (0 == WelsColorConvertMinStride (iColorFormat, 1)) {
+    IWelsTrace::WelsVTrace (m_pTrace, IWelsTrace::WELS_LOG_ERROR, "DecodeFrameEx(), unsupported color format %d",
+                            iColorFormat);
+    return dsInvalidArgument;
+  }
+
+  eDecState = DecodeFrame2 (kpSrc, kiSrcLen, (void**)pData, &DstInfo);
+  if (DstInfo.iBufferStatus != 1) {
+    iDstLen = 0;
+    return eDecState;
+  }
+
+  // the cropped picture is converted by one pass from internal storage into pDst, no intermediate I420 copy
+  iWidth	= DstInfo.UsrData.sSystemBuffer.iWidth;
+  iHeight	= DstInfo.UsrData.sSystemBuffer.iHeight;
+  iStride	= (0 == iDstStride) ? WelsColorConvertMinStride (iColorFormat, iWidth) : iDstStride;
+  if (iStride < WelsColorConvertMinStride (iColorFormat, iWidth)) {
+    iDstLen = 0;
+    return (DECODING_STATE) (eDecState | dsInvalidArgument);
+  }
+  iBufSize = WelsColorConvertBufSize (iColorFormat, iStride, iHeight);
+  if (NULL == pDst || iDstLen < iBufSize) {
+    iDstLen = iBufSize;
+    return (DECODING_STATE) (eDecState | dsDstBufNeedExpand);
+  }
 
-  return state;
+  WelsColorConvert (&m_pDecContext->sColorConvertFunc, pData, DstInfo.UsrData.sSystemBuffer.iStride, iWidth, iHeight,
+                    pDst, iStride, iColorFormat);
+  iDstLen = iBufSize;
+
+  return eDecState;
+}
+
+/*
+ *	Batched decoding: items are ordered by picture size and decoder, then runs of one size are cut into a task per
+ *	worker at most, so that a worker decodes streams of one size back to back with tables and buffers of that size hot.
+ */
+typedef struct TagDecodeBatchEntry {
+  int32_t			iWidth;
+  int32_t			iHeight;
+  CWelsDecoder*	pDecoder;
+  int32_t			iItemIdx;
+} SDecodeBatchEntry;
+
+typedef struct TagDecodeBatchTask {
+#if defined(MT_ENABLED)
+  SWelsThreadTask		sTask;
+#endif//MT_ENABLED
+  SDecodeBatchItem*		pItems;
+  SDecodeBatchEntry*	pEntries;	// first entry of the task
+  int32_t				iEntryNum;
+} SDecodeBatchTask;
+
+static int CompareBatchEntry (const void* kpA, const void* kpB) {
+  const SDecodeBatchEntry* kpEntryA = (const SDecodeBatchEntry*)kpA;
+  const SDecodeBatchEntry* kpEntryB = (const SDecodeBatchEntry*)kpB;
+
+  if (kpEntryA->iWidth != kpEntryB->iWidth)
+    return kpEntryA->iWidth - kpEntryB->iWidth;
+  if (kpEntryA->iHeight != kpEntryB->iHeight)
+    return kpEntryA->iHeight - kpEntryB->iHeight;
+  if (kpEntryA->pDecoder != kpEntryB->pDecoder)
+    return (kpEntryA->pDecoder < kpEntryB->pDecoder) ? -1 : 1;
+  return kpEntryA->iItemIdx - kpEntryB->iItemIdx;
+}
+
+static void DecodeBatchTaskProc (void* pArg) {
+  SDecodeBatchTask* pTask = (SDecodeBatchTask*)pArg;
+  int32_t i;
+
+  for (i = 0; i < pTask->iEntryNum; i++) {
+    SDecodeBatchItem* pItem = &pTask->pItems[pTask->pEntries[i].iItemIdx];
+    pItem->eState = pTask->pEntries[i].pDecoder->DecodeFrame2 (pItem->pSrc, pItem->iSrcLen, pItem->pDst,
+                    &pItem->sDstInfo);
+  }
+}
+
+// tasks over runs of entries of one picture size, items of a decoder are kept in one task
+static int32_t CutDecodeBatch (SDecodeBatchItem* pItems, SDecodeBatchEntry* pEntries, const int32_t kiEntryNum,
+                               const int32_t kiWorkerNum, SDecodeBatchTask* pTasks) {
+  int32_t iTaskNum = 0;
+  int32_t iRunStart = 0;
+
+  while (iRunStart < kiEntryNum) {
+    int32_t iRunEnd = iRunStart + 1;
+    int32_t iChunk, iStart;
+
+    while (iRunEnd < kiEntryNum && pEntries[iRunEnd].iWidth == pEntries[iRunStart].iWidth
+           && pEntries[iRunEnd].iHeight == pEntries[iRunStart].iHeight)
+      ++ iRunEnd;
+    iChunk = (iRunEnd - iRunStart + kiWorkerNum - 1) / kiWorkerNum;
+
+    for (iStart = iRunStart; iStart < iRunEnd;) {
+      int32_t iEnd = WELS_MIN (iStart + iChunk, iRunEnd);
+      while (iEnd < iRunEnd && pEntries[iEnd].pDecoder == pEntries[iEnd - 1].pDecoder)
+        ++ iEnd;
+      pTasks[iTaskNum].pItems		= pItems;
+      pTasks[iTaskNum].pEntries		= &pEntries[iStart];
+      pTasks[iTaskNum].iEntryNum	= iEnd - iStart;
+      ++ iTaskNum;
+      iStart = iEnd;
+    }
+    iRunStart = iRunEnd;
+  }
+  return iTaskNum;
 }
 
+int32_t DecodeBatch (SDecodeBatchItem* pItems, const int32_t kiItemNum) {
+  SDecodeBatchEntry* pEntries = NULL;
+  SDecodeBatchTask* pTasks = NULL;
+  int32_t iWorkerNum = 1;
+  int32_t iTaskNum = 0;
+  int32_t iFrameNum = 0;
+  int32_t i;
+#if defined(MT_ENABLED)
+  SWelsThreadPool* pPool = NULL;
+  SWelsThreadTaskGroup sGroup;
+#endif//MT_ENABLED
+
+  for (i = 0; i < kiItemNum; i++) {
+    if (NULL == pItems[i].pDecoder)
+      return -1;
+  }
+
+  pEntries	= (SDecodeBatchEntry*)WelsMalloc (kiItemNum * sizeof (SDecodeBatchEntry), "pEntries");
+  pTasks	= (SDecodeBatchTask*)WelsMalloc (kiItemNum * sizeof (SDecodeBatchTask), "pTasks");
+  if (NULL == pEntries || NULL == pTasks) {
+    WELS_SAFE_FREE (pEntries, "pEntries");
+    WELS_SAFE_FREE (pTasks, "pTasks");
+    return -1;
+  }
+
+  for (i = 0; i < kiItemNum; i++) {
+    pEntries[i].pDecoder = static_cast<CWelsDecoder*> (pItems[i].pDecoder);
+    pEntries[i].pDecoder->GetPictureSize (pEntries[i].iWidth, pEntries[i].iHeight);
+    pEntries[i].iItemIdx = i;
+  }
+  qsort (pEntries, kiItemNum, sizeof (SDecodeBatchEntry), CompareBatchEntry);
+
+#if defined(MT_ENABLED)
+  if (WELS_THREAD_ERROR_OK == WelsThreadPoolAttachShared (&pPool)
+      && WELS_THREAD_ERROR_OK != WelsThreadTaskGroupInit (&sGroup)) {
+    WelsThreadPoolDetachShared (pPool);
+    pPool = NULL;
+  }
+  if (NULL != pPool)
+    iWorkerNum = pPool->iThreadNum;
+#endif//MT_ENABLED
+
+  iTaskNum = CutDecodeBatch (pItems, pEntries, kiItemNum, iWorkerNum, pTasks);
+
+#if defined(MT_ENABLED)
+  if (NULL != pPool) {
+    for (i = 0; i < iTaskNum; i++) {
+      pTasks[i].sTask.pProc	= DecodeBatchTaskProc;
+      pTasks[i].sTask.pArg	= &pTasks[i];
+      pTasks[i].sTask.pGroup	= &sGroup;
+      if (WELS_THREAD_ERROR_OK != WelsThreadPoolQueueTask (pPool, &pTasks[i].sTask))
+        DecodeBatchTaskProc (&pTasks[i]);
+    }
+    WelsThreadPoolWaitGroup (pPool, &sGroup);
+    WelsThreadTaskGroupDestroy (&sGroup);
+    WelsThreadPoolDetachShared (pPool);
+  } else
+#endif//MT_ENABLED
+  {
+    for (i = 0; i < iTaskNum; i++)
+      DecodeBatchTaskProc (&pTasks[i]);
+  }
+
+  for (i = 0; i < kiItemNum; i++) {
+    if (1 == pItems[i].sDstInfo.iBufferStatus)
+      ++ iFrameNum;
+  }
+
+  WelsFree (pEntries, "pEntries");
+  WelsFree (pTasks, "pTasks");
+  return iFrameNum;
+}
 
 } // namespace WelsDec
 
@@ -465,3 +721,16 @@ void DestroyDecoder (ISVCDecoder* pDecoder) {
     delete (CWelsDecoder*)pDecoder;
   }
 }
+
+/*
+*	WelsDecodeBatch
+*	@return:	count of frames output, -1 for invalid arguments.
+*/
+int WelsDecodeBatch (SDecodeBatchItem* pItems, int iItemNum) {
+  if (NULL == pItems || iItemNum < 0)
+    return -1;
+  if (0 == iItemNum)
+    return 0;
+
+  return DecodeBatch (pItems, iItemNum);
+}
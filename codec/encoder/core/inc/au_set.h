@@ -127,6 +127,7 @@ int32_t WelsInitSubsetSps (SSubsetSps* pSubsetSps, SDLayerParam* pLayerParam, co
  * \param   kbDeblockingFilterPresentFlag			bool
  * \param	kiPpsId						PPS Id
  * \param	kbUsingSubsetSps					bool
+ * \param	kbEntropyCodingModeFlag				bool, true for CABAC
  * \return	0 - successful
  *			1 - failed
  */
@@ -135,7 +136,8 @@ int32_t WelsInitPps (SWelsPPS* pPps,
                      SSubsetSps* pSubsetSps,
                      const uint32_t kuiPpsId,
                      const bool kbDeblockingFilterPresentFlag,
-                     const bool kbUsingSubsetSps);
+                     const bool kbUsingSubsetSps,
+                     const bool kbEntropyCodingModeFlag);
 
 }
 #endif//WELS_ACCESS_UNIT_PARSER_H__
@@ -71,6 +71,15 @@ void PerformDeblockingFilter (sWelsEncCtx* pEnc);
 void DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc);
 
 void DeblockingFilterSliceAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, const int32_t kiSliceIdx);
+
+void DeblockingFilterRowAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, const int32_t kiMbY);
+
+/*!
+ * \brief	follow the MB coding of the current layer in raster order: with kiMbRowsCoded MB rows reconstructed,
+ *			filter MB row kiMbRowsCoded - 2 and expand the borders of MB row kiMbRowsCoded - 3, or finish all rows
+ *			left once the last MB row is coded; see bDeblockingRowFlag and bExpandingRowFlag of SDqLayer
+ */
+void PerformDeblockingFilterRows (sWelsEncCtx* pEnc, const int32_t kiMbRowsCoded);
 }
 
 #endif
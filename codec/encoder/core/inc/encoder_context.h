@@ -51,6 +51,7 @@
 #include "rc.h"
 #include "as264_common.h"
 #include "wels_preprocess.h"
+#include "lookahead.h"
 #include "wels_func_ptr_def.h"
 #include "crt_util_safe_x.h"
 
@@ -117,6 +118,7 @@ typedef struct TagWelsEncCtx {
   int32_t*					pSadCostMb;
   /* MVD cost tables for Inter MB */
   uint16_t*					pMvdCostTableInter; //[52];	// adaptive to spatial layers
+  uint16_t*					pMvdCostTableInterCabac; //[52];	// estimated from initial cabac contexts
   SMVUnitXY*
   pMvUnitBlock4x4;	// (*pMvUnitBlock4x4[2])[MB_BLOCK4x4_NUM];	    // for store each 4x4 blocks' mv unit, the two swap after different d layer
   int8_t*
@@ -131,6 +133,7 @@ typedef struct TagWelsEncCtx {
 
 #if defined(MT_ENABLED)
   SSliceThreading*				pSliceThreading;
+  struct TagMbRowThreading*		pMbRowThreading;	// NULL unless MB rows of single slice layers are coded in parallel
 #endif//MT_ENABLED
 
   // SSlice context
@@ -173,6 +176,7 @@ typedef struct TagWelsEncCtx {
   // VAA
   SVAAFrameInfo*		    	pVaa;		    // VAA information of reference
   CWelsPreProcess*				pVpp;
+  SWelsLookahead*				pLookahead;		// NULL unless lookahead rate control enabled
 
   SWelsSPS*							pSpsArray;		// MAX_SPS_COUNT by standard compatible
   SWelsSPS*							pSps;
@@ -225,6 +229,15 @@ typedef struct TagWelsEncCtx {
   WELS_MUTEX					mutexEncoderError;
 #endif
 
+  struct TagEncCtxPool*		pCtxPool;	// contexts of other configurations owned by this active one, NULL unless iCtxPoolSize > 0
 } sWelsEncCtx/*, *PWelsEncCtx*/;
+
+/*
+ *	contexts parked by WelsEncoderParamAdjust, reset and taken back when a configuration of the same shape returns
+ */
+typedef struct TagEncCtxPool {
+  sWelsEncCtx*				pCtxList[MAX_ENC_CTX_POOL_SIZE];	// the least recently parked first
+  int32_t						iCtxNum;
+} SEncCtxPool;
 }
 #endif//sWelsEncCtx_H__
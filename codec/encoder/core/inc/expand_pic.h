@@ -50,6 +50,12 @@ typedef void (*PExpandPictureFunc) (uint8_t* pDst, const int32_t kiStride, const
 
 void ExpandReferencingPicture (SPicture* pPic, PExpandPictureFunc pExpLuma, PExpandPictureFunc pExpChrom[2]);
 
+/*!
+ * \brief	expand borders of luma rows [kiRowStart, kiRowEnd) and the chroma rows of them, the top and bottom borders
+ *			are expanded along with the first and the last rows of the picture
+ */
+void ExpandReferencingPictureRows (SPicture* pPic, const int32_t kiRowStart, const int32_t kiRowEnd);
+
 void InitExpandPictureFunc (void* pL, const uint32_t kuiCPUFlags);
 }
 #endif
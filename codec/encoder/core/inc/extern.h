@@ -100,6 +100,12 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx*, void* pDst, const SSourcePicture** k
 
 int32_t WelsEncoderEncodeParameterSets (sWelsEncCtx* pCtx, void* pDst);
 
+/*!
+ * \brief	get the internal picture the next input can be written into to save its copy
+ * \return	0 on success, 1 if the input is copied anyway (scaling, cropping or lookahead)
+ */
+int32_t WelsEncoderGetInputPicture (sWelsEncCtx* pCtx, SSourcePicture* pSrcPic);
+
 /*
  * Force coding IDR as follows
  */
@@ -0,0 +1,104 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	lookahead.h
+ *
+ * \brief	frame lookahead analysis used by rate control
+ *
+ * \date	10/17/2014 Created
+ *
+ *************************************************************************************
+ */
+#ifndef WELS_LOOKAHEAD_H__
+#define WELS_LOOKAHEAD_H__
+
+#include "typedefs.h"
+#include "codec_app_def.h"
+#include "wels_const.h"
+
+namespace WelsSVCEnc {
+
+typedef struct TagWelsEncCtx sWelsEncCtx;
+
+#define LOOKAHEAD_SCENE_CUT_RATIO		0.85	// inter cost over intra cost above which a frame is taken as scene cut
+#define LOOKAHEAD_WEIGHT_RANGE			0.5		// target bits of P frame vary at most this much by lookahead weight
+#define LOOKAHEAD_PRE_CUT_RATIO			0.85	// weight of frames referenced by nothing after an upcoming scene cut
+
+/*
+ *	Frame buffered in lookahead, pixels are copied since the application owns its input only during the call
+ */
+typedef struct TagLookaheadFrame {
+  SSourcePicture	sSrcPic;		// I420 picture pointing to pBuffer
+  uint8_t*			pBuffer;
+  int32_t			iIntraCost;		// sum of DC predicted SAD of MBs
+  int32_t			iInterCost;		// sum of co-located SAD of MBs against previous input frame
+  int32_t			iCost;			// sum of the lesser of both per MB
+  bool				bSceneCut;
+} SLookaheadFrame;
+
+typedef struct TagWelsLookahead {
+  SLookaheadFrame	sFrames[MAX_LOOKAHEAD_FRAMES + 1];	// ring buffer, one more slot than depth for the frame being coded
+  int32_t			iDepth;			// count of frames buffered ahead of the frame being coded
+  int32_t			iHead;			// slot of oldest frame buffered
+  int32_t			iCount;			// count of frames buffered
+  int32_t			iLastSlot;		// slot of the last frame pushed, -1 if none
+  int32_t			iFramesSinceCut;
+
+  // hints of frame popped for coding
+  bool				bValid;			// set while frame popped from lookahead is being coded
+  bool				bSceneCut;		// current frame starts new scene
+  int32_t			iCutDistance;	// distance in frames to next scene cut in window, 0 if none
+  double			dWeight;		// cost of current frame over average cost of window
+} SWelsLookahead;
+
+/*!
+ * \brief	allocate lookahead buffers of pCtx->pSvcParam->iLookaheadFrames frames
+ * \return	0 on success, pCtx->pLookahead stays NULL if lookahead disabled
+ */
+int32_t WelsLookaheadInit (sWelsEncCtx* pCtx);
+
+void WelsLookaheadUninit (sWelsEncCtx* pCtx);
+
+/*!
+ * \brief	copy and analyze input picture, only I420 is accepted
+ * \return	0 on success
+ */
+int32_t WelsLookaheadPush (sWelsEncCtx* pCtx, const SSourcePicture* kpSrcPic);
+
+/*!
+ * \brief	take oldest frame once window is full, or any buffered one in case flushing,
+ *			and update hints for rate control
+ * \return	picture to be coded (valid until next push), NULL if none available
+ */
+const SSourcePicture* WelsLookaheadPop (sWelsEncCtx* pCtx, const bool kbFlush);
+
+}
+#endif//WELS_LOOKAHEAD_H__
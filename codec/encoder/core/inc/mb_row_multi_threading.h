@@ -0,0 +1,120 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ * \file	mb_row_multi_threading.h
+ *
+ * \brief	wavefront coding of MB rows of a slice by multiple threads
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+#ifndef SVC_MB_ROW_MULTIPLE_THREADING_H__
+#define SVC_MB_ROW_MULTIPLE_THREADING_H__
+
+#if defined(MT_ENABLED)
+
+#include "typedefs.h"
+#include "param_svc.h"
+#include "encoder_context.h"
+#include "mb_cache.h"
+#include "md.h"
+#include "WelsThreadPool.h"
+
+namespace WelsSVCEnc {
+
+/*
+ *	Syntax of one MB kept from mode decision until the entropy coding stage writes it
+ */
+typedef struct TagMbRowSyntax {
+  SDCTCoeff		sDct;
+  int8_t			iNonZeroCoeffCount[48];
+  bool			bPrevIntra4x4PredModeFlag[16];
+  int8_t			iRemIntra4x4PredModeFlag[16];
+  SMVUnitXY		sMbMvp[MB_BLOCK8x8_NUM];
+  int32_t			iCostLuma;
+  uint8_t			uiLumaI16x16Mode;
+  uint8_t			uiChmaI8x8Mode;
+} SMbRowSyntax;
+
+typedef struct TagMbRowState {
+  int32_t			iCodedMbNum;	// MBs of the row done by mode decision and reconstruction
+  int32_t			iWaitMbNum;		// the row below waits until iCodedMbNum reaches it, if pWaitEvent is set
+  WELS_EVENT*		pWaitEvent;
+} SMbRowState;
+
+struct TagMbRowThreading;
+
+typedef struct TagMbRowWorker {
+  struct TagMbRowThreading*	pMrt;
+  sWelsEncCtx*				pEncCtx;
+  SSlice					sSlice;				// copy of the slice being coded, with its own MB cache
+  SWelsMD					sMd;
+  int32_t					iAboveCodedMbNum;	// cached progress of the row above
+  WELS_EVENT*				pWaitEvent;
+  SWelsThreadTask			sTask;
+} SMbRowWorker;
+
+typedef struct TagMbRowThreading {
+  SWelsThreadPool*		pThreadPool;
+  bool					bOwnPool;			// pThreadPool is created for MB rows, not taken from slice threading
+  SWelsThreadTaskGroup	sTaskGroup;
+  int32_t				iWorkerNum;			// the calling thread is worker 0
+  SMbRowWorker*			pWorkers;
+  SMbRowSyntax*			pMbSyntax;			// [max MB number of layers]
+  SMbRowState*			pRowState;			// [max MB height of layers]
+
+  WELS_MUTEX			mutexRows;			// protects the fields below and pRowState
+  SSlice*				pCurSlice;
+  int32_t				iMbWidth;
+  int32_t				iMbHeight;
+  int32_t				iNextRow;			// next row to be taken by a worker
+  int32_t				iNextWriteRow;		// next row to be written by entropy coding
+  bool					bWriting;			// a worker is writing rows
+  int32_t				iEncReturn;
+} SMbRowThreading;
+
+/*!
+ * \brief	allocate workers and MB syntax buffers for the largest layer coded in single slice mode
+ * \return	0 on success, pCtx->pMbRowThreading stays NULL if wavefront is disabled or useless
+ */
+int32_t RequestMbRowThreading (sWelsEncCtx* pCtx, SWelsSvcCodingParam* pParam);
+
+void ReleaseMbRowThreading (sWelsEncCtx* pCtx);
+
+/*!
+ * \brief	code pSlice with MB rows distributed over threads, each MB waits for the MB above right;
+ *			the bitstream is written in MB order behind mode decision by any worker done with its row
+ */
+int32_t WelsCodeSliceMbRows (sWelsEncCtx* pEncCtx, SSlice* pSlice);
+
+}
+#endif//MT_ENABLED
+
+#endif//SVC_MB_ROW_MULTIPLE_THREADING_H__
@@ -118,6 +118,7 @@ void FillNeighborCacheInterWithBGD (SMbCache* pMbCache, SMB* pCurMb, int32_t iMb
 void InitFillNeighborCacheInterFunc (SWelsFuncPtrList* pFuncList, const int32_t kiFlag);
 
 void MvdCostInit (uint16_t* pMvdCostInter, const int32_t kiMvdSz);
+void MvdCostInitCabac (uint16_t* pMvdCostInter, const int32_t kiMvdSz);
 
 void PredictSad (int8_t* pRefIndexCache, int32_t* pSadCostCache, int32_t uiRef, int32_t* pSadPred);
 
@@ -44,6 +44,7 @@
 #include "codec_app_def.h"
 #include "wels_const.h"
 #include "WelsThreadLib.h"
+#include "WelsThreadPool.h"
 
 /*
  *	Dynamic Slicing Assignment (DSA)
@@ -177,6 +178,10 @@ int32_t		iThreadIndex;	// thread index, zero based
 // for dynamic slicing mode
 int32_t		iStartMbIndex;	// inclusive
 int32_t		iEndMbIndex;	// exclusive
+
+#if defined(MT_ENABLED)
+SWelsThreadTask	sTask;		// slice coding task when a thread pool is used instead of own threads
+#endif//MT_ENABLED
 } SSliceThreadPrivateData;
 
 typedef struct TagSliceThreading {
@@ -205,6 +210,11 @@ WELS_EVENT*					pFinUpdateMbListEvent[MAX_THREADS_NUM];	// signal to indicate fi
 #endif//_WIN32
 #endif//#if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
 
+#if defined(MT_ENABLED)
+SWelsThreadPool*			pThreadPool;	// shared pool coding the slices, NULL when own threads are used
+SWelsThreadTaskGroup		sSliceTaskGroup;	// slice tasks of the layer being coded
+#endif//MT_ENABLED
+
 WELS_MUTEX					mutexSliceNumUpdate;	// for dynamic slicing mode MT
 
 #if defined(DYNAMIC_SLICE_ASSIGN) || defined(MT_DEBUG)
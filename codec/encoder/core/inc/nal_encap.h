@@ -121,6 +121,23 @@ void WelsLoadNalForSlice (SWelsSliceBs* pSliceBs, const int32_t/*EWelsNalUnitTyp
  */
 void WelsUnloadNalForSlice (SWelsSliceBs* pSliceBs);
 
+/*!
+ * \brief	length of the run from pSrc on holding no zero byte, a run ending in the last bytes of the buffer may be
+ *		cut short (by less than 8 bytes for the c version), the escaping goes byte by byte from there
+ */
+typedef int32_t (*PNalNonZeroRunLenFunc) (const uint8_t* pSrc, const uint8_t* pSrcEnd);
+
+int32_t WelsNalNonZeroRunLen_c (const uint8_t* pSrc, const uint8_t* pSrcEnd);
+#if defined(X86_ASM)
+int32_t WelsNalNonZeroRunLen_sse2 (const uint8_t* pSrc, const uint8_t* pSrcEnd);
+int32_t WelsNalNonZeroRunLen_avx2 (const uint8_t* pSrc, const uint8_t* pSrcEnd);
+#endif//X86_ASM
+
+/*!
+ * \brief	select the zero byte scan of WelsEncodeNal() by kuiCpuFlag, the same for all encoder instances
+ */
+void WelsInitNalEncapFunc (const uint32_t kuiCpuFlag);
+
 /*!
  * \brief	encode NAL with emulation forbidden three bytes checking
  * \param	pDst			pDst NAL pData
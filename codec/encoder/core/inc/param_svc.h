@@ -91,6 +91,7 @@ int32_t		iDecompositionStages;
 uint8_t     uiCodingIdx2TemporalId[ (1 << MAX_TEMPORAL_LEVEL) + 1];
 
 uint8_t		uiProfileIdc;			// value of profile IDC (0 for auto-detection)
+bool		bEntropyCodingModeFlag;	// CABAC if true, CAVLC otherwise
 
 int8_t		iHighestTemporalId;
 //	uint8_t		uiDependencyId;
@@ -124,6 +125,7 @@ struct {
 char*       pCurPath; // record current lib path such as:/pData/pData/com.wels.enc/lib/
 
 bool		bDeblockingParallelFlag;	// deblocking filter parallelization control flag
+bool		bRowPipelineFlag;	// deblocking and border expansion follow the coded MB rows where possible, see bDeblockingRowFlag of SDqLayer
 bool		bMgsT0OnlyStrategy; //MGS_T0_only_strategy
 
 // FALSE: Streaming Video Sharing; TRUE: Video Conferencing Meeting;
@@ -157,6 +159,7 @@ void FillDefault (const bool kbEnableRc) {
 
   iTargetBitrate			= 0;	// overall target bitrate introduced in RC module
   bDeblockingParallelFlag = false;	// deblocking filter parallelization control flag
+  bRowPipelineFlag		= true;
 #ifdef MT_ENABLED
   iMultipleThreadIdc		= 0;	// auto to detect cpu cores inside
 #else
@@ -164,6 +167,8 @@ void FillDefault (const bool kbEnableRc) {
     1;	// 1 # 0: auto(dynamic imp. internal encoder); 1: multiple threads imp. disabled; > 1: count number of threads;
 #endif//MT_ENABLED
   iCountThreadsNum		= 1;	//		# derived from disable_multiple_slice_idc (=0 or >1) means;
+  bUseSharedThreadPool	= false;	// own slice coding threads
+  bEnableWavefront		= false;	// threads only work on different slices
 
   iLTRRefNum				= 0;
   iLtrMarkPeriod			= 30;	//the min distance of two int32_t references
@@ -187,8 +192,10 @@ void FillDefault (const bool kbEnableRc) {
   bEnableRc		= kbEnableRc;
   iRCMode			= 0;
   iPaddingFlag	= 0;
+  iEtropyCodingModeFlag	= 0;	// CAVLC
 
   bEnableDenoise				= false;	// denoise control
+  bEnableTemporalDenoise		= false;	// temporal denoise control
   bEnableSceneChangeDetect	= true;		// scene change detection control
   bEnableBackgroundDetection	= true;		// background detection control
   bEnableAdaptiveQuant		= true;		// adaptive quantization control
@@ -201,6 +208,9 @@ void FillDefault (const bool kbEnableRc) {
 
   iMaxQp = 51;
   iMinQp = 0;
+  iLookaheadFrames = 0;		// lookahead rate control disabled
+  iCtxPoolSize = 0;			// context rebuilt on every configuration change
+  eMotionSearchPreset = ME_PRESET_FAST;	// diamond search
   iUsageType = 0;
   memset(sDependencyLayers,0,sizeof(SDLayerParam)*MAX_DEPENDENCY_LAYER);
 
@@ -248,6 +258,7 @@ int32_t ParamBaseTranscode (const SEncParamBase& pCodingParam, const bool kbEnab
   while (iIdxSpatial < iSpatialLayerNum) {
 
     pDlp->uiProfileIdc		= uiProfileIdc;
+    pDlp->bEntropyCodingModeFlag	= false;
     sSpatialLayers[iIdxSpatial].fFrameRate	= WELS_CLIP3 (pCodingParam.fMaxFrameRate,
         MIN_FRAME_RATE, MAX_FRAME_RATE);
     pDlp->fInputFrameRate	=
@@ -321,11 +332,25 @@ int32_t ParamTranscode (const SEncParamExt& pCodingParam) {
   else
     iRCMode = pCodingParam.iRCMode;    // rc mode
   iPaddingFlag = pCodingParam.iPaddingFlag;
+  iEtropyCodingModeFlag	= pCodingParam.iEtropyCodingModeFlag;
+  iLookaheadFrames	= WELS_CLIP3 (pCodingParam.iLookaheadFrames, 0, MAX_LOOKAHEAD_FRAMES);
+
+  /* Multi-threading */
+#ifdef MT_ENABLED
+  iMultipleThreadIdc	= WELS_CLIP3 (pCodingParam.iMultipleThreadIdc, 0, MAX_THREADS_NUM);
+#endif//MT_ENABLED
+  bUseSharedThreadPool	= pCodingParam.bUseSharedThreadPool;
+  bEnableWavefront		= pCodingParam.bEnableWavefront;
+  iCtxPoolSize			= WELS_CLIP3 (pCodingParam.iCtxPoolSize, 0, MAX_ENC_CTX_POOL_SIZE);
+
+  /* Motion search engine */
+  eMotionSearchPreset	= (ME_SEARCH_PRESET)WELS_CLIP3 (pCodingParam.eMotionSearchPreset, ME_PRESET_FAST, ME_PRESET_SLOW);
 
   iTargetBitrate		= pCodingParam.iTargetBitrate;	// target bitrate
 
   /* Denoise Control */
   bEnableDenoise = pCodingParam.bEnableDenoise ? true : false;    // Denoise Control  // only support 0 or 1 now
+  bEnableTemporalDenoise = pCodingParam.bEnableTemporalDenoise ? true : false;
 
   /* Scene change detection control */
   bEnableSceneChangeDetect	= true;
@@ -376,7 +401,9 @@ int32_t ParamTranscode (const SEncParamExt& pCodingParam) {
   uint8_t uiProfileIdc		= PRO_BASELINE;
   int8_t iIdxSpatial	= 0;
   while (iIdxSpatial < iSpatialLayerNum) {
-    pDlp->uiProfileIdc		= uiProfileIdc;
+    pDlp->bEntropyCodingModeFlag	= (pCodingParam.iEtropyCodingModeFlag != 0)
+                                  || (pCodingParam.sSpatialLayers[iIdxSpatial].iEntropyCodingModeFlag != 0);
+    pDlp->uiProfileIdc		= GetProfileIdc (uiProfileIdc, pDlp->bEntropyCodingModeFlag);
 
     float fLayerFrameRate	= WELS_CLIP3 (pCodingParam.sSpatialLayers[iIdxSpatial].fFrameRate,
         MIN_FRAME_RATE, fParamMaxFrameRate);
@@ -419,6 +446,15 @@ int32_t ParamTranscode (const SEncParamExt& pCodingParam) {
   return 0;
 }
 
+/*!
+* \brief	profile of a layer, CABAC needs Main for base layer and Scalable High for enhancement layers
+*/
+static uint8_t GetProfileIdc (const uint8_t kuiBaselineProfileIdc, const bool kbEntropyCodingModeFlag) {
+  if (!kbEntropyCodingModeFlag)
+    return kuiBaselineProfileIdc;
+  return (PRO_BASELINE == kuiBaselineProfileIdc) ? PRO_MAIN : PRO_SCALABLE_HIGH;
+}
+
 // assuming that the width/height ratio of all spatial layers are the same
 
 void SetActualPicResolution() {
@@ -455,7 +491,8 @@ void DetermineTemporalSettings() {
     int8_t iMaxTemporalId = 0;
 
     memset (pDlp->uiCodingIdx2TemporalId, INVALID_TEMPORAL_ID, sizeof (pDlp->uiCodingIdx2TemporalId));
-    pDlp->uiProfileIdc = uiProfileIdc;	// PRO_BASELINE, PRO_SCALABLE_BASELINE;
+    pDlp->uiProfileIdc = GetProfileIdc (uiProfileIdc,
+                                        pDlp->bEntropyCodingModeFlag);	// PRO_BASELINE, PRO_SCALABLE_BASELINE or CABAC ones;
 
     iNotCodedMask	= (1 << (kuiLogFactorInOutRate + kuiLogFactorMaxInRate)) - 1;
     for (uint32_t uiFrameIdx = 0; uiFrameIdx <= uiGopSize; ++ uiFrameIdx) {
@@ -150,6 +150,7 @@ uint8_t		uiChromaQpIndexOffset;
 //	bool		bPicOrderPresentFlag;
 
 bool		bDeblockingFilterControlPresentFlag;
+bool		bEntropyCodingModeFlag;
 
 //	bool		bConstainedIntraPredFlag;
 //	bool		bRedundantPicCntPresentFlag;
@@ -221,6 +221,8 @@ typedef  struct  WelsRcFunc_s {
   PWelsRCPictureInfoUpdateFunc	pfWelsRcPictureInfoUpdate;
   PWelsRCMBInitFunc				pfWelsRcMbInit;
   PWelsRCMBInfoUpdateFunc			pfWelsRcMbInfoUpdate;
+  PWelsRCMBInitFunc				pfWelsRcMbInitWavefront;		// QP of MB coded in parallel with its neighbors, no bits feedback
+  PWelsRCMBInitFunc				pfWelsRcMbBitsInitWavefront;	// before such MB is written, pfWelsRcMbInfoUpdate follows
 } SWelsRcFunc;
 
 void WelsRcInitModule (void* pCtx,  int32_t iModule);
@@ -0,0 +1,184 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	set_mb_syn_cabac.h
+ *
+ * \brief	Binary arithmetic coder and residual block writing with cabac
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef SET_MB_SYN_CABAC_H_
+#define SET_MB_SYN_CABAC_H_
+
+#include "typedefs.h"
+#include "cabac_common.h"
+
+namespace WelsSVCEnc {
+
+/* ctxIdxOffset of syntax elements used in frame coded 4:2:0 slices, Table 9-34 of the spec */
+#define CTX_OFFSET_MB_TYPE_I			3
+#define CTX_OFFSET_SKIP_FLAG_P			11
+#define CTX_OFFSET_MB_TYPE_P			14
+#define CTX_OFFSET_MB_TYPE_P_SUFFIX		17
+#define CTX_OFFSET_SUB_MB_TYPE_P		21
+#define CTX_OFFSET_MVD_X				40
+#define CTX_OFFSET_MVD_Y				47
+#define CTX_OFFSET_REF_IDX				54
+#define CTX_OFFSET_MB_QP_DELTA			60
+#define CTX_OFFSET_INTRA_CHROMA_PRED	64
+#define CTX_OFFSET_PREV_INTRA_PRED_FLAG	68
+#define CTX_OFFSET_REM_INTRA_PRED_MODE	69
+#define CTX_OFFSET_CBP_LUMA				73
+#define CTX_OFFSET_CBP_CHROMA			77
+#define CTX_OFFSET_CODED_BLOCK_FLAG		85
+#define CTX_OFFSET_SIG_COEFF_FLAG		105
+#define CTX_OFFSET_LAST_SIG_COEFF_FLAG	166
+#define CTX_OFFSET_COEFF_ABS_LEVEL		227
+
+/*
+ *	state of binary arithmetic coder, bytes are written out directly once they can not be changed by carry any more
+ */
+typedef struct TagCabacCtx {
+uint32_t	uiLow;
+int32_t		iRange;
+int32_t		iQueue;				// count of bits in uiLow not written yet, minus 8
+int32_t		iBytesOutstanding;	// 0xff bytes held back until the carry is known
+uint8_t*	pBufStart;
+uint8_t*	pBufCur;
+uint8_t*	pBufEnd;
+uint8_t		sStateCtx[WELS_CONTEXT_COUNT];	// packed context states, see WELS_CABAC_STATE
+} SCabacCtx;
+
+extern const uint8_t g_kuiCabacRenormShift[64];
+extern const uint16_t g_kuiCabacBinBits[64][2];
+
+void WelsCabacContextInit (SCabacCtx* pCbCtx, const int32_t kiModel, const int32_t kiSliceQp);
+
+void WelsCabacEncodeInit (SCabacCtx* pCbCtx, uint8_t* pBuf, uint8_t* pBufEnd);
+
+/*!
+ * \brief	encode end_of_slice_flag equal to 1 and flush the coder, rbsp_stop_one_bit and alignment bits are included
+ */
+void WelsCabacEncodeFlush (SCabacCtx* pCbCtx);
+
+static inline void WelsCabacPutByte (SCabacCtx* pCbCtx) {
+if (pCbCtx->iQueue >= 0) {
+  const int32_t kiOut = pCbCtx->uiLow >> (pCbCtx->iQueue + 10);
+  pCbCtx->uiLow &= (0x400 << pCbCtx->iQueue) - 1;
+  pCbCtx->iQueue -= 8;
+
+  if ((kiOut & 0xff) == 0xff) {
+    ++ pCbCtx->iBytesOutstanding;
+  } else {
+    const int32_t kiCarry = kiOut >> 8;
+    int32_t iBytes = pCbCtx->iBytesOutstanding;
+    // the byte before slice data is written too when there is no carry, it is left unchanged then
+    pCbCtx->pBufCur[-1] += kiCarry;
+    while (iBytes > 0) {
+      *pCbCtx->pBufCur++ = kiCarry - 1;
+      -- iBytes;
+    }
+    *pCbCtx->pBufCur++ = kiOut;
+    pCbCtx->iBytesOutstanding = 0;
+  }
+}
+}
+
+static inline void WelsCabacEncodeRenorm (SCabacCtx* pCbCtx) {
+const int32_t kiShift = g_kuiCabacRenormShift[pCbCtx->iRange >> 3];
+pCbCtx->iRange <<= kiShift;
+pCbCtx->uiLow <<= kiShift;
+pCbCtx->iQueue += kiShift;
+WelsCabacPutByte (pCbCtx);
+}
+
+static inline void WelsCabacEncodeDecision (SCabacCtx* pCbCtx, const int32_t kiCtx, const uint32_t kuiBin) {
+const uint8_t kuiState		= pCbCtx->sStateCtx[kiCtx];
+const int32_t kiStateIdx	= kuiState >> 1;
+const uint32_t kuiMps		= kuiState & 1;
+const int32_t kiRangeLps	= g_kuiCabacRangeLps[kiStateIdx][ (pCbCtx->iRange >> 6) & 3];
+
+pCbCtx->iRange -= kiRangeLps;
+if (kuiBin != kuiMps) {
+  pCbCtx->uiLow += pCbCtx->iRange;
+  pCbCtx->iRange = kiRangeLps;
+  pCbCtx->sStateCtx[kiCtx] = WELS_CABAC_STATE (g_kuiStateTransTable[kiStateIdx][0], kiStateIdx ? kuiMps : 1 - kuiMps);
+} else {
+  pCbCtx->sStateCtx[kiCtx] = WELS_CABAC_STATE (g_kuiStateTransTable[kiStateIdx][1], kuiMps);
+}
+WelsCabacEncodeRenorm (pCbCtx);
+}
+
+static inline void WelsCabacEncodeBypass (SCabacCtx* pCbCtx, const uint32_t kuiBin) {
+pCbCtx->uiLow <<= 1;
+if (kuiBin)
+  pCbCtx->uiLow += pCbCtx->iRange;
+++ pCbCtx->iQueue;
+WelsCabacPutByte (pCbCtx);
+}
+
+/*!
+ * \brief	encode a bin equal to 0 with the terminating context (ctxIdx 276), e.g. end_of_slice_flag of a MB not last
+ */
+static inline void WelsCabacEncodeTerminate (SCabacCtx* pCbCtx) {
+pCbCtx->iRange -= 2;
+WelsCabacEncodeRenorm (pCbCtx);
+}
+
+/*!
+ * \brief	estimated bits of coding kuiBin with packed context state kuiState, in 1/256 bit unit
+ */
+static inline int32_t WelsCabacBinBits (const uint8_t kuiState, const uint32_t kuiBin) {
+return g_kuiCabacBinBits[kuiState >> 1][kuiBin != (kuiState & 1u)];
+}
+
+/*!
+ * \brief	k-th order Exp-Golomb suffix of UEGk binarization, all bins are bypass coded
+ */
+void WelsCabacEncodeUeBypass (SCabacCtx* pCbCtx, int32_t iExpBits, uint32_t uiVal);
+
+/*!
+ * \brief	code coded_block_flag of the block and its significance map and levels if any coefficient
+ * \param	pCoffLevel			coefficients in scan order
+ * \param	iEndIdx				index of the last coefficient of the block, 15, 14 (AC) or 3 (chroma DC)
+ * \param	iResidualProperty	ctxBlockCat, one of EResidualProperty
+ * \param	iCbfCtxInc			ctxIdxInc of coded_block_flag derived from the neighbouring blocks
+ *
+ * \return	coded_block_flag of the block
+ */
+int32_t WriteBlockResidualCabac (SCabacCtx* pCbCtx, int16_t* pCoffLevel, int32_t iEndIdx, int32_t iResidualProperty,
+                                int32_t iCbfCtxInc);
+
+}
+#endif
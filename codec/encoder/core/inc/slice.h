@@ -121,7 +121,7 @@ typedef struct TagSliceHeader {
   bool		bNumRefIdxActiveOverrideFlag;
 //	bool		field_pic_flag;		//not supported in base profile
 //	bool		bottom_field_flag;		//not supported in base profile
-  uint8_t		uiPadding1Bytes;
+  uint8_t		uiCabacInitIdc;	// table of context variables initialization for P slice with cabac
 
   SRefPicMarking		sRefMarking;	// Decoded reference picture marking syntaxs
 
@@ -165,7 +165,7 @@ typedef struct TagSlice {
 
   SMVUnitXY	sMvMin;
   SMVUnitXY	sMvMax;
-  SMVUnitXY	sMvc[5];
+  SMVUnitXY	sMvc[6];
   uint8_t		uiMvcNum;
   uint8_t		sScaleShift;
 
@@ -176,6 +176,10 @@ typedef struct TagSlice {
   bool		bDynamicSlicingSliceSizeCtrlFlag;
   uint8_t		uiAssumeLog2BytePerMb;
   uint8_t		uiReservedFillByte;	// reserved to meet 4 bytes alignment
+
+  int32_t		iMbSkipRun;		// P_Skip MBs not written yet with cavlc
+  int32_t		iLastDeltaQp;	// mb_qp_delta of the previous MB in slice with cabac, 0 if not present
+  SCabacCtx	sCabacCtx;
 } SSlice, *PSlice;
 
 }
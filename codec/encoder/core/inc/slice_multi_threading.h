@@ -79,6 +79,8 @@ int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pParam, con
 
 void ReleaseMtResource (sWelsEncCtx** ppCtx);
 
+void ResetMtResource (sWelsEncCtx* pCtx);
+
 int32_t AppendSliceToFrameBs (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32_t kiSliceCount);
 int32_t WriteSliceToFrameBs (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, uint8_t* pFrameBsBuffer, const int32_t iSliceIdx, int32_t& iSliceSize);
 
@@ -104,6 +106,9 @@ int32_t FiredSliceThreads (SSliceThreadPrivateData* pPriData, WELS_EVENT** ppEve
                            const uint32_t kuiNumThreads/*, int32_t *iLayerNum*/, SSliceCtx* pSliceCtx, const bool kbIsDynamicSlicingMode);
 #endif//_WIN32
 
+// queue slices (partitions in dynamic slicing mode) to the shared pool, wait for them on pSliceThreading->sSliceTaskGroup
+int32_t FiredSliceTasks (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32_t kiTaskNum, const bool kbIsDynamicSlicingMode);
+
 int32_t DynamicDetectCpuCores();
 
 #if defined(MT_ENABLED) && defined(DYNAMIC_SLICE_ASSIGN)
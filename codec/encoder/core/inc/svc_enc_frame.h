@@ -92,6 +92,8 @@ struct TagDqLayer {
   int8_t					iInterLayerSliceAlphaC0Offset;
   int8_t					iInterLayerSliceBetaOffset;
   bool					bDeblockingParallelFlag; //parallel_deblocking_flag
+  bool					bDeblockingRowFlag;	// MB rows are filtered along with the MB coding, see PerformDeblockingFilterRows
+  bool					bExpandingRowFlag;	// borders of pDecPic are expanded along with the MB coding, as above
 
   SPicture*				pRefPic;			// reference picture pointer
   SPicture*				pDecPic;			// reconstruction picture pointer for layer
@@ -104,6 +106,10 @@ struct TagDqLayer {
 
   SDqLayer*				pRefLayer;		// pointer to referencing dq_layer of current layer to be decoded
 
+  uint8_t*					pCoarseEncData;	// half resolution luma of pEncData[0], for ME_PRESET_SLOW only
+  uint8_t*					pCoarseRefData;	// half resolution luma of pRefPic including its padding
+  int32_t					iCoarseStride;	// stride of both half resolution planes
+
 };
 
 ///////////////////////////////////////////////////////////////////////
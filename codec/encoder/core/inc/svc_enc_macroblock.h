@@ -69,7 +69,10 @@ SMVUnitXY	sP16x16Mv;
 uint8_t		uiLumaQp;		// uiLumaQp: pPps->iInitialQp + sSliceHeader->delta_qp + mb->dquant.
 uint8_t		uiChromaQp;
 uint8_t		uiSliceIdc;	// AVC: pFirstMbInSlice?; SVC: (pFirstMbInSlice << 7) | ((uiDependencyId << 4) | uiQualityId);
-uint8_t		reserved_filling_bytes[1];	// filling bytes reserved to make structure aligned with 4 bytes, higher cache hit on less structure size by 2 cache lines( 2 * 64 bytes) once hit
+uint8_t		uiChromPredMode;	// intra_chroma_pred_mode, 0 for inter MB
+uint8_t		uiCbfDc;		// coded_block_flag of luma DC, Cb DC and Cr DC in bit 0 to 2, for cabac
+
+SMVUnitXY	sMvd[4];		// mvd of each 8x8 block for cabac, 0 for skip and intra MB
 } SMB, *PMb;
 
 }
@@ -46,6 +46,7 @@
 #include "memory_align.h"
 
 #include "codec_app_def.h"
+#include "set_mb_syn_cabac.h"
 namespace WelsSVCEnc {
 /*!
  * \brief	SSlice mode
@@ -107,6 +108,9 @@ uint32_t    uiBsStackCurBits;
 int32_t		iBsStackLeftBits;
 
 int32_t		iMbSkipRunStack;
+
+SCabacCtx	sStoredCabac;
+uint8_t		uiLastByte;	// byte before the writing position of cabac, may be changed by carry
 } SDynamicSlicingStack;
 
 /*!
@@ -131,6 +135,16 @@ int32_t InitSlicePEncCtx (SSliceCtx* pSliceCtx,
                           void* pPpsArg);
 
 
+/*!
+ * \brief	Restore MB map of Wels SSlice context to the partition given at initialization, buffers are kept
+ *
+ * \param	pSliceCtx		SSlice context initialized with pMso before
+ * \param	pMso			multiple slice options
+ *
+ * \return	0 - successful; none 0 - failed;
+ */
+int32_t ResetSlicePEncCtx (SSliceCtx* pSliceCtx, SSliceConfig* pMso);
+
 /*!
  * \brief	Uninitialize Wels SSlice context (Single/multiple slices and FMO)
  *
@@ -48,6 +48,8 @@ namespace WelsSVCEnc {
 #define MV_RANGE (64)
 #define	ITERATIVE_TIMES	(16)
 #define	BASE_MV_MB_NMB	((2*(MV_RANGE+ITERATIVE_TIMES)/MB_WIDTH_LUMA)-1)
+#define	ME_UMH_RANGE	(16)	// reach of cross and multi-hexagon steps in ME_PRESET_SLOW, full pel
+#define	ME_COARSE_RANGE	(8)	// window of half resolution search in ME_PRESET_SLOW, half pel units of full resolution
 
 union SadPredISatdUnit {
 uint32_t	uiSadPred;
@@ -127,6 +129,47 @@ void WelsMotionEstimateInitialPoint (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
 void WelsMotionEstimateIterativeSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, const int32_t kiStrideEnc,
                                         const int32_t kiStrideRef, uint8_t* pRef);
 
+/*!
+ * \brief	integer pel search methods selected by ME_SEARCH_PRESET, starting from pMe->sMv (full pel) at pRef
+ *
+ * \param	pFuncList	function list of encoder
+ * \param	pLpme	        Wels me information
+ * \param	pLpslice	slice holding the mv range
+ *
+ * \return	NONE
+ */
+void WelsMotionEstimateDiamondSearch (SWelsFuncPtrList* pFuncList, void* pLpme, void* pLpslice, const int32_t kiStrideEnc,
+                                      const int32_t kiStrideRef, uint8_t* pRef);
+void WelsMotionEstimateHexagonSearch (SWelsFuncPtrList* pFuncList, void* pLpme, void* pLpslice, const int32_t kiStrideEnc,
+                                      const int32_t kiStrideRef, uint8_t* pRef);
+void WelsMotionEstimateUmhSearch (SWelsFuncPtrList* pFuncList, void* pLpme, void* pLpslice, const int32_t kiStrideEnc,
+                                  const int32_t kiStrideRef, uint8_t* pRef);
+
+void WelsInitMeFunc (SWelsFuncPtrList* pFuncList, const ME_SEARCH_PRESET keSearchPreset);
+
+/*!
+ * \brief	build half resolution planes of encoding and reference picture for coarse search
+ *
+ * \param	pCurDqLayer	current layer, pCoarseEncData and pCoarseRefData must be allocated
+ *
+ * \return	NONE
+ */
+void WelsMeDownsamplePlanes (SDqLayer* pCurDqLayer);
+
+/*!
+ * \brief	16x16 search on the half resolution planes, the result is used as candidate of full resolution search
+ *
+ * \param	pFuncList	function list of encoder
+ * \param	pCurDqLayer	current layer holding the half resolution planes
+ * \param	pMe	        Wels me information, sMvp and pMvdCost are used
+ * \param	pSlice	        slice holding the mv range
+ * \param	pMv	        best vector found in quarter pel
+ *
+ * \return	NONE
+ */
+void WelsMotionEstimateCoarseSearch (SWelsFuncPtrList* pFuncList, SDqLayer* pCurDqLayer, SWelsME* pMe, SSlice* pSlice,
+                                     const int32_t kiMbX, const int32_t kiMbY, SMVUnitXY* pMv);
+
 bool WelsMeSadCostSelect (int32_t* pSadCost, const uint16_t* kpMvdCost, int32_t* pBestCost, const int32_t kiDx,
                             const int32_t kiDy, int32_t* pIx, int32_t* pIy);
 
@@ -0,0 +1,68 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	svc_set_mb_syn_cabac.h
+ *
+ * \brief	Seting all syntax elements of mb and encoding residual with cabac
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef SVC_SET_MB_SYN_CABAC_H_
+#define SVC_SET_MB_SYN_CABAC_H_
+
+#include "typedefs.h"
+#include "wels_common_basis.h"
+#include "encoder_context.h"
+#include "set_mb_syn_cabac.h"
+
+namespace WelsSVCEnc {
+
+/*!
+ * \brief	write cabac_alignment_one_bit after slice header, initialize context variables and arithmetic coder of slice
+ */
+void WelsInitSliceCabac (sWelsEncCtx* pEncCtx, SSlice* pSlice);
+
+/*!
+ * \brief	end slice data with end_of_slice_flag of the last MB, bit-stream of slice is byte aligned after it
+ */
+void WelsWriteSliceEndSynCabac (SSlice* pSlice);
+
+//for CABAC writing of MB syntax, including mb_skip_flag and end_of_slice_flag of the previous MB
+int32_t WelsSpatialWriteMbSynCabac (void* pEncCtx, SSlice* pSlice, SMB* pCurMb);
+
+void StashMBStatusCabac (SDynamicSlicingStack* pDss, SSlice* pSlice);
+void StashPopMBStatusCabac (SDynamicSlicingStack* pDss, SSlice* pSlice);
+
+}
+#endif
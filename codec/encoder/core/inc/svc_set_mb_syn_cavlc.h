@@ -56,8 +56,13 @@ void WelsSpatialWriteSubMbPred (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurM
 
 void WelsSpatialWriteMbPred (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb);
 
-//for Base Layer CAVLC writing
-int32_t WelsSpatialWriteMbSyn (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb);
+int32_t CheckBitstreamBuffer (const uint8_t kuiSliceIdx, sWelsEncCtx* pEncCtx, SBitStringAux* pBs);
+
+//for Base Layer CAVLC writing, P_Skip MBs are counted into mb_skip_run written before the next coded MB
+int32_t WelsSpatialWriteMbSyn (void* pEncCtx, SSlice* pSlice, SMB* pCurMb);
+
+void StashMBStatusCavlc (SDynamicSlicingStack* pDss, SSlice* pSlice);
+void StashPopMBStatusCavlc (SDynamicSlicingStack* pDss, SSlice* pSlice);
 
 }
 #endif
@@ -99,6 +99,8 @@
 
 #define MAX_SLICEGROUP_IDS		8	// Count number of SSlice Groups
 #define MAX_THREADS_NUM			4	// assume to support up to 4 logical cores(threads)
+#define MAX_LOOKAHEAD_FRAMES	32	// maximal count of frames buffered by lookahead rate control
+#define MAX_ENC_CTX_POOL_SIZE	4	// maximal count of encoder contexts kept for other configurations
 
 #define ALIGN_RBSP_LEN_FIX		4
 
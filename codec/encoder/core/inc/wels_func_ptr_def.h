@@ -114,6 +114,8 @@ typedef bool (*PInterMdFirstIntraModeFunc) (void* pEncCtx, void* pWelsMd, SMB* p
 
 typedef void (*PMotionSearchFunc) (SWelsFuncPtrList* pFuncList, void* pCurDqLayer, void* pMe,
                                    void* pSlice);  // here after reset all function pointers, will set as right parameter type
+typedef void (*PSearchMethodFunc) (SWelsFuncPtrList* pFuncList, void* pMe, void* pSlice, const int32_t kiStrideEnc,
+                                   const int32_t kiStrideRef, uint8_t* pRef);
 typedef void (*PFillInterNeighborCacheFunc) (SMbCache* pMbCache, SMB* pCurMb, int32_t iMbWidth, int8_t* pVaaBgMbFlag);
 typedef void (*PAccumulateSadFunc) (uint32_t* pSumDiff, int32_t* pGomForegroundBlockNum, int32_t* iSad8x8,
                                     int8_t* pVaaBgMbFlag);//for RC
@@ -127,6 +129,9 @@ typedef void (*PInterMdBackgroundInfoUpdateFunc) (SDqLayer* pCurLayer,  SMB* pCu
 
 typedef void (*PInterMdFunc) (void* pEncCtx, void* pWelsMd, SSlice* slice, SMB* pCurMb, SMbCache* pMbCache);
 
+typedef int32_t (*PSpatialWriteMbSynFunc) (void* pEncCtx, SSlice* pSlice, SMB* pCurMb);
+typedef void (*PStashMBStatusFunc) (SDynamicSlicingStack* pDss, SSlice* pSlice);
+
 typedef int32_t (*PSampleSadSatdCostFunc) (uint8_t*, int32_t, uint8_t*, int32_t);
 typedef void (*PSample4SadCostFunc) (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
 typedef int32_t (*PIntraPred4x4Combined3Func) (uint8_t*, int32_t, uint8_t*, int32_t, uint8_t*, int32_t*, int32_t,
@@ -176,6 +181,10 @@ struct TagWelsFuncPointerList {
   PInterMdBackgroundDecisionFunc          pfInterMdBackgroundDecision;
   PInterMdBackgroundInfoUpdateFunc      pfInterMdBackgroundInfoUpdate;
 
+  PSpatialWriteMbSynFunc		pfWelsSpatialWriteMbSyn;	// cavlc or cabac by entropy_coding_mode_flag of layer
+  PStashMBStatusFunc			pfStashMBStatus;		// for dynamic slicing step back
+  PStashMBStatusFunc			pfStashPopMBStatus;
+
   SMcFunc				        sMcFuncs;
   SSampleDealingFunc     sSampleDealingFuncs;
   PGetIntraPredFunc 		pfGetLumaI16x16Pred[I16_PRED_DC_A];
@@ -183,6 +192,7 @@ struct TagWelsFuncPointerList {
   PGetIntraPredFunc 		pfGetChromaPred[C_PRED_A];
   PMotionSearchFunc
   pfMotionSearch; //svc_encode_slice.c svc_mode_decision.c svc_enhance_layer_md.c svc_base_layer_md.c
+  PSearchMethodFunc		pfSearchMethod;	// integer pel search from the initial point, by ME_SEARCH_PRESET
 
   PCopyFunc      pfCopy16x16Aligned;		//svc_encode_slice.c svc_mode_decision.c svc_base_layer_md.c
   PCopyFunc      pfCopy16x16NotAligned;	//md.c
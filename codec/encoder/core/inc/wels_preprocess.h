@@ -113,6 +113,7 @@ class CWelsPreProcess {
   int32_t BuildSpatialPicList (sWelsEncCtx* pEncCtx, const SSourcePicture** kppSrcPicList, const int32_t kiConfiguredLayerNum);
   int32_t AnalyzeSpatialPic (sWelsEncCtx* pEncCtx, const int32_t kiDIdx);
   int32_t UpdateSpatialPictures(sWelsEncCtx* pEncCtx, SWelsSvcCodingParam* pParam, const int8_t iCurTid, const int32_t d_idx);
+  int32_t GetInputPicture (sWelsEncCtx* pEncCtx, SSourcePicture* pSrcPic);
 
  private:
   int32_t WelsPreprocessCreate();
@@ -124,6 +125,7 @@ class CWelsPreProcess {
   int32_t MultiLayerPreprocess (sWelsEncCtx* pEncCtx, const SSourcePicture** kppSrcPicList, const int32_t kiSpatialNum);
 
   void	BilateralDenoising (SPicture* pSrc, const int32_t iWidth, const int32_t iHeight);
+  void	TemporalDenoising (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture);
   bool  DetectSceneChange (SPicture* pCurPicture, SPicture* pRefPicture);
   int32_t DownsamplePadding (SPicture* pSrc, SPicture* pDstPic,  int32_t iSrcWidth, int32_t iSrcHeight,
                              int32_t iShrinkWidth, int32_t iShrinkHeight, int32_t iTargetWidth, int32_t iTargetHeight);
@@ -140,8 +142,8 @@ class CWelsPreProcess {
 
   int32_t ColorspaceConvert (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic, const SSourcePicture* kpSrc,
                              const int32_t kiWidth, const int32_t kiHeight);
-  void WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic, const SSourcePicture* kpSrc,
-                              const int32_t kiWidth, const int32_t kiHeight);
+  int32_t WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic, const SSourcePicture* kpSrc,
+                                 const int32_t kiWidth, const int32_t kiHeight);
 
  private:
   Scaled_Picture   m_sScaledPicture;
@@ -151,6 +153,8 @@ class CWelsPreProcess {
   sWelsEncCtx*     m_pEncCtx;
   bool             m_bInitDone;
   bool             m_bOfficialBranch;
+  int32_t          m_iFrameIdx;		// frames through BuildSpatialPicList(), wraps
+  int32_t          m_iVaaFrameIdx;	// m_iFrameIdx whose vaa statistics scene change detection did, -1 if none
   /* For Downsampling & VAA I420 based source pictures */
   SPicture*        m_pSpatialPic[MAX_DEPENDENCY_LAYER][MAX_TEMPORAL_LEVEL + 1 +
       LONG_TERM_REF_NUM];	// need memory requirement with total number of (log2(uiGopSize)+1+1+long_term_ref_num)
@@ -283,7 +283,7 @@ int32_t WelsWritePpsSyntax (SWelsPPS* pPps, SBitStringAux* pBitStringAux, SParaS
   }
 #endif
 
-  BsWriteOneBit (pLocalBitStringAux, false/*pPps->entropy_coding_mode_flag*/);
+  BsWriteOneBit (pLocalBitStringAux, pPps->bEntropyCodingModeFlag);
   BsWriteOneBit (pLocalBitStringAux, false/*pPps->bPicOrderPresentFlag*/);
 
 #ifdef DISABLE_FMO_FEATURE
@@ -432,7 +432,8 @@ int32_t WelsInitPps (SWelsPPS* pPps,
                      SSubsetSps* pSubsetSps,
                      const uint32_t kuiPpsId,
                      const bool kbDeblockingFilterPresentFlag,
-                     const bool kbUsingSubsetSps) {
+                     const bool kbUsingSubsetSps,
+                     const bool kbEntropyCodingModeFlag) {
   SWelsSPS* pUsedSps = NULL;
   if (pPps == NULL || (pSps == NULL && pSubsetSps == NULL))
     return 1;
@@ -480,6 +481,7 @@ int32_t WelsInitPps (SWelsPPS* pPps,
 
   pPps->uiChromaQpIndexOffset					= 0;
   pPps->bDeblockingFilterControlPresentFlag	= kbDeblockingFilterPresentFlag;
+  pPps->bEntropyCodingModeFlag	= kbEntropyCodingModeFlag;
 
   return 0;
 }
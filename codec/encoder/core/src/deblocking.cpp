@@ -39,6 +39,7 @@
  */
 
 #include "deblocking.h"
+#include "expand_pic.h"
 #include "cpu_core.h"
 
 namespace WelsSVCEnc {
@@ -673,6 +674,40 @@ void  DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc) {
   }
 }
 
+void DeblockingFilterRowAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, const int32_t kiMbY) {
+  int32_t i;
+  const int32_t kiMbWidth	= pCurDq->iMbWidth;
+  SMB* pCurrentMbBlock	= pCurDq->sMbDataP + kiMbY * kiMbWidth;
+  SSliceHeaderExt* sSliceHeaderExt = &pCurDq->sLayerInfo.pSliceInLayer[0].sSliceHeaderExt;
+  SDeblockingFilter pFilter;
+
+  if (sSliceHeaderExt->sSliceHeader.uiDisableDeblockingFilterIdc == 1)
+    return;
+
+  // offsets are the same in all slices of the layer, boundaries of slices are checked MB by MB for idc 2
+  pFilter.uiFilterIdc = (sSliceHeaderExt->sSliceHeader.uiDisableDeblockingFilterIdc != 0);
+
+  pFilter.iCsStride[0] = pCurDq->pDecPic->iLineSize[0];
+  pFilter.iCsStride[1] = pCurDq->pDecPic->iLineSize[1];
+  pFilter.iCsStride[2] = pCurDq->pDecPic->iLineSize[2];
+
+  pFilter.iSliceAlphaC0Offset = sSliceHeaderExt->sSliceHeader.iSliceAlphaC0Offset;
+  pFilter.iSliceBetaOffset     = sSliceHeaderExt->sSliceHeader.iSliceBetaOffset;
+
+  pFilter.iMbStride = kiMbWidth;
+
+  pFilter.pCsData[0] = pCurDq->pDecPic->pData[0] + ((kiMbY * pFilter.iCsStride[0]) << 4);
+  pFilter.pCsData[1] = pCurDq->pDecPic->pData[1] + ((kiMbY * pFilter.iCsStride[1]) << 3);
+  pFilter.pCsData[2] = pCurDq->pDecPic->pData[2] + ((kiMbY * pFilter.iCsStride[2]) << 3);
+  for (i = 0; i < kiMbWidth; i++) {
+    DeblockingMbAvcbase (pFunc, pCurrentMbBlock, &pFilter);
+    ++pCurrentMbBlock;
+    pFilter.pCsData[0] += MB_WIDTH_LUMA;
+    pFilter.pCsData[1] += MB_WIDTH_CHROMA;
+    pFilter.pCsData[2] += MB_WIDTH_CHROMA;
+  }
+}
+
 void DeblockingFilterSliceAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, const int32_t kiSliceIdx) {
   SSliceCtx* pSliceCtx			= pCurDq->pSliceEncCtx;
   SMB* pMbList							= pCurDq->sMbDataP;
@@ -757,6 +792,28 @@ void PerformDeblockingFilter (sWelsEncCtx* pEnc) {
   }
 }
 
+void PerformDeblockingFilterRows (sWelsEncCtx* pEnc, const int32_t kiMbRowsCoded) {
+  SDqLayer* pCurLayer			= pEnc->pCurDqLayer;
+  const int32_t kiMbHeight	= pCurLayer->iMbHeight;
+  const bool kbLastRow		= (kiMbRowsCoded == kiMbHeight);
+  int32_t iMbY;
+
+  // the intra prediction of a MB row takes unfiltered samples of the row above, so a row is filtered only once the
+  // row below it is coded, except for the last row
+  if (pCurLayer->bDeblockingRowFlag) {
+    for (iMbY = WELS_MAX (kiMbRowsCoded - 2, 0); iMbY < (kbLastRow ? kiMbHeight : kiMbRowsCoded - 1); ++ iMbY)
+      DeblockingFilterRowAvcbase (pCurLayer, pEnc->pFuncList, iMbY);
+  }
+
+  // the bottom of a MB row is changed by filtering the row below it, so it is final one row later again
+  if (pCurLayer->bExpandingRowFlag) {
+    const int32_t kiRowStart	= WELS_MAX (kiMbRowsCoded - 3, 0);
+    const int32_t kiRowEnd	= kbLastRow ? kiMbHeight : (kiMbRowsCoded - 2);
+    if (kiRowEnd > kiRowStart)
+      ExpandReferencingPictureRows (pCurLayer->pDecPic, kiRowStart << 4, kiRowEnd << 4);
+  }
+}
+
 void WelsNonZeroCount_c (int8_t* pNonZeroCount) {
   int32_t i;
   int32_t iIndex;
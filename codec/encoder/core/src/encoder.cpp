@@ -89,6 +89,16 @@ int32_t InitPic (const void* kpSrc, const int32_t kiColorspace, const int32_t ki
     pSrcPic->iStride[2]	= pSrcPic->iStride[1] = kiWidth >> 1;
     pSrcPic->iStride[3]	= 0;
     break;
+  case videoFormatNV12:
+  case videoFormatNV21:
+    pSrcPic->pData[0]	= NULL;
+    pSrcPic->pData[1]	= NULL;
+    pSrcPic->pData[2]	= NULL;
+    pSrcPic->pData[3]	= NULL;
+    pSrcPic->iStride[0]	= kiWidth;
+    pSrcPic->iStride[1]	= kiWidth;
+    pSrcPic->iStride[3]	= pSrcPic->iStride[2] = 0;
+    break;
   case videoFormatYUY2:
   case videoFormatYVYU:
   case videoFormatUYVY:
@@ -179,6 +189,7 @@ int32_t InitFunctionPointers (SWelsFuncPtrList* pFuncList, SWelsSvcCodingParam*
 
   //
   WelsInitBGDFunc (pFuncList, pParam->bEnableBackgroundDetection);
+  WelsInitMeFunc (pFuncList, pParam->eMotionSearchPreset);
   // for pfGetVarianceFromIntraVaa function ptr adaptive by CPU features, 6/7/2010
   InitIntraAnalysisVaaInfo (pFuncList, uiCpuFlag);
 
@@ -187,6 +198,7 @@ int32_t InitFunctionPointers (SWelsFuncPtrList* pFuncList, SWelsSvcCodingParam*
   /*get one column or row pixel when refinement*/
   WelsInitMcFuncs (pFuncList, uiCpuFlag);
   InitCoeffFunc (uiCpuFlag);
+  WelsInitNalEncapFunc (uiCpuFlag);
 
   WelsInitEncodingFuncs (pFuncList, uiCpuFlag);
   WelsInitReconstructionFuncs (pFuncList, uiCpuFlag);
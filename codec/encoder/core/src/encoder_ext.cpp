@@ -46,6 +46,8 @@
 #include "picture_handle.h"
 #include "svc_base_layer_md.h"
 #include "svc_encode_slice.h"
+#include "svc_set_mb_syn_cavlc.h"
+#include "svc_set_mb_syn_cabac.h"
 #include "decode_mb_aux.h"
 #include "deblocking.h"
 #include "ref_list_mgr_svc.h"
@@ -53,6 +55,7 @@
 #include "crt_util_safe_x.h"	// Safe CRT routines like utils for cross platforms
 #if defined(MT_ENABLED)
 #include "slice_multi_threading.h"
+#include "mb_row_multi_threading.h"
 #endif//MT_ENABLED
 #if defined(DYNAMIC_SLICE_ASSIGN) || defined(MT_DEBUG)
 #include "measure_time.h"
@@ -741,10 +744,47 @@ void FreeMbCache (SMbCache* pMbCache, CMemoryAlign* pMa) {
  * \pParam	pCtx			sWelsEncCtx*
  * \return	0 - successful; otherwise failed
  */
+/*!
+ * \brief	initialize sps (or subset sps) and pps of dependency layer kiDlayerIndex with current coding parameters
+ * \return	sps of the layer
+ */
+static SWelsSPS* InitLayerParaSets (sWelsEncCtx* pCtx, const int32_t kiDlayerIndex, const uint32_t kuiSpsId,
+                                    const uint32_t kuiPpsId) {
+  SWelsSvcCodingParam* pParam	= pCtx->pSvcParam;
+  SDLayerParam* pDlayerParam	= &pParam->sDependencyLayers[kiDlayerIndex];
+  const bool kbUseSubsetSps		= (kiDlayerIndex > BASE_DEPENDENCY_ID);
+  SWelsPPS* pPps					= &pCtx->pPPSArray[kuiPpsId];
+  SSubsetSps* pSubsetSps			= NULL;
+  SWelsSPS* pSps					= NULL;
+
+  // Need port pSps/pPps initialization due to spatial scalability changed
+  if (!kbUseSubsetSps) {
+    pSps	= &pCtx->pSpsArray[kuiSpsId];
+    WelsInitSps (pSps, pDlayerParam, pParam->uiIntraPeriod, pParam->iNumRefFrame, kuiSpsId,
+                 pParam->bEnableFrameCroppingFlag, pParam->bEnableRc);
+
+    if (pParam->iSpatialLayerNum > 1) {
+      // CABAC base layer is only Main profile compliant
+      pSps->bConstraintSet0Flag = !pDlayerParam->bEntropyCodingModeFlag;
+      pSps->bConstraintSet1Flag = true;
+      pSps->bConstraintSet2Flag = !pDlayerParam->bEntropyCodingModeFlag;
+    }
+  } else {
+    pSubsetSps	= &pCtx->pSubsetArray[kuiSpsId];
+    pSps		= &pSubsetSps->pSps;
+    WelsInitSubsetSps (pSubsetSps, pDlayerParam, pParam->uiIntraPeriod, pParam->iNumRefFrame, kuiSpsId,
+                       pParam->bEnableFrameCroppingFlag, pParam->bEnableRc);
+  }
+
+  // initialize pPps
+  WelsInitPps (pPps, pSps, pSubsetSps, kuiPpsId, true, kbUseSubsetSps, pDlayerParam->bEntropyCodingModeFlag);
+
+  return pSps;
+}
+
 static inline int32_t InitDqLayers (sWelsEncCtx** ppCtx) {
   SWelsSvcCodingParam* pParam	= NULL;
   SWelsSPS* pSps						= NULL;
-  SSubsetSps* pSubsetSps			= NULL;
   SWelsPPS* pPps						= NULL;
   CMemoryAlign* pMa				= NULL;
   SStrideTables* pStrideTab		= NULL;
@@ -827,6 +867,19 @@ static inline int32_t InitDqLayers (sWelsEncCtx** ppCtx) {
 
     pDqLayer->iMbWidth					= kiMbW;
     pDqLayer->iMbHeight					= kiMbH;
+
+    // half resolution planes for coarse motion search, the reference one keeps half of the padding
+    if (ME_PRESET_SLOW == pParam->eMotionSearchPreset) {
+      const int32_t kiCoarseStride	= (kiMbW << 3) + PADDING_LENGTH;
+
+      pDqLayer->iCoarseStride		= kiCoarseStride;
+      pDqLayer->pCoarseEncData	= (uint8_t*)pMa->WelsMalloc (kiCoarseStride * (kiMbH << 3), "pCoarseEncData");
+      pDqLayer->pCoarseRefData	= (uint8_t*)pMa->WelsMalloc (kiCoarseStride * ((kiMbH << 3) + PADDING_LENGTH),
+                                  "pCoarseRefData");
+      WELS_VERIFY_RETURN_PROC_IF (1, (NULL == pDqLayer->pCoarseEncData || NULL == pDqLayer->pCoarseRefData),
+                                  FreeMemorySvc (ppCtx))
+      pDqLayer->pCoarseRefData	+= (PADDING_LENGTH >> 1) * (kiCoarseStride + 1);
+    }
 #ifndef MT_ENABLED
     if (SM_DYN_SLICE == pDlayer->sSliceCfg.uiSliceMode) { //wmalloc pSliceInLayer
       SSlice* pSlice			= NULL;
@@ -948,30 +1001,7 @@ static inline int32_t InitDqLayers (sWelsEncCtx** ppCtx) {
 
     pDqIdc->uiSpatialId	= iDlayerIndex;
     pPps	= & (*ppCtx)->pPPSArray[iPpsId];
-    if (!bUseSubsetSps) {
-      pSps	= & (*ppCtx)->pSpsArray[iSpsId];
-    } else {
-      pSubsetSps	= & (*ppCtx)->pSubsetArray[iSpsId];
-      pSps			= &pSubsetSps->pSps;
-    }
-
-    // Need port pSps/pPps initialization due to spatial scalability changed
-    if (!bUseSubsetSps) {
-      WelsInitSps (pSps, pDlayerParam, pParam->uiIntraPeriod, pParam->iNumRefFrame, iSpsId,
-                   pParam->bEnableFrameCroppingFlag, pParam->bEnableRc);
-
-      if (iDlayerCount > 1) {
-        pSps->bConstraintSet0Flag = true;
-        pSps->bConstraintSet1Flag = true;
-        pSps->bConstraintSet2Flag = true;
-      }
-    } else {
-      WelsInitSubsetSps (pSubsetSps, pDlayerParam, pParam->uiIntraPeriod, pParam->iNumRefFrame, iSpsId,
-                         pParam->bEnableFrameCroppingFlag, pParam->bEnableRc);
-    }
-
-    // initialize pPps
-    WelsInitPps (pPps, pSps, pSubsetSps, iPpsId, true, bUseSubsetSps);
+    pSps	= InitLayerParaSets (*ppCtx, iDlayerIndex, iSpsId, iPpsId);
 
     // Not using FMO in SVC coding so far, come back if need FMO
     {
@@ -1349,7 +1379,8 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx) {
 
 #ifdef MT_ENABLED
   if (pParam->iMultipleThreadIdc > 1) {
-    const int32_t iTotalLength = iCountBsLen + (iTargetSpatialBsSize * ((*ppCtx)->iMaxSliceCount - 1));
+    // iMaxSliceCount is 0 if all layers are single slice, which happens with wavefront MB rows
+    const int32_t iTotalLength = iCountBsLen + (iTargetSpatialBsSize * (WELS_MAX ((*ppCtx)->iMaxSliceCount, 1) - 1));
     (*ppCtx)->pFrameBs			= (uint8_t*)pMa->WelsMalloc (iTotalLength, "pFrameBs");
     WELS_VERIFY_RETURN_PROC_IF (1, (NULL == (*ppCtx)->pFrameBs), FreeMemorySvc (ppCtx))
     (*ppCtx)->iFrameBsSize = iTotalLength;
@@ -1369,6 +1400,11 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx) {
     FreeMemorySvc (ppCtx);
     return 1;
   }
+  if (pParam->iMultipleThreadIdc > 1 && RequestMbRowThreading (*ppCtx, pParam)) {
+    WelsLog (*ppCtx, WELS_LOG_WARNING, "RequestMemorySvc(), RequestMbRowThreading failed!");
+    FreeMemorySvc (ppCtx);
+    return 1;
+  }
 #endif
 
   (*ppCtx)->pIntra4x4PredModeBlocks = static_cast<int8_t*>
@@ -1424,6 +1460,12 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx) {
   WELS_VERIFY_RETURN_PROC_IF (1, (NULL == (*ppCtx)->pWelsSvcRc), FreeMemorySvc (ppCtx))
   //End of Rate control module memory allocation
 
+  if (WelsLookaheadInit (*ppCtx)) {
+    WelsLog (*ppCtx, WELS_LOG_WARNING, "RequestMemorySvc(), WelsLookaheadInit failed!");
+    FreeMemorySvc (ppCtx);
+    return 1;
+  }
+
   //pVaa memory allocation
   (*ppCtx)->pVaa	= (SVAAFrameInfo*)pMa->WelsMallocz (sizeof (SVAAFrameInfo), "pVaa");
   WELS_VERIFY_RETURN_PROC_IF (1, (NULL == (*ppCtx)->pVaa), FreeMemorySvc (ppCtx))
@@ -1483,6 +1525,11 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx) {
   WELS_VERIFY_RETURN_PROC_IF (1, (NULL == (*ppCtx)->pMvdCostTableInter), FreeMemorySvc (ppCtx))
   MvdCostInit ((*ppCtx)->pMvdCostTableInter, kuiMvdInterTableSize);  //should put to a better place?
 
+  (*ppCtx)->pMvdCostTableInterCabac = (uint16_t*)pMa->WelsMallocz (52 * kuiMvdCacheAlginedSize,
+                                      "pMvdCostTableInterCabac");
+  WELS_VERIFY_RETURN_PROC_IF (1, (NULL == (*ppCtx)->pMvdCostTableInterCabac), FreeMemorySvc (ppCtx))
+  MvdCostInitCabac ((*ppCtx)->pMvdCostTableInterCabac, kuiMvdInterTableSize);
+
   if ((*ppCtx)->ppRefPicListExt[0] != NULL && (*ppCtx)->ppRefPicListExt[0]->pRef[0] != NULL)
     (*ppCtx)->pDecPic				= (*ppCtx)->ppRefPicListExt[0]->pRef[0];
   else
@@ -1538,6 +1585,7 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
     }
 
 #ifdef MT_ENABLED
+    ReleaseMbRowThreading (pCtx);	// before slice threading, it may use its thread pool
     if (pParam != NULL && pParam->iMultipleThreadIdc > 1)
       ReleaseMtResource (ppCtx);
 #endif//MT_ENABLED
@@ -1628,6 +1676,14 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
             pMa->WelsFree (pDq->sLayerInfo.pSliceInLayer, "pSliceInLayer");
             pDq->sLayerInfo.pSliceInLayer = NULL;
           }
+          if (NULL != pDq->pCoarseEncData) {
+            pMa->WelsFree (pDq->pCoarseEncData, "pCoarseEncData");
+            pDq->pCoarseEncData = NULL;
+          }
+          if (NULL != pDq->pCoarseRefData) {
+            pMa->WelsFree (pDq->pCoarseRefData - (PADDING_LENGTH >> 1) * (pDq->iCoarseStride + 1), "pCoarseRefData");
+            pDq->pCoarseRefData = NULL;
+          }
           if (kbIsDynamicSlicing) {
             pMa->WelsFree (pDq->pNumSliceCodedOfPartition, "pNumSliceCodedOfPartition");
             pDq->pNumSliceCodedOfPartition	= NULL;
@@ -1715,6 +1771,8 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
       pCtx->pVaa = NULL;
     }
 
+    WelsLookaheadUninit (pCtx);
+
     WelsRcFreeMemory (pCtx);
     // rate control module memory free
     if (NULL != pCtx->pWelsSvcRc) {
@@ -1727,6 +1785,10 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
       pMa->WelsFree (pCtx->pMvdCostTableInter, "pMvdCostTableInter");
       pCtx->pMvdCostTableInter = NULL;
     }
+    if (NULL != pCtx->pMvdCostTableInterCabac) {
+      pMa->WelsFree (pCtx->pMvdCostTableInterCabac, "pMvdCostTableInterCabac");
+      pCtx->pMvdCostTableInterCabac = NULL;
+    }
 
 #ifdef ENABLE_TRACE_FILE
     if (NULL != pCtx->pFileLog) {
@@ -1823,7 +1885,11 @@ int32_t InitSliceSettings (SWelsSvcCodingParam* pCodingParam, const int32_t kiCp
   } while (iSpatialIdx < iSpatialNum);
 
 #ifdef MT_ENABLED
-  pCodingParam->iCountThreadsNum				= WELS_MIN (kiCpuCores, iMaxSliceCount);
+  // MB rows of a slice are coded in parallel in wavefront mode, so threads are not limited by slices
+  if (pCodingParam->bEnableWavefront)
+    pCodingParam->iCountThreadsNum				= WELS_MIN (kiCpuCores, MAX_THREADS_NUM);
+  else
+    pCodingParam->iCountThreadsNum				= WELS_MIN (kiCpuCores, iMaxSliceCount);
   pCodingParam->iMultipleThreadIdc	= pCodingParam->iCountThreadsNum;
 #else
   pCodingParam->iMultipleThreadIdc	= 1;
@@ -1937,6 +2003,61 @@ void OutputCpuFeaturesLog (uint32_t uiCpuFeatureFlags, uint32_t uiCpuCores, int3
 #endif//_DEBUG
 }
 
+/*!
+ * \brief	detect cpu capacity features, number of logic processors and on chip cache line size
+ * \return	cpu feature flags, 0 if not detected
+ */
+static uint32_t DetectCpuFeatures (int32_t* pCpuCores, int32_t* pCacheLineSize) {
+  uint32_t uiCpuFeatureFlags	= 0;
+
+  *pCacheLineSize	= 16;	// 16 bytes aligned in default
+#ifdef X86_ASM
+  uiCpuFeatureFlags	= WelsCPUFeatureDetect (pCpuCores);	// detect cpu capacity features
+  if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_128)
+    *pCacheLineSize = 128;
+  else if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_64)
+    *pCacheLineSize = 64;
+  else if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_32)
+    *pCacheLineSize	= 32;
+  else if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_16)
+    *pCacheLineSize	= 16;
+#endif//X86_ASM
+
+  return uiCpuFeatureFlags;
+}
+
+/*!
+ * \brief	decide number of cpu cores slices and threads are planned with
+ */
+static int32_t DecideCpuCores (SWelsSvcCodingParam* pCodingParam, const uint32_t kuiCpuFeatureFlags,
+                               int32_t iCpuCores) {
+#ifndef WELS_TESTBED
+
+#if defined(MT_ENABLED) && defined(DYNAMIC_DETECT_CPU_CORES)
+  if (pCodingParam->iMultipleThreadIdc > 0)
+    iCpuCores = pCodingParam->iMultipleThreadIdc;
+  else {
+    if (kuiCpuFeatureFlags ==
+        0)	// cpuid not supported, use high level system API as followed to detect number of pysical/logic processor
+      iCpuCores = DynamicDetectCpuCores();
+    // So far so many cpu cores up to MAX_THREADS_NUM mean for server platforms,
+    // for client application here it is constrained by maximal to MAX_THREADS_NUM
+    if (iCpuCores > MAX_THREADS_NUM)	// MAX_THREADS_NUM
+      iCpuCores	= MAX_THREADS_NUM;	// MAX_THREADS_NUM
+    else if (iCpuCores < 1)	// just for safe
+      iCpuCores	= 1;
+  }
+#endif//MT_ENABLED && DYNAMIC_DETECT_CPU_CORES
+
+#else//WELS_TESTBED
+
+  iCpuCores	= pCodingParam->iMultipleThreadIdc;	// assigned uiCpuCores from iMultipleThreadIdc from SGE testing
+
+#endif//WELS_TESTBED
+
+  return WELS_CLIP3 (iCpuCores, 1, MAX_THREADS_NUM);
+}
+
 /*!
  * \brief	initialize Wels avc encoder core library
  * \pParam	ppCtx		sWelsEncCtx**
@@ -1965,46 +2086,12 @@ int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPar
   }
 
   // for cpu features detection, Only detect once??
+  uiCpuFeatureFlags	= DetectCpuFeatures (&uiCpuCores, &iCacheLineSize);
 #ifdef X86_ASM
-  uiCpuFeatureFlags	= WelsCPUFeatureDetect (&uiCpuCores);	// detect cpu capacity features
-  if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_128)
-    iCacheLineSize = 128;
-  else if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_64)
-    iCacheLineSize = 64;
-  else if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_32)
-    iCacheLineSize	= 32;
-  else if (uiCpuFeatureFlags & WELS_CPU_CACHELINE_16)
-    iCacheLineSize	= 16;
   OutputCpuFeaturesLog (uiCpuFeatureFlags, uiCpuCores, iCacheLineSize);
-#else
-  iCacheLineSize	= 16;	// 16 bytes aligned in default
 #endif//X86_ASM
 
-#ifndef WELS_TESTBED
-
-#if defined(MT_ENABLED) && defined(DYNAMIC_DETECT_CPU_CORES)
-  if (pCodingParam->iMultipleThreadIdc > 0)
-    uiCpuCores = pCodingParam->iMultipleThreadIdc;
-  else {
-    if (uiCpuFeatureFlags ==
-        0)	// cpuid not supported, use high level system API as followed to detect number of pysical/logic processor
-      uiCpuCores = DynamicDetectCpuCores();
-    // So far so many cpu cores up to MAX_THREADS_NUM mean for server platforms,
-    // for client application here it is constrained by maximal to MAX_THREADS_NUM
-    if (uiCpuCores > MAX_THREADS_NUM)	// MAX_THREADS_NUM
-      uiCpuCores	= MAX_THREADS_NUM;	// MAX_THREADS_NUM
-    else if (uiCpuCores < 1)	// just for safe
-      uiCpuCores	= 1;
-  }
-#endif//MT_ENABLED && DYNAMIC_DETECT_CPU_CORES
-
-#else//WELS_TESTBED
-
-  uiCpuCores	= pCodingParam->iMultipleThreadIdc;	// assigned uiCpuCores from iMultipleThreadIdc from SGE testing
-
-#endif//WELS_TESTBED
-
-  uiCpuCores	= WELS_CLIP3 (uiCpuCores, 1, MAX_THREADS_NUM);
+  uiCpuCores	= DecideCpuCores (pCodingParam, uiCpuFeatureFlags, uiCpuCores);
 
   if (InitSliceSettings (pCodingParam, uiCpuCores, &iSliceNum)) {
     WelsLog (NULL, WELS_LOG_ERROR, "WelsInitEncoderExt(), InitSliceSettings failed.\n");
@@ -2059,7 +2146,7 @@ int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPar
   }
 
 #ifdef MT_ENABLED
-  if (pCodingParam->iMultipleThreadIdc > 1)
+  if (pCodingParam->iMultipleThreadIdc > 1 && NULL == pCtx->pSliceThreading->pThreadPool)
     iRet = CreateSliceThreads (pCtx);
 #endif
 
@@ -2171,6 +2258,8 @@ void StatOverallEncodingExt (sWelsEncCtx* pCtx) {
   }
 }
 #endif
+static void EncCtxPoolRelease (SEncCtxPool** ppPool);
+
 /*!
  * \brief	uninitialize Wels encoder core library
  * \pParam	pEncCtx		sWelsEncCtx*
@@ -2187,8 +2276,11 @@ void WelsUninitEncoderExt (sWelsEncCtx** ppCtx) {
   StatOverallEncodingExt (*ppCtx);
 #endif
 
+  EncCtxPoolRelease (& (*ppCtx)->pCtxPool);
+
 #if defined(MT_ENABLED)
-  if ((*ppCtx)->pSvcParam->iMultipleThreadIdc > 1 && (*ppCtx)->pSliceThreading != NULL) {
+  if ((*ppCtx)->pSvcParam->iMultipleThreadIdc > 1 && (*ppCtx)->pSliceThreading != NULL
+      && NULL == (*ppCtx)->pSliceThreading->pThreadPool) {	// slice tasks on a pool are all done at the end of each frame
     const int32_t iThreadCount = (*ppCtx)->pSvcParam->iCountThreadsNum;
     int32_t iThreadIdx = 0;
 
@@ -2591,7 +2683,19 @@ void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
 
   /* function pointers conditional assignment under sWelsEncCtx, layer_mb_enc_rec (in stack) is exclusive */
 
+  if (pCurLayer->sLayerInfo.pPpsP->bEntropyCodingModeFlag) {
+    pCtx->pFuncList->pfWelsSpatialWriteMbSyn	= WelsSpatialWriteMbSynCabac;
+    pCtx->pFuncList->pfStashMBStatus			= StashMBStatusCabac;
+    pCtx->pFuncList->pfStashPopMBStatus		= StashPopMBStatusCabac;
+  } else {
+    pCtx->pFuncList->pfWelsSpatialWriteMbSyn	= WelsSpatialWriteMbSyn;
+    pCtx->pFuncList->pfStashMBStatus			= StashMBStatusCavlc;
+    pCtx->pFuncList->pfStashPopMBStatus		= StashPopMBStatusCavlc;
+  }
+
   if (P_SLICE == pCtx->eSliceType) {
+    if (NULL != pCurLayer->pCoarseRefData)
+      WelsMeDownsamplePlanes (pCurLayer);
     if (kbBaseAvail) {
       if (pCtx->pSvcParam->iSpatialLayerNum == (pCurLayer->sLayerInfo.sNalHeaderExt.uiDependencyId + 1)) { //
         pCtx->pFuncList->pfMotionSearch = WelsMotionEstimateSearchSad;
@@ -2853,6 +2957,19 @@ int32_t WelsWriteParameterSets (sWelsEncCtx* pCtx, int32_t* pNalLen, int32_t* pN
   return ENC_RETURN_SUCCESS;
 }
 
+/*!
+ * \brief	whether the reconstruction of the current layer is deblocked, along the MB rows or as a whole picture;
+ *			pictures no later picture refers to are left unfiltered unless the reconstruction is dumped
+ */
+static inline bool NeedDeblockingFilter (const SDLayerParam* kpDlp, const EWelsNalRefIdc keNalRefIdc,
+    const int8_t kiCurTid) {
+#if !defined(ENABLE_FRAME_DUMP)
+  if (keNalRefIdc == NRI_PRI_LOWEST || (kpDlp->iHighestTemporalId != 0 && kiCurTid >= kpDlp->iHighestTemporalId))
+    return false;
+#endif//!ENABLE_FRAME_DUMP
+  return true;
+}
+
 static inline int32_t AddPrefixNal (sWelsEncCtx* pCtx,
                                     SLayerBSInfo* pLayerBsInfo,
                                     int32_t* pNalLen,
@@ -3056,6 +3173,14 @@ int32_t WelsEncoderEncodeParameterSets (sWelsEncCtx* pCtx, void* pDst) {
   return ENC_RETURN_SUCCESS;
 }
 
+int32_t WelsEncoderGetInputPicture (sWelsEncCtx* pCtx, SSourcePicture* pSrcPic) {
+  // lookahead buffers a copy of each input anyway
+  if (NULL == pCtx || NULL == pSrcPic || NULL != pCtx->pLookahead)
+    return 1;
+
+  return pCtx->pVpp->GetInputPicture (pCtx, pSrcPic);
+}
+
 /*!
  * \brief	core svc encoding process
  *
@@ -3109,6 +3234,11 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
 
   // perform csc/denoise/downsample/padding, generate spatial layers
   iSpatialNum = pCtx->pVpp->BuildSpatialPicList (pCtx, ppSrcList, iConfiguredLayerNum);
+  if (iSpatialNum < 0) {
+    WelsLog (pCtx, WELS_LOG_ERROR, "WelsEncoderEncodeExt(), the input picture could not be taken, iSpatialNum= %d\n",
+             iSpatialNum);
+    return ENC_RETURN_INVALIDINPUT;
+  }
   if (iSpatialNum < 1) {	// skip due to temporal layer settings (different frame rate)
     ++ pCtx->iCodingIndex;
     pFbi->eOutputFrameType = WELS_FRAME_TYPE_SKIP;
@@ -3258,6 +3388,23 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
     pCtx->pFuncList->pfRc.pfWelsRcPictureInit (pCtx);
     PreprocessSliceCoding (pCtx);	// MUST be called after pfWelsRcPictureInit() and WelsInitCurrentLayer()
 
+    // deblocking and border expansion follow the MB rows as coded while this thread codes the MBs in raster order,
+    // so the rows are filtered before falling out of cache and the reference is ready once the last row is coded
+    {
+      const bool kbDeblocking		= NeedDeblockingFilter (param_d, eNalRefIdc, iCurTid) &&
+                                  (pCtx->pCurDqLayer->iLoopFilterDisableIdc == 0 || pCtx->pCurDqLayer->iLoopFilterDisableIdc == 2);
+      const bool kbExpanding		= (eNalRefIdc != NRI_PRI_LOWEST) && NeedDeblockingFilter (param_d, eNalRefIdc, iCurTid);
+#if defined(MT_ENABLED)
+      const bool kbRowPipelined	= pSvcParam->bRowPipelineFlag && (!pCtx->pCurDqLayer->bDeblockingParallelFlag) &&
+                                  ((SM_SINGLE_SLICE == param_d->sSliceCfg.uiSliceMode) ? (NULL == pCtx->pMbRowThreading) :
+                                   (pSvcParam->iMultipleThreadIdc <= 1));
+#else
+      const bool kbRowPipelined	= pSvcParam->bRowPipelineFlag;
+#endif//MT_ENABLED
+      pCtx->pCurDqLayer->bDeblockingRowFlag	= kbRowPipelined && kbDeblocking;
+      pCtx->pCurDqLayer->bExpandingRowFlag	= kbRowPipelined && kbExpanding;
+    }
+
     iLayerSize	= 0;
 
     if (SM_SINGLE_SLICE == param_d->sSliceCfg.uiSliceMode) {	// only one slice within a sQualityStat layer
@@ -3331,7 +3478,8 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
           return ENC_RETURN_UNEXPECTED;
         }
 
-        if (pSvcParam->iCountThreadsNum >= iSliceCount) {	//THREAD_FULLY_FIRE_MODE
+        // tasks of the pool are not bound to threads, so they are all fired at once as well
+        if (pSvcParam->iCountThreadsNum >= iSliceCount || NULL != pCtx->pSliceThreading->pThreadPool) {	//THREAD_FULLY_FIRE_MODE
 #if defined(PACKING_ONE_SLICE_PER_LAYER)
           int32_t iSliceIdx = 1;
           int32_t iOrgSlicePos[MAX_SLICES_NUM] = {0};
@@ -3344,10 +3492,13 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
           int64_t t_bs_append = 0;
 #endif//PACKING_ONE_SLICE_PER_LAYER
 
-          pCtx->iActiveThreadsNum	= iSliceCount;
+          pCtx->iActiveThreadsNum	= WELS_MIN (iSliceCount, pSvcParam->iCountThreadsNum);
           // to fire slice coding threads
-          err = FiredSliceThreads (&pCtx->pSliceThreading->pThreadPEncCtx[0], &pCtx->pSliceThreading->pReadySliceCodingEvent[0],
-                                   pLayerBsInfo, iSliceCount, pCtx->pCurDqLayer->pSliceEncCtx, false);
+          if (NULL != pCtx->pSliceThreading->pThreadPool)
+            err = FiredSliceTasks (pCtx, pLayerBsInfo, iSliceCount, false);
+          else
+            err = FiredSliceThreads (&pCtx->pSliceThreading->pThreadPEncCtx[0], &pCtx->pSliceThreading->pReadySliceCodingEvent[0],
+                                     pLayerBsInfo, iSliceCount, pCtx->pCurDqLayer->pSliceEncCtx, false);
           if (err) {
             WelsLog (pCtx, WELS_LOG_ERROR,
                      "[MT] WelsEncoderEncodeExt(), FiredSliceThreads return(%d) failed and exit encoding frame, iCountThreadsNum= %d, iSliceCount= %d, uiSliceMode= %d, iMultipleThreadIdc= %d!!\n",
@@ -3355,7 +3506,10 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
             return ENC_RETURN_UNEXPECTED;
           }
 
-          WelsMultipleEventsWaitAllBlocking (iSliceCount, &pCtx->pSliceThreading->pSliceCodedEvent[0]);
+          if (NULL != pCtx->pSliceThreading->pThreadPool)
+            WelsThreadPoolWaitGroup (pCtx->pSliceThreading->pThreadPool, &pCtx->pSliceThreading->sSliceTaskGroup);
+          else
+            WelsMultipleEventsWaitAllBlocking (iSliceCount, &pCtx->pSliceThreading->pSliceCodedEvent[0]);
 
 
           // all slices are finished coding here
@@ -3500,8 +3654,11 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
 #endif//PACKING_ONE_SLICE_PER_LAYER
 
         // to fire slice coding threads
-        err = FiredSliceThreads (&pCtx->pSliceThreading->pThreadPEncCtx[0], &pCtx->pSliceThreading->pReadySliceCodingEvent[0],
-                                 pLayerBsInfo, kiPartitionCnt, pCtx->pCurDqLayer->pSliceEncCtx, true);
+        if (NULL != pCtx->pSliceThreading->pThreadPool)
+          err = FiredSliceTasks (pCtx, pLayerBsInfo, kiPartitionCnt, true);
+        else
+          err = FiredSliceThreads (&pCtx->pSliceThreading->pThreadPEncCtx[0], &pCtx->pSliceThreading->pReadySliceCodingEvent[0],
+                                   pLayerBsInfo, kiPartitionCnt, pCtx->pCurDqLayer->pSliceEncCtx, true);
         if (err) {
           WelsLog (pCtx, WELS_LOG_ERROR,
                    "[MT] WelsEncoderEncodeExt(), FiredSliceThreads return(%d) failed and exit encoding frame, iCountThreadsNum= %d, iSliceCount= %d, uiSliceMode= %d, iMultipleThreadIdc= %d!!\n",
@@ -3509,7 +3666,10 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
           return ENC_RETURN_UNEXPECTED;
         }
 
-        WelsMultipleEventsWaitAllBlocking (kiPartitionCnt, &pCtx->pSliceThreading->pSliceCodedEvent[0]);
+        if (NULL != pCtx->pSliceThreading->pThreadPool)
+          WelsThreadPoolWaitGroup (pCtx->pSliceThreading->pThreadPool, &pCtx->pSliceThreading->sSliceTaskGroup);
+        else
+          WelsMultipleEventsWaitAllBlocking (kiPartitionCnt, &pCtx->pSliceThreading->pSliceCodedEvent[0]);
         WELS_VERIFY_RETURN_IFNEQ(pCtx->iEncoderError, ENC_RETURN_SUCCESS)
 
 #if defined(PACKING_ONE_SLICE_PER_LAYER)
@@ -3574,16 +3734,12 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
       }
     }
 
-    // deblocking filter
+    // deblocking filter, unless done by the slice threads or along the MB rows already
     if (
 #if defined(MT_ENABLED)
       (!pCtx->pCurDqLayer->bDeblockingParallelFlag) &&
 #endif//MT_ENABLED
-#if !defined(ENABLE_FRAME_DUMP)
-      ((eNalRefIdc != NRI_PRI_LOWEST) && (param_d->iHighestTemporalId == 0 || iCurTid < param_d->iHighestTemporalId)) &&
-#endif//!ENABLE_FRAME_DUMP
-      true
-    ) {
+      (!pCtx->pCurDqLayer->bDeblockingRowFlag) && NeedDeblockingFilter (param_d, eNalRefIdc, iCurTid)) {
       PerformDeblockingFilter (pCtx);
     }
 
@@ -3795,12 +3951,275 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, void* pDst, const SSourcePictur
   return ENC_RETURN_SUCCESS;
 }
 
+/*!
+ * \brief	coding parameters as WelsInitEncoderExt() would keep them for pParam, slice and thread settings derived
+ */
+static int32_t DeriveCodingParam (SWelsSvcCodingParam* pDerived, SWelsSvcCodingParam* pParam, int16_t* pMaxSliceCount) {
+  uint32_t uiCpuFeatureFlags	= 0;
+  int32_t iCpuCores				= 1;
+  int32_t iCacheLineSize		= 16;
+
+  memcpy (pDerived, pParam, sizeof (SWelsSvcCodingParam));	// confirmed_safe_unsafe_usage
+  uiCpuFeatureFlags	= DetectCpuFeatures (&iCpuCores, &iCacheLineSize);
+  iCpuCores			= DecideCpuCores (pDerived, uiCpuFeatureFlags, iCpuCores);
+  if (InitSliceSettings (pDerived, iCpuCores, pMaxSliceCount))
+    return 1;
+  pDerived->DetermineTemporalSettings();
+  return 0;
+}
+
+/*!
+ * \brief	whether context coding with pCtxParam has every allocation and set up coding with pParam needs
+ *			pParam should be derived by DeriveCodingParam() before
+ */
+static bool EncCtxShapeMatch (const SWelsSvcCodingParam* pCtxParam, const SWelsSvcCodingParam* pParam) {
+  int32_t iIndexD = 0;
+
+  if (pCtxParam->iSpatialLayerNum != pParam->iSpatialLayerNum ||
+      pCtxParam->iTemporalLayerNum != pParam->iTemporalLayerNum ||
+      pCtxParam->uiGopSize != pParam->uiGopSize ||
+      pCtxParam->iDecompStages != pParam->iDecompStages ||
+      pCtxParam->iPicWidth != pParam->iPicWidth ||
+      pCtxParam->iPicHeight != pParam->iPicHeight ||
+      pCtxParam->SUsedPicRect.iWidth != pParam->SUsedPicRect.iWidth ||
+      pCtxParam->SUsedPicRect.iHeight != pParam->SUsedPicRect.iHeight)
+    return false;
+
+  // reference pictures, spatial pictures and lookahead buffers
+  if (pCtxParam->iNumRefFrame != pParam->iNumRefFrame ||
+      pCtxParam->iLTRRefNum != pParam->iLTRRefNum ||
+      pCtxParam->bEnableLongTermReference != pParam->bEnableLongTermReference ||
+      pCtxParam->bEnableRc != pParam->bEnableRc ||
+      pCtxParam->iLookaheadFrames != pParam->iLookaheadFrames)
+    return false;
+
+  // analysis buffers and function pointers chosen at initialization
+  if (pCtxParam->bEnableAdaptiveQuant != pParam->bEnableAdaptiveQuant ||
+      pCtxParam->bEnableBackgroundDetection != pParam->bEnableBackgroundDetection ||
+      pCtxParam->eMotionSearchPreset != pParam->eMotionSearchPreset ||
+      pCtxParam->bMgsT0OnlyStrategy != pParam->bMgsT0OnlyStrategy)
+    return false;
+
+  // deblocking settings of dq layers
+  if (pCtxParam->iLoopFilterDisableIdc != pParam->iLoopFilterDisableIdc ||
+      pCtxParam->iLoopFilterAlphaC0Offset != pParam->iLoopFilterAlphaC0Offset ||
+      pCtxParam->iLoopFilterBetaOffset != pParam->iLoopFilterBetaOffset ||
+      pCtxParam->iInterLayerLoopFilterDisableIdc != pParam->iInterLayerLoopFilterDisableIdc ||
+      pCtxParam->iInterLayerLoopFilterAlphaC0Offset != pParam->iInterLayerLoopFilterAlphaC0Offset ||
+      pCtxParam->iInterLayerLoopFilterBetaOffset != pParam->iInterLayerLoopFilterBetaOffset ||
+      pCtxParam->bDeblockingParallelFlag != pParam->bDeblockingParallelFlag)
+    return false;
+
+  // slice threads or tasks
+  if (pCtxParam->iMultipleThreadIdc != pParam->iMultipleThreadIdc ||
+      pCtxParam->iCountThreadsNum != pParam->iCountThreadsNum ||
+      pCtxParam->bUseSharedThreadPool != pParam->bUseSharedThreadPool ||
+      pCtxParam->bEnableWavefront != pParam->bEnableWavefront)
+    return false;
+
+  do {
+    const SDLayerParam* kpCtxDlp	= &pCtxParam->sDependencyLayers[iIndexD];
+    const SDLayerParam* kpDlp		= &pParam->sDependencyLayers[iIndexD];
+
+    if (kpCtxDlp->iFrameWidth != kpDlp->iFrameWidth ||
+        kpCtxDlp->iFrameHeight != kpDlp->iFrameHeight ||
+        kpCtxDlp->iActualWidth != kpDlp->iActualWidth ||
+        kpCtxDlp->iActualHeight != kpDlp->iActualHeight ||
+        kpCtxDlp->iHighestTemporalId != kpDlp->iHighestTemporalId ||
+        kpCtxDlp->bEntropyCodingModeFlag != kpDlp->bEntropyCodingModeFlag)
+      return false;
+    if (memcmp (&kpCtxDlp->sSliceCfg, &kpDlp->sSliceCfg, sizeof (SSliceConfig)))
+      return false;
+
+    ++ iIndexD;
+  } while (iIndexD < pParam->iSpatialLayerNum);
+
+  return true;
+}
+
+/*!
+ * \brief	restore state of context as right after WelsInitEncoderExt() with its current coding parameters,
+ *			memory allocated is reused
+ * \return	0 - successful; otherwise failed and context should be released
+ */
+static int32_t WelsResetEncoderExt (sWelsEncCtx* pCtx) {
+  SWelsSvcCodingParam* pParam	= pCtx->pSvcParam;
+  SVAAFrameInfo* pVaa			= pCtx->pVaa;
+  SVAAFrameInfo sVaaBuffers;
+  const int32_t kiNumDependencyLayers	= pParam->iSpatialLayerNum;
+  const SDLayerParam* kpFinalSpatial	= &pParam->sDependencyLayers[kiNumDependencyLayers - 1];
+  const int32_t kiCountMaxMbNum			= ((15 + kpFinalSpatial->iFrameWidth) >> 4) * ((15 + kpFinalSpatial->iFrameHeight) >>
+                                        4);
+  int32_t iSpsId	= 0;
+  int32_t i			= 0;
+
+  pCtx->iCodingIndex		= 0;
+  pCtx->iFrameIndex			= 0;
+  pCtx->uiFrameIdxRc		= 0;
+  pCtx->iFrameNum			= 0;
+  pCtx->iPOC				= 0;
+  pCtx->eSliceType			= P_SLICE;
+  pCtx->eNalType			= NAL_UNIT_UNSPEC_0;
+  pCtx->eNalPriority		= NRI_PRI_LOWEST;
+  pCtx->eLastNalPriority	= NRI_PRI_LOWEST;
+  pCtx->iNumRef0			= 0;
+  pCtx->uiTemporalId		= 0;
+  pCtx->bNeedPrefixNalFlag	= false;
+  pCtx->bEncCurFrmAsIdrFlag	= true;	// make sure first frame is IDR
+  pCtx->iGlobalQp			= 26;	// global qp in default
+  pCtx->iSkipFrameFlag		= 0;
+  pCtx->iPosBsBuffer		= 0;
+  pCtx->pOut->iNalIndex		= 0;
+  pCtx->iEncoderError		= 0;
+  pCtx->iActiveThreadsNum	= pParam->iCountThreadsNum;
+  memset (pCtx->bLongTermRefFlag, 0, sizeof (pCtx->bLongTermRefFlag));
+  memset (pCtx->sSpatialIndexMap, 0, sizeof (pCtx->sSpatialIndexMap));
+  memset (pCtx->pRefList0, 0, sizeof (pCtx->pRefList0));
+#if defined(STAT_OUTPUT)
+  memset (pCtx->sStatData, 0, sizeof (pCtx->sStatData));
+  memset (&pCtx->sPerInfo, 0, sizeof (pCtx->sPerInfo));
+#endif//STAT_OUTPUT
+
+  memset (pCtx->pIntra4x4PredModeBlocks, 0, kiCountMaxMbNum * INTRA_4x4_MODE_NUM);
+  memset (pCtx->pNonZeroCountBlocks, 0, kiCountMaxMbNum * MB_LUMA_CHROMA_BLOCK4x4_NUM);
+  memset (pCtx->pMvUnitBlock4x4, 0, kiCountMaxMbNum * 2 * MB_BLOCK4x4_NUM * sizeof (SMVUnitXY));
+  memset (pCtx->pRefIndexBlock4x4, 0, kiCountMaxMbNum * 2 * MB_BLOCK8x8_NUM * sizeof (int8_t));
+  memset (pCtx->pSadCostMb, 0, kiCountMaxMbNum * sizeof (int32_t));
+
+  // parameter sets follow coding parameters not in shape, level and frame cropping for instance
+  for (i = 0; i < kiNumDependencyLayers; i++) {
+    InitLayerParaSets (pCtx, i, iSpsId, i);
+    if (i > BASE_DEPENDENCY_ID)
+      ++ iSpsId;
+  }
+
+  for (i = 0; i < kiNumDependencyLayers; i++) {
+    ResetLtrState (&pCtx->pLtr[i]);
+    pCtx->uiDependencyId	= i;
+    WelsResetRefList (pCtx);
+    if (ResetSlicePEncCtx (&pCtx->pSliceCtxList[i], &pParam->sDependencyLayers[i].sSliceCfg))
+      return 1;
+  }
+
+  // mb neighbours follow slice partitions restored above
+  memset (pCtx->ppMbListD[0], 0,
+          (pCtx->ppMbListD[kiNumDependencyLayers - 1] - pCtx->ppMbListD[0] + kiCountMaxMbNum) * sizeof (SMB));
+  for (i = 0; i < kiNumDependencyLayers; i++)
+    InitMbInfo (pCtx, pCtx->ppMbListD[i], pCtx->ppDqLayerList[i], i, kiCountMaxMbNum);
+
+  pCtx->uiDependencyId	= 0;
+  pCtx->pDecPic			= pCtx->ppRefPicListExt[0]->pRef[0];
+  pCtx->pEncPic			= NULL;
+  pCtx->pRefPic			= NULL;
+  pCtx->pCurDqLayer		= NULL;
+  pCtx->pSps			= &pCtx->pSpsArray[0];
+  pCtx->pPps			= &pCtx->pPPSArray[0];
+
+  // analysis results, buffers are kept
+  memcpy (&sVaaBuffers, pVaa, sizeof (SVAAFrameInfo));
+  memset (pVaa, 0, sizeof (SVAAFrameInfo));
+  pVaa->sVaaCalcInfo.pSad8x8			= sVaaBuffers.sVaaCalcInfo.pSad8x8;
+  pVaa->sVaaCalcInfo.pSsd16x16		= sVaaBuffers.sVaaCalcInfo.pSsd16x16;
+  pVaa->sVaaCalcInfo.pSum16x16		= sVaaBuffers.sVaaCalcInfo.pSum16x16;
+  pVaa->sVaaCalcInfo.pSumOfSquare16x16	= sVaaBuffers.sVaaCalcInfo.pSumOfSquare16x16;
+  pVaa->sVaaCalcInfo.pSumOfDiff8x8	= sVaaBuffers.sVaaCalcInfo.pSumOfDiff8x8;
+  pVaa->sVaaCalcInfo.pMad8x8			= sVaaBuffers.sVaaCalcInfo.pMad8x8;
+  pVaa->sAdaptiveQuantParam.pMotionTextureUnit			= sVaaBuffers.sAdaptiveQuantParam.pMotionTextureUnit;
+  pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp	= sVaaBuffers.sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp;
+  pVaa->pVaaBackgroundMbFlag			= sVaaBuffers.pVaaBackgroundMbFlag;
+  memset (pVaa->sVaaCalcInfo.pSad8x8, 0, kiCountMaxMbNum * 4 * sizeof (int32_t));
+  memset (pVaa->sVaaCalcInfo.pSsd16x16, 0, kiCountMaxMbNum * sizeof (int32_t));
+  memset (pVaa->sVaaCalcInfo.pSum16x16, 0, kiCountMaxMbNum * sizeof (int32_t));
+  memset (pVaa->sVaaCalcInfo.pSumOfSquare16x16, 0, kiCountMaxMbNum * sizeof (int32_t));
+  memset (pVaa->pVaaBackgroundMbFlag, 0, kiCountMaxMbNum * sizeof (int8_t));
+  if (pParam->bEnableAdaptiveQuant) {
+    memset (pVaa->sAdaptiveQuantParam.pMotionTextureUnit, 0, kiCountMaxMbNum * sizeof (SMotionTextureUnit));
+    memset (pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp, 0, kiCountMaxMbNum * sizeof (int8_t));
+  }
+  if (pParam->bEnableBackgroundDetection) {
+    memset (pVaa->sVaaCalcInfo.pSumOfDiff8x8, 0, kiCountMaxMbNum * 4 * sizeof (int32_t));
+    memset (pVaa->sVaaCalcInfo.pMad8x8, 0, kiCountMaxMbNum * 4 * sizeof (uint8_t));
+  }
+
+  if (NULL != pCtx->pLookahead) {
+    SWelsLookahead* pLookahead	= pCtx->pLookahead;
+    pLookahead->iHead			= 0;
+    pLookahead->iCount			= 0;
+    pLookahead->iLastSlot		= -1;
+    pLookahead->iFramesSinceCut	= 0;
+    pLookahead->bValid			= false;
+    pLookahead->bSceneCut		= false;
+    pLookahead->iCutDistance	= 0;
+    pLookahead->dWeight			= 1.0;
+  }
+
+  WelsRcFreeMemory (pCtx);
+  memset (pCtx->pWelsSvcRc, 0, kiNumDependencyLayers * sizeof (SWelsSvcRc));
+  WelsRcInitModule (pCtx,  pParam->bEnableRc ? WELS_RC_GOM : WELS_RC_DISABLE);
+
+#if defined(MT_ENABLED)
+  ResetMtResource (pCtx);
+#endif//MT_ENABLED
+
+  return 0;
+}
+
+/*!
+ * \brief	take context coding configuration pParam out of pool
+ * \return	context taken, NULL if none matched
+ */
+static sWelsEncCtx* EncCtxPoolTake (SEncCtxPool* pPool, const SWelsSvcCodingParam* pParam) {
+  int32_t i = 0;
+
+  for (i = 0; i < pPool->iCtxNum; i++) {
+    sWelsEncCtx* pCtx = pPool->pCtxList[i];
+    if (EncCtxShapeMatch (pCtx->pSvcParam, pParam)) {
+      -- pPool->iCtxNum;
+      memmove (&pPool->pCtxList[i], &pPool->pCtxList[i + 1], (pPool->iCtxNum - i) * sizeof (sWelsEncCtx*));
+      pPool->pCtxList[pPool->iCtxNum] = NULL;
+      return pCtx;
+    }
+  }
+  return NULL;
+}
+
+/*!
+ * \brief	park context in pool, the least recently parked one is released if pool holds kiPoolSize contexts already
+ */
+static void EncCtxPoolPark (SEncCtxPool* pPool, sWelsEncCtx** ppCtx, const int32_t kiPoolSize) {
+  while (pPool->iCtxNum > 0 && pPool->iCtxNum >= kiPoolSize) {
+    WelsUninitEncoderExt (&pPool->pCtxList[0]);
+    -- pPool->iCtxNum;
+    memmove (&pPool->pCtxList[0], &pPool->pCtxList[1], pPool->iCtxNum * sizeof (sWelsEncCtx*));
+    pPool->pCtxList[pPool->iCtxNum] = NULL;
+  }
+  pPool->pCtxList[pPool->iCtxNum ++]	= *ppCtx;
+  *ppCtx = NULL;
+}
+
+/*!
+ * \brief	release all contexts parked and pool itself
+ */
+static void EncCtxPoolRelease (SEncCtxPool** ppPool) {
+  SEncCtxPool* pPool = *ppPool;
+  int32_t i = 0;
+
+  if (NULL == pPool)
+    return;
+  for (i = 0; i < pPool->iCtxNum; i++)
+    WelsUninitEncoderExt (&pPool->pCtxList[i]);
+  free (pPool);
+  *ppPool = NULL;
+}
+
 /*!
  * \brief	Wels SVC encoder parameters adjustment
  *			SVC adjustment results in new requirement in memory blocks adjustment
  */
 int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewParam) {
   SWelsSvcCodingParam* pOldParam		= NULL;
+  SEncCtxPool* pPool					= NULL;
+  sWelsEncCtx* pCtx					= NULL;
   int32_t iReturn = ENC_RETURN_SUCCESS;
   int8_t iIndexD = 0;
   bool bNeedReset = false;
@@ -3849,6 +4268,12 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
         break;
       }
 
+      // entropy coding mode goes with pps and profile
+      if (kpOldDlp->bEntropyCodingModeFlag != kpNewDlp->bEntropyCodingModeFlag) {
+        bNeedReset	= true;
+        break;
+      }
+
       // check frame rate
       // we can not check whether corresponding fFrameRate is equal or not,
       // only need to check d_max/d_min and max_fr/d_max whether it is equal or not
@@ -3877,11 +4302,39 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
             (PARA_SET_TYPE)*sizeof (SParaSetOffsetVariable)); // confirmed_safe_unsafe_usage
     uiTmpIdrPicId = (*ppCtx)->sPSOVector.uiIdrPicId;
 
+    pPool				= (*ppCtx)->pCtxPool;
+    (*ppCtx)->pCtxPool	= NULL;
+    if (pNewParam->iCtxPoolSize > 0) {
+      // park current context and take back the one of the same configuration shape if any, reset is far lighter than init
+      SWelsSvcCodingParam sDerivedParam;
+      int16_t iSliceNum = 1;
+      if (NULL == pPool)
+        pPool = static_cast<SEncCtxPool*> (calloc (1, sizeof (SEncCtxPool)));
+      if (NULL != pPool && 0 == DeriveCodingParam (&sDerivedParam, pNewParam, &iSliceNum)) {
+        pCtx = EncCtxPoolTake (pPool, &sDerivedParam);
+        if (NULL != pCtx) {
+          memcpy (pCtx->pSvcParam, &sDerivedParam, sizeof (SWelsSvcCodingParam));	// confirmed_safe_unsafe_usage
+          pCtx->iMaxSliceCount	= iSliceNum;
+          if (WelsResetEncoderExt (pCtx)) {
+            WelsUninitEncoderExt (&pCtx);
+            pCtx = NULL;
+          }
+        }
+      }
+      if (NULL != pPool)
+        EncCtxPoolPark (pPool, ppCtx, pNewParam->iCtxPoolSize);
+    } else
+      EncCtxPoolRelease (&pPool);
     WelsUninitEncoderExt (ppCtx);
 
     /* Update new parameters */
-    if (WelsInitEncoderExt (ppCtx, pNewParam))
+    if (NULL != pCtx) {
+      *ppCtx	= pCtx;
+    } else if (WelsInitEncoderExt (ppCtx, pNewParam)) {
+      EncCtxPoolRelease (&pPool);
       return 1;
+    }
+    (*ppCtx)->pCtxPool	= pPool;
 
     // reset the scaled spatial picture size
     (*ppCtx)->pVpp->WelsPreprocessReset (*ppCtx);
@@ -3913,6 +4366,7 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
 
     /* denoise control */
     pOldParam->bEnableDenoise	= pNewParam->bEnableDenoise;
+    pOldParam->bEnableTemporalDenoise	= pNewParam->bEnableTemporalDenoise;
 
     /* background detection control */
     pOldParam->bEnableBackgroundDetection		= pNewParam->bEnableBackgroundDetection;
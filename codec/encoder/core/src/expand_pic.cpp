@@ -116,6 +116,42 @@ static inline void ExpandPictureChroma_c (uint8_t* pDst, const int32_t kiStride,
   } while (i < kiPicH);
 }
 
+// expand the left and right borders of rows [kiRowStart, kiRowEnd), along with the top border if the first row is
+// included and the bottom border if the last row is included; pieces of one picture give the same as expanding at once
+static void ExpandPictureRows_c (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW, const int32_t kiPicH,
+                                 const int32_t kiPaddingLen, const int32_t kiRowStart, const int32_t kiRowEnd) {
+  uint8_t* pTmp				= pDst + kiRowStart * kiStride;
+  int32_t i					= 0;
+
+  if (0 == kiRowStart) {
+    const uint8_t kuiTL		= pDst[0];
+    const uint8_t kuiTR		= pDst[kiPicW - 1];
+    for (i = 1; i <= kiPaddingLen; ++ i) {
+      uint8_t* pTop		= pDst - i * kiStride;
+      memcpy (pTop, pDst, kiPicW);	// confirmed_safe_unsafe_usage
+      memset (pTop - kiPaddingLen, kuiTL, kiPaddingLen);
+      memset (pTop + kiPicW, kuiTR, kiPaddingLen);
+    }
+  }
+  if (kiPicH == kiRowEnd) {
+    uint8_t* pDstLastLine	= pDst + (kiPicH - 1) * kiStride;
+    const uint8_t kuiBL		= pDstLastLine[0];
+    const uint8_t kuiBR		= pDstLastLine[kiPicW - 1];
+    for (i = 1; i <= kiPaddingLen; ++ i) {
+      uint8_t* pBottom	= pDstLastLine + i * kiStride;
+      memcpy (pBottom, pDstLastLine, kiPicW);	// confirmed_safe_unsafe_usage
+      memset (pBottom - kiPaddingLen, kuiBL, kiPaddingLen);
+      memset (pBottom + kiPicW, kuiBR, kiPaddingLen);
+    }
+  }
+
+  for (i = kiRowStart; i < kiRowEnd; ++ i) {
+    memset (pTmp - kiPaddingLen, pTmp[0], kiPaddingLen);
+    memset (pTmp + kiPicW, pTmp[kiPicW - 1], kiPaddingLen);
+    pTmp += kiStride;
+  }
+}
+
 void InitExpandPictureFunc (void* pL, const uint32_t kuiCPUFlag) {
   SWelsFuncPtrList* pFuncList = (SWelsFuncPtrList*)pL;
   pFuncList->pfExpandLumaPicture		= ExpandPictureLuma_c;
@@ -158,4 +194,22 @@ void ExpandReferencingPicture (SPicture* pPic, PExpandPictureFunc pExpLuma, PExp
 
 }
 
+void ExpandReferencingPictureRows (SPicture* pPic, const int32_t kiRowStart, const int32_t kiRowEnd) {
+  const int32_t kiWidthY	= pPic->iWidthInPixel;
+  const int32_t kiHeightY	= pPic->iHeightInPixel;
+  const int32_t kiWidthUV	= kiWidthY >> 1;
+  const int32_t kiHeightUV	= kiHeightY >> 1;
+  const int32_t kiRowEndY	= WELS_MIN (kiRowEnd, kiHeightY);
+  const int32_t kiRowEndUV	= WELS_MIN (kiRowEnd >> 1, kiHeightUV);
+
+  if (kiRowStart < kiRowEndY)
+    ExpandPictureRows_c (pPic->pData[0], pPic->iLineSize[0], kiWidthY, kiHeightY, PADDING_LENGTH, kiRowStart, kiRowEndY);
+  if ((kiRowStart >> 1) < kiRowEndUV) {
+    ExpandPictureRows_c (pPic->pData[1], pPic->iLineSize[1], kiWidthUV, kiHeightUV, PADDING_LENGTH >> 1, kiRowStart >> 1,
+                         kiRowEndUV);
+    ExpandPictureRows_c (pPic->pData[2], pPic->iLineSize[2], kiWidthUV, kiHeightUV, PADDING_LENGTH >> 1, kiRowStart >> 1,
+                         kiRowEndUV);
+  }
+}
+
 }
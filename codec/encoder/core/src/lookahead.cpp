@@ -0,0 +1,241 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	lookahead.cpp
+ *
+ * \brief	frame lookahead analysis used by rate control
+ *
+ * \date	10/17/2014 Created
+ *
+ *************************************************************************************
+ */
+#include <string.h>
+#include <math.h>
+#include "lookahead.h"
+#include "encoder_context.h"
+#include "sample.h"
+#include "utils.h"
+
+namespace WelsSVCEnc {
+
+/*!
+ * \brief	SAD of 16x16 luma block against DC of each 8x8 block, cheap estimation of intra cost
+ */
+static inline int32_t LookaheadIntraCost (const uint8_t* kpY, const int32_t kiStride) {
+  int32_t iCost = 0;
+  for (int32_t iBlk = 0; iBlk < 4; ++ iBlk) {
+    const uint8_t* kpBlk = kpY + ((iBlk >> 1) << 3) * kiStride + ((iBlk & 1) << 3);
+    const uint8_t* kpPix = kpBlk;
+    int32_t iSum = 0, iDc = 0, i, j;
+
+    for (j = 0; j < 8; ++ j, kpPix += kiStride) {
+      for (i = 0; i < 8; ++ i)
+        iSum += kpPix[i];
+    }
+    iDc = (iSum + 32) >> 6;
+    kpPix = kpBlk;
+    for (j = 0; j < 8; ++ j, kpPix += kiStride) {
+      for (i = 0; i < 8; ++ i)
+        iCost += WELS_ABS (kpPix[i] - iDc);
+    }
+  }
+  return iCost;
+}
+
+static void LookaheadAnalyzeFrame (sWelsEncCtx* pCtx, SLookaheadFrame* pCur, const SLookaheadFrame* kpPrev) {
+  PSampleSadSatdCostFunc pfSad	= pCtx->pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_16x16];
+  const int32_t kiStride		= pCur->sSrcPic.iStride[0];
+  const int32_t kiMbWidth		= pCur->sSrcPic.iPicWidth >> 4;
+  const int32_t kiMbHeight		= pCur->sSrcPic.iPicHeight >> 4;
+  const bool kbInter			= (NULL != kpPrev) && (kpPrev->sSrcPic.iPicWidth == pCur->sSrcPic.iPicWidth)
+                                  && (kpPrev->sSrcPic.iPicHeight == pCur->sSrcPic.iPicHeight);
+  int32_t iMbX, iMbY;
+
+  pCur->iIntraCost	= 0;
+  pCur->iInterCost	= 0;
+  pCur->iCost		= 0;
+  for (iMbY = 0; iMbY < kiMbHeight; ++ iMbY) {
+    uint8_t* pCurY	= pCur->sSrcPic.pData[0] + (iMbY << 4) * kiStride;
+    uint8_t* pPrevY	= kbInter ? (kpPrev->sSrcPic.pData[0] + (iMbY << 4) * kiStride) : NULL;
+    for (iMbX = 0; iMbX < kiMbWidth; ++ iMbX) {
+      const int32_t kiIntra	= LookaheadIntraCost (pCurY, kiStride);
+      const int32_t kiInter	= kbInter ? pfSad (pCurY, kiStride, pPrevY, kiStride) : kiIntra;
+      pCur->iIntraCost	+= kiIntra;
+      pCur->iInterCost	+= kiInter;
+      pCur->iCost		+= WELS_MIN (kiIntra, kiInter);
+      pCurY += 16;
+      if (kbInter)
+        pPrevY += 16;
+    }
+  }
+}
+
+int32_t WelsLookaheadInit (sWelsEncCtx* pCtx) {
+  SWelsSvcCodingParam* pParam	= pCtx->pSvcParam;
+  CMemoryAlign* pMa				= pCtx->pMemAlign;
+  SWelsLookahead* pLookahead	= NULL;
+  const int32_t kiDepth			= pParam->iLookaheadFrames;
+  const int32_t kiWidth			= WELS_ALIGN (pParam->iPicWidth, MB_WIDTH_LUMA);
+  const int32_t kiHeight		= WELS_ALIGN (pParam->iPicHeight, MB_HEIGHT_LUMA);
+  const int32_t kiFrameSize		= kiWidth * kiHeight * 3 / 2;
+  uint8_t* pBuffer				= NULL;
+  int32_t i;
+
+  pCtx->pLookahead = NULL;
+  if (kiDepth <= 0 || !pParam->bEnableRc)
+    return 0;
+
+  pLookahead = (SWelsLookahead*)pMa->WelsMallocz (sizeof (SWelsLookahead), "pLookahead");
+  if (NULL == pLookahead)
+    return 1;
+  pBuffer = (uint8_t*)pMa->WelsMallocz ((kiDepth + 1) * kiFrameSize, "pLookahead->pBuffer");
+  if (NULL == pBuffer) {
+    pMa->WelsFree (pLookahead, "pLookahead");
+    return 1;
+  }
+
+  for (i = 0; i <= kiDepth; ++ i) {
+    SSourcePicture* pPic = &pLookahead->sFrames[i].sSrcPic;
+    pLookahead->sFrames[i].pBuffer	= pBuffer + i * kiFrameSize;
+    pPic->iColorFormat	= videoFormatI420;
+    pPic->iStride[0]	= kiWidth;
+    pPic->iStride[1]	=
+      pPic->iStride[2]	= kiWidth >> 1;
+    pPic->pData[0]		= pLookahead->sFrames[i].pBuffer;
+    pPic->pData[1]		= pPic->pData[0] + kiWidth * kiHeight;
+    pPic->pData[2]		= pPic->pData[1] + (kiWidth >> 1) * (kiHeight >> 1);
+  }
+  pLookahead->iDepth			= kiDepth;
+  pLookahead->iLastSlot			= -1;
+  pLookahead->iFramesSinceCut	= 0;
+  pLookahead->dWeight			= 1.0;
+
+  pCtx->pLookahead = pLookahead;
+  return 0;
+}
+
+void WelsLookaheadUninit (sWelsEncCtx* pCtx) {
+  SWelsLookahead* pLookahead = pCtx->pLookahead;
+  if (NULL == pLookahead)
+    return;
+
+  pCtx->pMemAlign->WelsFree (pLookahead->sFrames[0].pBuffer, "pLookahead->pBuffer");
+  pCtx->pMemAlign->WelsFree (pLookahead, "pLookahead");
+  pCtx->pLookahead = NULL;
+}
+
+int32_t WelsLookaheadPush (sWelsEncCtx* pCtx, const SSourcePicture* kpSrcPic) {
+  SWelsLookahead* pLookahead	= pCtx->pLookahead;
+  const int32_t kiSlotNum		= pLookahead->iDepth + 1;
+  SLookaheadFrame* pFrame		= NULL;
+  SSourcePicture* pPic			= NULL;
+  int32_t iSlot, i, j;
+
+  if (kpSrcPic->iColorFormat != videoFormatI420 || pLookahead->iCount >= kiSlotNum)
+    return 1;
+
+  iSlot	= (pLookahead->iHead + pLookahead->iCount) % kiSlotNum;
+  pFrame	= &pLookahead->sFrames[iSlot];
+  pPic	= &pFrame->sSrcPic;
+  if (kpSrcPic->iPicWidth <= 0 || kpSrcPic->iPicHeight <= 0 ||
+      kpSrcPic->iPicWidth > pPic->iStride[0] || (kpSrcPic->iPicHeight * pPic->iStride[0]) > (pPic->pData[1] - pPic->pData[0]))
+    return 1;
+
+  pPic->iPicWidth	= kpSrcPic->iPicWidth;
+  pPic->iPicHeight	= kpSrcPic->iPicHeight;
+  for (i = 0; i < 3; ++ i) {
+    const int32_t kiShift	= (i > 0);
+    const int32_t kiWidth	= pPic->iPicWidth >> kiShift;
+    const int32_t kiHeight	= pPic->iPicHeight >> kiShift;
+    for (j = 0; j < kiHeight; ++ j)
+      memcpy (pPic->pData[i] + j * pPic->iStride[i], kpSrcPic->pData[i] + j * kpSrcPic->iStride[i], kiWidth);
+  }
+
+  LookaheadAnalyzeFrame (pCtx, pFrame, (pLookahead->iLastSlot < 0) ? NULL : &pLookahead->sFrames[pLookahead->iLastSlot]);
+
+  // same spacing as DecideFrameType() keeps between scene change IDRs
+  ++ pLookahead->iFramesSinceCut;
+  pFrame->bSceneCut = (pLookahead->iLastSlot >= 0) && (pLookahead->iFramesSinceCut >= (VGOP_SIZE << 1))
+                      && (pFrame->iCost > LOOKAHEAD_SCENE_CUT_RATIO * pFrame->iIntraCost);
+  if (pFrame->bSceneCut)
+    pLookahead->iFramesSinceCut = 0;
+
+  pLookahead->iLastSlot = iSlot;
+  ++ pLookahead->iCount;
+  return 0;
+}
+
+const SSourcePicture* WelsLookaheadPop (sWelsEncCtx* pCtx, const bool kbFlush) {
+  SWelsLookahead* pLookahead	= pCtx->pLookahead;
+  const int32_t kiSlotNum		= pLookahead->iDepth + 1;
+  SLookaheadFrame* pCur			= NULL;
+  int64_t iWindowCost			= 0;
+  int32_t iWindowNum			= 0;
+  int32_t i;
+
+  pLookahead->bValid = false;
+  if (pLookahead->iCount == 0 || (!kbFlush && pLookahead->iCount <= pLookahead->iDepth))
+    return NULL;
+
+  pCur = &pLookahead->sFrames[pLookahead->iHead];
+
+  // average cost over frames up to the next scene cut, those after it are budgeted by the new IDR
+  pLookahead->iCutDistance = 0;
+  for (i = 0; i < pLookahead->iCount; ++ i) {
+    const SLookaheadFrame* kpFrame = &pLookahead->sFrames[ (pLookahead->iHead + i) % kiSlotNum];
+    if (i > 0 && kpFrame->bSceneCut) {
+      pLookahead->iCutDistance = i;
+      break;
+    }
+    iWindowCost += kpFrame->iCost;
+    ++ iWindowNum;
+  }
+
+  pLookahead->dWeight = 1.0;
+  if (iWindowCost > 0) {
+    pLookahead->dWeight = pow ((double)pCur->iCost * iWindowNum / iWindowCost, 0.5);
+    pLookahead->dWeight = WELS_CLIP3 (pLookahead->dWeight, 1.0 - LOOKAHEAD_WEIGHT_RANGE, 1.0 + LOOKAHEAD_WEIGHT_RANGE);
+  }
+  if (pLookahead->iCutDistance > 0)
+    pLookahead->dWeight *= LOOKAHEAD_PRE_CUT_RATIO;
+
+  pLookahead->bSceneCut = pCur->bSceneCut;
+  if (pCur->bSceneCut && pCtx->pSvcParam->bEnableSceneChangeDetect)
+    pCtx->bEncCurFrmAsIdrFlag = true;
+
+  pLookahead->iHead = (pLookahead->iHead + 1) % kiSlotNum;
+  -- pLookahead->iCount;
+  pLookahead->bValid = true;
+
+  return &pCur->sSrcPic;
+}
+
+}
@@ -0,0 +1,431 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ * \file	mb_row_multi_threading.cpp
+ *
+ * \brief	wavefront coding of MB rows of a slice by multiple threads
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#if defined(MT_ENABLED)
+
+#include <assert.h>
+#include <string.h>
+#include "mb_row_multi_threading.h"
+#include "svc_encode_slice.h"
+#include "svc_base_layer_md.h"
+#include "svc_mode_decision.h"
+#include "svc_set_mb_syn_cavlc.h"
+#include "svc_enc_golomb.h"
+#include "rc.h"
+#include "utils.h"
+
+namespace WelsSVCEnc {
+
+int32_t AllocMbCacheAligned (SMbCache* pMbCache, CMemoryAlign* pMa);
+void FreeMbCache (SMbCache* pMbCache, CMemoryAlign* pMa);
+
+static void MbRowWorkerProc (void* pArg);
+
+int32_t RequestMbRowThreading (sWelsEncCtx* pCtx, SWelsSvcCodingParam* pParam) {
+  CMemoryAlign* pMa				= pCtx->pMemAlign;
+  SSliceThreading* pSmt			= pCtx->pSliceThreading;
+  SMbRowThreading* pMrt			= NULL;
+  int32_t iWorkerNum			= pParam->iCountThreadsNum;
+  int32_t iMaxMbNum				= 0;
+  int32_t iMaxMbHeight			= 0;
+  int32_t iIdx					= 0;
+
+  pCtx->pMbRowThreading	= NULL;
+  if (!pParam->bEnableWavefront || iWorkerNum < 2)
+    return 0;
+
+  // only layers coded as single slice are split into MB rows
+  for (iIdx = 0; iIdx < pParam->iSpatialLayerNum; iIdx++) {
+    const SDLayerParam* kpDlp	= &pParam->sDependencyLayers[iIdx];
+    if (SM_SINGLE_SLICE == kpDlp->sSliceCfg.uiSliceMode) {
+      const int32_t kiMbWidth	= (kpDlp->iFrameWidth + 15) >> 4;
+      const int32_t kiMbHeight	= (kpDlp->iFrameHeight + 15) >> 4;
+      iMaxMbNum		= WELS_MAX (iMaxMbNum, kiMbWidth * kiMbHeight);
+      iMaxMbHeight	= WELS_MAX (iMaxMbHeight, kiMbHeight);
+    }
+  }
+  if (iMaxMbHeight < 2)
+    return 0;
+  iWorkerNum	= WELS_MIN (iWorkerNum, iMaxMbHeight);
+
+  pMrt	= (SMbRowThreading*)pMa->WelsMalloc (sizeof (SMbRowThreading), "SMbRowThreading");
+  WELS_VERIFY_RETURN_IF (1, (NULL == pMrt))
+  pCtx->pMbRowThreading	= pMrt;
+
+  if (WELS_THREAD_ERROR_OK != WelsMutexInit (&pMrt->mutexRows))
+    return 1;
+  if (WELS_THREAD_ERROR_OK != WelsThreadTaskGroupInit (&pMrt->sTaskGroup))
+    return 1;
+
+  if (NULL != pSmt && NULL != pSmt->pThreadPool) {
+    pMrt->pThreadPool	= pSmt->pThreadPool;
+  } else {
+    if (WELS_THREAD_ERROR_OK != WelsThreadPoolCreate (&pMrt->pThreadPool, iWorkerNum - 1))
+      return 1;
+    pMrt->bOwnPool	= true;
+  }
+
+  pMrt->pWorkers	= (SMbRowWorker*)pMa->WelsMalloc (iWorkerNum * sizeof (SMbRowWorker), "pMrt->pWorkers");
+  WELS_VERIFY_RETURN_IF (1, (NULL == pMrt->pWorkers))
+  pMrt->iWorkerNum	= iWorkerNum;
+  for (iIdx = 0; iIdx < iWorkerNum; iIdx++) {
+    SMbRowWorker* pWorker	= &pMrt->pWorkers[iIdx];
+    pWorker->pMrt			= pMrt;
+    pWorker->pEncCtx		= pCtx;
+    pWorker->sTask.pProc	= MbRowWorkerProc;
+    pWorker->sTask.pArg		= pWorker;
+    pWorker->sTask.pGroup	= &pMrt->sTaskGroup;
+    if (WELS_THREAD_ERROR_OK != WelsEventCreate (&pWorker->pWaitEvent))
+      return 1;
+  }
+  for (iIdx = 0; iIdx < iWorkerNum; iIdx++) {
+    if (AllocMbCacheAligned (&pMrt->pWorkers[iIdx].sSlice.sMbCacheInfo, pMa))
+      return 1;
+  }
+
+  pMrt->pMbSyntax	= (SMbRowSyntax*)pMa->WelsMalloc (iMaxMbNum * sizeof (SMbRowSyntax), "pMrt->pMbSyntax");
+  WELS_VERIFY_RETURN_IF (1, (NULL == pMrt->pMbSyntax))
+  pMrt->pRowState	= (SMbRowState*)pMa->WelsMalloc (iMaxMbHeight * sizeof (SMbRowState), "pMrt->pRowState");
+  WELS_VERIFY_RETURN_IF (1, (NULL == pMrt->pRowState))
+
+  WelsLog (pCtx, WELS_LOG_INFO, "RequestMbRowThreading(), iWorkerNum= %d, iMaxMbHeight= %d, shared pool= %d\n",
+           iWorkerNum, iMaxMbHeight, !pMrt->bOwnPool);
+  return 0;
+}
+
+void ReleaseMbRowThreading (sWelsEncCtx* pCtx) {
+  CMemoryAlign* pMa			= NULL;
+  SMbRowThreading* pMrt		= NULL;
+  int32_t iIdx				= 0;
+
+  if (NULL == pCtx || NULL == pCtx->pMbRowThreading)
+    return;
+
+  pMa		= pCtx->pMemAlign;
+  pMrt	= pCtx->pMbRowThreading;
+
+  if (pMrt->bOwnPool && NULL != pMrt->pThreadPool)
+    WelsThreadPoolDestroy (pMrt->pThreadPool);
+  pMrt->pThreadPool	= NULL;
+  WelsThreadTaskGroupDestroy (&pMrt->sTaskGroup);
+  WelsMutexDestroy (&pMrt->mutexRows);
+
+  if (NULL != pMrt->pWorkers) {
+    for (iIdx = 0; iIdx < pMrt->iWorkerNum; iIdx++) {
+      FreeMbCache (&pMrt->pWorkers[iIdx].sSlice.sMbCacheInfo, pMa);
+      if (NULL != pMrt->pWorkers[iIdx].pWaitEvent)
+        WelsEventFree (pMrt->pWorkers[iIdx].pWaitEvent);
+    }
+    pMa->WelsFree (pMrt->pWorkers, "pMrt->pWorkers");
+    pMrt->pWorkers	= NULL;
+  }
+  if (NULL != pMrt->pMbSyntax) {
+    pMa->WelsFree (pMrt->pMbSyntax, "pMrt->pMbSyntax");
+    pMrt->pMbSyntax	= NULL;
+  }
+  if (NULL != pMrt->pRowState) {
+    pMa->WelsFree (pMrt->pRowState, "pMrt->pRowState");
+    pMrt->pRowState	= NULL;
+  }
+
+  pMa->WelsFree (pMrt, "SMbRowThreading");
+  pCtx->pMbRowThreading	= NULL;
+}
+
+/*
+ *	wait until MBs of the row above up to the above right neighbor are reconstructed
+ */
+static void MbRowWaitAbove (SMbRowWorker* pWorker, const int32_t kiRow, const int32_t kiNeededMbNum) {
+  SMbRowThreading* pMrt	= pWorker->pMrt;
+  SMbRowState* pAbove		= &pMrt->pRowState[kiRow - 1];
+
+  if (pWorker->iAboveCodedMbNum >= kiNeededMbNum)
+    return;
+
+  WelsMutexLock (&pMrt->mutexRows);
+  while (pAbove->iCodedMbNum < kiNeededMbNum) {
+    pAbove->iWaitMbNum	= kiNeededMbNum;
+    pAbove->pWaitEvent	= pWorker->pWaitEvent;	// set again after an interrupted wait as well
+    WelsMutexUnlock (&pMrt->mutexRows);
+    WelsEventWait (pWorker->pWaitEvent);
+    WelsMutexLock (&pMrt->mutexRows);
+  }
+  pWorker->iAboveCodedMbNum	= pAbove->iCodedMbNum;
+  WelsMutexUnlock (&pMrt->mutexRows);
+}
+
+static void MbRowPublishProgress (SMbRowThreading* pMrt, const int32_t kiRow) {
+  SMbRowState* pRow	= &pMrt->pRowState[kiRow];
+
+  WelsMutexLock (&pMrt->mutexRows);
+  ++ pRow->iCodedMbNum;
+  if (NULL != pRow->pWaitEvent && pRow->iCodedMbNum >= pRow->iWaitMbNum) {
+    WelsEventSignal (pRow->pWaitEvent);
+    pRow->pWaitEvent	= NULL;
+  }
+  WelsMutexUnlock (&pMrt->mutexRows);
+}
+
+/*
+ *	mode decision, transform and reconstruction of one MB row, the syntax is kept for the entropy coding stage
+ */
+static void MdMbRow (SMbRowWorker* pWorker, const int32_t kiRow) {
+  sWelsEncCtx* pEncCtx			= pWorker->pEncCtx;
+  SMbRowThreading* pMrt			= pWorker->pMrt;
+  SDqLayer* pCurLayer			= pEncCtx->pCurDqLayer;
+  SSlice* pSlice				= &pWorker->sSlice;
+  SMbCache* pMbCache			= &pSlice->sMbCacheInfo;
+  SWelsMD* pMd					= &pWorker->sMd;
+  const int32_t kiMbWidth		= pMrt->iMbWidth;
+  const int32_t kiSliceFirstMbXY	= pSlice->sSliceHeaderExt.sSliceHeader.iFirstMbInSlice;
+  const int32_t kiSliceIdx		= pSlice->uiSliceIdx;
+  const bool kbIntraSlice		= (I_SLICE == pEncCtx->eSliceType);
+  const int32_t kiMvdInterTableSize	= (pEncCtx->pSvcParam->iSpatialLayerNum == 1 ? 648 : 972);
+  const int32_t kiMvdInterTableStride = 1 + (kiMvdInterTableSize << 1);
+  uint16_t* pMvdCostTableInter	= &(pCurLayer->sLayerInfo.pPpsP->bEntropyCodingModeFlag ?
+                                    pEncCtx->pMvdCostTableInterCabac : pEncCtx->pMvdCostTableInter)[kiMvdInterTableSize];
+  const uint8_t kuiChromaQpIndexOffset = pCurLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset;
+  SDCTCoeff* pDct				= pMbCache->pDct;
+  bool* pPrevIntra4x4PredModeFlag	= pMbCache->pPrevIntra4x4PredModeFlag;
+  int8_t* pRemIntra4x4PredModeFlag	= pMbCache->pRemIntra4x4PredModeFlag;
+  int32_t iMbX					= 0;
+
+  pWorker->iAboveCodedMbNum	= 0;
+  for (iMbX = 0; iMbX < kiMbWidth; iMbX++) {
+    const int32_t kiMbXY	= kiRow * kiMbWidth + iMbX;
+    SMB* pCurMb				= &pCurLayer->sMbDataP[kiMbXY];
+    SMbRowSyntax* pSyntax	= &pMrt->pMbSyntax[kiMbXY];
+
+    if (kiRow > 0)
+      MbRowWaitAbove (pWorker, kiRow, WELS_MIN (iMbX + 2, kiMbWidth));
+
+    // residual and intra modes go straight to the MB syntax record
+    pMbCache->pDct						= &pSyntax->sDct;
+    pMbCache->pPrevIntra4x4PredModeFlag	= pSyntax->bPrevIntra4x4PredModeFlag;
+    pMbCache->pRemIntra4x4PredModeFlag	= pSyntax->iRemIntra4x4PredModeFlag;
+
+    if (kbIntraSlice) {
+      pCurMb->uiLumaQp   = pEncCtx->iGlobalQp;
+      pCurMb->uiChromaQp = g_kuiChromaQpTable[CLIP3_QP_0_51 (pCurMb->uiLumaQp + kuiChromaQpIndexOffset)];
+      pEncCtx->pFuncList->pfRc.pfWelsRcMbInitWavefront (pEncCtx, pCurMb, pSlice);
+
+      pMd->iLambda = g_kiQpCostTable[pCurMb->uiLumaQp];
+      WelsMdIntraInit (pEncCtx, pCurMb, pMbCache, kiSliceFirstMbXY);
+      WelsMdIntraMb (pEncCtx, pMd, pCurMb, pMbCache);
+      UpdateNonZeroCountCache (pCurMb, pMbCache);
+      pCurMb->uiSliceIdc = kiSliceIdx;
+    } else {
+      pEncCtx->pFuncList->pfRc.pfWelsRcMbInitWavefront (pEncCtx, pCurMb, pSlice);
+      // QP of the MB written last is not known yet, skip MBs take their own QP until written
+      pSlice->uiLastMbQp	= pCurMb->uiLumaQp;
+
+      pMd->iLambda = g_kiQpCostTable[pCurMb->uiLumaQp];
+      pMd->pMvdCost = &pMvdCostTableInter[pCurMb->uiLumaQp * kiMvdInterTableStride];
+      WelsMdIntraInit (pEncCtx, pCurMb, pMbCache, kiSliceFirstMbXY);
+      WelsMdInterInit (pEncCtx, pSlice, pCurMb, kiSliceFirstMbXY);
+      pEncCtx->pFuncList->pfInterMd (pEncCtx, pMd, pSlice, pCurMb, pMbCache);
+
+      WelsMdInterSaveSadAndRefMbType ((pCurLayer->pDecPic->uiRefMbType), pMbCache, pCurMb, pMd);
+      pEncCtx->pFuncList->pfInterMdBackgroundInfoUpdate (pCurLayer, pCurMb, pMbCache->bCollocatedPredFlag,
+          pEncCtx->pRefPic->iPictureType);
+      UpdateNonZeroCountCache (pCurMb, pMbCache);
+
+      pCurMb->uiSliceIdc = kiSliceIdx;
+      OutputPMbWithoutConstructCsRsNoCopy (pEncCtx, pCurLayer, pSlice, pCurMb);
+    }
+
+    memcpy (pSyntax->iNonZeroCoeffCount, pMbCache->iNonZeroCoeffCount, sizeof (pSyntax->iNonZeroCoeffCount));
+    memcpy (pSyntax->sMbMvp, pMbCache->sMbMvp, sizeof (pSyntax->sMbMvp));
+    pSyntax->uiLumaI16x16Mode	= pMbCache->uiLumaI16x16Mode;
+    pSyntax->uiChmaI8x8Mode		= pMbCache->uiChmaI8x8Mode;
+    pSyntax->iCostLuma			= pMd->iCostLuma;
+
+    MbRowPublishProgress (pMrt, kiRow);
+  }
+
+  pMbCache->pDct						= pDct;
+  pMbCache->pPrevIntra4x4PredModeFlag	= pPrevIntra4x4PredModeFlag;
+  pMbCache->pRemIntra4x4PredModeFlag	= pRemIntra4x4PredModeFlag;
+}
+
+/*
+ *	entropy coding of one MB row in the real slice, in MB order behind mode decision
+ */
+static int32_t WriteMbRow (SMbRowThreading* pMrt, sWelsEncCtx* pEncCtx, const int32_t kiRow) {
+  SSlice* pSlice				= pMrt->pCurSlice;
+  SMbCache* pMbCache			= &pSlice->sMbCacheInfo;
+  SMB* pMbList					= pEncCtx->pCurDqLayer->sMbDataP;
+  const int32_t kiMbWidth		= pMrt->iMbWidth;
+  SDCTCoeff* pDct				= pMbCache->pDct;
+  bool* pPrevIntra4x4PredModeFlag	= pMbCache->pPrevIntra4x4PredModeFlag;
+  int8_t* pRemIntra4x4PredModeFlag	= pMbCache->pRemIntra4x4PredModeFlag;
+  int32_t iMbX					= 0;
+  int32_t iEncReturn			= ENC_RETURN_SUCCESS;
+
+  for (iMbX = 0; iMbX < kiMbWidth; iMbX++) {
+    const int32_t kiMbXY	= kiRow * kiMbWidth + iMbX;
+    SMB* pCurMb				= &pMbList[kiMbXY];
+    SMbRowSyntax* pSyntax	= &pMrt->pMbSyntax[kiMbXY];
+
+    pMbCache->pDct						= &pSyntax->sDct;
+    pMbCache->pPrevIntra4x4PredModeFlag	= pSyntax->bPrevIntra4x4PredModeFlag;
+    pMbCache->pRemIntra4x4PredModeFlag	= pSyntax->iRemIntra4x4PredModeFlag;
+    memcpy (pMbCache->iNonZeroCoeffCount, pSyntax->iNonZeroCoeffCount, sizeof (pSyntax->iNonZeroCoeffCount));
+    memcpy (pMbCache->sMbMvp, pSyntax->sMbMvp, sizeof (pSyntax->sMbMvp));
+    pMbCache->uiLumaI16x16Mode	= pSyntax->uiLumaI16x16Mode;
+    pMbCache->uiChmaI8x8Mode	= pSyntax->uiChmaI8x8Mode;
+
+    pEncCtx->pFuncList->pfRc.pfWelsRcMbBitsInitWavefront (pEncCtx, pCurMb, pSlice);
+
+    iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
+    if (ENC_RETURN_SUCCESS != iEncReturn)
+      break;
+
+#if defined(MB_TYPES_CHECK)
+    WelsCountMbType (pEncCtx->sPerInfo.iMbCount, pEncCtx->eSliceType, pCurMb);
+#endif//MB_TYPES_CHECK
+
+    pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, pSyntax->iCostLuma, pSlice);
+  }
+
+  pMbCache->pDct						= pDct;
+  pMbCache->pPrevIntra4x4PredModeFlag	= pPrevIntra4x4PredModeFlag;
+  pMbCache->pRemIntra4x4PredModeFlag	= pRemIntra4x4PredModeFlag;
+  return iEncReturn;
+}
+
+/*
+ *	write all complete rows in order unless another worker is writing already
+ */
+static void WriteCodedMbRows (SMbRowThreading* pMrt, sWelsEncCtx* pEncCtx) {
+  int32_t iRow	= 0;
+
+  WelsMutexLock (&pMrt->mutexRows);
+  if (pMrt->bWriting) {
+    WelsMutexUnlock (&pMrt->mutexRows);
+    return;
+  }
+  pMrt->bWriting	= true;
+  for (;;) {
+    iRow	= pMrt->iNextWriteRow;
+    if (iRow >= pMrt->iMbHeight || pMrt->pRowState[iRow].iCodedMbNum < pMrt->iMbWidth)
+      break;
+    WelsMutexUnlock (&pMrt->mutexRows);
+
+    if (ENC_RETURN_SUCCESS == pMrt->iEncReturn)
+      pMrt->iEncReturn	= WriteMbRow (pMrt, pEncCtx, iRow);
+
+    WelsMutexLock (&pMrt->mutexRows);
+    ++ pMrt->iNextWriteRow;
+  }
+  pMrt->bWriting	= false;
+  WelsMutexUnlock (&pMrt->mutexRows);
+}
+
+static void MbRowWorkerProc (void* pArg) {
+  SMbRowWorker* pWorker	= (SMbRowWorker*)pArg;
+  SMbRowThreading* pMrt	= pWorker->pMrt;
+  int32_t iRow			= 0;
+
+  for (;;) {
+    WelsMutexLock (&pMrt->mutexRows);
+    iRow	= pMrt->iNextRow;
+    if (iRow < pMrt->iMbHeight)
+      ++ pMrt->iNextRow;
+    WelsMutexUnlock (&pMrt->mutexRows);
+    if (iRow >= pMrt->iMbHeight)
+      break;
+
+    MdMbRow (pWorker, iRow);
+    WriteCodedMbRows (pMrt, pWorker->pEncCtx);
+  }
+}
+
+int32_t WelsCodeSliceMbRows (sWelsEncCtx* pEncCtx, SSlice* pSlice) {
+  SMbRowThreading* pMrt			= pEncCtx->pMbRowThreading;
+  SDqLayer* pCurLayer			= pEncCtx->pCurDqLayer;
+  const SSliceHeader* kpSh		= &pSlice->sSliceHeaderExt.sSliceHeader;
+  const bool kbIntraSlice		= (I_SLICE == pEncCtx->eSliceType);
+  const bool kbBaseAvail		= pCurLayer->bBaseLayerAvailableFlag;
+  const bool kbHighestSpatial	= pEncCtx->pSvcParam->iSpatialLayerNum ==
+                                  (pCurLayer->sLayerInfo.sNalHeaderExt.uiDependencyId + 1);
+  int32_t iIdx					= 0;
+
+  if (!kbIntraSlice) {
+    //MD switch, same as WelsCodePSlice()
+    if (kbBaseAvail && kbHighestSpatial)
+      pEncCtx->pFuncList->pfInterMd	= WelsMdInterMbEnhancelayer;
+    else
+      pEncCtx->pFuncList->pfInterMd	= WelsMdInterMb;
+  }
+
+  pMrt->pCurSlice		= pSlice;
+  pMrt->iMbWidth		= pCurLayer->iMbWidth;
+  pMrt->iMbHeight		= pCurLayer->iMbHeight;
+  pMrt->iNextRow		= 0;
+  pMrt->iNextWriteRow	= 0;
+  pMrt->bWriting		= false;
+  pMrt->iEncReturn		= ENC_RETURN_SUCCESS;
+  memset (pMrt->pRowState, 0, pMrt->iMbHeight * sizeof (SMbRowState));
+
+  for (iIdx = 0; iIdx < pMrt->iWorkerNum; iIdx++) {
+    SMbRowWorker* pWorker	= &pMrt->pWorkers[iIdx];
+    SMbCache sMbCache		= pWorker->sSlice.sMbCacheInfo;
+
+    pWorker->sSlice					= *pSlice;
+    pWorker->sSlice.sMbCacheInfo	= sMbCache;	// each worker keeps its own MB cache
+
+    if (!kbIntraSlice) {
+      pWorker->sMd.uiRef			= kpSh->uiRefIndex;
+      pWorker->sMd.bMdUsingSad	= kbHighestSpatial;
+      if (!kbBaseAvail || !kbHighestSpatial)
+        memset (&pWorker->sMd.sMe, 0, sizeof (pWorker->sMd.sMe));
+    }
+  }
+
+  for (iIdx = 1; iIdx < pMrt->iWorkerNum; iIdx++)
+    WelsThreadPoolQueueTask (pMrt->pThreadPool, &pMrt->pWorkers[iIdx].sTask);
+  MbRowWorkerProc (&pMrt->pWorkers[0]);
+  WelsThreadPoolWaitGroup (pMrt->pThreadPool, &pMrt->sTaskGroup);
+
+  assert (pMrt->iNextWriteRow == pMrt->iMbHeight);
+  return pMrt->iEncReturn;
+}
+
+}
+#endif//MT_ENABLED
@@ -42,6 +42,7 @@
 #include "md.h"
 #include "cpu_core.h"
 #include "svc_enc_golomb.h"
+#include "set_mb_syn_cabac.h"
 
 namespace WelsSVCEnc {
 #define INTRA_VARIANCE_SAD_THRESHOLD 150
@@ -834,6 +835,48 @@ void MvdCostInit (uint16_t* pMvdCostInter, const int32_t kiMvdSz) {
   }
 }
 
+/*
+ * same layout as MvdCostInit(), bits of mvd are estimated from the initial cabac context states of P slice
+ * (cabac_init_idc 0) for each QP, with small mvd of the neighbouring blocks
+ */
+void MvdCostInitCabac (uint16_t* pMvdCostInter, const int32_t kiMvdSz) {
+  const int32_t kiSz		= kiMvdSz >> 1;
+  const int32_t* kpQpLambda = &g_kiQpCostTable[0];
+  uint8_t uiStateCtx[WELS_CONTEXT_COUNT];
+  int32_t iPrefixBits[10];	// in 1/256 bit unit, for prefix of |mvd| 0 ~ 9
+  int32_t i, j;
+
+  for (i = 0; i < 52; ++ i) {
+    const uint16_t kiLambda	= kpQpLambda[i];
+    uint16_t* pZeroMvd		= pMvdCostInter + i * kiMvdSz + kiSz;
+    int32_t iOnesBits		= 0;
+
+    WelsCabacContextStateInit (uiStateCtx, 0, i);
+    iPrefixBits[0] = WelsCabacBinBits (uiStateCtx[CTX_OFFSET_MVD_X], 0);
+    iOnesBits		= WelsCabacBinBits (uiStateCtx[CTX_OFFSET_MVD_X], 1);
+    for (j = 1; j < 10; j++) {
+      const uint8_t kuiState = uiStateCtx[CTX_OFFSET_MVD_X + WELS_MIN (j + 2, 6)];
+      iPrefixBits[j] = iOnesBits + ((j < 9) ? WelsCabacBinBits (kuiState, 0) : 0);
+      iOnesBits += WelsCabacBinBits (kuiState, 1);
+    }
+
+    *pZeroMvd = (kiLambda * iPrefixBits[0] + 128) >> 8;
+    for (j = 1; j <= kiSz; j++) {
+      int32_t iBits = iPrefixBits[WELS_MIN (j, 9)] + 256;	// sign
+      if (j >= 9) {
+        int32_t iSuffix = j - 9, k = 3;
+        while (iSuffix >= (1 << k)) {
+          iSuffix -= (1 << k);
+          ++ k;
+          iBits += 256;
+        }
+        iBits += (k + 1) << 8;
+      }
+      pZeroMvd[j] = pZeroMvd[-j] = (kiLambda * iBits + 128) >> 8;
+    }
+  }
+}
+
 void PredictSad (int8_t* pRefIndexCache, int32_t* pSadCostCache, int32_t uiRef, int32_t* pSadPred) {
   const int32_t kiRefB	= pRefIndexCache[1];//top g_uiCache12_8x8RefIdx[0] - 4
   int32_t iRefC			= pRefIndexCache[5];//top-right g_uiCache12_8x8RefIdx[0] - 2
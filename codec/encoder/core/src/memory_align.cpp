@@ -34,6 +34,7 @@
 #include <string.h>
 #include "memory_align.h"
 #include "macros.h"
+#include "WelsMemoryPool.h"
 
 namespace WelsSVCEnc {
 
@@ -85,7 +86,7 @@ void* CMemoryAlign::WelsMalloc (const uint32_t kuiSize, const char* kpTag) {
   const int32_t kiActualRequestedSize	= kiTrialRequestedSize;
   const uint32_t kiPayloadSize			= kuiSize;
 
-  uint8_t* pBuf		= (uint8_t*) malloc (kiActualRequestedSize);
+  uint8_t* pBuf		= (uint8_t*) WelsPoolMalloc (kiActualRequestedSize, kpTag);
 #ifdef MEMORY_CHECK
   if (m_fpMemChkPoint != NULL) {
     if (kpTag != NULL)
@@ -131,7 +132,7 @@ void CMemoryAlign::WelsFree (void* pPointer, const char* kpTag) {
       fflush (m_fpMemChkPoint);
     }
 #endif
-    free (* (((void**) pPointer) - 1));
+    WelsPoolFree (* (((void**) pPointer) - 1));
   }
 }
 
@@ -39,7 +39,46 @@
 #include "nal_encap.h"
 #include "svc_enc_golomb.h"
 #include "ls_defines.h"
+#include "cpu_core.h"
+#include <string.h>
 namespace WelsSVCEnc {
+
+/* high bit set in each byte of the word that may be zero, nonzero iff the word holds a zero byte */
+#define NAL_ZERO_BYTE_MASK(w)	(((w) - 0x0101010101010101ULL) & ~(w) & 0x8080808080808080ULL)
+
+int32_t WelsNalNonZeroRunLen_c (const uint8_t* pSrc, const uint8_t* pSrcEnd) {
+  const uint8_t* pCur = pSrc;
+  while (pSrcEnd - pCur >= 16) {
+    const uint64_t kuiWord0 = LD64 (pCur);
+    const uint64_t kuiWord1 = LD64 (pCur + 8);
+    if (NAL_ZERO_BYTE_MASK (kuiWord0) | NAL_ZERO_BYTE_MASK (kuiWord1))
+      break;
+    pCur += 16;
+  }
+  if (pSrcEnd - pCur >= 8) {
+    const uint64_t kuiWord = LD64 (pCur);
+    if (0 == NAL_ZERO_BYTE_MASK (kuiWord))
+      pCur += 8;
+  }
+  return (int32_t) (pCur - pSrc);
+}
+
+static PNalNonZeroRunLenFunc WelsNalNonZeroRunLen = WelsNalNonZeroRunLen_c;
+
+void WelsInitNalEncapFunc (const uint32_t kuiCpuFlag) {
+  WelsNalNonZeroRunLen = WelsNalNonZeroRunLen_c;
+#if defined(X86_ASM)
+  if (kuiCpuFlag & WELS_CPU_SSE2) {
+    WelsNalNonZeroRunLen = WelsNalNonZeroRunLen_sse2;
+  }
+  if (kuiCpuFlag & WELS_CPU_AVX2) {
+    WelsNalNonZeroRunLen = WelsNalNonZeroRunLen_avx2;
+  }
+#else
+  (void)kuiCpuFlag;
+#endif//X86_ASM
+}
+
 /*!
  * \brief	load an initialize NAL pRawNal pData
  */
@@ -162,6 +201,17 @@ int32_t WelsEncodeNal (SWelsNalRaw* pRawNal, void* pNalHeaderExt, const int32_t
   }
 
   while (pSrcPointer < pSrcEnd) {
+    /* an emulation prevention byte only follows two zero bytes, so the words holding no zero byte are copied
+       as is in bulk while no zero byte is pending, the escaping goes byte by byte around zero bytes only */
+    if (iZeroCount == 0) {
+      const int32_t kiRunLen = WelsNalNonZeroRunLen (pSrcPointer, pSrcEnd);
+      if (kiRunLen > 0) {
+        memcpy (pDstPointer, pSrcPointer, kiRunLen);
+        pDstPointer += kiRunLen;
+        pSrcPointer += kiRunLen;
+        continue;
+      }
+    }
     if (iZeroCount == 2 && *pSrcPointer <= 3) {
       //add the code 03
       *pDstPointer++	= 3;
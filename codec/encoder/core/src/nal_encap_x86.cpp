@@ -0,0 +1,100 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	nal_encap_x86.cpp
+ *
+ * \brief	SSE2/AVX2 zero byte scans for the NAL escaping
+ *
+ * \date	10/18/2014	Created
+ *
+ *************************************************************************************/
+#include "nal_encap.h"
+
+#if defined(X86_ASM)
+
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif//_MSC_VER
+
+#if defined(__GNUC__)
+#define WELS_ENC_TARGET(kpIsa)	__attribute__ ((target (kpIsa)))
+#else
+#define WELS_ENC_TARGET(kpIsa)
+#endif//__GNUC__
+
+namespace WelsSVCEnc {
+
+static inline int32_t LowestSetBit (const uint32_t kuiMask) {
+#if defined(_MSC_VER)
+  unsigned long uiIdx;
+  _BitScanForward (&uiIdx, kuiMask);
+  return (int32_t)uiIdx;
+#else
+  return __builtin_ctz (kuiMask);
+#endif//_MSC_VER
+}
+
+/* the run ends exactly at the first zero byte found in a vector, less than a vector left at the tail is scanned by
+   the narrower version */
+
+WELS_ENC_TARGET ("sse2")
+int32_t WelsNalNonZeroRunLen_sse2 (const uint8_t* pSrc, const uint8_t* pSrcEnd) {
+  const __m128i kvZero = _mm_setzero_si128();
+  const uint8_t* pCur = pSrc;
+  while (pSrcEnd - pCur >= 16) {
+    const __m128i kvSrc = _mm_loadu_si128 ((const __m128i*)pCur);
+    const uint32_t kuiMask = (uint32_t)_mm_movemask_epi8 (_mm_cmpeq_epi8 (kvSrc, kvZero));
+    if (kuiMask)
+      return (int32_t) (pCur - pSrc) + LowestSetBit (kuiMask);
+    pCur += 16;
+  }
+  return (int32_t) (pCur - pSrc) + WelsNalNonZeroRunLen_c (pCur, pSrcEnd);
+}
+
+WELS_ENC_TARGET ("avx2")
+int32_t WelsNalNonZeroRunLen_avx2 (const uint8_t* pSrc, const uint8_t* pSrcEnd) {
+  const __m256i kvZero = _mm256_setzero_si256();
+  const uint8_t* pCur = pSrc;
+  while (pSrcEnd - pCur >= 32) {
+    const __m256i kvSrc = _mm256_loadu_si256 ((const __m256i*)pCur);
+    const uint32_t kuiMask = (uint32_t)_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (kvSrc, kvZero));
+    if (kuiMask)
+      return (int32_t) (pCur - pSrc) + LowestSetBit (kuiMask);
+    pCur += 32;
+  }
+  return (int32_t) (pCur - pSrc) + WelsNalNonZeroRunLen_sse2 (pCur, pSrcEnd);
+}
+
+} // namespace WelsSVCEnc
+
+#endif//X86_ASM
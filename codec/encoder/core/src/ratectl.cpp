@@ -495,6 +495,9 @@ void RcDecideTargetBits (sWelsEncCtx* pEncCtx) {
   } else {
     pWelsSvcRc->iTargetBits = (int32_t) (pWelsSvcRc->iRemainingBits * pTOverRc->dTlayerWeight /
                                          pWelsSvcRc->dRemainingWeights);
+    //spread bits over lookahead window by complexity of upcoming frames
+    if (NULL != pEncCtx->pLookahead && pEncCtx->pLookahead->bValid)
+      pWelsSvcRc->iTargetBits = (int32_t) (pWelsSvcRc->iTargetBits * pEncCtx->pLookahead->dWeight);
     pWelsSvcRc->iTargetBits = WELS_CLIP3 (pWelsSvcRc->iTargetBits, pTOverRc->iMinBitsTl,	pTOverRc->iMaxBitsTl);
   }
   pWelsSvcRc->dRemainingWeights -= pTOverRc->dTlayerWeight;
@@ -869,6 +872,29 @@ void WelsRcMbInfoUpdateGom (void* pCtx, SMB* pCurMb, int32_t iCostLuma, SSlice*
   }
 }
 
+// wavefront MB rows: QP stays at the slice QP decided at picture level plus adaptive quantization
+void WelsRcMbInitWavefrontGom (void* pCtx, SMB* pCurMb, SSlice* pSlice) {
+  sWelsEncCtx* pEncCtx = (sWelsEncCtx*)pCtx;
+
+  if (pEncCtx->eSliceType == I_SLICE)
+    return;
+  RcCalculateMbQp (pEncCtx, pCurMb, pSlice->uiSliceIdx);
+}
+
+void WelsRcMbBitsInitWavefrontGom (void* pCtx, SMB* pCurMb, SSlice* pSlice) {
+  sWelsEncCtx* pEncCtx = (sWelsEncCtx*)pCtx;
+  SWelsSvcRc* pWelsSvcRc			= &pEncCtx->pWelsSvcRc[pEncCtx->uiDependencyId];
+  SRCSlicing* pSOverRc				= &pWelsSvcRc->pSlicingOverRc[pSlice->uiSliceIdx];
+
+  pSOverRc->iBsPosSlice = BsGetBitsPos (pSlice->pSliceBsa);
+
+  if (pEncCtx->eSliceType == I_SLICE)
+    return;
+  // keep gom costs per gom for complexity of next frame
+  if (0 == (pCurMb->iMbXY % pWelsSvcRc->iNumberMbGom) && pCurMb->iMbXY != pSOverRc->iStartMbSlice)
+    pSOverRc->iComplexityIndexSlice++;
+}
+
 void  WelsRcPictureInitDisable (void* pCtx) {
   sWelsEncCtx* pEncCtx = (sWelsEncCtx*)pCtx;
   SWelsSvcRc* pWelsSvcRc = &pEncCtx->pWelsSvcRc[pEncCtx->uiDependencyId];
@@ -903,6 +929,9 @@ void  WelsRcMbInitDisable (void* pCtx, SMB* pCurMb, SSlice* pSlice) {
 void  WelsRcMbInfoUpdateDisable (void* pCtx, SMB* pCurMb, int32_t iCostLuma, SSlice* pSlice) {
 }
 
+void  WelsRcMbBitsInitWavefrontDisable (void* pCtx, SMB* pCurMb, SSlice* pSlice) {
+}
+
 
 void  WelsRcInitModule (void* pCtx,  int32_t iModule) {
   sWelsEncCtx* pEncCtx = (sWelsEncCtx*)pCtx;
@@ -914,6 +943,8 @@ void  WelsRcInitModule (void* pCtx,  int32_t iModule) {
     pRcf->pfWelsRcPictureInfoUpdate = WelsRcPictureInfoUpdateDisable;
     pRcf->pfWelsRcMbInit = WelsRcMbInitDisable;
     pRcf->pfWelsRcMbInfoUpdate = WelsRcMbInfoUpdateDisable;
+    pRcf->pfWelsRcMbInitWavefront = WelsRcMbInitDisable;
+    pRcf->pfWelsRcMbBitsInitWavefront = WelsRcMbBitsInitWavefrontDisable;
     break;
   case WELS_RC_GOM:
   default:
@@ -921,6 +952,8 @@ void  WelsRcInitModule (void* pCtx,  int32_t iModule) {
     pRcf->pfWelsRcPictureInfoUpdate = WelsRcPictureInfoUpdateGom;
     pRcf->pfWelsRcMbInit = WelsRcMbInitGom;
     pRcf->pfWelsRcMbInfoUpdate = WelsRcMbInfoUpdateGom;
+    pRcf->pfWelsRcMbInitWavefront = WelsRcMbInitWavefrontGom;
+    pRcf->pfWelsRcMbBitsInitWavefront = WelsRcMbBitsInitWavefrontGom;
     break;
   }
 
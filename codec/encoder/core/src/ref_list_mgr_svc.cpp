@@ -348,8 +348,9 @@ bool WelsUpdateRefList (sWelsEncCtx* pCtx) {
 #if !defined(ENABLE_FRAME_DUMP)	// to save complexity, 1/6/2009
     if ((pParamD->iHighestTemporalId == 0) || (kuiTid < pParamD->iHighestTemporalId))
 #endif// !ENABLE_FRAME_DUMP
-    // Expanding picture for future reference
-    ExpandReferencingPicture (pCtx->pDecPic, pCtx->pFuncList->pfExpandLumaPicture, pCtx->pFuncList->pfExpandChromaPicture);
+    // Expanding picture for future reference, unless done along with the MB coding
+    if (!pCtx->pCurDqLayer->bExpandingRowFlag)
+      ExpandReferencingPicture (pCtx->pDecPic, pCtx->pFuncList->pfExpandLumaPicture, pCtx->pFuncList->pfExpandChromaPicture);
 
     // move picture in list
     pCtx->pDecPic->uiTemporalId = kuiTid;
@@ -0,0 +1,191 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	set_mb_syn_cabac.cpp
+ *
+ * \brief	Binary arithmetic coder and residual block writing with cabac
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include "set_mb_syn_cabac.h"
+#include "set_mb_syn_cavlc.h"
+#include "macros.h"
+
+namespace WelsSVCEnc {
+
+// count of bits to shift codIRange back into [256, 510], indexed by codIRange >> 3
+const uint8_t g_kuiCabacRenormShift[64] = {
+  6, 5, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// estimated bits of a bin in 1/256 bit unit, indexed by pStateIdx and whether the bin is LPS, -log2 of probability
+const uint16_t g_kuiCabacBinBits[64][2] = {
+  { 256,  256}, { 238,  275}, { 221,  294}, { 206,  314},
+  { 192,  333}, { 180,  352}, { 168,  371}, { 157,  391},
+  { 148,  410}, { 139,  429}, { 130,  448}, { 122,  468},
+  { 115,  487}, { 108,  506}, { 102,  525}, {  96,  545},
+  {  90,  564}, {  85,  583}, {  80,  602}, {  76,  622},
+  {  72,  641}, {  68,  660}, {  64,  679}, {  60,  699},
+  {  57,  718}, {  54,  737}, {  51,  756}, {  48,  776},
+  {  46,  795}, {  43,  814}, {  41,  833}, {  39,  853},
+  {  37,  872}, {  35,  891}, {  33,  910}, {  31,  930},
+  {  29,  949}, {  28,  968}, {  26,  987}, {  25, 1007},
+  {  24, 1026}, {  22, 1045}, {  21, 1064}, {  20, 1084},
+  {  19, 1103}, {  18, 1122}, {  17, 1141}, {  16, 1161},
+  {  15, 1180}, {  15, 1199}, {  14, 1218}, {  13, 1238},
+  {  12, 1257}, {  12, 1276}, {  11, 1295}, {  11, 1315},
+  {  10, 1334}, {  10, 1353}, {   9, 1372}, {   9, 1392},
+  {   8, 1411}, {   8, 1430}, {   7, 1449}, {   7, 1469}
+};
+
+// ctxBlockCatOffset of the residual syntax elements, Table 9-40 of the spec
+static const int16_t g_kiCbfCtxOffset[5]		= { 0, 4, 8, 12, 16 };
+static const int16_t g_kiSigCoeffCtxOffset[5]	= { 0, 15, 29, 44, 47 };
+static const int16_t g_kiAbsLevelCtxOffset[5]	= { 0, 10, 20, 30, 39 };
+
+void WelsCabacContextInit (SCabacCtx* pCbCtx, const int32_t kiModel, const int32_t kiSliceQp) {
+  WelsCabacContextStateInit (pCbCtx->sStateCtx, kiModel, kiSliceQp);
+}
+
+void WelsCabacEncodeInit (SCabacCtx* pCbCtx, uint8_t* pBuf, uint8_t* pBufEnd) {
+  pCbCtx->uiLow				= 0;
+  pCbCtx->iRange			= 510;
+  pCbCtx->iQueue			= -9;	// the first bit put by the coder is not written, see PutBit() of the spec
+  pCbCtx->iBytesOutstanding	= 0;
+  pCbCtx->pBufStart			= pBuf;
+  pCbCtx->pBufCur			= pBuf;
+  pCbCtx->pBufEnd			= pBufEnd;
+}
+
+void WelsCabacEncodeFlush (SCabacCtx* pCbCtx) {
+  // end_of_slice_flag: the bin 1 takes codIRange of 2 out of the interval
+  pCbCtx->iRange -= 2;
+  pCbCtx->uiLow += pCbCtx->iRange;
+
+  // the 10 bits of codILow are put after renormalization, the last one is rbsp_stop_one_bit
+  pCbCtx->uiLow |= 1;
+  pCbCtx->uiLow <<= 10;
+  pCbCtx->iQueue += 10;
+  while (pCbCtx->iQueue >= 0)
+    WelsCabacPutByte (pCbCtx);
+
+  // rbsp_alignment_zero_bit
+  if (pCbCtx->iQueue > -8) {
+    pCbCtx->uiLow <<= -pCbCtx->iQueue;
+    pCbCtx->iQueue = 0;
+    WelsCabacPutByte (pCbCtx);
+  }
+
+  while (pCbCtx->iBytesOutstanding > 0) {
+    *pCbCtx->pBufCur++ = 0xff;
+    -- pCbCtx->iBytesOutstanding;
+  }
+}
+
+void WelsCabacEncodeUeBypass (SCabacCtx* pCbCtx, int32_t iExpBits, uint32_t uiVal) {
+  while (uiVal >= (1u << iExpBits)) {
+    WelsCabacEncodeBypass (pCbCtx, 1);
+    uiVal -= (1u << iExpBits);
+    ++ iExpBits;
+  }
+  WelsCabacEncodeBypass (pCbCtx, 0);
+  while (iExpBits--)
+    WelsCabacEncodeBypass (pCbCtx, (uiVal >> iExpBits) & 1);
+}
+
+int32_t WriteBlockResidualCabac (SCabacCtx* pCbCtx, int16_t* pCoffLevel, int32_t iEndIdx, int32_t iResidualProperty,
+                                 int32_t iCbfCtxInc) {
+  const int32_t kiSigCtx		= CTX_OFFSET_SIG_COEFF_FLAG + g_kiSigCoeffCtxOffset[iResidualProperty];
+  const int32_t kiLastCtx		= CTX_OFFSET_LAST_SIG_COEFF_FLAG + g_kiSigCoeffCtxOffset[iResidualProperty];
+  const int32_t kiAbsCtx		= CTX_OFFSET_COEFF_ABS_LEVEL + g_kiAbsLevelCtxOffset[iResidualProperty];
+  const int32_t kiGt1CtxMax		= (CHROMA_DC == iResidualProperty) ? 3 : 4;
+  int32_t iLastIdx				= iEndIdx;
+  int32_t iNumEq1 = 0, iNumGt1 = 0;
+  int32_t i;
+
+  while (iLastIdx >= 0 && 0 == pCoffLevel[iLastIdx])
+    -- iLastIdx;
+
+  WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_CODED_BLOCK_FLAG + g_kiCbfCtxOffset[iResidualProperty] + iCbfCtxInc,
+                           iLastIdx >= 0);
+  if (iLastIdx < 0)
+    return 0;
+
+  /* significance map, the flags of the last coefficient of the block are inferred */
+  for (i = 0; i < iEndIdx; i++) {
+    const int32_t kiCtxInc = (CHROMA_DC == iResidualProperty) ? WELS_MIN (i, 2) : i;
+    const uint32_t kuiSig = (0 != pCoffLevel[i]);
+
+    WelsCabacEncodeDecision (pCbCtx, kiSigCtx + kiCtxInc, kuiSig);
+    if (kuiSig) {
+      WelsCabacEncodeDecision (pCbCtx, kiLastCtx + kiCtxInc, i == iLastIdx);
+      if (i == iLastIdx)
+        break;
+    }
+  }
+
+  /* levels in reverse scan order */
+  for (i = iLastIdx; i >= 0; i--) {
+    const int32_t kiLevel = pCoffLevel[i];
+    int32_t iAbsMinus1;
+
+    if (0 == kiLevel)
+      continue;
+
+    iAbsMinus1 = WELS_ABS (kiLevel) - 1;
+    WelsCabacEncodeDecision (pCbCtx, kiAbsCtx + ((iNumGt1 != 0) ? 0 : WELS_MIN (4, 1 + iNumEq1)), iAbsMinus1 > 0);
+    if (iAbsMinus1 > 0) {
+      const int32_t kiCtx = kiAbsCtx + 5 + WELS_MIN (kiGt1CtxMax, iNumGt1);
+      const int32_t kiPrefix = WELS_MIN (iAbsMinus1, 14);
+      int32_t j;
+
+      for (j = 1; j < kiPrefix; j++)
+        WelsCabacEncodeDecision (pCbCtx, kiCtx, 1);
+      if (iAbsMinus1 < 14)
+        WelsCabacEncodeDecision (pCbCtx, kiCtx, 0);
+      else
+        WelsCabacEncodeUeBypass (pCbCtx, 0, iAbsMinus1 - 14);
+      ++ iNumGt1;
+    } else {
+      ++ iNumEq1;
+    }
+    WelsCabacEncodeBypass (pCbCtx, kiLevel < 0);
+  }
+  return 1;
+}
+
+}
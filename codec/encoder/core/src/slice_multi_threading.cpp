@@ -219,6 +219,15 @@ int32_t NeedDynamicAdjust (void* pConsumeTime, const int32_t iSliceNum) {
 #endif//..
 
 #if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
+// pool task updating the neighbor info of the pMb list of one pSlice after slicing balance
+static void UpdateMbListTaskProc (void* pArg) {
+  SSliceThreadPrivateData* pPrivateData	= (SSliceThreadPrivateData*)pArg;
+  sWelsEncCtx* pEncPEncCtx			= (sWelsEncCtx*)pPrivateData->pWelsPEncCtx;
+  SDqLayer* pCurDq							= pEncPEncCtx->pCurDqLayer;
+
+  UpdateMbListNeighborParallel (pCurDq->pSliceEncCtx, pCurDq->sMbDataP, pPrivateData->iThreadIndex);
+}
+
 void DynamicAdjustSlicing (sWelsEncCtx* pCtx,
                            SDqLayer* pCurDqLayer,
                            void* pComplexRatio,
@@ -308,6 +317,19 @@ void DynamicAdjustSlicing (sWelsEncCtx* pCtx,
   if (DynamicAdjustSlicePEncCtxAll (pSliceCtx, iRunLen) == 0) {
     const int32_t kiThreadNum	= pCtx->pSvcParam->iCountThreadsNum;
     int32_t iThreadIdx			= 0;
+    if (NULL != pCtx->pSliceThreading->pThreadPool) {	// no update threads waiting, run the updates as pool tasks
+      do {
+        SWelsThreadTask* pTask	= &pCtx->pSliceThreading->pThreadPEncCtx[iThreadIdx].sTask;
+        pTask->pProc	= UpdateMbListTaskProc;
+        pTask->pArg		= &pCtx->pSliceThreading->pThreadPEncCtx[iThreadIdx];
+        pTask->pGroup	= &pCtx->pSliceThreading->sSliceTaskGroup;
+        WelsThreadPoolQueueTask (pCtx->pSliceThreading->pThreadPool, pTask);
+        ++ iThreadIdx;
+      } while (iThreadIdx < kiThreadNum);
+
+      WelsThreadPoolWaitGroup (pCtx->pSliceThreading->pThreadPool, &pCtx->pSliceThreading->sSliceTaskGroup);
+      return;
+    }
     do {
 #ifdef _WIN32
       WelsEventSignal (&pCtx->pSliceThreading->pUpdateMbListEvent[iThreadIdx]);
@@ -344,6 +366,7 @@ int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPara
   uint8_t* pBsBase			= NULL;
   int32_t iNumSpatialLayers	= 0;
   int32_t iThreadNum			= 0;
+  int32_t iPrivateDataNum		= 0;
   int32_t iIdx					= 0;
   int32_t iSliceBsBufferSize = 0;
   int16_t iMaxSliceNum		= 1;
@@ -361,7 +384,21 @@ int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPara
   pSmt	= (SSliceThreading*)pMa->WelsMalloc (sizeof (SSliceThreading), "SSliceThreading");
   WELS_VERIFY_RETURN_PROC_IF (1, (NULL == pSmt), FreeMemorySvc (ppCtx))
   (*ppCtx)->pSliceThreading	= pSmt;
-  pSmt->pThreadPEncCtx	= (SSliceThreadPrivateData*)pMa->WelsMalloc (sizeof (SSliceThreadPrivateData) * iThreadNum,
+  pSmt->pThreadPool		= NULL;
+
+  // with the shared pool every slice is a task of its own, so private data is needed per slice rather than per thread
+  if (pPara->bUseSharedThreadPool) {
+    if (WELS_THREAD_ERROR_OK == WelsThreadPoolAttachShared (&pSmt->pThreadPool)
+        && WELS_THREAD_ERROR_OK != WelsThreadTaskGroupInit (&pSmt->sSliceTaskGroup)) {
+      WelsThreadPoolDetachShared (pSmt->pThreadPool);
+      pSmt->pThreadPool	= NULL;
+    }
+    if (NULL == pSmt->pThreadPool)
+      WelsLog ((*ppCtx), WELS_LOG_WARNING, "RequestMtResource(), shared thread pool not available, use own threads\n");
+  }
+  iPrivateDataNum	= (NULL != pSmt->pThreadPool) ? WELS_MAX (iThreadNum, iMaxSliceNum) : iThreadNum;
+
+  pSmt->pThreadPEncCtx	= (SSliceThreadPrivateData*)pMa->WelsMalloc (sizeof (SSliceThreadPrivateData) * iPrivateDataNum,
                           "pThreadPEncCtx");
   WELS_VERIFY_RETURN_PROC_IF (1, (NULL == pSmt->pThreadPEncCtx), FreeMemorySvc (ppCtx))
   pSmt->pThreadHandles	= (WELS_THREAD_HANDLE*)pMa->WelsMalloc (sizeof (WELS_THREAD_HANDLE) * iThreadNum,
@@ -437,14 +474,20 @@ int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPara
 #endif//ENABLE_TRACE_MT
 
   iIdx = 0;
-  while (iIdx < iThreadNum) {
+  while (iIdx < iPrivateDataNum) {
+    pSmt->pThreadPEncCtx[iIdx].pWelsPEncCtx	= (void*) (*ppCtx);
+    pSmt->pThreadPEncCtx[iIdx].iSliceIndex	= iIdx;
+    pSmt->pThreadPEncCtx[iIdx].iThreadIndex	= iIdx;
+    ++ iIdx;
+  }
+
+  // neither threads nor events of its own when coding on the shared pool
+  iIdx = 0;
+  while (NULL == pSmt->pThreadPool && iIdx < iThreadNum) {
 #if defined(__GNUC__) && !defined(_WIN32)	// for posix threading
     char name[SEM_NAME_MAX] = {0};
     WELS_THREAD_ERROR_CODE err = 0;
 #endif//__GNUC__
-    pSmt->pThreadPEncCtx[iIdx].pWelsPEncCtx	= (void*) (*ppCtx);
-    pSmt->pThreadPEncCtx[iIdx].iSliceIndex	= iIdx;
-    pSmt->pThreadPEncCtx[iIdx].iThreadIndex	= iIdx;
     pSmt->pThreadHandles[iIdx]				= 0;
 
 #if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
@@ -553,7 +596,7 @@ void ReleaseMtResource (sWelsEncCtx** ppCtx) {
   if (NULL == pSmt)
     return;
 
-  while (iIdx < iThreadNum) {
+  while (NULL == pSmt->pThreadPool && iIdx < iThreadNum) {
 #ifdef _WIN32
     if (pSmt->pThreadHandles != NULL && pSmt->pThreadHandles[iIdx] != NULL)
       WelsThreadDestroy (&pSmt->pThreadHandles[iIdx]);
@@ -616,6 +659,12 @@ void ReleaseMtResource (sWelsEncCtx** ppCtx) {
   }
 #endif//PACKING_ONE_SLICE_PER_LAYER
 
+  if (NULL != pSmt->pThreadPool) {
+    WelsThreadTaskGroupDestroy (&pSmt->sSliceTaskGroup);
+    WelsThreadPoolDetachShared (pSmt->pThreadPool);
+    pSmt->pThreadPool = NULL;
+  }
+
   WelsMutexDestroy (&pSmt->mutexSliceNumUpdate);
   WelsMutexDestroy (&((*ppCtx)->mutexEncoderError));
 
@@ -691,6 +740,25 @@ void ReleaseMtResource (sWelsEncCtx** ppCtx) {
   (*ppCtx)->pSliceThreading = NULL;
 }
 
+void ResetMtResource (sWelsEncCtx* pCtx) {
+  SSliceThreading* pSmt	= NULL;
+  int32_t iIdx			= 0;
+
+  if (NULL == pCtx || NULL == pCtx->pSliceThreading)
+    return;
+
+  pSmt	= pCtx->pSliceThreading;
+#if defined(DYNAMIC_SLICE_ASSIGN) || defined(MT_DEBUG)
+  while (iIdx < pCtx->pSvcParam->iSpatialLayerNum) {
+    if (NULL != pSmt->pSliceConsumeTime[iIdx]) {
+      const int32_t kiSliceNum = pCtx->pSvcParam->sDependencyLayers[iIdx].sSliceCfg.sSliceArgument.uiSliceNum;
+      memset (pSmt->pSliceConsumeTime[iIdx], 0, kiSliceNum * sizeof (uint32_t));
+    }
+    ++ iIdx;
+  }
+#endif//#if defined(DYNAMIC_SLICE_ASSIGN) || defined(MT_DEBUG)
+}
+
 int32_t AppendSliceToFrameBs (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32_t iSliceCount) {
   SWelsSvcCodingParam* pCodingParam	= pCtx->pSvcParam;
   SDLayerParam* pDlp				= &pCodingParam->sDependencyLayers[pCtx->uiDependencyId];
@@ -901,337 +969,339 @@ WELS_THREAD_ROUTINE_TYPE UpdateMbListThreadProc (void* arg) {
 #endif//__GNUC__
 #endif//#if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
 
-// thread process for coding one pSlice
-WELS_THREAD_ROUTINE_TYPE CodingSliceThreadProc (void* arg) {
-  SSliceThreadPrivateData* pPrivateData	= (SSliceThreadPrivateData*)arg;
-  sWelsEncCtx* pEncPEncCtx			= NULL;
+// codes the slice (or the dynamic slicing partition) set in pPrivateData, returns non-zero on failure
+static uint32_t CodingSliceJob (SSliceThreadPrivateData* pPrivateData) {
+  sWelsEncCtx* pEncPEncCtx			= (sWelsEncCtx*)pPrivateData->pWelsPEncCtx;
   SDqLayer* pCurDq							= NULL;
   SSlice* pSlice								= NULL;
   SWelsSliceBs* pSliceBs						= NULL;
-#ifdef _WIN32
-  WELS_EVENT pEventsList[3];
-  int32_t iEventCount						= 0;
-#endif
-  WELS_THREAD_ERROR_CODE iWaitRet				= WELS_THREAD_ERROR_GENERAL;
   uint32_t uiThrdRet							= 0;
   int32_t iSliceSize							= 0;
   int32_t iSliceIdx							= -1;
-  int32_t iThreadIdx							= -1;
-  int32_t iEventIdx							= -1;
+  const int32_t iThreadIdx					= pPrivateData->iThreadIndex;
   bool bNeedPrefix							= false;
   EWelsNalUnitType eNalType						= NAL_UNIT_UNSPEC_0;
   EWelsNalRefIdc eNalRefIdc						= NRI_PRI_LOWEST;
   int32_t iReturn = ENC_RETURN_SUCCESS;
 
-  if (NULL == pPrivateData)
-    WELS_THREAD_ROUTINE_RETURN (1);
-
-  WelsSetThreadCancelable();
-
-  pEncPEncCtx	= (sWelsEncCtx*)pPrivateData->pWelsPEncCtx;
-
-  iThreadIdx		= pPrivateData->iThreadIndex;
-  iEventIdx		= iThreadIdx;
-
-#ifdef _WIN32
-  pEventsList[iEventCount++]	= pEncPEncCtx->pSliceThreading->pReadySliceCodingEvent[iEventIdx];
-  pEventsList[iEventCount++]	= pEncPEncCtx->pSliceThreading->pExitEncodeEvent[iEventIdx];
-#if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
-  pEventsList[iEventCount++] = pEncPEncCtx->pSliceThreading->pUpdateMbListEvent[iEventIdx];
-#endif//#if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
-#endif//_WIN32
-
-  do {
-#ifdef _WIN32
-    iWaitRet = WelsMultipleEventsWaitSingleBlocking (iEventCount,
-               &pEventsList[0],
-               (uint32_t) - 1);	// blocking until at least one event is
-#else
-#if defined(ENABLE_TRACE_MT)
-    WelsLog (pEncPEncCtx, WELS_LOG_INFO,
-             "[MT] CodingSliceThreadProc(), try to call WelsEventWait(pReadySliceCodingEvent[%d]= 0x%p), pEncPEncCtx= 0x%p!\n",
-             iEventIdx, (void*) (pEncPEncCtx->pReadySliceCodingEvent[iEventIdx]), (void*)pEncPEncCtx);
-#endif
-    iWaitRet = WelsEventWait (pEncPEncCtx->pSliceThreading->pReadySliceCodingEvent[iEventIdx]);
-#endif//WIN32
-    if (WELS_THREAD_ERROR_WAIT_OBJECT_0 == iWaitRet) {	// start pSlice coding signal waited
-      SLayerBSInfo* pLbi = pPrivateData->pLayerBs;
-      const int32_t kiCurDid			= pEncPEncCtx->uiDependencyId;
-      const int32_t kiCurTid			= pEncPEncCtx->uiTemporalId;
-      SWelsSvcCodingParam* pCodingParam	= pEncPEncCtx->pSvcParam;
-      SDLayerParam* pParamD			= &pCodingParam->sDependencyLayers[kiCurDid];
+  SLayerBSInfo* pLbi = pPrivateData->pLayerBs;
+  const int32_t kiCurDid			= pEncPEncCtx->uiDependencyId;
+  const int32_t kiCurTid			= pEncPEncCtx->uiTemporalId;
+  SWelsSvcCodingParam* pCodingParam	= pEncPEncCtx->pSvcParam;
+  SDLayerParam* pParamD			= &pCodingParam->sDependencyLayers[kiCurDid];
 
-      pCurDq			= pEncPEncCtx->pCurDqLayer;
-      eNalType		= pEncPEncCtx->eNalType;
-      eNalRefIdc		= pEncPEncCtx->eNalPriority;
-      bNeedPrefix		= pEncPEncCtx->bNeedPrefixNalFlag;
+  pCurDq			= pEncPEncCtx->pCurDqLayer;
+  eNalType		= pEncPEncCtx->eNalType;
+  eNalRefIdc		= pEncPEncCtx->eNalPriority;
+  bNeedPrefix		= pEncPEncCtx->bNeedPrefixNalFlag;
 
-      if (pParamD->sSliceCfg.uiSliceMode != SM_DYN_SLICE) {
-        int64_t iSliceStart	= 0;
-        bool bDsaFlag = false;
-        iSliceIdx		= pPrivateData->iSliceIndex;
-        pSlice			= &pCurDq->sLayerInfo.pSliceInLayer[iSliceIdx];
-        pSliceBs		= &pEncPEncCtx->pSliceBs[iSliceIdx];
+  if (pParamD->sSliceCfg.uiSliceMode != SM_DYN_SLICE) {
+    int64_t iSliceStart	= 0;
+    bool bDsaFlag = false;
+    iSliceIdx		= pPrivateData->iSliceIndex;
+    pSlice			= &pCurDq->sLayerInfo.pSliceInLayer[iSliceIdx];
+    pSliceBs		= &pEncPEncCtx->pSliceBs[iSliceIdx];
 
 #if defined(DYNAMIC_SLICE_ASSIGN) || defined(MT_DEBUG)
-        bDsaFlag	= (pParamD->sSliceCfg.uiSliceMode == SM_FIXEDSLCNUM_SLICE &&
-                     pCodingParam->iMultipleThreadIdc > 1 &&
-                     pCodingParam->iMultipleThreadIdc >= pParamD->sSliceCfg.sSliceArgument.uiSliceNum);
-        if (bDsaFlag)
-          iSliceStart = WelsTime();
+    bDsaFlag	= (pParamD->sSliceCfg.uiSliceMode == SM_FIXEDSLCNUM_SLICE &&
+                 pCodingParam->iMultipleThreadIdc > 1 &&
+                 pCodingParam->iMultipleThreadIdc >= pParamD->sSliceCfg.sSliceArgument.uiSliceNum);
+    if (bDsaFlag)
+      iSliceStart = WelsTime();
 #endif//DYNAMIC_SLICE_ASSIGN || MT_DEBUG
 
 #if !defined(PACKING_ONE_SLICE_PER_LAYER)
-        pSliceBs->uiBsPos	= 0;
+    pSliceBs->uiBsPos	= 0;
 #endif//!PACKING_ONE_SLICE_PER_LAYER
-        pSliceBs->iNalIndex	= 0;
-        assert ((void*) (&pSliceBs->sBsWrite) == (void*)pSlice->pSliceBsa);
-        InitBits (&pSliceBs->sBsWrite, pSliceBs->pBsBuffer, pSliceBs->uiSize);
+    pSliceBs->iNalIndex	= 0;
+    assert ((void*) (&pSliceBs->sBsWrite) == (void*)pSlice->pSliceBsa);
+    InitBits (&pSliceBs->sBsWrite, pSliceBs->pBsBuffer, pSliceBs->uiSize);
 
 #if MT_DEBUG_BS_WR
-        pSliceBs->bSliceCodedFlag	= false;
+    pSliceBs->bSliceCodedFlag	= false;
 #endif//MT_DEBUG_BS_WR
 
-        if (bNeedPrefix) {
-          if (eNalRefIdc != NRI_PRI_LOWEST) {
-            WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
-            WelsWriteSVCPrefixNal (&pSliceBs->sBsWrite, eNalRefIdc, (NAL_UNIT_CODED_SLICE_IDR == eNalType));
-            WelsUnloadNalForSlice (pSliceBs);
-          } else { // No Prefix NAL Unit RBSP syntax here, but need add NAL Unit Header extension
-            WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
-            // No need write any syntax of prefix NAL Unit RBSP here
-            WelsUnloadNalForSlice (pSliceBs);
-          }
-        }
+    if (bNeedPrefix) {
+      if (eNalRefIdc != NRI_PRI_LOWEST) {
+        WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
+        WelsWriteSVCPrefixNal (&pSliceBs->sBsWrite, eNalRefIdc, (NAL_UNIT_CODED_SLICE_IDR == eNalType));
+        WelsUnloadNalForSlice (pSliceBs);
+      } else { // No Prefix NAL Unit RBSP syntax here, but need add NAL Unit Header extension
+        WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
+        // No need write any syntax of prefix NAL Unit RBSP here
+        WelsUnloadNalForSlice (pSliceBs);
+      }
+    }
 
-        WelsLoadNalForSlice (pSliceBs, eNalType, eNalRefIdc);
+    WelsLoadNalForSlice (pSliceBs, eNalType, eNalRefIdc);
 
-        iReturn = WelsCodeOneSlice (pEncPEncCtx, iSliceIdx, eNalType);
-        if (ENC_RETURN_SUCCESS!=iReturn) {
-          uiThrdRet = iReturn;
-          break;
-        }
+    iReturn = WelsCodeOneSlice (pEncPEncCtx, iSliceIdx, eNalType);
+    if (ENC_RETURN_SUCCESS!=iReturn) {
+      return iReturn;
+    }
 
-        WelsUnloadNalForSlice (pSliceBs);
+    WelsUnloadNalForSlice (pSliceBs);
 
 #if !defined(PACKING_ONE_SLICE_PER_LAYER)
-        if (0 == iSliceIdx) {
-          pLbi->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
-          iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pLbi->pBsBuf, iSliceIdx, iSliceSize);
-          if (ENC_RETURN_SUCCESS!=iReturn) {
-            uiThrdRet = iReturn;
-            break;
-          }
-          pEncPEncCtx->iPosBsBuffer += iSliceSize;
-        } else
-        {
-          iReturn = WriteSliceBs (pEncPEncCtx, pSliceBs->pBs, iSliceIdx, iSliceSize);
-          if (ENC_RETURN_SUCCESS!=iReturn) {
-            uiThrdRet = iReturn;
-            break;
-          }
-        }
+    if (0 == iSliceIdx) {
+      pLbi->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
+      iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pLbi->pBsBuf, iSliceIdx, iSliceSize);
+      if (ENC_RETURN_SUCCESS!=iReturn) {
+        return iReturn;
+      }
+      pEncPEncCtx->iPosBsBuffer += iSliceSize;
+    } else
+    {
+      iReturn = WriteSliceBs (pEncPEncCtx, pSliceBs->pBs, iSliceIdx, iSliceSize);
+      if (ENC_RETURN_SUCCESS!=iReturn) {
+        return iReturn;
+      }
+    }
 #else// PACKING_ONE_SLICE_PER_LAYER
-        if (0 == iSliceIdx) {
-          pLbi->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
-          iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pLbi->pBsBuf, iSliceIdx, &iSliceSize);
-          if (ENC_RETURN_SUCCESS!=iReturn) {
-            uiThrdRet = iReturn;
-            break;
-          }
-          pEncPEncCtx->iPosBsBuffer += iSliceSize;
-        } else {
-          pLbi->pBsBuf	= pSliceBs->bs + pSliceBs->uiBsPos;
-          iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pLbi->pBsBuf, iSliceIdx, &iSliceSize);
-          if (ENC_RETURN_SUCCESS!=iReturn) {
-            uiThrdRet = iReturn;
-            break;
-          }
-          pSliceBs->uiBsPos += iSliceSize;
-        }
+    if (0 == iSliceIdx) {
+      pLbi->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
+      iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pLbi->pBsBuf, iSliceIdx, &iSliceSize);
+      if (ENC_RETURN_SUCCESS!=iReturn) {
+        return iReturn;
+      }
+      pEncPEncCtx->iPosBsBuffer += iSliceSize;
+    } else {
+      pLbi->pBsBuf	= pSliceBs->bs + pSliceBs->uiBsPos;
+      iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pLbi->pBsBuf, iSliceIdx, &iSliceSize);
+      if (ENC_RETURN_SUCCESS!=iReturn) {
+        return iReturn;
+      }
+      pSliceBs->uiBsPos += iSliceSize;
+    }
 #endif//!PACKING_ONE_SLICE_PER_LAYER
 
-        if (pCurDq->bDeblockingParallelFlag && pSlice->sSliceHeaderExt.sSliceHeader.uiDisableDeblockingFilterIdc != 1
+    if (pCurDq->bDeblockingParallelFlag && pSlice->sSliceHeaderExt.sSliceHeader.uiDisableDeblockingFilterIdc != 1
 #if !defined(ENABLE_FRAME_DUMP)
-            && (eNalRefIdc != NRI_PRI_LOWEST) &&
-            (pParamD->iHighestTemporalId == 0 || kiCurTid < pParamD->iHighestTemporalId)
+        && (eNalRefIdc != NRI_PRI_LOWEST) &&
+        (pParamD->iHighestTemporalId == 0 || kiCurTid < pParamD->iHighestTemporalId)
 #endif// !ENABLE_FRAME_DUMP
-           ) {
-          DeblockingFilterSliceAvcbase (pCurDq, pEncPEncCtx->pFuncList, iSliceIdx);
-        }
+       ) {
+      DeblockingFilterSliceAvcbase (pCurDq, pEncPEncCtx->pFuncList, iSliceIdx);
+    }
 
 #if defined(DYNAMIC_SLICE_ASSIGN) || defined(MT_DEBUG)
-        if (bDsaFlag) {
-          pEncPEncCtx->pSliceThreading->pSliceConsumeTime[pEncPEncCtx->uiDependencyId][iSliceIdx] = (uint32_t) (
-                WelsTime() - iSliceStart);
+    if (bDsaFlag) {
+      pEncPEncCtx->pSliceThreading->pSliceConsumeTime[pEncPEncCtx->uiDependencyId][iSliceIdx] = (uint32_t) (
+            WelsTime() - iSliceStart);
 #if defined(ENABLE_TRACE_MT)
-          WelsLog (pEncPEncCtx, WELS_LOG_INFO,
-                   "[MT] CodingSliceThreadProc(), coding_idx %d, uiSliceIdx %d, pSliceConsumeTime %d, iSliceSize %d, pFirstMbInSlice %d, count_num_mb_in_slice %d\n",
-                   pEncPEncCtx->iCodingIndex, iSliceIdx,
-                   pEncPEncCtx->pSliceThreading->pSliceConsumeTime[pEncPEncCtx->uiDependencyId][iSliceIdx], iSliceSize,
-                   pCurDq->pSliceEncCtx->pFirstMbInSlice[iSliceIdx], pCurDq->pSliceEncCtx->pCountMbNumInSlice[iSliceIdx]);
+      WelsLog (pEncPEncCtx, WELS_LOG_INFO,
+               "[MT] CodingSliceThreadProc(), coding_idx %d, uiSliceIdx %d, pSliceConsumeTime %d, iSliceSize %d, pFirstMbInSlice %d, count_num_mb_in_slice %d\n",
+               pEncPEncCtx->iCodingIndex, iSliceIdx,
+               pEncPEncCtx->pSliceThreading->pSliceConsumeTime[pEncPEncCtx->uiDependencyId][iSliceIdx], iSliceSize,
+               pCurDq->pSliceEncCtx->pFirstMbInSlice[iSliceIdx], pCurDq->pSliceEncCtx->pCountMbNumInSlice[iSliceIdx]);
 #endif//ENABLE_TRACE_MT
-        }
+    }
 #endif//DYNAMIC_SLICE_ASSIGN || MT_DEBUG
 
 #if defined(SLICE_INFO_OUTPUT)
-        fprintf (stderr,
-                 "@pSlice=%-6d sliceType:%c idc:%d size:%-6d\n",
-                 iSliceIdx,
-                 (pEncPEncCtx->eSliceType == P_SLICE ? 'P' : 'I'),
-                 eNalRefIdc,
-                 iSliceSize
-                );
+    fprintf (stderr,
+             "@pSlice=%-6d sliceType:%c idc:%d size:%-6d\n",
+             iSliceIdx,
+             (pEncPEncCtx->eSliceType == P_SLICE ? 'P' : 'I'),
+             eNalRefIdc,
+             iSliceSize
+            );
 #endif//SLICE_INFO_OUTPUT
 
 #if MT_DEBUG_BS_WR
-        pSliceBs->bSliceCodedFlag	= true;
+    pSliceBs->bSliceCodedFlag	= true;
 #endif//MT_DEBUG_BS_WR
 
-#ifdef _WIN32
-        WelsEventSignal (
-          &pEncPEncCtx->pSliceThreading->pSliceCodedEvent[iEventIdx]);	// mean finished coding current pSlice
-#else
-        WelsEventSignal (pEncPEncCtx->pSliceThreading->pSliceCodedEvent[iEventIdx]);	// mean finished coding current pSlice
-#endif//WIN32
-      } else {	// for SM_DYN_SLICE parallelization
+  } else {	// for SM_DYN_SLICE parallelization
 #ifdef PACKING_ONE_SLICE_PER_LAYER
-        SLayerBSInfo* pLbiPacking			= NULL;
+    SLayerBSInfo* pLbiPacking			= NULL;
 #endif//PACKING_ONE_SLICE_PER_LAYER
-        SSliceCtx* pSliceCtx			= pCurDq->pSliceEncCtx;
-        const int32_t kiPartitionId			= iThreadIdx;
-        const int32_t kiSliceIdxStep		= pEncPEncCtx->iActiveThreadsNum;
-        const int32_t kiFirstMbInPartition	= pPrivateData->iStartMbIndex;	// inclusive
-        const int32_t kiEndMbInPartition	= pPrivateData->iEndMbIndex;		// exclusive
-        int32_t iAnyMbLeftInPartition	= kiEndMbInPartition - kiFirstMbInPartition;
-
-        iSliceIdx		= pPrivateData->iSliceIndex;
-
-        pSliceCtx->pFirstMbInSlice[iSliceIdx]				= kiFirstMbInPartition;
-        pCurDq->pNumSliceCodedOfPartition[kiPartitionId]		= 1;	// one pSlice per partition intialized, dynamic slicing inside
-        pCurDq->pLastMbIdxOfPartition[kiPartitionId]			= kiEndMbInPartition - 1;
-
-        pCurDq->pLastCodedMbIdxOfPartition[kiPartitionId]		= 0;
-
-        while (iAnyMbLeftInPartition > 0) {
-          if (iSliceIdx >= pSliceCtx->iMaxSliceNumConstraint) {
-            // TODO: need exception handler for not large enough of MAX_SLICES_NUM related memory usage
-            // No idea about its solution due MAX_SLICES_NUM is fixed lenght in relevent pData structure
-            uiThrdRet	= 1;
-            break;
-          }
+    SSliceCtx* pSliceCtx			= pCurDq->pSliceEncCtx;
+    const int32_t kiPartitionId			= iThreadIdx;
+    const int32_t kiSliceIdxStep		= pEncPEncCtx->iActiveThreadsNum;
+    const int32_t kiFirstMbInPartition	= pPrivateData->iStartMbIndex;	// inclusive
+    const int32_t kiEndMbInPartition	= pPrivateData->iEndMbIndex;		// exclusive
+    int32_t iAnyMbLeftInPartition	= kiEndMbInPartition - kiFirstMbInPartition;
+
+    iSliceIdx		= pPrivateData->iSliceIndex;
+
+    pSliceCtx->pFirstMbInSlice[iSliceIdx]				= kiFirstMbInPartition;
+    pCurDq->pNumSliceCodedOfPartition[kiPartitionId]		= 1;	// one pSlice per partition intialized, dynamic slicing inside
+    pCurDq->pLastMbIdxOfPartition[kiPartitionId]			= kiEndMbInPartition - 1;
+
+    pCurDq->pLastCodedMbIdxOfPartition[kiPartitionId]		= 0;
+
+    while (iAnyMbLeftInPartition > 0) {
+      if (iSliceIdx >= pSliceCtx->iMaxSliceNumConstraint) {
+        // TODO: need exception handler for not large enough of MAX_SLICES_NUM related memory usage
+        // No idea about its solution due MAX_SLICES_NUM is fixed lenght in relevent pData structure
+        uiThrdRet	= 1;
+        break;
+      }
 
-          pSlice			= &pCurDq->sLayerInfo.pSliceInLayer[iSliceIdx];
-          pSliceBs		= &pEncPEncCtx->pSliceBs[iSliceIdx];
+      pSlice			= &pCurDq->sLayerInfo.pSliceInLayer[iSliceIdx];
+      pSliceBs		= &pEncPEncCtx->pSliceBs[iSliceIdx];
 
 #if !defined(PACKING_ONE_SLICE_PER_LAYER)
-          pSliceBs->uiBsPos	= 0;
+      pSliceBs->uiBsPos	= 0;
 #endif//!PACKING_ONE_SLICE_PER_LAYER
-          pSliceBs->iNalIndex	= 0;
-          InitBits (&pSliceBs->sBsWrite, pSliceBs->pBsBuffer, pSliceBs->uiSize);
-
-          if (bNeedPrefix) {
-            if (eNalRefIdc != NRI_PRI_LOWEST) {
-              WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
-              WelsWriteSVCPrefixNal (&pSliceBs->sBsWrite, eNalRefIdc, (NAL_UNIT_CODED_SLICE_IDR == eNalType));
-              WelsUnloadNalForSlice (pSliceBs);
-            } else { // No Prefix NAL Unit RBSP syntax here, but need add NAL Unit Header extension
-              WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
-              // No need write any syntax of prefix NAL Unit RBSP here
-              WelsUnloadNalForSlice (pSliceBs);
-            }
-          }
+      pSliceBs->iNalIndex	= 0;
+      InitBits (&pSliceBs->sBsWrite, pSliceBs->pBsBuffer, pSliceBs->uiSize);
 
-          WelsLoadNalForSlice (pSliceBs, eNalType, eNalRefIdc);
+      if (bNeedPrefix) {
+        if (eNalRefIdc != NRI_PRI_LOWEST) {
+          WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
+          WelsWriteSVCPrefixNal (&pSliceBs->sBsWrite, eNalRefIdc, (NAL_UNIT_CODED_SLICE_IDR == eNalType));
+          WelsUnloadNalForSlice (pSliceBs);
+        } else { // No Prefix NAL Unit RBSP syntax here, but need add NAL Unit Header extension
+          WelsLoadNalForSlice (pSliceBs, NAL_UNIT_PREFIX, eNalRefIdc);
+          // No need write any syntax of prefix NAL Unit RBSP here
+          WelsUnloadNalForSlice (pSliceBs);
+        }
+      }
 
-          iReturn = WelsCodeOneSlice (pEncPEncCtx, iSliceIdx, eNalType);
-          if (ENC_RETURN_SUCCESS!=iReturn) {
-            uiThrdRet = iReturn;
-            break;
-          }
+      WelsLoadNalForSlice (pSliceBs, eNalType, eNalRefIdc);
 
-          WelsUnloadNalForSlice (pSliceBs);
+      iReturn = WelsCodeOneSlice (pEncPEncCtx, iSliceIdx, eNalType);
+      if (ENC_RETURN_SUCCESS!=iReturn) {
+        uiThrdRet = iReturn;
+        break;
+      }
+
+      WelsUnloadNalForSlice (pSliceBs);
 
 #if !defined(PACKING_ONE_SLICE_PER_LAYER)
-          if (0 == kiPartitionId) {
-            if (0 == iSliceIdx)
-              pLbi->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
-            iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer, iSliceIdx, iSliceSize);
-            if (ENC_RETURN_SUCCESS!=iReturn) {
-              uiThrdRet = iReturn;
-              break;
-            }
-            pEncPEncCtx->iPosBsBuffer += iSliceSize;
-          } else
-          {
-            iSliceSize = WriteSliceBs (pEncPEncCtx, pSliceBs->pBs, iSliceIdx, iSliceSize);
-            if (ENC_RETURN_SUCCESS!=iReturn) {
-              uiThrdRet = iReturn;
-              break;
-            }
-          }
+      if (0 == kiPartitionId) {
+        if (0 == iSliceIdx)
+          pLbi->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
+        iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbi, pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer, iSliceIdx, iSliceSize);
+        if (ENC_RETURN_SUCCESS!=iReturn) {
+          uiThrdRet = iReturn;
+          break;
+        }
+        pEncPEncCtx->iPosBsBuffer += iSliceSize;
+      } else
+      {
+        iSliceSize = WriteSliceBs (pEncPEncCtx, pSliceBs->pBs, iSliceIdx, iSliceSize);
+        if (ENC_RETURN_SUCCESS!=iReturn) {
+          uiThrdRet = iReturn;
+          break;
+        }
+      }
 #else// PACKING_ONE_SLICE_PER_LAYER
-          pLbiPacking	= pLbi + (iSliceIdx - kiPartitionId);
-
-          if (0 == kiPartitionId) {
-            pLbiPacking->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
-            iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbiPacking, pLbiPacking->pBsBuf, iSliceIdx, iSliceSize);
-            if (ENC_RETURN_SUCCESS!=iReturn) {
-              uiThrdRet = iReturn;
-              break;
-            }
-            pEncPEncCtx->iPosBsBuffer += iSliceSize;
-          } else {
-            pLbiPacking->pBsBuf	= pSliceBs->bs + pSliceBs->uiBsPos;
-            iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbiPacking, pLbiPacking->pBsBuf, iSliceIdx, iSliceSize);
-            if (ENC_RETURN_SUCCESS!=iReturn) {
-              uiThrdRet = iReturn;
-              break;
-            }
-            pSliceBs->uiBsPos += iSliceSize;
-          }
-          pEncPEncCtx->pSliceThreading->pCountBsSizeInPartition[kiPartitionId] += iSliceSize;
+      pLbiPacking	= pLbi + (iSliceIdx - kiPartitionId);
+
+      if (0 == kiPartitionId) {
+        pLbiPacking->pBsBuf	= pEncPEncCtx->pFrameBs + pEncPEncCtx->iPosBsBuffer;
+        iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbiPacking, pLbiPacking->pBsBuf, iSliceIdx, iSliceSize);
+        if (ENC_RETURN_SUCCESS!=iReturn) {
+          uiThrdRet = iReturn;
+          break;
+        }
+        pEncPEncCtx->iPosBsBuffer += iSliceSize;
+      } else {
+        pLbiPacking->pBsBuf	= pSliceBs->bs + pSliceBs->uiBsPos;
+        iReturn = WriteSliceToFrameBs (pEncPEncCtx, pLbiPacking, pLbiPacking->pBsBuf, iSliceIdx, iSliceSize);
+        if (ENC_RETURN_SUCCESS!=iReturn) {
+          uiThrdRet = iReturn;
+          break;
+        }
+        pSliceBs->uiBsPos += iSliceSize;
+      }
+      pEncPEncCtx->pSliceThreading->pCountBsSizeInPartition[kiPartitionId] += iSliceSize;
 #endif//!PACKING_ONE_SLICE_PER_LAYER
 
-          if (pCurDq->bDeblockingParallelFlag && pSlice->sSliceHeaderExt.sSliceHeader.uiDisableDeblockingFilterIdc != 1
+      if (pCurDq->bDeblockingParallelFlag && pSlice->sSliceHeaderExt.sSliceHeader.uiDisableDeblockingFilterIdc != 1
 #if !defined(ENABLE_FRAME_DUMP)
-              && (eNalRefIdc != NRI_PRI_LOWEST) &&
-              (pParamD->iHighestTemporalId == 0 || kiCurTid < pParamD->iHighestTemporalId)
+          && (eNalRefIdc != NRI_PRI_LOWEST) &&
+          (pParamD->iHighestTemporalId == 0 || kiCurTid < pParamD->iHighestTemporalId)
 #endif// !ENABLE_FRAME_DUMP
-             ) {
-            DeblockingFilterSliceAvcbase (pCurDq, pEncPEncCtx->pFuncList, iSliceIdx);
-          }
+         ) {
+        DeblockingFilterSliceAvcbase (pCurDq, pEncPEncCtx->pFuncList, iSliceIdx);
+      }
 
 #if defined(SLICE_INFO_OUTPUT)
-          fprintf (stderr,
-                   "@pSlice=%-6d sliceType:%c idc:%d size:%-6d\n",
-                   iSliceIdx,
-                   (pEncPEncCtx->eSliceType == P_SLICE ? 'P' : 'I'),
-                   eNalRefIdc,
-                   iSliceSize
-                  );
+      fprintf (stderr,
+               "@pSlice=%-6d sliceType:%c idc:%d size:%-6d\n",
+               iSliceIdx,
+               (pEncPEncCtx->eSliceType == P_SLICE ? 'P' : 'I'),
+               eNalRefIdc,
+               iSliceSize
+              );
 #endif//SLICE_INFO_OUTPUT
 
 #if defined(ENABLE_TRACE_MT)
-          WelsLog (pEncPEncCtx, WELS_LOG_INFO,
-                   "[MT] CodingSliceThreadProc(), coding_idx %d, iPartitionId %d, uiSliceIdx %d, iSliceSize %d, count_mb_slice %d, iEndMbInPartition %d, pCurDq->pLastCodedMbIdxOfPartition[%d] %d\n",
-                   pEncPEncCtx->iCodingIndex, kiPartitionId, iSliceIdx, iSliceSize, pCurDq->pSliceEncCtx->pCountMbNumInSlice[iSliceIdx],
-                   kiEndMbInPartition, kiPartitionId, pCurDq->pLastCodedMbIdxOfPartition[kiPartitionId]);
+      WelsLog (pEncPEncCtx, WELS_LOG_INFO,
+               "[MT] CodingSliceThreadProc(), coding_idx %d, iPartitionId %d, uiSliceIdx %d, iSliceSize %d, count_mb_slice %d, iEndMbInPartition %d, pCurDq->pLastCodedMbIdxOfPartition[%d] %d\n",
+               pEncPEncCtx->iCodingIndex, kiPartitionId, iSliceIdx, iSliceSize, pCurDq->pSliceEncCtx->pCountMbNumInSlice[iSliceIdx],
+               kiEndMbInPartition, kiPartitionId, pCurDq->pLastCodedMbIdxOfPartition[kiPartitionId]);
 #endif//ENABLE_TRACE_MT
 
-          iAnyMbLeftInPartition = kiEndMbInPartition - (1 + pCurDq->pLastCodedMbIdxOfPartition[kiPartitionId]);
-          iSliceIdx += kiSliceIdxStep;
-        }
+      iAnyMbLeftInPartition = kiEndMbInPartition - (1 + pCurDq->pLastCodedMbIdxOfPartition[kiPartitionId]);
+      iSliceIdx += kiSliceIdxStep;
+    }
 
-        if (uiThrdRet)	// any exception??
-          break;
+  }
 
+  return uiThrdRet;
+}
+
+// thread process for coding one pSlice
+WELS_THREAD_ROUTINE_TYPE CodingSliceThreadProc (void* arg) {
+  SSliceThreadPrivateData* pPrivateData	= (SSliceThreadPrivateData*)arg;
+  sWelsEncCtx* pEncPEncCtx			= NULL;
 #ifdef _WIN32
-        WelsEventSignal (&pEncPEncCtx->pSliceThreading->pSliceCodedEvent[iEventIdx]);	// mean finished coding current pSlice
+  SDqLayer* pCurDq							= NULL;
+  WELS_EVENT pEventsList[3];
+  int32_t iEventCount						= 0;
+  int32_t iSliceIdx							= -1;
+#endif
+  WELS_THREAD_ERROR_CODE iWaitRet				= WELS_THREAD_ERROR_GENERAL;
+  uint32_t uiThrdRet							= 0;
+  int32_t iThreadIdx							= -1;
+  int32_t iEventIdx							= -1;
+
+  if (NULL == pPrivateData)
+    WELS_THREAD_ROUTINE_RETURN (1);
+
+  WelsSetThreadCancelable();
+
+  pEncPEncCtx	= (sWelsEncCtx*)pPrivateData->pWelsPEncCtx;
+
+  iThreadIdx		= pPrivateData->iThreadIndex;
+  iEventIdx		= iThreadIdx;
+
+#ifdef _WIN32
+  pEventsList[iEventCount++]	= pEncPEncCtx->pSliceThreading->pReadySliceCodingEvent[iEventIdx];
+  pEventsList[iEventCount++]	= pEncPEncCtx->pSliceThreading->pExitEncodeEvent[iEventIdx];
+#if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
+  pEventsList[iEventCount++] = pEncPEncCtx->pSliceThreading->pUpdateMbListEvent[iEventIdx];
+#endif//#if defined(DYNAMIC_SLICE_ASSIGN) && defined(TRY_SLICING_BALANCE)
+#endif//_WIN32
+
+  do {
+#ifdef _WIN32
+    iWaitRet = WelsMultipleEventsWaitSingleBlocking (iEventCount,
+               &pEventsList[0],
+               (uint32_t) - 1);	// blocking until at least one event is
 #else
-        WelsEventSignal (pEncPEncCtx->pSliceThreading->pSliceCodedEvent[iEventIdx]);	// mean finished coding current pSlice
+#if defined(ENABLE_TRACE_MT)
+    WelsLog (pEncPEncCtx, WELS_LOG_INFO,
+             "[MT] CodingSliceThreadProc(), try to call WelsEventWait(pReadySliceCodingEvent[%d]= 0x%p), pEncPEncCtx= 0x%p!\n",
+             iEventIdx, (void*) (pEncPEncCtx->pReadySliceCodingEvent[iEventIdx]), (void*)pEncPEncCtx);
+#endif
+    iWaitRet = WelsEventWait (pEncPEncCtx->pSliceThreading->pReadySliceCodingEvent[iEventIdx]);
+#endif//WIN32
+    if (WELS_THREAD_ERROR_WAIT_OBJECT_0 == iWaitRet) {	// start pSlice coding signal waited
+      uiThrdRet = CodingSliceJob (pPrivateData);
+      if (uiThrdRet)	// any exception??
+        break;
+
+#ifdef _WIN32
+      WelsEventSignal (&pEncPEncCtx->pSliceThreading->pSliceCodedEvent[iEventIdx]);	// mean finished coding current pSlice
+#else
+      WelsEventSignal (pEncPEncCtx->pSliceThreading->pSliceCodedEvent[iEventIdx]);	// mean finished coding current pSlice
 #endif//WIN32
-      }
     }
 #ifdef _WIN32
     else if (WELS_THREAD_ERROR_WAIT_OBJECT_0 + 1 == iWaitRet) {	// exit thread signal
@@ -1270,6 +1340,19 @@ WELS_THREAD_ROUTINE_TYPE CodingSliceThreadProc (void* arg) {
   WELS_THREAD_ROUTINE_RETURN (uiThrdRet);
 }
 
+// pool task for coding one pSlice, or one partition in dynamic slicing mode
+static void CodingSliceTaskProc (void* pArg) {
+  SSliceThreadPrivateData* pPrivateData	= (SSliceThreadPrivateData*)pArg;
+  sWelsEncCtx* pEncPEncCtx			= (sWelsEncCtx*)pPrivateData->pWelsPEncCtx;
+  const uint32_t kuiRet				= CodingSliceJob (pPrivateData);
+
+  if (kuiRet) {
+    WelsMutexLock (&pEncPEncCtx->mutexEncoderError);
+    pEncPEncCtx->iEncoderError |= kuiRet;
+    WelsMutexUnlock (&pEncPEncCtx->mutexEncoderError);
+  }
+}
+
 int32_t CreateSliceThreads (sWelsEncCtx* pCtx) {
   const int32_t kiThreadCount = pCtx->pSvcParam->iCountThreadsNum;
   int32_t iIdx = 0;
@@ -1397,6 +1480,46 @@ int32_t FiredSliceThreads (SSliceThreadPrivateData* pPriData, WELS_EVENT** pEven
   return 0;
 }
 
+int32_t FiredSliceTasks (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32_t kiTaskNum, const bool kbIsDynamicSlicingMode) {
+  SSliceThreading* pSmt			= pCtx->pSliceThreading;
+  SSliceThreadPrivateData* pPriData	= pSmt->pThreadPEncCtx;
+  SSliceCtx* pSliceCtx			= pCtx->pCurDqLayer->pSliceEncCtx;
+  int32_t iEndMbIdx	= 0;
+  int32_t iIdx		= 0;
+
+  if (NULL == pSmt->pThreadPool || pLbi == NULL || kiTaskNum <= 0
+      || kiTaskNum > WELS_MAX (pCtx->pSvcParam->iCountThreadsNum, pCtx->iMaxSliceCount)) {
+    WelsLog (pCtx, WELS_LOG_ERROR, "FiredSliceTasks(), fail due pThreadPool == %p || pLbi == %p || iTaskNum(%d) invalid!!\n",
+             (void*)pSmt->pThreadPool, (void*)pLbi, kiTaskNum);
+    return 1;
+  }
+
+  if (kbIsDynamicSlicingMode) {
+    iEndMbIdx	= pSliceCtx->iMbNumInFrame;
+    for (iIdx = kiTaskNum - 1; iIdx >= 0; --iIdx) {
+      const int32_t kiFirstMbIdx		= pSliceCtx->pFirstMbInSlice[iIdx];
+      pPriData[iIdx].iStartMbIndex	= kiFirstMbIdx;
+      pPriData[iIdx].iEndMbIndex		= iEndMbIdx;
+      iEndMbIdx						= kiFirstMbIdx;
+    }
+  }
+
+  for (iIdx = 0; iIdx < kiTaskNum; ++ iIdx) {
+#if defined(PACKING_ONE_SLICE_PER_LAYER)
+    pPriData[iIdx].pLayerBs	= pLbi + iIdx;
+#else
+    pPriData[iIdx].pLayerBs	= pLbi;
+#endif//PACKING_ONE_SLICE_PER_LAYER
+    pPriData[iIdx].iSliceIndex	= iIdx;
+    pPriData[iIdx].sTask.pProc	= CodingSliceTaskProc;
+    pPriData[iIdx].sTask.pArg	= &pPriData[iIdx];
+    pPriData[iIdx].sTask.pGroup	= &pSmt->sSliceTaskGroup;
+    WelsThreadPoolQueueTask (pSmt->pThreadPool, &pPriData[iIdx].sTask);
+  }
+
+  return 0;
+}
+
 int32_t DynamicDetectCpuCores() {
   WelsLogicalProcessInfo  info;
   WelsQueryLogicalProcessInfo (&info);
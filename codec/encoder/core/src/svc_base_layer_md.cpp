@@ -1021,6 +1021,12 @@ int32_t WelsMdP16x16 (SWelsFuncPtrList* pFunc, SDqLayer* pCurLayer, SWelsMD* pWe
   }
 
   PredMv (&pMbCache->sMvComponents, 0, 4, 0, & (sMe16x16->sMvp));
+  //half resolution motion vector predictor
+  if (NULL != pCurLayer->pCoarseRefData) {
+    WelsMotionEstimateCoarseSearch (pFunc, pCurLayer, sMe16x16, pSlice, pCurMb->iMbX, pCurMb->iMbY,
+                                    &pSlice->sMvc[pSlice->uiMvcNum]);
+    ++ pSlice->uiMvcNum;
+  }
   pFunc->pfMotionSearch (pFunc, pCurLayer, sMe16x16, pSlice);
 //	update_p16x16_motion2cache(pMbCache, pWelsMd->uiRef, &(sMe16x16->mv));
 
@@ -510,6 +510,29 @@ int32_t InitSlicePEncCtx (SSliceCtx* pSliceCtx,
   return 0;
 }
 
+/*!
+ * \brief	Restore MB map of Wels SSlice context to the partition given at initialization, buffers are kept
+ *
+ * \param	pSliceCtx		SSlice context initialized with pMso before
+ * \param	pMso			multiple slice options
+ *
+ * \return	0 - successful; none 0 - failed;
+ */
+int32_t ResetSlicePEncCtx (SSliceCtx* pSliceCtx, SSliceConfig* pMso) {
+  if (NULL == pSliceCtx || NULL == pSliceCtx->pOverallMbMap)
+    return 1;
+
+  // single slice map never changes
+  if (SM_SINGLE_SLICE == pSliceCtx->uiSliceMode)
+    return 0;
+
+  // slices counted in frame so far are dropped, dynamic slices are partitioned again for each frame
+  pSliceCtx->iSliceNumInFrame = GetInitialSliceNum (pSliceCtx->iMbWidth, pSliceCtx->iMbHeight, pMso);
+  if (SM_DYN_SLICE == pSliceCtx->uiSliceMode)
+    return 0;
+  return AssignMbMapMultipleSlices (pSliceCtx, pMso);
+}
+
 /*!
  * \brief	Uninitialize Wels SSlice context (Single/multiple slices and FMO)
  *
@@ -287,6 +287,7 @@ void    WelsEncRecUV (SWelsFuncPtrList* pFuncList, SMB* pCurMb, SMbCache* pMbCac
 
   if (iSingleCtr8x8 < 7) {	//from JVT-O079
     pfSetMemZeroSize64 (pRes, 128);	// confirmed_safe_unsafe_usage
+    pfSetMemZeroSize64 (pBlock - 64, 128);	// AC of the other chroma component may still be coded
     ST16 (&pCurMb->pNonZeroCount[16 + uiNoneZeroCountOffset], 0);
     ST16 (&pCurMb->pNonZeroCount[20 + uiNoneZeroCountOffset], 0);
   } else {
@@ -44,8 +44,11 @@
 #include "svc_base_layer_md.h"
 #include "svc_encode_mb.h"
 #include "svc_set_mb_syn_cavlc.h"
+#include "svc_set_mb_syn_cabac.h"
 #include "decode_mb_aux.h"
 #include "svc_mode_decision.h"
+#include "mb_row_multi_threading.h"
+#include "deblocking.h"
 
 namespace WelsSVCEnc {
 //#define ENC_TRACE
@@ -54,6 +57,12 @@ typedef int32_t (*PWelsCodingSliceFunc) (sWelsEncCtx* pCtx, SSlice* pSlice);
 typedef void (*PWelsSliceHeaderWriteFunc) (SBitStringAux* pBs, SDqLayer* pCurLayer, SSlice* pSlice,
     int32_t* pPpsIdDelta);
 
+// the last MB of a row completes it for the deblocking and border expansion following the MB coding
+static inline void PerformRowPipelineOnMbCoded (sWelsEncCtx* pEncCtx, SDqLayer* pCurLayer, const SMB* kpCurMb) {
+  if ((pCurLayer->bDeblockingRowFlag || pCurLayer->bExpandingRowFlag) && kpCurMb->iMbX + 1 == pCurLayer->iMbWidth)
+    PerformDeblockingFilterRows (pEncCtx, kpCurMb->iMbY + 1);
+}
+
 void UpdateNonZeroCountCache (SMB* pMb, SMbCache* pMbCache) {
   ST32 (&pMbCache->iNonZeroCoeffCount[9], LD32 (&pMb->pNonZeroCount[ 0]));
   ST32 (&pMbCache->iNonZeroCoeffCount[17], LD32 (&pMb->pNonZeroCount[ 4]));
@@ -115,6 +124,7 @@ void WelsSliceHeaderExtInit (sWelsEncCtx* pEncCtx, SDqLayer* pCurLayer, SSlice*
   }
 
   pCurSliceHeader->iSliceQpDelta = pEncCtx->iGlobalQp - pCurLayer->sLayerInfo.pPpsP->iPicInitQp;
+  pCurSliceHeader->uiCabacInitIdc = 0;
 
   //for deblocking initial
   pCurSliceHeader->uiDisableDeblockingFilterIdc			= pCurLayer->iLoopFilterDisableIdc;
@@ -270,6 +280,10 @@ void WelsSliceHeaderWrite (SBitStringAux* pBs, SDqLayer* pCurLayer, SSlice* pSli
     WriteRefPicMarking (pBs, pSliceHeader, pNalHead);
   }
 
+  if (pPps->bEntropyCodingModeFlag && P_SLICE == pSliceHeader->eSliceType) {
+    BsWriteUE (pBs, pSliceHeader->uiCabacInitIdc);
+  }
+
   BsWriteSE (pBs, pSliceHeader->iSliceQpDelta);       /* pSlice qp delta */
 
   if (pPps->bDeblockingFilterControlPresentFlag) {
@@ -338,6 +352,10 @@ void WelsSliceHeaderExtWrite (SBitStringAux* pBs, SDqLayer* pCurLayer, SSlice* p
   }
 //	}
 
+  if (pPps->bEntropyCodingModeFlag && P_SLICE == pSliceHeader->eSliceType) {
+    BsWriteUE (pBs, pSliceHeader->uiCabacInitIdc);
+  }
+
   BsWriteSE (pBs, pSliceHeader->iSliceQpDelta);       /* pSlice qp delta */
 
   if (pPps->bDeblockingFilterControlPresentFlag) {
@@ -495,7 +513,7 @@ int32_t WelsISliceMdEnc (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd + encodin
     WelsMdIntraMb (pEncCtx, &sMd, pCurMb, pMbCache);
     UpdateNonZeroCountCache (pCurMb, pMbCache);
 
-    iEncReturn = WelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
+    iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
     if (ENC_RETURN_SUCCESS != iEncReturn)
       return iEncReturn;
 
@@ -506,6 +524,7 @@ int32_t WelsISliceMdEnc (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd + encodin
 #endif//MB_TYPES_CHECK
 
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, sMd.iCostLuma, pSlice);
+    PerformRowPipelineOnMbCoded (pEncCtx, pCurLayer, pCurMb);
 
     ++iNumMbCoded;
 
@@ -559,11 +578,9 @@ int32_t WelsISliceMdEncDynamic (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd +
     WelsMdIntraMb (pEncCtx, &sMd, pCurMb, pMbCache);
     UpdateNonZeroCountCache (pCurMb, pMbCache);
     //stack pBs pointer
-    sDss.pBsStackBufPtr	= pBs->pBufPtr;
-    sDss.uiBsStackCurBits	= pBs->uiCurBits;
-    sDss.iBsStackLeftBits	= pBs->iLeftBits;
+    pEncCtx->pFuncList->pfStashMBStatus (&sDss, pSlice);
 
-    iEncReturn = WelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
+    iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
     if (ENC_RETURN_SUCCESS != iEncReturn)
       return iEncReturn;
 
@@ -571,9 +588,7 @@ int32_t WelsISliceMdEncDynamic (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd +
 
     if (DynSlcJudgeSliceBoundaryStepBack (pEncCtx, pSlice, pSliceCtx, pCurMb, &sDss)) { //islice
       //stack pBs pointer
-      pBs->pBufPtr		= sDss.pBsStackBufPtr;
-      pBs->uiCurBits	= sDss.uiBsStackCurBits;
-      pBs->iLeftBits	= sDss.iBsStackLeftBits;
+      pEncCtx->pFuncList->pfStashPopMBStatus (&sDss, pSlice);
 
       pCurLayer->pLastCodedMbIdxOfPartition[kiPartitionId] = iCurMbIdx -
           1;	// update pLastCodedMbIdxOfPartition, need to -1 due to stepping back
@@ -590,6 +605,7 @@ int32_t WelsISliceMdEncDynamic (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd +
 #endif//MB_TYPES_CHECK
 
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, sMd.iCostLuma, pSlice);
+    PerformRowPipelineOnMbCoded (pEncCtx, pCurLayer, pCurMb);
 
     ++iNumMbCoded;
 
@@ -695,6 +711,7 @@ int32_t WelsCodeOneSlice (sWelsEncCtx* pEncCtx, const int32_t kiSliceIdx, const
   SBitStringAux* pBs					= pCurSlice->pSliceBsa;
   const int32_t kiDynamicSliceFlag	= (pEncCtx->pSvcParam->sDependencyLayers[pEncCtx->uiDependencyId].sSliceCfg.uiSliceMode ==
                                        SM_DYN_SLICE);
+  const bool kbEntropyCodingModeFlag	= pCurLayer->sLayerInfo.pPpsP->bEntropyCodingModeFlag;
 
   assert (kiSliceIdx == pCurSlice->uiSliceIdx);
 
@@ -724,14 +741,31 @@ int32_t WelsCodeOneSlice (sWelsEncCtx* pEncCtx, const int32_t kiSliceIdx, const
 #endif
 
   pCurSlice->uiLastMbQp = pCurLayer->sLayerInfo.pPpsP->iPicInitQp + pCurSlice->sSliceHeaderExt.sSliceHeader.iSliceQpDelta;
+  pCurSlice->iMbSkipRun = 0;
+  if (kbEntropyCodingModeFlag)
+    WelsInitSliceCabac (pEncCtx, pCurSlice);
 
-  int32_t iEncReturn = g_pWelsSliceCoding[pNalHeadExt->bIdrFlag][kiDynamicSliceFlag] (pEncCtx, pCurSlice);
+  int32_t iEncReturn = ENC_RETURN_SUCCESS;
+#if defined(MT_ENABLED)
+  if (NULL != pEncCtx->pMbRowThreading && !kiDynamicSliceFlag
+      && SM_SINGLE_SLICE == pEncCtx->pSvcParam->sDependencyLayers[pEncCtx->uiDependencyId].sSliceCfg.uiSliceMode)
+    iEncReturn = WelsCodeSliceMbRows (pEncCtx, pCurSlice);
+  else
+#endif//MT_ENABLED
+    iEncReturn = g_pWelsSliceCoding[pNalHeadExt->bIdrFlag][kiDynamicSliceFlag] (pEncCtx, pCurSlice);
   if (ENC_RETURN_SUCCESS != iEncReturn)
     return iEncReturn;
 
-  BsRbspTrailingBits (pBs);
+  if (kbEntropyCodingModeFlag) {
+    WelsWriteSliceEndSynCabac (pCurSlice);
+  } else {
+    if (pCurSlice->iMbSkipRun)
+      BsWriteUE (pBs, pCurSlice->iMbSkipRun);
+
+    BsRbspTrailingBits (pBs);
 
-  BsFlush (pBs);
+    BsFlush (pBs);
+  }
 
   return ENC_RETURN_SUCCESS;
 }
@@ -921,7 +955,6 @@ bool DynSlcJudgeSliceBoundaryStepBack (void* pCtx, void* pSlice, SSliceCtx* pSli
 // for inter non-dynamic pSlice
 int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd, const int32_t kiSliceFirstMbXY) {
   SWelsMD* pMd					= (SWelsMD*)pWelsMd;
-  SBitStringAux* pBs			= pSlice->pSliceBsa;
   SDqLayer* pCurLayer			= pEncCtx->pCurDqLayer;
   SSliceCtx* pSliceCtx	= pCurLayer->pSliceEncCtx;
   SMbCache* pMbCache			= &pSlice->sMbCacheInfo;
@@ -930,13 +963,12 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
   int32_t iNumMbCoded		= 0;
   int32_t	iNextMbIdx			= kiSliceFirstMbXY;
   int32_t	iCurMbIdx			= -1;
-  int32_t	iMbSkipRun			= 0;
   const int32_t kiTotalNumMb	= pCurLayer->iMbWidth * pCurLayer->iMbHeight;
   const int32_t kiMvdInterTableSize	= (pEncCtx->pSvcParam->iSpatialLayerNum == 1 ? 648 : 972);
   const int32_t kiMvdInterTableStride = 1 + (kiMvdInterTableSize << 1);
-  uint16_t* pMvdCostTableInter		= &pEncCtx->pMvdCostTableInter[kiMvdInterTableSize];
+  uint16_t* pMvdCostTableInter		= &(pCurLayer->sLayerInfo.pPpsP->bEntropyCodingModeFlag ?
+                                      pEncCtx->pMvdCostTableInterCabac : pEncCtx->pMvdCostTableInter)[kiMvdInterTableSize];
   const int32_t kiSliceIdx				= pSlice->uiSliceIdx;
-  const uint8_t kuiChromaQpIndexOffset = pCurLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset;
   int32_t iEncReturn = ENC_RETURN_SUCCESS;
 
   for (;;) {
@@ -965,18 +997,9 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
     UpdateNonZeroCountCache (pCurMb, pMbCache);
 
     //step (6): begin to write bit stream; if the pSlice size is controlled, the writing may be skipped
-    if (IS_SKIP (pCurMb->uiMbType)) {
-      pCurMb->uiLumaQp	= pSlice->uiLastMbQp;
-      pCurMb->uiChromaQp = g_kuiChromaQpTable[CLIP3_QP_0_51 (pCurMb->uiLumaQp + kuiChromaQpIndexOffset)];
-
-      iMbSkipRun++;
-    } else {
-      BsWriteUE (pBs, iMbSkipRun);
-      iMbSkipRun = 0;
-      iEncReturn = WelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
-      if (ENC_RETURN_SUCCESS != iEncReturn)
-        return iEncReturn;
-    }
+    iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
+    if (ENC_RETURN_SUCCESS != iEncReturn)
+      return iEncReturn;
 
     //step (7): reconstruct current MB
     pCurMb->uiSliceIdc = kiSliceIdx;
@@ -988,6 +1011,7 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
 
     //step (8): update status and other parameters
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, pMd->iCostLuma, pSlice);
+    PerformRowPipelineOnMbCoded (pEncCtx, pCurLayer, pCurMb);
 
     /*judge if all pMb in cur pSlice has been encoded*/
     ++ iNumMbCoded;
@@ -998,10 +1022,6 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
     }
   }
 
-  if (iMbSkipRun) {
-    BsWriteUE (pBs, iMbSkipRun);
-  }
-
   return iEncReturn;
 }
 
@@ -1019,10 +1039,10 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
   const int32_t kiTotalNumMb	= pCurLayer->iMbWidth * pCurLayer->iMbHeight;
   int32_t	iNextMbIdx			= kiSliceFirstMbXY;
   int32_t	iCurMbIdx			= -1;
-  int32_t	iMbSkipRun			= 0;
   const int32_t kiMvdInterTableSize	= (pEncCtx->pSvcParam->iSpatialLayerNum == 1 ? 648 : 972);
   const int32_t kiMvdInterTableStride = 1 + (kiMvdInterTableSize << 1);
-  uint16_t* pMvdCostTableInter		= &pEncCtx->pMvdCostTableInter[kiMvdInterTableSize];
+  uint16_t* pMvdCostTableInter		= &(pCurLayer->sLayerInfo.pPpsP->bEntropyCodingModeFlag ?
+                                      pEncCtx->pMvdCostTableInterCabac : pEncCtx->pMvdCostTableInter)[kiMvdInterTableSize];
   const int32_t kiSliceIdx				= pSlice->uiSliceIdx;
   const int32_t kiPartitionId			= (kiSliceIdx % pEncCtx->iActiveThreadsNum);
   const uint8_t kuiChromaQpIndexOffset = pCurLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset;
@@ -1067,36 +1087,19 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
     //step (6): begin to write bit stream; if the pSlice size is controlled, the writing may be skipped
 
     //DYNAMIC_SLICING_ONE_THREAD - MultiD
-    //stack pBs pointer
-    sDss.pBsStackBufPtr	= pBs->pBufPtr;
-    sDss.uiBsStackCurBits	= pBs->uiCurBits;
-    sDss.iBsStackLeftBits	= pBs->iLeftBits;
-    //stack Pskip status
-    sDss.iMbSkipRunStack = iMbSkipRun;
+    //stack pBs pointer and Pskip status
+    pEncCtx->pFuncList->pfStashMBStatus (&sDss, pSlice);
     //DYNAMIC_SLICING_ONE_THREAD - MultiD
 
-    if (IS_SKIP (pCurMb->uiMbType)) {
-      pCurMb->uiLumaQp	= pSlice->uiLastMbQp;
-      pCurMb->uiChromaQp = g_kuiChromaQpTable[CLIP3_QP_0_51 (pCurMb->uiLumaQp + kuiChromaQpIndexOffset)];
-
-      iMbSkipRun++;
-    } else {
-      BsWriteUE (pBs, iMbSkipRun);
-      iMbSkipRun = 0;
-      iEncReturn = WelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
-      if (ENC_RETURN_SUCCESS != iEncReturn)
-        return iEncReturn;
-    }
+    iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
+    if (ENC_RETURN_SUCCESS != iEncReturn)
+      return iEncReturn;
 
     //DYNAMIC_SLICING_ONE_THREAD - MultiD
     sDss.iCurrentPos = BsGetBitsPos (pBs);
     if (DynSlcJudgeSliceBoundaryStepBack (pEncCtx, pSlice, pSliceCtx, pCurMb, &sDss)) {
-      //stack pBs pointer
-      pBs->pBufPtr		= sDss.pBsStackBufPtr;
-      pBs->uiCurBits	= sDss.uiBsStackCurBits;
-      pBs->iLeftBits	= sDss.iBsStackLeftBits;
-
-      iMbSkipRun = sDss.iMbSkipRunStack;
+      //stack pBs pointer and Pskip status
+      pEncCtx->pFuncList->pfStashPopMBStatus (&sDss, pSlice);
 
       pCurLayer->pLastCodedMbIdxOfPartition[kiPartitionId] = iCurMbIdx -
           1;	// update pLastCodedMbIdxOfPartition, need to -1 due to stepping back
@@ -1115,6 +1118,7 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
 
     //step (8): update status and other parameters
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, pMd->iCostLuma, pSlice);
+    PerformRowPipelineOnMbCoded (pEncCtx, pCurLayer, pCurMb);
 
     /*judge if all pMb in cur pSlice has been encoded*/
     ++ iNumMbCoded;
@@ -1127,10 +1131,6 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
     }
   }
 
-  if (iMbSkipRun) {
-    BsWriteUE (pBs, iMbSkipRun);
-  }
-
   return iEncReturn;
 }
 
@@ -41,6 +41,7 @@
 
 
 #include "svc_motion_estimate.h"
+#include "sample.h"
 
 namespace WelsSVCEnc {
 /*!
@@ -151,7 +152,7 @@ void WelsMotionEstimateInitialPoint (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
     pMe->uiSatdCost = iBestSadCost;
   } else {
     //  Step 3: Fast search pattern
-    WelsMotionEstimateIterativeSearch (pFuncList, pMe, iStrideEnc, iStrideRef, pRefMb);
+    pFuncList->pfSearchMethod (pFuncList, pMe, pSlice, iStrideEnc, iStrideRef, pRefMb);
   }
 }
 
@@ -231,4 +232,228 @@ void WelsMotionEstimateIterativeSearch (SWelsFuncPtrList* pFuncList, SWelsME* pM
   pMe->pRefMb = pRefMb;
 }
 
+void WelsMotionEstimateDiamondSearch (SWelsFuncPtrList* pFuncList, void* pLpme, void* pLpslice, const int32_t kiStrideEnc,
+                                      const int32_t kiStrideRef, uint8_t* pRef) {
+  WelsMotionEstimateIterativeSearch (pFuncList, (SWelsME*)pLpme, kiStrideEnc, kiStrideRef, pRef);
+}
+
+/*
+ *	integer pel search state shared by hexagon and UMH patterns, positions are full pel relative to the co-located block
+ */
+typedef struct TagMeSearchState {
+  PSampleSadSatdCostFunc	pSad;
+  uint8_t*					pEncMb;
+  uint8_t*					pColocatedRefMb;
+  int32_t					iStrideEnc;
+  int32_t					iStrideRef;
+  const uint16_t*			pMvdCost;
+  SMVUnitXY					sMvp;
+  SMVUnitXY					sMvMin;
+  SMVUnitXY					sMvMax;
+  int32_t					iBestX;
+  int32_t					iBestY;
+  int32_t					iBestCost;
+} SMeSearchState;
+
+// SAD per pixel below which the block is taken as static and not searched further
+#define ME_STATIC_SAD_PER_PIXEL	(1)
+static const uint8_t g_kuiMePixelNumShift[MAX_BLOCK_TYPE] = {8, 7, 7, 6, 4};
+
+static inline void MeTestPoint (SMeSearchState* pState, const int32_t kiX, const int32_t kiY) {
+  int32_t iCost;
+  if (kiX < pState->sMvMin.iMvX || kiX > pState->sMvMax.iMvX || kiY < pState->sMvMin.iMvY || kiY > pState->sMvMax.iMvY)
+    return;
+  iCost = COST_MVD (pState->pMvdCost, (kiX << 2) - pState->sMvp.iMvX, (kiY << 2) - pState->sMvp.iMvY);
+  if (iCost >= pState->iBestCost)
+    return;
+  iCost += pState->pSad (pState->pEncMb, pState->iStrideEnc, pState->pColocatedRefMb + kiY * pState->iStrideRef + kiX,
+                         pState->iStrideRef);
+  if (iCost < pState->iBestCost) {
+    pState->iBestCost	= iCost;
+    pState->iBestX		= kiX;
+    pState->iBestY		= kiY;
+  }
+}
+
+static inline void MeInitSearchState (SMeSearchState* pState, SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice,
+                                      const int32_t kiStrideEnc, const int32_t kiStrideRef, uint8_t* pRef) {
+  pState->pSad			= pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiPixel];
+  pState->pEncMb		= pMe->pEncMb;
+  pState->pColocatedRefMb	= pRef - pMe->sMv.iMvY * kiStrideRef - pMe->sMv.iMvX;
+  pState->iStrideEnc	= kiStrideEnc;
+  pState->iStrideRef	= kiStrideRef;
+  pState->pMvdCost		= pMe->pMvdCost;
+  pState->sMvp			= pMe->sMvp;
+  pState->sMvMin		= pSlice->sMvMin;
+  pState->sMvMax		= pSlice->sMvMax;
+  pState->iBestX		= pMe->sMv.iMvX;
+  pState->iBestY		= pMe->sMv.iMvY;
+  pState->iBestCost		= pMe->uiSadCost;
+}
+
+static inline void MeStoreSearchState (SMeSearchState* pState, SWelsME* pMe) {
+  /* -> qpel mv */
+  pMe->sMv.iMvX	= pState->iBestX << 2;
+  pMe->sMv.iMvY	= pState->iBestY << 2;
+  pMe->uiSatdCost = pMe->uiSadCost = pState->iBestCost;
+  pMe->pRefMb		= pState->pColocatedRefMb + pState->iBestY * pState->iStrideRef + pState->iBestX;
+}
+
+static inline bool MeIsStaticBlock (SMeSearchState* pState, const uint8_t kuiPixel) {
+  return pState->iBestCost < (ME_STATIC_SAD_PER_PIXEL << g_kuiMePixelNumShift[kuiPixel]);
+}
+
+static void MeHexagonRefine (SMeSearchState* pState) {
+  static const int8_t kiHexagon[6][2] = {{ -2, 0}, { -1, -2}, {1, -2}, {2, 0}, {1, 2}, { -1, 2}};
+  static const int8_t kiDiamond[4][2] = {{0, -1}, {0, 1}, { -1, 0}, {1, 0}};
+  int32_t iTimeThreshold = ITERATIVE_TIMES;
+  int32_t iCenterX, iCenterY;
+  int32_t i;
+
+  // large hexagon moves until the center is the best, small diamond refines it
+  do {
+    iCenterX = pState->iBestX;
+    iCenterY = pState->iBestY;
+    for (i = 0; i < 6; i++)
+      MeTestPoint (pState, iCenterX + kiHexagon[i][0], iCenterY + kiHexagon[i][1]);
+  } while (--iTimeThreshold && (iCenterX != pState->iBestX || iCenterY != pState->iBestY));
+
+  iCenterX = pState->iBestX;
+  iCenterY = pState->iBestY;
+  for (i = 0; i < 4; i++)
+    MeTestPoint (pState, iCenterX + kiDiamond[i][0], iCenterY + kiDiamond[i][1]);
+}
+
+void WelsMotionEstimateHexagonSearch (SWelsFuncPtrList* pFuncList, void* pLpme, void* pLpslice, const int32_t kiStrideEnc,
+                                      const int32_t kiStrideRef, uint8_t* pRef) {
+  SWelsME* pMe = (SWelsME*)pLpme;
+  SMeSearchState sState;
+
+  MeInitSearchState (&sState, pFuncList, pMe, (SSlice*)pLpslice, kiStrideEnc, kiStrideRef, pRef);
+  if (!MeIsStaticBlock (&sState, pMe->uiPixel))
+    MeHexagonRefine (&sState);
+  MeStoreSearchState (&sState, pMe);
+}
+
+void WelsMotionEstimateUmhSearch (SWelsFuncPtrList* pFuncList, void* pLpme, void* pLpslice, const int32_t kiStrideEnc,
+                                  const int32_t kiStrideRef, uint8_t* pRef) {
+  static const int8_t kiMultiHexagon[16][2] = {
+    { -4, -2}, { -4, -1}, { -4, 0}, { -4, 1}, { -4, 2}, {4, -2}, {4, -1}, {4, 0},
+    {4, 1}, {4, 2}, { -2, 3}, {0, 4}, {2, 3}, { -2, -3}, {0, -4}, {2, -3}
+  };
+  SWelsME* pMe = (SWelsME*)pLpme;
+  SMeSearchState sState;
+  int32_t iCenterX, iCenterY;
+  int32_t i, j;
+
+  MeInitSearchState (&sState, pFuncList, pMe, (SSlice*)pLpslice, kiStrideEnc, kiStrideRef, pRef);
+  if (MeIsStaticBlock (&sState, pMe->uiPixel)) {
+    MeStoreSearchState (&sState, pMe);
+    return;
+  }
+
+  //  unsymmetrical cross, horizontal motion dominates in natural video
+  iCenterX = sState.iBestX;
+  iCenterY = sState.iBestY;
+  for (i = 2; i <= ME_UMH_RANGE; i += 2) {
+    MeTestPoint (&sState, iCenterX - i, iCenterY);
+    MeTestPoint (&sState, iCenterX + i, iCenterY);
+  }
+  for (i = 2; i <= (ME_UMH_RANGE >> 1); i += 2) {
+    MeTestPoint (&sState, iCenterX, iCenterY - i);
+    MeTestPoint (&sState, iCenterX, iCenterY + i);
+  }
+
+  //  multi-hexagon grid of growing radius
+  if (!MeIsStaticBlock (&sState, pMe->uiPixel)) {
+    iCenterX = sState.iBestX;
+    iCenterY = sState.iBestY;
+    for (j = 1; j <= (ME_UMH_RANGE >> 2); j++) {
+      for (i = 0; i < 16; i++)
+        MeTestPoint (&sState, iCenterX + kiMultiHexagon[i][0] * j, iCenterY + kiMultiHexagon[i][1] * j);
+    }
+  }
+
+  MeHexagonRefine (&sState);
+  MeStoreSearchState (&sState, pMe);
+}
+
+void WelsInitMeFunc (SWelsFuncPtrList* pFuncList, const ME_SEARCH_PRESET keSearchPreset) {
+  switch (keSearchPreset) {
+  case ME_PRESET_MEDIUM:
+    pFuncList->pfSearchMethod = WelsMotionEstimateHexagonSearch;
+    break;
+  case ME_PRESET_SLOW:
+    pFuncList->pfSearchMethod = WelsMotionEstimateUmhSearch;
+    break;
+  case ME_PRESET_FAST:
+  default:
+    pFuncList->pfSearchMethod = WelsMotionEstimateDiamondSearch;
+    break;
+  }
+}
+
+static void MeDownsampleHalf (uint8_t* pDst, const int32_t kiDstStride, uint8_t* pSrc, const int32_t kiSrcStride,
+                              const int32_t kiDstWidth, const int32_t kiDstHeight) {
+  int32_t i, j;
+  for (j = 0; j < kiDstHeight; j++) {
+    uint8_t* pSrcLine0 = pSrc + (j << 1) * kiSrcStride;
+    uint8_t* pSrcLine1 = pSrcLine0 + kiSrcStride;
+    for (i = 0; i < kiDstWidth; i++) {
+      pDst[i] = (pSrcLine0[i << 1] + pSrcLine0[ (i << 1) + 1] + pSrcLine1[i << 1] + pSrcLine1[ (i << 1) + 1] + 2) >> 2;
+    }
+    pDst += kiDstStride;
+  }
+}
+
+void WelsMeDownsamplePlanes (SDqLayer* pCurDqLayer) {
+  SPicture* pRefPic			= pCurDqLayer->pRefPic;
+  const int32_t kiStride		= pCurDqLayer->iCoarseStride;
+  const int32_t kiWidth		= pCurDqLayer->iMbWidth << 3;
+  const int32_t kiHeight		= pCurDqLayer->iMbHeight << 3;
+  const int32_t kiRefStride	= pRefPic->iLineSize[0];
+
+  MeDownsampleHalf (pCurDqLayer->pCoarseEncData, kiStride, pCurDqLayer->pEncData[0], pCurDqLayer->iEncStride[0],
+                    kiWidth, kiHeight);
+  // padding of reference is downsampled too so that the search window may cross picture boundaries
+  MeDownsampleHalf (pCurDqLayer->pCoarseRefData - (PADDING_LENGTH >> 1) * (kiStride + 1), kiStride,
+                    pRefPic->pData[0] - PADDING_LENGTH * (kiRefStride + 1), kiRefStride,
+                    kiWidth + PADDING_LENGTH, kiHeight + PADDING_LENGTH);
+}
+
+void WelsMotionEstimateCoarseSearch (SWelsFuncPtrList* pFuncList, SDqLayer* pCurDqLayer, SWelsME* pMe, SSlice* pSlice,
+                                     const int32_t kiMbX, const int32_t kiMbY, SMVUnitXY* pMv) {
+  PSampleSadSatdCostFunc pSad	= pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x8];
+  const int32_t kiStride		= pCurDqLayer->iCoarseStride;
+  const int32_t kiOffset		= (kiMbY * kiStride + kiMbX) << 3;
+  uint8_t* pEnc					= pCurDqLayer->pCoarseEncData + kiOffset;
+  uint8_t* pRef					= pCurDqLayer->pCoarseRefData + kiOffset;
+  const uint16_t* kpMvdCost		= pMe->pMvdCost;
+  const SMVUnitXY ksMvp			= pMe->sMvp;
+  // half resolution range rounded towards zero keeps the full resolution vector within sMvMin and sMvMax
+  const int32_t kiMinX			= WELS_MAX (-ME_COARSE_RANGE, pSlice->sMvMin.iMvX / 2);
+  const int32_t kiMaxX			= WELS_MIN (ME_COARSE_RANGE, pSlice->sMvMax.iMvX / 2);
+  const int32_t kiMinY			= WELS_MAX (-ME_COARSE_RANGE, pSlice->sMvMin.iMvY / 2);
+  const int32_t kiMaxY			= WELS_MIN (ME_COARSE_RANGE, pSlice->sMvMax.iMvY / 2);
+  int32_t iBestCost				= INT_MAX;
+  int32_t iBestX = 0, iBestY = 0;
+  int32_t iX, iY;
+
+  for (iY = kiMinY; iY <= kiMaxY; iY++) {
+    for (iX = kiMinX; iX <= kiMaxX; iX++) {
+      // mvd cost in full resolution units weights a half resolution SAD of a quarter of the pixels
+      const int32_t kiCost = (pSad (pEnc, kiStride, pRef + iY * kiStride + iX, kiStride) << 2) +
+                             COST_MVD (kpMvdCost, (iX << 3) - ksMvp.iMvX, (iY << 3) - ksMvp.iMvY);
+      if (kiCost < iBestCost) {
+        iBestCost	= kiCost;
+        iBestX		= iX;
+        iBestY		= iY;
+      }
+    }
+  }
+
+  pMv->iMvX = iBestX << 3;
+  pMv->iMvY = iBestY << 3;
+}
+
 } // namespace WelsSVCEnc
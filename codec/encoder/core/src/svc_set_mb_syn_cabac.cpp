@@ -0,0 +1,489 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file	svc_set_mb_syn_cabac.cpp
+ *
+ * \brief	Seting all syntax elements of mb and encoding residual with cabac
+ *
+ * \date	10/18/2014 Created
+ *
+ *************************************************************************************
+ */
+
+#include "ls_defines.h"
+#include "svc_enc_golomb.h"
+#include "svc_set_mb_syn_cavlc.h"
+#include "svc_set_mb_syn_cabac.h"
+
+namespace WelsSVCEnc {
+
+/* SMB::uiCbfDc, coded_block_flag of DC blocks kept for the context of the neighbouring MBs */
+#define CBF_DC_LUMA		0x01
+#define CBF_DC_CB		0x02
+#define CBF_DC_CR		0x04
+
+// ctxIdxInc of the bins after the first one of I macroblock types, Table 9-39: in I slice; in P slice as suffix
+static const int8_t g_kiIntraMbTypeCtxInc[2][5] = {
+  { 3, 4, 5, 6, 7 },	// luma cbp, chroma cbp != 0, chroma cbp == 2, two bins of prediction mode
+  { 1, 2, 2, 3, 3 }
+};
+
+void WelsInitSliceCabac (sWelsEncCtx* pEncCtx, SSlice* pSlice) {
+  SBitStringAux* pBs			= pSlice->pSliceBsa;
+  const SSliceHeader* kpSh		= &pSlice->sSliceHeaderExt.sSliceHeader;
+  const int32_t kiModel			= (I_SLICE == kpSh->eSliceType) ? WELS_CABAC_MODEL_I : kpSh->uiCabacInitIdc;
+  const int32_t kiSliceQp		= pEncCtx->pCurDqLayer->sLayerInfo.pPpsP->iPicInitQp + kpSh->iSliceQpDelta;
+
+  /* cabac_alignment_one_bit */
+  if (!BsCheckByteAlign (pBs))
+    BsWriteBits (pBs, pBs->iLeftBits & 7, (1 << (pBs->iLeftBits & 7)) - 1);
+  BsFlush (pBs);
+
+  WelsCabacContextInit (&pSlice->sCabacCtx, kiModel, kiSliceQp);
+  WelsCabacEncodeInit (&pSlice->sCabacCtx, pBs->pBufPtr, pBs->pBufEnd);
+  pSlice->iLastDeltaQp = 0;
+}
+
+void WelsWriteSliceEndSynCabac (SSlice* pSlice) {
+  WelsCabacEncodeFlush (&pSlice->sCabacCtx);
+  pSlice->pSliceBsa->pBufPtr = pSlice->sCabacCtx.pBufCur;
+}
+
+void StashMBStatusCabac (SDynamicSlicingStack* pDss, SSlice* pSlice) {
+  SBitStringAux* pBs = pSlice->pSliceBsa;
+
+  pDss->pBsStackBufPtr		= pBs->pBufPtr;
+  pDss->uiBsStackCurBits	= pBs->uiCurBits;
+  pDss->iBsStackLeftBits	= pBs->iLeftBits;
+
+  memcpy (&pDss->sStoredCabac, &pSlice->sCabacCtx, sizeof (SCabacCtx));
+  // a carry of the coming MB may change the last byte written already
+  pDss->uiLastByte = pSlice->sCabacCtx.pBufCur[-1];
+}
+
+void StashPopMBStatusCabac (SDynamicSlicingStack* pDss, SSlice* pSlice) {
+  SBitStringAux* pBs = pSlice->pSliceBsa;
+
+  pBs->pBufPtr		= pDss->pBsStackBufPtr;
+  pBs->uiCurBits	= pDss->uiBsStackCurBits;
+  pBs->iLeftBits	= pDss->iBsStackLeftBits;
+
+  memcpy (&pSlice->sCabacCtx, &pDss->sStoredCabac, sizeof (SCabacCtx));
+  pSlice->sCabacCtx.pBufCur[-1] = pDss->uiLastByte;
+}
+
+static void WelsCabacMbType (SCabacCtx* pCbCtx, SMB* pCurMb, SMbCache* pMbCache, const SMB* kpLeftMb,
+                             const SMB* kpTopMb, const bool kbIntraSlice) {
+  const Mb_Type kuiMbType = pCurMb->uiMbType;
+
+  if (IS_INTRA (kuiMbType)) {
+    const int8_t* kpCtxInc	= g_kiIntraMbTypeCtxInc[!kbIntraSlice];
+    int32_t iCtx			= CTX_OFFSET_MB_TYPE_P_SUFFIX;
+
+    if (kbIntraSlice) {
+      iCtx = CTX_OFFSET_MB_TYPE_I + (kpLeftMb != NULL && !IS_INTRA4x4 (kpLeftMb->uiMbType))
+             + (kpTopMb != NULL && !IS_INTRA4x4 (kpTopMb->uiMbType));
+    } else {
+      WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_MB_TYPE_P, 1);	// prefix of intra MB in P slice
+    }
+
+    if (IS_INTRA4x4 (kuiMbType)) {
+      WelsCabacEncodeDecision (pCbCtx, iCtx, 0);
+    } else {
+      const int32_t kiCtxOffset	= kbIntraSlice ? CTX_OFFSET_MB_TYPE_I : CTX_OFFSET_MB_TYPE_P_SUFFIX;
+      const int32_t kiCbpChroma	= pCurMb->uiCbp >> 4;
+      const int32_t kiPredMode	= g_kiMapModeI16x16[pMbCache->uiLumaI16x16Mode];
+
+      WelsCabacEncodeDecision (pCbCtx, iCtx, 1);
+      WelsCabacEncodeTerminate (pCbCtx);	// not I_PCM
+      WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + kpCtxInc[0], (pCurMb->uiCbp & 0x0F) != 0);
+      WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + kpCtxInc[1], kiCbpChroma != 0);
+      if (kiCbpChroma)
+        WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + kpCtxInc[2], kiCbpChroma == 2);
+      WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + kpCtxInc[3], kiPredMode >> 1);
+      WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + kpCtxInc[4], kiPredMode & 1);
+    }
+    return;
+  }
+
+  /* P_L0_16x16: 000, P_L0_L0_16x8: 011, P_L0_L0_8x16: 010, P_8x8: 001 */
+  WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_MB_TYPE_P, 0);
+  if (MB_TYPE_16x8 == kuiMbType || MB_TYPE_8x16 == kuiMbType) {
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_MB_TYPE_P + 1, 1);
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_MB_TYPE_P + 3, MB_TYPE_16x8 == kuiMbType);
+  } else {
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_MB_TYPE_P + 1, 0);
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_MB_TYPE_P + 2, MB_TYPE_16x16 != kuiMbType);
+  }
+}
+
+static void WelsCabacMbIntraPred (SCabacCtx* pCbCtx, SMB* pCurMb, SMbCache* pMbCache, const SMB* kpLeftMb,
+                                  const SMB* kpTopMb) {
+  const int32_t kiChromaMode = g_kiMapModeIntraChroma[pMbCache->uiChmaI8x8Mode];
+  int32_t i;
+
+  if (IS_INTRA4x4 (pCurMb->uiMbType)) {
+    for (i = 0; i < 16; i++) {
+      const bool kbPredFlag = pMbCache->pPrevIntra4x4PredModeFlag[i];
+
+      WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_PREV_INTRA_PRED_FLAG, kbPredFlag);
+      if (!kbPredFlag) {
+        const int32_t kiRemMode = pMbCache->pRemIntra4x4PredModeFlag[i];
+        WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_REM_INTRA_PRED_MODE, kiRemMode & 1);
+        WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_REM_INTRA_PRED_MODE, (kiRemMode >> 1) & 1);
+        WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_REM_INTRA_PRED_MODE, (kiRemMode >> 2) & 1);
+      }
+    }
+  }
+
+  // uiChromPredMode of inter MBs is 0
+  WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_INTRA_CHROMA_PRED + (kpLeftMb != NULL && kpLeftMb->uiChromPredMode != 0)
+                           + (kpTopMb != NULL && kpTopMb->uiChromPredMode != 0), kiChromaMode > 0);
+  if (kiChromaMode > 0) {
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_INTRA_CHROMA_PRED + 3, kiChromaMode > 1);
+    if (kiChromaMode > 1)
+      WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_INTRA_CHROMA_PRED + 3, kiChromaMode > 2);
+  }
+  pCurMb->uiChromPredMode = kiChromaMode;
+}
+
+/*
+ *	neighbouring 8x8 blocks of block kiB8 are the blocks kiB8 ^ 1 (A) and kiB8 ^ 2 (B), either in current MB or in left/top MB
+ */
+static inline int32_t RefIdxCond (const SMB* kpMb, const int32_t kiB8) {
+  return (kpMb != NULL && !IS_SKIP (kpMb->uiMbType) && !IS_INTRA (kpMb->uiMbType) && kpMb->pRefIndex[kiB8] > 0);
+}
+
+static void WelsCabacRefIdx (SCabacCtx* pCbCtx, SMB* pCurMb, const SMB* kpLeftMb, const SMB* kpTopMb,
+                             const int32_t kiB8) {
+  const SMB* kpMbA	= (kiB8 & 1) ? pCurMb : kpLeftMb;
+  const SMB* kpMbB	= (kiB8 & 2) ? pCurMb : kpTopMb;
+  int32_t iRefIdx	= pCurMb->pRefIndex[kiB8];
+  int32_t iCtx		= CTX_OFFSET_REF_IDX + RefIdxCond (kpMbA, kiB8 ^ 1) + 2 * RefIdxCond (kpMbB, kiB8 ^ 2);
+
+  WelsCabacEncodeDecision (pCbCtx, iCtx, iRefIdx > 0);
+  if (iRefIdx > 0) {
+    iCtx = CTX_OFFSET_REF_IDX + 4;
+    while (--iRefIdx > 0) {
+      WelsCabacEncodeDecision (pCbCtx, iCtx, 1);
+      iCtx = CTX_OFFSET_REF_IDX + 5;
+    }
+    WelsCabacEncodeDecision (pCbCtx, iCtx, 0);
+  }
+}
+
+/*
+ *	UEG3 binarization with signedValFlag and uCoff of 9
+ */
+static void WelsCabacMvdComp (SCabacCtx* pCbCtx, const int32_t kiCtxOffset, const int32_t kiAbsSum,
+                              const int32_t kiMvd) {
+  const int32_t kiAbsMvd	= WELS_ABS (kiMvd);
+  const int32_t kiPrefix	= WELS_MIN (kiAbsMvd, 9);
+  int32_t iCtxInc			= (kiAbsSum < 3) ? 0 : ((kiAbsSum > 32) ? 2 : 1);
+  int32_t i;
+
+  WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + iCtxInc, kiAbsMvd != 0);
+  if (0 == kiAbsMvd)
+    return;
+
+  iCtxInc = 3;
+  for (i = 1; i < kiPrefix; i++) {
+    WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + iCtxInc, 1);
+    if (iCtxInc < 6)
+      ++ iCtxInc;
+  }
+  if (kiAbsMvd < 9)
+    WelsCabacEncodeDecision (pCbCtx, kiCtxOffset + iCtxInc, 0);
+  else
+    WelsCabacEncodeUeBypass (pCbCtx, 3, kiAbsMvd - 9);
+  WelsCabacEncodeBypass (pCbCtx, kiMvd < 0);
+}
+
+static void WelsCabacMvd (SCabacCtx* pCbCtx, SMB* pCurMb, const SMB* kpLeftMb, const SMB* kpTopMb,
+                          const int32_t kiB8, const SMVUnitXY ksMvd) {
+  const SMB* kpMbA		= (kiB8 & 1) ? pCurMb : kpLeftMb;
+  const SMB* kpMbB		= (kiB8 & 2) ? pCurMb : kpTopMb;
+  int32_t iAbsSumX = 0, iAbsSumY = 0;
+
+  if (kpMbA != NULL) {
+    iAbsSumX += WELS_ABS (kpMbA->sMvd[kiB8 ^ 1].iMvX);
+    iAbsSumY += WELS_ABS (kpMbA->sMvd[kiB8 ^ 1].iMvY);
+  }
+  if (kpMbB != NULL) {
+    iAbsSumX += WELS_ABS (kpMbB->sMvd[kiB8 ^ 2].iMvX);
+    iAbsSumY += WELS_ABS (kpMbB->sMvd[kiB8 ^ 2].iMvY);
+  }
+  WelsCabacMvdComp (pCbCtx, CTX_OFFSET_MVD_X, iAbsSumX, ksMvd.iMvX);
+  WelsCabacMvdComp (pCbCtx, CTX_OFFSET_MVD_Y, iAbsSumY, ksMvd.iMvY);
+
+  pCurMb->sMvd[kiB8] = ksMvd;
+}
+
+static void WelsCabacMbInterPred (SCabacCtx* pCbCtx, SSlice* pSlice, SMB* pCurMb, const SMB* kpLeftMb,
+                                  const SMB* kpTopMb) {
+  SMbCache* pMbCache		= &pSlice->sMbCacheInfo;
+  const bool kbRefIdxFlag	= pSlice->sSliceHeaderExt.sSliceHeader.uiNumRefIdxL0Active > 1;
+  SMVUnitXY sMvd;
+  int32_t i;
+
+  switch (pCurMb->uiMbType) {
+  case MB_TYPE_16x16:
+    if (kbRefIdxFlag)
+      WelsCabacRefIdx (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 0);
+
+    sMvd.sDeltaMv (pCurMb->sMv[0], pMbCache->sMbMvp[0]);
+    WelsCabacMvd (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 0, sMvd);
+    pCurMb->sMvd[1] = pCurMb->sMvd[2] = pCurMb->sMvd[3] = sMvd;
+    break;
+
+  case MB_TYPE_16x8:
+    if (kbRefIdxFlag) {
+      WelsCabacRefIdx (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 0);
+      WelsCabacRefIdx (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 2);
+    }
+
+    sMvd.sDeltaMv (pCurMb->sMv[0], pMbCache->sMbMvp[0]);
+    WelsCabacMvd (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 0, sMvd);
+    pCurMb->sMvd[1] = sMvd;
+    sMvd.sDeltaMv (pCurMb->sMv[8], pMbCache->sMbMvp[1]);
+    WelsCabacMvd (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 2, sMvd);
+    pCurMb->sMvd[3] = sMvd;
+    break;
+
+  case MB_TYPE_8x16:
+    if (kbRefIdxFlag) {
+      WelsCabacRefIdx (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 0);
+      WelsCabacRefIdx (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 1);
+    }
+
+    sMvd.sDeltaMv (pCurMb->sMv[0], pMbCache->sMbMvp[0]);
+    WelsCabacMvd (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 0, sMvd);
+    pCurMb->sMvd[2] = sMvd;
+    sMvd.sDeltaMv (pCurMb->sMv[2], pMbCache->sMbMvp[1]);
+    WelsCabacMvd (pCbCtx, pCurMb, kpLeftMb, kpTopMb, 1, sMvd);
+    pCurMb->sMvd[3] = sMvd;
+    break;
+
+  default:	// MB_TYPE_8x8, P_8x8ref0 is not allowed with cabac
+    for (i = 0; i < 4; i++)
+      WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_SUB_MB_TYPE_P, 1);	// P_L0_8x8
+
+    if (kbRefIdxFlag) {
+      for (i = 0; i < 4; i++)
+        WelsCabacRefIdx (pCbCtx, pCurMb, kpLeftMb, kpTopMb, i);
+    }
+    for (i = 0; i < 4; i++) {
+      sMvd.sDeltaMv (pCurMb->sMv[g_kuiMbCountScan4Idx[i << 2]], pMbCache->sMbMvp[i]);
+      WelsCabacMvd (pCbCtx, pCurMb, kpLeftMb, kpTopMb, i, sMvd);
+    }
+    break;
+  }
+}
+
+static void WelsCabacMbCbp (SCabacCtx* pCbCtx, SMB* pCurMb, const SMB* kpLeftMb, const SMB* kpTopMb) {
+  const int32_t kiCbpLuma		= pCurMb->uiCbp & 0x0F;
+  const int32_t kiCbpChroma		= pCurMb->uiCbp >> 4;
+  // unavailable MB acts as all luma 8x8 blocks coded and no chroma, skip MB as nothing coded
+  const int32_t kiCbpLeft		= (kpLeftMb == NULL) ? 0x0F : (IS_SKIP (kpLeftMb->uiMbType) ? 0 : kpLeftMb->uiCbp);
+  const int32_t kiCbpTop		= (kpTopMb == NULL) ? 0x0F : (IS_SKIP (kpTopMb->uiMbType) ? 0 : kpTopMb->uiCbp);
+  const int32_t kiChromaLeft	= kiCbpLeft >> 4;
+  const int32_t kiChromaTop		= kiCbpTop >> 4;
+  int32_t iB8;
+
+  for (iB8 = 0; iB8 < 4; iB8++) {
+    const int32_t kiCbpA = (iB8 & 1) ? kiCbpLuma : kiCbpLeft;
+    const int32_t kiCbpB = (iB8 & 2) ? kiCbpLuma : kiCbpTop;
+
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_CBP_LUMA + ! ((kiCbpA >> (iB8 ^ 1)) & 1)
+                             + 2 * ! ((kiCbpB >> (iB8 ^ 2)) & 1), (kiCbpLuma >> iB8) & 1);
+  }
+
+  WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_CBP_CHROMA + (kiChromaLeft != 0) + 2 * (kiChromaTop != 0), kiCbpChroma != 0);
+  if (kiCbpChroma)
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_CBP_CHROMA + 4 + (kiChromaLeft == 2) + 2 * (kiChromaTop == 2),
+                             kiCbpChroma == 2);
+}
+
+static void WelsCabacMbDeltaQp (SCabacCtx* pCbCtx, SSlice* pSlice, const int32_t kiDeltaQp) {
+  const int32_t kiVal	= (kiDeltaQp > 0) ? ((kiDeltaQp << 1) - 1) : (-kiDeltaQp << 1);
+  int32_t iCtx			= CTX_OFFSET_MB_QP_DELTA + (pSlice->iLastDeltaQp != 0);
+  int32_t i;
+
+  WelsCabacEncodeDecision (pCbCtx, iCtx, kiVal != 0);
+  if (kiVal) {
+    iCtx = CTX_OFFSET_MB_QP_DELTA + 2;
+    for (i = 1; i < kiVal; i++) {
+      WelsCabacEncodeDecision (pCbCtx, iCtx, 1);
+      iCtx = CTX_OFFSET_MB_QP_DELTA + 3;
+    }
+    WelsCabacEncodeDecision (pCbCtx, iCtx, 0);
+  }
+  pSlice->iLastDeltaQp = kiDeltaQp;
+}
+
+/*
+ *	condTermFlagN of coded_block_flag from the count cache, -1 for the blocks of unavailable MB
+ */
+static inline int32_t CbfCond (const int8_t kiNonZeroCount, const int32_t kiCbfUnavail) {
+  return (kiNonZeroCount < 0) ? kiCbfUnavail : (kiNonZeroCount > 0);
+}
+
+static inline int32_t CbfDcCond (const SMB* kpMb, const uint8_t kuiCbfDcMask, const int32_t kiCbfUnavail) {
+  return (kpMb == NULL) ? kiCbfUnavail : ((kpMb->uiCbfDc & kuiCbfDcMask) != 0);
+}
+
+static void WelsCabacMbResidual (SCabacCtx* pCbCtx, SMbCache* pMbCache, SMB* pCurMb, const SMB* kpLeftMb,
+                                 const SMB* kpTopMb) {
+  const int32_t kiCbpLuma			= pCurMb->uiCbp & 0x0F;
+  const int32_t kiCbpChroma			= pCurMb->uiCbp >> 4;
+  const int32_t kiCbfUnavail		= IS_INTRA (pCurMb->uiMbType) ? 1 : 0;
+  const int8_t* kpNonZeroCount		= pMbCache->iNonZeroCoeffCount;
+  int16_t* pBlock;
+  uint8_t uiCbfDc = 0;
+  int32_t i, iIdx;
+
+  if (IS_INTRA16x16 (pCurMb->uiMbType)) {
+    /* DC luma */
+    if (WriteBlockResidualCabac (pCbCtx, pMbCache->pDct->iLumaI16x16Dc, 15, LUMA_DC,
+                                 CbfDcCond (kpLeftMb, CBF_DC_LUMA, kiCbfUnavail) + 2 * CbfDcCond (kpTopMb, CBF_DC_LUMA, kiCbfUnavail)))
+      uiCbfDc |= CBF_DC_LUMA;
+
+    /* AC luma */
+    if (kiCbpLuma) {
+      pBlock = pMbCache->pDct->iLumaBlock[0];
+      for (i = 0; i < 16; i++) {
+        iIdx = g_kuiCache48CountScan4Idx[i];
+        WriteBlockResidualCabac (pCbCtx, pBlock, 14, LUMA_AC, CbfCond (kpNonZeroCount[iIdx - 1], kiCbfUnavail)
+                                 + 2 * CbfCond (kpNonZeroCount[iIdx - 8], kiCbfUnavail));
+        pBlock += 16;
+      }
+    }
+  } else if (kiCbpLuma) {
+    /* Luma DC AC */
+    pBlock = pMbCache->pDct->iLumaBlock[0];
+    for (i = 0; i < 16; i++) {
+      if (kiCbpLuma & (1 << (i >> 2))) {
+        iIdx = g_kuiCache48CountScan4Idx[i];
+        WriteBlockResidualCabac (pCbCtx, pBlock, 15, LUMA_4x4, CbfCond (kpNonZeroCount[iIdx - 1], kiCbfUnavail)
+                                 + 2 * CbfCond (kpNonZeroCount[iIdx - 8], kiCbfUnavail));
+      }
+      pBlock += 16;
+    }
+  }
+
+  if (kiCbpChroma) {
+    /* Chroma DC residual present */
+    for (i = 0; i < 2; i++) {
+      const uint8_t kuiMask = CBF_DC_CB << i;
+      if (WriteBlockResidualCabac (pCbCtx, pMbCache->pDct->iChromaDc[i], 3, CHROMA_DC,
+                                   CbfDcCond (kpLeftMb, kuiMask, kiCbfUnavail) + 2 * CbfDcCond (kpTopMb, kuiMask, kiCbfUnavail)))
+        uiCbfDc |= kuiMask;
+    }
+
+    /* Chroma AC residual present */
+    if (kiCbpChroma & 0x02) {
+      pBlock = pMbCache->pDct->iChromaBlock[0];	// Cb then Cr
+      for (i = 0; i < 8; i++) {
+        iIdx = g_kuiCache48CountScan4Idx[16 + (i & 3)] + ((i >> 2) * 24);
+        WriteBlockResidualCabac (pCbCtx, pBlock, 14, CHROMA_AC, CbfCond (kpNonZeroCount[iIdx - 1], kiCbfUnavail)
+                                 + 2 * CbfCond (kpNonZeroCount[iIdx - 8], kiCbfUnavail));
+        pBlock += 16;
+      }
+    }
+  }
+  pCurMb->uiCbfDc = uiCbfDc;
+}
+
+int32_t WelsSpatialWriteMbSynCabac (void* pEncCtx, SSlice* pSlice, SMB* pCurMb) {
+  sWelsEncCtx* pCtx			= (sWelsEncCtx*)pEncCtx;
+  SCabacCtx* pCbCtx			= &pSlice->sCabacCtx;
+  SMbCache* pMbCache		= &pSlice->sMbCacheInfo;
+  SBitStringAux* pBs		= pSlice->pSliceBsa;
+  const SSliceHeader* kpSh	= &pSlice->sSliceHeaderExt.sSliceHeader;
+  const bool kbIntraSlice	= (I_SLICE == kpSh->eSliceType);
+  const SMB* kpLeftMb		= (pCurMb->uiNeighborAvail & LEFT_MB_POS) ? (pCurMb - 1) : NULL;
+  const SMB* kpTopMb		= (pCurMb->uiNeighborAvail & TOP_MB_POS) ? (pCurMb - pCtx->pCurDqLayer->iMbWidth) : NULL;
+
+  /* end_of_slice_flag of the previous MB */
+  if (pCurMb->iMbXY != kpSh->iFirstMbInSlice)
+    WelsCabacEncodeTerminate (pCbCtx);
+
+  pCurMb->uiChromPredMode	= 0;
+  pCurMb->uiCbfDc			= 0;
+  memset (pCurMb->sMvd, 0, sizeof (pCurMb->sMvd));
+
+  if (!kbIntraSlice) {
+    const bool kbSkip = IS_SKIP (pCurMb->uiMbType);
+
+    WelsCabacEncodeDecision (pCbCtx, CTX_OFFSET_SKIP_FLAG_P + (kpLeftMb != NULL && !IS_SKIP (kpLeftMb->uiMbType))
+                             + (kpTopMb != NULL && !IS_SKIP (kpTopMb->uiMbType)), kbSkip);
+    if (kbSkip) {
+      pCurMb->uiLumaQp		= pSlice->uiLastMbQp;
+      pCurMb->uiChromaQp	= g_kuiChromaQpTable[CLIP3_QP_0_51 (pCurMb->uiLumaQp +
+                                                 pCtx->pCurDqLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset)];
+      pSlice->iLastDeltaQp	= 0;
+
+      pBs->pBufPtr = pCbCtx->pBufCur;
+      return CheckBitstreamBuffer (pSlice->uiSliceIdx, pCtx, pBs);
+    }
+  }
+
+  /* Step 1: write mb type and pred */
+  WelsCabacMbType (pCbCtx, pCurMb, pMbCache, kpLeftMb, kpTopMb, kbIntraSlice);
+  if (IS_INTRA (pCurMb->uiMbType))
+    WelsCabacMbIntraPred (pCbCtx, pCurMb, pMbCache, kpLeftMb, kpTopMb);
+  else
+    WelsCabacMbInterPred (pCbCtx, pSlice, pCurMb, kpLeftMb, kpTopMb);
+
+  /* Step 2: write coded block patern */
+  if (!IS_INTRA16x16 (pCurMb->uiMbType))
+    WelsCabacMbCbp (pCbCtx, pCurMb, kpLeftMb, kpTopMb);
+
+  /* Step 3: write QP and residual */
+  if (pCurMb->uiCbp > 0 || IS_INTRA16x16 (pCurMb->uiMbType)) {
+    const int32_t kiDeltaQp = pCurMb->uiLumaQp - pSlice->uiLastMbQp;
+    pSlice->uiLastMbQp = pCurMb->uiLumaQp;
+
+    WelsCabacMbDeltaQp (pCbCtx, pSlice, kiDeltaQp);
+    WelsCabacMbResidual (pCbCtx, pMbCache, pCurMb, kpLeftMb, kpTopMb);
+  } else {
+    pCurMb->uiLumaQp	= pSlice->uiLastMbQp;
+    pCurMb->uiChromaQp	= g_kuiChromaQpTable[CLIP3_QP_0_51 (pCurMb->uiLumaQp +
+                                             pCtx->pCurDqLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset)];
+    pSlice->iLastDeltaQp = 0;
+  }
+
+  /* Step 4: Check the left buffer */
+  pBs->pBufPtr = pCbCtx->pBufCur;
+  return CheckBitstreamBuffer (pSlice->uiSliceIdx, pCtx, pBs);
+}
+
+} // namespace WelsSVCEnc
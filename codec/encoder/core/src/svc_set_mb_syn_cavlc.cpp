@@ -220,11 +220,44 @@ int32_t CheckBitstreamBuffer(const uint8_t	kuiSliceIdx, sWelsEncCtx* pEncCtx,  S
   return ENC_RETURN_SUCCESS;
 }
 
+void StashMBStatusCavlc (SDynamicSlicingStack* pDss, SSlice* pSlice) {
+  SBitStringAux* pBs = pSlice->pSliceBsa;
+
+  pDss->pBsStackBufPtr		= pBs->pBufPtr;
+  pDss->uiBsStackCurBits	= pBs->uiCurBits;
+  pDss->iBsStackLeftBits	= pBs->iLeftBits;
+
+  pDss->iMbSkipRunStack		= pSlice->iMbSkipRun;
+}
+
+void StashPopMBStatusCavlc (SDynamicSlicingStack* pDss, SSlice* pSlice) {
+  SBitStringAux* pBs = pSlice->pSliceBsa;
+
+  pBs->pBufPtr		= pDss->pBsStackBufPtr;
+  pBs->uiCurBits	= pDss->uiBsStackCurBits;
+  pBs->iLeftBits	= pDss->iBsStackLeftBits;
+
+  pSlice->iMbSkipRun	= pDss->iMbSkipRunStack;
+}
+
 //============================Base Layer CAVLC Writing===============================
-int32_t WelsSpatialWriteMbSyn (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb) {
+int32_t WelsSpatialWriteMbSyn (void* pCtx, SSlice* pSlice, SMB* pCurMb) {
+  sWelsEncCtx* pEncCtx = (sWelsEncCtx*)pCtx;
   SBitStringAux* pBs = pSlice->pSliceBsa;
   SMbCache* pMbCache = &pSlice->sMbCacheInfo;
 
+  if (P_SLICE == pSlice->sSliceHeaderExt.sSliceHeader.eSliceType) {
+    if (IS_SKIP (pCurMb->uiMbType)) {
+      pCurMb->uiLumaQp = pSlice->uiLastMbQp;
+      pCurMb->uiChromaQp = g_kuiChromaQpTable[CLIP3_QP_0_51 (pCurMb->uiLumaQp +
+                                              pEncCtx->pCurDqLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset)];
+      ++ pSlice->iMbSkipRun;
+      return ENC_RETURN_SUCCESS;
+    }
+    BsWriteUE (pBs, pSlice->iMbSkipRun);
+    pSlice->iMbSkipRun = 0;
+  }
+
   /* Step 1: write mb type and pred */
   if (IS_Inter_8x8 (pCurMb->uiMbType)) {
     WelsSpatialWriteSubMbPred (pEncCtx, pSlice, pCurMb);
@@ -205,6 +205,8 @@ CWelsPreProcess::CWelsPreProcess (sWelsEncCtx* pEncCtx) {
   m_pEncLib = NULL;
   m_bInitDone = false;
   m_bOfficialBranch  = false;
+  m_iFrameIdx = 0;
+  m_iVaaFrameIdx = -1;
   m_pEncCtx = pEncCtx;
   memset (&m_sScaledPicture, 0, sizeof (m_sScaledPicture));
   memset (m_pSpatialPic, 0, sizeof(m_pSpatialPic));
@@ -226,6 +228,12 @@ int32_t CWelsPreProcess::WelsPreprocessCreate() {
     m_pEncLib->CreateIface (&m_pInterfaceVp);
     if (!m_pInterfaceVp)
       goto exit;
+
+#if defined(MT_ENABLED)
+    // split the preprocessing methods over as many threads as the slices are encoded on
+    int32_t iThreadsNum = m_pEncCtx->pSvcParam->iCountThreadsNum;
+    m_pInterfaceVp->SpecialFeature (FEATURE_THREADS_NUM, &iThreadsNum, NULL);
+#endif//MT_ENABLED
   } else
     goto exit;
 
@@ -249,6 +257,7 @@ int32_t CWelsPreProcess::WelsPreprocessDestroy() {
 int32_t CWelsPreProcess::WelsPreprocessReset (sWelsEncCtx* pCtx) {
   int32_t iRet = -1;
 
+  m_iVaaFrameIdx = -1;
   if (pCtx) {
     FreeScaledPic (&m_sScaledPicture, pCtx->pMemAlign);
     iRet = InitLastSpatialPictures (pCtx);
@@ -311,6 +320,9 @@ int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePi
   int32_t	iNumDependencyLayer = (int32_t)pSvcParam->iSpatialLayerNum;
   int32_t iSpatialNum = 0;
 
+  m_iFrameIdx = (m_iFrameIdx + 1) & 0x7fffffff;
+  m_iVaaFrameIdx = -1;
+
   if (!m_bInitDone) {
     if (WelsPreprocessCreate() != 0)
       return -1;
@@ -342,13 +354,18 @@ int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePi
   pCtx->pVaa->bSceneChangeFlag = pCtx->pVaa->bIdrPeriodFlag = false;
   if (pSvcParam->uiIntraPeriod)
     pCtx->pVaa->bIdrPeriodFlag = (1 + pCtx->iFrameIndex >= (int32_t)pSvcParam->uiIntraPeriod) ? true : false;
+  // periodic IDR is deferred to scene cut found by lookahead soon after
+  if (pCtx->pVaa->bIdrPeriodFlag && NULL != pCtx->pLookahead && pCtx->pLookahead->bValid
+      && pCtx->pLookahead->iCutDistance > 0 && pSvcParam->bEnableSceneChangeDetect)
+    pCtx->pVaa->bIdrPeriodFlag = false;
 
   if (m_bOfficialBranch) {	// Perform Down Sampling potentially due to application
     assert (kiConfiguredLayerNum == 1);
     iSpatialNum	= SingleLayerPreprocess (pCtx, kppSrcPicList[0], &m_sScaledPicture);
   } else { // for console each spatial pictures are available there
     iSpatialNum	= kiConfiguredLayerNum;
-    MultiLayerPreprocess (pCtx, kppSrcPicList, iSpatialNum);
+    if (MultiLayerPreprocess (pCtx, kppSrcPicList, iSpatialNum))
+      return -1;
   }
 
   return iSpatialNum;
@@ -368,12 +385,28 @@ int32_t CWelsPreProcess::AnalyzeSpatialPic (sWelsEncCtx* pCtx, const int32_t kiD
 
   SPicture* pCurPic = m_pSpatialPic[kiDidx][iCurTemporalIdx];
   SPicture* pRefPic = m_pSpatialPic[kiDidx][iRefTemporalIdx];
+
+  // statistics of scene change detection are taken for this frame and these pictures only, once
+  bool bVaaCalculated = (m_iVaaFrameIdx == m_iFrameIdx && pCtx->pVaa->sVaaCalcInfo.pCurY == pCurPic->pData[0]
+                         && pCtx->pVaa->sVaaCalcInfo.pRefY == pRefPic->pData[0]);
+  m_iVaaFrameIdx = -1;
+
+  // first, so that all the statistics below are of the picture which is encoded; the static blocks are picked on the
+  // 8x8 sad of the picture as it came in, from scene change detection or a sad pass of its own
+  if (pSvcParam->bEnableTemporalDenoise && pCtx->eSliceType == P_SLICE) {
+    if (!bVaaCalculated)
+      VaaCalculation (pCtx->pVaa, pCurPic, pRefPic, false, false, false);
+    TemporalDenoising (pCtx->pVaa, pCurPic, pRefPic);
+    bVaaCalculated = false;
+  }
+
   {
     SPicture* pLastPic = m_pLastSpatialPicture[kiDidx][0];
     bool bCalculateSQDiff = ((pLastPic->pData[0] == pRefPic->pData[0]) && bNeededMbAq);
     bool bCalculateVar = (pSvcParam->iRCMode == RC_MODE1 && pCtx->eSliceType == I_SLICE);
 
-    VaaCalculation (pCtx->pVaa, pCurPic, pRefPic, bCalculateSQDiff, bCalculateVar, bCalculateBGD);
+    if (!bVaaCalculated)
+      VaaCalculation (pCtx->pVaa, pCurPic, pRefPic, bCalculateSQDiff, bCalculateVar, bCalculateBGD);
   }
 
   if (pSvcParam->bEnableBackgroundDetection) {
@@ -418,10 +451,35 @@ int32_t CWelsPreProcess::UpdateSpatialPictures(sWelsEncCtx* pCtx, SWelsSvcCoding
   return 0;
 }
 
+/*!
+ * \brief	expose the spatial picture the next input is moved into, input written there is not moved again
+ *			(valid until the next frame is encoded since the spatial pictures rotate)
+ * \return	0 on success, 1 if the input is scaled or cropped before coding
+ */
+int32_t CWelsPreProcess::GetInputPicture (sWelsEncCtx* pCtx, SSourcePicture* pSrcPic) {
+  SWelsSvcCodingParam* pSvcParam	= pCtx->pSvcParam;
+  const int32_t kiDid				= pSvcParam->iSpatialLayerNum - 1;
+  const SDLayerParam* kpDlayer	= &pSvcParam->sDependencyLayers[kiDid];
+
+  if (pSvcParam->SUsedPicRect.iLeft != 0 || pSvcParam->SUsedPicRect.iTop != 0
+      || pSvcParam->SUsedPicRect.iWidth != kpDlayer->iActualWidth || pSvcParam->SUsedPicRect.iHeight != kpDlayer->iActualHeight)
+    return 1;
+
+  SPicture* pPic = m_pSpatialPic[kiDid][m_uiSpatialLayersInTemporal[kiDid] - 1];
+  memset (pSrcPic, 0, sizeof (SSourcePicture));
+  pSrcPic->iColorFormat	= videoFormatI420;
+  pSrcPic->iPicWidth		= kpDlayer->iActualWidth;
+  pSrcPic->iPicHeight		= kpDlayer->iActualHeight;
+  for (int32_t i = 0; i < 3; ++ i) {
+    pSrcPic->iStride[i]	= pPic->iLineSize[i];
+    pSrcPic->pData[i]	= pPic->pData[i];
+  }
+  return 0;
+}
 
 /*
 *	SingleLayerPreprocess: down sampling if applicable
-*  @return:	exact number of spatial layers need to encoder indeed
+*  @return:	exact number of spatial layers need to encoder indeed, -1 if the input picture could not be taken
 */
 int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSourcePicture* kpSrc,
     Scaled_Picture* pScaledPicture) {
@@ -450,7 +508,8 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
   pSrcPic = pScaledPicture->pScaledInputPicture ? pScaledPicture->pScaledInputPicture :
             m_pSpatialPic[iDependencyId][iPicturePos];
 
-  WelsMoveMemoryWrapper (pSvcParam, pSrcPic, kpSrc, iSrcWidth, iSrcHeight);
+  if (WelsMoveMemoryWrapper (pSvcParam, pSrcPic, kpSrc, iSrcWidth, iSrcHeight))
+    return -1;
 
   if (pSvcParam->bEnableDenoise)
     BilateralDenoising (pSrcPic, iSrcWidth, iSrcHeight);
@@ -556,7 +615,8 @@ int32_t CWelsPreProcess::MultiLayerPreprocess (sWelsEncCtx* pCtx, const SSourceP
 
     WelsUpdateSpatialIdxMap (pCtx, i, pDstPic, j);
 
-    WelsMoveMemoryWrapper (pSvcParam, pDstPic, pSrc, pSrc->iPicWidth, pSrc->iPicHeight);
+    if (WelsMoveMemoryWrapper (pSvcParam, pDstPic, pSrc, pSrc->iPicWidth, pSrc->iPicHeight))
+      return -1;
 
     if (pSvcParam->bEnableDenoise)
       BilateralDenoising (pDstPic, pSrc->iPicWidth, pSrc->iPicHeight);
@@ -649,10 +709,45 @@ int32_t CWelsPreProcess::InitLastSpatialPictures (sWelsEncCtx* pCtx) {
 }
 //*********************************************************************************************************/
 
+/*!
+ * \brief	convert a non i420 input straight into the padded spatial picture, what the i420 input is moved by
+ *			WelsMoveMemoryWrapper()
+ * \return	0 on success, 1 if the format or the picture is not supported by the converter
+ */
 int32_t CWelsPreProcess::ColorspaceConvert (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic,
     const SSourcePicture* kpSrc, const int32_t kiWidth, const int32_t kiHeight) {
-  return 1;
-  //not support yet
+  int32_t iMethodIdx = METHOD_COLORSPACE_CONVERT;
+  int32_t iSrcWidth  = WELS_MIN (kpSrc->iPicWidth, kiWidth) & ~1;
+  int32_t iSrcHeight = WELS_MIN (kpSrc->iPicHeight, kiHeight) & ~1;
+  SPixMap sSrcPixMap = {0};
+  SPixMap sDstPixMap = {0};
+
+  for (int32_t i = 0; i < 3; i++) {
+    sSrcPixMap.pPixel[i] = kpSrc->pData[i];
+    sSrcPixMap.iStride[i] = kpSrc->iStride[i];
+    sDstPixMap.pPixel[i] = pDstPic->pData[i];
+    sDstPixMap.iStride[i] = pDstPic->iLineSize[i];
+  }
+  sSrcPixMap.iSizeInBits = g_kiPixMapSizeInBits;
+  sSrcPixMap.sRect.iRectLeft = pSvcParam->SUsedPicRect.iLeft;
+  sSrcPixMap.sRect.iRectTop = pSvcParam->SUsedPicRect.iTop;
+  sSrcPixMap.sRect.iRectWidth = iSrcWidth;
+  sSrcPixMap.sRect.iRectHeight = iSrcHeight;
+  sSrcPixMap.eFormat = (EVideoFormat)kpSrc->iColorFormat;
+
+  sDstPixMap.iSizeInBits = g_kiPixMapSizeInBits;
+  sDstPixMap.sRect.iRectWidth = iSrcWidth;
+  sDstPixMap.sRect.iRectHeight = iSrcHeight;
+  sDstPixMap.eFormat = VIDEO_FORMAT_I420;
+
+  if (m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sDstPixMap) != RET_SUCCESS)
+    return 1;
+
+  if (kiWidth > iSrcWidth || kiHeight > iSrcHeight) {
+    Padding (pDstPic->pData[0], pDstPic->pData[1], pDstPic->pData[2], pDstPic->iLineSize[0], pDstPic->iLineSize[1],
+             iSrcWidth, kiWidth, iSrcHeight, kiHeight);
+  }
+  return 0;
 }
 
 void CWelsPreProcess::BilateralDenoising (SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight) {
@@ -673,13 +768,63 @@ void CWelsPreProcess::BilateralDenoising (SPicture* pSrc, const int32_t kiWidth,
   m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, NULL);
 }
 
+void CWelsPreProcess::TemporalDenoising (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture) {
+  int32_t iMethodIdx = METHOD_DENOISE;
+  SDenoiseParam sDenoiseParam = {0};
+  SPixMap sCurPixMap = {0};
+  SPixMap sRefPixMap = {0};
+
+  sCurPixMap.pPixel[0] = pCurPicture->pData[0];
+  sCurPixMap.pPixel[1] = pCurPicture->pData[1];
+  sCurPixMap.pPixel[2] = pCurPicture->pData[2];
+  sCurPixMap.iSizeInBits = g_kiPixMapSizeInBits;
+  sCurPixMap.sRect.iRectWidth = pCurPicture->iWidthInPixel;
+  sCurPixMap.sRect.iRectHeight = pCurPicture->iHeightInPixel;
+  sCurPixMap.iStride[0] = pCurPicture->iLineSize[0];
+  sCurPixMap.iStride[1] = pCurPicture->iLineSize[1];
+  sCurPixMap.iStride[2] = pCurPicture->iLineSize[2];
+  sCurPixMap.eFormat = VIDEO_FORMAT_I420;
+
+  sRefPixMap.pPixel[0] = pRefPicture->pData[0];
+  sRefPixMap.pPixel[1] = pRefPicture->pData[1];
+  sRefPixMap.pPixel[2] = pRefPicture->pData[2];
+  sRefPixMap.iSizeInBits = g_kiPixMapSizeInBits;
+  sRefPixMap.sRect.iRectWidth = pRefPicture->iWidthInPixel;
+  sRefPixMap.sRect.iRectHeight = pRefPicture->iHeightInPixel;
+  sRefPixMap.iStride[0] = pRefPicture->iLineSize[0];
+  sRefPixMap.iStride[1] = pRefPicture->iLineSize[1];
+  sRefPixMap.iStride[2] = pRefPicture->iLineSize[2];
+  sRefPixMap.eFormat = VIDEO_FORMAT_I420;
+
+  // the 8x8 sad of the VAA pass on these pictures tells the static blocks
+  sDenoiseParam.pCalcResult = &pVaaInfo->sVaaCalcInfo;
+  m_pInterfaceVp->Set (iMethodIdx, &sDenoiseParam);
+  m_pInterfaceVp->Process (iMethodIdx, &sCurPixMap, &sRefPixMap);
+}
+
 bool CWelsPreProcess::DetectSceneChange (SPicture* pCurPicture, SPicture* pRefPicture) {
   bool bSceneChangeFlag = false;
   int32_t iMethodIdx = METHOD_SCENE_CHANGE_DETECTION;
   SSceneChangeResult sSceneChangeDetectResult = {0};
+  SSceneChangeParam sSceneChangeParam = {0};
   SPixMap sSrcPixMap = {0};
   SPixMap sRefPixMap = {0};
 
+  m_iVaaFrameIdx = -1;
+  // analyze the frame in one pass: the vaa statistics needed by the later consumers are calculated here
+  // in full, scene change detection counts its motion blocks on the 8x8 sad of them
+  if (pCurPicture->iWidthInPixel == pRefPicture->iWidthInPixel
+      && pCurPicture->iHeightInPixel == pRefPicture->iHeightInPixel
+      && pCurPicture->iLineSize[0] == pRefPicture->iLineSize[0]
+      && (pCurPicture->iWidthInPixel & 15) == 0 && (pCurPicture->iHeightInPixel & 15) == 0) {
+    SVAAFrameInfo* pVaaInfo = m_pEncCtx->pVaa;
+
+    VaaCalculation (pVaaInfo, pCurPicture, pRefPicture, true, true, m_pEncCtx->pSvcParam->bEnableBackgroundDetection);
+    sSceneChangeParam.pCalcResult = &pVaaInfo->sVaaCalcInfo;
+    m_iVaaFrameIdx = m_iFrameIdx;
+  }
+  m_pInterfaceVp->Set (iMethodIdx, (void*)&sSceneChangeParam);
+
   sSrcPixMap.pPixel[0] = pCurPicture->pData[0];
   sSrcPixMap.iSizeInBits = g_kiPixMapSizeInBits;
   sSrcPixMap.iStride[0] = pCurPicture->iLineSize[0];
@@ -1015,11 +1160,20 @@ void  WelsMoveMemory_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV,  int32_t
   }
 }
 
-void  CWelsPreProcess::WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic,
+/*!
+ * \brief	move the input picture into the padded spatial picture, converting non i420 input
+ * \return	0 on success, 1 if the input could not be converted
+ */
+int32_t CWelsPreProcess::WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic,
     const SSourcePicture* kpSrc,
     const int32_t kiTargetWidth, const int32_t kiTargetHeight) {
-  if (VIDEO_FORMAT_I420 != (kpSrc->iColorFormat & (~VIDEO_FORMAT_VFlip)))
-    return;
+  if (VIDEO_FORMAT_I420 != (kpSrc->iColorFormat & (~VIDEO_FORMAT_VFlip))) {
+    // converted in place of the copy, with no intermediate i420 picture
+    return ColorspaceConvert (pSvcParam, pDstPic, kpSrc, kiTargetWidth, kiTargetHeight);
+  }
+  // written in place, see GetInputPicture()
+  if (kpSrc->pData[0] == pDstPic->pData[0] && kpSrc->pData[1] == pDstPic->pData[1] && kpSrc->pData[2] == pDstPic->pData[2])
+    return 0;
 
   int32_t  iSrcWidth       = kpSrc->iPicWidth;
   int32_t  iSrcHeight      = kpSrc->iPicHeight;
@@ -1056,30 +1210,31 @@ void  CWelsPreProcess::WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SP
 #define MAX_HEIGHT     (2304)//MAX_FS_LEVEL51 (36864); MAX_FS_LEVEL51*256/4096 = 2304
   if (pSrcY) {
     if (iSrcWidth <= 0 || iSrcWidth > MAX_WIDTH || iSrcHeight <= 0 || iSrcHeight > MAX_HEIGHT)
-      return;
+      return 1;
     if (kiSrcTopOffsetY >= iSrcHeight || kiSrcLeftOffsetY >= iSrcWidth || iSrcWidth > kiSrcStrideY)
-      return;
+      return 1;
   }
   if (pDstY) {
     if (kiTargetWidth <= 0 || kiTargetWidth > MAX_WIDTH || kiTargetHeight <= 0 || kiTargetHeight > MAX_HEIGHT)
-      return;
+      return 1;
     if (kiTargetWidth > kiDstStrideY)
-      return;
+      return 1;
   }
 
   if (pSrcY == NULL || pSrcU == NULL || pSrcV == NULL || pDstY == NULL || pDstU == NULL || pDstV == NULL
       || (iSrcWidth & 1) || (iSrcHeight & 1)) {
-  } else {
-    //i420_to_i420_c
-    WelsMoveMemory_c (pDstY,  pDstU,  pDstV,  kiDstStrideY, kiDstStrideUV,
-                      pSrcY,  pSrcU,  pSrcV, kiSrcStrideY, kiSrcStrideUV, iSrcWidth, iSrcHeight);
-
-    //in VP Process
-    if (kiTargetWidth > iSrcWidth || kiTargetHeight > iSrcHeight) {
-      Padding(pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, iSrcWidth, kiTargetWidth, iSrcHeight, kiTargetHeight);
-    }
+    return 1;
   }
 
+  //i420_to_i420_c
+  WelsMoveMemory_c (pDstY,  pDstU,  pDstV,  kiDstStrideY, kiDstStrideUV,
+                    pSrcY,  pSrcU,  pSrcV, kiSrcStrideY, kiSrcStrideUV, iSrcWidth, iSrcHeight);
+
+  //in VP Process
+  if (kiTargetWidth > iSrcWidth || kiTargetHeight > iSrcHeight) {
+    Padding(pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, iSrcWidth, kiTargetWidth, iSrcHeight, kiTargetHeight);
+  }
+  return 0;
 }
 
 //*********************************************************************************************************/
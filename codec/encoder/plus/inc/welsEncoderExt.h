@@ -57,6 +57,43 @@
 
 class ISVCEncoder;
 namespace WelsSVCEnc {
+
+#define ASYNC_ENCODE_QUEUE_SIZE	4	// frames queued by EncodeFrameAsync() and not yet taken by GetEncodedFrame()
+#define ASYNC_ENCODE_SLOT_NUM	(ASYNC_ENCODE_QUEUE_SIZE + 1)	// one more slot for the frame taken last
+
+/*
+ *	Frame queued for asynchronous encoding, input pixels are copied since the application owns its input only during the call
+ */
+typedef struct TagAsyncEncodeFrame {
+  SSourcePicture	sSrcPic;		// I420 picture pointing to pSrcBuffer
+  uint8_t*			pSrcBuffer;
+  int32_t			iSrcBufferSize;
+  bool				bFlush;			// NULL queued, drains frames of lookahead
+
+  SFrameBSInfo		sBsInfo;		// layers pointing to pBsBuffer once encoded
+  uint8_t*			pBsBuffer;
+  int32_t			iBsBufferSize;
+  int32_t			iFrameType;
+} SAsyncEncodeFrame;
+
+typedef struct TagAsyncEncoding {
+  SAsyncEncodeFrame	sFrames[ASYNC_ENCODE_SLOT_NUM];	// ring buffer
+  int32_t			iQueuedNum;		// counts of frames since start, slot of a frame is its count modulo slot number
+  int32_t			iEncodedNum;
+  int32_t			iTakenNum;
+#if defined(MT_ENABLED)
+  WELS_THREAD_HANDLE	hThread;
+  WELS_MUTEX		mutexCount;		// protects counts and flags
+  WELS_EVENT*		pQueuedEvent;	// signaled when a frame is queued or to stop the thread while bWaitQueued
+  WELS_EVENT*		pEncodedEvent;	// signaled when a frame is encoded while bWaitEncoded
+  WELS_EVENT*		pIdleEvent;		// signaled when all frames queued are encoded while bWaitIdle
+  bool				bWaitQueued;
+  bool				bWaitEncoded;
+  bool				bWaitIdle;
+  bool				bStop;
+#endif//MT_ENABLED
+} SAsyncEncoding;
+
 class CWelsH264SVCEncoder : public ISVCEncoder {
  public:
   CWelsH264SVCEncoder();
@@ -75,6 +112,9 @@ class CWelsH264SVCEncoder : public ISVCEncoder {
    * return: EVideoFrameType [IDR: videoFrameTypeIDR; P: videoFrameTypeP; ERROR: videoFrameTypeInvalid]
    */
   virtual int EXTAPI EncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo);
+  /*
+   * not supported with lookahead, the pictures would bypass the ones it keeps
+   */
   virtual int EXTAPI EncodeFrame2 (const SSourcePicture** kppSrcPicList, int nSrcPicNum, SFrameBSInfo* pBsInfo);
 
   /*
@@ -83,6 +123,7 @@ class CWelsH264SVCEncoder : public ISVCEncoder {
   virtual int EXTAPI EncodeParameterSets (SFrameBSInfo* pBsInfo);
 
   /*
+   * not supported with lookahead
    * return: 0 - success; otherwise - failed;
    */
   virtual int EXTAPI PauseFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo);
@@ -101,10 +142,30 @@ class CWelsH264SVCEncoder : public ISVCEncoder {
   virtual int EXTAPI SetOption (ENCODER_OPTION opt_id, void* option);
   virtual int EXTAPI GetOption (ENCODER_OPTION opt_id, void* option);
 
+  /*
+   * return: CM_RETURN: 0 - success; cmQueueFull - GetEncodedFrame() expected first; otherwise - failed;
+   */
+  virtual int EXTAPI EncodeFrameAsync (const SSourcePicture* kpSrcPic);
+  /*
+   * return: EVideoFrameType as EncodeFrame(), videoFrameTypeInvalid if nothing queued
+   */
+  virtual int EXTAPI GetEncodedFrame (SFrameBSInfo* pBsInfo);
+
  private:
   int Initialize2 (SWelsSvcCodingParam* argv);
+  int EncodeFrameInternal (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo);
+  int EncodeFrameList (const SSourcePicture** kppSrcPicList, int nSrcPicNum, SFrameBSInfo* pBsInfo);
+
+  int32_t CreateAsyncEncoding();
+  void    DestroyAsyncEncoding();
+  void    WaitAsyncEncodingIdle();
+  void    EncodeAsyncFrame (SAsyncEncodeFrame* pFrame);
+#if defined(MT_ENABLED)
+  static WELS_THREAD_ROUTINE_TYPE AsyncEncodingThreadProc (void* pArg);
+#endif//MT_ENABLED
 
   sWelsEncCtx*	m_pEncContext;
+  SAsyncEncoding*	m_pAsyncEncoding;	// created by first EncodeFrameAsync()
 
   welsCodecTrace*			m_pWelsTrace;
   SSourcePicture**			m_pSrcPicList;
@@ -60,6 +60,7 @@ namespace WelsSVCEnc {
  */
 CWelsH264SVCEncoder::CWelsH264SVCEncoder()
   :	m_pEncContext (NULL),
+    m_pAsyncEncoding (NULL),
     m_pWelsTrace (NULL),
     m_pSrcPicList (NULL),
     m_iSrcListSize (0),
@@ -426,6 +427,8 @@ int32_t CWelsH264SVCEncoder::Uninitialize() {
 
   WelsLog (m_pEncContext, WELS_LOG_INFO, "CWelsH264SVCEncoder::Uninitialize()..\n");
 
+  DestroyAsyncEncoding();
+
 #ifdef REC_FRAME_COUNT
   WelsLog (m_pEncContext, WELS_LOG_INFO,
            "CWelsH264SVCEncoder::Uninitialize, m_uiCountFrameNum= %d, m_iCspInternal= 0x%x\n", m_uiCountFrameNum, m_iCspInternal);
@@ -484,6 +487,11 @@ int32_t CWelsH264SVCEncoder::RawData2SrcPic (const uint8_t* pSrc) {
     m_pSrcPicList[0]->pData[1] = m_pSrcPicList[0]->pData[0] + y_length;
     m_pSrcPicList[0]->pData[2] = m_pSrcPicList[0]->pData[1] + (y_length >> 2);
     break;
+  case videoFormatNV12:
+  case videoFormatNV21:
+    m_pSrcPicList[0]->pData[1] = m_pSrcPicList[0]->pData[0] + y_length;
+    m_pSrcPicList[0]->pData[2] = NULL;
+    break;
   default:
     return 1;
   }
@@ -496,12 +504,43 @@ int32_t CWelsH264SVCEncoder::RawData2SrcPic (const uint8_t* pSrc) {
  *	SVC core encoding
  */
 int CWelsH264SVCEncoder::EncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo) {
-  if (! (kpSrcPic && m_pEncContext && m_bInitialFlag)) {
+  WaitAsyncEncodingIdle();
+
+  return EncodeFrameInternal (kpSrcPic, pBsInfo);
+}
+
+int CWelsH264SVCEncoder::EncodeFrameInternal (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo) {
+  if (! (m_pEncContext && m_bInitialFlag)) {
     return videoFrameTypeInvalid;
   }
 
   int32_t uiFrameType = videoFrameTypeInvalid;
-  uiFrameType = EncodeFrame2 (&kpSrcPic, 1, pBsInfo);
+  if (NULL != m_pEncContext->pLookahead) {
+    // the picture coded is the one input iLookaheadFrames calls before, NULL input drains the frames left
+    if (NULL != kpSrcPic && videoFormatI420 != kpSrcPic->iColorFormat) {
+      WelsLog (m_pEncContext, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::EncodeFrame(), lookahead takes I420 input only, iColorFormat= %d.\n",
+               kpSrcPic->iColorFormat);
+      return videoFrameTypeInvalid;
+    }
+    if (NULL != kpSrcPic && WelsLookaheadPush (m_pEncContext, kpSrcPic)) {
+      WelsLog (m_pEncContext, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), WelsLookaheadPush failed.\n");
+      return videoFrameTypeInvalid;
+    }
+    const SSourcePicture* kpCodingPic = WelsLookaheadPop (m_pEncContext, NULL == kpSrcPic);
+    if (NULL == kpCodingPic) {
+      pBsInfo->iLayerNum = 0;
+      return (NULL != kpSrcPic) ? videoFrameTypeDelayed : videoFrameTypeInvalid;
+    }
+    uiFrameType = EncodeFrameList (&kpCodingPic, 1, pBsInfo);
+    if (NULL != m_pEncContext)
+      m_pEncContext->pLookahead->bValid = false;
+  } else {
+    if (NULL == kpSrcPic) {
+      return videoFrameTypeInvalid;
+    }
+    uiFrameType = EncodeFrameList (&kpSrcPic, 1, pBsInfo);
+  }
 
 #ifdef REC_FRAME_COUNT
   ++ m_uiCountFrameNum;
@@ -517,7 +556,16 @@ int CWelsH264SVCEncoder::EncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSIn
 }
 
 
-int CWelsH264SVCEncoder::EncodeFrame2 (const SSourcePicture**   pSrcPicList, int nSrcPicNum, SFrameBSInfo* pBsInfo) {
+int CWelsH264SVCEncoder::EncodeFrame2 (const SSourcePicture** kppSrcPicList, int nSrcPicNum, SFrameBSInfo* pBsInfo) {
+  if (m_pEncContext && NULL != m_pEncContext->pLookahead) {
+    WelsLog (m_pEncContext, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame2(), not supported with lookahead.\n");
+    return videoFrameTypeInvalid;
+  }
+
+  return EncodeFrameList (kppSrcPicList, nSrcPicNum, pBsInfo);
+}
+
+int CWelsH264SVCEncoder::EncodeFrameList (const SSourcePicture**   pSrcPicList, int nSrcPicNum, SFrameBSInfo* pBsInfo) {
   if (!(pSrcPicList && m_pEncContext && m_bInitialFlag) || (nSrcPicNum<=0) ){
     return videoFrameTypeInvalid;
   }
@@ -537,6 +585,7 @@ int CWelsH264SVCEncoder::EncodeFrame2 (const SSourcePicture**   pSrcPicList, int
     break;//continue processing
   case ENC_RETURN_UNSUPPORTED_PARA:
   case ENC_RETURN_UNEXPECTED:
+  case ENC_RETURN_INVALIDINPUT:
     return videoFrameTypeInvalid;
   default:
     WelsLog (m_pEncContext, WELS_LOG_ERROR, "unexpected return(%d) from WelsEncoderEncodeExt()!\n", kiEncoderReturn);
@@ -619,18 +668,26 @@ int CWelsH264SVCEncoder::EncodeFrame2 (const SSourcePicture**   pSrcPicList, int
 }
 
 int CWelsH264SVCEncoder::EncodeParameterSets (SFrameBSInfo* pBsInfo) {
-    return WelsEncoderEncodeParameterSets (m_pEncContext, pBsInfo);
+  WaitAsyncEncodingIdle();
+  return WelsEncoderEncodeParameterSets (m_pEncContext, pBsInfo);
 }
 
 /*
  * return: 0 - success; otherwise - failed;
  */
 int CWelsH264SVCEncoder::PauseFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo) {
+  WaitAsyncEncodingIdle();
+
   int32_t  iReturn = 1;
 
+  if (m_pEncContext && NULL != m_pEncContext->pLookahead) {
+    WelsLog (m_pEncContext, WELS_LOG_ERROR, "CWelsH264SVCEncoder::PauseFrame(), not supported with lookahead.\n");
+    return iReturn;
+  }
+
   ForceIntraFrame (true);
 
-  if (EncodeFrame2 (&kpSrcPic, 1,pBsInfo) != videoFrameTypeInvalid) {
+  if (EncodeFrameList (&kpSrcPic, 1, pBsInfo) != videoFrameTypeInvalid) {
 	iReturn = 0;
   }
  
@@ -647,6 +704,8 @@ int CWelsH264SVCEncoder::PauseFrame (const SSourcePicture* kpSrcPic, SFrameBSInf
  *	Force key frame
  */
 int CWelsH264SVCEncoder::ForceIntraFrame (bool bIDR) {
+  WaitAsyncEncodingIdle();
+
   if (! (m_pEncContext && m_bInitialFlag)) {
     return 1;
   }
@@ -666,6 +725,8 @@ int CWelsH264SVCEncoder::ForceIntraFrame (bool bIDR) {
 * InDataFormat, IDRInterval, SVC Encode Param, Frame Rate, Bitrate,..
 ************************************************************************/
 int CWelsH264SVCEncoder::SetOption (ENCODER_OPTION eOptionId, void* pOption) {
+  WaitAsyncEncodingIdle();
+
   if (NULL == pOption) {
     return cmInitParaError;
   }
@@ -741,7 +802,7 @@ int CWelsH264SVCEncoder::SetOption (ENCODER_OPTION eOptionId, void* pOption) {
     int32_t iTargetWidth = 0;
     int32_t iTargetHeight = 0;
 
-    memcpy (&sEncodingParam, pOption, sizeof (SEncParamBase));	// confirmed_safe_unsafe_usage
+    memcpy (&sEncodingParam, pOption, sizeof (SEncParamExt));	// confirmed_safe_unsafe_usage
     WelsLog (m_pEncContext, WELS_LOG_INFO, "ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, sEncodingParam.iInputCsp= 0x%x\n",
              sEncodingParam.iInputCsp);
     WelsLog (m_pEncContext, WELS_LOG_INFO,
@@ -923,6 +984,8 @@ int CWelsH264SVCEncoder::SetOption (ENCODER_OPTION eOptionId, void* pOption) {
 }
 
 int CWelsH264SVCEncoder::GetOption (ENCODER_OPTION eOptionId, void* pOption) {
+  WaitAsyncEncodingIdle();
+
   if (NULL == pOption) {
     return cmInitParaError;
   }
@@ -991,6 +1054,13 @@ int CWelsH264SVCEncoder::GetOption (ENCODER_OPTION eOptionId, void* pOption) {
     * ((int32_t*)pOption)	= m_pEncContext->pSvcParam->iTargetBitrate;
   }
   break;
+  case ENCODER_OPTION_INPUT_PICTURE: {	// Picture the next EncodeFrame() reads in place
+    if (WelsEncoderGetInputPicture (m_pEncContext, (SSourcePicture*)pOption)) {
+      WelsLog (m_pEncContext, WELS_LOG_INFO, "ENCODER_OPTION_INPUT_PICTURE, input is copied anyway.\n");
+      return cmInitParaError;
+    }
+  }
+  break;
   default:
     return cmInitParaError;
   }
@@ -998,6 +1068,290 @@ int CWelsH264SVCEncoder::GetOption (ENCODER_OPTION eOptionId, void* pOption) {
   return 0;
 }
 
+/*
+ *	Asynchronous encoding: the input is copied in the calling thread while the previous
+ *	frames are encoded in order on a thread of their own, see EncodeFrameAsync()
+ */
+int32_t CWelsH264SVCEncoder::CreateAsyncEncoding() {
+  SAsyncEncoding* pAsync = new SAsyncEncoding;
+  if (NULL == pAsync) {
+    return 1;
+  }
+  memset (pAsync, 0, sizeof (SAsyncEncoding));
+  m_pAsyncEncoding = pAsync;
+
+#if defined(MT_ENABLED)
+  if (WELS_THREAD_ERROR_OK != WelsMutexInit (&pAsync->mutexCount)) {
+    delete pAsync;
+    m_pAsyncEncoding = NULL;
+    return 1;
+  }
+  if (WELS_THREAD_ERROR_OK != WelsEventCreate (&pAsync->pQueuedEvent)
+      || WELS_THREAD_ERROR_OK != WelsEventCreate (&pAsync->pEncodedEvent)
+      || WELS_THREAD_ERROR_OK != WelsEventCreate (&pAsync->pIdleEvent)
+      || WELS_THREAD_ERROR_OK != WelsThreadCreate (&pAsync->hThread, AsyncEncodingThreadProc, this, 0)) {
+    if (NULL != pAsync->pIdleEvent)
+      WelsEventFree (pAsync->pIdleEvent);
+    if (NULL != pAsync->pEncodedEvent)
+      WelsEventFree (pAsync->pEncodedEvent);
+    if (NULL != pAsync->pQueuedEvent)
+      WelsEventFree (pAsync->pQueuedEvent);
+    WelsMutexDestroy (&pAsync->mutexCount);
+    delete pAsync;
+    m_pAsyncEncoding = NULL;
+    return 1;
+  }
+#endif//MT_ENABLED
+
+  return 0;
+}
+
+void CWelsH264SVCEncoder::DestroyAsyncEncoding() {
+  SAsyncEncoding* pAsync = m_pAsyncEncoding;
+  if (NULL == pAsync) {
+    return;
+  }
+
+#if defined(MT_ENABLED)
+  // frames queued but not started yet are dropped
+  WelsMutexLock (&pAsync->mutexCount);
+  pAsync->bStop = true;
+  if (pAsync->bWaitQueued) {
+    pAsync->bWaitQueued = false;
+    WelsEventSignal (pAsync->pQueuedEvent);
+  }
+  WelsMutexUnlock (&pAsync->mutexCount);
+  WelsThreadJoin (pAsync->hThread);
+
+  WelsEventFree (pAsync->pIdleEvent);
+  WelsEventFree (pAsync->pEncodedEvent);
+  WelsEventFree (pAsync->pQueuedEvent);
+  WelsMutexDestroy (&pAsync->mutexCount);
+#endif//MT_ENABLED
+
+  for (int32_t i = 0; i < ASYNC_ENCODE_SLOT_NUM; ++ i) {
+    if (NULL != pAsync->sFrames[i].pSrcBuffer) {
+      delete [] pAsync->sFrames[i].pSrcBuffer;
+    }
+    if (NULL != pAsync->sFrames[i].pBsBuffer) {
+      delete [] pAsync->sFrames[i].pBsBuffer;
+    }
+  }
+  delete pAsync;
+  m_pAsyncEncoding = NULL;
+}
+
+/*
+ *	the synchronous calls share the encoder context with the encoding thread, so they wait for the frames queued
+ */
+void CWelsH264SVCEncoder::WaitAsyncEncodingIdle() {
+#if defined(MT_ENABLED)
+  SAsyncEncoding* pAsync = m_pAsyncEncoding;
+  if (NULL == pAsync) {
+    return;
+  }
+
+  // the counts are checked again after each wake up, an interrupted wait must not be taken as idle
+  WelsMutexLock (&pAsync->mutexCount);
+  while (pAsync->iEncodedNum != pAsync->iQueuedNum) {
+    pAsync->bWaitIdle = true;
+    WelsMutexUnlock (&pAsync->mutexCount);
+    WelsEventWait (pAsync->pIdleEvent);
+    WelsMutexLock (&pAsync->mutexCount);
+  }
+  WelsMutexUnlock (&pAsync->mutexCount);
+#endif//MT_ENABLED
+}
+
+void CWelsH264SVCEncoder::EncodeAsyncFrame (SAsyncEncodeFrame* pFrame) {
+  SFrameBSInfo* pBsInfo	= &pFrame->sBsInfo;
+  int32_t iSize			= 0;
+  int32_t i, j;
+
+  pBsInfo->iLayerNum	= 0;
+  pFrame->iFrameType	= EncodeFrameInternal (pFrame->bFlush ? NULL : &pFrame->sSrcPic, pBsInfo);
+  if (videoFrameTypeInvalid == pFrame->iFrameType) {
+    pBsInfo->iLayerNum	= 0;
+    return;
+  }
+
+  // the bitstream is moved out of the encoder since the next frame overwrites it
+  for (i = 0; i < pBsInfo->iLayerNum; ++ i) {
+    for (j = 0; j < pBsInfo->sLayerInfo[i].iNalCount; ++ j)
+      iSize += pBsInfo->sLayerInfo[i].iNalLengthInByte[j];
+  }
+  if (iSize > pFrame->iBsBufferSize) {
+    if (NULL != pFrame->pBsBuffer) {
+      delete [] pFrame->pBsBuffer;
+    }
+    pFrame->iBsBufferSize	= 0;
+    pFrame->pBsBuffer		= new uint8_t[iSize];
+    if (NULL == pFrame->pBsBuffer) {
+      pFrame->iFrameType	= videoFrameTypeInvalid;
+      pBsInfo->iLayerNum	= 0;
+      return;
+    }
+    pFrame->iBsBufferSize	= iSize;
+  }
+
+  iSize = 0;
+  for (i = 0; i < pBsInfo->iLayerNum; ++ i) {
+    SLayerBSInfo* pLayer	= &pBsInfo->sLayerInfo[i];
+    int32_t iLayerSize		= 0;
+    for (j = 0; j < pLayer->iNalCount; ++ j)
+      iLayerSize += pLayer->iNalLengthInByte[j];
+    memcpy (pFrame->pBsBuffer + iSize, pLayer->pBsBuf, iLayerSize);
+    pLayer->pBsBuf	= pFrame->pBsBuffer + iSize;
+    iSize += iLayerSize;
+  }
+}
+
+#if defined(MT_ENABLED)
+WELS_THREAD_ROUTINE_TYPE CWelsH264SVCEncoder::AsyncEncodingThreadProc (void* pArg) {
+  CWelsH264SVCEncoder* pEncoder	= (CWelsH264SVCEncoder*)pArg;
+  SAsyncEncoding* pAsync			= pEncoder->m_pAsyncEncoding;
+
+  while (true) {
+    WelsMutexLock (&pAsync->mutexCount);
+    while (!pAsync->bStop && pAsync->iEncodedNum == pAsync->iQueuedNum) {
+      pAsync->bWaitQueued = true;
+      WelsMutexUnlock (&pAsync->mutexCount);
+      WelsEventWait (pAsync->pQueuedEvent);
+      WelsMutexLock (&pAsync->mutexCount);
+    }
+    const bool kbStop = pAsync->bStop;
+    WelsMutexUnlock (&pAsync->mutexCount);
+    if (kbStop)
+      break;
+
+    pEncoder->EncodeAsyncFrame (&pAsync->sFrames[pAsync->iEncodedNum % ASYNC_ENCODE_SLOT_NUM]);
+
+    WelsMutexLock (&pAsync->mutexCount);
+    ++ pAsync->iEncodedNum;
+    if (pAsync->bWaitIdle && pAsync->iEncodedNum == pAsync->iQueuedNum) {
+      pAsync->bWaitIdle = false;
+      WelsEventSignal (pAsync->pIdleEvent);
+    }
+    if (pAsync->bWaitEncoded) {
+      pAsync->bWaitEncoded = false;
+      WelsEventSignal (pAsync->pEncodedEvent);
+    }
+    WelsMutexUnlock (&pAsync->mutexCount);
+  }
+
+  WELS_THREAD_ROUTINE_RETURN (0);
+}
+#endif//MT_ENABLED
+
+int CWelsH264SVCEncoder::EncodeFrameAsync (const SSourcePicture* kpSrcPic) {
+  if (! (m_pEncContext && m_bInitialFlag)) {
+    return cmInitExpected;
+  }
+  if (NULL != kpSrcPic && (videoFormatI420 != (kpSrcPic->iColorFormat & (~videoFormatVFlip))
+                           || kpSrcPic->iPicWidth <= 0 || kpSrcPic->iPicHeight <= 0)) {
+    WelsLog (m_pEncContext, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrameAsync(), invalid input picture.\n");
+    return cmInitParaError;
+  }
+  if (NULL == m_pAsyncEncoding && CreateAsyncEncoding()) {
+    WelsLog (m_pEncContext, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrameAsync(), CreateAsyncEncoding failed.\n");
+    return cmMallocMemeError;
+  }
+
+  // counts of frames queued and taken are changed by the calling thread only
+  SAsyncEncoding* pAsync = m_pAsyncEncoding;
+  if (pAsync->iQueuedNum - pAsync->iTakenNum >= ASYNC_ENCODE_QUEUE_SIZE) {
+    return cmQueueFull;
+  }
+
+  SAsyncEncodeFrame* pFrame = &pAsync->sFrames[pAsync->iQueuedNum % ASYNC_ENCODE_SLOT_NUM];
+  pFrame->bFlush = (NULL == kpSrcPic);
+  if (!pFrame->bFlush) {
+    SSourcePicture* pPic			= &pFrame->sSrcPic;
+    const int32_t kiLumaSize		= kpSrcPic->iPicWidth * kpSrcPic->iPicHeight;
+    const int32_t kiChromaSize	= (kpSrcPic->iPicWidth >> 1) * (kpSrcPic->iPicHeight >> 1);
+    const int32_t kiSize			= kiLumaSize + (kiChromaSize << 1);
+    if (kiSize > pFrame->iSrcBufferSize) {
+      if (NULL != pFrame->pSrcBuffer) {
+        delete [] pFrame->pSrcBuffer;
+      }
+      pFrame->iSrcBufferSize	= 0;
+      pFrame->pSrcBuffer		= new uint8_t[kiSize];
+      if (NULL == pFrame->pSrcBuffer) {
+        return cmMallocMemeError;
+      }
+      pFrame->iSrcBufferSize	= kiSize;
+    }
+
+    memset (pPic, 0, sizeof (SSourcePicture));
+    pPic->iColorFormat	= kpSrcPic->iColorFormat;
+    pPic->iPicWidth		= kpSrcPic->iPicWidth;
+    pPic->iPicHeight		= kpSrcPic->iPicHeight;
+    pPic->iStride[0]		= pPic->iPicWidth;
+    pPic->iStride[1]		= pPic->iStride[2] = pPic->iPicWidth >> 1;
+    pPic->pData[0]		= pFrame->pSrcBuffer;
+    pPic->pData[1]		= pPic->pData[0] + kiLumaSize;
+    pPic->pData[2]		= pPic->pData[1] + kiChromaSize;
+    for (int32_t i = 0; i < 3; ++ i) {
+      const int32_t kiShift	= (i > 0);
+      const int32_t kiWidth	= pPic->iPicWidth >> kiShift;
+      const int32_t kiHeight	= pPic->iPicHeight >> kiShift;
+      for (int32_t j = 0; j < kiHeight; ++ j)
+        memcpy (pPic->pData[i] + j * pPic->iStride[i], kpSrcPic->pData[i] + j * kpSrcPic->iStride[i], kiWidth);
+    }
+  }
+
+#if defined(MT_ENABLED)
+  WelsMutexLock (&pAsync->mutexCount);
+  ++ pAsync->iQueuedNum;
+  if (pAsync->bWaitQueued) {
+    pAsync->bWaitQueued = false;
+    WelsEventSignal (pAsync->pQueuedEvent);
+  }
+  WelsMutexUnlock (&pAsync->mutexCount);
+#else
+  EncodeAsyncFrame (pFrame);
+  ++ pAsync->iQueuedNum;
+  ++ pAsync->iEncodedNum;
+#endif//MT_ENABLED
+
+  return cmResultSuccess;
+}
+
+int CWelsH264SVCEncoder::GetEncodedFrame (SFrameBSInfo* pBsInfo) {
+  SAsyncEncoding* pAsync = m_pAsyncEncoding;
+  if (NULL == pBsInfo) {
+    return videoFrameTypeInvalid;
+  }
+  pBsInfo->iLayerNum = 0;
+  if (NULL == pAsync || pAsync->iTakenNum == pAsync->iQueuedNum) {
+    return videoFrameTypeInvalid;
+  }
+
+#if defined(MT_ENABLED)
+  WelsMutexLock (&pAsync->mutexCount);
+  while (pAsync->iEncodedNum == pAsync->iTakenNum) {
+    pAsync->bWaitEncoded = true;
+    WelsMutexUnlock (&pAsync->mutexCount);
+    WelsEventWait (pAsync->pEncodedEvent);
+    WelsMutexLock (&pAsync->mutexCount);
+  }
+  WelsMutexUnlock (&pAsync->mutexCount);
+#endif//MT_ENABLED
+
+  // the slot stays untouched until the next call, so the layers can point into it
+  const SAsyncEncodeFrame* kpFrame	= &pAsync->sFrames[pAsync->iTakenNum % ASYNC_ENCODE_SLOT_NUM];
+  const SFrameBSInfo* kpBsInfo		= &kpFrame->sBsInfo;
+  ++ pAsync->iTakenNum;
+
+  pBsInfo->iTemporalId		= kpBsInfo->iTemporalId;
+  pBsInfo->uiFrameType		= kpBsInfo->uiFrameType;
+  pBsInfo->eOutputFrameType	= kpBsInfo->eOutputFrameType;
+  pBsInfo->iLayerNum		= kpBsInfo->iLayerNum;
+  memcpy (pBsInfo->sLayerInfo, kpBsInfo->sLayerInfo, kpBsInfo->iLayerNum * sizeof (SLayerBSInfo));
+
+  return kpFrame->iFrameType;
+}
+
 void CWelsH264SVCEncoder::DumpSrcPicture (const uint8_t* pSrc) {
 #ifdef DUMP_SRC_PICTURE
   FILE* pFile = NULL;
@@ -9,16 +9,20 @@ ENCODER_CPP_SRCS=\
 	$(ENCODER_SRCDIR)/core/src/encoder_ext.cpp\
 	$(ENCODER_SRCDIR)/core/src/expand_pic.cpp\
 	$(ENCODER_SRCDIR)/core/src/get_intra_predictor.cpp\
+	$(ENCODER_SRCDIR)/core/src/lookahead.cpp\
+	$(ENCODER_SRCDIR)/core/src/mb_row_multi_threading.cpp\
 	$(ENCODER_SRCDIR)/core/src/mc.cpp\
 	$(ENCODER_SRCDIR)/core/src/md.cpp\
 	$(ENCODER_SRCDIR)/core/src/memory_align.cpp\
 	$(ENCODER_SRCDIR)/core/src/mv_pred.cpp\
 	$(ENCODER_SRCDIR)/core/src/nal_encap.cpp\
+	$(ENCODER_SRCDIR)/core/src/nal_encap_x86.cpp\
 	$(ENCODER_SRCDIR)/core/src/picture_handle.cpp\
 	$(ENCODER_SRCDIR)/core/src/property.cpp\
 	$(ENCODER_SRCDIR)/core/src/ratectl.cpp\
 	$(ENCODER_SRCDIR)/core/src/ref_list_mgr_svc.cpp\
 	$(ENCODER_SRCDIR)/core/src/sample.cpp\
+	$(ENCODER_SRCDIR)/core/src/set_mb_syn_cabac.cpp\
 	$(ENCODER_SRCDIR)/core/src/set_mb_syn_cavlc.cpp\
 	$(ENCODER_SRCDIR)/core/src/slice_multi_threading.cpp\
 	$(ENCODER_SRCDIR)/core/src/svc_base_layer_md.cpp\
@@ -27,6 +31,7 @@ ENCODER_CPP_SRCS=\
 	$(ENCODER_SRCDIR)/core/src/svc_encode_slice.cpp\
 	$(ENCODER_SRCDIR)/core/src/svc_mode_decision.cpp\
 	$(ENCODER_SRCDIR)/core/src/svc_motion_estimate.cpp\
+	$(ENCODER_SRCDIR)/core/src/svc_set_mb_syn_cabac.cpp\
 	$(ENCODER_SRCDIR)/core/src/svc_set_mb_syn_cavlc.cpp\
 	$(ENCODER_SRCDIR)/core/src/utils.cpp\
 	$(ENCODER_SRCDIR)/core/src/wels_preprocess.cpp\
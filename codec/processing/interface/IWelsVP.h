@@ -83,6 +83,7 @@ typedef enum {
   VIDEO_FORMAT_NV12		= 26,	/* y planar + uv packed */
   VIDEO_FORMAT_I422       = 27,   /* yuv 4:2:2 planar */
   VIDEO_FORMAT_I444       = 28,   /* yuv 4:4:4 planar */
+  VIDEO_FORMAT_NV21       = 29,   /* y planar + vu packed */
   VIDEO_FORMAT_YUYV       = 20,   /* yuv 4:2:2 packed */
 
   VIDEO_FORMAT_RGB24      = 1,
@@ -120,7 +121,7 @@ typedef struct {
 
 typedef enum {
   METHOD_NULL              = 0,
-  METHOD_COLORSPACE_CONVERT    ,//not support yet
+  METHOD_COLORSPACE_CONVERT    ,// to i420, pSrc of any rgb 24/32 bits, packed yuv 4:2:2, nv12/nv21 or yv12 format
   METHOD_DENOISE              ,
   METHOD_SCENE_CHANGE_DETECTION ,
   METHOD_DOWNSAMPLE			  ,
@@ -132,6 +133,11 @@ typedef enum {
   METHOD_MASK
 } EMethods;
 
+typedef enum {
+  FEATURE_NULL              = 0,
+  FEATURE_THREADS_NUM       // pIn: int*, threads the methods are split on, the calling thread included; 1 by default
+} EFeatures;
+
 //-----------------------------------------------------------------//
 //  Algorithm parameters define
 //-----------------------------------------------------------------//
@@ -166,6 +172,14 @@ typedef struct {
   SVAACalcResult*	pCalcResult;
 } SVAACalcParam;
 
+typedef struct {
+  SVAACalcResult*	pCalcResult;	// statistics of the same pictures if calculated already, the 8x8 sad is reused
+} SSceneChangeParam;
+
+typedef struct {
+  SVAACalcResult*	pCalcResult;	// statistics of the picture against the reference handed to the temporal mode, its 8x8 sad picks the static blocks
+} SDenoiseParam;
+
 typedef struct {
   signed char*		pBackgroundMbFlag;
   SVAACalcResult*  pCalcRes;
@@ -269,6 +283,10 @@ class IWelsVP {
 
 #endif
 
+/*
+ *	an instance is not thread safe: its methods must not be called from several threads at once, take one
+ *	instance per calling thread instead; FEATURE_THREADS_NUM splits the work of a call onto worker threads
+ */
 WELSVP_EXTERNC_BEGIN
 EResult CreateVpInterface (void** ppCtx, int iVersion /*= WELSVP_INTERFACE_VERION*/);
 EResult DestroyVpInterface (void* pCtx , int iVersion /*= WELSVP_INTERFACE_VERION*/);
@@ -64,44 +64,99 @@ EResult CAdaptiveQuantization::Process (int32_t iType, SPixMap* pSrcPixMap, SPix
   int32_t iMbWidth  = iWidth  >> 4;
   int32_t iMbHeight = iHeight >> 4;
   int32_t iMbTotalNum    = iMbWidth * iMbHeight;
+  const int32_t kiStripeNum = GetStripeNum (iMbHeight);
 
-  SMotionTextureUnit* pMotionTexture = NULL;
-  SVAACalcResult*     pVaaCalcResults = NULL;
-  int8_t   iMotionTextureIndexToDeltaQp = 0;
+  SAqStripeCtx sCtx;
   int32_t	 iAverMotionTextureIndexToDeltaQp = 0;	// double to uint32
   double dAverageMotionIndex = 0.0;	// double to float
   double dAverageTextureIndex = 0.0;
+  int32_t i = 0;
 
-  double dQStep = 0.0;
-  double dLumaMotionDeltaQp = 0;
-  double dLumaTextureDeltaQp = 0;
+  sCtx.pAq			= this;
+  sCtx.pSrcPixMap	= pSrcPixMap;
+  sCtx.pRefPixMap	= pRefPixMap;
+  sCtx.iMbWidth		= iMbWidth;
+  sCtx.iMbHeight	= iMbHeight;
+
+  /////////////////////////////////////// motion //////////////////////////////////
+  //  motion MB residual variance
+  RunStripes (MotionTextureStripe, &sCtx, kiStripeNum);
+
+  // partial sums are integral valued so the reduction is exact whatever the stripes are
+  for (i = 0; i < kiStripeNum; i++) {
+    dAverageMotionIndex += sCtx.dMotionIndexSum[i];
+    dAverageTextureIndex += sCtx.dTextureIndexSum[i];
+  }
+  dAverageMotionIndex = dAverageMotionIndex / iMbTotalNum;
+  dAverageTextureIndex = dAverageTextureIndex / iMbTotalNum;
+  if ((dAverageMotionIndex <= PESN) && (dAverageMotionIndex >= -PESN)) {
+    dAverageMotionIndex = 1.0;
+  }
+  if ((dAverageTextureIndex <= PESN) && (dAverageTextureIndex >= -PESN)) {
+    dAverageTextureIndex = 1.0;
+  }
+  //  motion mb residual map to QP
+  //  texture mb original map to QP
+  dAverageMotionIndex = AVERAGE_TIME_MOTION * dAverageMotionIndex;
+
+  if (m_sAdaptiveQuantParam.iAdaptiveQuantMode == AQ_QUALITY_MODE) {
+    dAverageTextureIndex = AVERAGE_TIME_TEXTURE_QUALITYMODE * dAverageTextureIndex;
+  } else {
+    dAverageTextureIndex = AVERAGE_TIME_TEXTURE_BITRATEMODE * dAverageTextureIndex;
+  }
+
+  sCtx.dAverageMotionIndex	= dAverageMotionIndex;
+  sCtx.dAverageTextureIndex	= dAverageTextureIndex;
+  RunStripes (DeltaQpStripe, &sCtx, kiStripeNum);
+
+  for (i = 0; i < kiStripeNum; i++) {
+    iAverMotionTextureIndexToDeltaQp += sCtx.iDeltaQpSum[i];
+  }
+  m_sAdaptiveQuantParam.dAverMotionTextureIndexToDeltaQp = (1.0 * iAverMotionTextureIndexToDeltaQp) / iMbTotalNum;
+
+  eReturn = RET_SUCCESS;
+
+  return eReturn;
+}
+
+void CAdaptiveQuantization::MotionTextureStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SAqStripeCtx* pStripeCtx = (SAqStripeCtx*)pCtx;
+  CAdaptiveQuantization* pAq = pStripeCtx->pAq;
+  const int32_t kiMbWidth = pStripeCtx->iMbWidth;
+#if defined(WIN64) && defined(X86_ASM)
+  uint8_t AdaptiveQuantizationBuffer[160];	// xmm registers of the thread of this stripe, not the shared member buffer
+  WelsXmmRegProtectFunc AdaptiveQuantizationload	= pAq->AdaptiveQuantizationload;
+  WelsXmmRegProtectFunc AdaptiveQuantizationstore	= pAq->AdaptiveQuantizationstore;
+#endif
+
+  SMotionTextureUnit* pMotionTexture = NULL;
+  SVAACalcResult*     pVaaCalcResults = NULL;
+  double dMotionIndexSum = 0.0;
+  double dTextureIndexSum = 0.0;
 
   uint8_t* pRefFrameY = NULL, *pCurFrameY = NULL;
   int32_t iRefStride = 0, iCurStride = 0;
 
   uint8_t* pRefFrameTmp = NULL, *pCurFrameTmp = NULL;
   int32_t i = 0, j = 0;
+  int32_t iStartRow = 0, iEndRow = 0;
 
-  pRefFrameY = (uint8_t*)pRefPixMap->pPixel[0];
-  pCurFrameY = (uint8_t*)pSrcPixMap->pPixel[0];
+  GetStripeRows (pStripeCtx->iMbHeight, kiStripeIdx, kiStripeNum, &iStartRow, &iEndRow);
 
-  iRefStride  = pRefPixMap->iStride[0];
-  iCurStride  = pSrcPixMap->iStride[0];
+  pRefFrameY = (uint8_t*)pStripeCtx->pRefPixMap->pPixel[0];
+  pCurFrameY = (uint8_t*)pStripeCtx->pSrcPixMap->pPixel[0];
 
-  /////////////////////////////////////// motion //////////////////////////////////
-  //  motion MB residual variance
-  dAverageMotionIndex = 0.0;
-  dAverageTextureIndex = 0.0;
-  pMotionTexture = m_sAdaptiveQuantParam.pMotionTextureUnit;
-  pVaaCalcResults = m_sAdaptiveQuantParam.pCalcResult;
+  iRefStride  = pStripeCtx->pRefPixMap->iStride[0];
+  iCurStride  = pStripeCtx->pSrcPixMap->iStride[0];
+
+  pMotionTexture = pAq->m_sAdaptiveQuantParam.pMotionTextureUnit + iStartRow * kiMbWidth;
+  pVaaCalcResults = pAq->m_sAdaptiveQuantParam.pCalcResult;
 
   if (pVaaCalcResults->pRefY == pRefFrameY && pVaaCalcResults->pCurY == pCurFrameY) {
-    int32_t iMbIndex = 0;
+    int32_t iMbIndex = iStartRow * kiMbWidth;
     int32_t iSumDiff, iSQDiff, uiSum, iSQSum;
-    for (j = 0; j < iMbHeight; j ++) {
-      pRefFrameTmp  = pRefFrameY;
-      pCurFrameTmp  = pCurFrameY;
-      for (i = 0; i < iMbWidth; i++) {
+    for (j = iStartRow; j < iEndRow; j ++) {
+      for (i = 0; i < kiMbWidth; i++) {
         XMMREG_PROTECT_STORE(AdaptiveQuantization);
         iSumDiff =  pVaaCalcResults->pSad8x8[iMbIndex][0];
         iSumDiff += pVaaCalcResults->pSad8x8[iMbIndex][1];
@@ -119,26 +174,24 @@ EResult CAdaptiveQuantization::Process (int32_t iType, SPixMap* pSrcPixMap, SPix
         uiSum = uiSum >> 8;
         pMotionTexture->uiTextureIndex = (iSQSum >> 8) - (uiSum * uiSum);
 
-        dAverageMotionIndex += pMotionTexture->uiMotionIndex;
-        dAverageTextureIndex += pMotionTexture->uiTextureIndex;
+        dMotionIndexSum += pMotionTexture->uiMotionIndex;
+        dTextureIndexSum += pMotionTexture->uiTextureIndex;
         pMotionTexture++;
         ++iMbIndex;
-        pRefFrameTmp += MB_WIDTH_LUMA;
-        pCurFrameTmp += MB_WIDTH_LUMA;
       }
-      pRefFrameY += (iRefStride) << 4;
-      pCurFrameY += (iCurStride) << 4;
     }
   } else {
-    for (j = 0; j < iMbHeight; j ++) {
+    pRefFrameY += (iStartRow * iRefStride) << 4;
+    pCurFrameY += (iStartRow * iCurStride) << 4;
+    for (j = iStartRow; j < iEndRow; j ++) {
       pRefFrameTmp  = pRefFrameY;
       pCurFrameTmp  = pCurFrameY;
-      for (i = 0; i < iMbWidth; i++) {
+      for (i = 0; i < kiMbWidth; i++) {
         XMMREG_PROTECT_STORE(AdaptiveQuantization);
-        m_pfVar (pRefFrameTmp, iRefStride, pCurFrameTmp, iCurStride, pMotionTexture);
+        pAq->m_pfVar (pRefFrameTmp, iRefStride, pCurFrameTmp, iCurStride, pMotionTexture);
         XMMREG_PROTECT_LOAD(AdaptiveQuantization);
-        dAverageMotionIndex += pMotionTexture->uiMotionIndex;
-        dAverageTextureIndex += pMotionTexture->uiTextureIndex;
+        dMotionIndexSum += pMotionTexture->uiMotionIndex;
+        dTextureIndexSum += pMotionTexture->uiTextureIndex;
         pMotionTexture++;
         pRefFrameTmp += MB_WIDTH_LUMA;
         pCurFrameTmp += MB_WIDTH_LUMA;
@@ -148,53 +201,52 @@ EResult CAdaptiveQuantization::Process (int32_t iType, SPixMap* pSrcPixMap, SPix
       pCurFrameY += (iCurStride) << 4;
     }
   }
-  dAverageMotionIndex = dAverageMotionIndex / iMbTotalNum;
-  dAverageTextureIndex = dAverageTextureIndex / iMbTotalNum;
-  if ((dAverageMotionIndex <= PESN) && (dAverageMotionIndex >= -PESN)) {
-    dAverageMotionIndex = 1.0;
-  }
-  if ((dAverageTextureIndex <= PESN) && (dAverageTextureIndex >= -PESN)) {
-    dAverageTextureIndex = 1.0;
-  }
-  //  motion mb residual map to QP
-  //  texture mb original map to QP
-  iAverMotionTextureIndexToDeltaQp = 0;
-  dAverageMotionIndex = AVERAGE_TIME_MOTION * dAverageMotionIndex;
+  pStripeCtx->dMotionIndexSum[kiStripeIdx]	= dMotionIndexSum;
+  pStripeCtx->dTextureIndexSum[kiStripeIdx]	= dTextureIndexSum;
+}
 
-  if (m_sAdaptiveQuantParam.iAdaptiveQuantMode == AQ_QUALITY_MODE) {
-    dAverageTextureIndex = AVERAGE_TIME_TEXTURE_QUALITYMODE * dAverageTextureIndex;
-  } else {
-    dAverageTextureIndex = AVERAGE_TIME_TEXTURE_BITRATEMODE * dAverageTextureIndex;
-  }
+void CAdaptiveQuantization::DeltaQpStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SAqStripeCtx* pStripeCtx = (SAqStripeCtx*)pCtx;
+  SAdaptiveQuantizationParam* pParam = &pStripeCtx->pAq->m_sAdaptiveQuantParam;
+  const int32_t kiMbWidth = pStripeCtx->iMbWidth;
+  const double kdAverageMotionIndex = pStripeCtx->dAverageMotionIndex;
+  const double kdAverageTextureIndex = pStripeCtx->dAverageTextureIndex;
+
+  SMotionTextureUnit* pMotionTexture = NULL;
+  int8_t   iMotionTextureIndexToDeltaQp = 0;
+  int32_t	 iDeltaQpSum = 0;
+  double dQStep = 0.0;
+  double dLumaMotionDeltaQp = 0;
+  double dLumaTextureDeltaQp = 0;
+  int32_t i = 0, j = 0;
+  int32_t iStartRow = 0, iEndRow = 0;
+
+  GetStripeRows (pStripeCtx->iMbHeight, kiStripeIdx, kiStripeNum, &iStartRow, &iEndRow);
 
-  pMotionTexture = m_sAdaptiveQuantParam.pMotionTextureUnit;
-  for (j = 0; j < iMbHeight; j ++) {
-    for (i = 0; i < iMbWidth; i++) {
-      double a = pMotionTexture->uiTextureIndex / dAverageTextureIndex;
+  pMotionTexture = pParam->pMotionTextureUnit + iStartRow * kiMbWidth;
+  for (j = iStartRow; j < iEndRow; j ++) {
+    for (i = 0; i < kiMbWidth; i++) {
+      double a = pMotionTexture->uiTextureIndex / kdAverageTextureIndex;
       dQStep = (a - 1) / (a + MODEL_ALPHA);
       dLumaTextureDeltaQp = MODEL_TIME * dQStep;// range +- 6
 
       iMotionTextureIndexToDeltaQp = (int8_t)dLumaTextureDeltaQp;
 
-      a = pMotionTexture->uiMotionIndex / dAverageMotionIndex;
+      a = pMotionTexture->uiMotionIndex / kdAverageMotionIndex;
       dQStep = (a - 1) / (a + MODEL_ALPHA);
       dLumaMotionDeltaQp = MODEL_TIME * dQStep;// range +- 6
 
-      if ((m_sAdaptiveQuantParam.iAdaptiveQuantMode == AQ_QUALITY_MODE && dLumaMotionDeltaQp < -PESN)
-          || (m_sAdaptiveQuantParam.iAdaptiveQuantMode == AQ_BITRATE_MODE)) {
+      if ((pParam->iAdaptiveQuantMode == AQ_QUALITY_MODE && dLumaMotionDeltaQp < -PESN)
+          || (pParam->iAdaptiveQuantMode == AQ_BITRATE_MODE)) {
         iMotionTextureIndexToDeltaQp += (int8_t)dLumaMotionDeltaQp;
       }
 
-      m_sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp[j * iMbWidth + i] = iMotionTextureIndexToDeltaQp;
-      iAverMotionTextureIndexToDeltaQp += iMotionTextureIndexToDeltaQp;
+      pParam->pMotionTextureIndexToDeltaQp[j * kiMbWidth + i] = iMotionTextureIndexToDeltaQp;
+      iDeltaQpSum += iMotionTextureIndexToDeltaQp;
       pMotionTexture++;
     }
   }
-  m_sAdaptiveQuantParam.dAverMotionTextureIndexToDeltaQp = (1.0 * iAverMotionTextureIndexToDeltaQp) / iMbTotalNum;
-
-  eReturn = RET_SUCCESS;
-
-  return eReturn;
+  pStripeCtx->iDeltaQpSum[kiStripeIdx] = iDeltaQpSum;
 }
 
 
@@ -63,6 +63,21 @@ WELSVP_EXTERN_C_END
 #endif
 
 
+class CAdaptiveQuantization;
+
+typedef struct TagAqStripeCtx {
+  CAdaptiveQuantization*	pAq;
+  SPixMap*					pSrcPixMap;
+  SPixMap*					pRefPixMap;
+  int32_t					iMbWidth;
+  int32_t					iMbHeight;
+  double					dAverageMotionIndex;	// scaled frame averages the delta QP pass maps against
+  double					dAverageTextureIndex;
+  double					dMotionIndexSum[MAX_STRIPE_NUM];	// partial sums of each stripe
+  double					dTextureIndexSum[MAX_STRIPE_NUM];
+  int32_t					iDeltaQpSum[MAX_STRIPE_NUM];
+} SAqStripeCtx;
+
 class CAdaptiveQuantization : public IStrategy {
  public:
   CAdaptiveQuantization (int32_t iCpuFlag);
@@ -74,6 +89,8 @@ class CAdaptiveQuantization : public IStrategy {
 
  private:
   void WelsInitVarFunc (PVarFunc& pfVar, int32_t iCpuFlag);
+  static void MotionTextureStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
+  static void DeltaQpStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
 
  private:
   PVarFunc			                   m_pfVar;
@@ -66,29 +66,31 @@ EResult CBackgroundDetection::Process (int32_t iType, SPixMap* pSrcPixMap, SPixM
   if (pSrcPixMap == NULL || pRefPixMap == NULL)
     return eReturn;
 
-  m_BgdParam.pCur[0] = (uint8_t*)pSrcPixMap->pPixel[0];
-  m_BgdParam.pCur[1] = (uint8_t*)pSrcPixMap->pPixel[1];
-  m_BgdParam.pCur[2] = (uint8_t*)pSrcPixMap->pPixel[2];
-  m_BgdParam.pRef[0] = (uint8_t*)pRefPixMap->pPixel[0];
-  m_BgdParam.pRef[1] = (uint8_t*)pRefPixMap->pPixel[1];
-  m_BgdParam.pRef[2] = (uint8_t*)pRefPixMap->pPixel[2];
-  m_BgdParam.iBgdWidth = pSrcPixMap->sRect.iRectWidth;
-  m_BgdParam.iBgdHeight = pSrcPixMap->sRect.iRectHeight;
-  m_BgdParam.iStride[0] = pSrcPixMap->iStride[0];
-  m_BgdParam.iStride[1] = pSrcPixMap->iStride[1];
-  m_BgdParam.iStride[2] = pSrcPixMap->iStride[2];
-
-  int32_t iCurFrameSize = m_BgdParam.iBgdWidth * m_BgdParam.iBgdHeight;
+  vBGDParam sBgdParam = m_BgdParam;	// per call copy, only the OU array and the results set are kept in the member
+  sBgdParam.pCur[0] = (uint8_t*)pSrcPixMap->pPixel[0];
+  sBgdParam.pCur[1] = (uint8_t*)pSrcPixMap->pPixel[1];
+  sBgdParam.pCur[2] = (uint8_t*)pSrcPixMap->pPixel[2];
+  sBgdParam.pRef[0] = (uint8_t*)pRefPixMap->pPixel[0];
+  sBgdParam.pRef[1] = (uint8_t*)pRefPixMap->pPixel[1];
+  sBgdParam.pRef[2] = (uint8_t*)pRefPixMap->pPixel[2];
+  sBgdParam.iBgdWidth = pSrcPixMap->sRect.iRectWidth;
+  sBgdParam.iBgdHeight = pSrcPixMap->sRect.iRectHeight;
+  sBgdParam.iStride[0] = pSrcPixMap->iStride[0];
+  sBgdParam.iStride[1] = pSrcPixMap->iStride[1];
+  sBgdParam.iStride[2] = pSrcPixMap->iStride[2];
+
+  int32_t iCurFrameSize = sBgdParam.iBgdWidth * sBgdParam.iBgdHeight;
   if (m_BgdParam.pOU_array == NULL || iCurFrameSize > m_iLargestFrameSize) {
     FreeOUArrayMemory();
-    m_BgdParam.pOU_array = AllocateOUArrayMemory (m_BgdParam.iBgdWidth, m_BgdParam.iBgdHeight);
+    m_BgdParam.pOU_array = AllocateOUArrayMemory (sBgdParam.iBgdWidth, sBgdParam.iBgdHeight);
     m_iLargestFrameSize = iCurFrameSize;
   }
+  sBgdParam.pOU_array = m_BgdParam.pOU_array;
 
-  if (m_BgdParam.pOU_array == NULL)
+  if (sBgdParam.pOU_array == NULL)
     return eReturn;
 
-  BackgroundDetection (&m_BgdParam);
+  BackgroundDetection (&sBgdParam);
 
   return RET_SUCCESS;
 }
@@ -158,14 +160,13 @@ void CBackgroundDetection::GetOUParameters (SVAACalcResult* sVaaCalcInfo, int32_
                           WELS_MIN (WELS_MIN (iSubSD[0], iSubSD[1]), WELS_MIN (iSubSD[2], iSubSD[3]));
 }
 
-void CBackgroundDetection::ForegroundBackgroundDivision (vBGDParam* pBgdParam) {
+void CBackgroundDetection::ForegroundBackgroundDivision (vBGDParam* pBgdParam, int32_t iStartRow, int32_t iEndRow) {
   int32_t iPicWidthInOU	= pBgdParam->iBgdWidth  >> LOG2_BGD_OU_SIZE;
-  int32_t iPicHeightInOU	= pBgdParam->iBgdHeight >> LOG2_BGD_OU_SIZE;
   int32_t iPicWidthInMb	= (15 + pBgdParam->iBgdWidth) >> 4;
 
-  SBackgroundOU* pBackgroundOU = pBgdParam->pOU_array;
+  SBackgroundOU* pBackgroundOU = pBgdParam->pOU_array + iStartRow * iPicWidthInOU;
 
-  for (int32_t j = 0; j < iPicHeightInOU; j ++) {
+  for (int32_t j = iStartRow; j < iEndRow; j ++) {
     for (int32_t i = 0; i < iPicWidthInOU; i++) {
       GetOUParameters (pBgdParam->pCalcRes, (j * iPicWidthInMb + i) << (LOG2_BGD_OU_SIZE - LOG2_MB_SIZE), iPicWidthInMb,
                        pBackgroundOU);
@@ -377,11 +378,23 @@ void CBackgroundDetection::ForegroundDilationAndBackgroundErosion (vBGDParam* pB
   }
 }
 
+void CBackgroundDetection::DivisionStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SBgdStripeCtx* pStripeCtx = (SBgdStripeCtx*)pCtx;
+  int32_t iStartRow = 0, iEndRow = 0;
+
+  GetStripeRows (pStripeCtx->pBgdParam->iBgdHeight >> LOG2_BGD_OU_SIZE, kiStripeIdx, kiStripeNum, &iStartRow, &iEndRow);
+  pStripeCtx->pBgd->ForegroundBackgroundDivision (pStripeCtx->pBgdParam, iStartRow, iEndRow);
+}
+
 void CBackgroundDetection::BackgroundDetection (vBGDParam* pBgdParam) {
-  // 1st step: foreground/background coarse division
-  ForegroundBackgroundDivision (pBgdParam);
+  SBgdStripeCtx sCtx;
+  sCtx.pBgd			= this;
+  sCtx.pBgdParam	= pBgdParam;
+
+  // 1st step: foreground/background coarse division, each OU stands alone so OU rows are split into stripes
+  RunStripes (DivisionStripe, &sCtx, GetStripeNum (pBgdParam->iBgdHeight >> LOG2_BGD_OU_SIZE));
 
-  // 2nd step: foreground dilation and background erosion
+  // 2nd step: foreground dilation and background erosion, serial as every OU reads the flags updated before it
   ForegroundDilationAndBackgroundErosion (pBgdParam);
 }
 
@@ -77,6 +77,11 @@ class CBackgroundDetection : public IStrategy {
     SVAACalcResult*  pCalcRes;
   } m_BgdParam;
 
+  struct SBgdStripeCtx {
+    CBackgroundDetection*	pBgd;
+    vBGDParam*				pBgdParam;
+  };
+
   int32_t     m_iLargestFrameSize;
 
  private:
@@ -96,7 +101,8 @@ class CBackgroundDetection : public IStrategy {
 
   void    GetOUParameters (SVAACalcResult* sVaaCalcInfo, int32_t iMbIndex, int32_t iMbWidth,
                            SBackgroundOU* pBackgroundOU);
-  void    ForegroundBackgroundDivision (vBGDParam* pBgdParam);
+  void    ForegroundBackgroundDivision (vBGDParam* pBgdParam, int32_t iStartRow, int32_t iEndRow);
+  static void DivisionStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
   void    ForegroundDilationAndBackgroundErosion (vBGDParam* pBgdParam);
   void    BackgroundDetection (vBGDParam* pBgdParam);
 };
@@ -0,0 +1,220 @@
+/*!
+ * \copy
+ *     Copyright (c)  2011-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "colorspace.h"
+#include "cpu.h"
+
+WELSVP_NAMESPACE_BEGIN
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CColorspaceConvert::CColorspaceConvert (int32_t iCpuFlag) {
+  m_iCPUFlag = iCpuFlag;
+  m_eMethod   = METHOD_COLORSPACE_CONVERT;
+  WelsMemset (&m_pfColorspace, 0, sizeof (m_pfColorspace));
+  InitColorspaceFuncs (m_pfColorspace, m_iCPUFlag);
+}
+
+CColorspaceConvert::~CColorspaceConvert() {
+}
+
+void CColorspaceConvert::InitColorspaceFuncs (SColorspaceFuncs& sColorspaceFuncs, int32_t iCpuFlag) {
+  sColorspaceFuncs.pfRgbToI420	= RgbToI420RowPair_c;
+  sColorspaceFuncs.pfBgrToI420	= BgrToI420RowPair_c;
+  sColorspaceFuncs.pfRgbaToI420	= RgbaToI420RowPair_c;
+  sColorspaceFuncs.pfBgraToI420	= BgraToI420RowPair_c;
+  sColorspaceFuncs.pfArgbToI420	= ArgbToI420RowPair_c;
+  sColorspaceFuncs.pfAbgrToI420	= AbgrToI420RowPair_c;
+  sColorspaceFuncs.pfYuy2ToI420	= Yuy2ToI420RowPair_c;
+  sColorspaceFuncs.pfUyvyToI420	= UyvyToI420RowPair_c;
+  sColorspaceFuncs.pfSplitChroma	= SplitChroma_c;
+#if defined(X86_ASM)
+  if (iCpuFlag & WELS_CPU_SSE2) {
+    sColorspaceFuncs.pfRgbaToI420	= RgbaToI420RowPair_sse2;
+    sColorspaceFuncs.pfBgraToI420	= BgraToI420RowPair_sse2;
+    sColorspaceFuncs.pfArgbToI420	= ArgbToI420RowPair_sse2;
+    sColorspaceFuncs.pfAbgrToI420	= AbgrToI420RowPair_sse2;
+    sColorspaceFuncs.pfYuy2ToI420	= Yuy2ToI420RowPair_sse2;
+    sColorspaceFuncs.pfUyvyToI420	= UyvyToI420RowPair_sse2;
+    sColorspaceFuncs.pfSplitChroma	= SplitChroma_sse2;
+  }
+  if (iCpuFlag & WELS_CPU_SSSE3) {
+    sColorspaceFuncs.pfRgbToI420	= RgbToI420RowPair_ssse3;
+    sColorspaceFuncs.pfBgrToI420	= BgrToI420RowPair_ssse3;
+  }
+  if (iCpuFlag & WELS_CPU_AVX2) {
+    sColorspaceFuncs.pfRgbaToI420	= RgbaToI420RowPair_avx2;
+    sColorspaceFuncs.pfBgraToI420	= BgraToI420RowPair_avx2;
+    sColorspaceFuncs.pfArgbToI420	= ArgbToI420RowPair_avx2;
+    sColorspaceFuncs.pfAbgrToI420	= AbgrToI420RowPair_avx2;
+    sColorspaceFuncs.pfSplitChroma	= SplitChroma_avx2;
+  }
+#endif//X86_ASM
+}
+
+EResult CColorspaceConvert::Process (int32_t iType, SPixMap* pSrc, SPixMap* pDst) {
+  const int32_t kiFormat	= pSrc->eFormat & (~VIDEO_FORMAT_VFlip);
+  const int32_t kiLeft		= pSrc->sRect.iRectLeft & ~1;
+  const int32_t kiTop		= pSrc->sRect.iRectTop & ~1;
+  int32_t iPlaneNum			= 1;	// packed
+  int32_t iBytesPerPixel	= 0;
+  bool bSwapChroma			= false;
+  SColorspaceStripeCtx sCtx;
+
+  WelsMemset (&sCtx, 0, sizeof (sCtx));
+  switch (kiFormat) {
+  case VIDEO_FORMAT_RGB:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfRgbToI420;
+    iBytesPerPixel		= 3;
+    break;
+  case VIDEO_FORMAT_BGR:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfBgrToI420;
+    iBytesPerPixel		= 3;
+    break;
+  case VIDEO_FORMAT_RGBA:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfRgbaToI420;
+    iBytesPerPixel		= 4;
+    break;
+  case VIDEO_FORMAT_BGRA:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfBgraToI420;
+    iBytesPerPixel		= 4;
+    break;
+  case VIDEO_FORMAT_ARGB:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfArgbToI420;
+    iBytesPerPixel		= 4;
+    break;
+  case VIDEO_FORMAT_ABGR:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfAbgrToI420;
+    iBytesPerPixel		= 4;
+    break;
+  case VIDEO_FORMAT_YVYU:
+    bSwapChroma			= true;
+  case VIDEO_FORMAT_YUY2:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfYuy2ToI420;
+    iBytesPerPixel		= 2;
+    break;
+  case VIDEO_FORMAT_UYVY:
+    sCtx.pfPackedToI420	= m_pfColorspace.pfUyvyToI420;
+    iBytesPerPixel		= 2;
+    break;
+  case VIDEO_FORMAT_NV21:
+    bSwapChroma			= true;
+  case VIDEO_FORMAT_NV12:
+    sCtx.pfSplitChroma	= m_pfColorspace.pfSplitChroma;
+    iPlaneNum			= 2;
+    break;
+  case VIDEO_FORMAT_YV12:
+    bSwapChroma			= true;
+  case VIDEO_FORMAT_I420:
+    iPlaneNum			= 3;
+    break;
+  default:
+    return RET_NOTSUPPORTED;
+  }
+
+  sCtx.iWidth	= pSrc->sRect.iRectWidth & ~1;
+  sCtx.iHeight	= pSrc->sRect.iRectHeight & ~1;
+  if (pDst->eFormat != VIDEO_FORMAT_I420 || pDst->pPixel[1] == NULL || pDst->pPixel[2] == NULL
+      || pDst->sRect.iRectWidth < sCtx.iWidth || pDst->sRect.iRectHeight < sCtx.iHeight
+      || sCtx.iWidth <= 0 || sCtx.iHeight <= 0) {
+    return RET_INVALIDPARAM;
+  }
+  if (iPlaneNum == 1 && pSrc->iStride[0] < sCtx.iWidth * iBytesPerPixel) {
+    return RET_INVALIDPARAM;
+  }
+
+  for (int32_t i = 0; i < iPlaneNum; i++) {
+    // chroma planes are subsampled by two in both directions, the interleaved one keeps its width in bytes
+    const int32_t kiShift	= (i == 0) ? 0 : 1;
+    const int32_t kiOffsetX	= (iPlaneNum == 1) ? kiLeft * iBytesPerPixel : ((iPlaneNum == 2) ? kiLeft : kiLeft >> kiShift);
+    const int32_t kiRows		= iPlaneNum == 1 ? sCtx.iHeight : sCtx.iHeight >> kiShift;
+    uint8_t* pPlane			= (uint8_t*)pSrc->pPixel[i];
+
+    if (pPlane == NULL || pSrc->iStride[i] <= 0) {
+      return RET_INVALIDPARAM;
+    }
+    sCtx.pSrc[i]		= pPlane + (kiTop >> kiShift) * pSrc->iStride[i] + kiOffsetX;
+    sCtx.iSrcStride[i]	= pSrc->iStride[i];
+    if (pSrc->eFormat & VIDEO_FORMAT_VFlip) {
+      sCtx.pSrc[i]		+= (kiRows - 1) * sCtx.iSrcStride[i];
+      sCtx.iSrcStride[i]	= -sCtx.iSrcStride[i];
+    }
+  }
+  for (int32_t i = 0; i < 3; i++) {
+    sCtx.pDst[i]		= (uint8_t*)pDst->pPixel[i];
+    sCtx.iDstStride[i]	= pDst->iStride[i];
+  }
+  if (bSwapChroma) {
+    sCtx.pDst[1]	= (uint8_t*)pDst->pPixel[2];
+    sCtx.pDst[2]	= (uint8_t*)pDst->pPixel[1];
+    sCtx.iDstStride[1]	= pDst->iStride[2];
+    sCtx.iDstStride[2]	= pDst->iStride[1];
+  }
+
+  // each stripe is a run of row pairs, i.e. of chroma rows
+  RunStripes (ConvertStripe, &sCtx, GetStripeNum (sCtx.iHeight >> 1));
+
+  return RET_SUCCESS;
+}
+
+void CColorspaceConvert::ConvertStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SColorspaceStripeCtx* pStripeCtx = (SColorspaceStripeCtx*)pCtx;
+  const int32_t kiWidth = pStripeCtx->iWidth;
+  int32_t iStartRow = 0, iEndRow = 0;
+
+  GetStripeRows (pStripeCtx->iHeight >> 1, kiStripeIdx, kiStripeNum, &iStartRow, &iEndRow);
+
+  for (int32_t j = iStartRow; j < iEndRow; j++) {
+    uint8_t* pDstY = pStripeCtx->pDst[0] + (j << 1) * pStripeCtx->iDstStride[0];
+    uint8_t* pDstU = pStripeCtx->pDst[1] + j * pStripeCtx->iDstStride[1];
+    uint8_t* pDstV = pStripeCtx->pDst[2] + j * pStripeCtx->iDstStride[2];
+    const uint8_t* pSrcY = pStripeCtx->pSrc[0] + (j << 1) * pStripeCtx->iSrcStride[0];
+
+    if (pStripeCtx->pfPackedToI420) {
+      pStripeCtx->pfPackedToI420 (pDstY, pStripeCtx->iDstStride[0], pDstU, pDstV, pSrcY, pStripeCtx->iSrcStride[0], kiWidth);
+      continue;
+    }
+
+    WelsMemcpy (pDstY, pSrcY, kiWidth);
+    WelsMemcpy (pDstY + pStripeCtx->iDstStride[0], pSrcY + pStripeCtx->iSrcStride[0], kiWidth);
+    if (pStripeCtx->pfSplitChroma) {
+      pStripeCtx->pfSplitChroma (pDstU, pDstV, pStripeCtx->pSrc[1] + j * pStripeCtx->iSrcStride[1], kiWidth >> 1);
+    } else {
+      WelsMemcpy (pDstU, pStripeCtx->pSrc[1] + j * pStripeCtx->iSrcStride[1], kiWidth >> 1);
+      WelsMemcpy (pDstV, pStripeCtx->pSrc[2] + j * pStripeCtx->iSrcStride[2], kiWidth >> 1);
+    }
+  }
+}
+
+
+WELSVP_NAMESPACE_END
@@ -0,0 +1,153 @@
+/*!
+ * \copy
+ *     Copyright (c)  2011-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file	    :  colorspace.h
+ *
+ * \brief	    :  colorspace conversion class of wels video processor class
+ *
+ * \date        :  2014/10/18
+ *
+ * \description :  1. conversion of the packed rgb, packed yuv 4:2:2 and semi-planar yuv 4:2:0 input to i420
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELSVP_COLORSPACE_H
+#define WELSVP_COLORSPACE_H
+
+#include "util.h"
+#include "memory.h"
+#include "WelsFrameWork.h"
+#include "IWelsVP.h"
+
+WELSVP_NAMESPACE_BEGIN
+
+/*
+ *	bt.601 studio swing, chroma from the rgb average of each 2x2 block:
+ *	y = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16
+ *	u = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128
+ *	v = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128
+ */
+#define CSC_RGB2Y(r, g, b)	(((66 * (r) + 129 * (g) + 25 * (b) + 128) >> 8) + 16)
+#define CSC_RGB2U(r, g, b)	(((-38 * (r) - 74 * (g) + 112 * (b) + 128) >> 8) + 128)
+#define CSC_RGB2V(r, g, b)	(((112 * (r) - 94 * (g) - 18 * (b) + 128) >> 8) + 128)
+
+/*!
+ * \brief	convert two source rows of a packed format into two luma rows and one row of each chroma component
+ * \param	kiWidth	width in pixels, even
+ */
+typedef void (PackedToI420Func) (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                 const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth);
+
+/*!
+ * \brief	deinterleave one row of semi-planar chroma
+ * \param	kiWidth	samples per chroma component
+ */
+typedef void (SplitChromaFunc) (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* pSrcUV, const int32_t kiWidth);
+
+typedef PackedToI420Func*	PPackedToI420Func;
+typedef SplitChromaFunc*	PSplitChromaFunc;
+
+// byte order in memory, i.e. rgba is r first
+PackedToI420Func	RgbToI420RowPair_c;
+PackedToI420Func	BgrToI420RowPair_c;
+PackedToI420Func	RgbaToI420RowPair_c;
+PackedToI420Func	BgraToI420RowPair_c;
+PackedToI420Func	ArgbToI420RowPair_c;
+PackedToI420Func	AbgrToI420RowPair_c;
+// yvyu is yuy2 with the chroma components swapped
+PackedToI420Func	Yuy2ToI420RowPair_c;
+PackedToI420Func	UyvyToI420RowPair_c;
+// nv21 is nv12 with the chroma components swapped
+SplitChromaFunc		SplitChroma_c;
+
+#ifdef X86_ASM
+PackedToI420Func	RgbToI420RowPair_ssse3;
+PackedToI420Func	BgrToI420RowPair_ssse3;
+PackedToI420Func	RgbaToI420RowPair_sse2;
+PackedToI420Func	BgraToI420RowPair_sse2;
+PackedToI420Func	ArgbToI420RowPair_sse2;
+PackedToI420Func	AbgrToI420RowPair_sse2;
+PackedToI420Func	RgbaToI420RowPair_avx2;
+PackedToI420Func	BgraToI420RowPair_avx2;
+PackedToI420Func	ArgbToI420RowPair_avx2;
+PackedToI420Func	AbgrToI420RowPair_avx2;
+PackedToI420Func	Yuy2ToI420RowPair_sse2;
+PackedToI420Func	UyvyToI420RowPair_sse2;
+SplitChromaFunc		SplitChroma_sse2;
+SplitChromaFunc		SplitChroma_avx2;
+#endif
+
+typedef struct TagColorspaceFuncs {
+  PPackedToI420Func	pfRgbToI420;
+  PPackedToI420Func	pfBgrToI420;
+  PPackedToI420Func	pfRgbaToI420;
+  PPackedToI420Func	pfBgraToI420;
+  PPackedToI420Func	pfArgbToI420;
+  PPackedToI420Func	pfAbgrToI420;
+  PPackedToI420Func	pfYuy2ToI420;
+  PPackedToI420Func	pfUyvyToI420;
+  PSplitChromaFunc	pfSplitChroma;
+} SColorspaceFuncs;
+
+typedef struct TagColorspaceStripeCtx {
+  PPackedToI420Func	pfPackedToI420;	// packed sources
+  PSplitChromaFunc	pfSplitChroma;	// semi-planar sources, planar ones are copied if both are NULL
+  uint8_t*	pSrc[3];			// top row of the rectangle, negative strides for the flipped sources
+  int32_t		iSrcStride[3];
+  uint8_t*	pDst[3];			// chroma components swapped for the sources storing v first
+  int32_t		iDstStride[3];
+  int32_t		iWidth;
+  int32_t		iHeight;
+} SColorspaceStripeCtx;
+
+class CColorspaceConvert : public IStrategy {
+ public:
+  CColorspaceConvert (int32_t iCpuFlag);
+  ~CColorspaceConvert();
+
+  /*!
+   * \brief	convert the rectangle of pSrc into the top left of the i420 pDst, with the rectangle in memory
+   *			coordinates of the source and its origin, width and height rounded down to even
+   */
+  EResult Process (int32_t iType, SPixMap* pSrc, SPixMap* pDst);
+
+ private:
+  void InitColorspaceFuncs (SColorspaceFuncs& sColorspaceFuncs, int32_t iCpuFlag);
+  static void ConvertStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
+
+ private:
+  SColorspaceFuncs m_pfColorspace;
+  int32_t  m_iCPUFlag;
+};
+
+WELSVP_NAMESPACE_END
+
+#endif
@@ -0,0 +1,140 @@
+/*!
+ * \copy
+ *     Copyright (c)  2011-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  colorspacefuncs.cpp
+ *
+ *  Abstract
+ *      Conversion of packed and semi-planar source rows to i420.
+ *
+ *  History
+ *      10/18/2014 Created
+ *
+ *****************************************************************************/
+
+#include "colorspace.h"
+
+
+WELSVP_NAMESPACE_BEGIN
+
+
+static inline void RgbToI420RowPair (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                     const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                                     const int32_t kiBytesPerPixel, const int32_t kiOffsetR, const int32_t kiOffsetG, const int32_t kiOffsetB) {
+  const uint8_t* pSrc1 = pSrc + kiSrcStride;
+  uint8_t* pDstY1 = pDstY + kiDstStrideY;
+
+  for (int32_t i = 0; i < kiWidth; i += 2) {
+    const uint8_t* p00 = pSrc + i * kiBytesPerPixel;
+    const uint8_t* p01 = p00 + kiBytesPerPixel;
+    const uint8_t* p10 = pSrc1 + i * kiBytesPerPixel;
+    const uint8_t* p11 = p10 + kiBytesPerPixel;
+
+    pDstY[i]		= CSC_RGB2Y (p00[kiOffsetR], p00[kiOffsetG], p00[kiOffsetB]);
+    pDstY[i + 1]	= CSC_RGB2Y (p01[kiOffsetR], p01[kiOffsetG], p01[kiOffsetB]);
+    pDstY1[i]		= CSC_RGB2Y (p10[kiOffsetR], p10[kiOffsetG], p10[kiOffsetB]);
+    pDstY1[i + 1]	= CSC_RGB2Y (p11[kiOffsetR], p11[kiOffsetG], p11[kiOffsetB]);
+
+    const int32_t kiR = (p00[kiOffsetR] + p01[kiOffsetR] + p10[kiOffsetR] + p11[kiOffsetR] + 2) >> 2;
+    const int32_t kiG = (p00[kiOffsetG] + p01[kiOffsetG] + p10[kiOffsetG] + p11[kiOffsetG] + 2) >> 2;
+    const int32_t kiB = (p00[kiOffsetB] + p01[kiOffsetB] + p10[kiOffsetB] + p11[kiOffsetB] + 2) >> 2;
+    pDstU[i >> 1]	= CSC_RGB2U (kiR, kiG, kiB);
+    pDstV[i >> 1]	= CSC_RGB2V (kiR, kiG, kiB);
+  }
+}
+
+void RgbToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                         const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  RgbToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 3, 0, 1, 2);
+}
+
+void BgrToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                         const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  RgbToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 3, 2, 1, 0);
+}
+
+void RgbaToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                          const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  RgbToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 4, 0, 1, 2);
+}
+
+void BgraToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                          const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  RgbToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 4, 2, 1, 0);
+}
+
+void ArgbToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                          const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  RgbToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 4, 1, 2, 3);
+}
+
+void AbgrToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                          const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  RgbToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 4, 3, 2, 1);
+}
+
+/*
+ *	4:2:2 to 4:2:0 takes the rounded average of the chroma of both rows
+ */
+static inline void Yuv422ToI420RowPair (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                        const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                                        const int32_t kiOffsetY, const int32_t kiOffsetU, const int32_t kiOffsetV) {
+  const uint8_t* pSrc1 = pSrc + kiSrcStride;
+  uint8_t* pDstY1 = pDstY + kiDstStrideY;
+
+  for (int32_t i = 0; i < kiWidth; i += 2) {
+    const int32_t kiX = i << 1;
+
+    pDstY[i]		= pSrc[kiX + kiOffsetY];
+    pDstY[i + 1]	= pSrc[kiX + kiOffsetY + 2];
+    pDstY1[i]		= pSrc1[kiX + kiOffsetY];
+    pDstY1[i + 1]	= pSrc1[kiX + kiOffsetY + 2];
+    pDstU[i >> 1]	= (pSrc[kiX + kiOffsetU] + pSrc1[kiX + kiOffsetU] + 1) >> 1;
+    pDstV[i >> 1]	= (pSrc[kiX + kiOffsetV] + pSrc1[kiX + kiOffsetV] + 1) >> 1;
+  }
+}
+
+void Yuy2ToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                          const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Yuv422ToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 0, 1, 3);
+}
+
+void UyvyToI420RowPair_c (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                          const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Yuv422ToI420RowPair (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 1, 0, 2);
+}
+
+void SplitChroma_c (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* pSrcUV, const int32_t kiWidth) {
+  for (int32_t i = 0; i < kiWidth; i++) {
+    pDstU[i] = pSrcUV[i << 1];
+    pDstV[i] = pSrcUV[ (i << 1) + 1];
+  }
+}
+
+WELSVP_NAMESPACE_END
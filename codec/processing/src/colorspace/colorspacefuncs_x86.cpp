@@ -0,0 +1,384 @@
+/*!
+ * \copy
+ *     Copyright (c)  2011-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  colorspacefuncs_x86.cpp
+ *
+ *  Abstract
+ *      SSE2/SSSE3/AVX2 conversion of packed and semi-planar source rows to i420, bit exact with the c versions.
+ *
+ *  History
+ *      10/18/2014 Created
+ *
+ *****************************************************************************/
+
+#include "colorspace.h"
+
+#ifdef X86_ASM
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+#define WELSVP_TARGET(kpIsa)	__attribute__ ((target (kpIsa)))
+#else
+#define WELSVP_TARGET(kpIsa)
+#endif//__GNUC__
+
+WELSVP_NAMESPACE_BEGIN
+
+/*
+ *	rgb: the luma sum of positive terms stays below 1 << 16, so it is done in wrapping 16 bit lanes and shifted
+ *	logically; the chroma sums of the 8 bit averages stay within int16 and are shifted arithmetically
+ */
+
+WELSVP_TARGET ("sse2")
+static inline __m128i RgbToY_sse2 (const __m128i kvR, const __m128i kvG, const __m128i kvB) {
+  __m128i vY = _mm_add_epi16 (_mm_mullo_epi16 (kvR, _mm_set1_epi16 (66)), _mm_mullo_epi16 (kvG, _mm_set1_epi16 (129)));
+  vY = _mm_add_epi16 (vY, _mm_add_epi16 (_mm_mullo_epi16 (kvB, _mm_set1_epi16 (25)), _mm_set1_epi16 (128)));
+  return _mm_add_epi16 (_mm_srli_epi16 (vY, 8), _mm_set1_epi16 (16));
+}
+
+WELSVP_TARGET ("sse2")
+static inline __m128i RgbToChroma_sse2 (const __m128i kvR, const __m128i kvG, const __m128i kvB,
+                                        const int16_t kiCoefR, const int16_t kiCoefG, const int16_t kiCoefB) {
+  __m128i vC = _mm_add_epi16 (_mm_mullo_epi16 (kvR, _mm_set1_epi16 (kiCoefR)), _mm_mullo_epi16 (kvG,
+                              _mm_set1_epi16 (kiCoefG)));
+  vC = _mm_add_epi16 (vC, _mm_add_epi16 (_mm_mullo_epi16 (kvB, _mm_set1_epi16 (kiCoefB)), _mm_set1_epi16 (128)));
+  return _mm_add_epi16 (_mm_srai_epi16 (vC, 8), _mm_set1_epi16 (128));
+}
+
+// rounded average of the 2x2 blocks of two rows of 8 words, in the low 4 words
+WELSVP_TARGET ("sse2")
+static inline __m128i Average2x2_sse2 (const __m128i kvRow0, const __m128i kvRow1) {
+  __m128i vSum = _mm_madd_epi16 (_mm_add_epi16 (kvRow0, kvRow1), _mm_set1_epi16 (1));
+  vSum = _mm_srli_epi32 (_mm_add_epi32 (vSum, _mm_set1_epi32 (2)), 2);
+  return _mm_packs_epi32 (vSum, vSum);
+}
+
+// 8 pixels of both rows, each given as two registers of 4 pixels with one channel per byte of the dword
+WELSVP_TARGET ("sse2")
+static inline void Rgb32ToI420x8_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                       const __m128i kvRow0Lo, const __m128i kvRow0Hi, const __m128i kvRow1Lo, const __m128i kvRow1Hi,
+                                       const int32_t kiShiftR, const int32_t kiShiftG, const int32_t kiShiftB) {
+  const __m128i kvMask = _mm_set1_epi32 (0xff);
+#define CHANNEL_OF(kvLo, kvHi, kiShift) \
+  _mm_packs_epi32 (_mm_and_si128 (_mm_srli_epi32 (kvLo, kiShift), kvMask), _mm_and_si128 (_mm_srli_epi32 (kvHi, kiShift), kvMask))
+  const __m128i kvR0 = CHANNEL_OF (kvRow0Lo, kvRow0Hi, kiShiftR);
+  const __m128i kvG0 = CHANNEL_OF (kvRow0Lo, kvRow0Hi, kiShiftG);
+  const __m128i kvB0 = CHANNEL_OF (kvRow0Lo, kvRow0Hi, kiShiftB);
+  const __m128i kvR1 = CHANNEL_OF (kvRow1Lo, kvRow1Hi, kiShiftR);
+  const __m128i kvG1 = CHANNEL_OF (kvRow1Lo, kvRow1Hi, kiShiftG);
+  const __m128i kvB1 = CHANNEL_OF (kvRow1Lo, kvRow1Hi, kiShiftB);
+#undef CHANNEL_OF
+
+  const __m128i kvY = _mm_packus_epi16 (RgbToY_sse2 (kvR0, kvG0, kvB0), RgbToY_sse2 (kvR1, kvG1, kvB1));
+  _mm_storel_epi64 ((__m128i*)pDstY, kvY);
+  _mm_storel_epi64 ((__m128i*) (pDstY + kiDstStrideY), _mm_srli_si128 (kvY, 8));
+
+  const __m128i kvR = Average2x2_sse2 (kvR0, kvR1);
+  const __m128i kvG = Average2x2_sse2 (kvG0, kvG1);
+  const __m128i kvB = Average2x2_sse2 (kvB0, kvB1);
+  const __m128i kvUV = _mm_packus_epi16 (RgbToChroma_sse2 (kvR, kvG, kvB, -38, -74, 112),
+                                         RgbToChroma_sse2 (kvR, kvG, kvB, 112, -94, -18));
+  * (int32_t*)pDstU = _mm_cvtsi128_si32 (kvUV);
+  * (int32_t*)pDstV = _mm_cvtsi128_si32 (_mm_srli_si128 (kvUV, 8));
+}
+
+WELSVP_TARGET ("sse2")
+static inline void Rgb32ToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+    const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+    const int32_t kiShiftR, const int32_t kiShiftG, const int32_t kiShiftB, PPackedToI420Func pfTail) {
+  int32_t i = 0;
+  for (; i + 8 <= kiWidth; i += 8) {
+    const uint8_t* pSrc0 = pSrc + (i << 2);
+    const uint8_t* pSrc1 = pSrc0 + kiSrcStride;
+    Rgb32ToI420x8_sse2 (pDstY + i, kiDstStrideY, pDstU + (i >> 1), pDstV + (i >> 1),
+                        _mm_loadu_si128 ((const __m128i*)pSrc0), _mm_loadu_si128 ((const __m128i*) (pSrc0 + 16)),
+                        _mm_loadu_si128 ((const __m128i*)pSrc1), _mm_loadu_si128 ((const __m128i*) (pSrc1 + 16)),
+                        kiShiftR, kiShiftG, kiShiftB);
+  }
+  if (i < kiWidth)
+    pfTail (pDstY + i, kiDstStrideY, pDstU + (i >> 1), pDstV + (i >> 1), pSrc + (i << 2), kiSrcStride, kiWidth - i);
+}
+
+WELSVP_TARGET ("sse2")
+void RgbaToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_sse2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 0, 8, 16, RgbaToI420RowPair_c);
+}
+
+WELSVP_TARGET ("sse2")
+void BgraToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_sse2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 16, 8, 0, BgraToI420RowPair_c);
+}
+
+WELSVP_TARGET ("sse2")
+void ArgbToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_sse2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 8, 16, 24, ArgbToI420RowPair_c);
+}
+
+WELSVP_TARGET ("sse2")
+void AbgrToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_sse2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 24, 16, 8, AbgrToI420RowPair_c);
+}
+
+/*
+ *	24 bit rgb: pshufb spreads 4 pixels to dwords, the second half of 8 pixels is loaded from byte 8 so that
+ *	nothing past the pixels converted is read
+ */
+
+WELSVP_TARGET ("ssse3")
+static inline void Rgb24ToI420RowPair_ssse3 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+    const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+    const int32_t kiShiftR, const int32_t kiShiftG, const int32_t kiShiftB, PPackedToI420Func pfTail) {
+  const __m128i kvShuffleLo = _mm_setr_epi8 (0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i kvShuffleHi = _mm_setr_epi8 (4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1);
+  int32_t i = 0;
+  for (; i + 8 <= kiWidth; i += 8) {
+    const uint8_t* pSrc0 = pSrc + i * 3;
+    const uint8_t* pSrc1 = pSrc0 + kiSrcStride;
+    Rgb32ToI420x8_sse2 (pDstY + i, kiDstStrideY, pDstU + (i >> 1), pDstV + (i >> 1),
+                        _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*)pSrc0), kvShuffleLo),
+                        _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc0 + 8)), kvShuffleHi),
+                        _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*)pSrc1), kvShuffleLo),
+                        _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc1 + 8)), kvShuffleHi),
+                        kiShiftR, kiShiftG, kiShiftB);
+  }
+  if (i < kiWidth)
+    pfTail (pDstY + i, kiDstStrideY, pDstU + (i >> 1), pDstV + (i >> 1), pSrc + i * 3, kiSrcStride, kiWidth - i);
+}
+
+WELSVP_TARGET ("ssse3")
+void RgbToI420RowPair_ssse3 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb24ToI420RowPair_ssse3 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 0, 8, 16, RgbToI420RowPair_c);
+}
+
+WELSVP_TARGET ("ssse3")
+void BgrToI420RowPair_ssse3 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb24ToI420RowPair_ssse3 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 16, 8, 0, BgrToI420RowPair_c);
+}
+
+/*
+ *	avx2 32 bit rgb: 16 pixels per row pair, the in-lane packs are put back in order with permutes
+ */
+
+WELSVP_TARGET ("avx2")
+static inline __m256i RgbToY_avx2 (const __m256i kvR, const __m256i kvG, const __m256i kvB) {
+  __m256i vY = _mm256_add_epi16 (_mm256_mullo_epi16 (kvR, _mm256_set1_epi16 (66)),
+                                 _mm256_mullo_epi16 (kvG, _mm256_set1_epi16 (129)));
+  vY = _mm256_add_epi16 (vY, _mm256_add_epi16 (_mm256_mullo_epi16 (kvB, _mm256_set1_epi16 (25)),
+                         _mm256_set1_epi16 (128)));
+  return _mm256_add_epi16 (_mm256_srli_epi16 (vY, 8), _mm256_set1_epi16 (16));
+}
+
+WELSVP_TARGET ("avx2")
+static inline __m256i RgbToChroma_avx2 (const __m256i kvR, const __m256i kvG, const __m256i kvB,
+                                        const int16_t kiCoefR, const int16_t kiCoefG, const int16_t kiCoefB) {
+  __m256i vC = _mm256_add_epi16 (_mm256_mullo_epi16 (kvR, _mm256_set1_epi16 (kiCoefR)),
+                                 _mm256_mullo_epi16 (kvG, _mm256_set1_epi16 (kiCoefG)));
+  vC = _mm256_add_epi16 (vC, _mm256_add_epi16 (_mm256_mullo_epi16 (kvB, _mm256_set1_epi16 (kiCoefB)),
+                         _mm256_set1_epi16 (128)));
+  return _mm256_add_epi16 (_mm256_srai_epi16 (vC, 8), _mm256_set1_epi16 (128));
+}
+
+// rounded average of the 2x2 blocks of two rows of 16 words, 4 per lane in the low words of each lane
+WELSVP_TARGET ("avx2")
+static inline __m256i Average2x2_avx2 (const __m256i kvRow0, const __m256i kvRow1) {
+  __m256i vSum = _mm256_madd_epi16 (_mm256_add_epi16 (kvRow0, kvRow1), _mm256_set1_epi16 (1));
+  vSum = _mm256_srli_epi32 (_mm256_add_epi32 (vSum, _mm256_set1_epi32 (2)), 2);
+  return _mm256_packs_epi32 (vSum, vSum);
+}
+
+// one channel of 16 pixels as words in order, from two registers of 8 pixels
+WELSVP_TARGET ("avx2")
+static inline __m256i Rgb32Channel_avx2 (const __m256i kvLo, const __m256i kvHi, const int32_t kiShift) {
+  const __m256i kvMask = _mm256_set1_epi32 (0xff);
+  const __m256i kvPacked = _mm256_packs_epi32 (_mm256_and_si256 (_mm256_srli_epi32 (kvLo, kiShift), kvMask),
+                           _mm256_and_si256 (_mm256_srli_epi32 (kvHi, kiShift), kvMask));
+  return _mm256_permute4x64_epi64 (kvPacked, 0xd8);
+}
+
+WELSVP_TARGET ("avx2")
+static inline void Rgb32ToI420RowPair_avx2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+    const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+    const int32_t kiShiftR, const int32_t kiShiftG, const int32_t kiShiftB, PPackedToI420Func pfTail) {
+  // dwords 0 and 4 hold u of either lane, 2 and 6 v
+  const __m256i kvChromaOrder = _mm256_setr_epi32 (0, 4, 2, 6, 1, 5, 3, 7);
+  int32_t i = 0;
+  for (; i + 16 <= kiWidth; i += 16) {
+    const uint8_t* pSrc0 = pSrc + (i << 2);
+    const uint8_t* pSrc1 = pSrc0 + kiSrcStride;
+    const __m256i kvRow0Lo = _mm256_loadu_si256 ((const __m256i*)pSrc0);
+    const __m256i kvRow0Hi = _mm256_loadu_si256 ((const __m256i*) (pSrc0 + 32));
+    const __m256i kvRow1Lo = _mm256_loadu_si256 ((const __m256i*)pSrc1);
+    const __m256i kvRow1Hi = _mm256_loadu_si256 ((const __m256i*) (pSrc1 + 32));
+    const __m256i kvR0 = Rgb32Channel_avx2 (kvRow0Lo, kvRow0Hi, kiShiftR);
+    const __m256i kvG0 = Rgb32Channel_avx2 (kvRow0Lo, kvRow0Hi, kiShiftG);
+    const __m256i kvB0 = Rgb32Channel_avx2 (kvRow0Lo, kvRow0Hi, kiShiftB);
+    const __m256i kvR1 = Rgb32Channel_avx2 (kvRow1Lo, kvRow1Hi, kiShiftR);
+    const __m256i kvG1 = Rgb32Channel_avx2 (kvRow1Lo, kvRow1Hi, kiShiftG);
+    const __m256i kvB1 = Rgb32Channel_avx2 (kvRow1Lo, kvRow1Hi, kiShiftB);
+
+    const __m256i kvY = _mm256_permute4x64_epi64 (_mm256_packus_epi16 (RgbToY_avx2 (kvR0, kvG0, kvB0),
+                        RgbToY_avx2 (kvR1, kvG1, kvB1)), 0xd8);
+    _mm_storeu_si128 ((__m128i*) (pDstY + i), _mm256_castsi256_si128 (kvY));
+    _mm_storeu_si128 ((__m128i*) (pDstY + i + kiDstStrideY), _mm256_extracti128_si256 (kvY, 1));
+
+    const __m256i kvR = Average2x2_avx2 (kvR0, kvR1);
+    const __m256i kvG = Average2x2_avx2 (kvG0, kvG1);
+    const __m256i kvB = Average2x2_avx2 (kvB0, kvB1);
+    const __m128i kvUV = _mm256_castsi256_si128 (_mm256_permutevar8x32_epi32 (_mm256_packus_epi16 (
+                           RgbToChroma_avx2 (kvR, kvG, kvB, -38, -74, 112), RgbToChroma_avx2 (kvR, kvG, kvB, 112, -94, -18)),
+                         kvChromaOrder));
+    _mm_storel_epi64 ((__m128i*) (pDstU + (i >> 1)), kvUV);
+    _mm_storel_epi64 ((__m128i*) (pDstV + (i >> 1)), _mm_srli_si128 (kvUV, 8));
+  }
+  if (i < kiWidth)
+    pfTail (pDstY + i, kiDstStrideY, pDstU + (i >> 1), pDstV + (i >> 1), pSrc + (i << 2), kiSrcStride, kiWidth - i);
+}
+
+WELSVP_TARGET ("avx2")
+void RgbaToI420RowPair_avx2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_avx2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 0, 8, 16, RgbaToI420RowPair_sse2);
+}
+
+WELSVP_TARGET ("avx2")
+void BgraToI420RowPair_avx2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_avx2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 16, 8, 0, BgraToI420RowPair_sse2);
+}
+
+WELSVP_TARGET ("avx2")
+void ArgbToI420RowPair_avx2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_avx2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 8, 16, 24, ArgbToI420RowPair_sse2);
+}
+
+WELSVP_TARGET ("avx2")
+void AbgrToI420RowPair_avx2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Rgb32ToI420RowPair_avx2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, 24, 16, 8, AbgrToI420RowPair_sse2);
+}
+
+/*
+ *	packed 4:2:2: luma and chroma bytes are split into words, the chroma of both rows averaged by pavgw
+ */
+
+WELSVP_TARGET ("sse2")
+static inline void Yuv422ToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU,
+    uint8_t* pDstV, const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+    const bool kbLumaFirst, PPackedToI420Func pfTail) {
+  const __m128i kvLowBytes = _mm_set1_epi16 (0x00ff);
+  const __m128i kvLowWords = _mm_set1_epi32 (0xffff);
+  int32_t i = 0;
+  for (; i + 16 <= kiWidth; i += 16) {
+    const uint8_t* pSrc0 = pSrc + (i << 1);
+    const uint8_t* pSrc1 = pSrc0 + kiSrcStride;
+    __m128i vChroma[2];
+    for (int32_t k = 0; k < 2; k++) {
+      const __m128i kvRow0 = _mm_loadu_si128 ((const __m128i*) (pSrc0 + (k << 4)));
+      const __m128i kvRow1 = _mm_loadu_si128 ((const __m128i*) (pSrc1 + (k << 4)));
+      const __m128i kvEven = _mm_packus_epi16 (_mm_and_si128 (kvRow0, kvLowBytes), _mm_and_si128 (kvRow1, kvLowBytes));
+      const __m128i kvOdd  = _mm_packus_epi16 (_mm_srli_epi16 (kvRow0, 8), _mm_srli_epi16 (kvRow1, 8));
+      const __m128i kvY    = kbLumaFirst ? kvEven : kvOdd;
+      const __m128i kvC    = kbLumaFirst ? kvOdd : kvEven;
+      _mm_storel_epi64 ((__m128i*) (pDstY + i + (k << 3)), kvY);
+      _mm_storel_epi64 ((__m128i*) (pDstY + i + (k << 3) + kiDstStrideY), _mm_srli_si128 (kvY, 8));
+      // u v pairs of both rows, averaged as words
+      vChroma[k] = _mm_avg_epu16 (_mm_unpacklo_epi8 (kvC, _mm_setzero_si128()), _mm_unpackhi_epi8 (kvC,
+                                  _mm_setzero_si128()));
+    }
+    const __m128i kvU = _mm_packs_epi32 (_mm_and_si128 (vChroma[0], kvLowWords), _mm_and_si128 (vChroma[1], kvLowWords));
+    const __m128i kvV = _mm_packs_epi32 (_mm_srli_epi32 (vChroma[0], 16), _mm_srli_epi32 (vChroma[1], 16));
+    const __m128i kvUV = _mm_packus_epi16 (kvU, kvV);
+    _mm_storel_epi64 ((__m128i*) (pDstU + (i >> 1)), kvUV);
+    _mm_storel_epi64 ((__m128i*) (pDstV + (i >> 1)), _mm_srli_si128 (kvUV, 8));
+  }
+  if (i < kiWidth)
+    pfTail (pDstY + i, kiDstStrideY, pDstU + (i >> 1), pDstV + (i >> 1), pSrc + (i << 1), kiSrcStride, kiWidth - i);
+}
+
+WELSVP_TARGET ("sse2")
+void Yuy2ToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Yuv422ToI420RowPair_sse2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, true, Yuy2ToI420RowPair_c);
+}
+
+WELSVP_TARGET ("sse2")
+void UyvyToI420RowPair_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                             const uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth) {
+  Yuv422ToI420RowPair_sse2 (pDstY, kiDstStrideY, pDstU, pDstV, pSrc, kiSrcStride, kiWidth, false, UyvyToI420RowPair_c);
+}
+
+/*
+ *	semi-planar chroma
+ */
+
+WELSVP_TARGET ("sse2")
+void SplitChroma_sse2 (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* pSrcUV, const int32_t kiWidth) {
+  const __m128i kvLowBytes = _mm_set1_epi16 (0x00ff);
+  int32_t i = 0;
+  for (; i + 16 <= kiWidth; i += 16) {
+    const __m128i kvLo = _mm_loadu_si128 ((const __m128i*) (pSrcUV + (i << 1)));
+    const __m128i kvHi = _mm_loadu_si128 ((const __m128i*) (pSrcUV + (i << 1) + 16));
+    _mm_storeu_si128 ((__m128i*) (pDstU + i), _mm_packus_epi16 (_mm_and_si128 (kvLo, kvLowBytes),
+                      _mm_and_si128 (kvHi, kvLowBytes)));
+    _mm_storeu_si128 ((__m128i*) (pDstV + i), _mm_packus_epi16 (_mm_srli_epi16 (kvLo, 8), _mm_srli_epi16 (kvHi, 8)));
+  }
+  if (i < kiWidth)
+    SplitChroma_c (pDstU + i, pDstV + i, pSrcUV + (i << 1), kiWidth - i);
+}
+
+WELSVP_TARGET ("avx2")
+void SplitChroma_avx2 (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* pSrcUV, const int32_t kiWidth) {
+  const __m256i kvLowBytes = _mm256_set1_epi16 (0x00ff);
+  int32_t i = 0;
+  for (; i + 32 <= kiWidth; i += 32) {
+    const __m256i kvLo = _mm256_loadu_si256 ((const __m256i*) (pSrcUV + (i << 1)));
+    const __m256i kvHi = _mm256_loadu_si256 ((const __m256i*) (pSrcUV + (i << 1) + 32));
+    const __m256i kvU = _mm256_packus_epi16 (_mm256_and_si256 (kvLo, kvLowBytes), _mm256_and_si256 (kvHi, kvLowBytes));
+    const __m256i kvV = _mm256_packus_epi16 (_mm256_srli_epi16 (kvLo, 8), _mm256_srli_epi16 (kvHi, 8));
+    _mm256_storeu_si256 ((__m256i*) (pDstU + i), _mm256_permute4x64_epi64 (kvU, 0xd8));
+    _mm256_storeu_si256 ((__m256i*) (pDstV + i), _mm256_permute4x64_epi64 (kvV, 0xd8));
+  }
+  if (i < kiWidth)
+    SplitChroma_sse2 (pDstU + i, pDstV + i, pSrcUV + (i << 1), kiWidth - i);
+}
+
+WELSVP_NAMESPACE_END
+
+#endif//X86_ASM
@@ -31,6 +31,7 @@
  */
 
 #include "WelsFrameWork.h"
+#include "../colorspace/colorspace.h"
 #include "../denoise/denoise.h"
 #include "../downsample/downsample.h"
 #include "../scenechangedetection/SceneChangeDetection.h"
@@ -96,12 +97,12 @@ CVpFrameWork::CVpFrameWork (uint32_t uiThreadsNum, EResult& eReturn) {
   for (int32_t i = 0; i < MAX_STRATEGY_NUM; i++) {
     IStrategy* pStrategy = m_pStgChain[i];
     pStrategy = CreateStrategy (WelsStaticCast (EMethods, i + 1), uiCPUFlag);
+    if (pStrategy)
+      pStrategy->m_pStripeRunner = &m_cStripeRunner;
     m_pStgChain[i] = pStrategy;
   }
 
-  WelsMutexInit (&m_mutes);
-
-  eReturn = RET_SUCCESS;
+  eReturn = m_cStripeRunner.SetThreadsNum (WELS_MAX (1, (int32_t)uiThreadsNum));
 }
 
 CVpFrameWork::~CVpFrameWork() {
@@ -111,8 +112,6 @@ CVpFrameWork::~CVpFrameWork() {
       _SafeDelete (m_pStgChain[i]);
     }
   }
-
-  WelsMutexDestroy (&m_mutes);
 }
 
 EResult CVpFrameWork::Init (int32_t iType, void* pCfg) {
@@ -121,14 +120,10 @@ EResult CVpFrameWork::Init (int32_t iType, void* pCfg) {
 
   Uninit (iType);
 
-  WelsMutexLock (&m_mutes);
-
   IStrategy* pStrategy = m_pStgChain[iCurIdx];
   if (pStrategy)
     eReturn = pStrategy->Init (0, pCfg);
 
-  WelsMutexUnlock (&m_mutes);
-
   return eReturn;
 }
 
@@ -136,14 +131,10 @@ EResult CVpFrameWork::Uninit (int32_t iType) {
   EResult eReturn        = RET_SUCCESS;
   int32_t iCurIdx    = WelsStaticCast (int32_t, WelsVpGetValidMethod (iType)) - 1;
 
-  WelsMutexLock (&m_mutes);
-
   IStrategy* pStrategy = m_pStgChain[iCurIdx];
   if (pStrategy)
     eReturn = pStrategy->Uninit (0);
 
-  WelsMutexUnlock (&m_mutes);
-
   return eReturn;
 }
 
@@ -167,14 +158,10 @@ EResult CVpFrameWork::Process (int32_t iType, SPixMap* pSrcPixMap, SPixMap* pDst
   if (!CheckValid (eMethod, sSrcPic, sDstPic))
     return RET_INVALIDPARAM;
 
-  WelsMutexLock (&m_mutes);
-
   IStrategy* pStrategy = m_pStgChain[iCurIdx];
   if (pStrategy)
     eReturn = pStrategy->Process (0, &sSrcPic, &sDstPic);
 
-  WelsMutexUnlock (&m_mutes);
-
   return eReturn;
 }
 
@@ -185,14 +172,10 @@ EResult CVpFrameWork::Get (int32_t iType, void* pParam) {
   if (!pParam)
     return RET_INVALIDPARAM;
 
-  WelsMutexLock (&m_mutes);
-
   IStrategy* pStrategy = m_pStgChain[iCurIdx];
   if (pStrategy)
     eReturn = pStrategy->Get (0, pParam);
 
-  WelsMutexUnlock (&m_mutes);
-
   return eReturn;
 }
 
@@ -203,20 +186,27 @@ EResult CVpFrameWork::Set (int32_t iType, void* pParam) {
   if (!pParam)
     return RET_INVALIDPARAM;
 
-  WelsMutexLock (&m_mutes);
-
   IStrategy* pStrategy = m_pStgChain[iCurIdx];
   if (pStrategy)
     eReturn = pStrategy->Set (0, pParam);
 
-  WelsMutexUnlock (&m_mutes);
-
   return eReturn;
 }
 
 EResult CVpFrameWork::SpecialFeature (int32_t iType, void* pIn, void* pOut) {
   EResult eReturn        = RET_SUCCESS;
 
+  switch (iType) {
+  case FEATURE_THREADS_NUM:
+    if (!pIn)
+      return RET_INVALIDPARAM;
+    eReturn = m_cStripeRunner.SetThreadsNum (* (int32_t*)pIn);
+    break;
+  default:
+    eReturn = RET_NOTSUPPORTED;
+    break;
+  }
+
   return eReturn;
 }
 
@@ -264,7 +254,7 @@ IStrategy* CVpFrameWork::CreateStrategy (EMethods m_eMethod, int32_t iCpuFlag) {
 
   switch (m_eMethod) {
   case METHOD_COLORSPACE_CONVERT:
-    //not support yet
+    pStrategy = WelsDynamicCast (IStrategy*, new CColorspaceConvert (iCpuFlag));
     break;
   case METHOD_DENOISE:
     pStrategy = WelsDynamicCast (IStrategy*, new CDenoiser (iCpuFlag));
@@ -63,6 +63,7 @@ class IStrategy : public IWelsVP {
     m_eFormat  = VIDEO_FORMAT_I420;
     m_iIndex   = 0;
     m_bInit    = false;
+    m_pStripeRunner = NULL;
   };
 
   virtual ~IStrategy() {}
@@ -88,13 +89,31 @@ class IStrategy : public IWelsVP {
   }
   virtual EResult Process (int32_t iType, SPixMap* pSrc, SPixMap* pDst) = 0;
 
+ protected:
+  int32_t GetStripeNum (const int32_t kiRowNum) {
+    return m_pStripeRunner ? m_pStripeRunner->GetStripeNum (kiRowNum) : 1;
+  }
+  void RunStripes (StripeFunc* pfStripe, void* pCtx, const int32_t kiStripeNum) {
+    if (m_pStripeRunner) {
+      m_pStripeRunner->Run (pfStripe, pCtx, kiStripeNum);
+    } else {
+      for (int32_t i = 0; i < kiStripeNum; i++)
+        pfStripe (pCtx, i, kiStripeNum);
+    }
+  }
+
  public:
   EMethods       m_eMethod;
   EVideoFormat m_eFormat;
   int32_t           m_iIndex;
   bool            m_bInit;
+  CStripeRunner*  m_pStripeRunner;	// owned by the framework, NULL runs all stripes on the calling thread
 };
 
+/*
+ *	an instance serves one calling thread at a time, there is no lock around the strategies;
+ *	the work of a call is split into stripes run on the workers of m_cStripeRunner
+ */
 class CVpFrameWork : public IWelsVP {
  public:
   CVpFrameWork (uint32_t uiThreadsNum, EResult& ret);
@@ -122,7 +141,7 @@ class CVpFrameWork : public IWelsVP {
  private:
   IStrategy* m_pStgChain[MAX_STRATEGY_NUM];
 
-  WELS_MUTEX m_mutes;
+  CStripeRunner m_cStripeRunner;
 };
 
 WELSVP_NAMESPACE_END
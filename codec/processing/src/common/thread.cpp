@@ -30,7 +30,7 @@
  *
  * \file	thread.cpp
  *
- * \brief	Interfaces introduced in thread programming
+ * \brief	Stripes of the strategies run on a pool of worker threads
  *
  * \date	11/17/2009 Created
  *
@@ -38,62 +38,108 @@
  */
 
 #include "thread.h"
+#include "util.h"
 
 WELSVP_NAMESPACE_BEGIN
 
-#if defined(_WIN32)
+#if defined(MT_ENABLED)
+typedef struct TagStripeTask {
+  SWelsThreadTask	sTask;
+  StripeFunc*		pfStripe;
+  void*				pCtx;
+  int32_t			iStripeIdx;
+  int32_t			iStripeNum;
+} SStripeTask;
 
-#ifdef WINAPI_FAMILY
-#if !WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
-#define InitializeCriticalSection(x) InitializeCriticalSectionEx(x, 0, 0)
-#endif
-#endif
+static void RunStripeTask (void* pArg) {
+  SStripeTask* pStripe = (SStripeTask*)pArg;
 
-WELS_THREAD_ERROR_CODE    WelsMutexInit (WELS_MUTEX*    mutex) {
-  InitializeCriticalSection (mutex);
-
-  return WELS_THREAD_ERROR_OK;
+  pStripe->pfStripe (pStripe->pCtx, pStripe->iStripeIdx, pStripe->iStripeNum);
 }
+#endif//MT_ENABLED
 
-WELS_THREAD_ERROR_CODE    WelsMutexLock (WELS_MUTEX*    mutex) {
-  EnterCriticalSection (mutex);
-
-  return WELS_THREAD_ERROR_OK;
+CStripeRunner::CStripeRunner() {
+  m_iThreadsNum = 1;
+#if defined(MT_ENABLED)
+  m_pThreadPool = NULL;
+#endif//MT_ENABLED
 }
 
-WELS_THREAD_ERROR_CODE    WelsMutexUnlock (WELS_MUTEX* mutex) {
-  LeaveCriticalSection (mutex);
-
-  return WELS_THREAD_ERROR_OK;
+CStripeRunner::~CStripeRunner() {
+  DestroyPool();
 }
 
-WELS_THREAD_ERROR_CODE    WelsMutexDestroy (WELS_MUTEX* mutex) {
-  DeleteCriticalSection (mutex);
-
-  return WELS_THREAD_ERROR_OK;
+void CStripeRunner::DestroyPool() {
+#if defined(MT_ENABLED)
+  if (m_pThreadPool != NULL) {
+    WelsThreadPoolDestroy (m_pThreadPool);
+    WelsThreadTaskGroupDestroy (&m_sTaskGroup);
+    m_pThreadPool = NULL;
+  }
+#endif//MT_ENABLED
+  m_iThreadsNum = 1;
 }
 
-#elif  defined(__GNUC__)
-
-WELS_THREAD_ERROR_CODE    WelsMutexInit (WELS_MUTEX*    mutex) {
-  return pthread_mutex_init (mutex, NULL);
+EResult CStripeRunner::SetThreadsNum (int32_t iThreadsNum) {
+  if (iThreadsNum <= 0)
+    return RET_INVALIDPARAM;
+
+  iThreadsNum = WELS_MIN (iThreadsNum, MAX_STRIPE_NUM);
+  if (iThreadsNum == m_iThreadsNum)
+    return RET_SUCCESS;
+
+  DestroyPool();
+#if defined(MT_ENABLED)
+  if (iThreadsNum > 1) {
+    // the stripes run on the calling thread alone if either fails
+    if (WelsThreadTaskGroupInit (&m_sTaskGroup) != WELS_THREAD_ERROR_OK)
+      return RET_FAILED;
+    // the calling thread works on a stripe as well, so one worker less is needed
+    if (WelsThreadPoolCreate (&m_pThreadPool, iThreadsNum - 1) != WELS_THREAD_ERROR_OK) {
+      WelsThreadTaskGroupDestroy (&m_sTaskGroup);
+      m_pThreadPool = NULL;
+      return RET_FAILED;
+    }
+    m_iThreadsNum = iThreadsNum;
+  }
+  return RET_SUCCESS;
+#else
+  return (iThreadsNum == 1) ? RET_SUCCESS : RET_NOTSUPPORTED;
+#endif//MT_ENABLED
 }
 
-WELS_THREAD_ERROR_CODE    WelsMutexLock (WELS_MUTEX*    mutex) {
-  return pthread_mutex_lock (mutex);
+int32_t CStripeRunner::GetStripeNum (const int32_t kiRowNum) {
+  return WELS_MAX (1, WELS_MIN (m_iThreadsNum, kiRowNum));
 }
 
-WELS_THREAD_ERROR_CODE    WelsMutexUnlock (WELS_MUTEX* mutex) {
-  return pthread_mutex_unlock (mutex);
+void CStripeRunner::Run (StripeFunc* pfStripe, void* pCtx, const int32_t kiStripeNum) {
+  int32_t i = 0;
+
+#if defined(MT_ENABLED)
+  if (m_pThreadPool != NULL && kiStripeNum > 1 && kiStripeNum <= MAX_STRIPE_NUM) {
+    SStripeTask sStripes[MAX_STRIPE_NUM];
+
+    for (i = 1; i < kiStripeNum; i++) {
+      SStripeTask* pStripe = &sStripes[i];
+      pStripe->sTask.pProc	= RunStripeTask;
+      pStripe->sTask.pArg		= pStripe;
+      pStripe->sTask.pGroup	= &m_sTaskGroup;
+      pStripe->pfStripe		= pfStripe;
+      pStripe->pCtx			= pCtx;
+      pStripe->iStripeIdx		= i;
+      pStripe->iStripeNum		= kiStripeNum;
+      if (WelsThreadPoolQueueTask (m_pThreadPool, &pStripe->sTask) != WELS_THREAD_ERROR_OK)
+        pfStripe (pCtx, i, kiStripeNum);
+    }
+    pfStripe (pCtx, 0, kiStripeNum);
+    WelsThreadPoolWaitGroup (m_pThreadPool, &m_sTaskGroup);
+    return;
+  }
+#endif//MT_ENABLED
+
+  for (i = 0; i < kiStripeNum; i++) {
+    pfStripe (pCtx, i, kiStripeNum);
+  }
 }
 
-WELS_THREAD_ERROR_CODE    WelsMutexDestroy (WELS_MUTEX* mutex) {
-  return pthread_mutex_destroy (mutex);
-}
-
-#endif
-
 WELSVP_NAMESPACE_END
-
-
-
@@ -30,7 +30,7 @@
  *
  * \file	thread.h
  *
- * \brief	Interfaces introduced in thread programming
+ * \brief	Stripes of the strategies run on a pool of worker threads
  *
  * \date	11/17/2009 Created
  *
@@ -41,48 +41,58 @@
 #define WELSVP_THREAD_H
 
 #include "typedef.h"
-
-#if defined(_WIN32)
-
-#include <windows.h>
-
-#elif defined(__GNUC__)
-
-#include <stdlib.h>
-#include <unistd.h>
-#include <pthread.h>
-#include <semaphore.h>
-#include <signal.h>
-#include <errno.h>
-
-#endif//WIN32
+#include "IWelsVP.h"
+#include "WelsThreadPool.h"
 
 WELSVP_NAMESPACE_BEGIN
 
-#if defined(_WIN32)
-
-typedef  HANDLE            WELS_THREAD_HANDLE;
-typedef  CRITICAL_SECTION  WELS_MUTEX;
-
-#elif defined(__GNUC__)
-
-typedef   pthread_t         WELS_THREAD_HANDLE;
-typedef   pthread_mutex_t   WELS_MUTEX;
+#define MAX_STRIPE_NUM		32
 
-#endif
-
-typedef int32_t WELS_THREAD_ERROR_CODE;
-
-#define   WELS_THREAD_ERROR_OK					0
-#define   WELS_THREAD_ERROR_GENERAL			((unsigned long)(-1))
-#define   WELS_THREAD_ERROR_WAIT_OBJECT_0		0
-#define	  WELS_THREAD_ERROR_WAIT_TIMEOUT		((unsigned long)0x00000102L)
-#define	  WELS_THREAD_ERROR_WAIT_FAILED		    WELS_THREAD_ERROR_GENERAL
+/*!
+ * \brief	work on stripe kiStripeIdx of kiStripeNum, stripes of one run are processed concurrently
+ *			so they must not write any data shared with the others
+ */
+typedef void (StripeFunc) (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
 
-WELS_THREAD_ERROR_CODE   WelsMutexInit (WELS_MUTEX*    mutex);
-WELS_THREAD_ERROR_CODE   WelsMutexLock (WELS_MUTEX*    mutex);
-WELS_THREAD_ERROR_CODE   WelsMutexUnlock (WELS_MUTEX* mutex);
-WELS_THREAD_ERROR_CODE   WelsMutexDestroy (WELS_MUTEX* mutex);
+/*!
+ * \brief	rows [*pStartRow, *pEndRow) of stripe kiStripeIdx when kiRowNum rows are split into kiStripeNum stripes
+ */
+static inline void GetStripeRows (const int32_t kiRowNum, const int32_t kiStripeIdx, const int32_t kiStripeNum,
+                                  int32_t* pStartRow, int32_t* pEndRow) {
+  *pStartRow	= kiRowNum * kiStripeIdx / kiStripeNum;
+  *pEndRow	= kiRowNum * (kiStripeIdx + 1) / kiStripeNum;
+}
+
+class CStripeRunner {
+ public:
+  CStripeRunner();
+  ~CStripeRunner();
+
+  /*!
+   * \brief	threads the stripes are run on, the calling thread included; 1 runs them on the calling thread only
+   */
+  EResult SetThreadsNum (int32_t iThreadsNum);
+
+  /*!
+   * \brief	number of stripes worth splitting kiRowNum rows into
+   */
+  int32_t GetStripeNum (const int32_t kiRowNum);
+
+  /*!
+   * \brief	run all stripes and return once they are done, the calling thread takes the first one
+   */
+  void    Run (StripeFunc* pfStripe, void* pCtx, const int32_t kiStripeNum);
+
+ private:
+  void    DestroyPool();
+
+ private:
+  int32_t              m_iThreadsNum;
+#if defined(MT_ENABLED)
+  SWelsThreadPool*     m_pThreadPool;
+  SWelsThreadTaskGroup m_sTaskGroup;
+#endif//MT_ENABLED
+};
 
 WELSVP_NAMESPACE_END
 
@@ -47,6 +47,7 @@ CDenoiser::CDenoiser (int32_t iCpuFlag) {
   m_uiSpaceRadius = DENOISE_GRAY_RADIUS;
   m_fSigmaGrey  = DENOISE_GRAY_SIGMA;
   m_uiType		 = DENOISE_ALL_COMPONENT;
+  WelsMemset (&m_sDenoiseParam, 0, sizeof (m_sDenoiseParam));
   InitDenoiseFunc (m_pfDenoise, m_CPUFlag);
 }
 
@@ -56,15 +57,19 @@ CDenoiser::~CDenoiser() {
 void CDenoiser::InitDenoiseFunc (SDenoiseFuncs& denoiser,  int32_t iCpuFlag) {
   denoiser.pfBilateralLumaFilter8 = BilateralLumaFilter8_c;
   denoiser.pfWaverageChromaFilter8 = WaverageChromaFilter8_c;
+  denoiser.pfTemporalBlend8x8 = TemporalBlend8x8_c;
+  denoiser.pfTemporalBlend4x4 = TemporalBlend4x4_c;
 #if defined(X86_ASM)
   if (iCpuFlag & WELS_CPU_SSE2) {
     denoiser.pfBilateralLumaFilter8 = BilateralLumaFilter8_sse2;
     denoiser.pfWaverageChromaFilter8 = WaverageChromaFilter8_sse2;
+    denoiser.pfTemporalBlend8x8 = TemporalBlend8x8_sse2;
+    denoiser.pfTemporalBlend4x4 = TemporalBlend4x4_sse2;
   }
 #endif
 }
 
-EResult CDenoiser::Process (int32_t iType, SPixMap* pSrc, SPixMap* dst) {
+EResult CDenoiser::Process (int32_t iType, SPixMap* pSrc, SPixMap* pRef) {
   uint8_t* pSrcY = (uint8_t*)pSrc->pPixel[0];
   uint8_t* pSrcU = (uint8_t*)pSrc->pPixel[1];
   uint8_t* pSrcV = (uint8_t*)pSrc->pPixel[2];
@@ -72,21 +77,91 @@ EResult CDenoiser::Process (int32_t iType, SPixMap* pSrc, SPixMap* dst) {
     return RET_INVALIDPARAM;
   }
 
+  SDenoiseStripeCtx sCtx;
+  sCtx.pDenoiser	= this;
+  sCtx.pSrc		= pSrc;
+  sCtx.pRef		= pRef;
+  sCtx.pCalcResult	= m_sDenoiseParam.pCalcResult;
+
+  if (pRef == NULL || pRef->pPixel[0] == NULL) {
+    // the filters work in place on rows already filtered, so the components are what runs in parallel
+    RunStripes (ComponentStripe, &sCtx, GetStripeNum (3));
+    return RET_SUCCESS;
+  }
+
+  // temporal mode, the 8x8 sad has to be of these very pictures
+  if (pRef->pPixel[1] == NULL || pRef->pPixel[2] == NULL
+      || pRef->sRect.iRectWidth != pSrc->sRect.iRectWidth || pRef->sRect.iRectHeight != pSrc->sRect.iRectHeight
+      || sCtx.pCalcResult == NULL || sCtx.pCalcResult->pCurY != pSrcY || sCtx.pCalcResult->pRefY != pRef->pPixel[0]) {
+    return RET_INVALIDPARAM;
+  }
+
+  RunStripes (TemporalStripe, &sCtx, GetStripeNum (pSrc->sRect.iRectHeight >> 4));
+
+  return RET_SUCCESS;
+}
+
+EResult CDenoiser::Set (int32_t iType, void* pParam) {
+  if (pParam == NULL) {
+    return RET_INVALIDPARAM;
+  }
+
+  m_sDenoiseParam = * (SDenoiseParam*)pParam;
+
+  return RET_SUCCESS;
+}
+
+void CDenoiser::TemporalStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SDenoiseStripeCtx* pStripeCtx = (SDenoiseStripeCtx*)pCtx;
+  const SDenoiseFuncs* kpFuncs = &pStripeCtx->pDenoiser->m_pfDenoise;
+  SPixMap* pSrc = pStripeCtx->pSrc;
+  SPixMap* pRef = pStripeCtx->pRef;
+  int32_t (*pSad8x8)[4] = pStripeCtx->pCalcResult->pSad8x8;
+  const int32_t kiMbWidth = pSrc->sRect.iRectWidth >> 4;
+  int32_t iStartRow = 0, iEndRow = 0;
+
+  GetStripeRows (pSrc->sRect.iRectHeight >> 4, kiStripeIdx, kiStripeNum, &iStartRow, &iEndRow);
+
+  for (int32_t j = iStartRow; j < iEndRow; j++) {
+    for (int32_t i = 0; i < kiMbWidth; i++) {
+      const int32_t kiMbIdx = j * kiMbWidth + i;
+
+      // 8x8 blocks in raster order within the MB, with the co-located 4x4 blocks of both chroma components
+      for (int32_t k = 0; k < 4; k++) {
+        if (pSad8x8[kiMbIdx][k] > DENOISE_TEMPORAL_SAD_THD)
+          continue;
+
+        const int32_t kiX = (i << 4) + ((k & 1) << 3);
+        const int32_t kiY = (j << 4) + ((k >> 1) << 3);
+        kpFuncs->pfTemporalBlend8x8 ((uint8_t*)pSrc->pPixel[0] + kiY * pSrc->iStride[0] + kiX, pSrc->iStride[0],
+                                     (uint8_t*)pRef->pPixel[0] + kiY * pRef->iStride[0] + kiX, pRef->iStride[0]);
+        for (int32_t c = 1; c < 3; c++) {
+          kpFuncs->pfTemporalBlend4x4 ((uint8_t*)pSrc->pPixel[c] + (kiY >> 1) * pSrc->iStride[c] + (kiX >> 1), pSrc->iStride[c],
+                                       (uint8_t*)pRef->pPixel[c] + (kiY >> 1) * pRef->iStride[c] + (kiX >> 1), pRef->iStride[c]);
+        }
+      }
+    }
+  }
+}
+
+void CDenoiser::ComponentStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SDenoiseStripeCtx* pStripeCtx = (SDenoiseStripeCtx*)pCtx;
+  CDenoiser* pDenoiser = pStripeCtx->pDenoiser;
+  SPixMap* pSrc = pStripeCtx->pSrc;
   int32_t iWidthY = pSrc->sRect.iRectWidth;
   int32_t iHeightY = pSrc->sRect.iRectHeight;
   int32_t iWidthUV = iWidthY >> 1;
   int32_t iHeightUV = iHeightY >> 1;
 
-  if (m_uiType & DENOISE_Y_COMPONENT)
-    BilateralDenoiseLuma (pSrcY, iWidthY, iHeightY, pSrc->iStride[0]);
-
-  if (m_uiType & DENOISE_U_COMPONENT)
-    WaverageDenoiseChroma (pSrcU, iWidthUV, iHeightUV, pSrc->iStride[1]);
+  for (int32_t i = kiStripeIdx; i < 3; i += kiStripeNum) {
+    if (! (pDenoiser->m_uiType & (1 << i)))
+      continue;
 
-  if (m_uiType & DENOISE_V_COMPONENT)
-    WaverageDenoiseChroma (pSrcV, iWidthUV, iHeightUV, pSrc->iStride[2]);
-
-  return RET_SUCCESS;
+    if (i == 0)
+      pDenoiser->BilateralDenoiseLuma ((uint8_t*)pSrc->pPixel[0], iWidthY, iHeightY, pSrc->iStride[0]);
+    else
+      pDenoiser->WaverageDenoiseChroma ((uint8_t*)pSrc->pPixel[i], iWidthUV, iHeightUV, pSrc->iStride[i]);
+  }
 }
 
 void CDenoiser::BilateralDenoiseLuma (uint8_t* pSrcY, int32_t iWidth, int32_t iHeight, int32_t iStride) {
@@ -59,6 +59,9 @@
 #define DENOISE_V_COMPONENT (4)
 #define DENOISE_ALL_COMPONENT (7)
 
+#define DENOISE_TEMPORAL_SAD_THD	(8 * 8 * 4)	// 8x8 blocks of mean absolute difference up to 4 are taken as static
+#define DENOISE_TEMPORAL_DIFF_THD	(8)			// samples of static blocks differing more from the reference are kept
+
 
 WELSVP_NAMESPACE_BEGIN
 
@@ -68,32 +71,61 @@ typedef void (DenoiseFilterFunc) (uint8_t* pixels, int32_t stride);
 
 typedef DenoiseFilterFunc* DenoiseFilterFuncPtr;
 
+/*!
+ * \brief	average the samples of a block with the co-located reference samples not differing by more than DENOISE_TEMPORAL_DIFF_THD
+ */
+typedef void (TemporalBlendFunc) (uint8_t* pCur, int32_t iCurStride, uint8_t* pRef, int32_t iRefStride);
+
+typedef TemporalBlendFunc* TemporalBlendFuncPtr;
+
 DenoiseFilterFunc     BilateralLumaFilter8_c;
 DenoiseFilterFunc     WaverageChromaFilter8_c;
+TemporalBlendFunc     TemporalBlend8x8_c;
+TemporalBlendFunc     TemporalBlend4x4_c;
 
 #ifdef X86_ASM
 WELSVP_EXTERN_C_BEGIN
 DenoiseFilterFunc     BilateralLumaFilter8_sse2 ;
 DenoiseFilterFunc     WaverageChromaFilter8_sse2 ;
 WELSVP_EXTERN_C_END
+TemporalBlendFunc     TemporalBlend8x8_sse2;
+TemporalBlendFunc     TemporalBlend4x4_sse2;
 #endif
 
 typedef  struct TagDenoiseFuncs {
   DenoiseFilterFuncPtr	pfBilateralLumaFilter8;//on 8 samples
   DenoiseFilterFuncPtr	pfWaverageChromaFilter8;//on 8 samples
+  TemporalBlendFuncPtr	pfTemporalBlend8x8;//luma block
+  TemporalBlendFuncPtr	pfTemporalBlend4x4;//chroma block
 } SDenoiseFuncs;
 
+class CDenoiser;
+
+typedef struct TagDenoiseStripeCtx {
+  CDenoiser*	pDenoiser;
+  SPixMap*		pSrc;
+  SPixMap*		pRef;			// previous denoised picture of the temporal mode
+  SVAACalcResult*	pCalcResult;
+} SDenoiseStripeCtx;
+
 class CDenoiser : public IStrategy {
  public:
   CDenoiser (int32_t iCpuFlag);
   ~CDenoiser();
 
-  EResult Process (int32_t iType, SPixMap* pSrc, SPixMap* dst);
+  /*!
+   * \brief	spatial filtering of pSrc in place if pRef is empty; otherwise temporal filtering, where the static
+   *			8x8 blocks found in the statistics given by Set are blended with the co-located blocks of pRef
+   */
+  EResult Process (int32_t iType, SPixMap* pSrc, SPixMap* pRef);
+  EResult Set (int32_t iType, void* pParam);
 
  private:
   void InitDenoiseFunc (SDenoiseFuncs& pf, int32_t cpu);
   void BilateralDenoiseLuma (uint8_t* p_y_data, int32_t width, int32_t height, int32_t stride);
   void WaverageDenoiseChroma (uint8_t* pSrcUV, int32_t width, int32_t height, int32_t stride);
+  static void ComponentStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
+  static void TemporalStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
 
  private:
   float		 m_fSigmaGrey;			//sigma for grey scale similarity, suggestion 2.5-3
@@ -101,6 +133,7 @@ class CDenoiser : public IStrategy {
   uint16_t	 m_uiType;					//do denoising on which component 1-Y, 2-U, 4-V; 7-YUV, 3-YU, 5-YV, 6-UV
 
   SDenoiseFuncs m_pfDenoise;
+  SDenoiseParam m_sDenoiseParam;
   int32_t      m_CPUFlag;
 };
 
@@ -123,4 +123,24 @@ void	Gauss3x3Filter (uint8_t* pSrc, int32_t iStride) {
   *pSrc = nSum >> 4;
 }
 
+static inline void TemporalBlend_c (uint8_t* pCur, int32_t iCurStride, uint8_t* pRef, int32_t iRefStride,
+                                    const int32_t kiSize) {
+  for (int32_t y = 0; y < kiSize; y++) {
+    for (int32_t x = 0; x < kiSize; x++) {
+      if (WELS_ABS (pCur[x] - pRef[x]) <= DENOISE_TEMPORAL_DIFF_THD)
+        pCur[x] = (pCur[x] + pRef[x] + 1) >> 1;
+    }
+    pCur += iCurStride;
+    pRef += iRefStride;
+  }
+}
+
+void TemporalBlend8x8_c (uint8_t* pCur, int32_t iCurStride, uint8_t* pRef, int32_t iRefStride) {
+  TemporalBlend_c (pCur, iCurStride, pRef, iRefStride, 8);
+}
+
+void TemporalBlend4x4_c (uint8_t* pCur, int32_t iCurStride, uint8_t* pRef, int32_t iRefStride) {
+  TemporalBlend_c (pCur, iCurStride, pRef, iRefStride, 4);
+}
+
 WELSVP_NAMESPACE_END
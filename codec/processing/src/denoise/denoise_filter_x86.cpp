@@ -0,0 +1,107 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  denoise_filter_x86.cpp
+ *
+ *  Abstract
+ *      SSE2 temporal blending of the denoiser, bit exact with the c versions.
+ *
+ *  History
+ *      10/18/2014 Created
+ *
+ *****************************************************************************/
+
+#include "denoise.h"
+
+#ifdef X86_ASM
+
+#include <emmintrin.h>
+
+#if defined(__GNUC__)
+#define WELSVP_TARGET(kpIsa)	__attribute__ ((target (kpIsa)))
+#else
+#define WELSVP_TARGET(kpIsa)
+#endif//__GNUC__
+
+WELSVP_NAMESPACE_BEGIN
+
+/*
+ *	samples within DENOISE_TEMPORAL_DIFF_THD of the reference take the pavg of both, the others are kept
+ */
+WELSVP_TARGET ("sse2")
+static inline __m128i TemporalBlend16_sse2 (const __m128i kvCur, const __m128i kvRef) {
+  const __m128i kvThd	= _mm_set1_epi8 (DENOISE_TEMPORAL_DIFF_THD);
+  __m128i vAbsDiff	= _mm_or_si128 (_mm_subs_epu8 (kvCur, kvRef), _mm_subs_epu8 (kvRef, kvCur));
+  __m128i vMask		= _mm_cmpeq_epi8 (_mm_subs_epu8 (vAbsDiff, kvThd), _mm_setzero_si128());
+
+  return _mm_or_si128 (_mm_and_si128 (vMask, _mm_avg_epu8 (kvCur, kvRef)), _mm_andnot_si128 (vMask, kvCur));
+}
+
+WELSVP_TARGET ("sse2")
+void TemporalBlend8x8_sse2 (uint8_t* pCur, int32_t iCurStride, uint8_t* pRef, int32_t iRefStride) {
+  // two rows per register
+  for (int32_t i = 0; i < 4; i++) {
+    __m128i vCur = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i*)pCur),
+                                       _mm_loadl_epi64 ((const __m128i*) (pCur + iCurStride)));
+    __m128i vRef = _mm_unpacklo_epi64 (_mm_loadl_epi64 ((const __m128i*)pRef),
+                                       _mm_loadl_epi64 ((const __m128i*) (pRef + iRefStride)));
+    __m128i vOut = TemporalBlend16_sse2 (vCur, vRef);
+
+    _mm_storel_epi64 ((__m128i*)pCur, vOut);
+    _mm_storel_epi64 ((__m128i*) (pCur + iCurStride), _mm_srli_si128 (vOut, 8));
+    pCur += iCurStride << 1;
+    pRef += iRefStride << 1;
+  }
+}
+
+WELSVP_TARGET ("sse2")
+static inline __m128i Load4x4_sse2 (const uint8_t* pSrc, const int32_t kiStride) {
+  __m128i vRow01 = _mm_unpacklo_epi32 (_mm_cvtsi32_si128 (* (const int32_t*)pSrc),
+                                       _mm_cvtsi32_si128 (* (const int32_t*) (pSrc + kiStride)));
+  __m128i vRow23 = _mm_unpacklo_epi32 (_mm_cvtsi32_si128 (* (const int32_t*) (pSrc + 2 * kiStride)),
+                                       _mm_cvtsi32_si128 (* (const int32_t*) (pSrc + 3 * kiStride)));
+  return _mm_unpacklo_epi64 (vRow01, vRow23);
+}
+
+WELSVP_TARGET ("sse2")
+void TemporalBlend4x4_sse2 (uint8_t* pCur, int32_t iCurStride, uint8_t* pRef, int32_t iRefStride) {
+  // all four rows in one register
+  __m128i vOut = TemporalBlend16_sse2 (Load4x4_sse2 (pCur, iCurStride), Load4x4_sse2 (pRef, iRefStride));
+
+  for (int32_t i = 0; i < 4; i++) {
+    * (int32_t*)pCur = _mm_cvtsi128_si32 (vOut);
+    vOut = _mm_srli_si128 (vOut, 4);
+    pCur += iCurStride;
+  }
+}
+
+WELSVP_NAMESPACE_END
+
+#endif//X86_ASM
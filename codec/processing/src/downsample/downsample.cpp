@@ -56,22 +56,21 @@ void CDownsampling::InitDownsampleFuncs (SDownsampleFuncs& sDownsampleFunc,  int
   sDownsampleFunc.pfGeneralRatioChroma = GeneralBilinearAccurateDownsampler_c;
   sDownsampleFunc.pfGeneralRatioLuma	 = GeneralBilinearFastDownsampler_c;
 #if defined(X86_ASM)
-  if (iCpuFlag & WELS_CPU_SSE) {
-    /*  sDownsampleFunc.pfHalfAverage[0]	= DyadicBilinearDownsamplerWidthx32_sse;
-      sDownsampleFunc.pfHalfAverage[1]	= DyadicBilinearDownsamplerWidthx16_sse;
-      sDownsampleFunc.pfHalfAverage[2]	= DyadicBilinearDownsamplerWidthx8_sse;*/
-  }
   if (iCpuFlag & WELS_CPU_SSE2) {
-    //  sDownsampleFunc.pfGeneralRatioChroma = GeneralBilinearAccurateDownsamplerWrap_sse2;
-    //  sDownsampleFunc.pfGeneralRatioLuma   = GeneralBilinearFastDownsamplerWrap_sse2;
+    sDownsampleFunc.pfHalfAverage[0]	= DyadicBilinearDownsamplerWidthx16_sse2;
+    sDownsampleFunc.pfHalfAverage[1]	= DyadicBilinearDownsamplerWidthx16_sse2;
+    sDownsampleFunc.pfHalfAverage[2]	= DyadicBilinearDownsamplerWidthx8_sse2;
+    sDownsampleFunc.pfGeneralRatioChroma = GeneralBilinearAccurateDownsampler_sse2;
+    sDownsampleFunc.pfGeneralRatioLuma   = GeneralBilinearFastDownsampler_sse2;
   }
   if (iCpuFlag & WELS_CPU_SSSE3) {
-    //  sDownsampleFunc.pfHalfAverage[0]	= DyadicBilinearDownsamplerWidthx32_ssse3;
-    //  sDownsampleFunc.pfHalfAverage[1]	= DyadicBilinearDownsamplerWidthx16_ssse3;
+    sDownsampleFunc.pfHalfAverage[0]	= DyadicBilinearDownsamplerWidthx32_ssse3;
+    sDownsampleFunc.pfHalfAverage[1]	= DyadicBilinearDownsamplerWidthx16_ssse3;
+    sDownsampleFunc.pfGeneralRatioChroma = GeneralBilinearAccurateDownsampler_ssse3;
+    sDownsampleFunc.pfGeneralRatioLuma   = GeneralBilinearFastDownsampler_ssse3;
   }
-  if (iCpuFlag & WELS_CPU_SSE41) {
-    //  sDownsampleFunc.pfHalfAverage[0]	= DyadicBilinearDownsamplerWidthx32_sse4;
-    //  sDownsampleFunc.pfHalfAverage[1]	= DyadicBilinearDownsamplerWidthx16_sse4;
+  if (iCpuFlag & WELS_CPU_AVX2) {
+    sDownsampleFunc.pfHalfAverage[0]	= DyadicBilinearDownsamplerWidthx32_avx2;
   }
 #endif//X86_ASM
 
@@ -82,38 +81,61 @@ EResult CDownsampling::Process (int32_t iType, SPixMap* pSrcPixMap, SPixMap* pDs
   int32_t iSrcHeightY = pSrcPixMap->sRect.iRectHeight;
   int32_t iDstWidthY = pDstPixMap->sRect.iRectWidth;
   int32_t iDstHeightY = pDstPixMap->sRect.iRectHeight;
-
-  int32_t iSrcWidthUV = iSrcWidthY >> 1;
-  int32_t iSrcHeightUV = iSrcHeightY >> 1;
-  int32_t iDstWidthUV = iDstWidthY >> 1;
-  int32_t iDstHeightUV = iDstHeightY >> 1;
+  SDownsampleStripeCtx sCtx;
 
   if (iSrcWidthY <= iDstWidthY || iSrcHeightY <= iDstHeightY) {
     return RET_INVALIDPARAM;
   }
 
+  sCtx.pDownsampleFuncs	= &m_pfDownsample;
+  sCtx.pSrcPixMap		= pSrcPixMap;
+  sCtx.pDstPixMap		= pDstPixMap;
+
   if ((iSrcWidthY >> 1) == iDstWidthY && (iSrcHeightY >> 1) == iDstHeightY) {
-    // use half average functions
-    uint8_t iAlignIndex = GetAlignedIndex (iSrcWidthY);
-    m_pfDownsample.pfHalfAverage[iAlignIndex] ((uint8_t*)pDstPixMap->pPixel[0], pDstPixMap->iStride[0],
-        (uint8_t*)pSrcPixMap->pPixel[0], pSrcPixMap->iStride[0], iSrcWidthY, iSrcHeightY);
-
-    iAlignIndex = GetAlignedIndex (iSrcWidthUV);
-    m_pfDownsample.pfHalfAverage[iAlignIndex] ((uint8_t*)pDstPixMap->pPixel[1], pDstPixMap->iStride[1],
-        (uint8_t*)pSrcPixMap->pPixel[1], pSrcPixMap->iStride[1], iSrcWidthUV, iSrcHeightUV);
-    m_pfDownsample.pfHalfAverage[iAlignIndex] ((uint8_t*)pDstPixMap->pPixel[2], pDstPixMap->iStride[2],
-        (uint8_t*)pSrcPixMap->pPixel[2], pSrcPixMap->iStride[2], iSrcWidthUV, iSrcHeightUV);
+    // use half average functions, every plane is split into the same number of stripes of rows
+    RunStripes (DyadicStripe, &sCtx, GetStripeNum (iDstHeightY >> 1));
   } else {
-    m_pfDownsample.pfGeneralRatioLuma ((uint8_t*)pDstPixMap->pPixel[0], pDstPixMap->iStride[0], iDstWidthY, iDstHeightY,
-                                       (uint8_t*)pSrcPixMap->pPixel[0], pSrcPixMap->iStride[0], iSrcWidthY, iSrcHeightY);
+    // the general ratio functions scale whole planes, so the planes are what runs in parallel
+    RunStripes (GeneralRatioStripe, &sCtx, GetStripeNum (3));
+  }
+  return RET_SUCCESS;
+}
 
-    m_pfDownsample.pfGeneralRatioChroma ((uint8_t*)pDstPixMap->pPixel[1], pDstPixMap->iStride[1], iDstWidthUV, iDstHeightUV,
-                                         (uint8_t*)pSrcPixMap->pPixel[1], pSrcPixMap->iStride[1], iSrcWidthUV, iSrcHeightUV);
+void CDownsampling::DyadicStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SDownsampleStripeCtx* pStripeCtx = (SDownsampleStripeCtx*)pCtx;
+  SPixMap* pSrcPixMap = pStripeCtx->pSrcPixMap;
+  SPixMap* pDstPixMap = pStripeCtx->pDstPixMap;
+
+  for (int32_t i = 0; i < 3; i++) {
+    const int32_t kiSrcWidth	= pSrcPixMap->sRect.iRectWidth >> (i > 0);
+    const int32_t kiSrcHeight	= pSrcPixMap->sRect.iRectHeight >> (i > 0);
+    const int32_t kiSrcStride	= pSrcPixMap->iStride[i];
+    const int32_t kiDstStride	= pDstPixMap->iStride[i];
+    int32_t iStartRow = 0, iEndRow = 0;
+
+    GetStripeRows (kiSrcHeight >> 1, kiStripeIdx, kiStripeNum, &iStartRow, &iEndRow);
+    if (iStartRow >= iEndRow)
+      continue;
+
+    pStripeCtx->pDownsampleFuncs->pfHalfAverage[GetAlignedIndex (kiSrcWidth)] ((uint8_t*)pDstPixMap->pPixel[i] +
+        iStartRow * kiDstStride, kiDstStride, (uint8_t*)pSrcPixMap->pPixel[i] + (iStartRow << 1) * kiSrcStride, kiSrcStride,
+        kiSrcWidth, (iEndRow - iStartRow) << 1);
+  }
+}
+
+void CDownsampling::GeneralRatioStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SDownsampleStripeCtx* pStripeCtx = (SDownsampleStripeCtx*)pCtx;
+  SPixMap* pSrcPixMap = pStripeCtx->pSrcPixMap;
+  SPixMap* pDstPixMap = pStripeCtx->pDstPixMap;
 
-    m_pfDownsample.pfGeneralRatioChroma ((uint8_t*)pDstPixMap->pPixel[2], pDstPixMap->iStride[2], iDstWidthUV, iDstHeightUV,
-                                         (uint8_t*)pSrcPixMap->pPixel[2], pSrcPixMap->iStride[2], iSrcWidthUV, iSrcHeightUV);
+  for (int32_t i = kiStripeIdx; i < 3; i += kiStripeNum) {
+    PGeneralDownsampleFunc pfGeneralRatio = (i > 0) ? pStripeCtx->pDownsampleFuncs->pfGeneralRatioChroma :
+                                            pStripeCtx->pDownsampleFuncs->pfGeneralRatioLuma;
+
+    pfGeneralRatio ((uint8_t*)pDstPixMap->pPixel[i], pDstPixMap->iStride[i], pDstPixMap->sRect.iRectWidth >> (i > 0),
+                    pDstPixMap->sRect.iRectHeight >> (i > 0), (uint8_t*)pSrcPixMap->pPixel[i], pSrcPixMap->iStride[i],
+                    pSrcPixMap->sRect.iRectWidth >> (i > 0), pSrcPixMap->sRect.iRectHeight >> (i > 0));
   }
-  return RET_SUCCESS;
 }
 
 int32_t CDownsampling::GetAlignedIndex (const int32_t kiSrcWidth) {
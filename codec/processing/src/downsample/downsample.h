@@ -73,39 +73,30 @@ typedef struct {
 
 
 #ifdef X86_ASM
-WELSVP_EXTERN_C_BEGIN
-// used for scr width is multipler of 8 pixels
-HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx8_sse;
-// iSrcWidth= x16 pixels
-HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx16_sse;
-// iSrcWidth= x32 pixels
-HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx32_sse;
-// used for scr width is multipler of 16 pixels
+// source width is a multiple of 8 pixels
+HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx8_sse2;
+// source width is a multiple of 16 pixels
+HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx16_sse2;
 HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx16_ssse3;
-// iSrcWidth= x32 pixels
+// source width is a multiple of 32 pixels
 HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx32_ssse3;
-// iSrcWidth= x16 pixels
-HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx16_sse4;
-// iSrcWidth= x32 pixels
-HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx32_sse4;
-
-GeneralDownsampleFunc GeneralBilinearFastDownsamplerWrap_sse2;
-GeneralDownsampleFunc GeneralBilinearAccurateDownsamplerWrap_sse2;
-
-void GeneralBilinearFastDownsampler_sse2 (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
-    const int32_t kiDstHeight,
-    uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight,
-    const uint32_t kuiScaleX, const uint32_t kuiScaleY);
-void GeneralBilinearAccurateDownsampler_sse2 (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
-    const int32_t kiDstHeight,
-    uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight,
-    const uint32_t kuiScaleX, const uint32_t kuiScaleY);
-WELSVP_EXTERN_C_END
+HalveDownsampleFunc		DyadicBilinearDownsamplerWidthx32_avx2;
+
+GeneralDownsampleFunc GeneralBilinearFastDownsampler_sse2;
+GeneralDownsampleFunc GeneralBilinearAccurateDownsampler_sse2;
+GeneralDownsampleFunc GeneralBilinearFastDownsampler_ssse3;
+GeneralDownsampleFunc GeneralBilinearAccurateDownsampler_ssse3;
 #endif
 
 
 
 
+typedef struct TagDownsampleStripeCtx {
+  const SDownsampleFuncs*	pDownsampleFuncs;
+  SPixMap*					pSrcPixMap;
+  SPixMap*					pDstPixMap;
+} SDownsampleStripeCtx;
+
 class CDownsampling : public IStrategy {
  public:
   CDownsampling (int32_t iCpuFlag);
@@ -116,7 +107,9 @@ class CDownsampling : public IStrategy {
  private:
   void InitDownsampleFuncs (SDownsampleFuncs& sDownsampleFunc, int32_t iCpuFlag);
 
-  int32_t GetAlignedIndex (const int32_t kiSrcWidth);
+  static int32_t GetAlignedIndex (const int32_t kiSrcWidth);
+  static void DyadicStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
+  static void GeneralRatioStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
 
  private:
   SDownsampleFuncs m_pfDownsample;
@@ -0,0 +1,518 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2014, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  downsamplefuncs_x86.cpp
+ *
+ *  Abstract
+ *      SSE2/SSSE3/AVX2 dyadic and general ratio downsamplers, bit exact with the c versions.
+ *
+ *  History
+ *      10/18/2014 Created
+ *
+ *****************************************************************************/
+
+#include "downsample.h"
+
+#ifdef X86_ASM
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+#define WELSVP_TARGET(kpIsa)	__attribute__ ((target (kpIsa)))
+#else
+#define WELSVP_TARGET(kpIsa)
+#endif//__GNUC__
+
+WELSVP_NAMESPACE_BEGIN
+
+/*
+ *	dyadic: every output is ((a + b + 1) >> 1 + (c + d + 1) >> 1 + 1) >> 1, which is what pavg
+ *	computes once the even and odd source bytes are separated
+ */
+
+WELSVP_TARGET ("sse2")
+static inline __m128i HalfAverageLine16_sse2 (const __m128i kvLine) {
+  const __m128i kvEvenMask = _mm_set1_epi16 (0x00ff);
+  return _mm_avg_epu16 (_mm_and_si128 (kvLine, kvEvenMask), _mm_srli_epi16 (kvLine, 8));
+}
+
+WELSVP_TARGET ("sse2")
+void DyadicBilinearDownsamplerWidthx8_sse2 (uint8_t* pDst, const int32_t kiDstStride,
+    uint8_t* pSrc, const int32_t kiSrcStride,
+    const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  const int32_t kiDstWidth	= kiSrcWidth >> 1;
+  const int32_t kiDstHeight	= kiSrcHeight >> 1;
+
+  for (int32_t j = 0; j < kiDstHeight; j ++) {
+    int32_t i = 0;
+    for (; i + 8 <= kiDstWidth; i += 8) {
+      const __m128i kvRow1 = HalfAverageLine16_sse2 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1))));
+      const __m128i kvRow2 = HalfAverageLine16_sse2 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1) + kiSrcStride)));
+      const __m128i kvAvg  = _mm_avg_epu16 (kvRow1, kvRow2);
+      _mm_storel_epi64 ((__m128i*) (pDst + i), _mm_packus_epi16 (kvAvg, kvAvg));
+    }
+    if (i < kiDstWidth) {	// 4 pixels left as the source width is a multiple of 8
+      const __m128i kvRow1 = HalfAverageLine16_sse2 (_mm_loadl_epi64 ((const __m128i*) (pSrc + (i << 1))));
+      const __m128i kvRow2 = HalfAverageLine16_sse2 (_mm_loadl_epi64 ((const __m128i*) (pSrc + (i << 1) + kiSrcStride)));
+      const __m128i kvAvg  = _mm_avg_epu16 (kvRow1, kvRow2);
+      * ((int32_t*) (pDst + i)) = _mm_cvtsi128_si32 (_mm_packus_epi16 (kvAvg, kvAvg));
+    }
+    pDst += kiDstStride;
+    pSrc += kiSrcStride << 1;
+  }
+}
+
+WELSVP_TARGET ("sse2")
+void DyadicBilinearDownsamplerWidthx16_sse2 (uint8_t* pDst, const int32_t kiDstStride,
+    uint8_t* pSrc, const int32_t kiSrcStride,
+    const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  const int32_t kiDstWidth	= kiSrcWidth >> 1;
+  const int32_t kiDstHeight	= kiSrcHeight >> 1;
+
+  for (int32_t j = 0; j < kiDstHeight; j ++) {
+    for (int32_t i = 0; i < kiDstWidth; i += 8) {
+      const __m128i kvRow1 = HalfAverageLine16_sse2 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1))));
+      const __m128i kvRow2 = HalfAverageLine16_sse2 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1) + kiSrcStride)));
+      const __m128i kvAvg  = _mm_avg_epu16 (kvRow1, kvRow2);
+      _mm_storel_epi64 ((__m128i*) (pDst + i), _mm_packus_epi16 (kvAvg, kvAvg));
+    }
+    pDst += kiDstStride;
+    pSrc += kiSrcStride << 1;
+  }
+}
+
+/* 32 source bytes to 16 horizontal averages, pshufb gathers the even bytes in the low half and the odd in the high */
+WELSVP_TARGET ("ssse3")
+static inline __m128i HalfAverageLine32_ssse3 (const uint8_t* pSrc, const __m128i kvShuffle) {
+  const __m128i kvLo = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*)pSrc), kvShuffle);
+  const __m128i kvHi = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc + 16)), kvShuffle);
+  return _mm_avg_epu8 (_mm_unpacklo_epi64 (kvLo, kvHi), _mm_unpackhi_epi64 (kvLo, kvHi));
+}
+
+/* 16 source bytes to 8 horizontal averages in the low half */
+WELSVP_TARGET ("ssse3")
+static inline __m128i HalfAverageLine16_ssse3 (const uint8_t* pSrc, const __m128i kvShuffle) {
+  const __m128i kvLine = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*)pSrc), kvShuffle);
+  return _mm_avg_epu8 (kvLine, _mm_srli_si128 (kvLine, 8));
+}
+
+WELSVP_TARGET ("ssse3")
+void DyadicBilinearDownsamplerWidthx16_ssse3 (uint8_t* pDst, const int32_t kiDstStride,
+    uint8_t* pSrc, const int32_t kiSrcStride,
+    const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  const __m128i kvShuffle	= _mm_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+  const int32_t kiDstWidth	= kiSrcWidth >> 1;
+  const int32_t kiDstHeight	= kiSrcHeight >> 1;
+
+  for (int32_t j = 0; j < kiDstHeight; j ++) {
+    int32_t i = 0;
+    for (; i + 16 <= kiDstWidth; i += 16) {
+      const __m128i kvRow1 = HalfAverageLine32_ssse3 (pSrc + (i << 1), kvShuffle);
+      const __m128i kvRow2 = HalfAverageLine32_ssse3 (pSrc + (i << 1) + kiSrcStride, kvShuffle);
+      _mm_storeu_si128 ((__m128i*) (pDst + i), _mm_avg_epu8 (kvRow1, kvRow2));
+    }
+    if (i < kiDstWidth) {
+      const __m128i kvRow1 = HalfAverageLine16_ssse3 (pSrc + (i << 1), kvShuffle);
+      const __m128i kvRow2 = HalfAverageLine16_ssse3 (pSrc + (i << 1) + kiSrcStride, kvShuffle);
+      _mm_storel_epi64 ((__m128i*) (pDst + i), _mm_avg_epu8 (kvRow1, kvRow2));
+    }
+    pDst += kiDstStride;
+    pSrc += kiSrcStride << 1;
+  }
+}
+
+WELSVP_TARGET ("ssse3")
+void DyadicBilinearDownsamplerWidthx32_ssse3 (uint8_t* pDst, const int32_t kiDstStride,
+    uint8_t* pSrc, const int32_t kiSrcStride,
+    const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  const __m128i kvShuffle	= _mm_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+  const int32_t kiDstWidth	= kiSrcWidth >> 1;
+  const int32_t kiDstHeight	= kiSrcHeight >> 1;
+
+  for (int32_t j = 0; j < kiDstHeight; j ++) {
+    for (int32_t i = 0; i < kiDstWidth; i += 16) {
+      const __m128i kvRow1 = HalfAverageLine32_ssse3 (pSrc + (i << 1), kvShuffle);
+      const __m128i kvRow2 = HalfAverageLine32_ssse3 (pSrc + (i << 1) + kiSrcStride, kvShuffle);
+      _mm_storeu_si128 ((__m128i*) (pDst + i), _mm_avg_epu8 (kvRow1, kvRow2));
+    }
+    pDst += kiDstStride;
+    pSrc += kiSrcStride << 1;
+  }
+}
+
+/*
+ *	64 source bytes to 32 horizontal averages, vpshufb works within 128-bit lanes so the
+ *	quadwords come out as 0, 2, 1, 3 and are put back in order by the caller
+ */
+WELSVP_TARGET ("avx2")
+static inline __m256i HalfAverageLine64_avx2 (const uint8_t* pSrc, const __m256i kvShuffle) {
+  const __m256i kvLo = _mm256_shuffle_epi8 (_mm256_loadu_si256 ((const __m256i*)pSrc), kvShuffle);
+  const __m256i kvHi = _mm256_shuffle_epi8 (_mm256_loadu_si256 ((const __m256i*) (pSrc + 32)), kvShuffle);
+  return _mm256_avg_epu8 (_mm256_unpacklo_epi64 (kvLo, kvHi), _mm256_unpackhi_epi64 (kvLo, kvHi));
+}
+
+WELSVP_TARGET ("avx2")
+void DyadicBilinearDownsamplerWidthx32_avx2 (uint8_t* pDst, const int32_t kiDstStride,
+    uint8_t* pSrc, const int32_t kiSrcStride,
+    const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  const __m256i kvShuffle	= _mm256_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                            0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+  const int32_t kiDstWidth	= kiSrcWidth >> 1;
+  const int32_t kiDstHeight	= kiSrcHeight >> 1;
+
+  for (int32_t j = 0; j < kiDstHeight; j ++) {
+    int32_t i = 0;
+    for (; i + 32 <= kiDstWidth; i += 32) {
+      const __m256i kvRow1 = HalfAverageLine64_avx2 (pSrc + (i << 1), kvShuffle);
+      const __m256i kvRow2 = HalfAverageLine64_avx2 (pSrc + (i << 1) + kiSrcStride, kvShuffle);
+      _mm256_storeu_si256 ((__m256i*) (pDst + i), _mm256_permute4x64_epi64 (_mm256_avg_epu8 (kvRow1, kvRow2), 0xd8));
+    }
+    if (i < kiDstWidth) {	// 16 pixels left as the source width is a multiple of 32
+      const __m128i kvShuffle128 = _mm256_castsi256_si128 (kvShuffle);
+      const __m128i kvLo1 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1))), kvShuffle128);
+      const __m128i kvHi1 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1) + 16)), kvShuffle128);
+      const __m128i kvLo2 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1) + kiSrcStride)),
+                                              kvShuffle128);
+      const __m128i kvHi2 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc + (i << 1) + kiSrcStride + 16)),
+                                              kvShuffle128);
+      const __m128i kvRow1 = _mm_avg_epu8 (_mm_unpacklo_epi64 (kvLo1, kvHi1), _mm_unpackhi_epi64 (kvLo1, kvHi1));
+      const __m128i kvRow2 = _mm_avg_epu8 (_mm_unpacklo_epi64 (kvLo2, kvHi2), _mm_unpackhi_epi64 (kvLo2, kvHi2));
+      _mm_storeu_si128 ((__m128i*) (pDst + i), _mm_avg_epu8 (kvRow1, kvRow2));
+    }
+    pDst += kiDstStride;
+    pSrc += kiSrcStride << 1;
+  }
+}
+
+/*
+ *	general ratio: the horizontal source position and phase of every output column are the same on all
+ *	rows, so they are worked out once per plane and each row then only gathers the (a, b) and (c, d)
+ *	byte pairs of its columns
+ */
+
+typedef struct TagColumnTable {
+  int32_t		iBodyWidth;		// interpolated columns, the last column is copied
+  int32_t		iLastX;			// source position of the last column
+  int32_t*		pSrcX;			// integer source position of each interpolated column
+  int16_t*		pWeightX;		// (scale - 1 - phase, phase) of each interpolated column
+  uint8_t*		pShuffle;		// pshufb pattern gathering the pairs of each 8 columns from 16 bytes, 0x80 if they span more
+} SColumnTable;
+
+typedef void (BilinearRowFunc) (uint8_t* pDst, const uint8_t* pSrc, const int32_t kiSrcStride,
+                                const SColumnTable* kpTable, const int32_t kiFv);
+
+static bool InitColumnTable (SColumnTable* pTable, const int32_t kiBodyWidth, const int32_t kiSrcWidth,
+                             const int32_t kiScaleBit, const int32_t kiScaleX) {
+  const int32_t kiScale = 1 << kiScaleBit;
+  const int32_t kiGroupNum = kiBodyWidth >> 3;
+  int32_t iXInverse = 1 << (kiScaleBit - 1);
+
+  pTable->pSrcX = (int32_t*)WelsMalloc (kiBodyWidth * (sizeof (int32_t) + 2 * sizeof (int16_t)) + (kiGroupNum << 4));
+  if (NULL == pTable->pSrcX)
+    return false;
+  pTable->pWeightX	= (int16_t*) (pTable->pSrcX + kiBodyWidth);
+  pTable->pShuffle	= (uint8_t*) (pTable->pWeightX + (kiBodyWidth << 1));
+  pTable->iBodyWidth	= kiBodyWidth;
+
+  for (int32_t j = 0; j < kiBodyWidth; j++) {
+    const int32_t kiFu = iXInverse & (kiScale - 1);
+    pTable->pSrcX[j]				= iXInverse >> kiScaleBit;
+    pTable->pWeightX[ (j << 1)]		= (int16_t) (kiScale - 1 - kiFu);
+    pTable->pWeightX[ (j << 1) + 1]	= (int16_t)kiFu;
+    iXInverse += kiScaleX;
+  }
+  pTable->iLastX = iXInverse >> kiScaleBit;
+
+  for (int32_t g = 0; g < kiGroupNum; g++) {
+    const int32_t* kpSrcX	= pTable->pSrcX + (g << 3);
+    uint8_t* pShuffle		= pTable->pShuffle + (g << 4);
+    // the 16 bytes loaded must cover the pairs and stay within the source line
+    if (kpSrcX[7] + 1 - kpSrcX[0] > 15 || kpSrcX[0] + 16 > kiSrcWidth) {
+      pShuffle[0] = 0x80;
+      continue;
+    }
+    for (int32_t k = 0; k < 8; k++) {
+      pShuffle[ (k << 1)]		= (uint8_t) (kpSrcX[k] - kpSrcX[0]);
+      pShuffle[ (k << 1) + 1]	= (uint8_t) (kpSrcX[k] - kpSrcX[0] + 1);
+    }
+  }
+  return true;
+}
+
+static void UninitColumnTable (SColumnTable* pTable) {
+  WelsFree (pTable->pSrcX);
+  pTable->pSrcX = NULL;
+}
+
+/* a and b of 8 columns as 16 bytes, a in the low byte of each word */
+WELSVP_TARGET ("sse2")
+static inline __m128i GatherPairs8_sse2 (const uint8_t* pSrc, const int32_t* kpSrcX) {
+#define PAIR(k) ((int16_t) (pSrc[kpSrcX[k]] | (pSrc[kpSrcX[k] + 1] << 8)))
+  return _mm_setr_epi16 (PAIR (0), PAIR (1), PAIR (2), PAIR (3), PAIR (4), PAIR (5), PAIR (6), PAIR (7));
+#undef PAIR
+}
+
+WELSVP_TARGET ("ssse3")
+static inline __m128i GatherPairs8_ssse3 (const uint8_t* pSrc, const int32_t* kpSrcX, const uint8_t* kpShuffle) {
+  if (kpShuffle[0] & 0x80)
+    return GatherPairs8_sse2 (pSrc, kpSrcX);
+  return _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (pSrc + kpSrcX[0])),
+                           _mm_loadu_si128 ((const __m128i*)kpShuffle));
+}
+
+/*
+ *	fast: scale bits are 16 horizontally and 15 vertically, the 4 weights of each pixel are
+ *	(wx * wy) >> 16 which is exactly what pmulhuw gives, and stay below 2^15 for pmaddwd
+ */
+#define FAST_SCALE_BIT_X	16
+#define FAST_SCALE_BIT_Y	15
+
+WELSVP_TARGET ("sse2")
+static inline __m128i FastBilinear4_sse2 (const __m128i kvAb, const __m128i kvCd, const __m128i kvWeightX,
+    const __m128i kvWeightY0, const __m128i kvWeightY1) {
+  const __m128i kvSum = _mm_add_epi32 (_mm_madd_epi16 (kvAb, _mm_mulhi_epu16 (kvWeightX, kvWeightY0)),
+                                       _mm_madd_epi16 (kvCd, _mm_mulhi_epu16 (kvWeightX, kvWeightY1)));
+  return _mm_srli_epi32 (_mm_add_epi32 (_mm_srli_epi32 (kvSum, FAST_SCALE_BIT_Y - 1), _mm_set1_epi32 (1)), 1);
+}
+
+WELSVP_TARGET ("sse2")
+static inline void FastBilinear8_sse2 (uint8_t* pDst, const __m128i kvAb, const __m128i kvCd, const int16_t* kpWeightX,
+                                       const __m128i kvWeightY0, const __m128i kvWeightY1) {
+  const __m128i kvZero = _mm_setzero_si128();
+  const __m128i kvLo = FastBilinear4_sse2 (_mm_unpacklo_epi8 (kvAb, kvZero), _mm_unpacklo_epi8 (kvCd, kvZero),
+                       _mm_loadu_si128 ((const __m128i*)kpWeightX), kvWeightY0, kvWeightY1);
+  const __m128i kvHi = FastBilinear4_sse2 (_mm_unpackhi_epi8 (kvAb, kvZero), _mm_unpackhi_epi8 (kvCd, kvZero),
+                       _mm_loadu_si128 ((const __m128i*) (kpWeightX + 8)), kvWeightY0, kvWeightY1);
+  const __m128i kvOut = _mm_packs_epi32 (kvLo, kvHi);
+  _mm_storel_epi64 ((__m128i*)pDst, _mm_packus_epi16 (kvOut, kvOut));
+}
+
+static inline void FastBilinearTail_c (uint8_t* pDst, const uint8_t* pSrc, const int32_t kiSrcStride,
+                                       const SColumnTable* kpTable, const int32_t kiFv, int32_t j) {
+  const uint32_t kuiWeightY0 = (1 << FAST_SCALE_BIT_Y) - 1 - kiFv;
+  for (; j < kpTable->iBodyWidth; j++) {
+    const uint8_t* pByCurrent = pSrc + kpTable->pSrcX[j];
+    const uint32_t kuiWeightX0 = (uint16_t)kpTable->pWeightX[ (j << 1)];
+    const uint32_t kuiWeightX1 = (uint16_t)kpTable->pWeightX[ (j << 1) + 1];
+    uint32_t x;
+
+    x  = ((kuiWeightX0 * kuiWeightY0) >> FAST_SCALE_BIT_X) * pByCurrent[0];
+    x += ((kuiWeightX1 * kuiWeightY0) >> FAST_SCALE_BIT_X) * pByCurrent[1];
+    x += ((kuiWeightX0 * kiFv) >> FAST_SCALE_BIT_X) * pByCurrent[kiSrcStride];
+    x += ((kuiWeightX1 * kiFv) >> FAST_SCALE_BIT_X) * pByCurrent[kiSrcStride + 1];
+    x >>= (FAST_SCALE_BIT_Y - 1);
+    x += 1;
+    x >>= 1;
+    pDst[j] = (uint8_t)WELS_CLAMP (x, 0, 255);
+  }
+}
+
+WELSVP_TARGET ("sse2")
+static void FastBilinearRow_sse2 (uint8_t* pDst, const uint8_t* pSrc, const int32_t kiSrcStride,
+                                  const SColumnTable* kpTable, const int32_t kiFv) {
+  const __m128i kvWeightY0 = _mm_set1_epi16 ((int16_t) ((1 << FAST_SCALE_BIT_Y) - 1 - kiFv));
+  const __m128i kvWeightY1 = _mm_set1_epi16 ((int16_t)kiFv);
+  int32_t j = 0;
+  for (; j + 8 <= kpTable->iBodyWidth; j += 8) {
+    FastBilinear8_sse2 (pDst + j, GatherPairs8_sse2 (pSrc, kpTable->pSrcX + j),
+                        GatherPairs8_sse2 (pSrc + kiSrcStride, kpTable->pSrcX + j), kpTable->pWeightX + (j << 1),
+                        kvWeightY0, kvWeightY1);
+  }
+  FastBilinearTail_c (pDst, pSrc, kiSrcStride, kpTable, kiFv, j);
+}
+
+WELSVP_TARGET ("ssse3")
+static void FastBilinearRow_ssse3 (uint8_t* pDst, const uint8_t* pSrc, const int32_t kiSrcStride,
+                                   const SColumnTable* kpTable, const int32_t kiFv) {
+  const __m128i kvWeightY0 = _mm_set1_epi16 ((int16_t) ((1 << FAST_SCALE_BIT_Y) - 1 - kiFv));
+  const __m128i kvWeightY1 = _mm_set1_epi16 ((int16_t)kiFv);
+  int32_t j = 0;
+  for (; j + 8 <= kpTable->iBodyWidth; j += 8) {
+    const uint8_t* kpShuffle = kpTable->pShuffle + (j << 1);
+    FastBilinear8_sse2 (pDst + j, GatherPairs8_ssse3 (pSrc, kpTable->pSrcX + j, kpShuffle),
+                        GatherPairs8_ssse3 (pSrc + kiSrcStride, kpTable->pSrcX + j, kpShuffle), kpTable->pWeightX + (j << 1),
+                        kvWeightY0, kvWeightY1);
+  }
+  FastBilinearTail_c (pDst, pSrc, kiSrcStride, kpTable, kiFv, j);
+}
+
+/*
+ *	accurate: 15 scale bits both ways, the horizontal sums fit in 23 bits but the vertical pass needs
+ *	the full 64-bit products of the c version
+ */
+#define ACCURATE_SCALE_BIT	15
+
+WELSVP_TARGET ("sse2")
+static inline __m128i AccurateBilinear4_sse2 (const __m128i kvAb, const __m128i kvCd, const __m128i kvWeightX,
+    const __m128i kvWeightY0, const __m128i kvWeightY1) {
+  const __m128i kvRound	= _mm_set_epi32 (0, 1 << (2 * ACCURATE_SCALE_BIT - 1), 0, 1 << (2 * ACCURATE_SCALE_BIT - 1));
+  const __m128i kvTop		= _mm_madd_epi16 (kvAb, kvWeightX);
+  const __m128i kvBottom	= _mm_madd_epi16 (kvCd, kvWeightX);
+  __m128i kvEven = _mm_add_epi64 (_mm_mul_epu32 (kvTop, kvWeightY0), _mm_mul_epu32 (kvBottom, kvWeightY1));
+  __m128i kvOdd  = _mm_add_epi64 (_mm_mul_epu32 (_mm_srli_epi64 (kvTop, 32), kvWeightY0),
+                                  _mm_mul_epu32 (_mm_srli_epi64 (kvBottom, 32), kvWeightY1));
+  kvEven = _mm_srli_epi64 (_mm_add_epi64 (kvEven, kvRound), 2 * ACCURATE_SCALE_BIT);
+  kvOdd  = _mm_srli_epi64 (_mm_add_epi64 (kvOdd, kvRound), 2 * ACCURATE_SCALE_BIT);
+  return _mm_or_si128 (kvEven, _mm_slli_epi64 (kvOdd, 32));
+}
+
+WELSVP_TARGET ("sse2")
+static inline void AccurateBilinear8_sse2 (uint8_t* pDst, const __m128i kvAb, const __m128i kvCd,
+    const int16_t* kpWeightX, const __m128i kvWeightY0, const __m128i kvWeightY1) {
+  const __m128i kvZero = _mm_setzero_si128();
+  const __m128i kvLo = AccurateBilinear4_sse2 (_mm_unpacklo_epi8 (kvAb, kvZero), _mm_unpacklo_epi8 (kvCd, kvZero),
+                       _mm_loadu_si128 ((const __m128i*)kpWeightX), kvWeightY0, kvWeightY1);
+  const __m128i kvHi = AccurateBilinear4_sse2 (_mm_unpackhi_epi8 (kvAb, kvZero), _mm_unpackhi_epi8 (kvCd, kvZero),
+                       _mm_loadu_si128 ((const __m128i*) (kpWeightX + 8)), kvWeightY0, kvWeightY1);
+  const __m128i kvOut = _mm_packs_epi32 (kvLo, kvHi);
+  _mm_storel_epi64 ((__m128i*)pDst, _mm_packus_epi16 (kvOut, kvOut));
+}
+
+static inline void AccurateBilinearTail_c (uint8_t* pDst, const uint8_t* pSrc, const int32_t kiSrcStride,
+    const SColumnTable* kpTable, const int32_t kiFv, int32_t j) {
+  const int64_t kiWeightY0 = (1 << ACCURATE_SCALE_BIT) - 1 - kiFv;
+  for (; j < kpTable->iBodyWidth; j++) {
+    const uint8_t* pByCurrent = pSrc + kpTable->pSrcX[j];
+    const int64_t kiWeightX0 = kpTable->pWeightX[ (j << 1)];
+    const int64_t kiWeightX1 = kpTable->pWeightX[ (j << 1) + 1];
+    int64_t x;
+
+    x = (kiWeightX0 * kiWeightY0 * pByCurrent[0] + kiWeightX1 * kiWeightY0 * pByCurrent[1] +
+         kiWeightX0 * kiFv * pByCurrent[kiSrcStride] + kiWeightX1 * kiFv * pByCurrent[kiSrcStride + 1] +
+         (int64_t) (1 << (2 * ACCURATE_SCALE_BIT - 1))) >> (2 * ACCURATE_SCALE_BIT);
+    pDst[j] = (uint8_t)WELS_CLAMP (x, 0, 255);
+  }
+}
+
+WELSVP_TARGET ("sse2")
+static void AccurateBilinearRow_sse2 (uint8_t* pDst, const uint8_t* pSrc, const int32_t kiSrcStride,
+                                      const SColumnTable* kpTable, const int32_t kiFv) {
+  const __m128i kvWeightY0 = _mm_set1_epi32 ((1 << ACCURATE_SCALE_BIT) - 1 - kiFv);
+  const __m128i kvWeightY1 = _mm_set1_epi32 (kiFv);
+  int32_t j = 0;
+  for (; j + 8 <= kpTable->iBodyWidth; j += 8) {
+    AccurateBilinear8_sse2 (pDst + j, GatherPairs8_sse2 (pSrc, kpTable->pSrcX + j),
+                            GatherPairs8_sse2 (pSrc + kiSrcStride, kpTable->pSrcX + j), kpTable->pWeightX + (j << 1),
+                            kvWeightY0, kvWeightY1);
+  }
+  AccurateBilinearTail_c (pDst, pSrc, kiSrcStride, kpTable, kiFv, j);
+}
+
+WELSVP_TARGET ("ssse3")
+static void AccurateBilinearRow_ssse3 (uint8_t* pDst, const uint8_t* pSrc, const int32_t kiSrcStride,
+                                       const SColumnTable* kpTable, const int32_t kiFv) {
+  const __m128i kvWeightY0 = _mm_set1_epi32 ((1 << ACCURATE_SCALE_BIT) - 1 - kiFv);
+  const __m128i kvWeightY1 = _mm_set1_epi32 (kiFv);
+  int32_t j = 0;
+  for (; j + 8 <= kpTable->iBodyWidth; j += 8) {
+    const uint8_t* kpShuffle = kpTable->pShuffle + (j << 1);
+    AccurateBilinear8_sse2 (pDst + j, GatherPairs8_ssse3 (pSrc, kpTable->pSrcX + j, kpShuffle),
+                            GatherPairs8_ssse3 (pSrc + kiSrcStride, kpTable->pSrcX + j, kpShuffle), kpTable->pWeightX + (j << 1),
+                            kvWeightY0, kvWeightY1);
+  }
+  AccurateBilinearTail_c (pDst, pSrc, kiSrcStride, kpTable, kiFv, j);
+}
+
+/* same walk over the rows as the c versions, the rows but the last are interpolated by pfRow */
+static bool GeneralBilinearDownsample (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+                                       const int32_t kiDstHeight,
+                                       uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight,
+                                       const int32_t kiScaleBitX, const int32_t kiScaleBitY, BilinearRowFunc* pfRow) {
+  const int32_t kiScaleY = 1 << kiScaleBitY;
+  int32_t iScalex = (int32_t) ((float)kiSrcWidth / (float)kiDstWidth * (1 << kiScaleBitX));
+  int32_t iScaley = (int32_t) ((float)kiSrcHeight / (float)kiDstHeight * kiScaleY);
+  SColumnTable sTable;
+  int32_t iYInverse;
+
+  if (kiDstWidth <= 8 || !InitColumnTable (&sTable, kiDstWidth - 1, kiSrcWidth, kiScaleBitX, iScalex))
+    return false;
+
+  iYInverse = 1 << (kiScaleBitY - 1);
+  for (int32_t i = 0; i < kiDstHeight - 1; i++) {
+    const uint8_t* kpBySrc = pSrc + (iYInverse >> kiScaleBitY) * kiSrcStride;
+    pfRow (pDst, kpBySrc, kiSrcStride, &sTable, iYInverse & (kiScaleY - 1));
+    pDst[sTable.iBodyWidth] = kpBySrc[sTable.iLastX];
+    pDst += kiDstStride;
+    iYInverse += iScaley;
+  }
+
+  // last row special
+  {
+    const uint8_t* kpBySrc = pSrc + (iYInverse >> kiScaleBitY) * kiSrcStride;
+    for (int32_t j = 0; j < sTable.iBodyWidth; j++)
+      pDst[j] = kpBySrc[sTable.pSrcX[j]];
+    pDst[sTable.iBodyWidth] = kpBySrc[sTable.iLastX];
+  }
+
+  UninitColumnTable (&sTable);
+  return true;
+}
+
+void GeneralBilinearFastDownsampler_sse2 (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+    const int32_t kiDstHeight,
+    uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  if (!GeneralBilinearDownsample (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth, kiSrcHeight,
+                                  FAST_SCALE_BIT_X, FAST_SCALE_BIT_Y, FastBilinearRow_sse2))
+    GeneralBilinearFastDownsampler_c (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth,
+                                      kiSrcHeight);
+}
+
+void GeneralBilinearFastDownsampler_ssse3 (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+    const int32_t kiDstHeight,
+    uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  if (!GeneralBilinearDownsample (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth, kiSrcHeight,
+                                  FAST_SCALE_BIT_X, FAST_SCALE_BIT_Y, FastBilinearRow_ssse3))
+    GeneralBilinearFastDownsampler_c (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth,
+                                      kiSrcHeight);
+}
+
+void GeneralBilinearAccurateDownsampler_sse2 (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+    const int32_t kiDstHeight,
+    uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  if (!GeneralBilinearDownsample (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth, kiSrcHeight,
+                                  ACCURATE_SCALE_BIT, ACCURATE_SCALE_BIT, AccurateBilinearRow_sse2))
+    GeneralBilinearAccurateDownsampler_c (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth,
+                                          kiSrcHeight);
+}
+
+void GeneralBilinearAccurateDownsampler_ssse3 (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+    const int32_t kiDstHeight,
+    uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
+  if (!GeneralBilinearDownsample (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth, kiSrcHeight,
+                                  ACCURATE_SCALE_BIT, ACCURATE_SCALE_BIT, AccurateBilinearRow_ssse3))
+    GeneralBilinearAccurateDownsampler_c (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth,
+                                          kiSrcHeight);
+}
+
+WELSVP_NAMESPACE_END
+
+#endif//X86_ASM
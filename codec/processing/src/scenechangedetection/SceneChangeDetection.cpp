@@ -47,6 +47,7 @@ CSceneChangeDetection::CSceneChangeDetection (int32_t iCpuFlag) {
   m_eMethod   = METHOD_SCENE_CHANGE_DETECTION;
   m_pfSad   = NULL;
   WelsMemset (&m_sSceneChangeParam, 0, sizeof (m_sSceneChangeParam));
+  WelsMemset (&m_sCalcParam, 0, sizeof (m_sCalcParam));
   InitSadFuncs (m_pfSad, m_iCpuFlag);
 }
 
@@ -83,21 +84,30 @@ EResult CSceneChangeDetection::Process (int32_t iType, SPixMap* pSrcPixMap, SPix
 
   m_sSceneChangeParam.bSceneChangeFlag = 0;
 
-  for (int32_t j = 0; j < iBlock8x8Height; j ++) {
-    pRefTmp	= pRefY;
-    pCurTmp 	= pCurY;
+  if (CanReuseCalcResult (pCurY, pRefY, iWidth, iHeight, iCurStride, iRefStride)) {
+    // 8x8 sad of the same pictures is there in vaa statistics, no need to read the pictures again
+    int32_t* pSad8x8 = (int32_t*)m_sCalcParam.pCalcResult->pSad8x8;
 
-    for (int32_t i = 0; i < iBlock8x8Width; i++) {
-      iBlockSad = m_pfSad (pRefTmp, iRefStride, pCurTmp, iCurStride);
+    for (int32_t i = 0; i < iBlock8x8Num; i++) {
+      iMotionBlockNum += (pSad8x8[i] > HIGH_MOTION_BLOCK_THRESHOLD);
+    }
+  } else {
+    for (int32_t j = 0; j < iBlock8x8Height; j ++) {
+      pRefTmp	= pRefY;
+      pCurTmp 	= pCurY;
 
-      iMotionBlockNum += (iBlockSad > HIGH_MOTION_BLOCK_THRESHOLD);
+      for (int32_t i = 0; i < iBlock8x8Width; i++) {
+        iBlockSad = m_pfSad (pRefTmp, iRefStride, pCurTmp, iCurStride);
 
-      pRefTmp += 8;
-      pCurTmp += 8;
-    }
+        iMotionBlockNum += (iBlockSad > HIGH_MOTION_BLOCK_THRESHOLD);
+
+        pRefTmp += 8;
+        pCurTmp += 8;
+      }
 
-    pRefY += iRefRowStride;
-    pCurY += iCurRowStride;
+      pRefY += iRefRowStride;
+      pCurY += iCurRowStride;
+    }
   }
 
   if (iMotionBlockNum >= iSceneChangeThreshold) {
@@ -120,6 +130,31 @@ EResult CSceneChangeDetection::Get (int32_t iType, void* pParam) {
   return RET_SUCCESS;
 }
 
+EResult CSceneChangeDetection::Set (int32_t iType, void* pParam) {
+  if (pParam == NULL) {
+    return RET_INVALIDPARAM;
+  }
+
+  m_sCalcParam = * (SSceneChangeParam*)pParam;
+
+  return RET_SUCCESS;
+}
+
+/*!
+ * \brief	whether the motion blocks can be counted on the 8x8 sad given by vaa statistics,
+ *			which is laid out in 16x16 blocks so only the pictures in whole macroblocks are covered
+ */
+bool CSceneChangeDetection::CanReuseCalcResult (uint8_t* pCurY, uint8_t* pRefY, int32_t iWidth, int32_t iHeight,
+    int32_t iCurStride, int32_t iRefStride) {
+  SVAACalcResult* pCalcResult = m_sCalcParam.pCalcResult;
+
+  if (pCalcResult == NULL || pCalcResult->pSad8x8 == NULL)
+    return false;
+
+  return (pCalcResult->pCurY == pCurY && pCalcResult->pRefY == pRefY && iCurStride == iRefStride
+          && (iWidth & 15) == 0 && (iHeight & 15) == 0);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 void CSceneChangeDetection::InitSadFuncs (SadFuncPtr& pfSad,  int32_t iCpuFlag) {
@@ -57,14 +57,18 @@ class CSceneChangeDetection : public IStrategy {
 
   EResult Process (int32_t iType, SPixMap* pSrc, SPixMap* pRef);
   EResult Get (int32_t iType, void* pParam);
+  EResult Set (int32_t iType, void* pParam);
 
  private:
   void InitSadFuncs (SadFuncPtr& pfSadFunc, int32_t iCpuFlag);
+  bool CanReuseCalcResult (uint8_t* pCurY, uint8_t* pRefY, int32_t iWidth, int32_t iHeight,
+                           int32_t iCurStride, int32_t iRefStride);
 
  private:
   SadFuncPtr m_pfSad;
   int32_t    m_iCpuFlag;
   SSceneChangeResult m_sSceneChangeParam;
+  SSceneChangeParam  m_sCalcParam;
 };
 
 WELSVP_NAMESPACE_END
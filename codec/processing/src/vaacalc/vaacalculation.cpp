@@ -70,9 +70,7 @@ void CVAACalculation::InitVaaFuncs (SVaaFuncs& sVaaFuncs, int32_t iCpuFlag) {
 EResult CVAACalculation::Process (int32_t iType, SPixMap* pSrcPixMap, SPixMap* pRefPixMap) {
   uint8_t* pCurData	= (uint8_t*)pSrcPixMap->pPixel[0];
   uint8_t* pRefData	= (uint8_t*)pRefPixMap->pPixel[0];
-  int32_t iPicWidth	= pSrcPixMap->sRect.iRectWidth;
-  int32_t iPicHeight	= pSrcPixMap->sRect.iRectHeight;
-  int32_t iPicStride	= pSrcPixMap->iStride[0];
+  SVaaStripeCtx sCtx;
 
   SVAACalcResult* pResult = m_sCalcParam.pCalcResult;
 
@@ -82,31 +80,70 @@ EResult CVAACalculation::Process (int32_t iType, SPixMap* pSrcPixMap, SPixMap* p
 
   pResult->pCurY = pCurData;
   pResult->pRefY = pRefData;
-  if (m_sCalcParam.iCalcBgd) {
-    if (m_sCalcParam.iCalcSsd) {
-      m_sVaaFuncs.pfVAACalcSadSsdBgd (pCurData, pRefData, iPicWidth, iPicHeight, iPicStride, &pResult->iFrameSad,
-                                      (int32_t*)pResult->pSad8x8, pResult->pSum16x16, pResult->pSumOfSquare16x16, pResult->pSsd16x16,
-                                      (int32_t*)pResult->pSumOfDiff8x8, (uint8_t*)pResult->pMad8x8);
+
+  sCtx.pVaaFuncs	= &m_sVaaFuncs;
+  sCtx.pCalcParam	= &m_sCalcParam;
+  sCtx.pCurData		= pCurData;
+  sCtx.pRefData		= pRefData;
+  sCtx.iPicWidth	= pSrcPixMap->sRect.iRectWidth;
+  sCtx.iPicStride	= pSrcPixMap->iStride[0];
+  sCtx.iMbHeight	= pSrcPixMap->sRect.iRectHeight >> 4;
+
+  const int32_t kiStripeNum = GetStripeNum (sCtx.iMbHeight);
+  RunStripes (ProcessStripe, &sCtx, kiStripeNum);
+
+  pResult->iFrameSad = 0;
+  for (int32_t i = 0; i < kiStripeNum; i++) {
+    pResult->iFrameSad += sCtx.iFrameSad[i];
+  }
+
+  return RET_SUCCESS;
+}
+
+void CVAACalculation::ProcessStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum) {
+  SVaaStripeCtx* pStripeCtx	= (SVaaStripeCtx*)pCtx;
+  const SVaaFuncs* kpFuncs	= pStripeCtx->pVaaFuncs;
+  const SVAACalcParam* kpParam	= pStripeCtx->pCalcParam;
+  SVAACalcResult* pResult	= kpParam->pCalcResult;
+  int32_t iStartRow = 0, iEndRow = 0;
+
+  GetStripeRows (pStripeCtx->iMbHeight, kiStripeIdx, kiStripeNum, &iStartRow, &iEndRow);
+
+  // the kernels see the stripe as a picture of its own, the statistics are laid out in mb raster order
+  const int32_t kiMbOffset	= iStartRow * (pStripeCtx->iPicWidth >> 4);
+  const int32_t kiPixOffset	= iStartRow * (pStripeCtx->iPicStride << 4);
+  const int32_t kiHeight	= (iEndRow - iStartRow) << 4;
+  const int32_t kiWidth		= pStripeCtx->iPicWidth;
+  const int32_t kiStride	= pStripeCtx->iPicStride;
+  uint8_t* pCurData	= pStripeCtx->pCurData + kiPixOffset;
+  uint8_t* pRefData	= pStripeCtx->pRefData + kiPixOffset;
+  int32_t* pFrameSad	= &pStripeCtx->iFrameSad[kiStripeIdx];
+  int32_t* pSad8x8	= (int32_t*) (pResult->pSad8x8 + kiMbOffset);
+
+  if (kpParam->iCalcBgd) {
+    int32_t* pSd8x8		= (int32_t*) (pResult->pSumOfDiff8x8 + kiMbOffset);
+    uint8_t* pMad8x8	= (uint8_t*) (pResult->pMad8x8 + kiMbOffset);
+    if (kpParam->iCalcSsd) {
+      kpFuncs->pfVAACalcSadSsdBgd (pCurData, pRefData, kiWidth, kiHeight, kiStride, pFrameSad, pSad8x8,
+                                   pResult->pSum16x16 + kiMbOffset, pResult->pSumOfSquare16x16 + kiMbOffset,
+                                   pResult->pSsd16x16 + kiMbOffset, pSd8x8, pMad8x8);
     } else {
-      m_sVaaFuncs.pfVAACalcSadBgd (pCurData, pRefData, iPicWidth, iPicHeight, iPicStride, &pResult->iFrameSad,
-                                   (int32_t*) (pResult->pSad8x8), (int32_t*) (pResult->pSumOfDiff8x8), (uint8_t*)pResult->pMad8x8);
+      kpFuncs->pfVAACalcSadBgd (pCurData, pRefData, kiWidth, kiHeight, kiStride, pFrameSad, pSad8x8, pSd8x8, pMad8x8);
     }
   } else {
-    if (m_sCalcParam.iCalcSsd) {
-      m_sVaaFuncs.pfVAACalcSadSsd (pCurData, pRefData, iPicWidth, iPicHeight, iPicStride, &pResult->iFrameSad,
-                                   (int32_t*)pResult->pSad8x8, pResult->pSum16x16, pResult->pSumOfSquare16x16, pResult->pSsd16x16);
+    if (kpParam->iCalcSsd) {
+      kpFuncs->pfVAACalcSadSsd (pCurData, pRefData, kiWidth, kiHeight, kiStride, pFrameSad, pSad8x8,
+                                pResult->pSum16x16 + kiMbOffset, pResult->pSumOfSquare16x16 + kiMbOffset,
+                                pResult->pSsd16x16 + kiMbOffset);
     } else {
-      if (m_sCalcParam.iCalcVar) {
-        m_sVaaFuncs.pfVAACalcSadVar (pCurData, pRefData, iPicWidth, iPicHeight, iPicStride, &pResult->iFrameSad,
-                                     (int32_t*)pResult->pSad8x8, pResult->pSum16x16, pResult->pSumOfSquare16x16);
+      if (kpParam->iCalcVar) {
+        kpFuncs->pfVAACalcSadVar (pCurData, pRefData, kiWidth, kiHeight, kiStride, pFrameSad, pSad8x8,
+                                  pResult->pSum16x16 + kiMbOffset, pResult->pSumOfSquare16x16 + kiMbOffset);
       } else {
-        m_sVaaFuncs.pfVAACalcSad (pCurData, pRefData, iPicWidth, iPicHeight, iPicStride, &pResult->iFrameSad,
-                                  (int32_t*)pResult->pSad8x8);
+        kpFuncs->pfVAACalcSad (pCurData, pRefData, kiWidth, kiHeight, kiStride, pFrameSad, pSad8x8);
       }
     }
   }
-
-  return RET_SUCCESS;
 }
 
 EResult CVAACalculation::Set (int32_t iType, void* pParam) {
@@ -103,6 +103,17 @@ VAACalcSadSsdFunc		VAACalcSadSsd_sse2;
 WELSVP_EXTERN_C_END
 #endif
 
+typedef struct TagVaaStripeCtx {
+  const SVaaFuncs*		pVaaFuncs;
+  const SVAACalcParam*	pCalcParam;
+  uint8_t*				pCurData;
+  uint8_t*				pRefData;
+  int32_t				iPicWidth;
+  int32_t				iPicStride;
+  int32_t				iMbHeight;
+  int32_t				iFrameSad[MAX_STRIPE_NUM];	// sad of each stripe, summed up once all are done
+} SVaaStripeCtx;
+
 class CVAACalculation : public IStrategy {
  public:
   CVAACalculation (int32_t iCpuFlag);
@@ -113,6 +124,7 @@ class CVAACalculation : public IStrategy {
 
  private:
   void InitVaaFuncs (SVaaFuncs& sVaaFunc, int32_t iCpuFlag);
+  static void ProcessStripe (void* pCtx, const int32_t kiStripeIdx, const int32_t kiStripeNum);
 
  private:
   SVaaFuncs      m_sVaaFuncs;
@@ -2,6 +2,9 @@ PROCESSING_SRCDIR=codec/processing
 PROCESSING_CPP_SRCS=\
 	$(PROCESSING_SRCDIR)/src/adaptivequantization/AdaptiveQuantization.cpp\
 	$(PROCESSING_SRCDIR)/src/backgrounddetection/BackgroundDetection.cpp\
+	$(PROCESSING_SRCDIR)/src/colorspace/colorspace.cpp\
+	$(PROCESSING_SRCDIR)/src/colorspace/colorspacefuncs.cpp\
+	$(PROCESSING_SRCDIR)/src/colorspace/colorspacefuncs_x86.cpp\
 	$(PROCESSING_SRCDIR)/src/common/memory.cpp\
 	$(PROCESSING_SRCDIR)/src/common/thread.cpp\
 	$(PROCESSING_SRCDIR)/src/common/WelsFrameWork.cpp\
@@ -9,8 +12,10 @@ PROCESSING_CPP_SRCS=\
 	$(PROCESSING_SRCDIR)/src/complexityanalysis/ComplexityAnalysis.cpp\
 	$(PROCESSING_SRCDIR)/src/denoise/denoise.cpp\
 	$(PROCESSING_SRCDIR)/src/denoise/denoise_filter.cpp\
+	$(PROCESSING_SRCDIR)/src/denoise/denoise_filter_x86.cpp\
 	$(PROCESSING_SRCDIR)/src/downsample/downsample.cpp\
 	$(PROCESSING_SRCDIR)/src/downsample/downsamplefuncs.cpp\
+	$(PROCESSING_SRCDIR)/src/downsample/downsamplefuncs_x86.cpp\
 	$(PROCESSING_SRCDIR)/src/imagerotate/imagerotate.cpp\
 	$(PROCESSING_SRCDIR)/src/imagerotate/imagerotatefuncs.cpp\
 	$(PROCESSING_SRCDIR)/src/scenechangedetection/SceneChangeDetection.cpp\
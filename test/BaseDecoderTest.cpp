@@ -46,7 +46,8 @@ static void ReadFrame(std::ifstream* file, BufferedData* buf) {
 BaseDecoderTest::BaseDecoderTest()
   : decoder_(NULL), decodeStatus_(OpenFile) {}
 
-void BaseDecoderTest::SetUp() {
+void BaseDecoderTest::SetUp(int threadCount, DECODER_THREADING_MODE threadingMode,
+    bool sharedThreadPool, bool deblockingThread) {
   long rv = CreateDecoder(&decoder_);
   ASSERT_EQ(0, rv);
   ASSERT_TRUE(decoder_ != NULL);
@@ -57,6 +58,10 @@ void BaseDecoderTest::SetUp() {
   decParam.uiTargetDqLayer = UCHAR_MAX;
   decParam.uiEcActiveFlag  = 1;
   decParam.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
+  decParam.iThreadCount = threadCount;
+  decParam.eThreadingMode = threadingMode;
+  decParam.bUseSharedThreadPool = sharedThreadPool;
+  decParam.bDeblockingThread = deblockingThread;
 
   rv = decoder_->Initialize(&decParam);
   ASSERT_EQ(0, rv);
@@ -70,7 +75,8 @@ void BaseDecoderTest::TearDown() {
 }
 
 
-void BaseDecoderTest::DecodeFrame(const uint8_t* src, int sliceSize, Callback* cbk) {
+void BaseDecoderTest::DecodeFrame(const uint8_t* src, int sliceSize, Callback* cbk,
+    bool* gotFrame) {
   void* data[3];
   SBufferInfo bufInfo;
   memset(data, 0, sizeof(data));
@@ -78,6 +84,9 @@ void BaseDecoderTest::DecodeFrame(const uint8_t* src, int sliceSize, Callback* c
 
   DECODING_STATE rv = decoder_->DecodeFrame2(src, sliceSize, data, &bufInfo);
   ASSERT_TRUE(rv == dsErrorFree);
+  if (gotFrame != NULL) {
+    *gotFrame = bufInfo.iBufferStatus == 1;
+  }
 
   if (bufInfo.iBufferStatus == 1 && cbk != NULL) {
     const Frame frame = {
@@ -125,8 +134,14 @@ void BaseDecoderTest::DecodeFile(const char* fileName, Callback* cbk) {
   int32_t iEndOfStreamFlag = 1;
   decoder_->SetOption(DECODER_OPTION_END_OF_STREAM, &iEndOfStreamFlag);
 
-  // Get pending last frame
-  DecodeFrame(NULL, 0, cbk);
+  // Get pending last frames, more than one may be delayed with multiple threads
+  bool gotFrame = true;
+  while (gotFrame) {
+    DecodeFrame(NULL, 0, cbk, &gotFrame);
+    if (::testing::Test::HasFatalFailure()) {
+      return;
+    }
+  }
 }
 
 bool BaseDecoderTest::Open(const char* fileName) {
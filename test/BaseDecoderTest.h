@@ -28,17 +28,21 @@ class BaseDecoderTest {
   };
 
   BaseDecoderTest();
-  void SetUp();
+  void SetUp(int threadCount = 0, DECODER_THREADING_MODE threadingMode = DECODER_THREADING_FRAME,
+      bool sharedThreadPool = false, bool deblockingThread = false);
   void TearDown();
   void DecodeFile(const char* fileName, Callback* cbk);
 
   bool Open(const char* fileName);
   bool DecodeNextFrame(Callback* cbk);
 
- private:
-  void DecodeFrame(const uint8_t* src, int sliceSize, Callback* cbk);
+ protected:
+  virtual void DecodeFrame(const uint8_t* src, int sliceSize, Callback* cbk, bool* gotFrame = NULL);
 
   ISVCDecoder* decoder_;
+
+ private:
+
   std::ifstream file_;
   BufferedData buf_;
   enum {
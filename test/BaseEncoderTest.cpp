@@ -18,7 +18,28 @@ static int InitWithParam(ISVCEncoder* encoder, int width,
   return encoder->Initialize(&param);
 }
 
-BaseEncoderTest::BaseEncoderTest() : encoder_(NULL) {}
+void BaseEncoderTest::FillParamExt(SEncParamExt* param, int width,
+    int height, float frameRate) {
+  memset (param, 0, sizeof(SEncParamExt));
+
+  param->fMaxFrameRate = frameRate;
+  param->iPicWidth = width;
+  param->iPicHeight = height;
+  param->iTargetBitrate = 5000000;
+  param->iInputCsp = videoFormatI420;
+  param->iRCMode = 1;
+  param->bEnableRc = true;
+  param->bEnableFrameSkip = false;
+  param->iTemporalLayerNum = 1;
+  param->iSpatialLayerNum = 1;
+  param->iMultipleThreadIdc = 1;
+  param->sSpatialLayers[0].iVideoWidth = width;
+  param->sSpatialLayers[0].iVideoHeight = height;
+  param->sSpatialLayers[0].fFrameRate = frameRate;
+  param->sSpatialLayers[0].iSpatialBitrate = param->iTargetBitrate;
+}
+
+BaseEncoderTest::BaseEncoderTest() : encoder_(NULL), async_(false), inPlace_(false) {}
 
 void BaseEncoderTest::SetUp() {
   int rv = CreateSVCEncoder(&encoder_);
@@ -34,8 +55,10 @@ void BaseEncoderTest::TearDown() {
 }
 
 void BaseEncoderTest::EncodeStream(InputStream* in, int width, int height,
-    float frameRate, Callback* cbk) {
-  int rv = InitWithParam(encoder_, width, height, frameRate);
+    float frameRate, Callback* cbk, const SEncParamExt* paramExt) {
+  int rv = paramExt != NULL ?
+      encoder_->InitializeExt(paramExt) :
+      InitWithParam(encoder_, width, height, frameRate);
   ASSERT_TRUE(rv == cmResultSuccess);
 
   // I420: 1(Y) + 1/4(U) + 1/4(V)
@@ -58,18 +81,76 @@ void BaseEncoderTest::EncodeStream(InputStream* in, int width, int height,
   pic.pData[0] = buf.data();
   pic.pData[1] = pic.pData[0] + width *height;
   pic.pData[2] = pic.pData[1] + (width*height>>2);
+  if (async_) {
+    int pending = 0;
+    while (in->read(buf.data(), frameSize) == frameSize) {
+      while ((rv = encoder_->EncodeFrameAsync(&pic)) == cmQueueFull) {
+        TakeEncodedFrame(&info, cbk, &pending);
+        ASSERT_FALSE(::testing::Test::HasFatalFailure());
+      }
+      ASSERT_TRUE(rv == cmResultSuccess);
+      ++pending;
+    }
+    while (pending > 0) {
+      TakeEncodedFrame(&info, cbk, &pending);
+      ASSERT_FALSE(::testing::Test::HasFatalFailure());
+    }
+    return;
+  }
   while (in->read(buf.data(), frameSize) == frameSize) {
-    rv = encoder_->EncodeFrame(&pic, &info);
+    if (inPlace_) {
+      SSourcePicture inPic;
+      ASSERT_TRUE(encoder_->GetOption(ENCODER_OPTION_INPUT_PICTURE, &inPic) == cmResultSuccess);
+      for (int i = 0; i < 3; ++i) {
+        int shift = (i > 0);
+        for (int j = 0; j < (height >> shift); ++j) {
+          memcpy(inPic.pData[i] + j * inPic.iStride[i], pic.pData[i] + j * pic.iStride[i], width >> shift);
+        }
+      }
+      rv = encoder_->EncodeFrame(&inPic, &info);
+    } else {
+      rv = encoder_->EncodeFrame(&pic, &info);
+    }
     ASSERT_TRUE(rv != videoFrameTypeInvalid);
+    if (rv != videoFrameTypeSkip && rv != videoFrameTypeDelayed && cbk != NULL) {
+      cbk->onEncodeFrame(info);
+    }
+  }
+}
+
+void BaseEncoderTest::DrainLookahead(Callback* cbk) {
+  SFrameBSInfo info;
+  memset(&info, 0, sizeof(SFrameBSInfo));
+  while (true) {
+    int rv;
+    if (async_) {
+      ASSERT_TRUE(encoder_->EncodeFrameAsync(NULL) == cmResultSuccess);
+      rv = encoder_->GetEncodedFrame(&info);
+    } else {
+      rv = encoder_->EncodeFrame(NULL, &info);
+    }
+    if (rv == videoFrameTypeInvalid) {
+      break;
+    }
+    ASSERT_TRUE(rv != videoFrameTypeDelayed);
     if (rv != videoFrameTypeSkip && cbk != NULL) {
       cbk->onEncodeFrame(info);
     }
   }
 }
 
+void BaseEncoderTest::TakeEncodedFrame(SFrameBSInfo* info, Callback* cbk, int* pending) {
+  int rv = encoder_->GetEncodedFrame(info);
+  --*pending;
+  ASSERT_TRUE(rv != videoFrameTypeInvalid);
+  if (rv != videoFrameTypeSkip && rv != videoFrameTypeDelayed && cbk != NULL) {
+    cbk->onEncodeFrame(*info);
+  }
+}
+
 void BaseEncoderTest::EncodeFile(const char* fileName, int width, int height,
-    float frameRate, Callback* cbk) {
+    float frameRate, Callback* cbk, const SEncParamExt* paramExt) {
   FileInputStream fileStream;
   ASSERT_TRUE(fileStream.Open(fileName));
-  EncodeStream(&fileStream, width, height, frameRate, cbk);
+  EncodeStream(&fileStream, width, height, frameRate, cbk, paramExt);
 }
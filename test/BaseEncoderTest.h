@@ -14,11 +14,26 @@ class BaseEncoderTest {
   BaseEncoderTest();
   void SetUp();
   void TearDown();
-  void EncodeFile(const char* fileName, int width, int height, float frameRate, Callback* cbk);
-  void EncodeStream(InputStream* in, int width, int height, float frameRate, Callback* cbk);
+  // paramExt is used instead of the basic defaults when given
+  void EncodeFile(const char* fileName, int width, int height, float frameRate, Callback* cbk,
+      const SEncParamExt* paramExt = NULL);
+  void EncodeStream(InputStream* in, int width, int height, float frameRate, Callback* cbk,
+      const SEncParamExt* paramExt = NULL);
+  // takes the frames still kept by lookahead once the input has ended
+  void DrainLookahead(Callback* cbk);
+
+  static void FillParamExt(SEncParamExt* param, int width, int height, float frameRate);
+  // frames are queued by EncodeFrameAsync and taken by GetEncodedFrame when set
+  void SetAsync(bool async) { async_ = async; }
+  // frames are written into the picture of ENCODER_OPTION_INPUT_PICTURE when set
+  void SetInPlaceInput(bool inPlace) { inPlace_ = inPlace; }
 
  private:
+  void TakeEncodedFrame(SFrameBSInfo* info, Callback* cbk, int* pending);
+
   ISVCEncoder* encoder_;
+  bool async_;
+  bool inPlace_;
 };
 
 #endif //__BASEENCODERTEST_H__
@@ -19,6 +19,8 @@ void CheckEncoderInterface(ISVCEncoder* p, CheckFunc check) {
   CHECK(7, p, ForceIntraFrame);
   CHECK(8, p, SetOption);
   CHECK(9, p, GetOption);
+  CHECK(10, p, EncodeFrameAsync);
+  CHECK(11, p, GetEncodedFrame);
 }
 
 void CheckDecoderInterface(ISVCDecoder* p, CheckFunc check) {
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.h"
+#include "cpu_core.h"
+#include "au_parser.h"
+
+using namespace WelsDec;
+
+#define MAX_SCAN_LEN 160
+#define TAIL_LEN 4 // bytes behind the scanned length copied along, they must not change the result
+
+static int32_t DetectEscOrStartCodeRef (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  for (int32_t i = 0; i + 2 < kiBufSize; ++i) {
+    if (kpBuf[i] == 0 && kpBuf[i + 1] == 0 && (kpBuf[i + 2] == 0x03 || kpBuf[i + 2] == 0x01))
+      return i;
+  }
+  return kiBufSize;
+}
+
+static int GetScanners (PDetectEscOrStartCodeFunc* pScanners) {
+  int iNum = 0;
+  pScanners[iNum++] = DetectEscOrStartCode_c;
+#if defined(X86_ASM)
+  const uint32_t kuiCpuFlags = WelsCPUFeatureDetect (NULL);
+  if (kuiCpuFlags & WELS_CPU_SSE2)
+    pScanners[iNum++] = DetectEscOrStartCode_sse2;
+  if (kuiCpuFlags & WELS_CPU_AVX2)
+    pScanners[iNum++] = DetectEscOrStartCode_avx2;
+#endif
+  return iNum;
+}
+
+// checks every scanner at every misalignment of the buffer start, kpSrc has TAIL_LEN bytes behind kiLen
+static void CheckAllScanners (const uint8_t* kpSrc, const int32_t kiLen) {
+  uint8_t uiBuf[32 + MAX_SCAN_LEN + TAIL_LEN];
+  PDetectEscOrStartCodeFunc pScanners[3];
+  const int kiNum = GetScanners (pScanners);
+  const int32_t kiExpected = DetectEscOrStartCodeRef (kpSrc, kiLen);
+  for (int iAlign = 0; iAlign < 32; ++iAlign) {
+    memset (uiBuf, 0, sizeof (uiBuf));
+    memcpy (uiBuf + iAlign, kpSrc, kiLen + TAIL_LEN);
+    for (int i = 0; i < kiNum; ++i) {
+      ASSERT_EQ (kiExpected, pScanners[i] (uiBuf + iAlign, kiLen)) << "scanner " << i << " len " << kiLen << " align "
+          << iAlign;
+    }
+  }
+}
+
+TEST (DecUT_AuParser, DetectEscOrStartCodeAtEveryOffset) {
+  const uint8_t kuiThird[] = {0x03, 0x01};
+  uint8_t uiSrc[MAX_SCAN_LEN + TAIL_LEN] = {0};
+  for (int t = 0; t < 2; ++t) {
+    for (int32_t iLen = 3; iLen <= 80; ++iLen) {
+      for (int32_t iPos = 0; iPos + 3 <= iLen; ++iPos) {
+        memset (uiSrc, 0x55, iLen);
+        uiSrc[iPos] = 0;
+        uiSrc[iPos + 1] = 0;
+        uiSrc[iPos + 2] = kuiThird[t];
+        CheckAllScanners (uiSrc, iLen);
+      }
+    }
+  }
+}
+
+TEST (DecUT_AuParser, DetectEscOrStartCodeCutAtTail) {
+  uint8_t uiSrc[MAX_SCAN_LEN + TAIL_LEN] = {0};
+  // the sequence does not fit: the bytes behind the buffer end must not be looked at
+  for (int32_t iLen = 0; iLen <= 80; ++iLen) {
+    memset (uiSrc, 0x55, sizeof (uiSrc));
+    if (iLen >= 2) {
+      uiSrc[iLen - 2] = 0;
+      uiSrc[iLen - 1] = 0;
+    }
+    uiSrc[iLen] = 0x03;
+    CheckAllScanners (uiSrc, iLen);
+    if (iLen >= 1) {
+      memset (uiSrc, 0x55, sizeof (uiSrc));
+      uiSrc[iLen - 1] = 0;
+      uiSrc[iLen] = 0;
+      uiSrc[iLen + 1] = 0x01;
+      CheckAllScanners (uiSrc, iLen);
+    }
+  }
+}
+
+TEST (DecUT_AuParser, DetectEscOrStartCodeZeroRuns) {
+  const uint8_t kuiFollow[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0xff};
+  uint8_t uiSrc[MAX_SCAN_LEN + TAIL_LEN] = {0};
+  for (size_t f = 0; f < sizeof (kuiFollow); ++f) {
+    for (int32_t iRun = 0; iRun <= 100; ++iRun) {
+      for (int32_t iLead = 0; iLead < 3; ++iLead) {
+        const int32_t kiLen = iLead + iRun + 1;
+        memset (uiSrc, 0x80, iLead);
+        memset (uiSrc + iLead, 0, iRun);
+        uiSrc[iLead + iRun] = kuiFollow[f];
+        CheckAllScanners (uiSrc, kiLen);
+      }
+    }
+  }
+}
+
+TEST (DecUT_AuParser, DetectEscOrStartCodeRandom) {
+  // a small alphabet produces many partial and overlapping sequences
+  const uint8_t kuiAlphabet[] = {0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0xff};
+  uint8_t uiSrc[MAX_SCAN_LEN + TAIL_LEN] = {0};
+  srand (0x2641);
+  for (int n = 0; n < 2000; ++n) {
+    const int32_t kiLen = rand() % (MAX_SCAN_LEN + 1);
+    for (int32_t i = 0; i < kiLen; ++i)
+      uiSrc[i] = kuiAlphabet[rand() % sizeof (kuiAlphabet)];
+    CheckAllScanners (uiSrc, kiLen);
+  }
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.h"
+#include "cpu_core.h"
+#include "color_convert.h"
+
+using namespace WelsDec;
+
+#define MAX_ROW_WIDTH 100
+#define MAX_ROW_BYTES (MAX_ROW_WIDTH * 4)
+#define GUARD_LEN 64 // bytes behind the row, a kernel must not write them
+
+typedef struct {
+  PInterleaveUVRowFunc	pfInterleaveUVRow;
+  PYuvToPackedRowFunc		pfPackedRow[3];
+} SRowKernels;
+
+static int GetKernels (SRowKernels* pKernels) {
+  int iNum = 0;
+  SRowKernels sC = {InterleaveUVRow_c, {YuvToYuy2Row_c, YuvToRgb24Row_c, YuvToBgraRow_c}};
+  pKernels[iNum++] = sC;
+#if defined(X86_ASM)
+  const uint32_t kuiCpuFlags = WelsCPUFeatureDetect (NULL);
+  if (kuiCpuFlags & WELS_CPU_SSE2) {
+    SRowKernels sSse2 = {InterleaveUVRow_sse2, {YuvToYuy2Row_sse2, YuvToRgb24Row_sse2, YuvToBgraRow_sse2}};
+    pKernels[iNum++] = sSse2;
+  }
+  if (kuiCpuFlags & WELS_CPU_AVX2) {
+    SRowKernels sAvx2 = {InterleaveUVRow_avx2, {YuvToYuy2Row_avx2, YuvToRgb24Row_avx2, YuvToBgraRow_avx2}};
+    pKernels[iNum++] = sAvx2;
+  }
+#endif
+  return iNum;
+}
+
+static void FillRandom (uint8_t* pBuf, const int32_t kiLen) {
+  for (int32_t i = 0; i < kiLen; ++i)
+    pBuf[i] = (uint8_t)rand();
+}
+
+// every kernel writes the bytes of the C row from misaligned sources, the guard bytes behind the row stay as they are
+TEST (DecUT_ColorConvert, PackedRowsMatchC) {
+  uint8_t uiY[32 + MAX_ROW_WIDTH], uiU[32 + MAX_ROW_WIDTH], uiV[32 + MAX_ROW_WIDTH];
+  uint8_t uiRef[MAX_ROW_BYTES + GUARD_LEN], uiDst[MAX_ROW_BYTES + GUARD_LEN];
+  SRowKernels sKernels[3];
+  const int kiNum = GetKernels (sKernels);
+  srand (0x1017);
+  for (int32_t iWidth = 1; iWidth <= MAX_ROW_WIDTH; ++iWidth) {
+    const int iAlign = rand() % 32;
+    FillRandom (uiY, sizeof (uiY));
+    FillRandom (uiU, sizeof (uiU));
+    FillRandom (uiV, sizeof (uiV));
+    for (int f = 0; f < 3; ++f) {
+      memset (uiRef, 0xa5, sizeof (uiRef));
+      sKernels[0].pfPackedRow[f] (uiRef, uiY + iAlign, uiU + iAlign, uiV + iAlign, iWidth);
+      for (int k = 1; k < kiNum; ++k) {
+        memset (uiDst, 0xa5, sizeof (uiDst));
+        sKernels[k].pfPackedRow[f] (uiDst, uiY + iAlign, uiU + iAlign, uiV + iAlign, iWidth);
+        ASSERT_EQ (0, memcmp (uiRef, uiDst, sizeof (uiRef))) << "kernel " << k << " format " << f << " width "
+            << iWidth;
+      }
+    }
+  }
+}
+
+TEST (DecUT_ColorConvert, InterleaveUVRowMatchesC) {
+  uint8_t uiU[32 + MAX_ROW_WIDTH], uiV[32 + MAX_ROW_WIDTH];
+  uint8_t uiRef[MAX_ROW_WIDTH * 2 + GUARD_LEN], uiDst[MAX_ROW_WIDTH * 2 + GUARD_LEN];
+  SRowKernels sKernels[3];
+  const int kiNum = GetKernels (sKernels);
+  srand (0x2017);
+  for (int32_t iWidth = 1; iWidth <= MAX_ROW_WIDTH; ++iWidth) {
+    const int iAlign = rand() % 32;
+    FillRandom (uiU, sizeof (uiU));
+    FillRandom (uiV, sizeof (uiV));
+    memset (uiRef, 0xa5, sizeof (uiRef));
+    sKernels[0].pfInterleaveUVRow (uiRef, uiU + iAlign, uiV + iAlign, iWidth);
+    for (int k = 1; k < kiNum; ++k) {
+      memset (uiDst, 0xa5, sizeof (uiDst));
+      sKernels[k].pfInterleaveUVRow (uiDst, uiU + iAlign, uiV + iAlign, iWidth);
+      ASSERT_EQ (0, memcmp (uiRef, uiDst, sizeof (uiRef))) << "kernel " << k << " width " << iWidth;
+    }
+  }
+}
+
+// the extremes of the fixed point terms, every Y against every corner of U and V
+TEST (DecUT_ColorConvert, RgbRowsClipAsC) {
+  const uint8_t kuiChroma[] = {0, 1, 127, 128, 129, 254, 255};
+  uint8_t uiY[256], uiU[128], uiV[128];
+  uint8_t uiRef[256 * 4 + GUARD_LEN], uiDst[256 * 4 + GUARD_LEN];
+  SRowKernels sKernels[3];
+  const int kiNum = GetKernels (sKernels);
+  for (int32_t i = 0; i < 256; ++i)
+    uiY[i] = (uint8_t)i;
+  for (size_t u = 0; u < sizeof (kuiChroma); ++u) {
+    for (size_t v = 0; v < sizeof (kuiChroma); ++v) {
+      memset (uiU, kuiChroma[u], sizeof (uiU));
+      memset (uiV, kuiChroma[v], sizeof (uiV));
+      for (int f = 1; f < 3; ++f) {
+        memset (uiRef, 0xa5, sizeof (uiRef));
+        sKernels[0].pfPackedRow[f] (uiRef, uiY, uiU, uiV, 256);
+        for (int k = 1; k < kiNum; ++k) {
+          memset (uiDst, 0xa5, sizeof (uiDst));
+          sKernels[k].pfPackedRow[f] (uiDst, uiY, uiU, uiV, 256);
+          ASSERT_EQ (0, memcmp (uiRef, uiDst, sizeof (uiRef))) << "kernel " << k << " format " << f << " u "
+              << (int)kuiChroma[u] << " v " << (int)kuiChroma[v];
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,11 @@
+DECODER_UNITTEST_SRCDIR=test/decoder
+DECODER_UNITTEST_CPP_SRCS=\
+	$(DECODER_UNITTEST_SRCDIR)/DecUT_AuParser.cpp\
+	$(DECODER_UNITTEST_SRCDIR)/DecUT_ColorConvert.cpp\
+
+DECODER_UNITTEST_OBJS += $(DECODER_UNITTEST_CPP_SRCS:.cpp=.o)
+
+OBJS += $(DECODER_UNITTEST_OBJS)
+$(DECODER_UNITTEST_SRCDIR)/%.o: $(DECODER_UNITTEST_SRCDIR)/%.cpp
+	$(QUIET_CXX)$(CXX) $(CFLAGS) $(CXXFLAGS) $(INCLUDES) $(DECODER_UNITTEST_CFLAGS) $(DECODER_UNITTEST_INCLUDES) -c $(CXX_O) $<
+
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
 #include "utils/HashFunctions.h"
 #include "BaseDecoderTest.h"
 
@@ -64,8 +66,655 @@ TEST_P(DecoderOutputTest, CompareOutput) {
 static const FileParam kFileParamArray[] = {
   {"res/test_vd_1d.264", "5827d2338b79ff82cd091c707823e466197281d3"},
   {"res/test_vd_rc.264", "eea02e97bfec89d0418593a8abaaf55d02eaa1ca"},
-  {"res/Static.264", "91dd4a7a796805b2cd015cae8fd630d96c663f42"}
+  {"res/Static.264", "91dd4a7a796805b2cd015cae8fd630d96c663f42"},
+  {"res/test_4slices.264", "d11330098866f980b4a395709279cc89534a536f"},
+  {"res/test_cabac_6slices.264", "805b3e73883ae9a3c8342aa85380054534b967d1"}
 };
 
 INSTANTIATE_TEST_CASE_P(DecodeFile, DecoderOutputTest,
     ::testing::ValuesIn(kFileParamArray));
+
+class ThreadedDecoderOutputTest : public DecoderOutputTest {
+ public:
+  virtual void SetUp() {
+    BaseDecoderTest::SetUp(4);
+    if (HasFatalFailure()) {
+      return;
+    }
+    SHA1_Init(&ctx_);
+  }
+};
+
+TEST_P(ThreadedDecoderOutputTest, CompareOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, ThreadedDecoderOutputTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+class SliceThreadedDecoderOutputTest : public DecoderOutputTest {
+ public:
+  virtual void SetUp() {
+    BaseDecoderTest::SetUp(4, DECODER_THREADING_SLICE);
+    if (HasFatalFailure()) {
+      return;
+    }
+    SHA1_Init(&ctx_);
+  }
+};
+
+TEST_P(SliceThreadedDecoderOutputTest, CompareOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, SliceThreadedDecoderOutputTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+class SharedPoolDecoderOutputTest : public DecoderOutputTest {
+ public:
+  virtual void SetUp() {
+    BaseDecoderTest::SetUp(4, DECODER_THREADING_SLICE, true);
+    if (HasFatalFailure()) {
+      return;
+    }
+    SHA1_Init(&ctx_);
+  }
+};
+
+TEST_P(SharedPoolDecoderOutputTest, CompareOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, SharedPoolDecoderOutputTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+class DeblockingThreadDecoderOutputTest : public DecoderOutputTest {
+ public:
+  virtual void SetUp() {
+    BaseDecoderTest::SetUp(0, DECODER_THREADING_FRAME, false, true);
+    if (HasFatalFailure()) {
+      return;
+    }
+    SHA1_Init(&ctx_);
+  }
+};
+
+TEST_P(DeblockingThreadDecoderOutputTest, CompareOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, DeblockingThreadDecoderOutputTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+class DecodedRowsTest : public ::testing::WithParamInterface<FileParam>,
+    public DecoderInitTest, public BaseDecoderTest::Callback {
+ public:
+  virtual void SetUp() {
+    BaseDecoderTest::SetUp(0, DECODER_THREADING_FRAME, false, useDeblockingThread());
+    if (HasFatalFailure()) {
+      return;
+    }
+    SDecodedRowsCallback callback = {DecodedRowsCallback, this};
+    ASSERT_EQ(0, decoder_->SetOption(DECODER_OPTION_ROWS_CALLBACK, &callback));
+    nextLine_ = 0;
+    frameCount_ = 0;
+  }
+  virtual bool useDeblockingThread() {
+    return false;
+  }
+  static void DecodedRowsCallback(void* context, const SDecodedRows* rows) {
+    static_cast<DecodedRowsTest*>(context)->onDecodedRows(*rows);
+  }
+  // rows must arrive top down without gaps, their samples must be final
+  void onDecodedRows(const SDecodedRows& rows) {
+    EXPECT_EQ(nextLine_, rows.iLineStart);
+    EXPECT_GT(rows.iLineEnd, rows.iLineStart);
+    if (0 == rows.iLineStart) {
+      rows_.resize(rows.iWidth * rows.iHeight * 3 / 2);
+    }
+    for (int i = rows.iLineStart; i < rows.iLineEnd; i++) {
+      memcpy(&rows_[i * rows.iWidth], rows.pData[0] + i * rows.iStride[0], rows.iWidth);
+    }
+    uint8_t* chroma = &rows_[rows.iWidth * rows.iHeight];
+    for (int i = rows.iLineStart / 2; i < rows.iLineEnd / 2; i++) {
+      memcpy(chroma + i * rows.iWidth / 2, rows.pData[1] + i * rows.iStride[1], rows.iWidth / 2);
+      memcpy(chroma + (rows.iHeight / 2 + i) * rows.iWidth / 2, rows.pData[2] + i * rows.iStride[1], rows.iWidth / 2);
+    }
+    nextLine_ = rows.iLineEnd;
+  }
+  virtual void onDecodeFrame(const Frame& frame) {
+    const Plane* planes[3] = {&frame.y, &frame.u, &frame.v};
+    const uint8_t* copy = &rows_[0];
+
+    ASSERT_EQ(frame.y.height, nextLine_);
+    for (int p = 0; p < 3; p++) {
+      for (int i = 0; i < planes[p]->height; i++) {
+        ASSERT_EQ(0, memcmp(copy, planes[p]->data + i * planes[p]->stride, planes[p]->width));
+        copy += planes[p]->width;
+      }
+    }
+    nextLine_ = 0;
+    ++frameCount_;
+  }
+ protected:
+  std::vector<uint8_t> rows_;
+  int nextLine_;
+  int frameCount_;
+};
+
+TEST_P(DecodedRowsTest, RowsMatchOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+  EXPECT_GT(frameCount_, 0);
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, DecodedRowsTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+class DeblockingThreadDecodedRowsTest : public DecodedRowsTest {
+ public:
+  virtual bool useDeblockingThread() {
+    return true;
+  }
+};
+
+TEST_P(DeblockingThreadDecodedRowsTest, RowsMatchOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+  EXPECT_GT(frameCount_, 0);
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, DeblockingThreadDecodedRowsTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+// reference conversion, BT.601 limited range
+static uint8_t Clip255(int v) {
+  return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+static void YuvToRgb(int y, int u, int v, uint8_t rgb[3]) {
+  int luma = 298 * (y - 16) + 128;
+  rgb[0] = Clip255((luma + 409 * (v - 128)) >> 8);
+  rgb[1] = Clip255((luma - 100 * (u - 128) - 208 * (v - 128)) >> 8);
+  rgb[2] = Clip255((luma + 516 * (u - 128)) >> 8);
+}
+
+struct ColorFormatParam {
+  int colorFormat;
+  int strideAlign;
+};
+
+// decode with DecodeFrame2 and with DecodeFrameEx of a second decoder fed the same input, compare both outputs
+class DecodeFrameExTest : public ::testing::WithParamInterface<ColorFormatParam>,
+    public DecoderInitTest, public BaseDecoderTest::Callback {
+ public:
+  virtual void SetUp() {
+    DecoderInitTest::SetUp();
+    if (HasFatalFailure()) {
+      return;
+    }
+    ASSERT_EQ(0, CreateDecoder(&exDecoder_));
+    SDecodingParam decParam;
+    memset(&decParam, 0, sizeof(SDecodingParam));
+    decParam.iOutputColorFormat  = videoFormatI420;
+    decParam.uiTargetDqLayer = UCHAR_MAX;
+    decParam.uiEcActiveFlag  = 1;
+    decParam.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
+    ASSERT_EQ(0, exDecoder_->Initialize(&decParam));
+    frameCount_ = 0;
+  }
+  virtual void TearDown() {
+    if (exDecoder_ != NULL) {
+      exDecoder_->Uninitialize();
+      DestroyDecoder(exDecoder_);
+    }
+    DecoderInitTest::TearDown();
+  }
+  virtual void DecodeFrame(const uint8_t* src, int sliceSize, BaseDecoderTest::Callback* cbk,
+      bool* gotFrame) {
+    gotRef_ = false;
+    BaseDecoderTest::DecodeFrame(src, sliceSize, cbk, gotFrame);
+    if (HasFatalFailure()) {
+      return;
+    }
+
+    const ColorFormatParam p = GetParam();
+    int width = 0, height = 0, colorFormat = p.colorFormat;
+    int stride = 0, len = 0;
+    if (gotRef_) {
+      stride = (refWidth_ * (p.colorFormat == videoFormatBGRA ? 4 : p.colorFormat == videoFormatRGB ? 3 :
+          p.colorFormat == videoFormatYUY2 ? 2 : 1) + p.strideAlign - 1) / p.strideAlign * p.strideAlign;
+      len = stride * refHeight_ * 2;
+      out_.assign(len, 0);
+    }
+    DECODING_STATE rv = exDecoder_->DecodeFrameEx(src, sliceSize, gotRef_ ? &out_[0] : NULL,
+        p.strideAlign > 1 ? stride : 0, len, width, height, colorFormat);
+    if (!gotRef_) {
+      ASSERT_EQ(0, len);
+      return;
+    }
+    ASSERT_EQ(dsErrorFree, rv);
+    ASSERT_EQ(refWidth_, width);
+    ASSERT_EQ(refHeight_, height);
+    ASSERT_GT(len, 0);
+    CheckOutput(stride);
+    ++frameCount_;
+  }
+  virtual void onDecodeFrame(const Frame& frame) {
+    gotRef_ = true;
+    refWidth_ = frame.y.width;
+    refHeight_ = frame.y.height;
+    ref_ = frame;
+  }
+  void CheckOutput(int stride) {
+    const int format = GetParam().colorFormat;
+    const uint8_t* dst = &out_[0];
+    const uint8_t* dstU = dst + stride * refHeight_;
+    const uint8_t* dstV = dstU + stride / 2 * refHeight_ / 2;
+    for (int i = 0; i < refHeight_; i++) {
+      const uint8_t* y = ref_.y.data + i * ref_.y.stride;
+      const uint8_t* u = ref_.u.data + i / 2 * ref_.u.stride;
+      const uint8_t* v = ref_.v.data + i / 2 * ref_.v.stride;
+      const uint8_t* row = dst + i * stride;
+      for (int j = 0; j < refWidth_; j++) {
+        uint8_t rgb[3];
+        switch (format) {
+        case videoFormatI420:
+          ASSERT_EQ(y[j], row[j]);
+          if (0 == (i & 1) && 0 == (j & 1)) {
+            ASSERT_EQ(u[j / 2], dstU[i / 2 * stride / 2 + j / 2]);
+            ASSERT_EQ(v[j / 2], dstV[i / 2 * stride / 2 + j / 2]);
+          }
+          break;
+        case videoFormatNV12:
+          ASSERT_EQ(y[j], row[j]);
+          if (0 == (i & 1) && 0 == (j & 1)) {
+            ASSERT_EQ(u[j / 2], dstU[i / 2 * stride + j]);
+            ASSERT_EQ(v[j / 2], dstU[i / 2 * stride + j + 1]);
+          }
+          break;
+        case videoFormatYUY2:
+          ASSERT_EQ(y[j], row[2 * j]);
+          ASSERT_EQ((j & 1) ? v[j / 2] : u[j / 2], row[2 * j + 1]);
+          break;
+        case videoFormatRGB:
+          YuvToRgb(y[j], u[j / 2], v[j / 2], rgb);
+          ASSERT_EQ(0, memcmp(rgb, row + 3 * j, 3));
+          break;
+        case videoFormatBGRA:
+          YuvToRgb(y[j], u[j / 2], v[j / 2], rgb);
+          ASSERT_EQ(rgb[2], row[4 * j]);
+          ASSERT_EQ(rgb[1], row[4 * j + 1]);
+          ASSERT_EQ(rgb[0], row[4 * j + 2]);
+          ASSERT_EQ(255, row[4 * j + 3]);
+          break;
+        }
+      }
+    }
+  }
+ protected:
+  ISVCDecoder* exDecoder_;
+  std::vector<uint8_t> out_;
+  Frame ref_;
+  int refWidth_;
+  int refHeight_;
+  bool gotRef_;
+  int frameCount_;
+};
+
+TEST_P(DecodeFrameExTest, MatchesDecodeFrame2) {
+  DecodeFile("res/test_vd_1d.264", this);
+  DecodeFile("res/test_cabac_6slices.264", this);
+  EXPECT_GT(frameCount_, 0);
+}
+
+static const ColorFormatParam kColorFormatParamArray[] = {
+  {videoFormatI420, 1},
+  {videoFormatI420, 64},
+  {videoFormatNV12, 1},
+  {videoFormatNV12, 32},
+  {videoFormatYUY2, 1},
+  {videoFormatRGB, 1},
+  {videoFormatRGB, 16},
+  {videoFormatBGRA, 1}
+};
+
+INSTANTIATE_TEST_CASE_P(ColorFormat, DecodeFrameExTest,
+    ::testing::ValuesIn(kColorFormatParamArray));
+
+TEST_F(DecoderInitTest, DecodeFrameExBufferTooSmall) {
+  std::ifstream file("res/test_vd_1d.264", std::ios::in | std::ios::binary);
+  ASSERT_TRUE(file.is_open());
+  std::vector<char> bs((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  unsigned char dst[16];
+  int len = sizeof(dst), width = 0, height = 0, colorFormat = videoFormatBGRA;
+  DECODING_STATE rv = decoder_->DecodeFrameEx(reinterpret_cast<unsigned char*>(&bs[0]), bs.size(), dst, 0, len,
+      width, height, colorFormat);
+  ASSERT_TRUE((rv & dsDstBufNeedExpand) != 0);
+  EXPECT_EQ(width * height * 4, len);
+
+  colorFormat = videoFormatRGB565;
+  rv = decoder_->DecodeFrameEx(NULL, 0, dst, 0, len, width, height, colorFormat);
+  EXPECT_EQ(dsInvalidArgument, rv);
+}
+
+// frame allocator reusing a buffer once both the decoder and the test are done with it
+class FrameBufferPool {
+ public:
+  struct Buffer {
+    std::vector<uint8_t> storage;
+    uint8_t* data;
+    int size;
+    bool decoderHeld;
+    bool appHeld;
+  };
+  ~FrameBufferPool() {
+    for (size_t i = 0; i < buffers_.size(); i++) {
+      delete buffers_[i];
+    }
+  }
+  static int GetBuffer(void* context, SFrameBuffer* frameBuf) {
+    return static_cast<FrameBufferPool*>(context)->Get(frameBuf);
+  }
+  static void ReleaseBuffer(void* context, SFrameBuffer* frameBuf) {
+    Buffer* buf = static_cast<Buffer*>(frameBuf->pOpaque);
+    EXPECT_TRUE(buf->decoderHeld);
+    EXPECT_EQ(buf->data, frameBuf->pBuffer);
+    buf->decoderHeld = false;
+  }
+  int Get(SFrameBuffer* frameBuf) {
+    Buffer* buf = NULL;
+    EXPECT_GT(frameBuf->iSize, frameBuf->iWidth * frameBuf->iHeight * 3 / 2);
+    for (size_t i = 0; i < buffers_.size() && buf == NULL; i++) {
+      if (!buffers_[i]->decoderHeld && !buffers_[i]->appHeld && buffers_[i]->size == frameBuf->iSize) {
+        buf = buffers_[i];
+      }
+    }
+    if (buf == NULL) {
+      buf = new Buffer;
+      buf->storage.resize(frameBuf->iSize + 15);
+      buf->data = &buf->storage[0] + (-reinterpret_cast<uintptr_t>(&buf->storage[0]) & 15);
+      buf->size = frameBuf->iSize;
+      buf->appHeld = false;
+      buffers_.push_back(buf);
+    }
+    buf->decoderHeld = true;
+    frameBuf->pBuffer = buf->data;
+    frameBuf->pOpaque = buf;
+    return 0;
+  }
+  std::vector<Buffer*> buffers_;
+};
+
+static void HashFrame(SHA_CTX* ctx, void* data[3], const SBufferInfo& bufInfo) {
+  const SSysMEMBuffer& b = bufInfo.UsrData.sSystemBuffer;
+  UpdateHashFromPlane(ctx, static_cast<uint8_t*>(data[0]), b.iWidth, b.iHeight, b.iStride[0]);
+  UpdateHashFromPlane(ctx, static_cast<uint8_t*>(data[1]), b.iWidth / 2, b.iHeight / 2, b.iStride[1]);
+  UpdateHashFromPlane(ctx, static_cast<uint8_t*>(data[2]), b.iWidth / 2, b.iHeight / 2, b.iStride[1]);
+}
+
+// output frames are held for a while without copy, they must not change meanwhile
+class FrameAllocatorTest : public DecoderOutputTest {
+ public:
+  struct HeldFrame {
+    void* data[3];
+    SBufferInfo bufInfo;
+    unsigned char digest[SHA_DIGEST_LENGTH];
+  };
+  enum {
+    kHeldFrameNum = 4
+  };
+  virtual void SetUp() {
+    BaseDecoderTest::SetUp(threadCount());
+    if (HasFatalFailure()) {
+      return;
+    }
+    SFrameAllocator allocator = {FrameBufferPool::GetBuffer, FrameBufferPool::ReleaseBuffer, &pool_};
+    ASSERT_EQ(0, decoder_->SetOption(DECODER_OPTION_FRAME_ALLOCATOR, &allocator));
+    SHA1_Init(&ctx_);
+    frameCount_ = 0;
+  }
+  virtual void TearDown() {
+    DecoderOutputTest::TearDown();
+    decoder_ = NULL;
+    for (size_t i = 0; i < pool_.buffers_.size(); i++) {
+      EXPECT_FALSE(pool_.buffers_[i]->decoderHeld);
+    }
+  }
+  virtual int threadCount() {
+    return 0;
+  }
+  virtual void DecodeFrame(const uint8_t* src, int sliceSize, BaseDecoderTest::Callback* cbk,
+      bool* gotFrame) {
+    HeldFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    ASSERT_EQ(dsErrorFree, decoder_->DecodeFrame2(src, sliceSize, frame.data, &frame.bufInfo));
+    if (gotFrame != NULL) {
+      *gotFrame = frame.bufInfo.iBufferStatus == 1;
+    }
+    if (frame.bufInfo.iBufferStatus != 1) {
+      return;
+    }
+
+    FrameBufferPool::Buffer* buf = static_cast<FrameBufferPool::Buffer*>(frame.bufInfo.pFrameOpaque);
+    ASSERT_TRUE(buf != NULL);
+    ASSERT_TRUE(buf->decoderHeld);
+    ASSERT_GE(static_cast<uint8_t*>(frame.data[0]), buf->data);
+    ASSERT_LT(static_cast<uint8_t*>(frame.data[2]), buf->data + buf->size);
+    HashFrame(&ctx_, frame.data, frame.bufInfo);
+
+    SHA_CTX frameCtx;
+    SHA1_Init(&frameCtx);
+    HashFrame(&frameCtx, frame.data, frame.bufInfo);
+    SHA1_Final(frame.digest, &frameCtx);
+    buf->appHeld = true;
+    held_.push_back(frame);
+    if (held_.size() > kHeldFrameNum) {
+      ReleaseOldestFrame();
+    }
+    ++frameCount_;
+  }
+  void ReleaseOldestFrame() {
+    HeldFrame& frame = held_.front();
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA_CTX frameCtx;
+    SHA1_Init(&frameCtx);
+    HashFrame(&frameCtx, frame.data, frame.bufInfo);
+    SHA1_Final(digest, &frameCtx);
+    EXPECT_EQ(0, memcmp(digest, frame.digest, SHA_DIGEST_LENGTH));
+    static_cast<FrameBufferPool::Buffer*>(frame.bufInfo.pFrameOpaque)->appHeld = false;
+    held_.erase(held_.begin());
+  }
+ protected:
+  FrameBufferPool pool_;
+  std::vector<HeldFrame> held_;
+  int frameCount_;
+};
+
+TEST_P(FrameAllocatorTest, CompareOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+  while (!held_.empty()) {
+    ReleaseOldestFrame();
+  }
+  EXPECT_GT(frameCount_, 0);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, FrameAllocatorTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+class ThreadedFrameAllocatorTest : public FrameAllocatorTest {
+ public:
+  virtual int threadCount() {
+    return 4;
+  }
+};
+
+TEST_P(ThreadedFrameAllocatorTest, CompareOutput) {
+  FileParam p = GetParam();
+  DecodeFile(p.fileName, this);
+  while (!held_.empty()) {
+    ReleaseOldestFrame();
+  }
+  EXPECT_GT(frameCount_, 0);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(DecodeFile, ThreadedFrameAllocatorTest,
+    ::testing::ValuesIn(kFileParamArray));
+
+// several streams of various sizes decoded by batches of one access unit per stream
+class DecodeBatchTest : public ::testing::Test {
+ public:
+  struct Stream {
+    ISVCDecoder* decoder;
+    std::vector<uint8_t> data;
+    std::vector<size_t> nalStarts;
+    size_t next;
+    bool done;
+    SHA_CTX ctx;
+    const char* hashStr;
+  };
+  virtual void SetUp() {
+    for (int i = 0; i < kStreamNum; i++) {
+      const FileParam& p = kFileParamArray[i % (sizeof(kFileParamArray) / sizeof(kFileParamArray[0]))];
+      Stream s;
+      ASSERT_EQ(0, CreateDecoder(&s.decoder));
+      SDecodingParam decParam;
+      memset(&decParam, 0, sizeof(SDecodingParam));
+      decParam.iOutputColorFormat  = videoFormatI420;
+      decParam.uiTargetDqLayer = UCHAR_MAX;
+      decParam.uiEcActiveFlag  = 1;
+      decParam.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
+      decParam.bUseSharedThreadPool = true;
+      ASSERT_EQ(0, s.decoder->Initialize(&decParam));
+
+      std::ifstream file(p.fileName, std::ios::in | std::ios::binary);
+      ASSERT_TRUE(file.is_open());
+      s.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      for (size_t j = 0; j + 4 <= s.data.size(); j++) {
+        if (s.data[j] == 0 && s.data[j + 1] == 0 && s.data[j + 2] == 0 && s.data[j + 3] == 1) {
+          s.nalStarts.push_back(j);
+        }
+      }
+      s.nalStarts.push_back(s.data.size());
+      s.next = 0;
+      s.done = false;
+      SHA1_Init(&s.ctx);
+      s.hashStr = p.hashStr;
+      streams_.push_back(s);
+    }
+  }
+  virtual void TearDown() {
+    for (size_t i = 0; i < streams_.size(); i++) {
+      streams_[i].decoder->Uninitialize();
+      DestroyDecoder(streams_[i].decoder);
+    }
+  }
+  enum {
+    kStreamNum = 12
+  };
+ protected:
+  std::vector<Stream> streams_;
+};
+
+TEST_F(DecodeBatchTest, CompareOutput) {
+  std::vector<SDecodeBatchItem> items;
+  std::vector<Stream*> itemStreams;
+  for (;;) {
+    items.clear();
+    itemStreams.clear();
+    for (size_t i = 0; i < streams_.size(); i++) {
+      Stream& s = streams_[i];
+      if (s.done) {
+        continue;
+      }
+      SDecodeBatchItem item;
+      memset(&item, 0, sizeof(item));
+      item.pDecoder = s.decoder;
+      if (s.next + 1 < s.nalStarts.size()) {
+        item.pSrc = &s.data[s.nalStarts[s.next]];
+        item.iSrcLen = s.nalStarts[s.next + 1] - s.nalStarts[s.next];
+        ++s.next;
+      }
+      items.push_back(item);
+      itemStreams.push_back(&s);
+    }
+    if (items.empty()) {
+      break;
+    }
+
+    int frames = WelsDecodeBatch(&items[0], items.size());
+    int expected = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+      const SDecodeBatchItem& item = items[i];
+      const SSysMEMBuffer& b = item.sDstInfo.UsrData.sSystemBuffer;
+      ASSERT_EQ(dsErrorFree, item.eState);
+      if (item.sDstInfo.iBufferStatus == 1) {
+        UpdateHashFromPlane(&itemStreams[i]->ctx, static_cast<uint8_t*>(item.pDst[0]), b.iWidth, b.iHeight, b.iStride[0]);
+        UpdateHashFromPlane(&itemStreams[i]->ctx, static_cast<uint8_t*>(item.pDst[1]), b.iWidth / 2, b.iHeight / 2,
+            b.iStride[1]);
+        UpdateHashFromPlane(&itemStreams[i]->ctx, static_cast<uint8_t*>(item.pDst[2]), b.iWidth / 2, b.iHeight / 2,
+            b.iStride[1]);
+        ++expected;
+      } else if (item.pSrc == NULL) {
+        itemStreams[i]->done = true;
+      }
+    }
+    ASSERT_EQ(expected, frames);
+  }
+
+  for (size_t i = 0; i < streams_.size(); i++) {
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1_Final(digest, &streams_[i].ctx);
+    ASSERT_TRUE(CompareHash(digest, streams_[i].hashStr));
+  }
+}
+
+TEST_F(DecodeBatchTest, InvalidArguments) {
+  SDecodeBatchItem item;
+  memset(&item, 0, sizeof(item));
+  EXPECT_EQ(-1, WelsDecodeBatch(NULL, 1));
+  EXPECT_EQ(-1, WelsDecodeBatch(&item, 1));
+  EXPECT_EQ(0, WelsDecodeBatch(&item, 0));
+}
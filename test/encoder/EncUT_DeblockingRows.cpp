@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "codec_def.h"
+#include "codec_app_def.h"
+#include "wels_const.h"
+#include "param_svc.h"
+#include "encoder_context.h"
+#include "extern.h"
+
+using namespace WelsSVCEnc;
+
+#define PIC_WIDTH	320
+#define PIC_HEIGHT	192
+#define FRAME_SIZE	(PIC_WIDTH * PIC_HEIGHT * 3 / 2)
+#define MAX_FRAME_NUM	9
+#define MAX_BS_SIZE	(FRAME_SIZE * 2)
+
+typedef struct {
+  int32_t	iSliceMode;
+  uint32_t	uiSliceArg;	// slice number for fixed slices, size constraint for dynamic ones
+  int32_t	iLoopFilterDisableIdc;
+} SRowPipelineCase;
+
+typedef struct {
+  int32_t	iFrameNum;
+  int32_t	iBsLen[MAX_FRAME_NUM];
+  uint8_t	uiBs[MAX_FRAME_NUM][MAX_BS_SIZE];
+  // reconstruction with the expanded borders, luma then both chroma planes
+  uint8_t	uiRec[MAX_FRAME_NUM][(PIC_WIDTH + 2 * PADDING_LENGTH) * (PIC_HEIGHT + 2 * PADDING_LENGTH) * 3 / 2];
+} SEncodedFrames;
+
+static int32_t CopyReconstruction (const SPicture* kpPic, uint8_t* pDst) {
+  int32_t iLen = 0;
+  for (int32_t i = 0; i < 3; ++i) {
+    const int32_t kiPad = PADDING_LENGTH >> (i > 0);
+    const int32_t kiWidth = (kpPic->iWidthInPixel >> (i > 0)) + 2 * kiPad;
+    const int32_t kiHeight = (kpPic->iHeightInPixel >> (i > 0)) + 2 * kiPad;
+    const uint8_t* kpSrc = kpPic->pData[i] - kiPad * kpPic->iLineSize[i] - kiPad;
+    for (int32_t j = 0; j < kiHeight; ++j) {
+      memcpy (pDst + iLen, kpSrc + j * kpPic->iLineSize[i], kiWidth);
+      iLen += kiWidth;
+    }
+  }
+  return iLen;
+}
+
+static void EncodeFrames (const SRowPipelineCase& kCase, const bool kbRowPipeline, SEncodedFrames* pOut) {
+  SEncParamExt sParamExt;
+  memset (&sParamExt, 0, sizeof (sParamExt));
+  sParamExt.fMaxFrameRate = 12.0f;
+  sParamExt.iPicWidth = PIC_WIDTH;
+  sParamExt.iPicHeight = PIC_HEIGHT;
+  sParamExt.iTargetBitrate = 5000000;
+  sParamExt.iInputCsp = videoFormatI420;
+  sParamExt.iRCMode = 1;
+  sParamExt.bEnableRc = true;
+  sParamExt.iTemporalLayerNum = 1;
+  sParamExt.iSpatialLayerNum = 1;
+  sParamExt.iMultipleThreadIdc = 1;
+  sParamExt.sSpatialLayers[0].iVideoWidth = PIC_WIDTH;
+  sParamExt.sSpatialLayers[0].iVideoHeight = PIC_HEIGHT;
+  sParamExt.sSpatialLayers[0].fFrameRate = 12.0f;
+  sParamExt.sSpatialLayers[0].iSpatialBitrate = sParamExt.iTargetBitrate;
+  sParamExt.sSpatialLayers[0].sSliceCfg.uiSliceMode = (SliceMode)kCase.iSliceMode;
+  if (kCase.iSliceMode == SM_DYN_SLICE)
+    sParamExt.sSpatialLayers[0].sSliceCfg.sSliceArgument.uiSliceSizeConstraint = kCase.uiSliceArg;
+  else
+    sParamExt.sSpatialLayers[0].sSliceCfg.sSliceArgument.uiSliceNum = kCase.uiSliceArg;
+
+  SWelsSvcCodingParam sParam (true);
+  ASSERT_EQ (0, sParam.ParamTranscode (sParamExt));
+  // taken as is, the transcoding turns 0 into 2 for the slice threads
+  sParam.iLoopFilterDisableIdc = kCase.iLoopFilterDisableIdc;
+  sParam.iInterLayerLoopFilterDisableIdc = kCase.iLoopFilterDisableIdc;
+  sParam.bRowPipelineFlag = kbRowPipeline;
+
+  FILE* pFile = fopen ("res/CiscoVT2people_320x192_12fps.yuv", "rb");
+  ASSERT_TRUE (pFile != NULL);
+  sWelsEncCtx* pCtx = NULL;
+  ASSERT_EQ (0, WelsInitEncoderExt (&pCtx, &sParam));
+
+  static uint8_t uiYuv[FRAME_SIZE];
+  SSourcePicture sPic;
+  memset (&sPic, 0, sizeof (sPic));
+  sPic.iColorFormat = videoFormatI420;
+  sPic.iPicWidth = PIC_WIDTH;
+  sPic.iPicHeight = PIC_HEIGHT;
+  sPic.pData[0] = uiYuv;
+  sPic.pData[1] = uiYuv + PIC_WIDTH * PIC_HEIGHT;
+  sPic.pData[2] = sPic.pData[1] + (PIC_WIDTH * PIC_HEIGHT >> 2);
+  sPic.iStride[0] = PIC_WIDTH;
+  sPic.iStride[1] = sPic.iStride[2] = PIC_WIDTH >> 1;
+  const SSourcePicture* kpPicList[1] = {&sPic};
+
+  pOut->iFrameNum = 0;
+  while (pOut->iFrameNum < MAX_FRAME_NUM && fread (uiYuv, 1, FRAME_SIZE, pFile) == FRAME_SIZE) {
+    SFrameBSInfo sInfo;
+    memset (&sInfo, 0, sizeof (sInfo));
+    EXPECT_EQ (ENC_RETURN_SUCCESS, WelsEncoderEncodeExt (pCtx, &sInfo, kpPicList, 1));
+    int32_t iLen = 0;
+    for (int32_t i = 0; i < sInfo.iLayerNum; ++i) {
+      const SLayerBSInfo* kpLayer = &sInfo.sLayerInfo[i];
+      int32_t iLayerLen = 0;
+      for (int32_t j = 0; j < kpLayer->iNalCount; ++j)
+        iLayerLen += kpLayer->iNalLengthInByte[j];
+      ASSERT_LE (iLen + iLayerLen, MAX_BS_SIZE);
+      memcpy (pOut->uiBs[pOut->iFrameNum] + iLen, kpLayer->pBsBuf, iLayerLen);
+      iLen += iLayerLen;
+    }
+    pOut->iBsLen[pOut->iFrameNum] = iLen;
+    CopyReconstruction (pCtx->pDecPic, pOut->uiRec[pOut->iFrameNum]);
+    ++ pOut->iFrameNum;
+  }
+  WelsUninitEncoderExt (&pCtx);
+  fclose (pFile);
+}
+
+class DeblockingRowsTest : public ::testing::TestWithParam<SRowPipelineCase> {
+};
+
+TEST_P (DeblockingRowsTest, SameAsWholePicturePass) {
+  static SEncodedFrames sRows, sWhole;
+  EncodeFrames (GetParam(), true, &sRows);
+  ASSERT_FALSE (HasFatalFailure());
+  EncodeFrames (GetParam(), false, &sWhole);
+  ASSERT_FALSE (HasFatalFailure());
+  ASSERT_EQ (MAX_FRAME_NUM, sRows.iFrameNum);
+  ASSERT_EQ (sWhole.iFrameNum, sRows.iFrameNum);
+  for (int32_t i = 0; i < sRows.iFrameNum; ++i) {
+    ASSERT_EQ (sWhole.iBsLen[i], sRows.iBsLen[i]) << "frame " << i;
+    EXPECT_EQ (0, memcmp (sWhole.uiBs[i], sRows.uiBs[i], sRows.iBsLen[i])) << "frame " << i;
+    EXPECT_EQ (0, memcmp (sWhole.uiRec[i], sRows.uiRec[i], sizeof (sRows.uiRec[i]))) << "frame " << i;
+  }
+}
+
+static const SRowPipelineCase kRowPipelineCases[] = {
+  {SM_SINGLE_SLICE, 1, 0},
+  {SM_FIXEDSLCNUM_SLICE, 4, 0},
+  {SM_FIXEDSLCNUM_SLICE, 4, 2},
+  {SM_DYN_SLICE, 600, 0},
+  {SM_DYN_SLICE, 600, 2},
+};
+
+INSTANTIATE_TEST_CASE_P (RowPipeline, DeblockingRowsTest, ::testing::ValuesIn (kRowPipelineCases));
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.h"
+#include "cpu_core.h"
+#include "nal_encap.h"
+
+using namespace WelsSVCEnc;
+
+#define MAX_PAYLOAD_LEN 300
+#define MAX_NAL_LEN (NAL_HEADER_SIZE + 1 + MAX_PAYLOAD_LEN * 2)
+
+// byte by byte escaping as the syntax describes it, start code and header as WelsEncodeNal writes them
+static int32_t EncodeNalRef (const uint8_t* kpPayload, const int32_t kiLen, const uint8_t kuiHeader, uint8_t* pDst) {
+  int32_t iDstLen = 0;
+  int32_t iZeroCount = 0;
+  pDst[iDstLen++] = 0;
+  pDst[iDstLen++] = 0;
+  pDst[iDstLen++] = 0;
+  pDst[iDstLen++] = 1;
+  pDst[iDstLen++] = kuiHeader;
+  for (int32_t i = 0; i < kiLen; ++i) {
+    if (iZeroCount == 2 && kpPayload[i] <= 3) {
+      pDst[iDstLen++] = 3;
+      iZeroCount = 0;
+    }
+    iZeroCount = (kpPayload[i] == 0) ? iZeroCount + 1 : 0;
+    pDst[iDstLen++] = kpPayload[i];
+  }
+  return iDstLen;
+}
+
+static int GetCpuFlagSets (uint32_t* pFlags) {
+  int iNum = 0;
+  pFlags[iNum++] = 0;
+#if defined(X86_ASM)
+  const uint32_t kuiCpuFlags = WelsCPUFeatureDetect (NULL);
+  if (kuiCpuFlags & WELS_CPU_SSE2)
+    pFlags[iNum++] = WELS_CPU_SSE2;
+  if (kuiCpuFlags & WELS_CPU_AVX2)
+    pFlags[iNum++] = WELS_CPU_SSE2 | WELS_CPU_AVX2;
+#endif
+  return iNum;
+}
+
+// the payload is encoded from every misalignment with every zero byte scan the cpu supports
+static void CheckEncodeNal (const uint8_t* kpPayload, const int32_t kiLen) {
+  uint8_t uiSrc[32 + MAX_PAYLOAD_LEN];
+  uint8_t uiExpected[MAX_NAL_LEN];
+  uint8_t uiDst[MAX_NAL_LEN];
+  uint32_t uiFlags[3];
+  const int kiFlagNum = GetCpuFlagSets (uiFlags);
+  SWelsNalRaw sRawNal;
+  memset (&sRawNal, 0, sizeof (sRawNal));
+  sRawNal.sNalExt.sNalHeader.eNalUnitType = NAL_UNIT_CODED_SLICE;
+  sRawNal.sNalExt.sNalHeader.uiNalRefIdc = NRI_PRI_HIGHEST;
+  const int32_t kiExpectedLen = EncodeNalRef (kpPayload, kiLen, (NRI_PRI_HIGHEST << 5) | NAL_UNIT_CODED_SLICE,
+                                uiExpected);
+
+  for (int f = 0; f < kiFlagNum; ++f) {
+    WelsInitNalEncapFunc (uiFlags[f]);
+    for (int iAlign = 0; iAlign < 32; iAlign += 3) {
+      memcpy (uiSrc + iAlign, kpPayload, kiLen);
+      sRawNal.pRawData = uiSrc + iAlign;
+      sRawNal.iPayloadSize = kiLen;
+      int32_t iDstLen = 0;
+      ASSERT_EQ (ENC_RETURN_SUCCESS, WelsEncodeNal (&sRawNal, NULL, sizeof (uiDst), uiDst, &iDstLen));
+      ASSERT_EQ (kiExpectedLen, iDstLen) << "cpu flags " << uiFlags[f] << " len " << kiLen;
+      ASSERT_EQ (0, memcmp (uiExpected, uiDst, iDstLen)) << "cpu flags " << uiFlags[f] << " len " << kiLen;
+    }
+  }
+}
+
+static void FillPayload (uint8_t* pPayload, const int32_t kiLen, const int32_t kiZeroPercent) {
+  for (int32_t i = 0; i < kiLen; ++i) {
+    if (rand() % 100 < kiZeroPercent)
+      pPayload[i] = 0;
+    else if (rand() & 1)
+      pPayload[i] = 1 + rand() % 4;	// the bytes that need an escape after two zeros and 0x04
+    else
+      pPayload[i] = rand() & 0xff;
+  }
+}
+
+TEST (EncUT_NalEncap, EncodeNalRandomPayload) {
+  uint8_t uiPayload[MAX_PAYLOAD_LEN];
+  srand (0x264);
+  for (int n = 0; n < 300; ++n) {
+    const int32_t kiLen = rand() % (MAX_PAYLOAD_LEN + 1);
+    FillPayload (uiPayload, kiLen, 1);
+    CheckEncodeNal (uiPayload, kiLen);
+  }
+}
+
+TEST (EncUT_NalEncap, EncodeNalZeroHeavyPayload) {
+  const int32_t kiZeroPercent[] = {30, 60, 90};
+  uint8_t uiPayload[MAX_PAYLOAD_LEN];
+  srand (0x265);
+  for (int n = 0; n < 300; ++n) {
+    const int32_t kiLen = rand() % (MAX_PAYLOAD_LEN + 1);
+    FillPayload (uiPayload, kiLen, kiZeroPercent[n % 3]);
+    CheckEncodeNal (uiPayload, kiLen);
+  }
+}
+
+TEST (EncUT_NalEncap, EncodeNalZeroRuns) {
+  // a zero run of every length ending at every offset of the vectors, then the byte deciding about the escape
+  const uint8_t kuiFollow[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0xff};
+  uint8_t uiPayload[MAX_PAYLOAD_LEN];
+  for (size_t f = 0; f < sizeof (kuiFollow); ++f) {
+    for (int32_t iLead = 0; iLead < 40; iLead += 7) {
+      for (int32_t iRun = 0; iRun <= 70; ++iRun) {
+        const int32_t kiLen = iLead + iRun + 1 + 33;
+        memset (uiPayload, 0x80, kiLen);
+        memset (uiPayload + iLead, 0, iRun);
+        uiPayload[iLead + iRun] = kuiFollow[f];
+        CheckEncodeNal (uiPayload, kiLen);
+      }
+    }
+  }
+}
+
+TEST (EncUT_NalEncap, NonZeroRunLen) {
+  uint8_t uiPayload[MAX_PAYLOAD_LEN];
+  PNalNonZeroRunLenFunc pfRunLen[3] = {WelsNalNonZeroRunLen_c};
+  int iNum = 1;
+#if defined(X86_ASM)
+  const uint32_t kuiCpuFlags = WelsCPUFeatureDetect (NULL);
+  if (kuiCpuFlags & WELS_CPU_SSE2)
+    pfRunLen[iNum++] = WelsNalNonZeroRunLen_sse2;
+  if (kuiCpuFlags & WELS_CPU_AVX2)
+    pfRunLen[iNum++] = WelsNalNonZeroRunLen_avx2;
+#endif
+  srand (0x266);
+  for (int n = 0; n < 1000; ++n) {
+    const int32_t kiLen = rand() % (MAX_PAYLOAD_LEN + 1);
+    FillPayload (uiPayload, kiLen, rand() % 4);
+    int32_t iRun = 0;
+    while (iRun < kiLen && uiPayload[iRun] != 0)
+      ++ iRun;
+    for (int i = 0; i < iNum; ++i) {
+      const int32_t kiRunLen = pfRunLen[i] (uiPayload, uiPayload + kiLen);
+      // never beyond the first zero byte and never short by a vector and more
+      EXPECT_LE (kiRunLen, iRun) << "scan " << i;
+      EXPECT_GT (kiRunLen + 16, iRun) << "scan " << i;
+    }
+  }
+}
@@ -0,0 +1,11 @@
+ENCODER_UNITTEST_SRCDIR=test/encoder
+ENCODER_UNITTEST_CPP_SRCS=\
+	$(ENCODER_UNITTEST_SRCDIR)/EncUT_DeblockingRows.cpp\
+	$(ENCODER_UNITTEST_SRCDIR)/EncUT_NalEncap.cpp\
+
+ENCODER_UNITTEST_OBJS += $(ENCODER_UNITTEST_CPP_SRCS:.cpp=.o)
+
+OBJS += $(ENCODER_UNITTEST_OBJS)
+$(ENCODER_UNITTEST_SRCDIR)/%.o: $(ENCODER_UNITTEST_SRCDIR)/%.cpp
+	$(QUIET_CXX)$(CXX) $(CFLAGS) $(CXXFLAGS) $(INCLUDES) $(ENCODER_UNITTEST_CFLAGS) $(ENCODER_UNITTEST_INCLUDES) -c $(CXX_O) $<
+
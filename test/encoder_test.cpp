@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "utils/HashFunctions.h"
+#include "utils/BufferedData.h"
+#include "utils/FileInputStream.h"
 #include "BaseEncoderTest.h"
 
 static void UpdateHashFromFrame(const SFrameBSInfo& info, SHA_CTX* ctx) {
@@ -79,3 +81,612 @@ static const EncodeFileParam kFileParamArray[] = {
 
 INSTANTIATE_TEST_CASE_P(EncodeFile, EncoderOutputTest,
     ::testing::ValuesIn(kFileParamArray));
+
+class LookaheadEncoderTest : public EncoderInitTest, public BaseEncoderTest::Callback {
+ public:
+  LookaheadEncoderTest() : frameNum_(0) {}
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    if (frameInfo.iLayerNum > 0) {
+      ++frameNum_;
+    }
+  }
+ protected:
+  int frameNum_;
+};
+
+TEST_F(LookaheadEncoderTest, DelayedOutputIsDrained) {
+  // 9 frames input, window is longer than half of them
+  SEncParamExt param;
+  FillParamExt(&param, 320, 192, 12.0f);
+  param.iLookaheadFrames = 6;
+  EncodeFile("res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f, this, &param);
+  ASSERT_FALSE(HasFatalFailure());
+  ASSERT_EQ(3, frameNum_);
+  DrainLookahead(this);
+  ASSERT_EQ(9, frameNum_);
+}
+
+TEST(LookaheadApiTest, DelayedFramesAndPauseFrame) {
+  static const int kWidth = 160;
+  static const int kHeight = 96;
+  ISVCEncoder* encoder = NULL;
+  BufferedData buf;
+  ASSERT_EQ(0, CreateSVCEncoder(&encoder));
+  SEncParamExt param;
+  BaseEncoderTest::FillParamExt(&param, kWidth, kHeight, 6.0f);
+  param.iLookaheadFrames = 2;
+  ASSERT_EQ(cmResultSuccess, encoder->InitializeExt(&param));
+  buf.SetLength(kWidth * kHeight * 3 / 2);
+  memset(buf.data(), 0x80, kWidth * kHeight * 3 / 2);
+
+  SFrameBSInfo info;
+  memset(&info, 0, sizeof(SFrameBSInfo));
+  SSourcePicture pic;
+  memset(&pic, 0, sizeof(SSourcePicture));
+  pic.iPicWidth = kWidth;
+  pic.iPicHeight = kHeight;
+  pic.iColorFormat = videoFormatI420;
+  pic.pData[0] = buf.data();
+  pic.pData[1] = pic.pData[0] + kWidth * kHeight;
+  pic.pData[2] = pic.pData[1] + (kWidth * kHeight >> 2);
+  pic.iStride[0] = kWidth;
+  pic.iStride[1] = pic.iStride[2] = kWidth >> 1;
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(videoFrameTypeDelayed, encoder->EncodeFrame(&pic, &info));
+    EXPECT_EQ(0, info.iLayerNum);
+  }
+  // the pause frame would overtake the pictures kept
+  EXPECT_NE(0, encoder->PauseFrame(&pic, &info));
+  EXPECT_EQ(videoFrameTypeIDR, encoder->EncodeFrame(&pic, &info));
+  EXPECT_GT(info.iLayerNum, 0);
+  encoder->Uninitialize();
+  DestroySVCEncoder(encoder);
+}
+
+struct MotionSearchParam {
+  ME_SEARCH_PRESET preset;
+  const char* hashStr;
+};
+
+class MotionSearchEncoderTest : public ::testing::WithParamInterface<MotionSearchParam>,
+    public EncoderInitTest , public BaseEncoderTest::Callback {
+ public:
+  virtual void SetUp() {
+    EncoderInitTest::SetUp();
+    if (HasFatalFailure()) {
+      return;
+    }
+    SHA1_Init(&ctx_);
+  }
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    UpdateHashFromFrame(frameInfo, &ctx_);
+  }
+ protected:
+  SHA_CTX ctx_;
+};
+
+TEST_P(MotionSearchEncoderTest, CompareOutput) {
+  MotionSearchParam p = GetParam();
+  SEncParamExt param;
+  FillParamExt(&param, 320, 192, 12.0f);
+  param.eMotionSearchPreset = p.preset;
+  EncodeFile("res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f, this, &param);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+static const MotionSearchParam kMotionSearchParamArray[] = {
+  {ME_PRESET_FAST, "6915b961ba983b0aa73e86e512d97633eed87f9a"},
+  {ME_PRESET_MEDIUM, "b185aa5bb6e74fcec93791cb46950ce1fb60310e"},
+  {ME_PRESET_SLOW, "ada3a4d1c923a573caf591f03a1c6674037bf7e4"},
+};
+
+INSTANTIATE_TEST_CASE_P(MotionSearchPreset, MotionSearchEncoderTest,
+    ::testing::ValuesIn(kMotionSearchParamArray));
+
+class SharedThreadPoolEncoderTest : public EncoderInitTest, public BaseEncoderTest::Callback {
+ public:
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    UpdateHashFromFrame(frameInfo, &ctx_);
+  }
+ protected:
+  void EncodeWithPool(bool sharedThreadPool, unsigned char* digest) {
+    SEncParamExt param;
+    FillParamExt(&param, 320, 192, 12.0f);
+    param.iMultipleThreadIdc = 4;
+    param.bUseSharedThreadPool = sharedThreadPool;
+    param.sSpatialLayers[0].sSliceCfg.uiSliceMode = 4; // SM_DYN_SLICE
+    param.sSpatialLayers[0].sSliceCfg.sSliceArgument.uiSliceSizeConstraint = 600;
+    SHA1_Init(&ctx_);
+    EncodeFile("res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f, this, &param);
+    SHA1_Final(digest, &ctx_);
+  }
+  SHA_CTX ctx_;
+};
+
+TEST_F(SharedThreadPoolEncoderTest, SameOutputAsOwnThreads) {
+  // dynamic slicing partitions are fixed, so the output does not depend on the threads
+  unsigned char ownDigest[SHA_DIGEST_LENGTH];
+  unsigned char poolDigest[SHA_DIGEST_LENGTH];
+  EncodeWithPool(false, ownDigest);
+  if (HasFatalFailure()) {
+    return;
+  }
+  EncodeWithPool(true, poolDigest);
+  if (!HasFatalFailure()) {
+    ASSERT_EQ(0, memcmp(ownDigest, poolDigest, SHA_DIGEST_LENGTH));
+  }
+}
+
+class WavefrontEncoderTest : public EncoderInitTest, public BaseEncoderTest::Callback {
+ public:
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    UpdateHashFromFrame(frameInfo, &ctx_);
+  }
+ protected:
+  void EncodeWithThreads(int threadNum, bool wavefront, unsigned char* digest) {
+    SEncParamExt param;
+    FillParamExt(&param, 320, 192, 12.0f);
+    param.bEnableRc = false;
+    param.iMultipleThreadIdc = threadNum;
+    param.bEnableWavefront = wavefront;
+    SHA1_Init(&ctx_);
+    EncodeFile("res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f, this, &param);
+    SHA1_Final(digest, &ctx_);
+  }
+  SHA_CTX ctx_;
+};
+
+TEST_F(WavefrontEncoderTest, SameOutputAsSingleThread) {
+  // without rate control MB rows coded in parallel take the same decisions as in raster order
+  unsigned char singleDigest[SHA_DIGEST_LENGTH];
+  unsigned char wavefrontDigest[SHA_DIGEST_LENGTH];
+  EncodeWithThreads(1, false, singleDigest);
+  if (HasFatalFailure()) {
+    return;
+  }
+  EncodeWithThreads(4, true, wavefrontDigest);
+  if (!HasFatalFailure()) {
+    ASSERT_EQ(0, memcmp(singleDigest, wavefrontDigest, SHA_DIGEST_LENGTH));
+  }
+}
+
+class TemporalDenoiseEncoderTest : public EncoderInitTest, public BaseEncoderTest::Callback {
+ public:
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    UpdateHashFromFrame(frameInfo, &ctx_);
+  }
+ protected:
+  void EncodeWithDenoise(bool temporalDenoise, unsigned char* digest) {
+    SEncParamExt param;
+    FillParamExt(&param, 320, 192, 12.0f);
+    param.bEnableRc = false;
+    param.bEnableTemporalDenoise = temporalDenoise;
+    SHA1_Init(&ctx_);
+    EncodeFile("res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f, this, &param);
+    SHA1_Final(digest, &ctx_);
+  }
+  SHA_CTX ctx_;
+};
+
+TEST_F(TemporalDenoiseEncoderTest, CompareOutput) {
+  // the static blocks of the P pictures are blended, so the output has to change
+  unsigned char plainDigest[SHA_DIGEST_LENGTH];
+  unsigned char denoisedDigest[SHA_DIGEST_LENGTH];
+  EncodeWithDenoise(false, plainDigest);
+  if (HasFatalFailure()) {
+    return;
+  }
+  EncodeWithDenoise(true, denoisedDigest);
+  if (!HasFatalFailure()) {
+    ASSERT_NE(0, memcmp(plainDigest, denoisedDigest, SHA_DIGEST_LENGTH));
+    ASSERT_TRUE(CompareHash(denoisedDigest, "78220fa0fa3f706fb84285751eb1a1a2fdfac2e7"));
+  }
+}
+
+class AsyncEncoderTest : public EncoderInitTest, public BaseEncoderTest::Callback {
+ public:
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    UpdateHashFromFrame(frameInfo, &ctx_);
+  }
+ protected:
+  void EncodeWithAsync(bool async, int lookaheadFrames, unsigned char* digest) {
+    SEncParamExt param;
+    FillParamExt(&param, 320, 192, 12.0f);
+    param.iLookaheadFrames = lookaheadFrames;
+    SetAsync(async);
+    SHA1_Init(&ctx_);
+    EncodeFile("res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f, this, &param);
+    if (lookaheadFrames > 0 && !HasFatalFailure()) {
+      DrainLookahead(this);
+    }
+    SHA1_Final(digest, &ctx_);
+  }
+  SHA_CTX ctx_;
+};
+
+TEST_F(AsyncEncoderTest, SameOutputAsEncodeFrame) {
+  // frames are encoded in order on the encoder thread, the queue only decouples the caller
+  unsigned char syncDigest[SHA_DIGEST_LENGTH];
+  unsigned char asyncDigest[SHA_DIGEST_LENGTH];
+  EncodeWithAsync(false, 0, syncDigest);
+  if (HasFatalFailure()) {
+    return;
+  }
+  EncodeWithAsync(true, 0, asyncDigest);
+  if (!HasFatalFailure()) {
+    ASSERT_EQ(0, memcmp(syncDigest, asyncDigest, SHA_DIGEST_LENGTH));
+  }
+}
+
+TEST_F(AsyncEncoderTest, LookaheadIsDrained) {
+  unsigned char syncDigest[SHA_DIGEST_LENGTH];
+  unsigned char asyncDigest[SHA_DIGEST_LENGTH];
+  EncodeWithAsync(false, 6, syncDigest);
+  if (HasFatalFailure()) {
+    return;
+  }
+  EncodeWithAsync(true, 6, asyncDigest);
+  if (!HasFatalFailure()) {
+    ASSERT_EQ(0, memcmp(syncDigest, asyncDigest, SHA_DIGEST_LENGTH));
+  }
+}
+
+class InPlaceInputEncoderTest : public EncoderInitTest, public BaseEncoderTest::Callback {
+ public:
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    UpdateHashFromFrame(frameInfo, &ctx_);
+  }
+ protected:
+  void EncodeInPlace(bool inPlace, int width, int height, unsigned char* digest) {
+    SEncParamExt param;
+    FillParamExt(&param, width, height, 6.0f);
+    SetInPlaceInput(inPlace);
+    SHA1_Init(&ctx_);
+    EncodeFile(fileName_, width, height, 6.0f, this, &param);
+    SHA1_Final(digest, &ctx_);
+  }
+  void CompareInPlace(const char* fileName, int width, int height) {
+    unsigned char copiedDigest[SHA_DIGEST_LENGTH];
+    unsigned char inPlaceDigest[SHA_DIGEST_LENGTH];
+    fileName_ = fileName;
+    EncodeInPlace(false, width, height, copiedDigest);
+    if (HasFatalFailure()) {
+      return;
+    }
+    EncodeInPlace(true, width, height, inPlaceDigest);
+    if (!HasFatalFailure()) {
+      ASSERT_EQ(0, memcmp(copiedDigest, inPlaceDigest, SHA_DIGEST_LENGTH));
+    }
+  }
+  const char* fileName_;
+  SHA_CTX ctx_;
+};
+
+TEST_F(InPlaceInputEncoderTest, SameOutputAsCopiedInput) {
+  CompareInPlace("res/CiscoVT2people_160x96_6fps.yuv", 160, 96);
+}
+
+TEST_F(InPlaceInputEncoderTest, SameOutputAsCopiedInputNotMbAligned) {
+  CompareInPlace("res/Static_152_100.yuv", 152, 100);
+}
+
+static void* CountingMalloc(void* userData, unsigned int size) {
+  ++*static_cast<int*>(userData);
+  return malloc(size);
+}
+
+static void CountingFree(void* userData, void* ptr, unsigned int size) {
+  --*static_cast<int*>(userData);
+  free(ptr);
+}
+
+class MemoryPoolEncoderTest : public EncoderInitTest, public BaseEncoderTest::Callback {
+ public:
+  MemoryPoolEncoderTest() : blockNum_(0) {}
+  virtual void TearDown() {
+    EncoderInitTest::TearDown();
+    // all buffers are back, so the default pool can be restored
+    EXPECT_EQ(0, blockNum_);
+    EXPECT_EQ(0, WelsSetMemoryAllocator(NULL));
+  }
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {}
+ protected:
+  int blockNum_;
+};
+
+TEST_F(MemoryPoolEncoderTest, ReportsTagPeaks) {
+  SWelsMemoryTagUsage usage[512];
+  EncodeFile("res/CiscoVT2people_160x96_6fps.yuv", 160, 96, 6.0f, this);
+  int num = WelsGetMemoryTagUsage(usage, 512);
+  ASSERT_GT(num, 0);
+  unsigned int currentBytes = 0;
+  for (int i = 0; i < num; ++i) {
+    ASSERT_TRUE(usage[i].pTag != NULL);
+    ASSERT_GE(usage[i].uiPeakBytes, usage[i].uiCurrentBytes);
+    currentBytes += usage[i].uiCurrentBytes;
+  }
+  ASSERT_GT(currentBytes, 0u);
+  // the encoder still holds its buffers
+  ASSERT_NE(0, WelsSetMemoryAllocator(NULL));
+}
+
+TEST_F(MemoryPoolEncoderTest, CustomAllocator) {
+  SWelsMemoryAllocator allocator = {CountingMalloc, CountingFree, &blockNum_};
+  ASSERT_EQ(0, WelsSetMemoryAllocator(&allocator));
+  EncodeFile("res/CiscoVT2people_160x96_6fps.yuv", 160, 96, 6.0f, this);
+  ASSERT_GT(blockNum_, 0);
+}
+
+struct CabacEncodeParam {
+  int sliceMode;
+  const char* hashStr;
+};
+
+class CabacEncoderTest : public ::testing::WithParamInterface<CabacEncodeParam>,
+    public EncoderInitTest , public BaseEncoderTest::Callback {
+ public:
+  virtual void SetUp() {
+    EncoderInitTest::SetUp();
+    if (HasFatalFailure()) {
+      return;
+    }
+    SHA1_Init(&ctx_);
+  }
+  virtual void onEncodeFrame(const SFrameBSInfo& frameInfo) {
+    UpdateHashFromFrame(frameInfo, &ctx_);
+  }
+ protected:
+  SHA_CTX ctx_;
+};
+
+TEST_P(CabacEncoderTest, CompareOutput) {
+  CabacEncodeParam p = GetParam();
+  SEncParamExt param;
+  FillParamExt(&param, 320, 192, 12.0f);
+  param.sSpatialLayers[0].iEntropyCodingModeFlag = 1;
+  param.sSpatialLayers[0].sSliceCfg.uiSliceMode = p.sliceMode;
+  param.sSpatialLayers[0].sSliceCfg.sSliceArgument.uiSliceSizeConstraint = 600;
+  EncodeFile("res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f, this, &param);
+
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1_Final(digest, &ctx_);
+  if (!HasFatalFailure()) {
+    ASSERT_TRUE(CompareHash(digest, p.hashStr));
+  }
+}
+
+static const CabacEncodeParam kCabacEncodeParamArray[] = {
+  {0, "a08caf1a917413a944c739c17dd3cd1715f90dff"}, // SM_SINGLE_SLICE
+  {4, "7a8efbc6cf89b2ac5d33671180589244804fb536"}, // SM_DYN_SLICE
+};
+
+INSTANTIATE_TEST_CASE_P(CabacSliceMode, CabacEncoderTest,
+    ::testing::ValuesIn(kCabacEncodeParamArray));
+
+struct SwitchSource {
+  const char* fileName;
+  int width;
+  int height;
+  float frameRate;
+};
+
+class ParamSwitchEncoderTest : public ::testing::Test {
+ protected:
+  // resolutions are switched back and forth every few frames
+  void EncodeWithSwitches(int ctxPoolSize, unsigned char* digest) {
+    static const SwitchSource kSources[2] = {
+      {"res/CiscoVT2people_320x192_12fps.yuv", 320, 192, 12.0f},
+      {"res/CiscoVT2people_160x96_6fps.yuv", 160, 96, 6.0f},
+    };
+    static const int kFramesPerSwitch = 2;
+    static const int kSwitchNum = 5;
+    FileInputStream in[2];
+    ISVCEncoder* encoder = NULL;
+    SHA_CTX ctx;
+
+    SHA1_Init(&ctx);
+    ASSERT_TRUE(in[0].Open(kSources[0].fileName));
+    ASSERT_TRUE(in[1].Open(kSources[1].fileName));
+    ASSERT_EQ(0, CreateSVCEncoder(&encoder));
+    for (int i = 0; i < kSwitchNum && !HasFatalFailure(); ++i) {
+      const SwitchSource& src = kSources[i & 1];
+      SEncParamExt param;
+      BaseEncoderTest::FillParamExt(&param, src.width, src.height, src.frameRate);
+      param.iCtxPoolSize = ctxPoolSize;
+      if (i == 0) {
+        ASSERT_EQ(cmResultSuccess, encoder->InitializeExt(&param));
+      } else {
+        ASSERT_EQ(cmResultSuccess, encoder->SetOption(ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, &param));
+      }
+      EncodeFrames(encoder, &in[i & 1], src.width, src.height, kFramesPerSwitch, &ctx);
+    }
+    encoder->Uninitialize();
+    DestroySVCEncoder(encoder);
+    SHA1_Final(digest, &ctx);
+  }
+
+  void EncodeFrames(ISVCEncoder* encoder, InputStream* in, int width, int height, int frameNum, SHA_CTX* ctx) {
+    const int frameSize = width * height * 3 / 2;
+    BufferedData buf;
+    buf.SetLength(frameSize);
+    ASSERT_TRUE(buf.Length() == frameSize);
+
+    SFrameBSInfo info;
+    memset(&info, 0, sizeof(SFrameBSInfo));
+    SSourcePicture pic;
+    memset(&pic, 0, sizeof(SSourcePicture));
+    pic.iPicWidth = width;
+    pic.iPicHeight = height;
+    pic.iColorFormat = videoFormatI420;
+    pic.iStride[0] = width;
+    pic.iStride[1] = pic.iStride[2] = width >> 1;
+    pic.pData[0] = buf.data();
+    pic.pData[1] = pic.pData[0] + width * height;
+    pic.pData[2] = pic.pData[1] + (width * height >> 2);
+    for (int i = 0; i < frameNum; ++i) {
+      ASSERT_EQ(frameSize, in->read(buf.data(), frameSize));
+      int rv = encoder->EncodeFrame(&pic, &info);
+      ASSERT_TRUE(rv != videoFrameTypeInvalid);
+      if (rv != videoFrameTypeSkip) {
+        UpdateHashFromFrame(info, ctx);
+      }
+    }
+  }
+};
+
+TEST_F(ParamSwitchEncoderTest, PooledContextsSameOutputAsRebuilt) {
+  // contexts taken back from the pool are reset to the state of a newly initialized one
+  unsigned char rebuiltDigest[SHA_DIGEST_LENGTH];
+  unsigned char pooledDigest[SHA_DIGEST_LENGTH];
+  EncodeWithSwitches(0, rebuiltDigest);
+  if (HasFatalFailure()) {
+    return;
+  }
+  EncodeWithSwitches(2, pooledDigest);
+  if (!HasFatalFailure()) {
+    ASSERT_EQ(0, memcmp(rebuiltDigest, pooledDigest, SHA_DIGEST_LENGTH));
+  }
+}
+
+class InputFormatEncoderTest : public ::testing::TestWithParam<EVideoFormatType> {
+ protected:
+  // the I420 frames of the file repacked into format, I420 itself taken as is
+  void EncodeFile(EVideoFormatType format, unsigned char* digest) {
+    static const int kWidth = 160;
+    static const int kHeight = 96;
+    const int frameSize = kWidth * kHeight * 3 / 2;
+    FileInputStream in;
+    ISVCEncoder* encoder = NULL;
+    BufferedData buf;
+    BufferedData packed;
+    SHA_CTX ctx;
+
+    SHA1_Init(&ctx);
+    ASSERT_TRUE(in.Open("res/CiscoVT2people_160x96_6fps.yuv"));
+    ASSERT_EQ(0, CreateSVCEncoder(&encoder));
+    SEncParamExt param;
+    BaseEncoderTest::FillParamExt(&param, kWidth, kHeight, 6.0f);
+    param.iInputCsp = format;
+    ASSERT_EQ(cmResultSuccess, encoder->InitializeExt(&param));
+    buf.SetLength(frameSize);
+    packed.SetLength(kWidth * kHeight * 2);
+
+    SFrameBSInfo info;
+    memset(&info, 0, sizeof(SFrameBSInfo));
+    SSourcePicture pic;
+    memset(&pic, 0, sizeof(SSourcePicture));
+    pic.iPicWidth = kWidth;
+    pic.iPicHeight = kHeight;
+    pic.iColorFormat = format;
+    while (in.read(buf.data(), frameSize) == frameSize) {
+      const unsigned char* y = buf.data();
+      const unsigned char* u = y + kWidth * kHeight;
+      const unsigned char* v = u + (kWidth * kHeight >> 2);
+      unsigned char* dst = packed.data();
+      switch (format) {
+      case videoFormatNV12:
+      case videoFormatNV21:
+        memcpy(dst, y, kWidth * kHeight);
+        for (int i = 0; i < (kWidth * kHeight >> 2); ++i) {
+          dst[kWidth * kHeight + 2 * i] = format == videoFormatNV12 ? u[i] : v[i];
+          dst[kWidth * kHeight + 2 * i + 1] = format == videoFormatNV12 ? v[i] : u[i];
+        }
+        pic.pData[0] = dst;
+        pic.pData[1] = dst + kWidth * kHeight;
+        pic.iStride[0] = pic.iStride[1] = kWidth;
+        break;
+      case videoFormatYUY2:
+      case videoFormatUYVY:
+        // both rows of a pair take the same chroma, which is what they are averaged back to
+        for (int j = 0; j < kHeight; ++j) {
+          for (int i = 0; i < kWidth; ++i) {
+            const int c = (j >> 1) * (kWidth >> 1) + (i >> 1);
+            const int luma = format == videoFormatYUY2 ? 0 : 1;
+            dst[j * kWidth * 2 + 2 * i + luma] = y[j * kWidth + i];
+            dst[j * kWidth * 2 + 2 * i + 1 - luma] = (i & 1) ? v[c] : u[c];
+          }
+        }
+        pic.pData[0] = dst;
+        pic.iStride[0] = kWidth * 2;
+        break;
+      default:
+        pic.pData[0] = buf.data();
+        pic.pData[1] = pic.pData[0] + kWidth * kHeight;
+        pic.pData[2] = pic.pData[1] + (kWidth * kHeight >> 2);
+        pic.iStride[0] = kWidth;
+        pic.iStride[1] = pic.iStride[2] = kWidth >> 1;
+        break;
+      }
+      int rv = encoder->EncodeFrame(&pic, &info);
+      ASSERT_TRUE(rv != videoFrameTypeInvalid);
+      if (rv != videoFrameTypeSkip) {
+        UpdateHashFromFrame(info, &ctx);
+      }
+    }
+    encoder->Uninitialize();
+    DestroySVCEncoder(encoder);
+    SHA1_Final(digest, &ctx);
+  }
+};
+
+TEST_P(InputFormatEncoderTest, SameOutputAsI420) {
+  // the repacking is lossless, so the converted input is the I420 one
+  unsigned char i420Digest[SHA_DIGEST_LENGTH];
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  EncodeFile(videoFormatI420, i420Digest);
+  if (HasFatalFailure()) {
+    return;
+  }
+  EncodeFile(GetParam(), digest);
+  if (!HasFatalFailure()) {
+    ASSERT_EQ(0, memcmp(i420Digest, digest, SHA_DIGEST_LENGTH));
+  }
+}
+
+static const EVideoFormatType kInputFormatArray[] = {
+  videoFormatNV12, videoFormatNV21, videoFormatYUY2, videoFormatUYVY,
+};
+
+INSTANTIATE_TEST_CASE_P(InputFormat, InputFormatEncoderTest,
+    ::testing::ValuesIn(kInputFormatArray));
+
+TEST(InputFormatErrorTest, FailedConversionFailsTheFrame) {
+  static const int kWidth = 160;
+  static const int kHeight = 96;
+  ISVCEncoder* encoder = NULL;
+  BufferedData buf;
+  ASSERT_EQ(0, CreateSVCEncoder(&encoder));
+  SEncParamExt param;
+  BaseEncoderTest::FillParamExt(&param, kWidth, kHeight, 6.0f);
+  param.iInputCsp = videoFormatNV12;
+  ASSERT_EQ(cmResultSuccess, encoder->InitializeExt(&param));
+  buf.SetLength(kWidth * kHeight * 3 / 2);
+  memset(buf.data(), 0x80, kWidth * kHeight * 3 / 2);
+
+  SFrameBSInfo info;
+  memset(&info, 0, sizeof(SFrameBSInfo));
+  SSourcePicture pic;
+  memset(&pic, 0, sizeof(SSourcePicture));
+  pic.iPicWidth = kWidth;
+  pic.iPicHeight = kHeight;
+  pic.iColorFormat = videoFormatNV12;
+  pic.pData[0] = buf.data();
+  pic.iStride[0] = pic.iStride[1] = kWidth;
+  // the interleaved chroma plane is missing
+  EXPECT_EQ(videoFrameTypeInvalid, encoder->EncodeFrame(&pic, &info));
+  pic.pData[1] = buf.data() + kWidth * kHeight;
+  EXPECT_NE(videoFrameTypeInvalid, encoder->EncodeFrame(&pic, &info));
+  encoder->Uninitialize();
+
+  // lookahead takes I420 only
+  param.iLookaheadFrames = 2;
+  ASSERT_EQ(cmResultSuccess, encoder->InitializeExt(&param));
+  EXPECT_EQ(videoFrameTypeInvalid, encoder->EncodeFrame(&pic, &info));
+  encoder->Uninitialize();
+  DestroySVCEncoder(encoder);
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.h"
+#include "cpu_core.h"
+#include "denoise/denoise.h"
+
+using namespace nsWelsVP;
+
+#define GUARD_BYTES 64
+
+static uint32_t GetCpuFlags() {
+#if defined(X86_ASM)
+  return WelsCPUFeatureDetect (NULL);
+#else
+  return 0;
+#endif
+}
+
+// pCur[x] is kept or averaged with pRef[x] depending on their difference alone
+static uint8_t TemporalBlendRef (const uint8_t kuiCur, const uint8_t kuiRef) {
+  const int32_t kiDiff = kuiCur - kuiRef;
+  if (kiDiff > DENOISE_TEMPORAL_DIFF_THD || kiDiff < -DENOISE_TEMPORAL_DIFF_THD)
+    return kuiCur;
+  return (uint8_t) ((kuiCur + kuiRef + 1) >> 1);
+}
+
+typedef struct {
+  TemporalBlendFuncPtr	pfBlend;
+  TemporalBlendFuncPtr	pfBlendRef;
+  uint32_t				uiCpuFlag;
+  int32_t				iSize;
+  const char*			pName;
+} SBlendKernel;
+
+#if defined(X86_ASM)
+static const SBlendKernel kBlendKernels[] = {
+  {TemporalBlend8x8_sse2,	TemporalBlend8x8_c,	WELS_CPU_SSE2,	8,	"8x8_sse2"},
+  {TemporalBlend4x4_sse2,	TemporalBlend4x4_c,	WELS_CPU_SSE2,	4,	"4x4_sse2"},
+};
+#else
+static const SBlendKernel kBlendKernels[] = {
+  {TemporalBlend8x8_c,	TemporalBlend8x8_c,	0,	8,	"8x8_c"},
+  {TemporalBlend4x4_c,	TemporalBlend4x4_c,	0,	4,	"4x4_c"},
+};
+#endif
+
+// differences around the threshold on both sides and samples at both ends of the range
+static void MakeBlendBlock (uint8_t* pCur, uint8_t* pRef, const int32_t kiSize) {
+  for (int32_t i = 0; i < kiSize; ++i) {
+    const int32_t kiDiff = rand() % (4 * DENOISE_TEMPORAL_DIFF_THD + 1) - 2 * DENOISE_TEMPORAL_DIFF_THD;
+    int32_t iCur = rand() & 0xff;
+    if ((rand() & 7) == 0)
+      iCur = (rand() & 1) ? 0xff : 0;
+    pCur[i] = (uint8_t)iCur;
+    pRef[i] = (uint8_t)WELS_CLAMP (iCur + kiDiff, 0, 255);
+  }
+}
+
+// the whole buffer is compared, nothing may be written beside the block
+TEST (ProcessUT_Denoise, TemporalBlendKernelsMatchC) {
+  const uint32_t kuiCpuFlags = GetCpuFlags();
+  srand (0x2424);
+  for (size_t k = 0; k < sizeof (kBlendKernels) / sizeof (kBlendKernels[0]); ++k) {
+    const SBlendKernel& kKernel = kBlendKernels[k];
+    if ((kKernel.uiCpuFlag & kuiCpuFlags) != kKernel.uiCpuFlag)
+      continue;
+    for (int32_t n = 0; n < 500; ++n) {
+      const int32_t kiCurStride = kKernel.iSize + rand() % 40;
+      const int32_t kiRefStride = kKernel.iSize + rand() % 40;
+      const int32_t kiOffset = rand() % 16;
+      const int32_t kiCurSize = kiOffset + kiCurStride * kKernel.iSize + GUARD_BYTES;
+      const int32_t kiRefSize = kiOffset + kiRefStride * kKernel.iSize + GUARD_BYTES;
+      uint8_t* pCur = new uint8_t[kiCurSize];
+      uint8_t* pCurRef = new uint8_t[kiCurSize];
+      uint8_t* pRef = new uint8_t[kiRefSize];
+      uint8_t* pRefCopy = new uint8_t[kiRefSize];
+      for (int32_t i = 0; i < kiCurSize; ++i)
+        pCur[i] = rand() & 0xff;
+      for (int32_t i = 0; i < kiRefSize; ++i)
+        pRef[i] = rand() & 0xff;
+      for (int32_t y = 0; y < kKernel.iSize; ++y) {
+        uint8_t uiCur[8], uiRef[8];
+        MakeBlendBlock (uiCur, uiRef, kKernel.iSize);
+        memcpy (pCur + kiOffset + y * kiCurStride, uiCur, kKernel.iSize);
+        memcpy (pRef + kiOffset + y * kiRefStride, uiRef, kKernel.iSize);
+      }
+      memcpy (pCurRef, pCur, kiCurSize);
+      memcpy (pRefCopy, pRef, kiRefSize);
+
+      kKernel.pfBlendRef (pCurRef + kiOffset, kiCurStride, pRef + kiOffset, kiRefStride);
+      kKernel.pfBlend (pCur + kiOffset, kiCurStride, pRef + kiOffset, kiRefStride);
+      EXPECT_EQ (0, memcmp (pCurRef, pCur, kiCurSize)) << kKernel.pName << " strides " << kiCurStride << ", "
+          << kiRefStride << " offset " << kiOffset;
+      EXPECT_EQ (0, memcmp (pRefCopy, pRef, kiRefSize)) << kKernel.pName << " wrote to the reference";
+
+      delete[] pCur;
+      delete[] pCurRef;
+      delete[] pRef;
+      delete[] pRefCopy;
+    }
+  }
+}
+
+// the c kernels against the definition, to pin what the simd versions are compared with
+TEST (ProcessUT_Denoise, TemporalBlendCMatchesDefinition) {
+  uint8_t uiCur[8 * 8], uiRef[8 * 8], uiExpected[8 * 8];
+  srand (0x2425);
+  for (int32_t n = 0; n < 200; ++n) {
+    MakeBlendBlock (uiCur, uiRef, 8 * 8);
+    for (int32_t i = 0; i < 8 * 8; ++i)
+      uiExpected[i] = TemporalBlendRef (uiCur[i], uiRef[i]);
+    TemporalBlend8x8_c (uiCur, 8, uiRef, 8);
+    ASSERT_EQ (0, memcmp (uiExpected, uiCur, sizeof (uiCur)));
+  }
+}
+
+class TemporalDenoiseTest : public ::testing::Test {
+ public:
+  enum {
+    kiWidth = 96,
+    kiHeight = 64,
+    kiStride = kiWidth + 32,
+    kiMbNum = (kiWidth >> 4) * (kiHeight >> 4)
+  };
+
+  virtual void SetUp() {
+    memset (&m_sResult, 0, sizeof (m_sResult));
+    m_sResult.pSad8x8 = m_iSad8x8;
+    srand (0x2426);
+    MakePictures();
+    for (int32_t c = 0; c < 3; ++c) {
+      InitPlane (&m_sCurMap, c, m_uiCur[c]);
+      InitPlane (&m_sRefMap, c, m_uiRef[c]);
+    }
+    // the statistics are of the pictures as they are handed in
+    m_sResult.pCurY = m_uiCur[0];
+    m_sResult.pRefY = m_uiRef[0];
+    for (int32_t iMb = 0; iMb < kiMbNum; ++iMb) {
+      for (int32_t k = 0; k < 4; ++k) {
+        const int32_t kiX = ((iMb % (kiWidth >> 4)) << 4) + ((k & 1) << 3);
+        const int32_t kiY = ((iMb / (kiWidth >> 4)) << 4) + ((k >> 1) << 3);
+        m_iSad8x8[iMb][k] = 0;
+        for (int32_t y = kiY; y < kiY + 8; ++y) {
+          for (int32_t x = kiX; x < kiX + 8; ++x)
+            m_iSad8x8[iMb][k] += WELS_ABS (m_uiCur[0][y * kiStride + x] - m_uiRef[0][y * kiStride + x]);
+        }
+      }
+    }
+  }
+
+  void InitPlane (SPixMap* pMap, const int32_t kiPlane, uint8_t* pData) {
+    if (kiPlane == 0)
+      memset (pMap, 0, sizeof (*pMap));
+    pMap->pPixel[kiPlane] = pData;
+    pMap->iStride[kiPlane] = kiStride >> (kiPlane > 0);
+    pMap->iSizeInBits = 8;
+    pMap->sRect.iRectWidth = kiWidth;
+    pMap->sRect.iRectHeight = kiHeight;
+    pMap->eFormat = VIDEO_FORMAT_I420;
+  }
+
+  // 8x8 blocks of the reference in order: the same up to a little noise, up to larger noise, or new
+  void MakePictures() {
+    for (int32_t c = 0; c < 3; ++c) {
+      const int32_t kiShift = (c > 0);
+      for (int32_t y = 0; y < (kiHeight >> kiShift); ++y) {
+        for (int32_t x = 0; x < (kiStride >> kiShift); ++x) {
+          const int32_t kiIdx = y * (kiStride >> kiShift) + x;
+          const int32_t kiBlock = ((y << kiShift) >> 3) * (kiWidth >> 3) + ((x << kiShift) >> 3);
+          const int32_t kiCur = 40 + ((x + y) & 0x7f) + rand() % 5;
+          int32_t iRef = kiCur;
+          if (kiBlock % 3 == 0)
+            iRef += rand() % 5 - 2;
+          else if (kiBlock % 3 == 1)
+            iRef += rand() % 15 - 7;
+          else
+            iRef = rand() & 0xff;
+          m_uiCur[c][kiIdx] = (uint8_t)kiCur;
+          m_uiRef[c][kiIdx] = (uint8_t)iRef;
+        }
+      }
+    }
+    memcpy (m_uiCurIn, m_uiCur, sizeof (m_uiCur));
+  }
+
+  uint8_t m_uiCur[3][kiStride * kiHeight];
+  uint8_t m_uiCurIn[3][kiStride * kiHeight];
+  uint8_t m_uiRef[3][kiStride * kiHeight];
+  int32_t m_iSad8x8[kiMbNum][4];
+  SVAACalcResult m_sResult;
+  SPixMap m_sCurMap;
+  SPixMap m_sRefMap;
+};
+
+// static 8x8 blocks and their chroma are blended sample by sample, the others are left as they are
+TEST_F (TemporalDenoiseTest, BlendsStaticBlocksOnly) {
+  CDenoiser cDenoiser (GetCpuFlags());
+  SDenoiseParam sParam;
+  int32_t iBlockCount[2] = {0, 0};
+  sParam.pCalcResult = &m_sResult;
+  ASSERT_EQ (RET_SUCCESS, cDenoiser.Set (0, &sParam));
+  ASSERT_EQ (RET_SUCCESS, cDenoiser.Process (0, &m_sCurMap, &m_sRefMap));
+
+  for (int32_t iMb = 0; iMb < kiMbNum; ++iMb) {
+    for (int32_t k = 0; k < 4; ++k) {
+      const bool kbStatic = m_iSad8x8[iMb][k] <= DENOISE_TEMPORAL_SAD_THD;
+      const int32_t kiX = ((iMb % (kiWidth >> 4)) << 4) + ((k & 1) << 3);
+      const int32_t kiY = ((iMb / (kiWidth >> 4)) << 4) + ((k >> 1) << 3);
+      ++ iBlockCount[kbStatic];
+      for (int32_t c = 0; c < 3; ++c) {
+        const int32_t kiShift = (c > 0);
+        const int32_t kiPlaneStride = kiStride >> kiShift;
+        for (int32_t y = kiY >> kiShift; y < (kiY + 8) >> kiShift; ++y) {
+          for (int32_t x = kiX >> kiShift; x < (kiX + 8) >> kiShift; ++x) {
+            const int32_t kiIdx = y * kiPlaneStride + x;
+            const uint8_t kuiExpected = kbStatic ? TemporalBlendRef (m_uiCurIn[c][kiIdx], m_uiRef[c][kiIdx]) :
+                                        m_uiCurIn[c][kiIdx];
+            ASSERT_EQ (kuiExpected, m_uiCur[c][kiIdx]) << "plane " << c << " at " << x << "," << y << " sad "
+                << m_iSad8x8[iMb][k];
+          }
+        }
+      }
+    }
+  }
+  // both kinds of blocks have been checked
+  EXPECT_GT (iBlockCount[0], 0);
+  EXPECT_GT (iBlockCount[1], 0);
+}
+
+// statistics of other pictures cannot pick the blocks, nothing is touched then
+TEST_F (TemporalDenoiseTest, RejectsStatisticsOfOtherPictures) {
+  CDenoiser cDenoiser (GetCpuFlags());
+  SDenoiseParam sParam;
+
+  sParam.pCalcResult = NULL;
+  ASSERT_EQ (RET_SUCCESS, cDenoiser.Set (0, &sParam));
+  EXPECT_EQ (RET_INVALIDPARAM, cDenoiser.Process (0, &m_sCurMap, &m_sRefMap));
+
+  sParam.pCalcResult = &m_sResult;
+  ASSERT_EQ (RET_SUCCESS, cDenoiser.Set (0, &sParam));
+  m_sResult.pRefY = m_uiCur[0];
+  EXPECT_EQ (RET_INVALIDPARAM, cDenoiser.Process (0, &m_sCurMap, &m_sRefMap));
+  m_sResult.pRefY = m_uiRef[0];
+  m_sRefMap.sRect.iRectHeight -= 16;
+  EXPECT_EQ (RET_INVALIDPARAM, cDenoiser.Process (0, &m_sCurMap, &m_sRefMap));
+
+  EXPECT_EQ (0, memcmp (m_uiCurIn, m_uiCur, sizeof (m_uiCur)));
+}
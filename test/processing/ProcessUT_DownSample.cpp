@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.h"
+#include "cpu_core.h"
+#include "downsample/downsample.h"
+
+using namespace nsWelsVP;
+
+#define GUARD_BYTES 64
+
+static uint32_t GetCpuFlags() {
+#if defined(X86_ASM)
+  return WelsCPUFeatureDetect (NULL);
+#else
+  return 0;
+#endif
+}
+
+static void FillRandom (uint8_t* pBuf, const int32_t kiSize) {
+  for (int32_t i = 0; i < kiSize; ++i)
+    pBuf[i] = rand() & 0xff;
+}
+
+typedef struct {
+  PHalveDownsampleFunc	pfHalve;
+  uint32_t				uiCpuFlag;
+  int32_t				iWidthAlign;
+  const char*			pName;
+} SHalveKernel;
+
+typedef struct {
+  PGeneralDownsampleFunc	pfGeneral;
+  PGeneralDownsampleFunc	pfGeneralRef;
+  uint32_t				uiCpuFlag;
+  const char*			pName;
+} SGeneralKernel;
+
+#if defined(X86_ASM)
+static const SHalveKernel kHalveKernels[] = {
+  {DyadicBilinearDownsamplerWidthx8_sse2,	WELS_CPU_SSE2,	8,	"x8_sse2"},
+  {DyadicBilinearDownsamplerWidthx16_sse2,	WELS_CPU_SSE2,	16,	"x16_sse2"},
+  {DyadicBilinearDownsamplerWidthx16_ssse3,	WELS_CPU_SSSE3,	16,	"x16_ssse3"},
+  {DyadicBilinearDownsamplerWidthx32_ssse3,	WELS_CPU_SSSE3,	32,	"x32_ssse3"},
+  {DyadicBilinearDownsamplerWidthx32_avx2,	WELS_CPU_AVX2,	32,	"x32_avx2"},
+};
+
+static const SGeneralKernel kGeneralKernels[] = {
+  {GeneralBilinearFastDownsampler_sse2,		GeneralBilinearFastDownsampler_c,		WELS_CPU_SSE2,	"fast_sse2"},
+  {GeneralBilinearAccurateDownsampler_sse2,	GeneralBilinearAccurateDownsampler_c,	WELS_CPU_SSE2,	"accurate_sse2"},
+  {GeneralBilinearFastDownsampler_ssse3,	GeneralBilinearFastDownsampler_c,		WELS_CPU_SSSE3,	"fast_ssse3"},
+  {GeneralBilinearAccurateDownsampler_ssse3,	GeneralBilinearAccurateDownsampler_c,	WELS_CPU_SSSE3,	"accurate_ssse3"},
+};
+#else
+static const SHalveKernel kHalveKernels[] = {
+  {DyadicBilinearDownsampler_c, 0, 1, "c"},
+};
+
+static const SGeneralKernel kGeneralKernels[] = {
+  {GeneralBilinearFastDownsampler_c,		GeneralBilinearFastDownsampler_c,		0,	"fast_c"},
+  {GeneralBilinearAccurateDownsampler_c,	GeneralBilinearAccurateDownsampler_c,	0,	"accurate_c"},
+};
+#endif
+
+// the whole destination including the padding behind each row is compared, nothing may be written beyond the width
+TEST (ProcessUT_DownSample, DyadicKernelsMatchC) {
+  const uint32_t kuiCpuFlags = GetCpuFlags();
+  const int32_t kiHeights[] = {2, 6, 18, 34};
+  srand (0x1234);
+  for (size_t k = 0; k < sizeof (kHalveKernels) / sizeof (kHalveKernels[0]); ++k) {
+    const SHalveKernel& kKernel = kHalveKernels[k];
+    if ((kKernel.uiCpuFlag & kuiCpuFlags) != kKernel.uiCpuFlag)
+      continue;
+    for (int32_t iSrcWidth = kKernel.iWidthAlign; iSrcWidth <= 288; iSrcWidth += kKernel.iWidthAlign) {
+      for (size_t h = 0; h < sizeof (kiHeights) / sizeof (kiHeights[0]); ++h) {
+        const int32_t kiSrcHeight = kiHeights[h];
+        const int32_t kiSrcStride = iSrcWidth + (rand() % 3) * 16;
+        const int32_t kiDstStride = (iSrcWidth >> 1) + (rand() % 3) * 8;
+        const int32_t kiDstSize = kiDstStride * (kiSrcHeight >> 1) + GUARD_BYTES;
+        uint8_t* pSrc = new uint8_t[kiSrcStride * kiSrcHeight + GUARD_BYTES];
+        uint8_t* pDst = new uint8_t[kiDstSize];
+        uint8_t* pDstRef = new uint8_t[kiDstSize];
+        FillRandom (pSrc, kiSrcStride * kiSrcHeight + GUARD_BYTES);
+        memset (pDst, 0xa5, kiDstSize);
+        memset (pDstRef, 0xa5, kiDstSize);
+
+        DyadicBilinearDownsampler_c (pDstRef, kiDstStride, pSrc, kiSrcStride, iSrcWidth, kiSrcHeight);
+        kKernel.pfHalve (pDst, kiDstStride, pSrc, kiSrcStride, iSrcWidth, kiSrcHeight);
+        int32_t iRow = 0;
+        while (iRow < (kiSrcHeight >> 1)
+               && 0 == memcmp (pDstRef + iRow * kiDstStride, pDst + iRow * kiDstStride, iSrcWidth >> 1))
+          ++ iRow;
+        EXPECT_EQ (kiSrcHeight >> 1, iRow) << kKernel.pName << " width " << iSrcWidth << " height " << kiSrcHeight;
+        EXPECT_EQ (0, memcmp (pDstRef, pDst, kiDstSize)) << kKernel.pName << " wrote beyond the width " << iSrcWidth;
+
+        delete[] pSrc;
+        delete[] pDst;
+        delete[] pDstRef;
+      }
+    }
+  }
+}
+
+TEST (ProcessUT_DownSample, GeneralRatioKernelsMatchC) {
+  const uint32_t kuiCpuFlags = GetCpuFlags();
+  // odd sizes and sizes not a multiple of 16 or 32 on both sides
+  const int32_t kiSrcSizes[][2] = {{17, 9}, {33, 19}, {64, 36}, {101, 57}, {160, 90}, {352, 288}, {641, 361}};
+  const int32_t kiRatios[][2] = {{3, 4}, {2, 3}, {9, 16}, {1, 3}, {7, 8}, {5, 11}};
+  srand (0x4321);
+  for (size_t k = 0; k < sizeof (kGeneralKernels) / sizeof (kGeneralKernels[0]); ++k) {
+    const SGeneralKernel& kKernel = kGeneralKernels[k];
+    if ((kKernel.uiCpuFlag & kuiCpuFlags) != kKernel.uiCpuFlag)
+      continue;
+    for (size_t s = 0; s < sizeof (kiSrcSizes) / sizeof (kiSrcSizes[0]); ++s) {
+      for (size_t r = 0; r < sizeof (kiRatios) / sizeof (kiRatios[0]); ++r) {
+        const int32_t kiSrcWidth = kiSrcSizes[s][0];
+        const int32_t kiSrcHeight = kiSrcSizes[s][1];
+        const int32_t kiDstWidth = WELS_MAX (1, kiSrcWidth * kiRatios[r][0] / kiRatios[r][1] + (int32_t) (r & 1));
+        const int32_t kiDstHeight = WELS_MAX (1, kiSrcHeight * kiRatios[r][0] / kiRatios[r][1]);
+        if (kiDstWidth >= kiSrcWidth || kiDstHeight >= kiSrcHeight)
+          continue;
+        const int32_t kiSrcStride = kiSrcWidth + (rand() % 4) * 8;
+        const int32_t kiDstStride = kiDstWidth + (rand() % 4) * 8;
+        const int32_t kiDstSize = kiDstStride * kiDstHeight + GUARD_BYTES;
+        uint8_t* pSrc = new uint8_t[kiSrcStride * kiSrcHeight + GUARD_BYTES];
+        uint8_t* pDst = new uint8_t[kiDstSize];
+        uint8_t* pDstRef = new uint8_t[kiDstSize];
+        FillRandom (pSrc, kiSrcStride * kiSrcHeight + GUARD_BYTES);
+        memset (pDst, 0xa5, kiDstSize);
+        memset (pDstRef, 0xa5, kiDstSize);
+
+        kKernel.pfGeneralRef (pDstRef, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth,
+                              kiSrcHeight);
+        kKernel.pfGeneral (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth, kiSrcHeight);
+        EXPECT_EQ (0, memcmp (pDstRef, pDst, kiDstSize)) << kKernel.pName << " " << kiSrcWidth << "x" << kiSrcHeight <<
+            " to " << kiDstWidth << "x" << kiDstHeight;
+
+        delete[] pSrc;
+        delete[] pDst;
+        delete[] pDstRef;
+      }
+    }
+  }
+}
+
+// the strategy picks the kernel by the width of each plane, odd widths fall back to the c version for some planes
+TEST (ProcessUT_DownSample, ProcessMatchesC) {
+  const int32_t kiSizes[][4] = {{62, 34, 31, 17}, {100, 60, 50, 30}, {130, 66, 65, 33}, {192, 108, 96, 54},
+    {208, 64, 104, 32}, {264, 40, 132, 20}, {200, 120, 150, 90}, {321, 181, 160, 90}, {97, 55, 64, 36}
+  };
+  CDownsampling cDownsampleC (0);
+  CDownsampling cDownsample (GetCpuFlags());
+  srand (0x5678);
+  for (size_t s = 0; s < sizeof (kiSizes) / sizeof (kiSizes[0]); ++s) {
+    SPixMap sSrc, sDst, sDstRef;
+    uint8_t* pPlanes[9];
+    memset (&sSrc, 0, sizeof (sSrc));
+    sSrc.sRect.iRectWidth = kiSizes[s][0];
+    sSrc.sRect.iRectHeight = kiSizes[s][1];
+    sDst = sSrc;
+    sDst.sRect.iRectWidth = kiSizes[s][2];
+    sDst.sRect.iRectHeight = kiSizes[s][3];
+    sDstRef = sDst;
+    for (int i = 0; i < 3; ++i) {
+      const int32_t kiSrcSize = (kiSizes[s][0] + 32) * kiSizes[s][1] + GUARD_BYTES;
+      const int32_t kiDstSize = (kiSizes[s][2] + 32) * kiSizes[s][3] + GUARD_BYTES;
+      sSrc.iStride[i] = (kiSizes[s][0] >> (i > 0)) + 32;
+      sDst.iStride[i] = sDstRef.iStride[i] = (kiSizes[s][2] >> (i > 0)) + 16;
+      pPlanes[i] = new uint8_t[kiSrcSize];
+      pPlanes[3 + i] = new uint8_t[kiDstSize];
+      pPlanes[6 + i] = new uint8_t[kiDstSize];
+      FillRandom (pPlanes[i], kiSrcSize);
+      memset (pPlanes[3 + i], 0, kiDstSize);
+      memset (pPlanes[6 + i], 0, kiDstSize);
+      sSrc.pPixel[i] = pPlanes[i];
+      sDst.pPixel[i] = pPlanes[3 + i];
+      sDstRef.pPixel[i] = pPlanes[6 + i];
+    }
+    ASSERT_EQ (RET_SUCCESS, cDownsampleC.Process (0, &sSrc, &sDstRef));
+    ASSERT_EQ (RET_SUCCESS, cDownsample.Process (0, &sSrc, &sDst));
+    for (int i = 0; i < 3; ++i) {
+      const int32_t kiDstSize = (kiSizes[s][2] + 32) * kiSizes[s][3] + GUARD_BYTES;
+      EXPECT_EQ (0, memcmp (pPlanes[6 + i], pPlanes[3 + i], kiDstSize)) << "plane " << i << " of " << kiSizes[s][0]
+          << "x" << kiSizes[s][1];
+    }
+    for (int i = 0; i < 9; ++i)
+      delete[] pPlanes[i];
+  }
+}
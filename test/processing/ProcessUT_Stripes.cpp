@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "typedefs.h"
+#include "IWelsVP.h"
+
+#define PIC_WIDTH		80
+#define PIC_MAX_HEIGHT	176
+#define PIC_STRIDE		(PIC_WIDTH + 32)
+#define PIC_MB_NUM		((PIC_WIDTH >> 4) * (PIC_MAX_HEIGHT >> 4))
+
+typedef struct {
+  uint8_t	uiPlane[3][PIC_STRIDE * PIC_MAX_HEIGHT];
+} SPicBuf;
+
+typedef struct {
+  int32_t	iSad8x8[PIC_MB_NUM][4];
+  int32_t	iSsd16x16[PIC_MB_NUM];
+  int32_t	iSum16x16[PIC_MB_NUM];
+  int32_t	iSumOfSquare16x16[PIC_MB_NUM];
+  int32_t	iSumOfDiff8x8[PIC_MB_NUM][4];
+  uint8_t	uiMad8x8[PIC_MB_NUM][4];
+  SVAACalcResult sResult;
+} SVaaResultBuf;
+
+// heights in MB rows of 1, 3, 5, 7 and 11, none of them split evenly on all of the thread counts
+static const int32_t kiHeights[] = {16, 48, 80, 112, 176};
+static const int32_t kiThreadsNums[] = {2, 3, 4, 5, 8};
+
+static void InitVaaResult (SVaaResultBuf* pBuf) {
+  memset (pBuf, 0xcd, sizeof (*pBuf));
+  memset (&pBuf->sResult, 0, sizeof (pBuf->sResult));
+  pBuf->sResult.pSad8x8 = pBuf->iSad8x8;
+  pBuf->sResult.pSsd16x16 = pBuf->iSsd16x16;
+  pBuf->sResult.pSum16x16 = pBuf->iSum16x16;
+  pBuf->sResult.pSumOfSquare16x16 = pBuf->iSumOfSquare16x16;
+  pBuf->sResult.pSumOfDiff8x8 = pBuf->iSumOfDiff8x8;
+  pBuf->sResult.pMad8x8 = pBuf->uiMad8x8;
+}
+
+static void InitPixMap (SPixMap* pPixMap, SPicBuf* pPic, const int32_t kiWidth, const int32_t kiHeight) {
+  memset (pPixMap, 0, sizeof (*pPixMap));
+  for (int32_t i = 0; i < 3; ++i) {
+    pPixMap->pPixel[i] = pPic->uiPlane[i];
+    pPixMap->iStride[i] = PIC_STRIDE >> (i > 0);
+  }
+  pPixMap->iSizeInBits = 8;
+  pPixMap->sRect.iRectWidth = kiWidth;
+  pPixMap->sRect.iRectHeight = kiHeight;
+  pPixMap->eFormat = VIDEO_FORMAT_I420;
+}
+
+// a smooth picture with noise, and a reference with every fourth 16x16 block new, the others static up to noise
+static void MakePictures (SPicBuf* pCur, SPicBuf* pRef) {
+  for (int32_t c = 0; c < 3; ++c) {
+    for (int32_t i = 0; i < PIC_STRIDE * PIC_MAX_HEIGHT; ++i) {
+      const int32_t kiX = i % PIC_STRIDE, kiY = i / PIC_STRIDE;
+      pCur->uiPlane[c][i] = (uint8_t) (kiX * 2 + kiY + rand() % 9);
+      if (((kiX >> 4) + (kiY >> 4) * 3) % 4)
+        pRef->uiPlane[c][i] = (uint8_t) (pCur->uiPlane[c][i] + rand() % 5 - 2);
+      else
+        pRef->uiPlane[c][i] = (uint8_t)rand();
+    }
+  }
+}
+
+class StripesTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    m_pSerial = m_pStriped = NULL;
+    ASSERT_EQ (RET_SUCCESS, CreateVpInterface ((void**)&m_pSerial, WELSVP_INTERFACE_VERION));
+    ASSERT_EQ (RET_SUCCESS, CreateVpInterface ((void**)&m_pStriped, WELSVP_INTERFACE_VERION));
+    srand (0x23);
+  }
+  virtual void TearDown() {
+    if (m_pSerial)
+      DestroyVpInterface (m_pSerial, WELSVP_INTERFACE_VERION);
+    if (m_pStriped)
+      DestroyVpInterface (m_pStriped, WELSVP_INTERFACE_VERION);
+  }
+
+  // false if threads are not supported by the build, everything runs on the calling thread then
+  bool SetThreadsNum (int32_t iThreadsNum) {
+    return m_pStriped->SpecialFeature (FEATURE_THREADS_NUM, &iThreadsNum, NULL) == RET_SUCCESS;
+  }
+
+  void CalcVaa (IWelsVP* pVp, SPixMap* pCur, SPixMap* pRef, SVaaResultBuf* pBuf, const int32_t kiFlags) {
+    SVAACalcParam sParam;
+    sParam.iCalcSsd = kiFlags & 1;
+    sParam.iCalcVar = (kiFlags >> 1) & 1;
+    sParam.iCalcBgd = (kiFlags >> 2) & 1;
+    sParam.iReserved = 0;
+    sParam.pCalcResult = &pBuf->sResult;
+    ASSERT_EQ (RET_SUCCESS, pVp->Set (METHOD_VAA_STATISTICS, &sParam));
+    ASSERT_EQ (RET_SUCCESS, pVp->Process (METHOD_VAA_STATISTICS, pCur, pRef));
+  }
+
+  IWelsVP* m_pSerial;
+  IWelsVP* m_pStriped;
+};
+
+TEST_F (StripesTest, VaaCalcMatchesSingleStripe) {
+  static SPicBuf sCur, sRef;
+  static SVaaResultBuf sSerial, sStriped;
+  MakePictures (&sCur, &sRef);
+  for (size_t t = 0; t < sizeof (kiThreadsNums) / sizeof (kiThreadsNums[0]); ++t) {
+    if (!SetThreadsNum (kiThreadsNums[t]))
+      return;
+    for (size_t h = 0; h < sizeof (kiHeights) / sizeof (kiHeights[0]); ++h) {
+      SPixMap sCurMap, sRefMap;
+      InitPixMap (&sCurMap, &sCur, PIC_WIDTH, kiHeights[h]);
+      InitPixMap (&sRefMap, &sRef, PIC_WIDTH, kiHeights[h]);
+      for (int32_t iFlags = 0; iFlags < 8; ++iFlags) {
+        InitVaaResult (&sSerial);
+        InitVaaResult (&sStriped);
+        CalcVaa (m_pSerial, &sCurMap, &sRefMap, &sSerial, iFlags);
+        CalcVaa (m_pStriped, &sCurMap, &sRefMap, &sStriped, iFlags);
+        EXPECT_EQ (sSerial.sResult.iFrameSad, sStriped.sResult.iFrameSad);
+        EXPECT_EQ (0, memcmp (&sSerial, &sStriped, offsetof (SVaaResultBuf, sResult))) << "threads " << kiThreadsNums[t]
+            << " height " << kiHeights[h] << " flags " << iFlags;
+      }
+    }
+  }
+}
+
+TEST_F (StripesTest, DenoiseMatchesSingleStripe) {
+  static SPicBuf sSrc, sRef, sSerial, sStriped;
+  static SVaaResultBuf sSerialVaa, sStripedVaa;
+  MakePictures (&sSrc, &sRef);
+  for (size_t t = 0; t < sizeof (kiThreadsNums) / sizeof (kiThreadsNums[0]); ++t) {
+    if (!SetThreadsNum (kiThreadsNums[t]))
+      return;
+    for (size_t h = 0; h < sizeof (kiHeights) / sizeof (kiHeights[0]); ++h) {
+      SPixMap sSerialMap, sStripedMap, sRefMap;
+      InitPixMap (&sSerialMap, &sSerial, PIC_WIDTH, kiHeights[h]);
+      InitPixMap (&sStripedMap, &sStriped, PIC_WIDTH, kiHeights[h]);
+      InitPixMap (&sRefMap, &sRef, PIC_WIDTH, kiHeights[h]);
+
+      // spatial mode
+      memcpy (&sSerial, &sSrc, sizeof (sSrc));
+      memcpy (&sStriped, &sSrc, sizeof (sSrc));
+      ASSERT_EQ (RET_SUCCESS, m_pSerial->Process (METHOD_DENOISE, &sSerialMap, NULL));
+      ASSERT_EQ (RET_SUCCESS, m_pStriped->Process (METHOD_DENOISE, &sStripedMap, NULL));
+      EXPECT_EQ (0, memcmp (&sSerial, &sStriped, sizeof (sSrc))) << "spatial threads " << kiThreadsNums[t]
+          << " height " << kiHeights[h];
+
+      // temporal mode, with the statistics of either copy against the reference
+      SDenoiseParam sParam;
+      memcpy (&sSerial, &sSrc, sizeof (sSrc));
+      memcpy (&sStriped, &sSrc, sizeof (sSrc));
+      InitVaaResult (&sSerialVaa);
+      InitVaaResult (&sStripedVaa);
+      CalcVaa (m_pSerial, &sSerialMap, &sRefMap, &sSerialVaa, 0);
+      CalcVaa (m_pSerial, &sStripedMap, &sRefMap, &sStripedVaa, 0);
+      sParam.pCalcResult = &sSerialVaa.sResult;
+      ASSERT_EQ (RET_SUCCESS, m_pSerial->Set (METHOD_DENOISE, &sParam));
+      ASSERT_EQ (RET_SUCCESS, m_pSerial->Process (METHOD_DENOISE, &sSerialMap, &sRefMap));
+      sParam.pCalcResult = &sStripedVaa.sResult;
+      ASSERT_EQ (RET_SUCCESS, m_pStriped->Set (METHOD_DENOISE, &sParam));
+      ASSERT_EQ (RET_SUCCESS, m_pStriped->Process (METHOD_DENOISE, &sStripedMap, &sRefMap));
+      EXPECT_EQ (0, memcmp (&sSerial, &sStriped, sizeof (sSrc))) << "temporal threads " << kiThreadsNums[t]
+          << " height " << kiHeights[h];
+    }
+  }
+}
+
+TEST_F (StripesTest, DownsampleMatchesSingleStripe) {
+  static SPicBuf sSrc, sRef, sSerial, sStriped;
+  MakePictures (&sSrc, &sRef);
+  for (size_t t = 0; t < sizeof (kiThreadsNums) / sizeof (kiThreadsNums[0]); ++t) {
+    if (!SetThreadsNum (kiThreadsNums[t]))
+      return;
+    for (size_t h = 0; h < sizeof (kiHeights) / sizeof (kiHeights[0]); ++h) {
+      // dyadic, then a general ratio
+      const int32_t kiDstSizes[][2] = {{PIC_WIDTH >> 1, kiHeights[h] >> 1},
+        {(PIC_WIDTH * 2 / 3) & ~1, (kiHeights[h] * 2 / 3) & ~1}
+      };
+      for (int32_t d = 0; d < 2; ++d) {
+        SPixMap sSrcMap, sSerialMap, sStripedMap;
+        InitPixMap (&sSrcMap, &sSrc, PIC_WIDTH, kiHeights[h]);
+        InitPixMap (&sSerialMap, &sSerial, kiDstSizes[d][0], kiDstSizes[d][1]);
+        InitPixMap (&sStripedMap, &sStriped, kiDstSizes[d][0], kiDstSizes[d][1]);
+        memset (&sSerial, 0, sizeof (sSerial));
+        memset (&sStriped, 0, sizeof (sStriped));
+        ASSERT_EQ (RET_SUCCESS, m_pSerial->Process (METHOD_DOWNSAMPLE, &sSrcMap, &sSerialMap));
+        ASSERT_EQ (RET_SUCCESS, m_pStriped->Process (METHOD_DOWNSAMPLE, &sSrcMap, &sStripedMap));
+        EXPECT_EQ (0, memcmp (&sSerial, &sStriped, sizeof (sSerial))) << "threads " << kiThreadsNums[t] << " height "
+            << kiHeights[h] << " dst " << kiDstSizes[d][0] << "x" << kiDstSizes[d][1];
+      }
+    }
+  }
+}
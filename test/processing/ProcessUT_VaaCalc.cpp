@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include "typedefs.h"
+#include "IWelsVP.h"
+
+#define MAX_MB_NUM ((352 / 16) * (288 / 16))
+
+typedef struct {
+  int32_t	iSad8x8[MAX_MB_NUM][4];
+  int32_t	iSsd16x16[MAX_MB_NUM];
+  int32_t	iSum16x16[MAX_MB_NUM];
+  int32_t	iSumOfSquare16x16[MAX_MB_NUM];
+  int32_t	iSumOfDiff8x8[MAX_MB_NUM][4];
+  uint8_t	uiMad8x8[MAX_MB_NUM][4];
+  SVAACalcResult sResult;
+} SVaaResultBuf;
+
+static void InitVaaResult (SVaaResultBuf* pBuf, const uint8_t kuiFill) {
+  memset (pBuf, kuiFill, sizeof (*pBuf));
+  memset (&pBuf->sResult, 0, sizeof (pBuf->sResult));
+  pBuf->sResult.pSad8x8 = pBuf->iSad8x8;
+  pBuf->sResult.pSsd16x16 = pBuf->iSsd16x16;
+  pBuf->sResult.pSum16x16 = pBuf->iSum16x16;
+  pBuf->sResult.pSumOfSquare16x16 = pBuf->iSumOfSquare16x16;
+  pBuf->sResult.pSumOfDiff8x8 = pBuf->iSumOfDiff8x8;
+  pBuf->sResult.pMad8x8 = pBuf->uiMad8x8;
+}
+
+static void InitPixMap (SPixMap* pPixMap, uint8_t* pY, const int32_t kiWidth, const int32_t kiHeight,
+                        const int32_t kiStride) {
+  memset (pPixMap, 0, sizeof (*pPixMap));
+  pPixMap->pPixel[0] = pY;
+  pPixMap->iSizeInBits = 8;
+  pPixMap->iStride[0] = kiStride;
+  pPixMap->sRect.iRectWidth = kiWidth;
+  pPixMap->sRect.iRectHeight = kiHeight;
+  pPixMap->eFormat = VIDEO_FORMAT_I420;
+}
+
+// kiChange 0: noise only, 1: some moving blocks, 2: a new picture
+static void MakePictures (uint8_t* pCur, uint8_t* pRef, const int32_t kiStride, const int32_t kiHeight,
+                          const int32_t kiChange) {
+  for (int32_t i = 0; i < kiStride * kiHeight; ++i) {
+    pCur[i] = (uint8_t) ((i * 7 + (i / kiStride) * 13) & 0xff);
+    if (kiChange == 2)
+      pRef[i] = rand() & 0xff;
+    else if (kiChange == 1 && (rand() % 8) == 0)
+      pRef[i] = pCur[i] ^ 0x80;
+    else {
+      const int32_t kiNoisy = pCur[i] + rand() % 5 - 2;
+      pRef[i] = (uint8_t) (kiNoisy < 0 ? 0 : (kiNoisy > 255 ? 255 : kiNoisy));
+    }
+  }
+}
+
+class VaaCalcTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    m_pVp = NULL;
+    ASSERT_EQ (RET_SUCCESS, CreateVpInterface ((void**)&m_pVp, WELSVP_INTERFACE_VERION));
+  }
+  virtual void TearDown() {
+    if (m_pVp)
+      DestroyVpInterface (m_pVp, WELSVP_INTERFACE_VERION);
+  }
+
+  void CalcVaa (SPixMap* pCur, SPixMap* pRef, SVaaResultBuf* pBuf, const int kiSsd, const int kiVar, const int kiBgd) {
+    SVAACalcParam sParam;
+    sParam.iCalcSsd = kiSsd;
+    sParam.iCalcVar = kiVar;
+    sParam.iCalcBgd = kiBgd;
+    sParam.iReserved = 0;
+    sParam.pCalcResult = &pBuf->sResult;
+    ASSERT_EQ (RET_SUCCESS, m_pVp->Set (METHOD_VAA_STATISTICS, &sParam));
+    ASSERT_EQ (RET_SUCCESS, m_pVp->Process (METHOD_VAA_STATISTICS, pCur, pRef));
+  }
+
+  int DetectSceneChange (SPixMap* pCur, SPixMap* pRef, SVAACalcResult* pCalcResult) {
+    SSceneChangeParam sParam;
+    SSceneChangeResult sResult;
+    sParam.pCalcResult = pCalcResult;
+    sResult.bSceneChangeFlag = -1;
+    EXPECT_EQ (RET_SUCCESS, m_pVp->Set (METHOD_SCENE_CHANGE_DETECTION, &sParam));
+    EXPECT_EQ (RET_SUCCESS, m_pVp->Process (METHOD_SCENE_CHANGE_DETECTION, pCur, pRef));
+    EXPECT_EQ (RET_SUCCESS, m_pVp->Get (METHOD_SCENE_CHANGE_DETECTION, &sResult));
+    return sResult.bSceneChangeFlag;
+  }
+
+  IWelsVP* m_pVp;
+};
+
+// scene change detection counting on the 8x8 sad of the fused vaa pass decides as its own sad pass does
+TEST_F (VaaCalcTest, SceneChangeOnVaaResultMatchesOwnPass) {
+  const int32_t kiSizes[][2] = {{64, 48}, {176, 144}, {352, 288}, {100, 60}};
+  static uint8_t uiCur[(352 + 32) * 288];
+  static uint8_t uiRef[(352 + 32) * 288];
+  static SVaaResultBuf sBuf;
+  int iFlagCount[2] = {0, 0};
+  srand (0x22);
+  for (size_t s = 0; s < sizeof (kiSizes) / sizeof (kiSizes[0]); ++s) {
+    for (int32_t iChange = 0; iChange < 3; ++iChange) {
+      const int32_t kiStride = kiSizes[s][0] + 32;
+      SPixMap sCur, sRef;
+      MakePictures (uiCur, uiRef, kiStride, kiSizes[s][1], iChange);
+      InitPixMap (&sCur, uiCur, kiSizes[s][0], kiSizes[s][1], kiStride);
+      InitPixMap (&sRef, uiRef, kiSizes[s][0], kiSizes[s][1], kiStride);
+
+      const int kiOwnFlag = DetectSceneChange (&sCur, &sRef, NULL);
+      InitVaaResult (&sBuf, 0);
+      if ((kiSizes[s][0] & 15) == 0 && (kiSizes[s][1] & 15) == 0)
+        CalcVaa (&sCur, &sRef, &sBuf, 1, 1, 1);
+      EXPECT_EQ (kiOwnFlag, DetectSceneChange (&sCur, &sRef, &sBuf.sResult)) << kiSizes[s][0] << "x" << kiSizes[s][1]
+          << " change " << iChange;
+      ++ iFlagCount[kiOwnFlag ? 1 : 0];
+    }
+  }
+  // both decisions have been compared
+  EXPECT_GT (iFlagCount[0], 0);
+  EXPECT_GT (iFlagCount[1], 0);
+}
+
+// the fused pass computes everything at once, each field any narrower pass computes has to come out the same
+TEST_F (VaaCalcTest, FusedPassMatchesSeparatePasses) {
+  const int32_t kiSizes[][2] = {{64, 48}, {176, 144}, {352, 288}};
+  static uint8_t uiCur[(352 + 32) * 288];
+  static uint8_t uiRef[(352 + 32) * 288];
+  static SVaaResultBuf sFused, sSeparate;
+  srand (0x23);
+  for (size_t s = 0; s < sizeof (kiSizes) / sizeof (kiSizes[0]); ++s) {
+    const int32_t kiStride = kiSizes[s][0] + 32;
+    const int32_t kiMbNum = (kiSizes[s][0] >> 4) * (kiSizes[s][1] >> 4);
+    SPixMap sCur, sRef;
+    MakePictures (uiCur, uiRef, kiStride, kiSizes[s][1], 1);
+    InitPixMap (&sCur, uiCur, kiSizes[s][0], kiSizes[s][1], kiStride);
+    InitPixMap (&sRef, uiRef, kiSizes[s][0], kiSizes[s][1], kiStride);
+
+    InitVaaResult (&sFused, 0);
+    CalcVaa (&sCur, &sRef, &sFused, 1, 1, 1);
+    for (int iFlags = 0; iFlags < 8; ++iFlags) {
+      const int kiSsd = iFlags & 1, kiVar = (iFlags >> 1) & 1, kiBgd = (iFlags >> 2) & 1;
+      InitVaaResult (&sSeparate, 0xcd);
+      CalcVaa (&sCur, &sRef, &sSeparate, kiSsd, kiVar, kiBgd);
+
+      EXPECT_EQ (sFused.sResult.iFrameSad, sSeparate.sResult.iFrameSad) << "flags " << iFlags;
+      EXPECT_EQ (0, memcmp (sFused.iSad8x8, sSeparate.iSad8x8, kiMbNum * sizeof (sFused.iSad8x8[0])))
+          << "flags " << iFlags;
+      if (kiSsd || (kiVar && !kiBgd)) {	// the sad/bgd kernel has no sums, iCalcVar does not apply with iCalcBgd
+        EXPECT_EQ (0, memcmp (sFused.iSum16x16, sSeparate.iSum16x16, kiMbNum * sizeof (int32_t))) << "flags " << iFlags;
+        EXPECT_EQ (0, memcmp (sFused.iSumOfSquare16x16, sSeparate.iSumOfSquare16x16, kiMbNum * sizeof (int32_t)))
+            << "flags " << iFlags;
+      }
+      if (kiSsd) {
+        EXPECT_EQ (0, memcmp (sFused.iSsd16x16, sSeparate.iSsd16x16, kiMbNum * sizeof (int32_t))) << "flags " << iFlags;
+      }
+      if (kiBgd) {
+        EXPECT_EQ (0, memcmp (sFused.iSumOfDiff8x8, sSeparate.iSumOfDiff8x8,
+                              kiMbNum * sizeof (sFused.iSumOfDiff8x8[0]))) << "flags " << iFlags;
+        EXPECT_EQ (0, memcmp (sFused.uiMad8x8, sSeparate.uiMad8x8, kiMbNum * sizeof (sFused.uiMad8x8[0])))
+            << "flags " << iFlags;
+      }
+    }
+  }
+}